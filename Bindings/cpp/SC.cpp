@@ -1,5 +1,6 @@
 // Copyright (c) Stefano Cristiano
 // SPDX-License-Identifier: MIT
+#include "../../Libraries/Algorithms/AlgorithmSimd.cpp"
 #include "../../Libraries/Async/Async.cpp"
 #include "../../Libraries/Build/Build.cpp"
 #include "../../Libraries/File/FileDescriptor.cpp"
@@ -12,8 +13,10 @@
 #include "../../Libraries/Hashing/Hashing.cpp"
 #include "../../Libraries/Http/HttpClient.cpp"
 #include "../../Libraries/Http/HttpParser.cpp"
+#include "../../Libraries/Http/HttpRouter.cpp"
 #include "../../Libraries/Http/HttpServer.cpp"
 #include "../../Libraries/Http/HttpURLParser.cpp"
+#include "../../Libraries/Http/HttpWebSocket.cpp"
 #include "../../Libraries/Plugin/Plugin.cpp"
 #include "../../Libraries/Process/Process.cpp"
 #include "../../Libraries/SerializationText/SerializationJson.cpp"
@@ -25,6 +28,10 @@
 #include "../../Libraries/Strings/StringIterator.cpp"
 #include "../../Libraries/Strings/StringView.cpp"
 #include "../../Libraries/Testing/Testing.cpp"
+#include "../../Libraries/Threading/CpuTopology.cpp"
+#include "../../Libraries/Threading/EpochReclamation.cpp"
+#include "../../Libraries/Threading/JobSystem.cpp"
+#include "../../Libraries/Threading/TaskGraph.cpp"
 #include "../../Libraries/Threading/ThreadPool.cpp"
 #include "../../Libraries/Threading/Threading.cpp"
 #include "../../Libraries/Time/Time.cpp"
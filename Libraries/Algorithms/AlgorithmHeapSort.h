@@ -0,0 +1,68 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "AlgorithmBubbleSort.h" // smallerThan
+
+namespace SC
+{
+namespace Algorithms
+{
+//! @addtogroup group_algorithms
+//! @{
+
+/// @brief Moves down the root of a max-heap until it's not smaller than its children (used by heapSort).
+/// @tparam RandomIterator A type that behaves as a random access iterator (can just be a pointer)
+/// @tparam BinaryPredicate A predicate that takes `(a, b)` and returns `bool` (example SC::Algorithms::smallerThan)
+/// @param first Iterator pointing at first element of the heap
+/// @param root Index of the element to move down
+/// @param size Number of elements in the heap
+/// @param predicate The given BinaryPredicate
+template <typename RandomIterator, typename BinaryPredicate>
+constexpr void heapSiftDown(RandomIterator first, size_t root, size_t size, BinaryPredicate& predicate)
+{
+    for (size_t child = 2 * root + 1; child < size; child = 2 * root + 1)
+    {
+        if (child + 1 < size and predicate(first[child], first[child + 1]))
+        {
+            child++;
+        }
+        if (not predicate(first[root], first[child]))
+        {
+            return;
+        }
+        swap(first[root], first[child]);
+        root = child;
+    }
+}
+
+/// @brief Sorts iterator range according to BinaryPredicate (heap sort).
+///
+/// Runs in `O(n log(n))` for any input and it doesn't need additional memory, but it's not stable (the relative
+/// order of elements comparing equal is not preserved).
+/// @tparam RandomIterator A type that behaves as a random access iterator (can just be a pointer)
+/// @tparam BinaryPredicate A predicate that takes `(a, b)` and returns `bool` (example SC::Algorithms::smallerThan)
+/// @param first Iterator pointing at first element of the range
+/// @param last Iterator pointing after last element of the range
+/// @param predicate The given BinaryPredicate
+template <typename RandomIterator,
+          typename BinaryPredicate = smallerThan<typename TypeTraits::RemovePointer<RandomIterator>::type>>
+constexpr void heapSort(RandomIterator first, RandomIterator last, BinaryPredicate predicate = BinaryPredicate())
+{
+    if (first >= last)
+    {
+        return;
+    }
+    const size_t size = static_cast<size_t>(last - first);
+    for (size_t idx = size / 2; idx > 0; --idx)
+    {
+        heapSiftDown(first, idx - 1, size, predicate);
+    }
+    for (size_t idx = size - 1; idx > 0; --idx)
+    {
+        swap(first[0], first[idx]);
+        heapSiftDown(first, 0, idx, predicate);
+    }
+}
+//! @}
+} // namespace Algorithms
+} // namespace SC
@@ -0,0 +1,47 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "AlgorithmBubbleSort.h" // smallerThan
+
+namespace SC
+{
+namespace Algorithms
+{
+//! @addtogroup group_algorithms
+//! @{
+
+/// @brief Sorts iterator range according to BinaryPredicate (insertion sort).
+///
+/// Runs in `O(n^2)` but it's the fastest sort for small ranges (a few tens of elements) or for ranges that are almost
+/// sorted, and it's stable (the relative order of elements comparing equal is preserved).
+/// @tparam RandomIterator A type that behaves as a random access iterator (can just be a pointer)
+/// @tparam BinaryPredicate A predicate that takes `(a, b)` and returns `bool` (example SC::Algorithms::smallerThan)
+/// @param first Iterator pointing at first element of the range
+/// @param last Iterator pointing after last element of the range
+/// @param predicate The given BinaryPredicate
+template <typename RandomIterator,
+          typename BinaryPredicate = smallerThan<typename TypeTraits::RemovePointer<RandomIterator>::type>>
+constexpr void insertionSort(RandomIterator first, RandomIterator last, BinaryPredicate predicate = BinaryPredicate())
+{
+    if (first >= last)
+    {
+        return;
+    }
+    for (RandomIterator current = first + 1; current != last; ++current)
+    {
+        RandomIterator sift     = current;
+        RandomIterator siftPrev = current - 1;
+        if (predicate(*sift, *siftPrev))
+        {
+            auto value = move(*sift);
+            do
+            {
+                *sift-- = move(*siftPrev);
+            } while (sift != first and predicate(value, *--siftPrev));
+            *sift = move(value);
+        }
+    }
+}
+//! @}
+} // namespace Algorithms
+} // namespace SC
@@ -0,0 +1,122 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "AlgorithmInsertionSort.h"
+
+namespace SC
+{
+namespace Algorithms
+{
+//! @addtogroup group_algorithms
+//! @{
+
+/// @brief Implementation details of SC::Algorithms::mergeSort
+struct MergeSort
+{
+    static constexpr size_t InsertionSortThreshold = 16; ///< Ranges smaller than this use insertion sort
+
+    template <typename RandomIterator, typename ScratchIterator, typename BinaryPredicate>
+    static constexpr void sort(RandomIterator first, RandomIterator last, ScratchIterator scratch,
+                               BinaryPredicate& predicate)
+    {
+        const size_t size = static_cast<size_t>(last - first);
+        if (size < InsertionSortThreshold)
+        {
+            insertionSort(first, last, predicate);
+            return;
+        }
+        const RandomIterator middle = first + size / 2;
+        sort(first, middle, scratch, predicate);
+        sort(middle, last, scratch, predicate);
+        if (not predicate(*middle, *(middle - 1)))
+        {
+            return; // Halves are already in order
+        }
+        // Moves left half to scratch and merges it with right half, taking from left half when elements are equal
+        ScratchIterator scratchEnd = scratch;
+        for (RandomIterator it = first; it != middle; ++it)
+        {
+            *scratchEnd++ = move(*it);
+        }
+        ScratchIterator left  = scratch;
+        RandomIterator  right = middle;
+        RandomIterator  out   = first;
+        while (left != scratchEnd and right != last)
+        {
+            if (predicate(*right, *left))
+                *out++ = move(*right++);
+            else
+                *out++ = move(*left++);
+        }
+        while (left != scratchEnd)
+        {
+            *out++ = move(*left++);
+        }
+    }
+};
+
+/// @brief Sorts iterator range according to BinaryPredicate (merge sort).
+///
+/// Runs in `O(n log(n))` for any input and it's stable (the relative order of elements comparing equal is preserved),
+/// but it needs scratch memory provided by the caller, so that it never allocates. @n
+/// Small ranges are sorted with insertion sort, and merging is skipped for ranges that are already in order (making
+/// sorted inputs linear).
+/// @tparam RandomIterator A type that behaves as a random access iterator (can just be a pointer)
+/// @tparam ScratchIterator A type that behaves as a random access iterator (can just be a pointer)
+/// @tparam BinaryPredicate A predicate that takes `(a, b)` and returns `bool` (example SC::Algorithms::smallerThan)
+/// @param first Iterator pointing at first element of the range
+/// @param last Iterator pointing after last element of the range
+/// @param scratch Iterator pointing at first of at least `(last - first) / 2` constructed elements, that will be
+/// assigned during sort (and left in unspecified state)
+/// @param predicate The given BinaryPredicate
+template <typename RandomIterator, typename ScratchIterator,
+          typename BinaryPredicate = smallerThan<typename TypeTraits::RemovePointer<RandomIterator>::type>>
+constexpr void mergeSort(RandomIterator first, RandomIterator last, ScratchIterator scratch,
+                         BinaryPredicate predicate = BinaryPredicate())
+{
+    if (first >= last)
+    {
+        return;
+    }
+    MergeSort::sort(first, last, scratch, predicate);
+}
+
+/// @brief Merges two sorted ranges into output, moving their elements (stable, elements of the first range come first
+/// when comparing equal).
+/// @tparam InputIterator1 A type that behaves as an input iterator (can just be a pointer)
+/// @tparam InputIterator2 A type that behaves as an input iterator (can just be a pointer)
+/// @tparam OutputIterator A type that behaves as an output iterator (can just be a pointer)
+/// @tparam BinaryPredicate A predicate that takes `(a, b)` and returns `bool` (example SC::Algorithms::smallerThan)
+/// @param first1 Iterator pointing at first element of the first range
+/// @param last1 Iterator pointing after last element of the first range
+/// @param first2 Iterator pointing at first element of the second range
+/// @param last2 Iterator pointing after last element of the second range
+/// @param output Iterator pointing at first of `(last1 - first1) + (last2 - first2)` constructed elements, not
+/// overlapping with the input ranges
+/// @param predicate The given BinaryPredicate
+/// @return Iterator pointing after the last element assigned to output
+template <typename InputIterator1, typename InputIterator2, typename OutputIterator,
+          typename BinaryPredicate = smallerThan<typename TypeTraits::RemovePointer<InputIterator1>::type>>
+constexpr OutputIterator merge(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2,
+                               OutputIterator output, BinaryPredicate predicate = BinaryPredicate())
+{
+    while (first1 != last1 and first2 != last2)
+    {
+        if (predicate(*first2, *first1))
+            *output++ = move(*first2++);
+        else
+            *output++ = move(*first1++);
+    }
+    while (first1 != last1)
+    {
+        *output++ = move(*first1++);
+    }
+    while (first2 != last2)
+    {
+        *output++ = move(*first2++);
+    }
+    return output;
+}
+//! @}
+} // namespace Algorithms
+} // namespace SC
@@ -0,0 +1,293 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "AlgorithmHeapSort.h"
+#include "AlgorithmInsertionSort.h"
+
+namespace SC
+{
+namespace Algorithms
+{
+//! @addtogroup group_algorithms
+//! @{
+
+/// @brief Implementation details of SC::Algorithms::quickSort (pattern-defeating quicksort)
+struct QuickSort
+{
+    static constexpr size_t InsertionSortThreshold    = 24;  ///< Ranges smaller than this use insertion sort
+    static constexpr size_t NintherThreshold          = 128; ///< Ranges larger than this pick pivot with Tukey ninther
+    static constexpr size_t PartialInsertionSortLimit = 8;   ///< Moves after which partial insertion sort gives up
+
+    /// @brief Insertion sort assuming that the element before first is not greater than all elements of the range
+    template <typename RandomIterator, typename BinaryPredicate>
+    static constexpr void unguardedInsertionSort(RandomIterator first, RandomIterator last, BinaryPredicate& predicate)
+    {
+        for (RandomIterator current = first + 1; current < last; ++current)
+        {
+            RandomIterator sift     = current;
+            RandomIterator siftPrev = current - 1;
+            if (predicate(*sift, *siftPrev))
+            {
+                auto value = move(*sift);
+                do
+                {
+                    *sift-- = move(*siftPrev);
+                } while (predicate(value, *--siftPrev));
+                *sift = move(value);
+            }
+        }
+    }
+
+    /// @brief Insertion sort that gives up after PartialInsertionSortLimit moves
+    /// @return `true` if the range has been sorted
+    template <typename RandomIterator, typename BinaryPredicate>
+    static constexpr bool partialInsertionSort(RandomIterator first, RandomIterator last, BinaryPredicate& predicate)
+    {
+        if (first == last)
+        {
+            return true;
+        }
+        size_t numMoves = 0;
+        for (RandomIterator current = first + 1; current != last; ++current)
+        {
+            RandomIterator sift     = current;
+            RandomIterator siftPrev = current - 1;
+            if (predicate(*sift, *siftPrev))
+            {
+                auto value = move(*sift);
+                do
+                {
+                    *sift-- = move(*siftPrev);
+                } while (sift != first and predicate(value, *--siftPrev));
+                *sift = move(value);
+                numMoves += static_cast<size_t>(current - sift);
+            }
+            if (numMoves > PartialInsertionSortLimit)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename RandomIterator, typename BinaryPredicate>
+    static constexpr void sort2(RandomIterator a, RandomIterator b, BinaryPredicate& predicate)
+    {
+        if (predicate(*b, *a))
+        {
+            swap(*a, *b);
+        }
+    }
+
+    template <typename RandomIterator, typename BinaryPredicate>
+    static constexpr void sort3(RandomIterator a, RandomIterator b, RandomIterator c, BinaryPredicate& predicate)
+    {
+        sort2(a, b, predicate);
+        sort2(b, c, predicate);
+        sort2(a, b, predicate);
+    }
+
+    /// @brief Partitions around the pivot in *first, putting elements equal to pivot on the right side
+    /// @return Position of the pivot after partitioning
+    template <typename RandomIterator, typename BinaryPredicate>
+    static constexpr RandomIterator partitionRight(RandomIterator begin, RandomIterator end, BinaryPredicate& predicate,
+                                                   bool& alreadyPartitioned)
+    {
+        auto pivot = move(*begin);
+
+        RandomIterator first = begin;
+        RandomIterator last  = end;
+        // Median of three guarantees that there's an element not smaller than pivot (no bound check needed)
+        while (predicate(*++first, pivot))
+        {
+        }
+        // If first is the first element not smaller than pivot there may be no element smaller than pivot
+        if (first - 1 == begin)
+        {
+            while (first < last and not predicate(*--last, pivot))
+            {
+            }
+        }
+        else
+        {
+            while (not predicate(*--last, pivot))
+            {
+            }
+        }
+        alreadyPartitioned = first >= last;
+        while (first < last)
+        {
+            swap(*first, *last);
+            while (predicate(*++first, pivot))
+            {
+            }
+            while (not predicate(*--last, pivot))
+            {
+            }
+        }
+        RandomIterator pivotPosition = first - 1;
+        *begin                       = move(*pivotPosition);
+        *pivotPosition               = move(pivot);
+        return pivotPosition;
+    }
+
+    /// @brief Partitions around the pivot in *first, putting elements equal to pivot on the left side.
+    /// Used when the pivot is equal to the element before the range, so that all elements equal to it are skipped.
+    /// @return Position of the pivot after partitioning
+    template <typename RandomIterator, typename BinaryPredicate>
+    static constexpr RandomIterator partitionLeft(RandomIterator begin, RandomIterator end, BinaryPredicate& predicate)
+    {
+        auto pivot = move(*begin);
+
+        RandomIterator first = begin;
+        RandomIterator last  = end;
+        while (predicate(pivot, *--last))
+        {
+        }
+        if (last + 1 == end)
+        {
+            while (first < last and not predicate(pivot, *++first))
+            {
+            }
+        }
+        else
+        {
+            while (not predicate(pivot, *++first))
+            {
+            }
+        }
+        while (first < last)
+        {
+            swap(*first, *last);
+            while (predicate(pivot, *--last))
+            {
+            }
+            while (not predicate(pivot, *++first))
+            {
+            }
+        }
+        RandomIterator pivotPosition = last;
+        *begin                       = move(*pivotPosition);
+        *pivotPosition               = move(pivot);
+        return pivotPosition;
+    }
+
+    /// @brief Swaps a few elements of a range to break patterns causing bad partitions
+    template <typename RandomIterator>
+    static constexpr void breakPatterns(RandomIterator first, RandomIterator last)
+    {
+        const size_t size = static_cast<size_t>(last - first);
+        if (size >= InsertionSortThreshold)
+        {
+            const size_t quarter = size / 4;
+            swap(first[0], first[quarter]);
+            swap(last[-1], last[-static_cast<ssize_t>(quarter)]);
+            if (size > NintherThreshold)
+            {
+                swap(first[1], first[quarter + 1]);
+                swap(first[2], first[quarter + 2]);
+                swap(last[-2], last[-static_cast<ssize_t>(quarter + 1)]);
+                swap(last[-3], last[-static_cast<ssize_t>(quarter + 2)]);
+            }
+        }
+    }
+
+    template <typename RandomIterator, typename BinaryPredicate>
+    static constexpr void sort(RandomIterator begin, RandomIterator end, BinaryPredicate& predicate,
+                               size_t badPartitionsAllowed, bool leftmost)
+    {
+        while (true)
+        {
+            const size_t size = static_cast<size_t>(end - begin);
+            if (size < InsertionSortThreshold)
+            {
+                if (leftmost)
+                    insertionSort(begin, end, predicate);
+                else
+                    unguardedInsertionSort(begin, end, predicate);
+                return;
+            }
+
+            // Pivot is median of three elements (or median of three medians of three) and it's moved to begin
+            const size_t half = size / 2;
+            if (size > NintherThreshold)
+            {
+                sort3(begin, begin + half, end - 1, predicate);
+                sort3(begin + 1, begin + (half - 1), end - 2, predicate);
+                sort3(begin + 2, begin + (half + 1), end - 3, predicate);
+                sort3(begin + (half - 1), begin + half, begin + (half + 1), predicate);
+                swap(*begin, *(begin + half));
+            }
+            else
+            {
+                sort3(begin + half, begin, end - 1, predicate);
+            }
+
+            // If pivot is equal to the element before the range (that is the pivot of a previous partition) all
+            // elements equal to it can be skipped, as they're all in place (this makes many duplicates linear)
+            if (not leftmost and not predicate(*(begin - 1), *begin))
+            {
+                begin = partitionLeft(begin, end, predicate) + 1;
+                continue;
+            }
+
+            bool                 alreadyPartitioned = false;
+            const RandomIterator pivotPosition      = partitionRight(begin, end, predicate, alreadyPartitioned);
+
+            const size_t leftSize  = static_cast<size_t>(pivotPosition - begin);
+            const size_t rightSize = static_cast<size_t>(end - (pivotPosition + 1));
+            if (leftSize < size / 8 or rightSize < size / 8)
+            {
+                // Too many bad partitions would lead to O(n^2), so heapSort guarantees O(n log(n)) in the worst case
+                if (--badPartitionsAllowed == 0)
+                {
+                    heapSort(begin, end, predicate);
+                    return;
+                }
+                breakPatterns(begin, pivotPosition);
+                breakPatterns(pivotPosition + 1, end);
+            }
+            else if (alreadyPartitioned and partialInsertionSort(begin, pivotPosition, predicate) and
+                     partialInsertionSort(pivotPosition + 1, end, predicate))
+            {
+                return; // Range was probably already sorted
+            }
+
+            // Recurse on the left side and loop on the right side
+            sort(begin, pivotPosition, predicate, badPartitionsAllowed, leftmost);
+            begin    = pivotPosition + 1;
+            leftmost = false;
+        }
+    }
+};
+
+/// @brief Sorts iterator range according to BinaryPredicate (pattern-defeating quicksort).
+///
+/// Runs in `O(n log(n))` for any input and it doesn't need additional memory, but it's not stable (the relative
+/// order of elements comparing equal is not preserved). @n
+/// It's a quicksort picking median of three (or Tukey ninther) pivots, switching to insertion sort for small ranges.
+/// Already sorted ranges, reversed ranges and ranges with many duplicates are sorted in linear time, while patterns
+/// leading to bad partitions are broken shuffling a few elements, falling back to heapSort if they keep happening.
+/// @tparam RandomIterator A type that behaves as a random access iterator (can just be a pointer)
+/// @tparam BinaryPredicate A predicate that takes `(a, b)` and returns `bool` (example SC::Algorithms::smallerThan)
+/// @param first Iterator pointing at first element of the range
+/// @param last Iterator pointing after last element of the range
+/// @param predicate The given BinaryPredicate
+template <typename RandomIterator,
+          typename BinaryPredicate = smallerThan<typename TypeTraits::RemovePointer<RandomIterator>::type>>
+constexpr void quickSort(RandomIterator first, RandomIterator last, BinaryPredicate predicate = BinaryPredicate())
+{
+    if (first >= last)
+    {
+        return;
+    }
+    size_t badPartitionsAllowed = 1; // log2 of the number of elements
+    for (size_t size = static_cast<size_t>(last - first); size > 1; size /= 2)
+    {
+        badPartitionsAllowed++;
+    }
+    QuickSort::sort(first, last, predicate, badPartitionsAllowed, true);
+}
+//! @}
+} // namespace Algorithms
+} // namespace SC
@@ -0,0 +1,163 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "../Foundation/LibC.h" // memcpy
+#include "../Foundation/TypeTraits.h"
+
+namespace SC
+{
+namespace Algorithms
+{
+//! @addtogroup group_algorithms
+//! @{
+
+/// @brief Maps keys of SC::Algorithms::radixSort to unsigned integers with the same order
+template <typename Key>
+struct RadixSortKey;
+
+/// @brief Unsigned integers are already ordered
+template <typename Unsigned>
+struct RadixSortUnsignedKey
+{
+    using Bits = Unsigned;
+    static constexpr Bits toBits(Unsigned key) { return key; }
+};
+
+/// @brief Signed integers are ordered flipping their sign bit
+template <typename Signed, typename Unsigned>
+struct RadixSortSignedKey
+{
+    using Bits = Unsigned;
+    static constexpr Bits SignBit = static_cast<Bits>(Bits(1) << (sizeof(Bits) * 8 - 1));
+    static constexpr Bits toBits(Signed key) { return static_cast<Bits>(static_cast<Bits>(key) ^ SignBit); }
+};
+
+/// @brief Floating point numbers are ordered flipping all bits of negative numbers and sign bit of positive ones.
+/// NaN are sorted after positive infinity (or before negative infinity if their sign bit is set).
+template <typename Float, typename Unsigned>
+struct RadixSortFloatKey
+{
+    using Bits = Unsigned;
+    static constexpr Bits SignBit = static_cast<Bits>(Bits(1) << (sizeof(Bits) * 8 - 1));
+    static Bits toBits(Float key)
+    {
+        Bits bits;
+        ::memcpy(&bits, &key, sizeof(bits));
+        return (bits & SignBit) ? static_cast<Bits>(~bits) : static_cast<Bits>(bits ^ SignBit);
+    }
+};
+
+// clang-format off
+template <> struct RadixSortKey<uint8_t>  : public RadixSortUnsignedKey<uint8_t> {};
+template <> struct RadixSortKey<uint16_t> : public RadixSortUnsignedKey<uint16_t> {};
+template <> struct RadixSortKey<uint32_t> : public RadixSortUnsignedKey<uint32_t> {};
+template <> struct RadixSortKey<uint64_t> : public RadixSortUnsignedKey<uint64_t> {};
+template <> struct RadixSortKey<int8_t>   : public RadixSortSignedKey<int8_t, uint8_t> {};
+template <> struct RadixSortKey<int16_t>  : public RadixSortSignedKey<int16_t, uint16_t> {};
+template <> struct RadixSortKey<int32_t>  : public RadixSortSignedKey<int32_t, uint32_t> {};
+template <> struct RadixSortKey<int64_t>  : public RadixSortSignedKey<int64_t, uint64_t> {};
+template <> struct RadixSortKey<float>    : public RadixSortFloatKey<float, uint32_t> {};
+template <> struct RadixSortKey<double>   : public RadixSortFloatKey<double, uint64_t> {};
+// clang-format on
+
+/// @brief Functor returning the item itself as key of SC::Algorithms::radixSort
+struct RadixSortIdentity
+{
+    template <typename T>
+    constexpr const T& operator()(const T& item) const
+    {
+        return item;
+    }
+};
+
+/// @brief Implementation details of SC::Algorithms::radixSort
+struct RadixSort
+{
+    static constexpr size_t NumBuckets = 256; ///< Keys are sorted one byte at a time
+
+    // Moves all items from source to destination, in the order of their digit at shift
+    template <typename Key, typename SourceIterator, typename DestinationIterator, typename KeyOfItem>
+    static void scatter(SourceIterator source, DestinationIterator destination, size_t size,
+                        size_t (&offsets)[NumBuckets], size_t shift, KeyOfItem& keyOf)
+    {
+        for (size_t idx = 0; idx < size; ++idx)
+        {
+            const size_t digit = (RadixSortKey<Key>::toBits(keyOf(source[idx])) >> shift) & 0xff;
+            destination[offsets[digit]++] = move(source[idx]);
+        }
+    }
+};
+
+/// @brief Sorts iterator range in ascending order of keys (LSD radix sort).
+///
+/// Runs in `O(n)` (a pass for every byte of the key) and it's stable (the relative order of elements with equal keys
+/// is preserved), but it needs scratch memory provided by the caller, so that it never allocates. @n
+/// Keys can be integers or floating point numbers (see SC::Algorithms::RadixSortKey). Bytes having the same value
+/// in all keys are skipped, so that for example small integers stored in 64 bits are sorted with just a few passes.
+/// @note Being based on keys instead of comparisons, items can't be sorted with a BinaryPredicate. To sort in
+/// descending order, or by multiple keys, return a transformed key (for example `~key` or `(high << 32) | low`).
+/// @tparam RandomIterator A type that behaves as a random access iterator (can just be a pointer)
+/// @tparam ScratchIterator A type that behaves as a random access iterator (can just be a pointer)
+/// @tparam KeyOfItem A functor that takes an item and returns its key
+/// @param first Iterator pointing at first element of the range
+/// @param last Iterator pointing after last element of the range
+/// @param scratch Iterator pointing at first of at least `last - first` constructed elements, that will be assigned
+/// during sort (and left in unspecified state)
+/// @param keyOf The given KeyOfItem functor
+template <typename RandomIterator, typename ScratchIterator, typename KeyOfItem = RadixSortIdentity>
+void radixSort(RandomIterator first, RandomIterator last, ScratchIterator scratch, KeyOfItem keyOf = KeyOfItem())
+{
+    using KeyReference = typename TypeTraits::RemoveReference<decltype(keyOf(*first))>::type;
+    using Key          = typename TypeTraits::RemoveConst<KeyReference>::type;
+    using Bits         = typename RadixSortKey<Key>::Bits;
+    constexpr size_t NumDigits = sizeof(Bits);
+    if (first >= last)
+    {
+        return;
+    }
+    const size_t size = static_cast<size_t>(last - first);
+
+    // Counts occurrences of all digits with a single pass
+    size_t counts[NumDigits][RadixSort::NumBuckets] = {};
+    for (size_t idx = 0; idx < size; ++idx)
+    {
+        const Bits bits = RadixSortKey<Key>::toBits(keyOf(first[idx]));
+        for (size_t digit = 0; digit < NumDigits; ++digit)
+        {
+            counts[digit][(bits >> (digit * 8)) & 0xff]++;
+        }
+    }
+
+    const Bits firstBits = RadixSortKey<Key>::toBits(keyOf(first[0]));
+    bool       inScratch = false;
+    for (size_t digit = 0; digit < NumDigits; ++digit)
+    {
+        size_t(&offsets)[RadixSort::NumBuckets] = counts[digit];
+        if (offsets[(firstBits >> (digit * 8)) & 0xff] == size)
+        {
+            continue; // All keys have the same value for this digit
+        }
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < RadixSort::NumBuckets; ++bucket)
+        {
+            const size_t count = offsets[bucket];
+            offsets[bucket]    = offset;
+            offset += count;
+        }
+        if (inScratch)
+            RadixSort::scatter<Key>(scratch, first, size, offsets, digit * 8, keyOf);
+        else
+            RadixSort::scatter<Key>(first, scratch, size, offsets, digit * 8, keyOf);
+        inScratch = not inScratch;
+    }
+    if (inScratch)
+    {
+        for (size_t idx = 0; idx < size; ++idx)
+        {
+            first[idx] = move(scratch[idx]);
+        }
+    }
+}
+//! @}
+} // namespace Algorithms
+} // namespace SC
@@ -0,0 +1,528 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "AlgorithmSimd.h"
+#include "../Foundation/LibC.h" // memmove
+
+// Kernels use compiler vector extensions, generating SSE2 / AVX2 / NEON code without including intrinsics headers
+#if (SC_COMPILER_GCC || SC_COMPILER_CLANG) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+#define SC_ALGORITHMS_SIMD_X86 1
+#else
+#define SC_ALGORITHMS_SIMD_X86 0
+#endif
+
+#if (SC_COMPILER_GCC || SC_COMPILER_CLANG) && defined(__aarch64__)
+#define SC_ALGORITHMS_SIMD_NEON 1
+#else
+#define SC_ALGORITHMS_SIMD_NEON 0
+#endif
+
+// AVX2 support is detected with __builtin_cpu_supports, that is not linked by default with clang-cl
+#define SC_ALGORITHMS_SIMD_AVX2 (SC_ALGORITHMS_SIMD_X86 && !SC_COMPILER_CLANG_CL)
+
+#if SC_ALGORITHMS_SIMD_X86 || SC_ALGORITHMS_SIMD_NEON
+#define SC_ALGORITHMS_SIMD_INLINE __attribute__((always_inline)) inline
+#endif
+
+struct SC::Algorithms::Simd::Internal
+{
+    static bool      levelIsForced;
+    static SimdLevel forcedLevel;
+
+    // Every kernel has a scalar implementation and a vector one, instantiated for 16 and 32 bytes vectors.
+    // Vector implementations are always inlined so that they can be compiled for AVX2 inside runAVX2.
+    template <typename Kernel, typename... Args>
+    static auto dispatch(Args... args)
+    {
+        switch (Simd::getLevel())
+        {
+#if SC_ALGORITHMS_SIMD_AVX2
+        case SimdLevel::AVX2: return runAVX2<Kernel>(args...);
+#endif
+#if SC_ALGORITHMS_SIMD_X86 || SC_ALGORITHMS_SIMD_NEON
+        case SimdLevel::SSE2:
+        case SimdLevel::NEON: return Kernel::template vector<16>(args...);
+#endif
+        default: break;
+        }
+        return Kernel::scalar(args...);
+    }
+
+#if SC_ALGORITHMS_SIMD_AVX2
+    template <typename Kernel, typename... Args>
+    __attribute__((target("avx2"))) static auto runAVX2(Args... args)
+    {
+        return Kernel::template vector<32>(args...);
+    }
+#endif
+
+    template <typename T>
+    using UnsignedOfSize = TypeTraits::ConditionalT<sizeof(T) == 1, uint8_t,
+                                                    TypeTraits::ConditionalT<sizeof(T) == 4, uint32_t, uint64_t>>;
+
+#if SC_ALGORITHMS_SIMD_X86 || SC_ALGORITHMS_SIMD_NEON
+    template <typename T, size_t Bytes>
+    struct VectorOf
+    {
+        typedef T type __attribute__((vector_size(Bytes)));
+    };
+
+    template <typename V, typename T>
+    SC_ALGORITHMS_SIMD_INLINE static void load(V& vector, const T* values)
+    {
+        __builtin_memcpy(&vector, values, sizeof(V));
+    }
+
+    // Checks if any lane of the result of a vector comparison is true (all bits set)
+    template <typename Mask>
+    SC_ALGORITHMS_SIMD_INLINE static bool anyTrue(const Mask& mask)
+    {
+        uint64_t words[sizeof(Mask) / sizeof(uint64_t)];
+        __builtin_memcpy(words, &mask, sizeof(Mask));
+        uint64_t result = 0;
+        for (size_t idx = 0; idx < sizeof(Mask) / sizeof(uint64_t); ++idx)
+        {
+            result |= words[idx];
+        }
+        return result != 0;
+    }
+#endif
+
+    template <typename T>
+    struct FindValue
+    {
+        static size_t scalar(const T* values, size_t numValues, T value)
+        {
+            for (size_t idx = 0; idx < numValues; ++idx)
+            {
+                if (values[idx] == value)
+                    return idx;
+            }
+            return numValues;
+        }
+
+#if SC_ALGORITHMS_SIMD_X86 || SC_ALGORITHMS_SIMD_NEON
+        template <size_t Bytes>
+        SC_ALGORITHMS_SIMD_INLINE static size_t vector(const T* values, size_t numValues, T value)
+        {
+            using V                = typename VectorOf<T, Bytes>::type;
+            constexpr size_t Lanes = Bytes / sizeof(T);
+
+            const V key = V{} + value;
+            size_t  idx = 0;
+            // Comparisons of four vectors are merged to check them with a single branch
+            for (; idx + 4 * Lanes <= numValues; idx += 4 * Lanes)
+            {
+                V v0, v1, v2, v3;
+                load(v0, values + idx);
+                load(v1, values + idx + Lanes);
+                load(v2, values + idx + 2 * Lanes);
+                load(v3, values + idx + 3 * Lanes);
+                if (anyTrue((v0 == key) | (v1 == key) | (v2 == key) | (v3 == key)))
+                    break;
+            }
+            for (; idx + Lanes <= numValues; idx += Lanes)
+            {
+                V v;
+                load(v, values + idx);
+                if (anyTrue(v == key))
+                    break;
+            }
+            return idx + scalar(values + idx, numValues - idx, value);
+        }
+#endif
+    };
+
+    template <typename T>
+    struct CountValue
+    {
+        static size_t scalar(const T* values, size_t numValues, T value)
+        {
+            size_t count = 0;
+            for (size_t idx = 0; idx < numValues; ++idx)
+            {
+                count += values[idx] == value ? 1 : 0;
+            }
+            return count;
+        }
+
+#if SC_ALGORITHMS_SIMD_X86 || SC_ALGORITHMS_SIMD_NEON
+        template <size_t Bytes>
+        SC_ALGORITHMS_SIMD_INLINE static size_t vector(const T* values, size_t numValues, T value)
+        {
+            using V                = typename VectorOf<T, Bytes>::type;
+            using U                = typename VectorOf<UnsignedOfSize<T>, Bytes>::type;
+            constexpr size_t Lanes = Bytes / sizeof(T);
+            // Lanes of the accumulator are summed before they can overflow
+            constexpr size_t MaxIterations = sizeof(T) == 1 ? 255 : 0xffff;
+
+            const V key   = V{} + value;
+            size_t  idx   = 0;
+            size_t  count = 0;
+            while (idx + Lanes <= numValues)
+            {
+                U accumulator = {};
+                for (size_t iteration = 0; iteration < MaxIterations and idx + Lanes <= numValues; ++iteration)
+                {
+                    V v;
+                    load(v, values + idx);
+                    accumulator -= static_cast<U>(v == key); // Comparison sets all bits (-1) of true lanes
+                    idx += Lanes;
+                }
+                for (size_t lane = 0; lane < Lanes; ++lane)
+                {
+                    count += static_cast<size_t>(accumulator[lane]);
+                }
+            }
+            return count + scalar(values + idx, numValues - idx, value);
+        }
+#endif
+    };
+
+    template <typename T>
+    struct FindMinMax
+    {
+        static void scalar(const T* values, size_t numValues, T* minValue, T* maxValue)
+        {
+            for (size_t idx = 0; idx < numValues; ++idx)
+            {
+                if (values[idx] < *minValue)
+                    *minValue = values[idx];
+                if (*maxValue < values[idx])
+                    *maxValue = values[idx];
+            }
+        }
+
+#if SC_ALGORITHMS_SIMD_X86 || SC_ALGORITHMS_SIMD_NEON
+        template <size_t Bytes>
+        SC_ALGORITHMS_SIMD_INLINE static void vector(const T* values, size_t numValues, T* minValue, T* maxValue)
+        {
+            using V                = typename VectorOf<T, Bytes>::type;
+            constexpr size_t Lanes = Bytes / sizeof(T);
+
+            size_t idx = 0;
+            if (numValues >= Lanes)
+            {
+                V minVector, maxVector;
+                load(minVector, values);
+                maxVector = minVector;
+                for (idx = Lanes; idx + Lanes <= numValues; idx += Lanes)
+                {
+                    V v;
+                    load(v, values + idx);
+                    minVector = v < minVector ? v : minVector;
+                    maxVector = maxVector < v ? v : maxVector;
+                }
+                for (size_t lane = 0; lane < Lanes; ++lane)
+                {
+                    if (minVector[lane] < *minValue)
+                        *minValue = minVector[lane];
+                    if (*maxValue < maxVector[lane])
+                        *maxValue = maxVector[lane];
+                }
+            }
+            scalar(values + idx, numValues - idx, minValue, maxValue);
+        }
+#endif
+    };
+
+    struct FindMismatch
+    {
+        static size_t scalar(const uint8_t* first, const uint8_t* second, size_t numBytes)
+        {
+            for (size_t idx = 0; idx < numBytes; ++idx)
+            {
+                if (first[idx] != second[idx])
+                    return idx;
+            }
+            return numBytes;
+        }
+
+#if SC_ALGORITHMS_SIMD_X86 || SC_ALGORITHMS_SIMD_NEON
+        template <size_t Bytes>
+        SC_ALGORITHMS_SIMD_INLINE static size_t vector(const uint8_t* first, const uint8_t* second, size_t numBytes)
+        {
+            using V = typename VectorOf<uint8_t, Bytes>::type;
+
+            size_t idx = 0;
+            for (; idx + 2 * Bytes <= numBytes; idx += 2 * Bytes)
+            {
+                V first0, first1, second0, second1;
+                load(first0, first + idx);
+                load(first1, first + idx + Bytes);
+                load(second0, second + idx);
+                load(second1, second + idx + Bytes);
+                if (anyTrue((first0 != second0) | (first1 != second1)))
+                    break;
+            }
+            for (; idx + Bytes <= numBytes; idx += Bytes)
+            {
+                V firstVector, secondVector;
+                load(firstVector, first + idx);
+                load(secondVector, second + idx);
+                if (anyTrue(firstVector != secondVector))
+                    break;
+            }
+            return idx + scalar(first + idx, second + idx, numBytes - idx);
+        }
+#endif
+    };
+
+    // ElementSize is the size of elements known at compile time (or zero to use elementSize)
+    template <size_t ElementSize>
+    struct RemoveMasked
+    {
+        // Moves values in [from, to) whose mask is zero after the first numKept values
+        static size_t removeRange(char* values, size_t elementSize, size_t from, size_t to, const uint8_t* removeMask,
+                                  size_t numKept)
+        {
+            const size_t size = ElementSize != 0 ? ElementSize : elementSize;
+            for (size_t idx = from; idx < to; ++idx)
+            {
+                if (removeMask[idx] == 0)
+                {
+                    if (numKept != idx) // numKept < idx so that source and destination never overlap
+                        __builtin_memcpy(values + numKept * size, values + idx * size, size);
+                    numKept++;
+                }
+            }
+            return numKept;
+        }
+
+        static size_t scalar(char* values, size_t elementSize, size_t numValues, const uint8_t* removeMask)
+        {
+            return removeRange(values, elementSize, 0, numValues, removeMask, 0);
+        }
+
+#if SC_ALGORITHMS_SIMD_X86 || SC_ALGORITHMS_SIMD_NEON
+        template <size_t Bytes>
+        SC_ALGORITHMS_SIMD_INLINE static size_t vector(char* values, size_t elementSize, size_t numValues,
+                                                       const uint8_t* removeMask)
+        {
+            using V           = typename VectorOf<uint8_t, Bytes>::type;
+            const size_t size = ElementSize != 0 ? ElementSize : elementSize;
+            const V      zero = {};
+
+            size_t idx = 0;
+            // Values before the first removed one stay where they are
+            for (; idx + Bytes <= numValues; idx += Bytes)
+            {
+                V mask;
+                load(mask, removeMask + idx);
+                if (anyTrue(mask != zero))
+                    break;
+            }
+            size_t numKept = idx;
+            for (; idx + Bytes <= numValues; idx += Bytes)
+            {
+                V mask;
+                load(mask, removeMask + idx);
+                if (not anyTrue(mask == zero))
+                    continue; // all values of the block are removed
+                if (not anyTrue(mask != zero))
+                {
+                    // all values of the block are kept
+                    ::memmove(values + numKept * size, values + idx * size, Bytes * size);
+                    numKept += Bytes;
+                    continue;
+                }
+                numKept = removeRange(values, size, idx, idx + Bytes, removeMask, numKept);
+            }
+            return removeRange(values, size, idx, numValues, removeMask, numKept);
+        }
+#endif
+    };
+
+    template <typename T>
+    static size_t findValue(const T* values, size_t numValues, T value)
+    {
+        return dispatch<FindValue<T>>(values, numValues, value);
+    }
+
+    template <typename T>
+    static size_t countValue(const T* values, size_t numValues, T value)
+    {
+        return dispatch<CountValue<T>>(values, numValues, value);
+    }
+
+    template <typename T>
+    static void findMinMax(const T* values, size_t numValues, T& minValue, T& maxValue)
+    {
+        minValue = values[0];
+        maxValue = values[0];
+        dispatch<FindMinMax<T>>(values, numValues, &minValue, &maxValue);
+    }
+
+    template <size_t ElementSize>
+    static size_t removeMasked(char* values, size_t elementSize, size_t numValues, const uint8_t* removeMask)
+    {
+        return dispatch<RemoveMasked<ElementSize>>(values, elementSize, numValues, removeMask);
+    }
+};
+
+bool SC::Algorithms::Simd::Internal::levelIsForced = false;
+
+SC::Algorithms::SimdLevel SC::Algorithms::Simd::Internal::forcedLevel = SC::Algorithms::SimdLevel::Scalar;
+
+SC::Algorithms::SimdLevel SC::Algorithms::Simd::getSupportedLevel()
+{
+#if SC_ALGORITHMS_SIMD_AVX2
+    if (__builtin_cpu_supports("avx2"))
+        return SimdLevel::AVX2;
+#endif
+#if SC_ALGORITHMS_SIMD_X86
+    return SimdLevel::SSE2;
+#elif SC_ALGORITHMS_SIMD_NEON
+    return SimdLevel::NEON;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+SC::Algorithms::SimdLevel SC::Algorithms::Simd::getLevel()
+{
+    return Internal::levelIsForced ? Internal::forcedLevel : getSupportedLevel();
+}
+
+SC::Algorithms::SimdLevel SC::Algorithms::Simd::setLevel(SimdLevel level)
+{
+    const SimdLevel supported = getSupportedLevel();
+    switch (level)
+    {
+    case SimdLevel::Scalar: break;
+    case SimdLevel::SSE2: level = SC_ALGORITHMS_SIMD_X86 ? level : supported; break;
+    case SimdLevel::AVX2: level = supported == SimdLevel::AVX2 ? level : supported; break;
+    case SimdLevel::NEON: level = SC_ALGORITHMS_SIMD_NEON ? level : supported; break;
+    }
+    Internal::levelIsForced = true;
+    Internal::forcedLevel   = level;
+    return level;
+}
+
+const char* SC::Algorithms::Simd::getLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::Scalar: return "Scalar";
+    case SimdLevel::SSE2: return "SSE2";
+    case SimdLevel::AVX2: return "AVX2";
+    case SimdLevel::NEON: return "NEON";
+    }
+    Assert::unreachable();
+}
+
+namespace SC
+{
+namespace Algorithms
+{
+size_t Simd::findValue(const uint8_t* values, size_t numValues, uint8_t value)
+{
+    return Internal::findValue(values, numValues, value);
+}
+
+size_t Simd::findValue(const uint32_t* values, size_t numValues, uint32_t value)
+{
+    return Internal::findValue(values, numValues, value);
+}
+
+size_t Simd::findValue(const uint64_t* values, size_t numValues, uint64_t value)
+{
+    return Internal::findValue(values, numValues, value);
+}
+
+size_t Simd::findValue(const float* values, size_t numValues, float value)
+{
+    return Internal::findValue(values, numValues, value);
+}
+
+size_t Simd::findValue(const double* values, size_t numValues, double value)
+{
+    return Internal::findValue(values, numValues, value);
+}
+
+size_t Simd::countValue(const uint8_t* values, size_t numValues, uint8_t value)
+{
+    return Internal::countValue(values, numValues, value);
+}
+
+size_t Simd::countValue(const uint32_t* values, size_t numValues, uint32_t value)
+{
+    return Internal::countValue(values, numValues, value);
+}
+
+size_t Simd::countValue(const uint64_t* values, size_t numValues, uint64_t value)
+{
+    return Internal::countValue(values, numValues, value);
+}
+
+size_t Simd::countValue(const float* values, size_t numValues, float value)
+{
+    return Internal::countValue(values, numValues, value);
+}
+
+size_t Simd::countValue(const double* values, size_t numValues, double value)
+{
+    return Internal::countValue(values, numValues, value);
+}
+
+void Simd::findMinMax(const int8_t* values, size_t numValues, int8_t& minValue, int8_t& maxValue)
+{
+    Internal::findMinMax(values, numValues, minValue, maxValue);
+}
+
+void Simd::findMinMax(const uint8_t* values, size_t numValues, uint8_t& minValue, uint8_t& maxValue)
+{
+    Internal::findMinMax(values, numValues, minValue, maxValue);
+}
+
+void Simd::findMinMax(const int32_t* values, size_t numValues, int32_t& minValue, int32_t& maxValue)
+{
+    Internal::findMinMax(values, numValues, minValue, maxValue);
+}
+
+void Simd::findMinMax(const uint32_t* values, size_t numValues, uint32_t& minValue, uint32_t& maxValue)
+{
+    Internal::findMinMax(values, numValues, minValue, maxValue);
+}
+
+void Simd::findMinMax(const int64_t* values, size_t numValues, int64_t& minValue, int64_t& maxValue)
+{
+    Internal::findMinMax(values, numValues, minValue, maxValue);
+}
+
+void Simd::findMinMax(const uint64_t* values, size_t numValues, uint64_t& minValue, uint64_t& maxValue)
+{
+    Internal::findMinMax(values, numValues, minValue, maxValue);
+}
+
+void Simd::findMinMax(const float* values, size_t numValues, float& minValue, float& maxValue)
+{
+    Internal::findMinMax(values, numValues, minValue, maxValue);
+}
+
+void Simd::findMinMax(const double* values, size_t numValues, double& minValue, double& maxValue)
+{
+    Internal::findMinMax(values, numValues, minValue, maxValue);
+}
+
+size_t Simd::findMismatch(const void* first, const void* second, size_t numBytes)
+{
+    return Internal::dispatch<Internal::FindMismatch>(static_cast<const uint8_t*>(first),
+                                                      static_cast<const uint8_t*>(second), numBytes);
+}
+
+size_t Simd::removeMasked(void* values, size_t elementSize, size_t numValues, const uint8_t* removeMask)
+{
+    char* bytes = static_cast<char*>(values);
+    // Common sizes are copied with constant size memcpy (a single load / store)
+    switch (elementSize)
+    {
+    case 1: return Internal::removeMasked<1>(bytes, elementSize, numValues, removeMask);
+    case 2: return Internal::removeMasked<2>(bytes, elementSize, numValues, removeMask);
+    case 4: return Internal::removeMasked<4>(bytes, elementSize, numValues, removeMask);
+    case 8: return Internal::removeMasked<8>(bytes, elementSize, numValues, removeMask);
+    case 16: return Internal::removeMasked<16>(bytes, elementSize, numValues, removeMask);
+    default: return Internal::removeMasked<0>(bytes, elementSize, numValues, removeMask);
+    }
+}
+} // namespace Algorithms
+} // namespace SC
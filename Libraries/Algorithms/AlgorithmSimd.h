@@ -0,0 +1,248 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "../Foundation/Assert.h"
+#include "../Foundation/Span.h"
+#include "../Foundation/TypeTraits.h" // EnableIf
+
+namespace SC
+{
+namespace Algorithms
+{
+//! @addtogroup group_algorithms
+//! @{
+
+/// @brief Instruction set used by SIMD algorithms (see SC::Algorithms::Simd)
+enum class SimdLevel : uint8_t
+{
+    Scalar = 0, ///< Plain loops (used when compiler vector extensions are not available, for example on MSVC)
+    SSE2,       ///< 16 bytes vectors on x86 (always available on x86_64)
+    AVX2,       ///< 32 bytes vectors on x86, used only if the CPU supports them
+    NEON,       ///< 16 bytes vectors on ARM64
+};
+
+/// @brief Runtime dispatch and type erased kernels of SIMD algorithms (SC::Algorithms::findValue and friends).
+///
+/// Kernels are compiled for SSE2 and AVX2 on x86 (NEON on ARM64) with compiler vector extensions, and every call
+/// selects the best one supported by the running CPU, so that binaries don't need to be built for a specific CPU.
+/// Compilers without vector extensions (MSVC) always use Scalar kernels.
+struct SC_COMPILER_EXPORT Simd
+{
+    /// @brief Returns the best instruction set supported by the CPU running the program
+    [[nodiscard]] static SimdLevel getSupportedLevel();
+
+    /// @brief Returns the instruction set currently used by SIMD algorithms
+    [[nodiscard]] static SimdLevel getLevel();
+
+    /// @brief Selects the instruction set used by SIMD algorithms (for example to compare them in a benchmark).
+    /// Falls back to Simd::getSupportedLevel if the CPU doesn't support the requested one.
+    /// @warning Must not be called while other threads are using SIMD algorithms
+    /// @return The instruction set that will be used
+    static SimdLevel setLevel(SimdLevel level);
+
+    /// @brief Returns a printable name of the instruction set
+    [[nodiscard]] static const char* getLevelName(SimdLevel level);
+
+    // Type erased kernels used by SC::Algorithms::findValue, countValue, findMinMax (numValues must be > 0)
+    // clang-format off
+    static size_t findValue(const uint8_t*  values, size_t numValues, uint8_t  value);
+    static size_t findValue(const uint32_t* values, size_t numValues, uint32_t value);
+    static size_t findValue(const uint64_t* values, size_t numValues, uint64_t value);
+    static size_t findValue(const float*    values, size_t numValues, float    value);
+    static size_t findValue(const double*   values, size_t numValues, double   value);
+
+    static size_t countValue(const uint8_t*  values, size_t numValues, uint8_t  value);
+    static size_t countValue(const uint32_t* values, size_t numValues, uint32_t value);
+    static size_t countValue(const uint64_t* values, size_t numValues, uint64_t value);
+    static size_t countValue(const float*    values, size_t numValues, float    value);
+    static size_t countValue(const double*   values, size_t numValues, double   value);
+
+    static void findMinMax(const int8_t*   values, size_t numValues, int8_t&   minValue, int8_t&   maxValue);
+    static void findMinMax(const uint8_t*  values, size_t numValues, uint8_t&  minValue, uint8_t&  maxValue);
+    static void findMinMax(const int32_t*  values, size_t numValues, int32_t&  minValue, int32_t&  maxValue);
+    static void findMinMax(const uint32_t* values, size_t numValues, uint32_t& minValue, uint32_t& maxValue);
+    static void findMinMax(const int64_t*  values, size_t numValues, int64_t&  minValue, int64_t&  maxValue);
+    static void findMinMax(const uint64_t* values, size_t numValues, uint64_t& minValue, uint64_t& maxValue);
+    static void findMinMax(const float*    values, size_t numValues, float&    minValue, float&    maxValue);
+    static void findMinMax(const double*   values, size_t numValues, double&   minValue, double&   maxValue);
+    // clang-format on
+
+    /// @brief Returns index of the first different byte (or numBytes if all bytes are equal)
+    static size_t findMismatch(const void* first, const void* second, size_t numBytes);
+
+    /// @brief Removes values whose removeMask byte is not zero, keeping order of the others
+    /// @return Number of values kept (moved at the beginning of values)
+    static size_t removeMasked(void* values, size_t elementSize, size_t numValues, const uint8_t* removeMask);
+
+  private:
+    struct Internal;
+};
+
+/// @brief Maps types to the ones handled by SC::Algorithms::Simd kernels
+template <typename T>
+struct SimdType
+{
+    static constexpr bool Equality = false; ///< Values can be compared with SC::Algorithms::Simd kernels
+    static constexpr bool Ordering = false; ///< Minimum and maximum can be found with SC::Algorithms::Simd kernels
+    using EqualityType             = T;     ///< Type with the same bits, used for equality comparisons
+};
+
+/// @brief Base of SimdType for types handled by SC::Algorithms::Simd kernels
+template <typename U, bool IsOrdered>
+struct SimdTypeKernel
+{
+    static constexpr bool Equality = true;
+    static constexpr bool Ordering = IsOrdered;
+    using EqualityType             = U;
+};
+// clang-format off
+template <> struct SimdType<char>     : SimdTypeKernel<uint8_t,  false> {};
+template <> struct SimdType<int8_t>   : SimdTypeKernel<uint8_t,  true> {};
+template <> struct SimdType<uint8_t>  : SimdTypeKernel<uint8_t,  true> {};
+template <> struct SimdType<int32_t>  : SimdTypeKernel<uint32_t, true> {};
+template <> struct SimdType<uint32_t> : SimdTypeKernel<uint32_t, true> {};
+template <> struct SimdType<int64_t>  : SimdTypeKernel<uint64_t, true> {};
+template <> struct SimdType<uint64_t> : SimdTypeKernel<uint64_t, true> {};
+template <> struct SimdType<float>    : SimdTypeKernel<float,    true> {};
+template <> struct SimdType<double>   : SimdTypeKernel<double,   true> {};
+// clang-format on
+
+/// @brief Finds index of the first item equal to value.
+/// Integer and floating point types are searched with SIMD instructions (see SC::Algorithms::Simd), as `memchr` does
+/// for bytes. Other types are compared one by one with `==`.
+/// @return Index of the found item or `values.sizeInElements()` if not found
+template <typename T>
+[[nodiscard]] typename TypeTraits::EnableIf<SimdType<T>::Equality, size_t>::type findValue(Span<const T> values,
+                                                                                            T             value)
+{
+    using U = typename SimdType<T>::EqualityType;
+    return Simd::findValue(reinterpret_cast<const U*>(values.data()), values.sizeInElements(),
+                           *reinterpret_cast<const U*>(&value));
+}
+
+template <typename T>
+[[nodiscard]] typename TypeTraits::EnableIf<not SimdType<T>::Equality, size_t>::type findValue(Span<const T> values,
+                                                                                                const T&      value)
+{
+    for (size_t idx = 0; idx < values.sizeInElements(); ++idx)
+    {
+        if (values[idx] == value)
+            return idx;
+    }
+    return values.sizeInElements();
+}
+
+/// @brief Counts items equal to value (using SIMD instructions for integer and floating point types)
+template <typename T>
+[[nodiscard]] typename TypeTraits::EnableIf<SimdType<T>::Equality, size_t>::type countValue(Span<const T> values,
+                                                                                             T             value)
+{
+    using U = typename SimdType<T>::EqualityType;
+    return Simd::countValue(reinterpret_cast<const U*>(values.data()), values.sizeInElements(),
+                            *reinterpret_cast<const U*>(&value));
+}
+
+template <typename T>
+[[nodiscard]] typename TypeTraits::EnableIf<not SimdType<T>::Equality, size_t>::type countValue(Span<const T> values,
+                                                                                                 const T&      value)
+{
+    size_t count = 0;
+    for (size_t idx = 0; idx < values.sizeInElements(); ++idx)
+    {
+        count += values[idx] == value ? 1 : 0;
+    }
+    return count;
+}
+
+/// @brief Finds minimum and maximum of values (using SIMD instructions for integer and floating point types).
+/// Result is unspecified if floating point values contain NaN.
+/// @return `false` if values is empty
+template <typename T>
+[[nodiscard]] typename TypeTraits::EnableIf<SimdType<T>::Ordering, bool>::type findMinMax(Span<const T> values,
+                                                                                          T& minValue, T& maxValue)
+{
+    if (values.empty())
+        return false;
+    Simd::findMinMax(values.data(), values.sizeInElements(), minValue, maxValue);
+    return true;
+}
+
+template <typename T>
+[[nodiscard]] typename TypeTraits::EnableIf<not SimdType<T>::Ordering, bool>::type findMinMax(Span<const T> values,
+                                                                                              T& minValue, T& maxValue)
+{
+    if (values.empty())
+        return false;
+    minValue = values[0];
+    maxValue = values[0];
+    for (size_t idx = 1; idx < values.sizeInElements(); ++idx)
+    {
+        if (values[idx] < minValue)
+            minValue = values[idx];
+        if (maxValue < values[idx])
+            maxValue = values[idx];
+    }
+    return true;
+}
+
+/// @brief Returns index of the first item that differs between first and second (or the size of the shortest one).
+/// Integer types are compared with SIMD instructions, as `memcmp` does for bytes.
+template <typename T>
+[[nodiscard]] size_t findMismatch(Span<const T> first, Span<const T> second)
+{
+    const size_t numValues = first.sizeInElements() < second.sizeInElements() ? first.sizeInElements()
+                                                                                : second.sizeInElements();
+    // Floating point values comparing equal can have different bits (0.0 and -0.0)
+    constexpr bool Bitwise = SimdType<T>::Equality and not TypeTraits::IsSame<T, float>::value and
+                             not TypeTraits::IsSame<T, double>::value;
+    if (Bitwise)
+    {
+        return Simd::findMismatch(first.data(), second.data(), numValues * sizeof(T)) / sizeof(T);
+    }
+    for (size_t idx = 0; idx < numValues; ++idx)
+    {
+        if (not(first[idx] == second[idx]))
+            return idx;
+    }
+    return numValues;
+}
+
+/// @brief Checks if first and second have the same size and all of their items are equal
+template <typename T>
+[[nodiscard]] bool equal(Span<const T> first, Span<const T> second)
+{
+    return first.sizeInElements() == second.sizeInElements() and
+           findMismatch(first, second) == first.sizeInElements();
+}
+
+/// @brief Compares first and second lexicographically (as `memcmp` does for bytes)
+/// @return A negative value if first comes before second, a positive one if it comes after, `0` if they're equal
+template <typename T>
+[[nodiscard]] int compare(Span<const T> first, Span<const T> second)
+{
+    const size_t idx = findMismatch(first, second);
+    if (idx < first.sizeInElements() and idx < second.sizeInElements())
+    {
+        return first[idx] < second[idx] ? -1 : 1;
+    }
+    if (first.sizeInElements() == second.sizeInElements())
+        return 0;
+    return first.sizeInElements() < second.sizeInElements() ? -1 : 1;
+}
+
+/// @brief Removes all items whose byte in removeMask is not zero, keeping the order of the other items.
+/// The mask is scanned with SIMD instructions so that runs of kept or removed items are handled a vector at a time.
+/// @note Items must be trivially copyable, as they're moved with `memmove`
+/// @param values Items to compact (kept items are moved at the beginning)
+/// @param removeMask One byte for every item, non-zero if the item must be removed
+/// @return Number of items kept
+template <typename T>
+[[nodiscard]] size_t removeMasked(Span<T> values, Span<const uint8_t> removeMask)
+{
+    static_assert(TypeTraits::IsTriviallyCopyable<T>::value, "removeMasked needs trivially copyable items");
+    SC_ASSERT_RELEASE(removeMask.sizeInElements() == values.sizeInElements());
+    return Simd::removeMasked(values.data(), sizeof(T), values.sizeInElements(), removeMask.data());
+}
+//! @}
+} // namespace Algorithms
+} // namespace SC
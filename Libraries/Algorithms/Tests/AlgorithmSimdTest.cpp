@@ -0,0 +1,273 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../AlgorithmSimd.h"
+#include "../../Testing/Testing.h"
+
+namespace SC
+{
+struct AlgorithmSimdTest;
+}
+
+struct SC::AlgorithmSimdTest : public SC::TestCase
+{
+    static constexpr size_t MaxValues = 300; // Larger than a few unrolled AVX2 iterations of 8 bits values
+
+    AlgorithmSimdTest(SC::TestReport& report) : TestCase(report, "AlgorithmSimdTest")
+    {
+        using namespace SC;
+        using namespace SC::Algorithms;
+        const SimdLevel levels[] = {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::NEON};
+        if (test_section("level"))
+        {
+            const SimdLevel supported = Simd::getSupportedLevel();
+            report.console.print("Supported SIMD level: {}\n", Simd::getLevelName(supported));
+            SC_TEST_EXPECT(Simd::setLevel(SimdLevel::Scalar) == SimdLevel::Scalar);
+            SC_TEST_EXPECT(Simd::getLevel() == SimdLevel::Scalar);
+            SC_TEST_EXPECT(Simd::setLevel(supported) == supported);
+            SC_TEST_EXPECT(Simd::getLevel() == supported);
+        }
+        // Every algorithm is tested at all levels supported by the CPU, for all sizes up to MaxValues
+        for (SimdLevel level : levels)
+        {
+            if (Simd::setLevel(level) != level)
+                continue;
+            if (test_section("find"))
+            {
+                SC_TEST_EXPECT(testFind<uint8_t>());
+                SC_TEST_EXPECT(testFind<char>());
+                SC_TEST_EXPECT(testFind<int32_t>());
+                SC_TEST_EXPECT(testFind<uint64_t>());
+                SC_TEST_EXPECT(testFind<float>());
+                SC_TEST_EXPECT(testFind<double>());
+            }
+            if (test_section("count"))
+            {
+                SC_TEST_EXPECT(testCount<uint8_t>());
+                SC_TEST_EXPECT(testCount<int32_t>());
+                SC_TEST_EXPECT(testCount<int64_t>());
+                SC_TEST_EXPECT(testCount<float>());
+                SC_TEST_EXPECT(testCount<double>());
+                // 8 bits lanes must not overflow
+                uint8_t bytes[70000];
+                for (size_t idx = 0; idx < sizeof(bytes); ++idx)
+                {
+                    bytes[idx] = idx % 7 == 0 ? 1 : 0;
+                }
+                SC_TEST_EXPECT(countValue<uint8_t>(bytes, 1) == (sizeof(bytes) + 6) / 7);
+            }
+            if (test_section("min max"))
+            {
+                SC_TEST_EXPECT(testMinMax<int8_t>());
+                SC_TEST_EXPECT(testMinMax<uint8_t>());
+                SC_TEST_EXPECT(testMinMax<int32_t>());
+                SC_TEST_EXPECT(testMinMax<uint32_t>());
+                SC_TEST_EXPECT(testMinMax<int64_t>());
+                SC_TEST_EXPECT(testMinMax<uint64_t>());
+                SC_TEST_EXPECT(testMinMax<float>());
+                SC_TEST_EXPECT(testMinMax<double>());
+                int minValue = 0, maxValue = 0;
+                SC_TEST_EXPECT(not findMinMax<int>({}, minValue, maxValue));
+            }
+            if (test_section("equal / compare"))
+            {
+                SC_TEST_EXPECT(testCompare<uint8_t>());
+                SC_TEST_EXPECT(testCompare<int32_t>());
+                SC_TEST_EXPECT(testCompare<uint64_t>());
+                SC_TEST_EXPECT(testCompare<double>());
+                // Floating point values are compared by value and not by their bits
+                const float zeros[]         = {0.0f, 1.0f};
+                const float negativeZeros[] = {-0.0f, 1.0f};
+                SC_TEST_EXPECT(equal<float>(zeros, negativeZeros));
+                SC_TEST_EXPECT(compare<char>({"abc", 3}, {"abd", 3}) < 0);
+                SC_TEST_EXPECT(compare<char>({"abc", 3}, {"ab", 2}) > 0);
+            }
+            if (test_section("remove masked"))
+            {
+                SC_TEST_EXPECT(testRemoveMasked<uint8_t>());
+                SC_TEST_EXPECT(testRemoveMasked<uint16_t>());
+                SC_TEST_EXPECT(testRemoveMasked<uint32_t>());
+                SC_TEST_EXPECT(testRemoveMasked<uint64_t>());
+                SC_TEST_EXPECT(testRemoveMasked<Triplet>());
+            }
+        }
+        (void)Simd::setLevel(Simd::getSupportedLevel());
+        if (test_section("snippet"))
+        {
+            simdSnippet();
+        }
+    }
+
+    struct Triplet // An item with a size that's not a power of two
+    {
+        uint32_t values[3];
+
+        Triplet() = default;
+        Triplet(size_t value) : values{static_cast<uint32_t>(value), 0, static_cast<uint32_t>(value)} {}
+        bool operator==(const Triplet& other) const
+        {
+            return values[0] == other.values[0] and values[1] == other.values[1] and values[2] == other.values[2];
+        }
+    };
+
+    template <typename T>
+    static T makeValue(size_t idx)
+    {
+        return static_cast<T>(idx % 100 + 1); // Values in [1, 100]
+    }
+
+    template <typename T>
+    bool testFind()
+    {
+        T values[MaxValues];
+        for (size_t idx = 0; idx < MaxValues; ++idx)
+        {
+            values[idx] = makeValue<T>(idx);
+        }
+        for (size_t numValues = 0; numValues <= MaxValues; ++numValues)
+        {
+            // Search values at many positions (they all differ in the first 100 values)
+            const size_t position = numValues > 100 ? numValues % 100 : numValues / 2;
+            const size_t expected = position < numValues ? position : numValues;
+            if (numValues > 0 and Algorithms::findValue<T>({values, numValues}, values[position]) != expected)
+                return false;
+            if (Algorithms::findValue<T>({values, numValues}, static_cast<T>(0)) != numValues)
+                return false;
+            // Search starting from an unaligned address
+            if (numValues > 1)
+            {
+                const size_t found = Algorithms::findValue<T>({values + 1, numValues - 1}, values[numValues - 1]);
+                if (found > numValues - 2)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename T>
+    bool testCount()
+    {
+        T values[MaxValues];
+        for (size_t numValues = 0; numValues <= MaxValues; ++numValues)
+        {
+            size_t expected = 0;
+            for (size_t idx = 0; idx < numValues; ++idx)
+            {
+                values[idx] = makeValue<T>(idx % 5);
+                expected += idx % 5 == 3 ? 1 : 0;
+            }
+            if (Algorithms::countValue<T>({values, numValues}, makeValue<T>(3)) != expected)
+                return false;
+        }
+        return true;
+    }
+
+    template <typename T>
+    bool testMinMax()
+    {
+        T values[MaxValues];
+        for (size_t numValues = 1; numValues <= MaxValues; ++numValues)
+        {
+            for (size_t idx = 0; idx < numValues; ++idx)
+            {
+                values[idx] = static_cast<T>(idx % 50 + 10);
+            }
+            // Place extremes at positions that change with the size
+            const size_t minPosition = (numValues * 7 / 11) % numValues;
+            const size_t maxPosition = (minPosition + 1 + numValues / 3) % numValues;
+            values[minPosition]      = static_cast<T>(3);
+            values[maxPosition]      = static_cast<T>(97);
+            T minValue, maxValue;
+            if (not Algorithms::findMinMax<T>({values, numValues}, minValue, maxValue))
+                return false;
+            const T expectedMin = static_cast<T>(numValues == 1 ? 97 : 3);
+            if (not(minValue == expectedMin and maxValue == static_cast<T>(97)))
+                return false;
+        }
+        return true;
+    }
+
+    template <typename T>
+    bool testCompare()
+    {
+        T first[MaxValues], second[MaxValues];
+        for (size_t idx = 0; idx < MaxValues; ++idx)
+        {
+            first[idx]  = makeValue<T>(idx);
+            second[idx] = makeValue<T>(idx);
+        }
+        for (size_t numValues = 1; numValues <= MaxValues; ++numValues)
+        {
+            const Span<const T> firstSpan  = {first, numValues};
+            const Span<const T> secondSpan = {second, numValues};
+            if (not Algorithms::equal(firstSpan, secondSpan) or Algorithms::compare(firstSpan, secondSpan) != 0)
+                return false;
+            const size_t position = numValues * 5 / 7;
+            second[position]      = static_cast<T>(120); // Larger than all values of first
+            if (Algorithms::equal(firstSpan, secondSpan) or Algorithms::findMismatch(firstSpan, secondSpan) != position)
+                return false;
+            if (Algorithms::compare(firstSpan, secondSpan) >= 0 or Algorithms::compare(secondSpan, firstSpan) <= 0)
+                return false;
+            second[position] = first[position];
+            if (Algorithms::compare<T>({first, numValues - 1}, secondSpan) >= 0)
+                return false;
+        }
+        return true;
+    }
+
+    template <typename T>
+    bool testRemoveMasked()
+    {
+        T       values[MaxValues];
+        uint8_t mask[MaxValues];
+        for (size_t numValues = 0; numValues <= MaxValues; ++numValues)
+        {
+            for (size_t idx = 0; idx < numValues; ++idx)
+            {
+                values[idx] = T(idx);
+                // Runs of kept, removed and mixed values longer than a vector
+                const size_t run = (idx / 40) % 3;
+                mask[idx]        = run == 0 ? 0 : (run == 1 ? 1 : static_cast<uint8_t>(idx % 3 == 0 ? 0xff : 0));
+            }
+            const size_t numKept = Algorithms::removeMasked<T>({values, numValues}, {mask, numValues});
+            size_t       kept    = 0;
+            for (size_t idx = 0; idx < numValues; ++idx)
+            {
+                if (mask[idx] == 0)
+                {
+                    if (kept >= numKept or not(values[kept] == T(idx)))
+                        return false;
+                    kept++;
+                }
+            }
+            if (kept != numKept)
+                return false;
+        }
+        return true;
+    }
+
+    void simdSnippet();
+};
+
+void SC::AlgorithmSimdTest::simdSnippet()
+{
+    //! [algorithmSimdSnippet]
+    using namespace SC::Algorithms;
+    int32_t ids[]     = {4, 8, 15, 16, 23, 42, 8};
+    uint8_t removed[] = {0, 1, 0, 0, 1, 0, 1};
+
+    SC_TEST_EXPECT(findValue<int32_t>(ids, 15) == 2);
+    SC_TEST_EXPECT(countValue<int32_t>(ids, 8) == 2);
+    int32_t minValue, maxValue;
+    SC_TEST_EXPECT(findMinMax<int32_t>(ids, minValue, maxValue));
+    SC_TEST_EXPECT(minValue == 4 and maxValue == 42);
+    // Remove all items with a non zero byte in the mask
+    const size_t numKept = removeMasked<int32_t>(ids, removed);
+    SC_TEST_EXPECT(numKept == 4);
+    SC_TEST_EXPECT(equal<int32_t>({ids, numKept}, {4, 15, 16, 42}));
+    //! [algorithmSimdSnippet]
+}
+
+namespace SC
+{
+void runAlgorithmSimdTest(SC::TestReport& report) { AlgorithmSimdTest test(report); }
+} // namespace SC
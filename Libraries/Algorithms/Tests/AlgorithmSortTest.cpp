@@ -0,0 +1,254 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../AlgorithmMergeSort.h"
+#include "../AlgorithmQuickSort.h"
+#include "../AlgorithmRadixSort.h"
+#include "../../Testing/Testing.h"
+
+namespace SC
+{
+struct AlgorithmSortTest;
+
+// Sorts a permutation of [0, 40) returning the sum of indices holding their own value (780 when sorted)
+constexpr int sortAtCompileTime(bool quick)
+{
+    int values[40]  = {};
+    int scratch[20] = {};
+    for (int idx = 0; idx < 40; ++idx)
+    {
+        values[idx] = (idx * 7) % 40;
+    }
+    if (quick)
+        Algorithms::quickSort(values, values + 40);
+    else
+        Algorithms::mergeSort(values, values + 40, scratch);
+    int sortedValues = 0;
+    for (int idx = 0; idx < 40; ++idx)
+    {
+        sortedValues += values[idx] == idx ? idx : 0;
+    }
+    return sortedValues;
+}
+} // namespace SC
+
+struct SC::AlgorithmSortTest : public SC::TestCase
+{
+    static constexpr size_t MaxValues = 2000;
+
+    enum class Distribution
+    {
+        Random,
+        Sorted,
+        Reversed,
+        FewUnique,
+        OrganPipe,
+        Sawtooth,
+        AllEqual,
+    };
+
+    struct Item
+    {
+        int32_t  key   = 0;
+        uint32_t order = 0; // Position before sorting, to check stability
+
+        constexpr bool operator<(const Item& other) const { return key < other.key; }
+    };
+
+    uint32_t randomState = 1;
+
+    uint32_t random()
+    {
+        randomState ^= randomState << 13; // xorshift32
+        randomState ^= randomState >> 17;
+        randomState ^= randomState << 5;
+        return randomState;
+    }
+
+    void fill(Distribution distribution, Item* items, size_t numItems)
+    {
+        for (size_t idx = 0; idx < numItems; ++idx)
+        {
+            const int32_t position = static_cast<int32_t>(idx);
+            const int32_t size     = static_cast<int32_t>(numItems);
+            int32_t       key      = 0;
+            switch (distribution)
+            {
+            case Distribution::Random: key = static_cast<int32_t>(random()); break;
+            case Distribution::Sorted: key = position; break;
+            case Distribution::Reversed: key = size - position; break;
+            case Distribution::FewUnique: key = static_cast<int32_t>(random() % 4) - 2; break;
+            case Distribution::OrganPipe: key = position < size / 2 ? position : size - position; break;
+            case Distribution::Sawtooth: key = position % 37; break;
+            case Distribution::AllEqual: key = 42; break;
+            }
+            items[idx].key   = key;
+            items[idx].order = static_cast<uint32_t>(idx);
+        }
+    }
+
+    // Checks that items are sorted by key, and if stable is true that items with equal keys kept their order
+    static bool isSorted(const Item* items, size_t numItems, bool stable)
+    {
+        for (size_t idx = 1; idx < numItems; ++idx)
+        {
+            if (items[idx].key < items[idx - 1].key)
+                return false;
+            if (stable and items[idx].key == items[idx - 1].key and items[idx].order < items[idx - 1].order)
+                return false;
+        }
+        return true;
+    }
+
+    AlgorithmSortTest(SC::TestReport& report) : TestCase(report, "AlgorithmSortTest")
+    {
+        using namespace SC;
+        const Distribution distributions[] = {Distribution::Random,    Distribution::Sorted,   Distribution::Reversed,
+                                              Distribution::FewUnique, Distribution::OrganPipe, Distribution::Sawtooth,
+                                              Distribution::AllEqual};
+
+        const size_t sizes[] = {0, 1, 2, 3, 15, 16, 17, 23, 24, 25, 100, 127, 128, 129, 500, MaxValues};
+
+        Item items[MaxValues];
+        Item scratch[MaxValues];
+        if (test_section("insertionSort"))
+        {
+            bool sorted = true;
+            for (Distribution distribution : distributions)
+            {
+                for (size_t numItems : {size_t(0), size_t(1), size_t(2), size_t(31), size_t(200)})
+                {
+                    fill(distribution, items, numItems);
+                    Algorithms::insertionSort(items, items + numItems);
+                    sorted = sorted and isSorted(items, numItems, true);
+                }
+            }
+            SC_TEST_EXPECT(sorted);
+        }
+        if (test_section("quickSort"))
+        {
+            bool sorted = true;
+            for (Distribution distribution : distributions)
+            {
+                for (size_t numItems : sizes)
+                {
+                    fill(distribution, items, numItems);
+                    Algorithms::quickSort(items, items + numItems);
+                    sorted = sorted and isSorted(items, numItems, false);
+                }
+            }
+            SC_TEST_EXPECT(sorted);
+            // Custom predicate
+            fill(Distribution::Random, items, MaxValues);
+            Algorithms::quickSort(items, items + MaxValues, [](const Item& a, const Item& b) { return b < a; });
+            bool descending = true;
+            for (size_t idx = 1; idx < MaxValues; ++idx)
+            {
+                descending = descending and not(items[idx - 1] < items[idx]);
+            }
+            SC_TEST_EXPECT(descending);
+        }
+        if (test_section("mergeSort"))
+        {
+            bool sorted = true;
+            for (Distribution distribution : distributions)
+            {
+                for (size_t numItems : sizes)
+                {
+                    fill(distribution, items, numItems);
+                    Algorithms::mergeSort(items, items + numItems, scratch);
+                    sorted = sorted and isSorted(items, numItems, true);
+                }
+            }
+            SC_TEST_EXPECT(sorted);
+
+            // Merging two sorted halves into a separate output
+            fill(Distribution::FewUnique, items, MaxValues);
+            Item* middle = items + MaxValues / 2;
+            Algorithms::mergeSort(items, middle, scratch);
+            Algorithms::mergeSort(middle, items + MaxValues, scratch);
+            Item* end = Algorithms::merge(items, middle, middle, items + MaxValues, scratch);
+            SC_TEST_EXPECT(end == scratch + MaxValues);
+            SC_TEST_EXPECT(isSorted(scratch, MaxValues, true));
+        }
+        if (test_section("radixSort"))
+        {
+            bool sorted = true;
+            for (Distribution distribution : distributions)
+            {
+                for (size_t numItems : sizes)
+                {
+                    fill(distribution, items, numItems);
+                    Algorithms::radixSort(items, items + numItems, scratch, [](const Item& item) { return item.key; });
+                    sorted = sorted and isSorted(items, numItems, true);
+                }
+            }
+            SC_TEST_EXPECT(sorted);
+            SC_TEST_EXPECT(testRadixSortKeys());
+        }
+        if (test_section("constexpr"))
+        {
+            static_assert(sortAtCompileTime(true) == 40 * 39 / 2, "quickSort must be usable in constexpr");
+            static_assert(sortAtCompileTime(false) == 40 * 39 / 2, "mergeSort must be usable in constexpr");
+        }
+        if (test_section("snippet"))
+        {
+            sortSnippet();
+        }
+    }
+
+    bool testRadixSortKeys()
+    {
+        int64_t  integers[MaxValues], integersScratch[MaxValues];
+        double   doubles[MaxValues], doublesScratch[MaxValues];
+        uint16_t shorts[MaxValues], shortsScratch[MaxValues];
+        for (size_t idx = 0; idx < MaxValues; ++idx)
+        {
+            integers[idx] = static_cast<int64_t>(random()) * (idx % 2 == 0 ? -1 : 1) * 1000;
+            doubles[idx]  = static_cast<double>(static_cast<int32_t>(random())) / 1000.0;
+            shorts[idx]   = static_cast<uint16_t>(random());
+        }
+        doubles[10] = -0.0;
+        doubles[11] = 0.0;
+        Algorithms::radixSort(integers, integers + MaxValues, integersScratch);
+        Algorithms::radixSort(doubles, doubles + MaxValues, doublesScratch);
+        Algorithms::radixSort(shorts, shorts + MaxValues, shortsScratch);
+        for (size_t idx = 1; idx < MaxValues; ++idx)
+        {
+            if (integers[idx] < integers[idx - 1] or doubles[idx] < doubles[idx - 1] or shorts[idx] < shorts[idx - 1])
+                return false;
+        }
+        return true;
+    }
+
+    void sortSnippet();
+};
+
+void SC::AlgorithmSortTest::sortSnippet()
+{
+    //! [algorithmSortSnippet]
+    struct Person
+    {
+        uint32_t age;
+        char     initial;
+    };
+    Person people[] = {{42, 'A'}, {18, 'B'}, {42, 'C'}, {7, 'D'}};
+    Person scratch[4];
+    auto   byAge = [](const Person& a, const Person& b) { return a.age < b.age; };
+
+    // Fast, not stable and without additional memory
+    Algorithms::quickSort(people, people + 4, byAge);
+    SC_TEST_EXPECT(people[0].initial == 'D' and people[1].initial == 'B');
+
+    // Stable (A stays before C), using scratch memory for half of the items
+    Algorithms::mergeSort(people, people + 4, scratch, byAge);
+
+    // Stable and linear time for integer or floating point keys, using scratch memory for all items
+    Algorithms::radixSort(people, people + 4, scratch, [](const Person& person) { return person.age; });
+    SC_TEST_EXPECT(people[2].initial == 'A' or people[2].initial == 'C');
+    //! [algorithmSortSnippet]
+}
+
+namespace SC
+{
+void runAlgorithmSortTest(SC::TestReport& report) { AlgorithmSortTest test(report); }
+} // namespace SC
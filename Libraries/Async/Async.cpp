@@ -12,6 +12,7 @@
 #include "Internal/AsyncEmscripten.inl"
 #endif
 
+#include "../Threading/JobSystem.h" // JobCounter
 #include "../Threading/ThreadPool.h"
 #include "../Threading/Threading.h" // EventObject
 
@@ -424,6 +425,114 @@ SC::Result SC::AsyncEventLoopMonitor::close()
     return Result(true);
 }
 
+//-------------------------------------------------------------------------------------------------------
+// AsyncEventLoopJobs
+//-------------------------------------------------------------------------------------------------------
+
+// Lives on the stack of the job calling AsyncEventLoopJobs::startAndWait, until the counter reaches zero
+struct SC::AsyncEventLoopJobs::Request
+{
+    StartFunction startRequest;
+    JobCounter    counter;
+    Result        result = Result(true);
+    Request*      next   = nullptr;
+};
+
+SC::Result SC::AsyncEventLoopJobs::create(AsyncEventLoop& loop)
+{
+    SC_TRY_MSG(eventLoop == nullptr, "AsyncEventLoopJobs::create - Already initialized");
+    eventLoopWakeUp.callback = [this](AsyncLoopWakeUp::Result& result)
+    {
+        result.reactivateRequest(true);
+        startPendingRequests();
+    };
+    SC_TRY(eventLoopWakeUp.start(loop));
+    eventLoop = &loop;
+    return Result(true);
+}
+
+SC::Result SC::AsyncEventLoopJobs::close()
+{
+    SC_TRY_MSG(eventLoop != nullptr, "AsyncEventLoopJobs::close - Not initialized");
+    mutex.lock();
+    const bool hasPendingRequests = pendingHead != nullptr;
+    mutex.unlock();
+    SC_TRY_MSG(not hasPendingRequests, "AsyncEventLoopJobs::close - Jobs are still waiting for requests to start");
+    SC_TRY(eventLoopWakeUp.stop());
+    eventLoop = nullptr;
+    return Result(true);
+}
+
+SC::Result SC::AsyncEventLoopJobs::startAndWait(StartFunction&& startRequest)
+{
+    SC_TRY_MSG(eventLoop != nullptr, "AsyncEventLoopJobs::startAndWait - Not initialized");
+    Request request;
+    request.startRequest = move(startRequest);
+    request.counter.increment();
+
+    mutex.lock();
+    if (pendingTail)
+    {
+        pendingTail->next = &request;
+    }
+    else
+    {
+        pendingHead = &request;
+    }
+    pendingTail = &request;
+    mutex.unlock();
+
+    Result wakeUpResult = eventLoopWakeUp.wakeUp();
+    if (not wakeUpResult and removePendingRequest(request))
+    {
+        return wakeUpResult;
+    }
+    request.counter.wait(); // Suspends the fiber (or blocks the thread) until all requests complete
+    return request.result;
+}
+
+bool SC::AsyncEventLoopJobs::removePendingRequest(Request& request)
+{
+    mutex.lock();
+    Request* previous = nullptr;
+    Request* current  = pendingHead;
+    while (current != nullptr and current != &request)
+    {
+        previous = current;
+        current  = current->next;
+    }
+    if (current != nullptr)
+    {
+        (previous ? previous->next : pendingHead) = current->next;
+        if (pendingTail == current)
+        {
+            pendingTail = previous;
+        }
+    }
+    mutex.unlock();
+    return current != nullptr; // false means that the event loop thread has already taken the request
+}
+
+void SC::AsyncEventLoopJobs::startPendingRequests()
+{
+    mutex.lock();
+    Request* request = pendingHead;
+    pendingHead      = nullptr;
+    pendingTail      = nullptr;
+    mutex.unlock();
+    while (request != nullptr)
+    {
+        Request* next = request->next; // request can be released as soon as its counter reaches zero
+        Result   res  = request->startRequest(*eventLoop, request->counter);
+        if (not res)
+        {
+            request->result = res;
+            request->counter.decrement();
+        }
+        request = next;
+    }
+}
+
 //-------------------------------------------------------------------------------------------------------
 // AsyncEventLoop::Internal
 //-------------------------------------------------------------------------------------------------------
@@ -488,6 +597,10 @@ void SC::AsyncEventLoop::Internal::invokeExpiredTimers(Time::HighResolutionCount
                 async->state = AsyncRequest::State::Submitting;
                 submissions.queueBack(*async);
             }
+            else if (async->state == AsyncRequest::State::Free)
+            {
+                async->markAsFree();
+            }
         }
     }
 }
@@ -641,6 +754,11 @@ SC::Result SC::AsyncEventLoop::Internal::completeAndEventuallyReactivate(KernelE
     else
     {
         SC_TRY(teardownAsync(kernelEvents, async));
+        if (async.state == AsyncRequest::State::Free)
+        {
+            // Detach from the loop so that the request can be started again (for example from another callback)
+            async.markAsFree();
+        }
     }
     if (not returnCode)
     {
@@ -693,7 +811,8 @@ SC::Result SC::AsyncEventLoop::Internal::blockingPoll(SyncMode syncMode, AsyncKe
     {
         // We may have some manualCompletions queued (for SocketClose for example) but no active handles
         SC_LOG_MESSAGE("Active Requests Before Poll = {}\n", getTotalNumberOfActiveHandle());
-        SC_TRY(kernelEvents.syncWithKernel(*loop, syncMode));
+        // Don't block waiting for other requests if some manual completions are already waiting to be dispatched
+        SC_TRY(kernelEvents.syncWithKernel(*loop, manualCompletions.isEmpty() ? syncMode : SyncMode::NoWait));
         SC_LOG_MESSAGE("Active Requests After Poll = {}\n", getTotalNumberOfActiveHandle());
     }
     return SC::Result(true);
@@ -1040,6 +1159,8 @@ SC::Result SC::AsyncEventLoop::wakeUpFromExternalThread(AsyncLoopWakeUp& async)
 
 void SC::AsyncEventLoop::Internal::executeWakeUps(AsyncResult& result)
 {
+    // Reset pending flags before invoking callbacks, so that wake ups requested while they're running are not lost
+    wakeUpPending.exchange(false);
     AsyncLoopWakeUp* async;
     for (async = activeLoopWakeUps.front; //
          async != nullptr;                //
@@ -1047,7 +1168,7 @@ void SC::AsyncEventLoop::Internal::executeWakeUps(AsyncResult& result)
     {
         SC_ASSERT_DEBUG(async->type == AsyncRequest::Type::LoopWakeUp);
         AsyncLoopWakeUp* notifier = async;
-        if (notifier->pending.load() == true)
+        if (notifier->pending.exchange(false) == true) // allow executing the notification again
         {
             AsyncLoopWakeUp::Result asyncResult(*notifier, Result(true));
             asyncResult.getAsync().callback(asyncResult);
@@ -1056,11 +1177,8 @@ void SC::AsyncEventLoop::Internal::executeWakeUps(AsyncResult& result)
                 notifier->eventObject->signal();
             }
             result.reactivateRequest(asyncResult.shouldBeReactivated);
-            notifier->pending.exchange(false); // allow executing the notification again
         }
     }
-
-    wakeUpPending.exchange(false);
 }
 
 void SC::AsyncEventLoop::Internal::removeActiveHandle(AsyncRequest& async)
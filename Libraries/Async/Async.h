@@ -48,6 +48,8 @@ struct EventObject;
 struct AsyncKernelEvents;
 struct AsyncEventLoop;
 struct AsyncEventLoopMonitor;
+struct AsyncEventLoopJobs;
+struct JobCounter;
 
 struct AsyncRequest;
 struct AsyncResult;
@@ -1044,4 +1046,43 @@ struct SC::AsyncEventLoopMonitor
     Result monitoringLoopThread(Thread& thread);
 };
 
+/// @brief Lets jobs of SC::JobSystem start async requests, suspending their fiber until the requests complete.
+/// Async requests can only be started on the thread running the AsyncEventLoop, so AsyncEventLoopJobs::startAndWait
+/// queues a function starting them, wakes up the event loop and waits on a SC::JobCounter that is decremented by the
+/// completion callback of the requests. When called from a job, only its fiber is suspended (the worker thread keeps
+/// running other jobs), while any other thread just blocks.
+///
+/// \snippet Libraries/Async/Tests/AsyncTest.cpp AsyncEventLoopJobsSnippet
+struct SC::AsyncEventLoopJobs
+{
+    /// @brief Function starting async requests on the event loop thread.
+    /// The counter has already been incremented once, so completion callback must call JobCounter::decrement.
+    /// Starting more requests requires calling JobCounter::increment once for each additional request.
+    using StartFunction = Function<Result(AsyncEventLoop&, JobCounter&)>;
+
+    /// @brief Starts handling requests of jobs (must be called on the event loop thread)
+    Result create(AsyncEventLoop& loop);
+
+    /// @brief Stops handling requests of jobs (must be called on the event loop thread after all jobs are done)
+    Result close();
+
+    /// @brief Runs startRequest on the event loop thread and waits for the completion of the requests it has started.
+    /// @param startRequest Function starting async requests on event loop thread, decrementing the counter when done
+    /// @return The error returned by startRequest (if any), after which the counter is decremented automatically
+    Result startAndWait(StartFunction&& startRequest);
+
+  private:
+    struct Request;
+
+    AsyncEventLoop* eventLoop = nullptr;
+    AsyncLoopWakeUp eventLoopWakeUp;
+
+    Mutex    mutex;
+    Request* pendingHead = nullptr; // Requests of jobs waiting to be started (protected by mutex)
+    Request* pendingTail = nullptr;
+
+    void startPendingRequests();
+    bool removePendingRequest(Request& request);
+};
+
 //! @}
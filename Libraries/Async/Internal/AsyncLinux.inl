@@ -407,7 +407,8 @@ struct SC::AsyncEventLoop::Internal::KernelEventsIoURing
     {
         io_uring_sqe* submission;
         SC_TRY(getNewSubmission(async, submission));
-        globalLibURing.io_uring_prep_send(submission, async.handle, async.buffer.data(), async.buffer.sizeInBytes(), 0);
+        globalLibURing.io_uring_prep_send(submission, async.handle, async.buffer.data(), async.buffer.sizeInBytes(),
+                                          MSG_NOSIGNAL);
         globalLibURing.io_uring_sqe_set_data(submission, &async);
         return Result(true);
     }
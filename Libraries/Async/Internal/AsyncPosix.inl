@@ -591,7 +591,13 @@ struct SC::AsyncEventLoop::Internal::KernelEventsPosix
     [[nodiscard]] static Result completeAsync(AsyncSocketSend::Result& result)
     {
         AsyncSocketSend& async = result.getAsync();
-        const ssize_t    res   = ::send(async.handle, async.buffer.data(), async.buffer.sizeInBytes(), 0);
+#if defined(MSG_NOSIGNAL)
+        // Writing to a socket closed by the remote side must return an error instead of raising SIGPIPE
+        constexpr int flags = MSG_NOSIGNAL;
+#else
+        constexpr int flags = 0; // SO_NOSIGPIPE is set when creating the socket
+#endif
+        const ssize_t res = ::send(async.handle, async.buffer.data(), async.buffer.sizeInBytes(), flags);
         SC_TRY_MSG(res >= 0, "error in send");
         result.completionData.numBytes = static_cast<size_t>(res);
         SC_TRY_MSG(result.completionData.numBytes == async.buffer.sizeInBytes(), "send didn't send all data");
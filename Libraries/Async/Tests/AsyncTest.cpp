@@ -6,6 +6,7 @@
 #include "../../Process/Process.h"
 #include "../../Strings/String.h"
 #include "../../Testing/Testing.h"
+#include "../../Threading/JobSystem.h"
 #include "../../Threading/Threading.h" // EventObject
 
 namespace SC
@@ -38,6 +39,7 @@ struct SC::AsyncTest : public SC::TestCase
             loopWakeUpFromExternalThread();
             loopWakeUp();
             loopWakeUpEventObject();
+            loopJobs();
             processExit();
             socketAccept();
             socketConnect();
@@ -180,6 +182,10 @@ struct SC::AsyncTest : public SC::TestCase
         SC_TEST_EXPECT(timeout1Called == 1 and timeout2Called == 1); // timeout2 fires after 100 ms
         SC_TEST_EXPECT(eventLoop.runOnce());
         SC_TEST_EXPECT(timeout1Called == 1 and timeout2Called == 2); // Re-activated timeout2 fires again after 1 ms
+        // A request that has completed without being re-activated can be started again
+        SC_TEST_EXPECT(timeout1.start(eventLoop, Time::Milliseconds(1)));
+        SC_TEST_EXPECT(eventLoop.run());
+        SC_TEST_EXPECT(timeout1Called == 2 and timeout2Called == 2);
     }
 
     int  threadWasCalled = 0;
@@ -315,6 +321,96 @@ struct SC::AsyncTest : public SC::TestCase
         }
     }
 
+    void loopJobs()
+    {
+        if (test_section("loop jobs"))
+        {
+            //! [AsyncEventLoopJobsSnippet]
+            static constexpr int NumJobs = 8;
+            struct Context
+            {
+                AsyncEventLoopJobs loopJobs;
+                AsyncLoopTimeout   timeouts[NumJobs];
+                Atomic<int32_t>    numCompleted = 0;
+                Atomic<int32_t>    numErrors    = 0;
+            } context;
+
+            JobSystem::Options jobOptions;
+            jobOptions.numWorkers = 2; // Less workers than jobs waiting for async requests at the same time
+            jobOptions.numFibers  = NumJobs + 1;
+
+            JobSystem jobSystem;
+            SC_TEST_EXPECT(jobSystem.create(jobOptions));
+
+            AsyncEventLoop eventLoop;
+            SC_TEST_EXPECT(eventLoop.create(options));
+            SC_TEST_EXPECT(context.loopJobs.create(eventLoop));
+
+            Job jobs[NumJobs];
+            for (int idx = 0; idx < NumJobs; ++idx)
+            {
+                jobs[idx].function = [&context, idx]()
+                {
+                    AsyncLoopTimeout& timeout = context.timeouts[idx];
+                    // Runs on the event loop thread, while the fiber of this job is suspended
+                    auto startTimeout = [&timeout](AsyncEventLoop& loop, JobCounter& counter)
+                    {
+                        timeout.callback = [&counter](AsyncLoopTimeout::Result&) { counter.decrement(); };
+                        return timeout.start(loop, Time::Milliseconds(10));
+                    };
+                    if (context.loopJobs.startAndWait(startTimeout))
+                    {
+                        context.numCompleted.fetch_add(1); // Timeout has expired
+                    }
+                    else
+                    {
+                        context.numErrors.fetch_add(1);
+                    }
+                };
+            }
+            JobCounter jobsCounter;
+            SC_TEST_EXPECT(jobSystem.run(jobs, jobsCounter));
+            //! [AsyncEventLoopJobsSnippet]
+
+            // Failing to start a request makes AsyncEventLoopJobs::startAndWait return the error
+            Result failedResult = Result(true);
+            Job    failingJob;
+            failingJob.function = [&context, &failedResult]()
+            {
+                failedResult = context.loopJobs.startAndWait([](AsyncEventLoop&, JobCounter&)
+                                                             { return Result::Error("startRequest failed"); });
+            };
+            SC_TEST_EXPECT(jobSystem.run(failingJob, jobsCounter));
+
+            // A job waits (without blocking its worker) for all other jobs and then lets the event loop exit
+            AsyncLoopWakeUp jobsDone;
+            jobsDone.callback = [this, &context](AsyncLoopWakeUp::Result& res)
+            {
+                SC_TEST_EXPECT(res.getAsync().stop());
+                SC_TEST_EXPECT(context.loopJobs.close());
+            };
+            SC_TEST_EXPECT(jobsDone.start(eventLoop));
+            Job        finalJob;
+            JobCounter finalCounter;
+            finalJob.function = [&jobsCounter, &jobsDone]()
+            {
+                jobsCounter.wait();
+                (void)jobsDone.wakeUp();
+            };
+            SC_TEST_EXPECT(jobSystem.run(finalJob, finalCounter));
+
+            SC_TEST_EXPECT(eventLoop.run());
+            finalCounter.wait();
+            SC_TEST_EXPECT(context.numCompleted.load() == NumJobs);
+            SC_TEST_EXPECT(context.numErrors.load() == 0);
+            SC_TEST_EXPECT(not failedResult);
+            SC_TEST_EXPECT(StringView::fromNullTerminated(failedResult.message, StringEncoding::Ascii) ==
+                           "startRequest failed");
+            SC_TEST_EXPECT(jobSystem.destroy());
+            SC_TEST_EXPECT(eventLoop.close());
+        }
+    }
+
     void processExit()
     {
         if (test_section("process exit"))
@@ -572,6 +668,10 @@ struct SC::AsyncTest : public SC::TestCase
             SC_TEST_EXPECT(sendCount == 1);
             SC_TEST_EXPECT(eventLoop.runNoWait());
             SC_TEST_EXPECT(sendCount == 1);
+            // A request completed without being re-activated is detached from the loop, so it can be started again
+            SC_TEST_EXPECT(sendAsync.start(eventLoop, client, sendData));
+            SC_TEST_EXPECT(eventLoop.runOnce());
+            SC_TEST_EXPECT(sendCount == 2);
 
             char       receiveBuffer[1] = {0};
             Span<char> receiveData      = {receiveBuffer, sizeof(receiveBuffer)};
@@ -1,7 +1,7 @@
 // Copyright (c) 2022-2023, Stefano Cristiano
 //
 #pragma once
-#include "../../Algorithms/AlgorithmBubbleSort.h"
+#include "../../Algorithms/AlgorithmQuickSort.h"
 #include "../Build.h"
 
 namespace SC
@@ -205,9 +205,9 @@ struct SC::Build::WriterInternal
                 return Result::Error("BuildWriter::getPathsRelativeTo - Cannot find path");
             }
         }
-        Algorithms::bubbleSort(outputFiles.begin(), outputFiles.end(),
-                               [](const RenderItem& a1, const RenderItem& a2)
-                               { return a1.path.view().compare(a2.path.view()) == StringView::Comparison::Smaller; });
+        Algorithms::quickSort(outputFiles.begin(), outputFiles.end(),
+                              [](const RenderItem& a1, const RenderItem& a2)
+                              { return a1.path.view().compare(a2.path.view()) == StringView::Comparison::Smaller; });
         return Result(true);
     }
 };
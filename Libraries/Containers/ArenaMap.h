@@ -12,6 +12,9 @@ struct ArenaMap;
 
 template <typename T>
 struct ArenaMapKey;
+
+template <typename T, uint32_t ItemsPerChunk>
+struct ChunkedArenaMap;
 } // namespace SC
 
 //! @addtogroup group_containers
@@ -39,6 +42,8 @@ struct SC::ArenaMapKey
     Generation generation;
     uint32_t   index;
     friend struct ArenaMap<T>;
+    template <typename U, uint32_t ItemsPerChunk>
+    friend struct ChunkedArenaMap;
     template <typename U>
     friend struct ArenaMapKey;
 
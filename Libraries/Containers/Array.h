@@ -226,6 +226,12 @@ struct SC::Array
     /// @return `true` if operation succeeded
     [[nodiscard]] bool insert(size_t idx, Span<const T> data);
 
+    /// @brief Inserts an item moving it at given index
+    /// @param idx Index where to insert the item
+    /// @param element The element to be moved at position idx
+    /// @return `true` if operation succeeded
+    [[nodiscard]] bool insert(size_t idx, T&& element) { return insertMove(idx, &element, 1); }
+
     /// @brief Appends a range of items copying them at the end of array
     /// @param data the range of items to copy
     /// @return `true` if operation succeeded
@@ -0,0 +1,381 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "../Containers/ArenaMap.h"
+#include "../Containers/Vector.h"
+
+namespace SC
+{
+template <typename T, uint32_t ItemsPerChunk = 64>
+struct ChunkedArenaMap;
+} // namespace SC
+
+//! @addtogroup group_containers
+//! @{
+
+/// @brief A sparse container keeping objects at a stable memory location, growing on demand in fixed size chunks.
+/// @tparam T Type of items kept in this Arena
+/// @tparam ItemsPerChunk Number of items in each chunk (a power of two makes key lookup cheaper)
+///
+/// SC::ChunkedArenaMap has the same interface and the same SC::ArenaMapKey of SC::ArenaMap, but it doesn't need to be
+/// sized upfront. Objects live in chunks of ItemsPerChunk slots, allocated from SC::Memory when all existing slots are
+/// used, so existing objects are never moved. @n
+/// New objects take the first free slot, keeping used slots packed at the beginning, so that empty chunks at the end
+/// can be released with SC::ChunkedArenaMap::releaseEmptyChunks. @n
+/// SC::ChunkedArenaMap::remove never releases memory, as the removed object can still be in use (for example when it's
+/// removed from within one of its own callbacks). Iteration visits chunks in order, skipping empty ones. @n
+/// Keys of removed objects stay invalid even after the chunk holding them has been released and allocated again.
+/// SC::ChunkedArenaMap::setMaxSize can limit the number of objects, making insertion fail when it's reached.
+template <typename T, SC::uint32_t ItemsPerChunk>
+struct SC::ChunkedArenaMap
+{
+    using Key = ArenaMapKey<T>;
+
+    static_assert(ItemsPerChunk > 0, "ChunkedArenaMap needs at least one item per chunk");
+
+    ChunkedArenaMap() {}
+
+    ~ChunkedArenaMap() { clear(); }
+
+    ChunkedArenaMap(const ChunkedArenaMap& other) { *this = other; }
+
+    ChunkedArenaMap(ChunkedArenaMap&& other) { *this = move(other); }
+
+    ChunkedArenaMap& operator=(const ChunkedArenaMap& other)
+    {
+        if (this == &other)
+            return *this;
+        clear();
+        SC_ASSERT_RELEASE(chunks.resize(other.chunks.size()));
+        for (size_t chunkIdx = 0; chunkIdx < other.chunks.size(); ++chunkIdx)
+        {
+            chunks[chunkIdx].generationBase = other.chunks[chunkIdx].generationBase;
+        }
+        for (size_t chunkIdx = 0; chunkIdx < other.numChunks; ++chunkIdx)
+        {
+            const Chunk& source = *other.chunks[chunkIdx].chunk;
+            Chunk*       chunk  = static_cast<Chunk*>(Memory::allocate(sizeof(Chunk)));
+            SC_ASSERT_RELEASE(chunk);
+            chunk->numUsed = source.numUsed;
+            for (uint32_t slot = 0; slot < ItemsPerChunk; ++slot)
+            {
+                chunk->generations[slot] = source.generations[slot];
+                if (source.generations[slot].used)
+                {
+                    new (&chunk->items()[slot], PlacementNew()) T(source.items()[slot]);
+                }
+            }
+            chunks[chunkIdx].chunk = chunk;
+            numChunks++;
+        }
+        numUsed        = other.numUsed;
+        maxSize        = other.maxSize;
+        firstFreeChunk = other.firstFreeChunk;
+        return *this;
+    }
+
+    ChunkedArenaMap& operator=(ChunkedArenaMap&& other)
+    {
+        clear();
+        chunks               = move(other.chunks);
+        numChunks            = other.numChunks;
+        numUsed              = other.numUsed;
+        maxSize              = other.maxSize;
+        firstFreeChunk       = other.firstFreeChunk;
+        other.numChunks      = 0;
+        other.numUsed        = 0;
+        other.firstFreeChunk = 0;
+        return *this;
+    }
+
+    /// @brief Get the number of objects that can be stored without allocating new chunks
+    uint32_t getNumAllocated() const { return static_cast<uint32_t>(numChunks * ItemsPerChunk); }
+
+    /// @brief Get the number of chunks currently allocated
+    [[nodiscard]] size_t getNumChunks() const { return numChunks; }
+
+    /// @brief Get the number of used slots in the arena
+    [[nodiscard]] size_t size() const { return numUsed; }
+
+    /// @brief Sets maximum number of objects that can be stored (insertion fails once it's reached)
+    void setMaxSize(size_t newMaxSize) { maxSize = newMaxSize; }
+
+    template <typename MapType>
+    struct ChunkedArenaMapIterator
+    {
+        MapType* map   = nullptr;
+        uint32_t index = 0;
+
+        void operator++() { index = map->findUsedSlot(index + 1); }
+
+        bool operator==(ChunkedArenaMapIterator it) const
+        {
+            SC_ASSERT_DEBUG(it.map == map and map != nullptr);
+            return it.index == index;
+        }
+        bool operator!=(ChunkedArenaMapIterator it) const
+        {
+            SC_ASSERT_DEBUG(it.map == map and map != nullptr);
+            return it.index != index;
+        }
+
+        auto& operator*() const { return map->itemAt(index); }
+        auto* operator->() const { return &map->itemAt(index); }
+    };
+    using ConstIterator = ChunkedArenaMapIterator<const ChunkedArenaMap>;
+    using Iterator      = ChunkedArenaMapIterator<ChunkedArenaMap>;
+
+    ConstIterator cbegin() const { return begin(); }
+    ConstIterator cend() const { return end(); }
+    ConstIterator begin() const { return {this, findUsedSlot(0)}; }
+    ConstIterator end() const { return {this, getNumAllocated()}; }
+    Iterator      begin() { return {this, findUsedSlot(0)}; }
+    Iterator      end() { return {this, getNumAllocated()}; }
+
+    /// @brief Destroys all objects and releases all chunks
+    void clear()
+    {
+        for (size_t chunkIdx = 0; chunkIdx < numChunks; ++chunkIdx)
+        {
+            releaseChunk(chunks[chunkIdx]);
+        }
+        numChunks      = 0;
+        numUsed        = 0;
+        firstFreeChunk = 0;
+    }
+
+    template <typename Value>
+    [[nodiscard]] Key insert(const Value& object)
+    {
+        Key key = allocateNewKeySlot();
+        if (key.isValid())
+        {
+            new (&itemAt(key.index), PlacementNew()) T(object);
+        }
+        return key;
+    }
+
+    [[nodiscard]] Key allocate()
+    {
+        Key key = allocateNewKeySlot();
+        if (key.isValid())
+        {
+            new (&itemAt(key.index), PlacementNew()) T();
+        }
+        return key;
+    }
+
+    template <typename Value>
+    [[nodiscard]] Key insert(Value&& object)
+    {
+        Key key = allocateNewKeySlot();
+        if (key.isValid())
+        {
+            new (&itemAt(key.index), PlacementNew()) T(move(object));
+        }
+        return key;
+    }
+
+    [[nodiscard]] bool containsKey(Key key) const { return get(key) != nullptr; }
+
+    template <typename ComparableToValue>
+    [[nodiscard]] bool containsValue(const ComparableToValue& value, Key* optionalKey = nullptr) const
+    {
+        for (uint32_t index = findUsedSlot(0); index < getNumAllocated(); index = findUsedSlot(index + 1))
+        {
+            if (itemAt(index) == value)
+            {
+                if (optionalKey)
+                {
+                    optionalKey->index      = index;
+                    optionalKey->generation = generationAt(index);
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] bool remove(Key key)
+    {
+        if (get(key) == nullptr)
+            return false;
+        const size_t chunkIdx = key.index / ItemsPerChunk;
+        Chunk&       chunk    = *chunks[chunkIdx].chunk;
+        Generation&  slot     = chunk.generations[key.index % ItemsPerChunk];
+        slot.generation++;
+        slot.used = 0;
+        chunk.items()[key.index % ItemsPerChunk].~T();
+        chunk.numUsed--;
+        numUsed--;
+        firstFreeChunk = chunkIdx < firstFreeChunk ? chunkIdx : firstFreeChunk;
+        return true;
+    }
+
+    /// @brief Releases trailing empty chunks, keeping the last empty one to avoid allocating and releasing a chunk
+    /// repeatedly when the number of objects oscillates around a chunk boundary.
+    /// @warning Memory of all removed objects in such chunks is freed, so it must not be called while any of them is
+    /// still in use (for example from one of their callbacks)
+    /// @return Number of released chunks
+    size_t releaseEmptyChunks()
+    {
+        size_t numReleased = 0;
+        while (numChunks >= 2 and chunks[numChunks - 1].chunk->numUsed == 0 and
+               chunks[numChunks - 2].chunk->numUsed == 0)
+        {
+            releaseChunk(chunks[numChunks - 1]);
+            numChunks--;
+            numReleased++;
+        }
+        firstFreeChunk = firstFreeChunk < numChunks ? firstFreeChunk : numChunks;
+        return numReleased;
+    }
+
+    [[nodiscard]] T* get(Key key)
+    {
+        if (not isSlotOf(key))
+            return nullptr;
+        return &itemAt(key.index);
+    }
+
+    [[nodiscard]] const T* get(Key key) const
+    {
+        if (not isSlotOf(key))
+            return nullptr;
+        return &itemAt(key.index);
+    }
+
+  private:
+    using Generation = typename Key::Generation;
+
+    struct Chunk
+    {
+        static_assert(alignof(T) <= 16, "ChunkedArenaMap chunks are allocated with SC::Memory (aligned to 16 bytes)");
+
+        Generation generations[ItemsPerChunk];
+        uint32_t   numUsed;
+
+        alignas(T) char storage[ItemsPerChunk * sizeof(T)];
+
+        T*       items() { return reinterpret_cast<T*>(storage); }
+        const T* items() const { return reinterpret_cast<const T*>(storage); }
+    };
+    struct ChunkSlot
+    {
+        Chunk*   chunk          = nullptr;
+        uint32_t generationBase = 0; // Generation of all slots when the chunk is allocated again
+    };
+
+    Vector<ChunkSlot> chunks; // Slots after numChunks remember generationBase of released chunks
+
+    size_t numChunks      = 0;
+    size_t numUsed        = 0;
+    size_t maxSize        = Key::MaxIndex;
+    size_t firstFreeChunk = 0; // No chunk before this one has free slots
+
+    T& itemAt(uint32_t index) { return chunks[index / ItemsPerChunk].chunk->items()[index % ItemsPerChunk]; }
+
+    const T& itemAt(uint32_t index) const
+    {
+        return chunks[index / ItemsPerChunk].chunk->items()[index % ItemsPerChunk];
+    }
+
+    const Generation& generationAt(uint32_t index) const
+    {
+        return chunks[index / ItemsPerChunk].chunk->generations[index % ItemsPerChunk];
+    }
+
+    [[nodiscard]] bool isSlotOf(Key key) const
+    {
+        return key.isValid() and key.index / ItemsPerChunk < numChunks and generationAt(key.index) == key.generation;
+    }
+
+    // Returns index of first used slot at or after index (or getNumAllocated() if none), skipping empty chunks
+    uint32_t findUsedSlot(uint32_t index) const
+    {
+        for (size_t chunkIdx = index / ItemsPerChunk; chunkIdx < numChunks; ++chunkIdx)
+        {
+            const Chunk& chunk = *chunks[chunkIdx].chunk;
+            if (chunk.numUsed > 0)
+            {
+                for (uint32_t slot = index % ItemsPerChunk; slot < ItemsPerChunk; ++slot)
+                {
+                    if (chunk.generations[slot].used)
+                    {
+                        return static_cast<uint32_t>(chunkIdx * ItemsPerChunk + slot);
+                    }
+                }
+            }
+            index = 0;
+        }
+        return getNumAllocated();
+    }
+
+    void releaseChunk(ChunkSlot& chunkSlot)
+    {
+        Chunk& chunk = *chunkSlot.chunk;
+        // Next generation of slots must be higher than the one of all keys handed out for this chunk so far
+        uint32_t generationBase = chunkSlot.generationBase;
+        for (uint32_t slot = 0; slot < ItemsPerChunk; ++slot)
+        {
+            Generation& generation = chunk.generations[slot];
+            if (generation.used)
+            {
+                chunk.items()[slot].~T();
+                generation.generation++;
+            }
+            generationBase = generation.generation > generationBase ? generation.generation : generationBase;
+        }
+        chunkSlot.generationBase = generationBase;
+        Memory::release(chunkSlot.chunk);
+        chunkSlot.chunk = nullptr;
+    }
+
+    [[nodiscard]] Key allocateNewKeySlot()
+    {
+        if (numUsed >= maxSize)
+            return {};
+        size_t chunkIdx = firstFreeChunk;
+        while (chunkIdx < numChunks and chunks[chunkIdx].chunk->numUsed == ItemsPerChunk)
+        {
+            chunkIdx++;
+        }
+        firstFreeChunk = chunkIdx;
+        if (chunkIdx == numChunks)
+        {
+            if (static_cast<uint64_t>(numChunks + 1) * ItemsPerChunk > Key::MaxIndex)
+                return {};
+            if (numChunks == chunks.size() and not chunks.push_back(ChunkSlot()))
+                return {};
+            Chunk* chunk = static_cast<Chunk*>(Memory::allocate(sizeof(Chunk)));
+            if (chunk == nullptr)
+                return {};
+            chunk->numUsed = 0;
+            for (Generation& generation : chunk->generations)
+            {
+                generation.used       = 0;
+                generation.generation = chunks[chunkIdx].generationBase;
+            }
+            chunks[chunkIdx].chunk = chunk;
+            numChunks++;
+        }
+        Chunk& chunk = *chunks[chunkIdx].chunk;
+        for (uint32_t slot = 0; slot < ItemsPerChunk; ++slot)
+        {
+            if (chunk.generations[slot].used == 0)
+            {
+                chunk.generations[slot].used = 1;
+                chunk.numUsed++;
+                numUsed++;
+
+                Key key;
+                key.generation = chunk.generations[slot];
+                key.index      = static_cast<uint32_t>(chunkIdx * ItemsPerChunk + slot);
+                return key;
+            }
+        }
+        SC_ASSERT_DEBUG(false); // numUsed of the chunk is wrong
+        return {};
+    }
+};
+//! @}
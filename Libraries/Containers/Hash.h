@@ -0,0 +1,134 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "../Foundation/LibC.h"
+#include "../Foundation/PrimitiveTypes.h"
+
+namespace SC
+{
+template <typename T>
+struct Hash;
+struct HashBytes;
+} // namespace SC
+
+//! @addtogroup group_containers
+//! @{
+
+/// @brief Incremental 64 bit hash of a sequence of bytes, processed 8 bytes at a time.
+///
+/// The result depends only on the sequence of bytes, and not on how it has been split between HashBytes::add calls.
+/// It's fast and well distributed, but it's not a cryptographic hash and it's not meant to resist to hash flooding.
+struct SC::HashBytes
+{
+    /// @brief Starts hashing a sequence of bytes
+    /// @param seed Initial value (different seeds give different hashes for the same sequence)
+    explicit HashBytes(uint64_t seed = 0) : state(seed ^ 0x9e3779b97f4a7c15ULL) {}
+
+    /// @brief Adds numBytes to the hashed sequence
+    void add(const void* bytes, size_t numBytes)
+    {
+        const uint8_t* data = static_cast<const uint8_t*>(bytes);
+        while (numPending != 0 and numBytes > 0)
+        {
+            addByte(*data++);
+            numBytes--;
+        }
+        for (; numBytes >= 8; numBytes -= 8, data += 8)
+        {
+            uint64_t word;
+            ::memcpy(&word, data, sizeof(word)); // Little endian on all supported platforms
+            addWord(word);
+        }
+        while (numBytes-- > 0)
+        {
+            addByte(*data++);
+        }
+    }
+
+    /// @brief Adds a single byte to the hashed sequence
+    void addByte(uint8_t byte)
+    {
+        pending |= static_cast<uint64_t>(byte) << (numPending * 8);
+        if (++numPending == 8)
+        {
+            addWord(pending);
+            pending    = 0;
+            numPending = 0;
+        }
+    }
+
+    /// @brief Returns the hash of all bytes added so far
+    [[nodiscard]] uint64_t finish() const { return mix(state ^ mix(pending ^ (length + numPending))); }
+
+    /// @brief Scrambles bits of an integer, so that even similar values get well distributed hashes
+    [[nodiscard]] static constexpr uint64_t mix(uint64_t value)
+    {
+        // Finalizer of MurmurHash3
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdULL;
+        value ^= value >> 33;
+        value *= 0xc4ceb9fe1a85ec53ULL;
+        value ^= value >> 33;
+        return value;
+    }
+
+  private:
+    void addWord(uint64_t word)
+    {
+        state = mix(state ^ word) + 0x9e3779b97f4a7c15ULL;
+        length += 8;
+    }
+
+    uint64_t state;
+    uint64_t pending    = 0; // Bytes not forming a full word yet
+    uint32_t numPending = 0;
+    uint64_t length     = 0;
+};
+
+/// @brief Default hash function used by SC::HashMap and SC::HashSet.
+///
+/// It's specialized for integer types and pointers, and it calls `uint64_t hash() const` on all other types
+/// (see for example SC::StringView::hash and SC::String::hash).
+/// Types comparing equal with `==` must have the same hash, even if they're different types (for example a
+/// SC::String key looked up with a SC::StringView).
+template <typename T>
+struct SC::Hash
+{
+    template <typename U>
+    [[nodiscard]] uint64_t operator()(const U& value) const
+    {
+        return value.hash();
+    }
+};
+
+namespace SC
+{
+struct HashInteger
+{
+    [[nodiscard]] constexpr uint64_t operator()(uint64_t value) const { return HashBytes::mix(value); }
+};
+template <> struct Hash<bool> : public HashInteger {};
+template <> struct Hash<char> : public HashInteger {};
+template <> struct Hash<signed char> : public HashInteger {};
+template <> struct Hash<unsigned char> : public HashInteger {};
+template <> struct Hash<char16_t> : public HashInteger {};
+template <> struct Hash<char32_t> : public HashInteger {};
+template <> struct Hash<short> : public HashInteger {};
+template <> struct Hash<unsigned short> : public HashInteger {};
+template <> struct Hash<int> : public HashInteger {};
+template <> struct Hash<unsigned int> : public HashInteger {};
+template <> struct Hash<long> : public HashInteger {};
+template <> struct Hash<unsigned long> : public HashInteger {};
+template <> struct Hash<long long> : public HashInteger {};
+template <> struct Hash<unsigned long long> : public HashInteger {};
+
+template <typename T>
+struct Hash<T*>
+{
+    [[nodiscard]] uint64_t operator()(const T* value) const
+    {
+        return HashBytes::mix(static_cast<uint64_t>(reinterpret_cast<size_t>(value)));
+    }
+};
+} // namespace SC
+//! @}
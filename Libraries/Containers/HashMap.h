@@ -0,0 +1,177 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "../Containers/Internal/HashTable.h"
+
+namespace SC
+{
+template <typename Key, typename Value, typename HashFunction>
+struct HashMap;
+template <typename Key, typename Value>
+struct HashMapItem;
+} // namespace SC
+//! @addtogroup group_containers
+//! @{
+
+/// @brief The single item of HashMap, holding a Key and Value
+/// @tparam Key The type representing Key in the map.
+/// @tparam Value The type representing Value in the map.
+template <typename Key, typename Value>
+struct SC::HashMapItem
+{
+    Key   key;   ///< Key item value
+    Value value; ///< Map item value
+
+    struct KeyOfItem
+    {
+        static const Key& get(const HashMapItem& item) { return item.key; }
+    };
+};
+
+/// @brief A map holding HashMapItem key-value pairs in an open addressing hash table (see SC::HashTable).
+///
+/// It has the same interface of SC::VectorMap, but insertion, lookup and removal take constant time on average,
+/// instead of being linear in the number of items. Iteration order is unspecified.
+/// @warning Inserting or removing items can move other items, invalidating pointers obtained from the map.
+/// @tparam Key Type of the key (must support `==` comparison and must be hashable by HashFunction)
+/// @tparam Value Value type associated with Key
+/// @tparam HashFunction Functor hashing Key and all types comparable to it (defaults to SC::Hash)
+template <typename Key, typename Value, typename HashFunction = SC::Hash<Key>>
+struct SC::HashMap
+{
+    using Item = HashMapItem<Key, Value>;
+
+    HashTable<Item, typename Item::KeyOfItem, HashFunction> items;
+
+    /// @brief Return the number of key-value pairs in the map
+    [[nodiscard]] size_t size() const { return items.size(); }
+
+    /// @brief Check if the map is empty
+    [[nodiscard]] bool isEmpty() const { return items.size() == 0; }
+
+    [[nodiscard]] auto begin() { return items.begin(); }
+    [[nodiscard]] auto begin() const { return items.begin(); }
+    [[nodiscard]] auto end() { return items.end(); }
+    [[nodiscard]] auto end() const { return items.end(); }
+
+    /// @brief Removes all items from the map, keeping allocated memory
+    void clear() { items.clear(); }
+
+    /// @brief Allocates memory for at least numItems key-value pairs
+    /// @return `false` if memory allocation fails
+    [[nodiscard]] bool reserve(size_t numItems) { return items.reserve(numItems); }
+
+    /// @brief Remove an item with matching key from the Map
+    /// @param key The key that must be removed
+    /// @return `true` if the item was found
+    template <typename ComparableToKey>
+    [[nodiscard]] bool remove(const ComparableToKey& key)
+    {
+        return items.remove(key);
+    }
+
+    /// @brief Inserts an item if it doesn't exist already.
+    /// @param item The item to insert
+    /// @return `false` if item already exists or if insertion fails (`true` otherwise)
+    [[nodiscard]] bool insertIfNotExists(Item&& item)
+    {
+        bool inserted = false;
+        return items.findOrInsert(item.key, inserted, move(item)) != nullptr and inserted;
+    }
+
+    /// @brief Insert an item, overwriting the potentially already existing one
+    /// @param item Item to insert
+    /// @return A pointer to the Value if insertion succeeds, `nullptr` if insertion fails.
+    [[nodiscard]] Value* insertOverwrite(Item&& item)
+    {
+        bool  inserted = false;
+        Item* found    = items.findOrInsert(item.key, inserted, move(item));
+        if (found == nullptr)
+        {
+            return nullptr;
+        }
+        if (not inserted)
+        {
+            found->value = move(item.value);
+        }
+        return &found->value;
+    }
+
+    /// @brief Inserts a new value, automatically generating key with Key::generateUniqueKey (works for StrongID for
+    /// example)
+    /// @param value The new value to be inserted
+    /// @return A pointer to the new Key or `nullptr` if the map is full
+    [[nodiscard]] const Key* insertValueUniqueKey(Value&& value)
+    {
+        const Key key      = Key::generateUniqueKey(*this);
+        bool      inserted = false;
+        Item*     item     = items.findOrInsert(key, inserted, key, forward<Value>(value));
+        return item != nullptr ? &item->key : nullptr;
+    }
+
+    /// @brief Check if the given key is contained in the map
+    template <typename ComparableToKey>
+    [[nodiscard]] bool contains(const ComparableToKey& key) const
+    {
+        return items.find(key) != nullptr;
+    }
+
+    /// @brief Check if the given key is contained in the map
+    /// @param key The key to search for inside current map
+    /// @param outValue A reference that will receive pointer to the found element (if found)
+    template <typename ComparableToKey>
+    [[nodiscard]] bool contains(const ComparableToKey& key, const Value*& outValue) const
+    {
+        const Item* item = items.find(key);
+        if (item != nullptr)
+        {
+            outValue = &item->value;
+            return true;
+        }
+        return false;
+    }
+
+    /// @brief Check if the given key is contained in the map
+    /// @param key The key to search for inside current map
+    /// @param outValue A reference that will receive pointer to the found element (if found)
+    template <typename ComparableToKey>
+    [[nodiscard]] bool contains(const ComparableToKey& key, Value*& outValue)
+    {
+        Item* item = items.find(key);
+        if (item != nullptr)
+        {
+            outValue = &item->value;
+            return true;
+        }
+        return false;
+    }
+
+    /// @brief Get the Value associated to the given key
+    /// @return A pointer to the value if it exists in the map, `nullptr` otherwise
+    template <typename ComparableToKey>
+    [[nodiscard]] const Value* get(const ComparableToKey& key) const
+    {
+        const Item* item = items.find(key);
+        return item != nullptr ? &item->value : nullptr;
+    }
+
+    /// @brief Get the Value associated to the given key
+    /// @return A pointer to the value if it exists in the map, `nullptr` otherwise
+    template <typename ComparableToKey>
+    [[nodiscard]] Value* get(const ComparableToKey& key)
+    {
+        Item* item = items.find(key);
+        return item != nullptr ? &item->value : nullptr;
+    }
+
+    /// @brief Get the value associated to the given key, or creates a new one if needed
+    /// @return A pointer to the value or `nullptr` if memory allocation fails
+    template <typename ComparableToKey>
+    [[nodiscard]] Value* getOrCreate(const ComparableToKey& key)
+    {
+        bool  inserted = false;
+        Item* item     = items.findOrInsert(key, inserted, key, Value());
+        return item != nullptr ? &item->value : nullptr;
+    }
+};
+//! @}
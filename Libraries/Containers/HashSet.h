@@ -0,0 +1,69 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "../Containers/Internal/HashTable.h"
+
+namespace SC
+{
+template <typename Value, typename HashFunction>
+struct HashSet;
+} // namespace SC
+
+//! @addtogroup group_containers
+//! @{
+
+/// @brief A set built on an open addressing hash table (see SC::HashTable), ensuring no item duplication
+///
+/// It has the same interface of SC::VectorSet, but insertion, lookup and removal take constant time on average.
+/// Iteration order is unspecified.
+/// @tparam Value The contained value (must support `==` comparison and must be hashable by HashFunction)
+/// @tparam HashFunction Functor hashing Value and all types comparable to it (defaults to SC::Hash)
+template <typename Value, typename HashFunction = SC::Hash<Value>>
+struct SC::HashSet
+{
+    struct KeyOfItem
+    {
+        static const Value& get(const Value& value) { return value; }
+    };
+    HashTable<Value, KeyOfItem, HashFunction> items;
+
+    /// @brief Return size of the set
+    [[nodiscard]] size_t size() const { return items.size(); }
+
+    /// @brief Check if the set is empty
+    [[nodiscard]] bool isEmpty() const { return items.size() == 0; }
+
+    [[nodiscard]] auto begin() const { return items.begin(); }
+    [[nodiscard]] auto end() const { return items.end(); }
+
+    /// @brief Removes all values from the set, keeping allocated memory
+    void clear() { items.clear(); }
+
+    /// @brief Allocates memory for at least numValues values
+    /// @return `false` if memory allocation fails
+    [[nodiscard]] bool reserve(size_t numValues) { return items.reserve(numValues); }
+
+    /// @brief Check if the given Value exists in the HashSet
+    template <typename ComparableToValue>
+    [[nodiscard]] bool contains(const ComparableToValue& value) const
+    {
+        return items.find(value) != nullptr;
+    }
+
+    /// @brief Inserts a value in the HashSet (if it doesn't already exists)
+    /// @return `false` if memory allocation fails
+    [[nodiscard]] bool insert(const Value& value)
+    {
+        bool inserted = false;
+        return items.findOrInsert(value, inserted, value) != nullptr;
+    }
+
+    /// @brief Removes a value from the HashSet (if it exists)
+    /// @return `true` if the value was found
+    template <typename ComparableToValue>
+    [[nodiscard]] bool remove(const ComparableToValue& value)
+    {
+        return items.remove(value);
+    }
+};
+//! @}
@@ -0,0 +1,411 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "../../Containers/Hash.h"
+#include "../../Containers/Vector.h"
+
+namespace SC
+{
+template <typename Item, typename KeyOfItem, typename HashFunction>
+struct HashTable;
+} // namespace SC
+
+//! @addtogroup group_containers
+//! @{
+
+/// @brief Open addressing hash table shared by SC::HashMap and SC::HashSet.
+///
+/// The table follows the "Swiss table" layout:
+/// - A control byte for each slot holds 7 bits of the item hash (or the Empty marker), so that most mismatching
+///   slots are skipped without touching items at all.
+/// - Control bytes are probed in groups of 8, comparing all of them at once with SWAR (SIMD Within A Register)
+///   arithmetic on a single `uint64_t`. The first 7 control bytes are cloned after the last one so that a group
+///   starting at any position can be loaded without wrapping around.
+/// - Probing is linear (group after group) and it stops at the first group containing an Empty control byte.
+/// - Removal doesn't leave tombstones: following items of the same cluster are shifted back to fill the hole
+///   (Knuth's Algorithm R), so lookups never slow down after many removals.
+///
+/// Control bytes and items are stored in two SC::Vector, so they use the same SC::Memory based allocations.
+/// Capacity is always a power of two, and the table grows when it's 3/4 full.
+/// @warning Inserting or removing items can move other items, invalidating pointers and iterators to them.
+/// @tparam Item Type stored in the table
+/// @tparam KeyOfItem Struct with a static `get(const Item&)` function returning the key of an item
+/// @tparam HashFunction Functor returning an `uint64_t` hash for the key (and for all types comparable to it)
+template <typename Item, typename KeyOfItem, typename HashFunction>
+struct SC::HashTable
+{
+    static constexpr size_t  GroupWidth      = 8;    ///< Number of control bytes compared at once
+    static constexpr size_t  MinimumCapacity = 16;   ///< Capacity of the table at first insertion
+    static constexpr uint8_t Empty           = 0x80; ///< Control byte of slots not holding an item
+
+    HashTable() = default;
+    ~HashTable() { destroyItems(); }
+
+    HashTable(const HashTable& other) { copyFrom(other); }
+    HashTable(HashTable&& other) noexcept { moveFrom(other); }
+
+    HashTable& operator=(const HashTable& other)
+    {
+        if (&other != this)
+        {
+            destroyItems();
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    HashTable& operator=(HashTable&& other) noexcept
+    {
+        if (&other != this)
+        {
+            destroyItems();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    /// @brief Iterates all items of the table, skipping empty slots
+    template <typename TableType, typename ItemType>
+    struct Iterator
+    {
+        TableType* table = nullptr;
+        size_t     index = 0;
+
+        Iterator(TableType* table, size_t index) : table(table), index(index) { skipEmpty(); }
+
+        [[nodiscard]] ItemType& operator*() const { return table->itemAt(index); }
+        [[nodiscard]] ItemType* operator->() const { return &table->itemAt(index); }
+        [[nodiscard]] bool      operator!=(const Iterator& other) const { return index != other.index; }
+        [[nodiscard]] bool      operator==(const Iterator& other) const { return index == other.index; }
+
+        Iterator& operator++()
+        {
+            index++;
+            skipEmpty();
+            return *this;
+        }
+
+      private:
+        void skipEmpty()
+        {
+            const size_t capacity = table->capacity();
+            while (index < capacity and table->controls[index] == Empty)
+            {
+                index++;
+            }
+        }
+    };
+
+    /// @brief Number of items in the table
+    [[nodiscard]] size_t size() const { return numItems; }
+
+    /// @brief Number of slots of the table (items that can be inserted before growing are 3/4 of it)
+    [[nodiscard]] size_t capacity() const { return slots.size(); }
+
+    /// @brief Destroys all items, keeping allocated memory
+    void clear()
+    {
+        destroyItems();
+        for (size_t idx = 0; idx < controls.size(); ++idx)
+        {
+            controls[idx] = Empty;
+        }
+        numItems = 0;
+    }
+
+    /// @brief Grows the table so that it can hold at least numItemsToReserve items without further allocations
+    /// @return `false` if memory allocation fails
+    [[nodiscard]] bool reserve(size_t numItemsToReserve)
+    {
+        size_t newCapacity = MinimumCapacity;
+        while (newCapacity - newCapacity / 4 < numItemsToReserve)
+        {
+            newCapacity *= 2;
+        }
+        return newCapacity <= capacity() ? true : rehash(newCapacity);
+    }
+
+    /// @brief Finds the item with a key comparing equal to the given one
+    /// @return Pointer to the item or `nullptr` if it doesn't exist
+    template <typename ComparableToKey>
+    [[nodiscard]] Item* find(const ComparableToKey& key)
+    {
+        const size_t index = findIndex(key);
+        return index == NotFound ? nullptr : &itemAt(index);
+    }
+
+    /// @brief Finds the item with a key comparing equal to the given one
+    /// @return Pointer to the item or `nullptr` if it doesn't exist
+    template <typename ComparableToKey>
+    [[nodiscard]] const Item* find(const ComparableToKey& key) const
+    {
+        const size_t index = findIndex(key);
+        return index == NotFound ? nullptr : &itemAt(index);
+    }
+
+    /// @brief Finds the item with given key, or constructs a new one with the given arguments if it doesn't exist
+    /// @param key Key of the item (must be equal to the key of the item constructed from args)
+    /// @param inserted Set to `true` if the item has been constructed, `false` if it already existed
+    /// @param args Arguments forwarded to brace initialization of the new Item (only if it doesn't exist)
+    /// @return Pointer to the item or `nullptr` if memory allocation fails
+    template <typename ComparableToKey, typename... Args>
+    [[nodiscard]] Item* findOrInsert(const ComparableToKey& key, bool& inserted, Args&&... args)
+    {
+        inserted          = false;
+        const uint64_t h  = hashFunction(key);
+        size_t         at = NotFound;
+        if (capacity() > 0)
+        {
+            at = findIndexOrEmpty(key, h);
+            if (controls[at] != Empty)
+            {
+                return &itemAt(at);
+            }
+        }
+        if (numItems + 1 > capacity() - capacity() / 4)
+        {
+            if (not rehash(capacity() == 0 ? MinimumCapacity : capacity() * 2))
+            {
+                return nullptr;
+            }
+            at = findEmpty(h);
+        }
+        new (&itemAt(at), PlacementNew()) Item{forward<Args>(args)...};
+        setControl(at, getControl(h));
+        numItems++;
+        inserted = true;
+        return &itemAt(at);
+    }
+
+    /// @brief Removes the item with a key comparing equal to the given one
+    /// @return `true` if the item has been found and removed
+    template <typename ComparableToKey>
+    [[nodiscard]] bool remove(const ComparableToKey& key)
+    {
+        const size_t index = findIndex(key);
+        if (index == NotFound)
+        {
+            return false;
+        }
+        removeAt(index);
+        return true;
+    }
+
+    [[nodiscard]] Iterator<HashTable, Item>             begin() { return {this, 0}; }
+    [[nodiscard]] Iterator<HashTable, Item>             end() { return {this, capacity()}; }
+    [[nodiscard]] Iterator<const HashTable, const Item> begin() const { return {this, 0}; }
+    [[nodiscard]] Iterator<const HashTable, const Item> end() const { return {this, capacity()}; }
+
+  private:
+    static constexpr size_t   NotFound = ~static_cast<size_t>(0);
+    static constexpr uint64_t LowBits  = 0x0101010101010101ULL;
+    static constexpr uint64_t HighBits = 0x8080808080808080ULL;
+
+    struct Slot
+    {
+        alignas(Item) char storage[sizeof(Item)];
+    };
+
+    Vector<uint8_t> controls; // capacity + GroupWidth - 1 control bytes (the first ones are cloned at the end)
+    Vector<Slot>    slots;
+    size_t          numItems = 0;
+    HashFunction    hashFunction;
+
+    [[nodiscard]] Item& itemAt(size_t index) { return *reinterpret_cast<Item*>(slots.data()[index].storage); }
+
+    [[nodiscard]] const Item& itemAt(size_t index) const
+    {
+        return *reinterpret_cast<const Item*>(slots.data()[index].storage);
+    }
+
+    // Low bits of the hash select the slot, high bits are stored in the control byte
+    [[nodiscard]] size_t  getHome(uint64_t hash) const { return static_cast<size_t>(hash) & (capacity() - 1); }
+    [[nodiscard]] uint8_t getControl(uint64_t hash) const { return static_cast<uint8_t>(hash >> 57); }
+
+    [[nodiscard]] uint64_t loadGroup(size_t index) const
+    {
+        uint64_t group;
+        ::memcpy(&group, controls.data() + index, sizeof(group)); // Little endian on all supported platforms
+        return group;
+    }
+
+    // Sets the high bit of bytes equal to control. It can report false positives only for bytes following a true
+    // match (because of the borrow), that are discarded comparing keys. Empty bytes never match.
+    [[nodiscard]] static uint64_t matchControl(uint64_t group, uint8_t control)
+    {
+        const uint64_t bytes = group ^ (LowBits * control);
+        return (bytes - LowBits) & ~bytes & HighBits;
+    }
+
+    [[nodiscard]] static uint64_t matchEmpty(uint64_t group) { return group & HighBits; }
+
+    // Index of the lowest byte with its high bit set in mask (that must not be zero)
+    [[nodiscard]] static size_t lowestByte(uint64_t mask)
+    {
+        return static_cast<size_t>((((mask & (~mask + 1)) >> 7) * 0x0001020304050607ULL) >> 56);
+    }
+
+    void setControl(size_t index, uint8_t control)
+    {
+        controls[index] = control;
+        if (index < GroupWidth - 1)
+        {
+            controls[capacity() + index] = control;
+        }
+    }
+
+    template <typename ComparableToKey>
+    [[nodiscard]] size_t findIndex(const ComparableToKey& key) const
+    {
+        if (numItems == 0)
+        {
+            return NotFound;
+        }
+        const size_t index = findIndexOrEmpty(key, hashFunction(key));
+        return controls[index] == Empty ? NotFound : index;
+    }
+
+    // Returns index of the item with given key or, if it doesn't exist, index of the first empty slot of its cluster
+    template <typename ComparableToKey>
+    [[nodiscard]] size_t findIndexOrEmpty(const ComparableToKey& key, uint64_t hash) const
+    {
+        const size_t  mask    = capacity() - 1;
+        const uint8_t control = getControl(hash);
+        size_t        index   = getHome(hash);
+        while (true)
+        {
+            const uint64_t group = loadGroup(index);
+            for (uint64_t match = matchControl(group, control); match != 0; match &= match - 1)
+            {
+                const size_t candidate = (index + lowestByte(match)) & mask;
+                if (KeyOfItem::get(itemAt(candidate)) == key)
+                {
+                    return candidate;
+                }
+            }
+            const uint64_t empty = matchEmpty(group);
+            if (empty != 0)
+            {
+                return (index + lowestByte(empty)) & mask;
+            }
+            index = (index + GroupWidth) & mask;
+        }
+    }
+
+    [[nodiscard]] size_t findEmpty(uint64_t hash) const
+    {
+        const size_t mask  = capacity() - 1;
+        size_t       index = getHome(hash);
+        while (true)
+        {
+            const uint64_t empty = matchEmpty(loadGroup(index));
+            if (empty != 0)
+            {
+                return (index + lowestByte(empty)) & mask;
+            }
+            index = (index + GroupWidth) & mask;
+        }
+    }
+
+    void removeAt(size_t index)
+    {
+        const size_t mask = capacity() - 1;
+        itemAt(index).~Item();
+        numItems--;
+        // Shift back following items of the cluster that can be moved closer to their home slot
+        size_t hole = index;
+        size_t next = index;
+        while (true)
+        {
+            next = (next + 1) & mask;
+            if (controls[next] == Empty)
+            {
+                break;
+            }
+            const size_t home = getHome(hashFunction(KeyOfItem::get(itemAt(next))));
+            // Item must stay where it is if its home slot is cyclically in (hole, next]
+            const bool stays = hole <= next ? (hole < home and home <= next) : (hole < home or home <= next);
+            if (not stays)
+            {
+                placementNew(itemAt(hole), move(itemAt(next)));
+                itemAt(next).~Item();
+                setControl(hole, controls[next]);
+                hole = next;
+            }
+        }
+        setControl(hole, Empty);
+    }
+
+    [[nodiscard]] bool rehash(size_t newCapacity)
+    {
+        HashTable other;
+        if (not other.controls.resize(newCapacity + GroupWidth - 1, static_cast<uint8_t>(Empty)) or
+            not other.slots.resizeWithoutInitializing(newCapacity))
+        {
+            return false;
+        }
+        for (size_t idx = 0; idx < capacity(); ++idx)
+        {
+            if (controls[idx] != Empty)
+            {
+                Item&          item  = itemAt(idx);
+                const uint64_t h     = hashFunction(KeyOfItem::get(item));
+                const size_t   index = other.findEmpty(h);
+                placementNew(other.itemAt(index), move(item));
+                other.setControl(index, other.getControl(h));
+                item.~Item();
+            }
+        }
+        other.numItems = numItems;
+        controls       = move(other.controls);
+        slots          = move(other.slots);
+        other.numItems = 0;
+        return true;
+    }
+
+    void destroyItems()
+    {
+        if (numItems > 0)
+        {
+            for (size_t idx = 0; idx < capacity(); ++idx)
+            {
+                if (controls[idx] != Empty)
+                {
+                    itemAt(idx).~Item();
+                }
+            }
+        }
+    }
+
+    void copyFrom(const HashTable& other)
+    {
+        hashFunction = other.hashFunction;
+        numItems     = 0;
+        controls = other.controls;
+        if (not slots.resizeWithoutInitializing(other.capacity()) or controls.size() != other.controls.size())
+        {
+            controls.clear();
+            slots.clear();
+            SC_ASSERT_DEBUG(false);
+            return;
+        }
+        for (size_t idx = 0; idx < capacity(); ++idx)
+        {
+            if (controls[idx] != Empty)
+            {
+                placementNew(itemAt(idx), other.itemAt(idx));
+            }
+        }
+        numItems = other.numItems;
+    }
+
+    void moveFrom(HashTable& other)
+    {
+        hashFunction   = other.hashFunction;
+        controls       = move(other.controls);
+        slots          = move(other.slots);
+        numItems       = other.numItems;
+        other.numItems = 0;
+    }
+};
+//! @}
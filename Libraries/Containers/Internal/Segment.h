@@ -18,6 +18,7 @@ template <typename T>
 struct SegmentItems;
 template <typename Allocator, typename T>
 struct SegmentOperations;
+struct MemoryAllocator;
 } // namespace SC
 
 //! @addtogroup group_containers
@@ -35,12 +36,15 @@ struct alignas(SC::uint64_t) SC::SegmentHeaderBase
     SizeType capacityBytes : sizeof(SizeType) * 8 - 1;
     SizeType isFollowedBySmallVector : 1;
 
+    MemoryAllocator* allocator; // Allocator of heap segments (`nullptr` means SC::Memory)
+
     void initDefaults()
     {
         static_assert(alignof(SegmentHeaderBase) == alignof(uint64_t), "SegmentHeaderBase check alignment");
-        static_assert(sizeof(SegmentHeaderBase) == sizeof(SizeType) * 2, "SegmentHeaderBase check alignment");
+        static_assert(sizeof(SegmentHeaderBase) % alignof(uint64_t) == 0, "SegmentHeaderBase check alignment");
         isSmallVector           = false;
         isFollowedBySmallVector = false;
+        allocator               = nullptr;
     }
 
     [[nodiscard]] static SegmentHeaderBase* getSegmentHeader(void* oldItems)
@@ -671,9 +675,21 @@ bool SC::SegmentOperations<Allocator, T>::shrink_to_fit(T*& oldItems)
             oldItems = Allocator::template getItems<T>(newSegment);
         }
     }
-    else
+    else if (oldSegment != nullptr)
     {
-        if (oldSegment != nullptr)
+        if (oldSegment->allocator != nullptr)
+        {
+            // An empty segment must be kept to remember the allocator, so it's just shrunk to its header
+            clear(oldSegment);
+            if (oldSegment->capacityBytes > 0)
+            {
+                SegmentHeader* newSegment = Allocator::reallocate(oldSegment, 0);
+                if (newSegment == nullptr)
+                    SC_LANGUAGE_UNLIKELY { return false; }
+                oldItems = Allocator::template getItems<T>(newSegment);
+            }
+        }
+        else
         {
             destroy(oldSegment);
             oldItems = nullptr;
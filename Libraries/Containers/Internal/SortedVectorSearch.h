@@ -0,0 +1,136 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "../../Foundation/TypeTraits.h"
+
+namespace SC
+{
+template <typename T>
+struct SortedVectorPackedKey;
+struct SortedVectorSearch;
+} // namespace SC
+
+//! @addtogroup group_containers
+//! @{
+
+/// @brief Tells if items of type T are integers that can be compared many at once with SIMD instructions
+template <typename T>
+struct SC::SortedVectorPackedKey
+{
+    static constexpr bool value = false;
+};
+// clang-format off
+template <> struct SC::SortedVectorPackedKey<SC::int32_t>  { static constexpr bool value = true; };
+template <> struct SC::SortedVectorPackedKey<SC::uint32_t> { static constexpr bool value = true; };
+template <> struct SC::SortedVectorPackedKey<SC::int64_t>  { static constexpr bool value = true; };
+template <> struct SC::SortedVectorPackedKey<SC::uint64_t> { static constexpr bool value = true; };
+// clang-format on
+
+/// @brief Binary search on sorted arrays, used by SC::SortedVectorMap and SC::SortedVectorSet.
+///
+/// Halving steps select the next half with a conditional move rather than a branch, so they don't pay for branch
+/// mispredictions. When items are packed integers (see SC::SortedVectorPackedKey) the search stops at a window of
+/// SortedVectorSearch::PackedWindowBytes (a cache line), and the position inside it is found counting items smaller
+/// than the key with SIMD comparisons (SSE2 on x86, NEON on ARM). This replaces the last halving steps, each one
+/// waiting for the memory load of the previous one, with a few independent comparisons.
+struct SC::SortedVectorSearch
+{
+    static constexpr size_t PackedWindowBytes = 64; ///< Bytes of packed items compared linearly at the end of search
+
+    /// @brief Finds index of the first item whose key is not smaller than the given key
+    /// @tparam KeyOfItem A type with a static `get(const Item&)` method returning the key of an item
+    /// @param items Items sorted by their key
+    /// @param numItems Number of items
+    /// @param key The key to search for
+    /// @return Index of the first item whose key is not smaller than key (or numItems if none)
+    template <typename KeyOfItem, typename Item, typename ComparableToKey>
+    [[nodiscard]] static size_t lowerBound(const Item* items, size_t numItems, const ComparableToKey& key)
+    {
+        constexpr bool Packed = SortedVectorPackedKey<Item>::value and TypeTraits::IsSame<Item, ComparableToKey>::value;
+        size_t         first  = 0;
+        while (numItems > (Packed ? PackedWindowBytes / sizeof(Item) : 1))
+        {
+            const size_t half = numItems / 2;
+            first             = (KeyOfItem::get(items[first + half]) < key) ? first + half : first;
+            numItems -= half;
+        }
+        return first + countSmaller<KeyOfItem>(items + first, numItems, key);
+    }
+
+    /// @brief Finds index of the first item whose key is greater than the given key
+    /// @tparam KeyOfItem A type with a static `get(const Item&)` method returning the key of an item
+    /// @param items Items sorted by their key
+    /// @param numItems Number of items
+    /// @param key The key to search for
+    /// @return Index of the first item whose key is greater than key (or numItems if none)
+    template <typename KeyOfItem, typename Item, typename ComparableToKey>
+    [[nodiscard]] static size_t upperBound(const Item* items, size_t numItems, const ComparableToKey& key)
+    {
+        size_t first = 0;
+        while (numItems > 0)
+        {
+            const size_t half = numItems / 2;
+            const auto&  test = KeyOfItem::get(items[first + half]);
+            if (test < key or test == key)
+            {
+                first += half + 1;
+                numItems -= half + 1;
+            }
+            else
+            {
+                numItems = half;
+            }
+        }
+        return first;
+    }
+
+  private:
+    template <typename KeyOfItem, typename Item, typename ComparableToKey>
+    [[nodiscard]] static typename TypeTraits::EnableIf<
+        not(SortedVectorPackedKey<Item>::value and TypeTraits::IsSame<Item, ComparableToKey>::value), size_t>::type
+    countSmaller(const Item* items, size_t numItems, const ComparableToKey& key)
+    {
+        size_t count = 0;
+        for (size_t idx = 0; idx < numItems; ++idx)
+        {
+            count += (KeyOfItem::get(items[idx]) < key) ? 1 : 0;
+        }
+        return count;
+    }
+
+    template <typename KeyOfItem, typename Item, typename ComparableToKey>
+    [[nodiscard]] static typename TypeTraits::EnableIf<
+        SortedVectorPackedKey<Item>::value and TypeTraits::IsSame<Item, ComparableToKey>::value, size_t>::type
+    countSmaller(const Item* items, size_t numItems, const ComparableToKey& key)
+    {
+        size_t idx   = 0;
+        size_t count = 0;
+#if SC_COMPILER_GCC || SC_COMPILER_CLANG
+        // Compiler vector extensions generate SSE2 / NEON code without including intrinsics headers
+        typedef Item     Vector __attribute__((vector_size(16)));
+        constexpr size_t LanesCount  = 16 / sizeof(Item);
+        Vector           keyVector   = {};
+        Vector           accumulator = {};
+        for (size_t lane = 0; lane < LanesCount; ++lane)
+        {
+            keyVector[lane] = key;
+        }
+        for (; idx + LanesCount <= numItems; idx += LanesCount)
+        {
+            Vector values;
+            __builtin_memcpy(&values, items + idx, sizeof(values));
+            accumulator -= static_cast<Vector>(values < keyVector); // Comparison sets all bits (-1) of true lanes
+        }
+        for (size_t lane = 0; lane < LanesCount; ++lane)
+        {
+            count += static_cast<size_t>(accumulator[lane]);
+        }
+#endif
+        for (; idx < numItems; ++idx)
+        {
+            count += (items[idx] < key) ? 1 : 0;
+        }
+        return count;
+    }
+};
+//! @}
@@ -75,6 +75,16 @@ struct SC::SmallVector : public Vector<T>
         return *this;
     }
 
+#if SC_MEMORY_TAGGING
+    ~SmallVector()
+    {
+        if (Vector<T>::items == buffer.items)
+        {
+            MemoryTagLink::countSmallVectorInline();
+        }
+    }
+#endif
+
   private:
     void init()
     {
@@ -0,0 +1,241 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "../Algorithms/AlgorithmQuickSort.h"
+#include "../Containers/Internal/SortedVectorSearch.h"
+#include "../Containers/VectorMap.h" // VectorMapItem
+
+namespace SC
+{
+template <typename Key, typename Value, typename Container>
+struct SortedVectorMap;
+} // namespace SC
+//! @addtogroup group_containers
+//! @{
+
+/// @brief A map holding VectorMapItem key-value pairs in a Vector sorted by key, for fast lookup of read-mostly data.
+///
+/// Lookups are binary searches taking `O(log(n))`, while insertion and removal take linear time as they move all
+/// following items. Items are contiguous in memory and iterated in key order.
+/// To build a large map, append all items to SortedVectorMap::items and call SortedVectorMap::sortItems once,
+/// instead of inserting them one by one.
+/// It works on top of SC::Vector, SC::SmallVector or SC::Array, as given by the Container template parameter.
+/// @tparam Key Type of the key (must support `<` and `==` comparisons)
+/// @tparam Value Value type associated with Key
+/// @tparam Container Container used for the Map
+template <typename Key, typename Value, typename Container = SC::Vector<SC::VectorMapItem<Key, Value>>>
+struct SC::SortedVectorMap
+{
+    using Item = VectorMapItem<Key, Value>;
+
+    struct KeyOfItem
+    {
+        static const Key& get(const Item& item) { return item.key; }
+    };
+
+    /// @brief Items sorted by key.
+    /// Items can be freely appended (for example during loading) if SortedVectorMap::sortItems is called afterwards.
+    Container items;
+
+    /// @brief Return the number of key-value pairs in the map
+    [[nodiscard]] auto size() const { return items.size(); }
+
+    /// @brief Check if the map is empty
+    [[nodiscard]] auto isEmpty() const { return items.isEmpty(); }
+
+    [[nodiscard]] Item*       begin() { return items.begin(); }
+    [[nodiscard]] const Item* begin() const { return items.begin(); }
+    [[nodiscard]] Item*       end() { return items.end(); }
+    [[nodiscard]] const Item* end() const { return items.end(); }
+
+    /// @brief Sorts items by key in `O(n log(n))`, removing items with duplicated keys.
+    /// Of all items with equal key only one is kept, but which one is unspecified.
+    /// @return `false` if removing duplicated items fails
+    [[nodiscard]] bool sortItems()
+    {
+        Algorithms::quickSort(items.begin(), items.end(), [](const Item& a, const Item& b) { return a.key < b.key; });
+        size_t numUnique = 0;
+        for (size_t idx = 0; idx < items.size(); ++idx)
+        {
+            if (numUnique == 0 or items[numUnique - 1].key < items[idx].key)
+            {
+                if (idx != numUnique)
+                {
+                    items[numUnique] = move(items[idx]);
+                }
+                numUnique++;
+            }
+        }
+        while (items.size() > numUnique)
+        {
+            if (not items.pop_back())
+                return false;
+        }
+        return true;
+    }
+
+    /// @brief Index of the first item whose key is not smaller than the given key (or size() if none)
+    template <typename ComparableToKey>
+    [[nodiscard]] size_t lowerBound(const ComparableToKey& key) const
+    {
+        return SortedVectorSearch::lowerBound<KeyOfItem>(items.begin(), items.size(), key);
+    }
+
+    /// @brief Index of the first item whose key is greater than the given key (or size() if none)
+    template <typename ComparableToKey>
+    [[nodiscard]] size_t upperBound(const ComparableToKey& key) const
+    {
+        return SortedVectorSearch::upperBound<KeyOfItem>(items.begin(), items.size(), key);
+    }
+
+    /// @brief Returns all items with keys in the `[from, to)` range
+    template <typename From, typename To>
+    [[nodiscard]] Span<const Item> getRange(const From& from, const To& to) const
+    {
+        const size_t first = lowerBound(from);
+        const size_t last  = lowerBound(to);
+        return {items.begin() + first, last > first ? last - first : 0};
+    }
+
+    /// @brief Returns all items with keys in the `[from, to)` range
+    template <typename From, typename To>
+    [[nodiscard]] Span<Item> getRange(const From& from, const To& to)
+    {
+        const size_t first = lowerBound(from);
+        const size_t last  = lowerBound(to);
+        return {items.begin() + first, last > first ? last - first : 0};
+    }
+
+    /// @brief Remove an item with matching key from the Map
+    /// @param key The key that must be removed
+    /// @return `true` if the item was found
+    template <typename ComparableToKey>
+    [[nodiscard]] bool remove(const ComparableToKey& key)
+    {
+        const size_t idx = lowerBound(key);
+        if (idx < items.size() and items[idx].key == key)
+        {
+            return items.removeAt(idx);
+        }
+        return false;
+    }
+
+    /// @brief Inserts an item if it doesn't exist already.
+    /// @param item The item to insert
+    /// @return `false` if item already exists or if insertion fails (`true` otherwise)
+    [[nodiscard]] bool insertIfNotExists(Item&& item)
+    {
+        const size_t idx = lowerBound(item.key);
+        if (idx < items.size() and items[idx].key == item.key)
+        {
+            return false;
+        }
+        return insertAt(idx, move(item)) != nullptr;
+    }
+
+    /// @brief Insert an item, overwriting the potentially already existing one
+    /// @param item Item to insert
+    /// @return A pointer to the Value if insertion succeeds, `nullptr` if insertion fails.
+    [[nodiscard]] Value* insertOverwrite(Item&& item)
+    {
+        const size_t idx = lowerBound(item.key);
+        if (idx < items.size() and items[idx].key == item.key)
+        {
+            items[idx].value = move(item.value);
+            return &items[idx].value;
+        }
+        Item* inserted = insertAt(idx, move(item));
+        return inserted != nullptr ? &inserted->value : nullptr;
+    }
+
+    /// @brief Inserts a new value, automatically generating key with Key::generateUniqueKey (works for StrongID for
+    /// example)
+    /// @param value The new value to be inserted
+    /// @return A pointer to the new Key or `nullptr` if the map is full
+    [[nodiscard]] const Key* insertValueUniqueKey(Value&& value)
+    {
+        const Key key  = Key::generateUniqueKey(*this);
+        Item*     item = insertAt(lowerBound(key), {key, forward<Value>(value)});
+        return item != nullptr ? &item->key : nullptr;
+    }
+
+    /// @brief Check if the given key is contained in the map
+    template <typename ComparableToKey>
+    [[nodiscard]] bool contains(const ComparableToKey& key) const
+    {
+        return get(key) != nullptr;
+    }
+
+    /// @brief Check if the given key is contained in the map
+    /// @param key The key to search for inside current map
+    /// @param outValue A reference that will receive pointer to the found element (if found)
+    template <typename ComparableToKey>
+    [[nodiscard]] bool contains(const ComparableToKey& key, const Value*& outValue) const
+    {
+        const Value* value = get(key);
+        if (value != nullptr)
+        {
+            outValue = value;
+            return true;
+        }
+        return false;
+    }
+
+    /// @brief Check if the given key is contained in the map
+    /// @param key The key to search for inside current map
+    /// @param outValue A reference that will receive pointer to the found element (if found)
+    template <typename ComparableToKey>
+    [[nodiscard]] bool contains(const ComparableToKey& key, Value*& outValue)
+    {
+        Value* value = get(key);
+        if (value != nullptr)
+        {
+            outValue = value;
+            return true;
+        }
+        return false;
+    }
+
+    /// @brief Get the Value associated to the given key
+    /// @return A pointer to the value if it exists in the map, `nullptr` otherwise
+    template <typename ComparableToKey>
+    [[nodiscard]] const Value* get(const ComparableToKey& key) const
+    {
+        const size_t idx = lowerBound(key);
+        return idx < items.size() and items[idx].key == key ? &items[idx].value : nullptr;
+    }
+
+    /// @brief Get the Value associated to the given key
+    /// @return A pointer to the value if it exists in the map, `nullptr` otherwise
+    template <typename ComparableToKey>
+    [[nodiscard]] Value* get(const ComparableToKey& key)
+    {
+        const size_t idx = lowerBound(key);
+        return idx < items.size() and items[idx].key == key ? &items[idx].value : nullptr;
+    }
+
+    /// @brief Get the value associated to the given key, or creates a new one if needed
+    /// @return A pointer to the value or `nullptr` if the map is full
+    template <typename ComparableToKey>
+    [[nodiscard]] Value* getOrCreate(const ComparableToKey& key)
+    {
+        const size_t idx = lowerBound(key);
+        if (idx < items.size() and items[idx].key == key)
+        {
+            return &items[idx].value;
+        }
+        Item* inserted = insertAt(idx, {key, Value()});
+        return inserted != nullptr ? &inserted->value : nullptr;
+    }
+
+  private:
+    Item* insertAt(size_t idx, Item&& item)
+    {
+        if (not items.insert(idx, move(item)))
+        {
+            return nullptr;
+        }
+        return &items[idx];
+    }
+};
+//! @}
@@ -0,0 +1,127 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "../Algorithms/AlgorithmQuickSort.h"
+#include "../Containers/Internal/SortedVectorSearch.h"
+#include "../Containers/Vector.h"
+
+namespace SC
+{
+template <typename Value, typename Container>
+struct SortedVectorSet;
+} // namespace SC
+
+//! @addtogroup group_containers
+//! @{
+
+/// @brief A set built on a sorted Vector, ensuring no item duplication, for fast lookup of read-mostly data.
+///
+/// Lookups are binary searches taking `O(log(n))`, while insertion and removal take linear time.
+/// Sets of `int32_t`, `uint32_t`, `int64_t` or `uint64_t` complete the search comparing many values at once with SIMD
+/// instructions (see SC::SortedVectorSearch).
+/// To build a large set, append all values to SortedVectorSet::items and call SortedVectorSet::sortItems once.
+/// @tparam Value The contained value (must support `<` and `==` comparisons)
+/// @tparam Container The underlying container used (SC::Vector, SC::SmallVector or SC::Array)
+template <typename Value, typename Container = SC::Vector<Value>>
+struct SC::SortedVectorSet
+{
+    struct KeyOfItem
+    {
+        static const Value& get(const Value& value) { return value; }
+    };
+
+    /// @brief Sorted values.
+    /// Values can be freely appended (for example during loading) if SortedVectorSet::sortItems is called afterwards.
+    Container items;
+
+    /// @brief Return size of the set
+    [[nodiscard]] auto size() const { return items.size(); }
+
+    /// @brief Check if the set is empty
+    [[nodiscard]] auto isEmpty() const { return items.isEmpty(); }
+
+    [[nodiscard]] const Value* begin() const { return items.begin(); }
+    [[nodiscard]] const Value* end() const { return items.end(); }
+
+    /// @brief Sorts values in `O(n log(n))`, removing duplicated ones
+    /// @return `false` if removing duplicated values fails
+    [[nodiscard]] bool sortItems()
+    {
+        Algorithms::quickSort(items.begin(), items.end(), [](const Value& a, const Value& b) { return a < b; });
+        size_t numUnique = 0;
+        for (size_t idx = 0; idx < items.size(); ++idx)
+        {
+            if (numUnique == 0 or items[numUnique - 1] < items[idx])
+            {
+                if (idx != numUnique)
+                {
+                    items[numUnique] = move(items[idx]);
+                }
+                numUnique++;
+            }
+        }
+        while (items.size() > numUnique)
+        {
+            if (not items.pop_back())
+                return false;
+        }
+        return true;
+    }
+
+    /// @brief Index of the first value not smaller than the given one (or size() if none)
+    template <typename ComparableToValue>
+    [[nodiscard]] size_t lowerBound(const ComparableToValue& value) const
+    {
+        return SortedVectorSearch::lowerBound<KeyOfItem>(items.begin(), items.size(), value);
+    }
+
+    /// @brief Index of the first value greater than the given one (or size() if none)
+    template <typename ComparableToValue>
+    [[nodiscard]] size_t upperBound(const ComparableToValue& value) const
+    {
+        return SortedVectorSearch::upperBound<KeyOfItem>(items.begin(), items.size(), value);
+    }
+
+    /// @brief Returns all values in the `[from, to)` range
+    template <typename From, typename To>
+    [[nodiscard]] Span<const Value> getRange(const From& from, const To& to) const
+    {
+        const size_t first = lowerBound(from);
+        const size_t last  = lowerBound(to);
+        return {items.begin() + first, last > first ? last - first : 0};
+    }
+
+    /// @brief Check if the given Value exists in the SortedVectorSet
+    template <typename ComparableToValue>
+    [[nodiscard]] bool contains(const ComparableToValue& value) const
+    {
+        const size_t idx = lowerBound(value);
+        return idx < items.size() and items[idx] == value;
+    }
+
+    /// @brief Inserts a value in the SortedVectorSet (if it doesn't already exists)
+    /// @return `false` if memory allocation fails
+    [[nodiscard]] bool insert(const Value& value)
+    {
+        const size_t idx = lowerBound(value);
+        if (idx < items.size() and items[idx] == value)
+        {
+            return true;
+        }
+        return items.insert(idx, {&value, 1});
+    }
+
+    /// @brief Removes a value from the SortedVectorSet (if it exists)
+    /// @return `true` if the value was found
+    template <typename ComparableToValue>
+    [[nodiscard]] bool remove(const ComparableToValue& value)
+    {
+        const size_t idx = lowerBound(value);
+        if (idx < items.size() and items[idx] == value)
+        {
+            return items.removeAt(idx);
+        }
+        return false;
+    }
+};
+//! @}
@@ -0,0 +1,194 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../ChunkedArenaMap.h"
+#include "../../Strings/String.h"
+#include "../../Testing/Testing.h"
+
+namespace SC
+{
+struct ChunkedArenaMapTest;
+}
+
+struct SC::ChunkedArenaMapTest : public SC::TestCase
+{
+    ChunkedArenaMapTest(SC::TestReport& report) : TestCase(report, "ChunkedArenaMapTest")
+    {
+        using namespace SC;
+        if (test_section("insert/get/remove/contains"))
+        {
+            ChunkedArenaMap<String, 2> map;
+            ChunkedArenaMap<String, 2>::Key keys[3];
+            SC_TEST_EXPECT(map.getNumChunks() == 0);
+            keys[0] = map.insert("ASD");
+            SC_TEST_EXPECT(map.size() == 1);
+            SC_TEST_EXPECT(map.getNumChunks() == 1);
+            keys[1] = map.insert("DSA");
+            keys[2] = map.insert("BDA");
+            SC_TEST_EXPECT(map.getNumChunks() == 2);
+            SC_TEST_EXPECT(map.getNumAllocated() == 4);
+            int index = 0;
+            for (const auto& it : map)
+            {
+                switch (index++)
+                {
+                case 0: SC_TEST_EXPECT(it == "ASD"); break;
+                case 1: SC_TEST_EXPECT(it == "DSA"); break;
+                case 2: SC_TEST_EXPECT(it == "BDA"); break;
+                }
+            }
+            SC_TEST_EXPECT(index == 3);
+            SC_TEST_EXPECT(map.get(keys[0])->view() == "ASD");
+            SC_TEST_EXPECT(map.get(keys[1])->view() == "DSA");
+            SC_TEST_EXPECT(map.get(keys[2])->view() == "BDA");
+            ChunkedArenaMap<String, 2>::Key key;
+            SC_TEST_EXPECT(not map.containsKey(key));
+            SC_TEST_EXPECT(map.get(key) == nullptr);
+            SC_TEST_EXPECT(map.containsValue("BDA", &key) and key == keys[2]);
+            SC_TEST_EXPECT(not map.containsValue("__ASD__"));
+            SC_TEST_EXPECT(map.remove(keys[1]));
+            SC_TEST_EXPECT(not map.remove(keys[1]));
+            SC_TEST_EXPECT(not map.containsKey(keys[1]));
+            SC_TEST_EXPECT(map.get(keys[1]) == nullptr);
+
+            // New objects go in the first free slot
+            const auto newKey = map.insert("123");
+            SC_TEST_EXPECT(map.get(newKey)->view() == "123");
+            SC_TEST_EXPECT(not(newKey == keys[1]));
+            SC_TEST_EXPECT(map.get(keys[1]) == nullptr);
+            index = 0;
+            for (auto& it : map)
+            {
+                switch (index++)
+                {
+                case 0: SC_TEST_EXPECT(it == "ASD"); break;
+                case 1:
+                    SC_TEST_EXPECT(it == "123");
+                    it = "456";
+                    break;
+                case 2: SC_TEST_EXPECT(it == "BDA"); break;
+                }
+            }
+            SC_TEST_EXPECT(map.get(newKey)->view() == "456");
+        }
+        if (test_section("growth"))
+        {
+            // Objects never move when the map grows
+            ChunkedArenaMap<String, 4> map;
+            ChunkedArenaMap<String, 4>::Key keys[100];
+            String*                         pointers[100];
+            for (int idx = 0; idx < 100; ++idx)
+            {
+                keys[idx] = map.insert(String("value"));
+                SC_TEST_EXPECT(keys[idx].isValid());
+                pointers[idx] = map.get(keys[idx]);
+            }
+            SC_TEST_EXPECT(map.size() == 100);
+            SC_TEST_EXPECT(map.getNumChunks() == 25);
+            for (int idx = 0; idx < 100; ++idx)
+            {
+                SC_TEST_EXPECT(map.get(keys[idx]) == pointers[idx]);
+            }
+        }
+        if (test_section("release"))
+        {
+            ChunkedArenaMap<int, 4> map;
+            ChunkedArenaMap<int, 4>::Key keys[16];
+            for (int idx = 0; idx < 16; ++idx)
+            {
+                keys[idx] = map.insert(idx);
+            }
+            SC_TEST_EXPECT(map.getNumChunks() == 4);
+            // Empty chunks in the middle are kept
+            for (int idx = 4; idx < 8; ++idx)
+            {
+                SC_TEST_EXPECT(map.remove(keys[idx]));
+            }
+            SC_TEST_EXPECT(map.getNumChunks() == 4);
+            int sum = 0;
+            for (int value : map)
+            {
+                sum += value;
+            }
+            SC_TEST_EXPECT(sum == (0 + 1 + 2 + 3) + (8 + 9 + 10 + 11) + (12 + 13 + 14 + 15));
+            // Removing never releases chunks, while trailing empty chunks are released on request keeping the last one
+            for (int idx = 8; idx < 16; ++idx)
+            {
+                SC_TEST_EXPECT(map.remove(keys[idx]));
+            }
+            SC_TEST_EXPECT(map.size() == 4);
+            SC_TEST_EXPECT(map.getNumChunks() == 4);
+            SC_TEST_EXPECT(map.releaseEmptyChunks() == 2);
+            SC_TEST_EXPECT(map.getNumChunks() == 2);
+            SC_TEST_EXPECT(map.releaseEmptyChunks() == 0);
+            // Keys of objects in released chunks stay invalid when chunks are allocated again
+            ChunkedArenaMap<int, 4>::Key newKeys[12];
+            for (int idx = 0; idx < 12; ++idx)
+            {
+                newKeys[idx] = map.insert(100 + idx);
+            }
+            SC_TEST_EXPECT(map.getNumChunks() == 4);
+            for (int idx = 4; idx < 16; ++idx)
+            {
+                SC_TEST_EXPECT(not map.containsKey(keys[idx]));
+                SC_TEST_EXPECT(not map.remove(keys[idx]));
+            }
+            for (int idx = 0; idx < 12; ++idx)
+            {
+                SC_TEST_EXPECT(*map.get(newKeys[idx]) == 100 + idx);
+            }
+            map.clear();
+            SC_TEST_EXPECT(map.size() == 0 and map.getNumChunks() == 0);
+            SC_TEST_EXPECT(map.begin() == map.end());
+            SC_TEST_EXPECT(not map.containsKey(newKeys[0]));
+            const auto key = map.insert(1);
+            SC_TEST_EXPECT(not map.containsKey(newKeys[0]) and not map.containsKey(keys[0]));
+            SC_TEST_EXPECT(*map.get(key) == 1);
+        }
+        if (test_section("max size"))
+        {
+            ChunkedArenaMap<int, 4> map;
+            map.setMaxSize(5);
+            ChunkedArenaMap<int, 4>::Key keys[5];
+            for (int idx = 0; idx < 5; ++idx)
+            {
+                keys[idx] = map.insert(idx);
+                SC_TEST_EXPECT(keys[idx].isValid());
+            }
+            SC_TEST_EXPECT(not map.insert(5).isValid());
+            SC_TEST_EXPECT(map.remove(keys[2]));
+            SC_TEST_EXPECT(map.insert(5).isValid());
+        }
+        if (test_section("copy"))
+        {
+            ChunkedArenaMap<String, 2> map, mapCopy, mapMove;
+            ChunkedArenaMap<String, 2>::Key keys[3];
+            keys[0] = map.insert("ASD");
+            keys[1] = map.insert("DSA");
+            keys[2] = map.insert("BDA");
+            mapCopy = map;
+            mapMove = move(map);
+
+#ifndef __clang_analyzer__
+            SC_TEST_EXPECT(map.size() == 0);
+#endif // not __clang_analyzer__
+            SC_TEST_EXPECT(mapCopy.size() == 3);
+            SC_TEST_EXPECT(mapMove.size() == 3);
+
+            SC_TEST_EXPECT(mapCopy.get(keys[0])->view() == "ASD");
+            SC_TEST_EXPECT(mapCopy.get(keys[1])->view() == "DSA");
+            SC_TEST_EXPECT(mapCopy.get(keys[2])->view() == "BDA");
+
+            SC_TEST_EXPECT(mapCopy.remove(keys[0]));
+            SC_TEST_EXPECT(mapCopy.size() == 2);
+
+            SC_TEST_EXPECT(mapMove.get(keys[0])->view() == "ASD");
+            SC_TEST_EXPECT(mapMove.get(keys[1])->view() == "DSA");
+            SC_TEST_EXPECT(mapMove.get(keys[2])->view() == "BDA");
+        }
+    }
+};
+
+namespace SC
+{
+void runChunkedArenaMapTest(SC::TestReport& report) { ChunkedArenaMapTest test(report); }
+} // namespace SC
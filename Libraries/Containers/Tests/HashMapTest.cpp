@@ -0,0 +1,240 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../HashMap.h"
+#include "../../Containers/VectorMap.h"
+#include "../../Strings/String.h"
+#include "../../Testing/Testing.h"
+
+namespace SC
+{
+struct HashMapTest;
+}
+
+struct SC::HashMapTest : public SC::TestCase
+{
+    // Maps all keys to a few hashes (with the same control byte), to test long clusters and wrapping around
+    struct CollidingHash
+    {
+        uint64_t operator()(int value) const { return static_cast<uint64_t>(value % 5) + 13; }
+    };
+
+    inline void testRandomOperations();
+
+    HashMapTest(SC::TestReport& report) : TestCase(report, "HashMapTest")
+    {
+        using namespace SC;
+        if (test_section("contains"))
+        {
+            HashMap<int, int> map;
+            SC_TEST_EXPECT(map.isEmpty());
+            SC_TEST_EXPECT(map.insertIfNotExists({1, 2}));
+            SC_TEST_EXPECT(map.insertIfNotExists({2, 3}));
+            SC_TEST_EXPECT(not map.insertIfNotExists({2, 4}));
+            SC_TEST_EXPECT(map.size() == 2);
+            const int* value;
+            SC_TEST_EXPECT(map.contains(1, value) && *value == 2);
+            SC_TEST_EXPECT(map.contains(2, value) && *value == 3);
+            SC_TEST_EXPECT(not map.contains(3));
+            SC_TEST_EXPECT(*map.insertOverwrite({2, 5}) == 5);
+            SC_TEST_EXPECT(*map.get(2) == 5);
+            SC_TEST_EXPECT(map.size() == 2);
+            int* created = map.getOrCreate(7);
+            SC_TEST_EXPECT(created != nullptr and *created == 0);
+            *created = 8;
+            SC_TEST_EXPECT(*map.getOrCreate(7) == 8);
+            SC_TEST_EXPECT(map.size() == 3);
+        }
+        if (test_section("strings"))
+        {
+            //! [hashMapSnippet]
+            HashMap<String, String> map;
+            SC_TEST_EXPECT(map.insertIfNotExists({"Ciao", "Fra"}));
+            SC_TEST_EXPECT(map.insertIfNotExists({"Bella", "Bro"}));
+            // Lookup with a StringView, without creating a String
+            String* value = map.get("Ciao");
+            SC_TEST_EXPECT(value and value->view() == "Fra");
+            SC_TEST_EXPECT(map.get("Fail") == nullptr);
+            // UTF16 StringView-s have the same hash of equal UTF8 ones
+            SC_TEST_EXPECT(map.contains("B\x00" "e\x00" "l\x00" "l\x00" "a\x00"_u16));
+            SC_TEST_EXPECT(map.remove("Bella"));
+            SC_TEST_EXPECT(not map.contains("Bella"));
+            //! [hashMapSnippet]
+        }
+        if (test_section("remove"))
+        {
+            HashMap<int, int, CollidingHash> map;
+            for (int idx = 0; idx < 10; ++idx)
+            {
+                SC_TEST_EXPECT(map.insertIfNotExists({idx, idx * 10}));
+            }
+            // Removing from the middle of a cluster must shift back following items
+            for (int idx = 0; idx < 10; idx += 2)
+            {
+                SC_TEST_EXPECT(map.remove(idx));
+                SC_TEST_EXPECT(not map.remove(idx));
+            }
+            SC_TEST_EXPECT(map.size() == 5);
+            for (int idx = 0; idx < 10; ++idx)
+            {
+                const int* value = map.get(idx);
+                SC_TEST_EXPECT((idx % 2 == 0) == (value == nullptr));
+                SC_TEST_EXPECT(value == nullptr or *value == idx * 10);
+            }
+        }
+        if (test_section("grow"))
+        {
+            HashMap<int, int> map;
+            constexpr int     NumItems = 10000;
+            for (int idx = 0; idx < NumItems; ++idx)
+            {
+                SC_TEST_EXPECT(map.insertIfNotExists({idx * 7, idx}));
+            }
+            SC_TEST_EXPECT(map.size() == NumItems);
+            SC_TEST_EXPECT(map.items.capacity() * 3 / 4 >= NumItems);
+            for (int idx = 0; idx < NumItems; ++idx)
+            {
+                const int* value = map.get(idx * 7);
+                SC_TEST_EXPECT(value and *value == idx);
+                SC_TEST_EXPECT(not map.contains(idx * 7 + 1));
+            }
+            HashMap<int, int> reserved;
+            SC_TEST_EXPECT(reserved.reserve(1000));
+            const size_t capacity = reserved.items.capacity();
+            for (int idx = 0; idx < 1000; ++idx)
+            {
+                SC_TEST_EXPECT(reserved.insertIfNotExists({idx, idx}));
+            }
+            SC_TEST_EXPECT(reserved.items.capacity() == capacity);
+            reserved.clear();
+            SC_TEST_EXPECT(reserved.isEmpty() and not reserved.contains(1));
+            SC_TEST_EXPECT(reserved.items.capacity() == capacity);
+        }
+        if (test_section("copy move"))
+        {
+            HashMap<String, int> map;
+            SC_TEST_EXPECT(map.insertIfNotExists({"one", 1}));
+            SC_TEST_EXPECT(map.insertIfNotExists({"two", 2}));
+            HashMap<String, int> copy = map;
+            SC_TEST_EXPECT(copy.size() == 2 and *copy.get("one") == 1 and *copy.get("two") == 2);
+            SC_TEST_EXPECT(copy.remove("one"));
+            SC_TEST_EXPECT(map.contains("one"));
+            HashMap<String, int> moved = move(map);
+            SC_TEST_EXPECT(moved.size() == 2 and *moved.get("one") == 1);
+            SC_TEST_EXPECT(map.isEmpty() and not map.contains("one"));
+            copy = moved;
+            SC_TEST_EXPECT(copy.size() == 2 and *copy.get("two") == 2);
+            moved = move(copy);
+            SC_TEST_EXPECT(moved.size() == 2 and *moved.get("two") == 2);
+        }
+        if (test_section("iterate"))
+        {
+            HashMap<int, int> map;
+            for (int idx = 1; idx <= 100; ++idx)
+            {
+                SC_TEST_EXPECT(map.insertIfNotExists({idx, idx * 2}));
+            }
+            int sumKeys   = 0;
+            int numValues = 0;
+            for (HashMapItem<int, int>& item : map)
+            {
+                SC_TEST_EXPECT(item.value == item.key * 2);
+                sumKeys += item.key;
+                item.value = 0;
+            }
+            const HashMap<int, int>& constMap = map;
+            for (const HashMapItem<int, int>& item : constMap)
+            {
+                numValues += item.value == 0 ? 1 : 0;
+            }
+            SC_TEST_EXPECT(sumKeys == 5050);
+            SC_TEST_EXPECT(numValues == 100);
+        }
+        if (test_section("StrongID"))
+        {
+            struct Key
+            {
+                using ID = StrongID<Key>;
+            };
+            struct IDHash
+            {
+                uint64_t operator()(Key::ID key) const { return Hash<int32_t>()(key.identifier); }
+            };
+            HashMap<Key::ID, String, IDHash> map;
+            const Key::ID key1 = Key::ID::generateUniqueKey(map);
+            SC_TEST_EXPECT(map.insertIfNotExists({key1, "key1"}));
+            auto res = map.insertValueUniqueKey("key2");
+            SC_TEST_EXPECT(res);
+            const Key::ID key2 = *res;
+            SC_TEST_EXPECT(map.get(key1)->view() == "key1");
+            SC_TEST_EXPECT(map.get(key2)->view() == "key2");
+        }
+        if (test_section("hash"))
+        {
+            SC_TEST_EXPECT(Hash<int>()(1) != Hash<int>()(2));
+            SC_TEST_EXPECT(""_a8.hash() == ""_u16.hash());
+            SC_TEST_EXPECT("ascii"_a8.hash() == "ascii"_u8.hash());
+            SC_TEST_EXPECT("ascii"_a8.hash() != "asci"_a8.hash());
+            // U+00E0, U+20AC and U+1F600 (a surrogate pair in UTF16) followed by ASCII
+            const StringView utf16 = "\xE0\x00" "\xAC\x20" "\x3D\xD8\x00\xDE" " \x00" "a\x00" "b\x00" "c\x00" "d\x00"
+                                     "e\x00" "f\x00" "g\x00" "h\x00"_u16;
+            SC_TEST_EXPECT(utf16.hash() == "\xC3\xA0\xE2\x82\xAC\xF0\x9F\x98\x80 abcdefgh"_u8.hash());
+            SC_TEST_EXPECT(utf16.hash() != "\xC3\xA0\xE2\x82\xAC\xF0\x9F\x98\x80 abcdefg"_u8.hash());
+            // Hash doesn't depend on how bytes are split between calls
+            HashBytes split;
+            split.add("0123", 4);
+            split.add("456789abcdef", 12);
+            split.addByte('g');
+            HashBytes single;
+            single.add("0123456789abcdefg", 17);
+            SC_TEST_EXPECT(split.finish() == single.finish());
+            SC_TEST_EXPECT(String("hello").hash() == "hello"_a8.hash());
+        }
+        if (test_section("random"))
+        {
+            testRandomOperations();
+        }
+    }
+};
+
+void SC::HashMapTest::testRandomOperations()
+{
+    // Compares a HashMap with colliding hashes against a VectorMap, after random insertions and removals
+    HashMap<int, int, CollidingHash> map;
+    VectorMap<int, int>              reference;
+
+    uint32_t random = 12345;
+    for (int iteration = 0; iteration < 20000; ++iteration)
+    {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        const int key = static_cast<int>(random % 300);
+        if (random & 0x10000)
+        {
+            SC_TEST_EXPECT(map.insertOverwrite({key, iteration}) != nullptr);
+            SC_TEST_EXPECT(reference.insertOverwrite({key, iteration}) != nullptr);
+        }
+        else
+        {
+            SC_TEST_EXPECT(map.remove(key) == reference.remove(key));
+        }
+    }
+    SC_TEST_EXPECT(map.size() == reference.size());
+    for (const VectorMapItem<int, int>& item : reference)
+    {
+        const int* value = map.get(item.key);
+        SC_TEST_EXPECT(value and *value == item.value);
+    }
+    size_t numItems = 0;
+    for (const HashMapItem<int, int>& item : map)
+    {
+        SC_TEST_EXPECT(reference.contains(item.key));
+        numItems++;
+    }
+    SC_TEST_EXPECT(numItems == reference.size());
+}
+
+namespace SC
+{
+void runHashMapTest(SC::TestReport& report) { HashMapTest test(report); }
+} // namespace SC
@@ -0,0 +1,65 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../HashSet.h"
+#include "../../Strings/String.h"
+#include "../../Testing/Testing.h"
+
+namespace SC
+{
+struct HashSetTest;
+}
+
+struct SC::HashSetTest : public SC::TestCase
+{
+    HashSetTest(SC::TestReport& report) : TestCase(report, "HashSetTest")
+    {
+        using namespace SC;
+        if (test_section("simple"))
+        {
+            //! [hashSetSnippet]
+            HashSet<String> setOfStrings;
+            SC_TEST_EXPECT(setOfStrings.insert("123"));
+            SC_TEST_EXPECT(setOfStrings.insert("123"));
+            SC_TEST_EXPECT(setOfStrings.contains("123"));
+            SC_TEST_EXPECT(setOfStrings.insert("456"));
+            SC_TEST_EXPECT(setOfStrings.contains("123"));
+            SC_TEST_EXPECT(setOfStrings.contains("456"));
+            SC_TEST_EXPECT(setOfStrings.size() == 2);
+            SC_TEST_EXPECT(setOfStrings.remove("123"));
+            SC_TEST_EXPECT(not setOfStrings.remove("123"));
+            SC_TEST_EXPECT(setOfStrings.size() == 1);
+            SC_TEST_EXPECT(setOfStrings.contains("456"));
+            SC_TEST_EXPECT(not setOfStrings.contains("123"));
+
+            for (auto& item : setOfStrings)
+            {
+                SC_TEST_EXPECT(item == "456");
+            }
+            //! [hashSetSnippet]
+        }
+        if (test_section("integers"))
+        {
+            HashSet<uint32_t> set;
+            for (uint32_t idx = 0; idx < 1000; ++idx)
+            {
+                SC_TEST_EXPECT(set.insert(idx * 3));
+            }
+            for (uint32_t idx = 0; idx < 1000; idx += 2)
+            {
+                SC_TEST_EXPECT(set.remove(idx * 3));
+            }
+            SC_TEST_EXPECT(set.size() == 500);
+            for (uint32_t idx = 0; idx < 3000; ++idx)
+            {
+                SC_TEST_EXPECT(set.contains(idx) == (idx % 6 == 3));
+            }
+            set.clear();
+            SC_TEST_EXPECT(set.isEmpty() and not set.contains(3u));
+        }
+    }
+};
+
+namespace SC
+{
+void runHashSetTest(SC::TestReport& report) { HashSetTest test(report); }
+} // namespace SC
@@ -0,0 +1,122 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../SortedVectorMap.h"
+#include "../../Containers/Array.h"
+#include "../../Strings/String.h"
+#include "../../Testing/Testing.h"
+
+namespace SC
+{
+struct SortedVectorMapTest;
+}
+
+struct SC::SortedVectorMapTest : public SC::TestCase
+{
+    SortedVectorMapTest(SC::TestReport& report) : TestCase(report, "SortedVectorMapTest")
+    {
+        using namespace SC;
+        if (test_section("contains"))
+        {
+            SortedVectorMap<int, int> map;
+            SC_TEST_EXPECT(map.insertIfNotExists({3, 4}));
+            SC_TEST_EXPECT(map.insertIfNotExists({1, 2}));
+            SC_TEST_EXPECT(map.insertIfNotExists({2, 3}));
+            SC_TEST_EXPECT(not map.insertIfNotExists({2, 5}));
+            const int* value;
+            SC_TEST_EXPECT(map.contains(1, value) && *value == 2);
+            SC_TEST_EXPECT(map.contains(2, value) && *value == 3);
+            SC_TEST_EXPECT(not map.contains(4));
+            SC_TEST_EXPECT(not map.contains(0));
+            SC_TEST_EXPECT(*map.insertOverwrite({2, 6}) == 6);
+            SC_TEST_EXPECT(*map.getOrCreate(0) == 0);
+            SC_TEST_EXPECT(map.size() == 4);
+            int expectedKey = 0;
+            for (const VectorMapItem<int, int>& item : map)
+            {
+                SC_TEST_EXPECT(item.key == expectedKey++);
+            }
+            SC_TEST_EXPECT(map.remove(2));
+            SC_TEST_EXPECT(not map.remove(2));
+            SC_TEST_EXPECT(map.size() == 3 and not map.contains(2) and map.contains(3));
+        }
+        if (test_section("bulk load"))
+        {
+            //! [sortedVectorMapSnippet]
+            SortedVectorMap<String, int> map;
+            // Append items in any order and sort them once
+            SC_TEST_EXPECT(map.items.push_back({"delta", 4}));
+            SC_TEST_EXPECT(map.items.push_back({"alpha", 1}));
+            SC_TEST_EXPECT(map.items.push_back({"charlie", 3}));
+            SC_TEST_EXPECT(map.items.push_back({"bravo", 2}));
+            SC_TEST_EXPECT(map.items.push_back({"alpha", 1}));
+            SC_TEST_EXPECT(map.sortItems());
+            SC_TEST_EXPECT(map.size() == 4);
+            SC_TEST_EXPECT(*map.get("charlie") == 3);
+
+            // Items with keys in ["b", "d")
+            Span<const VectorMapItem<String, int>> range = map.getRange("b", "d");
+            SC_TEST_EXPECT(range.sizeInElements() == 2);
+            SC_TEST_EXPECT(range[0].key == "bravo" and range[1].key == "charlie");
+            //! [sortedVectorMapSnippet]
+            SC_TEST_EXPECT(map.lowerBound("alpha") == 0 and map.upperBound("alpha") == 1);
+            SC_TEST_EXPECT(map.lowerBound("zulu") == 4 and map.upperBound("a") == 0);
+            SC_TEST_EXPECT(map.getRange("d", "b").empty());
+            for (VectorMapItem<String, int>& item : map.getRange("alpha", "charlie"))
+            {
+                item.value *= 10;
+            }
+            SC_TEST_EXPECT(*map.get("alpha") == 10 and *map.get("bravo") == 20 and *map.get("charlie") == 3);
+        }
+        if (test_section("array"))
+        {
+            SortedVectorMap<String, String, Array<VectorMapItem<String, String>, 2>> map;
+            SC_TEST_EXPECT(map.insertIfNotExists({"Ciao", "Fra"}));
+            SC_TEST_EXPECT(map.insertIfNotExists({"Bella", "Bro"}));
+            SC_TEST_EXPECT(not map.insertIfNotExists({"Fail", "Fail"}));
+            SC_TEST_EXPECT(map.items[0].key == "Bella");
+            const String* value;
+            SC_TEST_EXPECT(map.contains("Ciao", value) && *value == "Fra");
+            SC_TEST_EXPECT(map.contains("Bella", value) && *value == "Bro");
+        }
+        if (test_section("random"))
+        {
+            // Compares lookups against a VectorMap after many insertions and removals
+            SortedVectorMap<int, int> map;
+            VectorMap<int, int>       reference;
+            uint32_t                  random = 98765;
+            for (int iteration = 0; iteration < 5000; ++iteration)
+            {
+                random ^= random << 13;
+                random ^= random >> 17;
+                random ^= random << 5;
+                const int key = static_cast<int>(random % 500);
+                if (random & 0x10000)
+                {
+                    SC_TEST_EXPECT(*map.insertOverwrite({key, iteration}) == iteration);
+                    SC_TEST_EXPECT(reference.insertOverwrite({key, iteration}) != nullptr);
+                }
+                else
+                {
+                    SC_TEST_EXPECT(map.remove(key) == reference.remove(key));
+                }
+            }
+            SC_TEST_EXPECT(map.size() == reference.size());
+            for (int key = -1; key <= 500; ++key)
+            {
+                const int* value = map.get(key);
+                const int* other = reference.get(key);
+                SC_TEST_EXPECT((value == nullptr) == (other == nullptr));
+                SC_TEST_EXPECT(value == nullptr or *value == *other);
+            }
+            for (size_t idx = 1; idx < map.size(); ++idx)
+            {
+                SC_TEST_EXPECT(map.items[idx - 1].key < map.items[idx].key);
+            }
+        }
+    }
+};
+
+namespace SC
+{
+void runSortedVectorMapTest(SC::TestReport& report) { SortedVectorMapTest test(report); }
+} // namespace SC
@@ -0,0 +1,110 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../SortedVectorSet.h"
+#include "../../Containers/SmallVector.h"
+#include "../../Strings/String.h"
+#include "../../Testing/Testing.h"
+
+namespace SC
+{
+struct SortedVectorSetTest;
+}
+
+struct SC::SortedVectorSetTest : public SC::TestCase
+{
+    template <typename T>
+    inline void testPackedSearch(T offset);
+
+    SortedVectorSetTest(SC::TestReport& report) : TestCase(report, "SortedVectorSetTest")
+    {
+        using namespace SC;
+        if (test_section("simple"))
+        {
+            //! [sortedVectorSetSnippet]
+            SortedVectorSet<String> set;
+            SC_TEST_EXPECT(set.insert("456"));
+            SC_TEST_EXPECT(set.insert("123"));
+            SC_TEST_EXPECT(set.insert("123"));
+            SC_TEST_EXPECT(set.insert("789"));
+            SC_TEST_EXPECT(set.size() == 3);
+            SC_TEST_EXPECT(set.contains("123") and not set.contains("124"));
+            SC_TEST_EXPECT(set.remove("456"));
+            SC_TEST_EXPECT(not set.remove("456"));
+            // Values are iterated in sorted order
+            const char* expected[] = {"123", "789"};
+            size_t      idx        = 0;
+            for (const String& value : set)
+            {
+                SC_TEST_EXPECT(value == StringView::fromNullTerminated(expected[idx++], StringEncoding::Ascii));
+            }
+            //! [sortedVectorSetSnippet]
+        }
+        if (test_section("bulk load"))
+        {
+            SortedVectorSet<int, SmallVector<int, 16>> set;
+            const int values[] = {5, 3, 9, 3, 1, 5, 5, 7, 0, 9};
+            SC_TEST_EXPECT(set.items.append({values, sizeof(values) / sizeof(values[0])}));
+            SC_TEST_EXPECT(set.sortItems());
+            SC_TEST_EXPECT(set.size() == 6);
+            const int sorted[] = {0, 1, 3, 5, 7, 9};
+            for (size_t idx = 0; idx < set.size(); ++idx)
+            {
+                SC_TEST_EXPECT(set.items[idx] == sorted[idx]);
+            }
+            Span<const int> range = set.getRange(2, 7);
+            SC_TEST_EXPECT(range.sizeInElements() == 2 and range[0] == 3 and range[1] == 5);
+            SC_TEST_EXPECT(set.lowerBound(4) == 3 and set.upperBound(5) == 4 and set.upperBound(-1) == 0);
+        }
+        if (test_section("packed"))
+        {
+            testPackedSearch<int32_t>(-1000);
+            testPackedSearch<uint32_t>(0x7FFFFFC0u);
+            testPackedSearch<int64_t>(-(static_cast<int64_t>(1) << 40));
+            testPackedSearch<uint64_t>((static_cast<uint64_t>(1) << 63) - 64);
+        }
+        if (test_section("heap sort"))
+        {
+            int values[100];
+            for (int idx = 0; idx < 100; ++idx)
+            {
+                values[idx] = (idx * 37) % 100;
+            }
+            Algorithms::heapSort(values, values + 100);
+            bool sorted = true;
+            for (int idx = 0; idx < 100; ++idx)
+            {
+                sorted = sorted and values[idx] == idx;
+            }
+            SC_TEST_EXPECT(sorted);
+            Algorithms::heapSort(values, values + 100, [](int a, int b) { return a > b; });
+            SC_TEST_EXPECT(values[0] == 99 and values[99] == 0);
+        }
+    }
+};
+
+template <typename T>
+void SC::SortedVectorSetTest::testPackedSearch(T offset)
+{
+    // Odd values starting from offset (crossing the sign bit of unsigned types), at all sizes around the SIMD window,
+    // searching for all present and missing values
+    for (size_t numValues = 0; numValues < 3 * SortedVectorSearch::PackedWindowBytes / sizeof(T); ++numValues)
+    {
+        SortedVectorSet<T> set;
+        for (size_t idx = 0; idx < numValues; ++idx)
+        {
+            SC_TEST_EXPECT(set.items.push_back(static_cast<T>(offset + static_cast<T>(idx * 2 + 1))));
+        }
+        bool allFound = true;
+        for (size_t idx = 0; idx <= numValues * 2; ++idx)
+        {
+            const T value = static_cast<T>(offset + static_cast<T>(idx));
+            allFound      = allFound and set.lowerBound(value) == idx / 2 and set.contains(value) == (idx % 2 == 1);
+        }
+        SC_TEST_EXPECT(allFound);
+    }
+}
+
+namespace SC
+{
+void runSortedVectorSetTest(SC::TestReport& report) { SortedVectorSetTest test(report); }
+} // namespace SC
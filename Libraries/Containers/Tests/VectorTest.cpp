@@ -370,6 +370,22 @@ void SC::VectorTest::testClassType()
         }
     }
 
+    if (test_section("class_insert_element_middle"))
+    {
+        SC::Vector<VectorTestClass> vector;
+        SC_TEST_EXPECT(vector.push_back(VectorTestClass("0")));
+        SC_TEST_EXPECT(vector.push_back(VectorTestClass("2")));
+        SC_TEST_EXPECT(vector.insert(1, VectorTestClass("1")));
+        SC_TEST_EXPECT(vector.insert(3, VectorTestClass("3")));
+        SC_TEST_EXPECT(vector.size() == 4);
+        for (size_t idx = 0; idx < 4; ++idx)
+        {
+            int32_t value = 0;
+            SC_TEST_EXPECT(vector[idx].toString().parseInt32(value));
+            SC_TEST_EXPECT(value == static_cast<int32_t>(idx));
+        }
+    }
+
     if (test_section("class_appendMove"))
     {
         SC::Vector<VectorTestClass> vector1, vector2;
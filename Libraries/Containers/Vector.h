@@ -26,6 +26,36 @@ struct SC::VectorAllocator
 
     static void release(SegmentHeader* oldHeader);
 
+    // Segments allocated with SC::Memory are preceded by a SC::MemoryTagLink when SC_MEMORY_TAGGING is enabled,
+    // leaving all headers (including the ones inline in SC::SmallVector and SC::SmallString) unchanged
+    static SegmentHeader* allocateMemory(size_t numBytes);
+    static SegmentHeader* reallocateMemory(SegmentHeader* header, size_t numBytes);
+    static void           releaseMemory(SegmentHeader* header);
+
+#if SC_MEMORY_TAGGING
+    static constexpr size_t TagPrefix =
+        (sizeof(MemoryTagLink) + MemoryAllocator::Alignment - 1) & ~(MemoryAllocator::Alignment - 1);
+
+    static MemoryTagLink& getTagLink(SegmentHeader* header)
+    {
+        return *reinterpret_cast<MemoryTagLink*>(reinterpret_cast<char*>(header) - TagPrefix);
+    }
+
+    static size_t getTagUsedBytes(const MemoryTagLink& link, size_t& capacityBytes)
+    {
+        const char*          block  = reinterpret_cast<const char*>(&link);
+        const SegmentHeader* header = reinterpret_cast<const SegmentHeader*>(block + TagPrefix);
+        capacityBytes               = header->capacityBytes;
+        return header->sizeBytes;
+    }
+
+    static void track(SegmentHeader* header, MemoryTagSite* site, bool spilled)
+    {
+        getTagLink(header).track(site, TagPrefix + sizeof(SegmentHeader) + header->capacityBytes, &getTagUsedBytes,
+                                 spilled);
+    }
+#endif
+
     template <typename T>
     static T* getItems(SegmentHeader* header)
     {
@@ -68,6 +98,17 @@ struct SC::Vector
     /// @param list The initializer list that will be appended to this Vector
     Vector(std::initializer_list<T> list) : items(nullptr) { (void)append({list.begin(), list.size()}); }
 
+    /// @brief Constructs an empty Vector allocating its memory from the given allocator, instead of SC::Memory.
+    /// The allocator is stored in the allocated segment, so the Vector is still as large as a pointer.
+    /// For this reason a segment made only of its header (16 bytes) is immediately allocated, and it's kept even
+    /// when the Vector is emptied with Vector::shrink_to_fit. Such header costs a block of a SC::PoolAllocator and
+    /// it's reclaimed by SC::ArenaAllocator only on reset, so allocator-backed vectors should be created only when
+    /// they're going to be filled. Failing to allocate the header is a fatal error (it asserts in release too).
+    /// @param allocator The allocator (for example SC::ArenaAllocator), that must outlive the Vector
+    /// @note Copies of the Vector use SC::Memory, while move construction / assignment take the allocator along with
+    /// the memory of the moved Vector. A moved-from Vector is left empty and uses SC::Memory from then on.
+    explicit Vector(MemoryAllocator& allocator);
+
     /// @brief Destroys the Vector, releasing allocated memory
     ~Vector() { destroy(); }
 
@@ -176,7 +217,8 @@ struct SC::Vector
     /// @brief Sets size() to zero, without calling destructor on elements.
     void clearWithoutInitializing() { (void)resizeWithoutInitializing(0); }
 
-    /// @brief Reallocates the vector so that size() == capacity(). If Vector is empty, it deallocates its memory.
+    /// @brief Reallocates the vector so that size() == capacity(). If Vector is empty, it deallocates its memory
+    /// (keeping just the segment header if it has been constructed with a SC::MemoryAllocator).
     /// @return `true` if operation succeeded
     [[nodiscard]] bool shrink_to_fit() { return Operations::shrink_to_fit(items); }
 
@@ -192,6 +234,13 @@ struct SC::Vector
     /// @return capacity of the vector
     [[nodiscard]] size_t capacity() const;
 
+    /// @brief Gets the allocator used by the vector
+    /// @return The allocator passed to the constructor or `nullptr` if memory comes from SC::Memory (or inline storage)
+    [[nodiscard]] MemoryAllocator* getAllocator() const
+    {
+        return items == nullptr ? nullptr : getSegmentItems()->allocator;
+    }
+
     /// @brief Gets pointer to first element of the vector
     /// @return pointer to first element of the vector
     [[nodiscard]] T* begin() { return items; }
@@ -217,6 +266,12 @@ struct SC::Vector
     /// @return `true` if operation succeeded
     [[nodiscard]] bool insert(size_t idx, Span<const T> data);
 
+    /// @brief Inserts an item moving it at given index
+    /// @param idx Index where to insert the item
+    /// @param element The element to be moved at position idx
+    /// @return `true` if operation succeeded
+    [[nodiscard]] bool insert(size_t idx, T&& element) { return insertMove(idx, {&element, 1}); }
+
     /// @brief Appends a range of items copying them at the end of vector
     /// @param data the range of items to copy
     /// @return `true` if operation succeeded
@@ -296,23 +351,44 @@ inline SC::SegmentHeader* SC::VectorAllocator::reallocate(SegmentHeader* oldHead
     {
         return nullptr;
     }
+#if SC_MEMORY_TAGGING
+    // Reallocation can move the segment, so it must be unlinked from its site before (and linked again after)
+    const bool     spilled = oldHeader->isSmallVector;
+    const bool     tracked = not spilled and oldHeader->allocator == nullptr;
+    MemoryTagSite* tagSite = tracked ? getTagLink(oldHeader).untrack(true) : nullptr;
+#endif
     SegmentHeader* newHeader;
     if (oldHeader->isSmallVector)
     {
-        newHeader          = static_cast<SegmentHeader*>(Memory::allocate(sizeof(SegmentHeader) + newSize));
+        newHeader          = allocateMemory(sizeof(SegmentHeader) + newSize);
         const auto minSize = min(newSize, static_cast<decltype(newSize)>(oldHeader->sizeBytes));
-        ::memcpy(newHeader, oldHeader, minSize + alignof(SegmentHeader));
+        ::memcpy(newHeader, oldHeader, minSize + sizeof(SegmentHeader));
         newHeader->initDefaults();
         newHeader->isFollowedBySmallVector = true;
     }
+    else if (oldHeader->allocator != nullptr)
+    {
+        newHeader = static_cast<SegmentHeader*>(oldHeader->allocator->reallocate(
+            oldHeader, sizeof(SegmentHeader) + oldHeader->capacityBytes, sizeof(SegmentHeader) + newSize));
+    }
     else
     {
-        newHeader = static_cast<SegmentHeader*>(Memory::reallocate(oldHeader, sizeof(SegmentHeader) + newSize));
+        newHeader = reallocateMemory(oldHeader, sizeof(SegmentHeader) + newSize);
     }
     if (newHeader)
     {
         newHeader->capacityBytes = static_cast<SegmentHeader::SizeType>(newSize);
     }
+#if SC_MEMORY_TAGGING
+    if (newHeader != nullptr and newHeader->allocator == nullptr)
+    {
+        track(newHeader, tagSite, spilled);
+    }
+    else if (newHeader == nullptr and tagSite != nullptr)
+    {
+        track(oldHeader, tagSite, false); // Reallocation failed, so the old segment is still alive
+    }
+#endif
     return newHeader;
 }
 
@@ -343,15 +419,29 @@ inline SC::SegmentHeader* SC::VectorAllocator::allocate(SegmentHeader* oldHeader
             }
         }
     }
-    SegmentHeader* newHeader = static_cast<SegmentHeader*>(Memory::allocate(sizeof(SegmentHeader) + numNewBytes));
+    // New segments keep using the allocator of the segment they replace
+    MemoryAllocator* allocator = oldHeader != nullptr ? oldHeader->allocator : nullptr;
+    SegmentHeader*   newHeader =
+        allocator != nullptr ? static_cast<SegmentHeader*>(allocator->allocate(sizeof(SegmentHeader) + numNewBytes))
+                             : allocateMemory(sizeof(SegmentHeader) + numNewBytes);
     if (newHeader)
     {
         newHeader->capacityBytes = static_cast<SegmentHeader::SizeType>(numNewBytes);
         newHeader->initDefaults();
+        newHeader->allocator = allocator;
         if (oldHeader != nullptr && oldHeader->isSmallVector)
         {
             newHeader->isFollowedBySmallVector = true;
         }
+#if SC_MEMORY_TAGGING
+        if (allocator == nullptr)
+        {
+            // Segments replacing a heap one keep its site, so containers are attributed to where they've been created
+            const bool     spilled = oldHeader != nullptr and oldHeader->isSmallVector;
+            MemoryTagSite* site    = oldHeader != nullptr and not spilled ? getTagLink(oldHeader).site : nullptr;
+            track(newHeader, site, spilled);
+        }
+#endif
     }
     return newHeader;
 }
@@ -362,12 +452,48 @@ inline void SC::VectorAllocator::release(SegmentHeader* oldHeader)
     {
         oldHeader->sizeBytes = 0;
     }
+    else if (oldHeader->allocator != nullptr)
+    {
+        oldHeader->allocator->release(oldHeader, sizeof(SegmentHeader) + oldHeader->capacityBytes);
+    }
     else
     {
-        Memory::release(oldHeader);
+        releaseMemory(oldHeader);
     }
 }
 
+#if SC_MEMORY_TAGGING
+inline SC::SegmentHeader* SC::VectorAllocator::allocateMemory(size_t numBytes)
+{
+    char* block = static_cast<char*>(Memory::allocate(TagPrefix + numBytes));
+    return block == nullptr ? nullptr : reinterpret_cast<SegmentHeader*>(block + TagPrefix);
+}
+
+inline SC::SegmentHeader* SC::VectorAllocator::reallocateMemory(SegmentHeader* header, size_t numBytes)
+{
+    char* block = static_cast<char*>(Memory::reallocate(&getTagLink(header), TagPrefix + numBytes));
+    return block == nullptr ? nullptr : reinterpret_cast<SegmentHeader*>(block + TagPrefix);
+}
+
+inline void SC::VectorAllocator::releaseMemory(SegmentHeader* header)
+{
+    (void)getTagLink(header).untrack(false);
+    Memory::release(&getTagLink(header));
+}
+#else
+inline SC::SegmentHeader* SC::VectorAllocator::allocateMemory(size_t numBytes)
+{
+    return static_cast<SegmentHeader*>(Memory::allocate(numBytes));
+}
+
+inline SC::SegmentHeader* SC::VectorAllocator::reallocateMemory(SegmentHeader* header, size_t numBytes)
+{
+    return static_cast<SegmentHeader*>(Memory::reallocate(header, numBytes));
+}
+
+inline void SC::VectorAllocator::releaseMemory(SegmentHeader* header) { Memory::release(header); }
+#endif
+
 //-----------------------------------------------------------------------------------------------------------------------
 // Vector
 //-----------------------------------------------------------------------------------------------------------------------
@@ -384,6 +510,19 @@ SC::Vector<T>::Vector(const Vector& other) : items(nullptr)
     }
 }
 
+template <typename T>
+SC::Vector<T>::Vector(MemoryAllocator& allocator) : items(nullptr)
+{
+    // An empty segment holding the allocator, that will be used by all following allocations
+    SegmentHeader* header = static_cast<SegmentHeader*>(allocator.allocate(sizeof(SegmentHeader)));
+    SC_ASSERT_RELEASE(header != nullptr);
+    header->sizeBytes     = 0;
+    header->capacityBytes = 0;
+    header->initDefaults();
+    header->allocator = &allocator;
+    items             = VectorAllocator::getItems<T>(header);
+}
+
 template <typename T>
 SC::Vector<T>::Vector(Vector&& other) noexcept
 {
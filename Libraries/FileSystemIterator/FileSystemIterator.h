@@ -101,9 +101,9 @@ struct SC::FileSystemIterator
   private:
     struct InternalDefinition
     {
-        static constexpr int Windows = 4272;
-        static constexpr int Apple   = 2104;
-        static constexpr int Default = 2088;
+        static constexpr int Windows = 4288;
+        static constexpr int Apple   = 2120;
+        static constexpr int Default = 2104;
 
         static constexpr size_t Alignment = sizeof(uint64_t);
 
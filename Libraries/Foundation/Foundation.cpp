@@ -180,9 +180,353 @@ void SC::Assert::print(const char* expression, const char* filename, const char*
 //--------------------------------------------------------------------
 // Memory
 //--------------------------------------------------------------------
+#if SC_MEMORY_CACHING_ALLOCATOR
+#include "Internal/MemoryCachingAllocator.inl"
+
+void* SC::Memory::reallocate(void* memory, size_t numBytes)
+{
+    return MemoryCachingAllocator::reallocate(memory, numBytes);
+}
+void* SC::Memory::allocate(size_t numBytes) { return MemoryCachingAllocator::allocate(numBytes); }
+void  SC::Memory::release(void* allocatedMemory) { return MemoryCachingAllocator::release(allocatedMemory); }
+bool  SC::Memory::getStatistics(MemoryStatistics& statistics)
+{
+    return MemoryCachingAllocator::getStatistics(statistics);
+}
+#else
 void* SC::Memory::reallocate(void* memory, size_t numBytes) { return ::realloc(memory, numBytes); }
 void* SC::Memory::allocate(size_t numBytes) { return ::malloc(numBytes); }
 void  SC::Memory::release(void* allocatedMemory) { return ::free(allocatedMemory); }
+bool  SC::Memory::getStatistics(MemoryStatistics&) { return false; }
+#endif
+
+#if SC_MEMORY_TAGGING
+#include "Internal/MemoryTagging.inl"
+#else
+bool SC::Memory::getTagStatistics(Span<MemoryTagStatistics>, size_t& numStatistics, bool)
+{
+    numStatistics = 0;
+    return false;
+}
+#endif
+
+//--------------------------------------------------------------------
+// MemoryAllocator
+//--------------------------------------------------------------------
+namespace SC
+{
+static constexpr size_t memoryAllocatorAlign(size_t numBytes)
+{
+    return (numBytes + MemoryAllocator::Alignment - 1) & ~(MemoryAllocator::Alignment - 1);
+}
+} // namespace SC
+
+struct SC::ArenaAllocator::Chunk
+{
+    Chunk* next;
+    size_t capacity;
+
+    static constexpr size_t HeaderSize = memoryAllocatorAlign(sizeof(Chunk*) + sizeof(size_t));
+
+    char* getData() { return reinterpret_cast<char*>(this) + HeaderSize; }
+};
+
+SC::ArenaAllocator::ArenaAllocator(size_t chunkSize)
+    : MemoryAllocator(&ArenaAllocator::allocatorFunction), chunkSize(memoryAllocatorAlign(chunkSize))
+{}
+
+SC::ArenaAllocator::~ArenaAllocator()
+{
+    while (firstChunk != nullptr)
+    {
+        Chunk* next = firstChunk->next;
+        Memory::release(firstChunk);
+        firstChunk = next;
+    }
+}
+
+void SC::ArenaAllocator::reset()
+{
+    currentChunk  = firstChunk;
+    offset        = 0;
+    lastAllocated = ~static_cast<size_t>(0);
+    bytesUsed     = 0;
+}
+
+void SC::ArenaAllocator::setChunkSize(size_t newChunkSize) { chunkSize = memoryAllocatorAlign(newChunkSize); }
+
+bool SC::ArenaAllocator::reserve(size_t numBytes)
+{
+    if (firstChunk == nullptr)
+    {
+        if (allocateBlock(numBytes) == nullptr)
+        {
+            return false;
+        }
+        reset();
+    }
+    return true;
+}
+
+void* SC::ArenaAllocator::allocateBlock(size_t numBytes)
+{
+    const size_t alignedBytes = memoryAllocatorAlign(numBytes);
+    if (currentChunk == nullptr or offset + alignedBytes > currentChunk->capacity)
+    {
+        // Reuse the following chunk (kept by a previous reset) if it's large enough, or insert a new one before it
+        Chunk* next = currentChunk != nullptr ? currentChunk->next : firstChunk;
+        if (next == nullptr or next->capacity < alignedBytes)
+        {
+            const size_t capacity = alignedBytes > chunkSize ? alignedBytes : chunkSize;
+            Chunk*       chunk    = static_cast<Chunk*>(Memory::allocate(Chunk::HeaderSize + capacity));
+            if (chunk == nullptr)
+            {
+                return nullptr;
+            }
+            chunk->next     = next;
+            chunk->capacity = capacity;
+            if (currentChunk != nullptr)
+            {
+                currentChunk->next = chunk;
+            }
+            else
+            {
+                firstChunk = chunk;
+            }
+            next = chunk;
+        }
+        currentChunk = next;
+        offset       = 0;
+    }
+    lastAllocated = offset;
+    offset += alignedBytes;
+    bytesUsed += alignedBytes;
+    return currentChunk->getData() + lastAllocated;
+}
+
+bool SC::ArenaAllocator::resizeLastBlock(void* memory, size_t newNumBytes)
+{
+    if (currentChunk == nullptr or memory != currentChunk->getData() + lastAllocated)
+    {
+        return false;
+    }
+    const size_t newOffset = lastAllocated + memoryAllocatorAlign(newNumBytes);
+    if (newOffset > currentChunk->capacity)
+    {
+        return false;
+    }
+    bytesUsed = bytesUsed + newOffset - offset;
+    offset    = newOffset;
+    return true;
+}
+
+void* SC::ArenaAllocator::allocatorFunction(MemoryAllocator& allocator, Operation operation, void* memory,
+                                            size_t oldNumBytes, size_t newNumBytes)
+{
+    ArenaAllocator& self = static_cast<ArenaAllocator&>(allocator);
+    switch (operation)
+    {
+    case Operation::Allocate: return self.allocateBlock(newNumBytes);
+    case Operation::Reallocate: {
+        if (self.resizeLastBlock(memory, newNumBytes))
+        {
+            return memory;
+        }
+        void* newMemory = self.allocateBlock(newNumBytes);
+        if (newMemory != nullptr)
+        {
+            ::memcpy(newMemory, memory, oldNumBytes < newNumBytes ? oldNumBytes : newNumBytes);
+        }
+        return newMemory;
+    }
+    case Operation::Release: break; // Memory is reclaimed only by reset
+    }
+    return nullptr;
+}
+
+struct SC::ScratchAllocator::BlockHeader
+{
+    size_t previousBlock; // Offset of the header of the block allocated before this one (or NoBlock)
+    size_t released;      // Block has been released out of order and it will be reclaimed later
+
+    static constexpr size_t HeaderSize = memoryAllocatorAlign(sizeof(size_t) * 2);
+};
+
+SC::ScratchAllocator::ScratchAllocator(Span<char> memory) : MemoryAllocator(&ScratchAllocator::allocatorFunction)
+{
+    // Align the start of the buffer, so that all blocks will be aligned
+    const size_t address  = reinterpret_cast<size_t>(memory.data());
+    const size_t padding  = memoryAllocatorAlign(address) - address;
+    const bool   isUsable = memory.data() != nullptr and memory.sizeInBytes() > padding;
+    buffer                = isUsable ? memory.data() + padding : nullptr;
+    capacity              = isUsable ? memory.sizeInBytes() - padding : 0;
+}
+
+bool SC::ScratchAllocator::owns(const void* memory) const
+{
+    return buffer != nullptr and memory >= buffer and memory < buffer + capacity;
+}
+
+void* SC::ScratchAllocator::allocateBlock(size_t numBytes)
+{
+    const size_t blockSize = BlockHeader::HeaderSize + memoryAllocatorAlign(numBytes);
+    if (top + blockSize > capacity)
+    {
+        return Memory::allocate(numBytes); // Buffer is full
+    }
+    BlockHeader* header   = reinterpret_cast<BlockHeader*>(buffer + top);
+    header->previousBlock = lastBlock;
+    header->released      = 0;
+    lastBlock             = top;
+    top += blockSize;
+    return buffer + lastBlock + BlockHeader::HeaderSize;
+}
+
+void SC::ScratchAllocator::releaseBlock(void* memory)
+{
+    if (not owns(memory))
+    {
+        Memory::release(memory);
+        return;
+    }
+    const size_t headerOffset = static_cast<size_t>(static_cast<char*>(memory) - buffer) - BlockHeader::HeaderSize;
+    BlockHeader* header       = reinterpret_cast<BlockHeader*>(buffer + headerOffset);
+    if (headerOffset != lastBlock)
+    {
+        header->released = 1;
+        return;
+    }
+    // Pop this block and all blocks before it that have already been released
+    top       = headerOffset;
+    lastBlock = header->previousBlock;
+    while (lastBlock != NoBlock)
+    {
+        BlockHeader* previous = reinterpret_cast<BlockHeader*>(buffer + lastBlock);
+        if (previous->released == 0)
+        {
+            break;
+        }
+        top       = lastBlock;
+        lastBlock = previous->previousBlock;
+    }
+}
+
+void* SC::ScratchAllocator::allocatorFunction(MemoryAllocator& allocator, Operation operation, void* memory,
+                                              size_t oldNumBytes, size_t newNumBytes)
+{
+    ScratchAllocator& self = static_cast<ScratchAllocator&>(allocator);
+    switch (operation)
+    {
+    case Operation::Allocate: return self.allocateBlock(newNumBytes);
+    case Operation::Reallocate: {
+        if (not self.owns(memory))
+        {
+            return Memory::reallocate(memory, newNumBytes);
+        }
+        const size_t headerOffset =
+            static_cast<size_t>(static_cast<char*>(memory) - self.buffer) - BlockHeader::HeaderSize;
+        const size_t newTop = headerOffset + BlockHeader::HeaderSize + memoryAllocatorAlign(newNumBytes);
+        if (headerOffset == self.lastBlock and newTop <= self.capacity)
+        {
+            self.top = newTop; // Grow or shrink the last block in place
+            return memory;
+        }
+        void* newMemory = self.allocateBlock(newNumBytes);
+        if (newMemory != nullptr)
+        {
+            ::memcpy(newMemory, memory, oldNumBytes < newNumBytes ? oldNumBytes : newNumBytes);
+            self.releaseBlock(memory);
+        }
+        return newMemory;
+    }
+    case Operation::Release:
+        if (memory != nullptr)
+        {
+            self.releaseBlock(memory);
+        }
+        break;
+    }
+    return nullptr;
+}
+
+struct SC::PoolAllocator::Chunk
+{
+    Chunk* next;
+
+    static constexpr size_t HeaderSize = memoryAllocatorAlign(sizeof(Chunk*));
+};
+
+struct SC::PoolAllocator::FreeBlock
+{
+    FreeBlock* next;
+};
+
+SC::PoolAllocator::PoolAllocator(size_t blockSize, size_t blocksPerChunk)
+    : MemoryAllocator(&PoolAllocator::allocatorFunction),
+      blockSize(memoryAllocatorAlign(blockSize > 0 ? blockSize : 1)),
+      blocksPerChunk(blocksPerChunk > 0 ? blocksPerChunk : 1)
+{}
+
+SC::PoolAllocator::~PoolAllocator()
+{
+    while (chunks != nullptr)
+    {
+        Chunk* next = chunks->next;
+        Memory::release(chunks);
+        chunks = next;
+    }
+}
+
+void* SC::PoolAllocator::allocateBlock(size_t numBytes)
+{
+    if (numBytes > blockSize)
+    {
+        return nullptr;
+    }
+    if (freeBlocks == nullptr)
+    {
+        Chunk* chunk = static_cast<Chunk*>(Memory::allocate(Chunk::HeaderSize + blockSize * blocksPerChunk));
+        if (chunk == nullptr)
+        {
+            return nullptr;
+        }
+        chunk->next = chunks;
+        chunks      = chunk;
+        // Link blocks in reverse order, so that they're handed out in address order
+        char* blocks = reinterpret_cast<char*>(chunk) + Chunk::HeaderSize;
+        for (size_t idx = blocksPerChunk; idx > 0; --idx)
+        {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(blocks + (idx - 1) * blockSize);
+            block->next      = freeBlocks;
+            freeBlocks       = block;
+        }
+    }
+    FreeBlock* block = freeBlocks;
+    freeBlocks       = block->next;
+    numBlocksInUse++;
+    return block;
+}
+
+void* SC::PoolAllocator::allocatorFunction(MemoryAllocator& allocator, Operation operation, void* memory, size_t,
+                                           size_t newNumBytes)
+{
+    PoolAllocator& self = static_cast<PoolAllocator&>(allocator);
+    switch (operation)
+    {
+    case Operation::Allocate: return self.allocateBlock(newNumBytes);
+    case Operation::Reallocate: return newNumBytes <= self.blockSize ? memory : nullptr;
+    case Operation::Release:
+        if (memory != nullptr)
+        {
+            FreeBlock* block = static_cast<FreeBlock*>(memory);
+            block->next      = self.freeBlocks;
+            self.freeBlocks  = block;
+            self.numBlocksInUse--;
+        }
+        break;
+    }
+    return nullptr;
+}
 
 //--------------------------------------------------------------------
 // Standard C++ Library support
@@ -1,6 +1,8 @@
 // Copyright (c) Stefano Cristiano
 // SPDX-License-Identifier: MIT
 #pragma once
+#include "../Foundation/Assert.h"
+#include "../Foundation/Memory.h"     // FunctionN heap fallback
 #include "../Foundation/TypeTraits.h" // RemoveReference, AddPointer, IsSame
 
 namespace SC
@@ -8,7 +10,14 @@ namespace SC
 //! @addtogroup group_foundation_utility
 //! @{
 
-/// @brief Wraps function pointers, member functions and lambdas without ever allocating. @n
+/// @brief Wraps function pointers, member functions and lambdas, storing lambdas in InlineBytes of inline storage. @n
+///
+/// SC::Function is a FunctionN with an inline storage of `2 * sizeof(void*)`, never allocating memory. @n
+/// Lambdas capturing more state can be stored in a FunctionN with bigger InlineBytes, chosen at compile time.
+/// Setting AllowHeap to `true` stores lambdas that don't fit InlineBytes in memory allocated from SC::Memory instead
+/// of issuing a static assertion. @n
+/// Lambdas that are trivially copyable (for example lambdas capturing just pointers, references or integers) are
+/// copied and moved with a plain copy of the inline storage, without calling through the type erased operation.
 ///
 /// Example:
 /**
@@ -36,21 +45,31 @@ namespace SC
 
     BigClass bigClass;
 
-    // This will static_assert because sizeof(BigClass) (grabbed by copy) exceeds LAMBDA_SIZE
+    // This will static_assert because sizeof(BigClass) (grabbed by copy) exceeds inline storage of Function
     // func = [bigClass](float a) -> int { return static_cast<int>(a);};
 
+    // This is fine, as BigClass fits in the 32 bytes of inline storage
+    FunctionN<int(float), 32> bigFunc = [bigClass](float a) -> int { return static_cast<int>(a);};
+
+    // Lambdas that don't fit inline storage are allocated with SC::Memory
+    FunctionN<int(float), 16, true> heapFunc = [bigClass](float a) -> int { return static_cast<int>(a);};
     @endcode
 
-    Size of lambdas or less than LAMBDA_SIZE (currently `2 * sizeof(void*)`). @n
-    If lambda is bigger than `LAMBDA_SIZE` the constructor will static assert.
     @tparam FuncType Type of function to be wrapped (Lambda, free function or pointer to member function)
-
+    @tparam InlineBytes Size of the storage for lambdas inside the FunctionN
+    @tparam AllowHeap If `true` lambdas bigger than InlineBytes are allocated with SC::Memory (instead of static
+    asserting)
  * */
+template <typename FuncType, size_t InlineBytes = sizeof(void*) * 2, bool AllowHeap = false>
+struct FunctionN;
+
+/// @brief Wraps function pointers, member functions and lambdas without ever allocating (see SC::FunctionN). @n
+/// Size of lambdas must be less or equal than `2 * sizeof(void*)`, or the constructor will static assert.
 template <typename FuncType>
-struct Function;
+using Function = FunctionN<FuncType>;
 
-template <typename R, typename... Args>
-struct Function<R(Args...)>
+template <typename R, typename... Args, size_t InlineBytes, bool AllowHeap>
+struct FunctionN<R(Args...), InlineBytes, AllowHeap>
 {
   private:
     enum class FunctionErasedOperation
@@ -62,47 +81,51 @@ struct Function<R(Args...)>
     using StubFunction      = R (*)(const void* const*, typename TypeTraits::AddPointer<Args>::type...);
     using OperationFunction = void (*)(FunctionErasedOperation operation, const void** other, const void* const*);
 
-    static const int LAMBDA_SIZE = sizeof(void*) * 2;
+    static_assert(InlineBytes >= sizeof(void*), "FunctionN needs at least sizeof(void*) InlineBytes");
 
     StubFunction      functionStub;
-    OperationFunction functionOperation;
+    OperationFunction functionOperation; // nullptr when storage can be just copied (and doesn't need destruction)
 
-    union
+    union Storage
     {
         const void* classInstance;
-        char        lambdaMemory[LAMBDA_SIZE] = {0};
-    };
+        char        lambdaMemory[InlineBytes];
+    } storage = {nullptr};
 
     void executeOperation(FunctionErasedOperation operation, const void** other) const
     {
         if (functionOperation)
-            (*functionOperation)(operation, other, &classInstance);
+            (*functionOperation)(operation, other, &storage.classInstance);
     }
 
-    Function(const void* instance, StubFunction stub, OperationFunction operation)
-        : functionStub(stub), functionOperation(operation)
+    FunctionN(const void* instance, StubFunction stub) : functionStub(stub), functionOperation(nullptr)
     {
-        classInstance = instance;
+        storage.classInstance = instance;
     }
-    using FreeFunction = R (*)(Args...);
+
+    template <typename Lambda>
+    struct IsStoredInline
+    {
+        static constexpr bool value = sizeof(Lambda) <= InlineBytes and alignof(Lambda) <= alignof(Storage);
+    };
 
   public:
     /// @brief Constructs an empty Function
-    Function()
+    FunctionN()
     {
-        static_assert(sizeof(Function) == sizeof(void*) * 4, "Function Size");
+        static_assert(sizeof(FunctionN) == sizeof(void*) * 2 + sizeof(Storage), "Function Size");
         functionStub      = nullptr;
         functionOperation = nullptr;
     }
 
-    /// Constructs a function from a lambda with a compatible size (equal or less than LAMBDA_SIZE)
-    /// If lambda is bigger than `LAMBDA_SIZE` a static assertion will be issued
+    /// Constructs a function from a lambda with a compatible size (equal or less than InlineBytes)
+    /// If lambda is bigger than `InlineBytes` a static assertion will be issued (unless AllowHeap is `true`)
     /// SFINAE is used to avoid universal reference from "eating" also copy constructor
     template <
         typename Lambda,
         typename = typename TypeTraits::EnableIf<
-            not TypeTraits::IsSame<typename TypeTraits::RemoveReference<Lambda>::type, Function>::value, void>::type>
-    Function(Lambda&& lambda)
+            not TypeTraits::IsSame<typename TypeTraits::RemoveReference<Lambda>::type, FunctionN>::value, void>::type>
+    FunctionN(Lambda&& lambda)
     {
         functionStub      = nullptr;
         functionOperation = nullptr;
@@ -110,16 +133,16 @@ struct Function<R(Args...)>
     }
 
     /// @brief Destroys the function wrapper
-    ~Function() { executeOperation(FunctionErasedOperation::Destruct, nullptr); }
+    ~FunctionN() { executeOperation(FunctionErasedOperation::Destruct, nullptr); }
 
     /// @brief Move constructor for Function wrapper
     /// @param other The moved from function
-    Function(Function&& other)
+    FunctionN(FunctionN&& other)
     {
         functionStub      = other.functionStub;
         functionOperation = other.functionOperation;
-        classInstance     = other.classInstance;
-        other.executeOperation(FunctionErasedOperation::MoveConstruct, &classInstance);
+        storage           = other.storage;
+        other.executeOperation(FunctionErasedOperation::MoveConstruct, &storage.classInstance);
         other.executeOperation(FunctionErasedOperation::Destruct, nullptr);
         other.functionStub      = nullptr;
         other.functionOperation = nullptr;
@@ -127,34 +150,42 @@ struct Function<R(Args...)>
 
     /// @brief Copy constructor for Function wrapper
     /// @param other The function to be copied
-    Function(const Function& other)
+    FunctionN(const FunctionN& other)
     {
         functionStub      = other.functionStub;
         functionOperation = other.functionOperation;
-        other.executeOperation(FunctionErasedOperation::CopyConstruct, &classInstance);
+        storage           = other.storage;
+        other.executeOperation(FunctionErasedOperation::CopyConstruct, &storage.classInstance);
     }
 
     /// @brief Copy assign a function to current function wrapper. Destroys existing wrapper.
     /// @param other The function to be assigned to current function
-    Function& operator=(const Function& other)
+    FunctionN& operator=(const FunctionN& other)
     {
+        if (this == &other)
+            return *this;
         executeOperation(FunctionErasedOperation::Destruct, nullptr);
         functionStub      = other.functionStub;
         functionOperation = other.functionOperation;
-        other.executeOperation(FunctionErasedOperation::CopyConstruct, &classInstance);
+        storage           = other.storage;
+        other.executeOperation(FunctionErasedOperation::CopyConstruct, &storage.classInstance);
         return *this;
     }
 
     /// @brief Move assign a function to current function wrapper. Destroys existing wrapper.
     /// @param other The function to be move-assigned to current function
-    Function& operator=(Function&& other) noexcept
+    FunctionN& operator=(FunctionN&& other) noexcept
     {
+        if (this == &other)
+            return *this;
         executeOperation(FunctionErasedOperation::Destruct, nullptr);
         functionStub      = other.functionStub;
         functionOperation = other.functionOperation;
-        other.executeOperation(FunctionErasedOperation::MoveConstruct, &classInstance);
+        storage           = other.storage;
+        other.executeOperation(FunctionErasedOperation::MoveConstruct, &storage.classInstance);
         other.executeOperation(FunctionErasedOperation::Destruct, nullptr);
-        other.functionStub = nullptr;
+        other.functionStub      = nullptr;
+        other.functionOperation = nullptr;
         return *this;
     }
 
@@ -171,30 +202,7 @@ struct Function<R(Args...)>
         executeOperation(FunctionErasedOperation::Destruct, nullptr);
         functionStub      = nullptr;
         functionOperation = nullptr;
-
-        new (&classInstance, PlacementNew()) Lambda(forward<Lambda>(lambda));
-        static_assert(sizeof(Lambda) <= sizeof(lambdaMemory), "Lambda is too big");
-        functionStub = [](const void* const* p, typename TypeTraits::AddPointer<Args>::type... args) -> R
-        {
-            Lambda& lambda = *reinterpret_cast<Lambda*>(const_cast<void**>(p));
-            return lambda(*args...);
-        };
-        functionOperation = [](FunctionErasedOperation operation, const void** other, const void* const* p)
-        {
-            Lambda& lambda = *reinterpret_cast<Lambda*>(const_cast<void**>(p));
-            if (operation == FunctionErasedOperation::Destruct)
-                lambda.~Lambda();
-            else if (operation == FunctionErasedOperation::CopyConstruct)
-                new (other, PlacementNew()) Lambda(lambda);
-            else if (operation == FunctionErasedOperation::MoveConstruct)
-                new (other, PlacementNew()) Lambda(move(lambda));
-            else
-#if SC_COMPILER_MSVC
-                __assume(false);
-#else
-                __builtin_unreachable();
-#endif
-        };
+        bindLambda<typename TypeTraits::RemoveReference<Lambda>::type>(forward<Lambda>(lambda));
     }
 
     /// @brief Binds a free function to function wrapper
@@ -203,9 +211,9 @@ struct Function<R(Args...)>
     void bind()
     {
         executeOperation(FunctionErasedOperation::Destruct, nullptr);
-        classInstance     = nullptr;
-        functionStub      = &FunctionWrapper<FreeFunction>;
-        functionOperation = &FunctionOperation;
+        storage.classInstance = nullptr;
+        functionStub          = &FunctionWrapper<FreeFunction>;
+        functionOperation     = nullptr;
     }
 
     /// @brief Binds a class member function to function wrapper
@@ -216,9 +224,9 @@ struct Function<R(Args...)>
     void bind(const Class& c)
     {
         executeOperation(FunctionErasedOperation::Destruct, nullptr);
-        classInstance     = &c;
-        functionStub      = &MemberWrapper<Class, MemberFunction>;
-        functionOperation = &MemberOperation;
+        storage.classInstance = &c;
+        functionStub          = &MemberWrapper<Class, MemberFunction>;
+        functionOperation     = nullptr;
     }
 
     /// @brief Binds a class member function to function wrapper
@@ -229,9 +237,9 @@ struct Function<R(Args...)>
     void bind(Class& c)
     {
         executeOperation(FunctionErasedOperation::Destruct, nullptr);
-        classInstance     = &c;
-        functionStub      = &MemberWrapper<Class, MemberFunction>;
-        functionOperation = &MemberOperation;
+        storage.classInstance = &c;
+        functionStub          = &MemberWrapper<Class, MemberFunction>;
+        functionOperation     = nullptr;
     }
 
     /// @brief Binds a class member function to function wrapper
@@ -240,9 +248,9 @@ struct Function<R(Args...)>
     /// @param c Reference to the instance of class where the method must be bound to
     /// @return The function wrapper
     template <typename Class, R (Class::*MemberFunction)(Args...)>
-    static Function fromMember(Class& c)
+    static FunctionN fromMember(Class& c)
     {
-        return Function(&c, &MemberWrapper<Class, MemberFunction>, &MemberOperation);
+        return FunctionN(&c, &MemberWrapper<Class, MemberFunction>);
     }
 
     /// @brief Binds a class member function to function wrapper
@@ -251,21 +259,84 @@ struct Function<R(Args...)>
     /// @param c Reference to the instance of class where the method must be bound to
     /// @return The function wrapper
     template <typename Class, R (Class::*MemberFunction)(Args...) const>
-    static Function fromMember(const Class& c)
+    static FunctionN fromMember(const Class& c)
     {
-        return Function(&c, &MemberWrapper<Class, MemberFunction>, &MemberOperation);
+        return FunctionN(&c, &MemberWrapper<Class, MemberFunction>);
     }
 
     /// @brief Invokes the wrapped function. If no function is bound, this is UB.
     /// @param args Arguments to be passed to the wrapped function
     /// @return the return value of the invoked function.
-    [[nodiscard]] R operator()(Args... args) const { return (*functionStub)(&classInstance, &args...); }
+    [[nodiscard]] R operator()(Args... args) const { return (*functionStub)(&storage.classInstance, &args...); }
 
   private:
-    static void MemberOperation(FunctionErasedOperation operation, const void** other, const void* const* p)
+    // Lambda is constructed inside the inline storage
+    template <typename Lambda, typename Source>
+    typename TypeTraits::EnableIf<IsStoredInline<Lambda>::value>::type bindLambda(Source&& source)
     {
-        if (operation == FunctionErasedOperation::CopyConstruct or operation == FunctionErasedOperation::MoveConstruct)
-            *other = *p;
+        new (&storage.classInstance, PlacementNew()) Lambda(forward<Source>(source));
+        functionStub = [](const void* const* p, typename TypeTraits::AddPointer<Args>::type... args) -> R
+        {
+            Lambda& lambda = *reinterpret_cast<Lambda*>(const_cast<void**>(p));
+            return lambda(*args...);
+        };
+        if (TypeTraits::IsTriviallyCopyable<Lambda>::value)
+            return; // Copying storage is enough
+        functionOperation = [](FunctionErasedOperation operation, const void** other, const void* const* p)
+        {
+            Lambda& lambda = *reinterpret_cast<Lambda*>(const_cast<void**>(p));
+            if (operation == FunctionErasedOperation::Destruct)
+                lambda.~Lambda();
+            else if (operation == FunctionErasedOperation::CopyConstruct)
+                new (other, PlacementNew()) Lambda(lambda);
+            else if (operation == FunctionErasedOperation::MoveConstruct)
+                new (other, PlacementNew()) Lambda(move(lambda));
+            else
+#if SC_COMPILER_MSVC
+                __assume(false);
+#else
+                __builtin_unreachable();
+#endif
+        };
+    }
+
+    // Lambda is allocated with SC::Memory and the inline storage holds a pointer to it
+    template <typename Lambda, typename Source>
+    typename TypeTraits::EnableIf<not IsStoredInline<Lambda>::value>::type bindLambda(Source&& source)
+    {
+        static_assert(AllowHeap, "Lambda is too big (increase InlineBytes or set AllowHeap of FunctionN)");
+        void* memory = Memory::allocate(sizeof(Lambda));
+        SC_ASSERT_RELEASE(memory != nullptr);
+        storage.classInstance = new (memory, PlacementNew()) Lambda(forward<Source>(source));
+        functionStub = [](const void* const* p, typename TypeTraits::AddPointer<Args>::type... args) -> R
+        {
+            Lambda& lambda = *static_cast<Lambda*>(const_cast<void*>(*p));
+            return lambda(*args...);
+        };
+        functionOperation = [](FunctionErasedOperation operation, const void** other, const void* const* p)
+        {
+            Lambda* lambda = static_cast<Lambda*>(const_cast<void*>(*p));
+            if (operation == FunctionErasedOperation::Destruct)
+            {
+                if (lambda != nullptr)
+                {
+                    lambda->~Lambda();
+                    Memory::release(lambda);
+                }
+            }
+            else if (operation == FunctionErasedOperation::CopyConstruct)
+            {
+                void* memory = Memory::allocate(sizeof(Lambda));
+                SC_ASSERT_RELEASE(memory != nullptr);
+                *other = new (memory, PlacementNew()) Lambda(*lambda);
+            }
+            else if (operation == FunctionErasedOperation::MoveConstruct)
+            {
+                // Ownership of the allocation passes to other, so that Destruct of the moved from one is a no-op
+                *other                         = lambda;
+                *const_cast<const void**>(p) = nullptr;
+            }
+        };
     }
 
     template <typename Class, R (Class::*MemberFunction)(Args...)>
@@ -288,7 +359,69 @@ struct Function<R(Args...)>
         SC_COMPILER_UNUSED(p);
         return FreeFunction(*args...);
     }
-    static void FunctionOperation(FunctionErasedOperation, const void**, const void* const*) {}
+};
+
+/// @brief A non-owning reference to a function pointer, lambda or any other callable, meant for call-only parameters.
+///
+/// FunctionRef is just two pointers and it never allocates or copies the referenced callable, so it's cheaper to pass
+/// than SC::Function, and it accepts lambdas of any size. @n
+/// The referenced callable must outlive the FunctionRef, so it should not be stored (use SC::Function for that).
+/// Example:
+/**
+ * @code{.cpp}
+    int sumOf(Span<const int> values, FunctionRef<int(int)> transform)
+    {
+        int sum = 0;
+        for (int value : values)
+            sum += transform(value);
+        return sum;
+    }
+    // ... somewhere later
+    int offset = 2;
+    int sum = sumOf({1, 2, 3}, [&](int value) { return value + offset; }); // sum == 12
+    @endcode
+ * */
+template <typename FuncType>
+struct FunctionRef;
+
+template <typename R, typename... Args>
+struct FunctionRef<R(Args...)>
+{
+    /// @brief Refers to a callable object (for example a lambda), that must outlive this FunctionRef
+    template <typename Callable,
+              typename = typename TypeTraits::EnableIf<not TypeTraits::IsSame<
+                  typename TypeTraits::RemoveConst<typename TypeTraits::RemoveReference<Callable>::type>::type,
+                  FunctionRef>::value>::type>
+    FunctionRef(Callable&& callable)
+    {
+        using CallableType = typename TypeTraits::RemoveReference<Callable>::type;
+
+        target.object = const_cast<void*>(static_cast<const void*>(&callable));
+        functionStub  = [](Target target, typename TypeTraits::AddPointer<Args>::type... args) -> R
+        { return (*static_cast<CallableType*>(target.object))(*args...); };
+    }
+
+    /// @brief Refers to a free function
+    FunctionRef(R (*function)(Args...))
+    {
+        target.function = function;
+        functionStub    = [](Target target, typename TypeTraits::AddPointer<Args>::type... args) -> R
+        { return target.function(*args...); };
+    }
+
+    /// @brief Invokes the referenced callable
+    R operator()(Args... args) const { return functionStub(target, &args...); }
+
+  private:
+    union Target
+    {
+        void* object;
+        R (*function)(Args...);
+    };
+    using StubFunction = R (*)(Target, typename TypeTraits::AddPointer<Args>::type...);
+
+    StubFunction functionStub;
+    Target       target;
 };
 
 template <typename T>
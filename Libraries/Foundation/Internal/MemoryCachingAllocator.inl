@@ -0,0 +1,779 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+// Included by Foundation.cpp when SC_MEMORY_CACHING_ALLOCATOR == 1 (after Windows.h on Windows)
+#if !SC_PLATFORM_WINDOWS
+#include <pthread.h> // pthread_key_create
+#include <sched.h>   // sched_yield
+#if !SC_PLATFORM_EMSCRIPTEN
+#include <sys/mman.h> // mmap
+#endif
+#endif
+
+namespace SC
+{
+struct MemoryCachingAllocator;
+}
+
+// All of its state is zero initialized, as memory can be allocated before (or after) running static constructors
+struct SC::MemoryCachingAllocator
+{
+    static constexpr size_t   SpanSize       = 64 * 1024; // Unit obtained from the OS, aligned to its size
+    static constexpr size_t   SpanHeaderSize = 64;        // Blocks (or large allocations) start after it
+    static constexpr size_t   MaxSmallSize   = 8192;      // Size of the largest size class
+    static constexpr uint32_t NumSizeClasses = static_cast<uint32_t>(MemoryStatistics::NumSizeClasses);
+    static constexpr uint32_t LargeClass     = 0xffffffff;
+    static constexpr uint32_t SpanMagic      = 0x5ca1ab1e;
+    static constexpr size_t   BatchBytes     = 16 * 1024; // Bytes moved between thread caches and central lists
+    static constexpr size_t   MaxCachedSpans = 16;        // Largest (in spans) released large allocation kept
+    static constexpr size_t   MaxCachedBytes = 16 * 1024 * 1024; // Total bytes of released large allocations kept
+
+    //--------------------------------------------------------------------
+    // Atomics (Foundation can't depend on Threading)
+    //--------------------------------------------------------------------
+#if SC_PLATFORM_WINDOWS
+    static uint64_t load(const uint64_t& value) { return *reinterpret_cast<const volatile uint64_t*>(&value); }
+    static int64_t  load(const int64_t& value) { return *reinterpret_cast<const volatile int64_t*>(&value); }
+
+    static void store(uint64_t& value, uint64_t newValue) { *reinterpret_cast<volatile uint64_t*>(&value) = newValue; }
+
+    static int64_t fetchAdd(int64_t& value, int64_t delta)
+    {
+        return ::InterlockedExchangeAdd64(reinterpret_cast<volatile LONG64*>(&value), delta);
+    }
+
+    static bool compareExchange(int64_t& value, int64_t& expected, int64_t desired)
+    {
+        const int64_t previous = ::InterlockedCompareExchange64(reinterpret_cast<volatile LONG64*>(&value), desired,
+                                                                expected);
+        const bool    exchanged = previous == expected;
+        expected                = previous;
+        return exchanged;
+    }
+
+    static int32_t exchangeAcquire(int32_t& value, int32_t newValue)
+    {
+        return ::InterlockedExchange(reinterpret_cast<volatile LONG*>(&value), newValue);
+    }
+    static int32_t loadRelaxed(const int32_t& value) { return *reinterpret_cast<const volatile int32_t*>(&value); }
+    static void    storeRelease(int32_t& value, int32_t newValue) { (void)exchangeAcquire(value, newValue); }
+    static void    yield() { ::SwitchToThread(); }
+#else
+    static uint64_t load(const uint64_t& value) { return __atomic_load_n(&value, __ATOMIC_RELAXED); }
+    static int64_t  load(const int64_t& value) { return __atomic_load_n(&value, __ATOMIC_RELAXED); }
+    static void     store(uint64_t& value, uint64_t newValue) { __atomic_store_n(&value, newValue, __ATOMIC_RELAXED); }
+
+    static int64_t fetchAdd(int64_t& value, int64_t delta)
+    {
+        return __atomic_fetch_add(&value, delta, __ATOMIC_RELAXED);
+    }
+
+    static bool compareExchange(int64_t& value, int64_t& expected, int64_t desired)
+    {
+        return __atomic_compare_exchange_n(&value, &expected, desired, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    }
+
+    static int32_t exchangeAcquire(int32_t& value, int32_t newValue)
+    {
+        return __atomic_exchange_n(&value, newValue, __ATOMIC_ACQUIRE);
+    }
+    static int32_t loadRelaxed(const int32_t& value) { return __atomic_load_n(&value, __ATOMIC_RELAXED); }
+    static void    yield() { ::sched_yield(); }
+
+    static void storeRelease(int32_t& value, int32_t newValue)
+    {
+        __atomic_store_n(&value, newValue, __ATOMIC_RELEASE);
+    }
+#endif
+
+    // Protects central lists, that are accessed only once every many allocations
+    struct SpinLock
+    {
+        int32_t locked;
+
+        void lock()
+        {
+            int numSpins = 0;
+            while (exchangeAcquire(locked, 1) != 0)
+            {
+                while (loadRelaxed(locked) != 0)
+                {
+                    if (++numSpins == 32)
+                    {
+                        numSpins = 0;
+                        yield(); // Owner is probably not running (or the machine is oversubscribed)
+                    }
+                }
+            }
+        }
+
+        void unlock() { storeRelease(locked, 0); }
+    };
+
+    //--------------------------------------------------------------------
+    // Data structures
+    //--------------------------------------------------------------------
+    struct Block
+    {
+        Block* next;      // Next block of the chain
+        Block* nextChain; // Next chain (only for first blocks of chains in central lists)
+    };
+
+    // At the start of every span. Any block pointer rounded down to SpanSize lands here.
+    struct SpanHeader
+    {
+        uint32_t    magic;
+        uint32_t    sizeClass; // Or LargeClass
+        size_t      numSpans;  // Size of a large allocation (in spans)
+        SpanHeader* next;      // Cached large allocations list
+    };
+
+    struct alignas(64) CentralClass
+    {
+        SpinLock lock;
+        Block*   chains; // Chains of blocks released by threads
+        char*    cursor; // Next block to carve from current span
+        char*    end;
+    };
+
+    struct Counters
+    {
+        uint64_t numAllocations[NumSizeClasses];
+        uint64_t numReleases[NumSizeClasses];
+        uint64_t numLargeAllocations;
+        uint64_t numLargeReleases;
+        uint64_t bytesAllocated;
+        uint64_t bytesReleased;
+    };
+
+    struct CachedClass
+    {
+        Block*   head;
+        uint32_t count;
+    };
+
+    struct ThreadCache
+    {
+        CachedClass classes[NumSizeClasses];
+
+        Counters counters;   // Written only by the owner thread (with relaxed atomics), read by getStatistics
+        int64_t  flushedNet; // Net bytes of this thread already added to State::flushedBytes
+
+        ThreadCache* next; // Registry of live thread caches (or free caches list)
+        ThreadCache* prev;
+    };
+
+    struct State
+    {
+        CentralClass classes[NumSizeClasses];
+
+        SpinLock    largeLock;
+        SpanHeader* largeSpans[MaxCachedSpans + 1]; // Released large allocations, by number of spans
+        size_t      largeCachedBytes;
+
+        SpinLock     registryLock;
+        int32_t      initialized; // Thread exit callback has been registered
+        ThreadCache* threads;     // Live thread caches
+        ThreadCache* freeCaches;  // Caches of exited threads, to be reused
+        size_t       numThreads;
+        char*        metadataCursor; // Memory for thread caches
+        char*        metadataEnd;
+        Counters     retired; // Counters of exited threads and of allocations done without a thread cache
+
+        int64_t bytesMapped;
+        int64_t flushedBytes; // Bytes in use, as of last flush of every thread
+        int64_t peakBytes;
+#if !SC_PLATFORM_WINDOWS
+        pthread_key_t threadKey;
+#endif
+    };
+
+    static State                     state;
+    static thread_local ThreadCache* currentCache;
+    static thread_local bool         threadExited; // Thread cache has been flushed by the thread exit callback
+
+    //--------------------------------------------------------------------
+    // Size classes
+    //--------------------------------------------------------------------
+    // 16 bytes steps up to 128 bytes, then 4 classes for every power of two, up to MaxSmallSize
+    static uint32_t getSizeClass(size_t numBytes)
+    {
+        if (numBytes <= 128)
+        {
+            return numBytes == 0 ? 0 : static_cast<uint32_t>((numBytes - 1) / 16);
+        }
+        uint32_t shift = 5; // Step between classes in current power of two
+        while (((numBytes - 1) >> (shift + 3)) != 0)
+        {
+            shift++;
+        }
+        return 8 + (shift - 5) * 4 + static_cast<uint32_t>((numBytes - 1) >> shift) - 4;
+    }
+
+    static size_t getBlockSize(uint32_t sizeClass)
+    {
+        if (sizeClass < 8)
+        {
+            return (sizeClass + 1) * 16;
+        }
+        const uint32_t index = sizeClass - 8;
+        return static_cast<size_t>(5 + index % 4) << (5 + index / 4);
+    }
+
+    static uint32_t getBatchSize(uint32_t sizeClass)
+    {
+        const size_t numBlocks = BatchBytes / getBlockSize(sizeClass);
+        return numBlocks < 2 ? 2 : (numBlocks > 64 ? 64 : static_cast<uint32_t>(numBlocks));
+    }
+
+    static SpanHeader* getSpan(void* memory)
+    {
+        SpanHeader* span = reinterpret_cast<SpanHeader*>(reinterpret_cast<uintptr_t>(memory) & ~(SpanSize - 1));
+        SC_ASSERT_DEBUG(span->magic == SpanMagic); // Memory not allocated by Memory::allocate
+        return span;
+    }
+
+    //--------------------------------------------------------------------
+    // OS memory
+    //--------------------------------------------------------------------
+    static SpanHeader* mapSpans(size_t numSpans)
+    {
+        const size_t numBytes = numSpans * SpanSize;
+#if SC_PLATFORM_WINDOWS
+        // VirtualAlloc returns addresses aligned to allocation granularity (64 KB)
+        void* memory = ::VirtualAlloc(nullptr, numBytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (memory == nullptr)
+            return nullptr;
+        if ((reinterpret_cast<uintptr_t>(memory) & (SpanSize - 1)) != 0)
+        {
+            ::VirtualFree(memory, 0, MEM_RELEASE);
+            return nullptr;
+        }
+#elif SC_PLATFORM_EMSCRIPTEN
+        void* memory = nullptr;
+        if (::posix_memalign(&memory, SpanSize, numBytes) != 0)
+            return nullptr;
+#else
+        // Maps an additional span to find an aligned range inside it, unmapping the rest
+        void* mapped = ::mmap(nullptr, numBytes + SpanSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+        if (mapped == MAP_FAILED)
+            return nullptr;
+        const uintptr_t start   = reinterpret_cast<uintptr_t>(mapped);
+        const uintptr_t aligned = (start + SpanSize - 1) & ~(SpanSize - 1);
+        if (aligned > start)
+        {
+            ::munmap(mapped, aligned - start);
+        }
+        if (start + SpanSize > aligned)
+        {
+            ::munmap(reinterpret_cast<void*>(aligned + numBytes), start + SpanSize - aligned);
+        }
+        void* memory = reinterpret_cast<void*>(aligned);
+#endif
+        (void)fetchAdd(state.bytesMapped, static_cast<int64_t>(numBytes));
+        return static_cast<SpanHeader*>(memory);
+    }
+
+    static void unmapSpans(SpanHeader* span, size_t numSpans)
+    {
+        (void)fetchAdd(state.bytesMapped, -static_cast<int64_t>(numSpans * SpanSize));
+#if SC_PLATFORM_WINDOWS
+        ::VirtualFree(span, 0, MEM_RELEASE);
+#elif SC_PLATFORM_EMSCRIPTEN
+        ::free(span);
+#else
+        ::munmap(span, numSpans * SpanSize);
+#endif
+    }
+
+    //--------------------------------------------------------------------
+    // Statistics
+    //--------------------------------------------------------------------
+    static void increment(uint64_t& counter, uint64_t value) { store(counter, load(counter) + value); }
+
+    static void addFlushedBytes(int64_t delta)
+    {
+        const int64_t bytes = fetchAdd(state.flushedBytes, delta) + delta;
+        int64_t       peak  = load(state.peakBytes);
+        while (bytes > peak and not compareExchange(state.peakBytes, peak, bytes))
+        {
+        }
+    }
+
+    // Publishes bytes allocated or released by the thread since last flush, to update the peak
+    static void flush(ThreadCache& cache)
+    {
+        const int64_t net = static_cast<int64_t>(cache.counters.bytesAllocated - cache.counters.bytesReleased);
+        addFlushedBytes(net - cache.flushedNet);
+        cache.flushedNet = net;
+    }
+
+    // Counts an allocation (or release) done without a thread cache
+    static void countRetired(uint32_t sizeClass, bool allocation, size_t numBytes)
+    {
+        state.registryLock.lock();
+        Counters& counters = state.retired;
+        if (sizeClass == LargeClass)
+        {
+            increment(allocation ? counters.numLargeAllocations : counters.numLargeReleases, 1);
+        }
+        else
+        {
+            increment(allocation ? counters.numAllocations[sizeClass] : counters.numReleases[sizeClass], 1);
+        }
+        increment(allocation ? counters.bytesAllocated : counters.bytesReleased, numBytes);
+        state.registryLock.unlock();
+        addFlushedBytes(allocation ? static_cast<int64_t>(numBytes) : -static_cast<int64_t>(numBytes));
+    }
+
+    static void addCounters(Counters& destination, const Counters& source)
+    {
+        for (uint32_t idx = 0; idx < NumSizeClasses; ++idx)
+        {
+            increment(destination.numAllocations[idx], load(source.numAllocations[idx]));
+            increment(destination.numReleases[idx], load(source.numReleases[idx]));
+        }
+        increment(destination.numLargeAllocations, load(source.numLargeAllocations));
+        increment(destination.numLargeReleases, load(source.numLargeReleases));
+        increment(destination.bytesAllocated, load(source.bytesAllocated));
+        increment(destination.bytesReleased, load(source.bytesReleased));
+    }
+
+    static bool getStatistics(MemoryStatistics& statistics)
+    {
+        Counters counters = {};
+        state.registryLock.lock();
+        addCounters(counters, state.retired);
+        for (ThreadCache* cache = state.threads; cache != nullptr; cache = cache->next)
+        {
+            addCounters(counters, cache->counters);
+        }
+        statistics.numThreadCaches = state.numThreads;
+        state.registryLock.unlock();
+
+        for (uint32_t idx = 0; idx < NumSizeClasses; ++idx)
+        {
+            statistics.sizeClasses[idx].blockSize      = getBlockSize(idx);
+            statistics.sizeClasses[idx].numAllocations = counters.numAllocations[idx];
+            statistics.sizeClasses[idx].numReleases    = counters.numReleases[idx];
+        }
+        statistics.numLargeAllocations = counters.numLargeAllocations;
+        statistics.numLargeReleases    = counters.numLargeReleases;
+
+        // A block can be counted as released by a thread before its allocation is counted by another one
+        const uint64_t allocated  = counters.bytesAllocated;
+        const uint64_t released   = counters.bytesReleased;
+        const int64_t  peak       = load(state.peakBytes);
+        statistics.bytesInUse     = allocated > released ? static_cast<size_t>(allocated - released) : 0;
+        statistics.peakBytesInUse = peak > static_cast<int64_t>(statistics.bytesInUse) ? static_cast<size_t>(peak)
+                                                                                         : statistics.bytesInUse;
+        statistics.bytesMapped    = static_cast<size_t>(load(state.bytesMapped));
+        return true;
+    }
+
+    //--------------------------------------------------------------------
+    // Central lists
+    //--------------------------------------------------------------------
+    // Takes a chain of blocks released by some thread, or carves up to numBlocks new blocks from a span
+    static Block* fetchChain(uint32_t sizeClass, uint32_t numBlocks)
+    {
+        CentralClass& central = state.classes[sizeClass];
+        central.lock.lock();
+        Block* chain = central.chains;
+        if (chain != nullptr)
+        {
+            central.chains = chain->nextChain;
+            central.lock.unlock();
+            return chain;
+        }
+        const size_t blockSize = getBlockSize(sizeClass);
+        if (central.cursor == nullptr or central.cursor + blockSize > central.end)
+        {
+            SpanHeader* span = mapSpans(1);
+            if (span == nullptr)
+            {
+                central.lock.unlock();
+                return nullptr;
+            }
+            span->magic     = SpanMagic;
+            span->sizeClass = sizeClass;
+            span->numSpans  = 1;
+            central.cursor  = reinterpret_cast<char*>(span) + SpanHeaderSize;
+            central.end     = reinterpret_cast<char*>(span) + SpanSize;
+        }
+        Block* last = nullptr;
+        for (uint32_t idx = 0; idx < numBlocks and central.cursor + blockSize <= central.end; ++idx)
+        {
+            Block* block = reinterpret_cast<Block*>(central.cursor);
+            block->next  = nullptr;
+            if (last == nullptr)
+                chain = block;
+            else
+                last->next = block;
+            last = block;
+            central.cursor += blockSize;
+        }
+        central.lock.unlock();
+        return chain;
+    }
+
+    static void pushChain(uint32_t sizeClass, Block* chain)
+    {
+        CentralClass& central = state.classes[sizeClass];
+        central.lock.lock();
+        chain->nextChain = central.chains;
+        central.chains   = chain;
+        central.lock.unlock();
+    }
+
+    //--------------------------------------------------------------------
+    // Thread caches
+    //--------------------------------------------------------------------
+    // Called by the TLS callback on Windows (on DLL_THREAD_DETACH) and by the pthread key destructor elsewhere.
+    // Fiber local storage callbacks are not used, as they also run when a fiber is deleted (see JobSystem).
+    static void onThreadExit(void* value)
+    {
+        if (value == nullptr)
+            return;
+        ThreadCache& cache = *static_cast<ThreadCache*>(value);
+        for (uint32_t idx = 0; idx < NumSizeClasses; ++idx)
+        {
+            if (cache.classes[idx].head != nullptr)
+            {
+                pushChain(idx, cache.classes[idx].head);
+            }
+        }
+        flush(cache);
+
+        state.registryLock.lock();
+        addCounters(state.retired, cache.counters);
+        if (cache.prev != nullptr)
+            cache.prev->next = cache.next;
+        else
+            state.threads = cache.next;
+        if (cache.next != nullptr)
+            cache.next->prev = cache.prev;
+        cache.next       = state.freeCaches;
+        state.freeCaches = &cache;
+        state.numThreads--;
+        state.registryLock.unlock();
+
+        currentCache = nullptr;
+        threadExited = true; // Allocations done by later thread exit callbacks don't use a thread cache
+    }
+
+    static ThreadCache* getThreadCache()
+    {
+        ThreadCache* cache = currentCache;
+        if (cache != nullptr or threadExited)
+            return cache;
+
+        state.registryLock.lock();
+        if (state.initialized == 0)
+        {
+#if SC_PLATFORM_WINDOWS
+            state.initialized = 1; // Thread exit is always notified by the TLS callback
+#else
+            state.initialized = ::pthread_key_create(&state.threadKey, &onThreadExit) == 0 ? 1 : -1;
+#endif
+        }
+        cache = state.freeCaches;
+        if (cache != nullptr)
+        {
+            state.freeCaches = cache->next;
+        }
+        else
+        {
+            if (state.metadataCursor == nullptr or state.metadataCursor + sizeof(ThreadCache) > state.metadataEnd)
+            {
+                char* memory         = reinterpret_cast<char*>(mapSpans(1));
+                state.metadataCursor = memory;
+                state.metadataEnd    = memory ? memory + SpanSize : nullptr;
+            }
+            if (state.metadataCursor != nullptr)
+            {
+                cache = reinterpret_cast<ThreadCache*>(state.metadataCursor);
+                state.metadataCursor += (sizeof(ThreadCache) + 63) & ~size_t(63);
+            }
+        }
+        if (cache != nullptr)
+        {
+            ::memset(cache, 0, sizeof(ThreadCache));
+            cache->next = state.threads;
+            if (state.threads != nullptr)
+                state.threads->prev = cache;
+            state.threads = cache;
+            state.numThreads++;
+        }
+        const bool canRegisterExit = state.initialized == 1;
+        state.registryLock.unlock();
+
+        if (cache != nullptr and canRegisterExit)
+        {
+            // Without a thread exit callback (very unlikely) blocks cached by the thread are leaked when it exits
+#if !SC_PLATFORM_WINDOWS
+            (void)::pthread_setspecific(state.threadKey, cache);
+#endif
+        }
+        currentCache = cache;
+        return cache;
+    }
+
+    //--------------------------------------------------------------------
+    // Small allocations
+    //--------------------------------------------------------------------
+    static void* allocateSmall(uint32_t sizeClass)
+    {
+        ThreadCache* cache = currentCache;
+        if (cache != nullptr)
+        {
+            CachedClass& cached = cache->classes[sizeClass];
+            Block*       block  = cached.head;
+            if (block != nullptr)
+                SC_LANGUAGE_LIKELY
+                {
+                    cached.head = block->next;
+                    cached.count--;
+                    increment(cache->counters.numAllocations[sizeClass], 1);
+                    increment(cache->counters.bytesAllocated, getBlockSize(sizeClass));
+                    return block;
+                }
+        }
+        return allocateSmallSlow(sizeClass);
+    }
+
+    static void* allocateSmallSlow(uint32_t sizeClass)
+    {
+        ThreadCache* cache = getThreadCache();
+        if (cache == nullptr)
+        {
+            // Thread is exiting, take a single block from the central list
+            Block* chain = fetchChain(sizeClass, 1);
+            if (chain == nullptr)
+                return nullptr;
+            if (chain->next != nullptr)
+            {
+                pushChain(sizeClass, chain->next);
+            }
+            countRetired(sizeClass, true, getBlockSize(sizeClass));
+            return chain;
+        }
+        CachedClass& cached = cache->classes[sizeClass];
+        if (cached.head == nullptr)
+        {
+            Block* chain = fetchChain(sizeClass, getBatchSize(sizeClass));
+            if (chain == nullptr)
+                return nullptr;
+            uint32_t numBlocks = 0;
+            for (Block* block = chain; block != nullptr; block = block->next)
+            {
+                numBlocks++;
+            }
+            cached.head  = chain;
+            cached.count = numBlocks;
+        }
+        Block* block = cached.head;
+        cached.head  = block->next;
+        cached.count--;
+        increment(cache->counters.numAllocations[sizeClass], 1);
+        increment(cache->counters.bytesAllocated, getBlockSize(sizeClass));
+        flush(*cache);
+        return block;
+    }
+
+    static void releaseSmall(void* memory, uint32_t sizeClass)
+    {
+        Block*       block = static_cast<Block*>(memory);
+        ThreadCache* cache = currentCache;
+        if (cache == nullptr)
+        {
+            cache = getThreadCache();
+            if (cache == nullptr)
+            {
+                block->next = nullptr;
+                pushChain(sizeClass, block);
+                countRetired(sizeClass, false, getBlockSize(sizeClass));
+                return;
+            }
+        }
+        CachedClass& cached = cache->classes[sizeClass];
+        block->next         = cached.head;
+        cached.head         = block;
+        cached.count++;
+        increment(cache->counters.numReleases[sizeClass], 1);
+        increment(cache->counters.bytesReleased, getBlockSize(sizeClass));
+
+        const uint32_t batchSize = getBatchSize(sizeClass);
+        if (cached.count > 2 * batchSize)
+        {
+            // Moves a batch of blocks to the central list, where other threads can take them
+            Block* last = cached.head;
+            for (uint32_t idx = 1; idx < batchSize; ++idx)
+            {
+                last = last->next;
+            }
+            Block* chain = cached.head;
+            cached.head  = last->next;
+            last->next   = nullptr;
+            cached.count -= batchSize;
+            pushChain(sizeClass, chain);
+            flush(*cache);
+        }
+    }
+
+    //--------------------------------------------------------------------
+    // Large allocations
+    //--------------------------------------------------------------------
+    static void countLarge(bool allocation, size_t numBytes)
+    {
+        ThreadCache* cache = getThreadCache();
+        if (cache == nullptr)
+        {
+            countRetired(LargeClass, allocation, numBytes);
+            return;
+        }
+        Counters& counters = cache->counters;
+        increment(allocation ? counters.numLargeAllocations : counters.numLargeReleases, 1);
+        increment(allocation ? counters.bytesAllocated : counters.bytesReleased, numBytes);
+        flush(*cache);
+    }
+
+    static void* allocateLarge(size_t numBytes)
+    {
+        if (numBytes > ~size_t(0) - SpanHeaderSize - SpanSize)
+            return nullptr;
+        const size_t numSpans = (numBytes + SpanHeaderSize + SpanSize - 1) / SpanSize;
+
+        SpanHeader* span = nullptr;
+        if (numSpans <= MaxCachedSpans)
+        {
+            state.largeLock.lock();
+            span = state.largeSpans[numSpans];
+            if (span != nullptr)
+            {
+                state.largeSpans[numSpans] = span->next;
+                state.largeCachedBytes -= numSpans * SpanSize;
+            }
+            state.largeLock.unlock();
+        }
+        if (span == nullptr)
+        {
+            span = mapSpans(numSpans);
+            if (span == nullptr)
+                return nullptr;
+            span->magic     = SpanMagic;
+            span->sizeClass = LargeClass;
+            span->numSpans  = numSpans;
+        }
+        countLarge(true, numSpans * SpanSize);
+        return reinterpret_cast<char*>(span) + SpanHeaderSize;
+    }
+
+    static void releaseLarge(SpanHeader* span)
+    {
+        const size_t numSpans = span->numSpans;
+        countLarge(false, numSpans * SpanSize);
+        if (numSpans <= MaxCachedSpans)
+        {
+            state.largeLock.lock();
+            const bool cached = state.largeCachedBytes + numSpans * SpanSize <= MaxCachedBytes;
+            if (cached)
+            {
+                span->next                 = state.largeSpans[numSpans];
+                state.largeSpans[numSpans] = span;
+                state.largeCachedBytes += numSpans * SpanSize;
+            }
+            state.largeLock.unlock();
+            if (cached)
+                return;
+        }
+        unmapSpans(span, numSpans);
+    }
+
+    //--------------------------------------------------------------------
+    // Memory functions
+    //--------------------------------------------------------------------
+    static void* allocate(size_t numBytes)
+    {
+        return numBytes <= MaxSmallSize ? allocateSmall(getSizeClass(numBytes)) : allocateLarge(numBytes);
+    }
+
+    static void release(void* memory)
+    {
+        if (memory == nullptr)
+            return;
+        SpanHeader* span = getSpan(memory);
+        if (span->sizeClass == LargeClass)
+        {
+            releaseLarge(span);
+        }
+        else
+        {
+            releaseSmall(memory, span->sizeClass);
+        }
+    }
+
+    static void* reallocate(void* memory, size_t numBytes)
+    {
+        if (memory == nullptr)
+        {
+            return allocate(numBytes);
+        }
+        if (numBytes == 0)
+        {
+            release(memory);
+            return nullptr;
+        }
+        SpanHeader* span = getSpan(memory);
+        size_t      capacity;
+        if (span->sizeClass == LargeClass)
+        {
+            // Keeps the allocation unless it would waste more than half of it
+            capacity = span->numSpans * SpanSize - SpanHeaderSize;
+            if (numBytes <= capacity and numBytes > capacity / 2)
+                return memory;
+        }
+        else
+        {
+            capacity = getBlockSize(span->sizeClass);
+            if (numBytes <= MaxSmallSize and getSizeClass(numBytes) == span->sizeClass)
+                return memory;
+        }
+        void* newMemory = allocate(numBytes);
+        if (newMemory == nullptr)
+            return nullptr; // Like realloc, the original memory is still valid
+        ::memcpy(newMemory, memory, numBytes < capacity ? numBytes : capacity);
+        release(memory);
+        return newMemory;
+    }
+};
+
+SC::MemoryCachingAllocator::State                     SC::MemoryCachingAllocator::state;
+thread_local SC::MemoryCachingAllocator::ThreadCache* SC::MemoryCachingAllocator::currentCache = nullptr;
+thread_local bool                                     SC::MemoryCachingAllocator::threadExited = false;
+
+#if SC_PLATFORM_WINDOWS
+// Thread exit hook run by the loader for every thread (and never when deleting fibers).
+// Placed after .CRT$XLD, so that it runs after the destructors of thread_local objects that may release memory.
+static void NTAPI SC_MemoryCachingAllocatorOnTLS(PVOID, DWORD reason, PVOID)
+{
+    if (reason == DLL_THREAD_DETACH)
+    {
+        SC::MemoryCachingAllocator::onThreadExit(SC::MemoryCachingAllocator::currentCache);
+    }
+}
+#if defined(_MSC_VER)
+#pragma section(".CRT$XLY", long, read)
+#if defined(_M_IX86)
+#pragma comment(linker, "/INCLUDE:__tls_used")
+#pragma comment(linker, "/INCLUDE:_SC_MemoryCachingAllocatorTLSCallback")
+#else
+#pragma comment(linker, "/INCLUDE:_tls_used")
+#pragma comment(linker, "/INCLUDE:SC_MemoryCachingAllocatorTLSCallback")
+#endif
+extern "C" __declspec(allocate(".CRT$XLY")) const PIMAGE_TLS_CALLBACK SC_MemoryCachingAllocatorTLSCallback =
+    &SC_MemoryCachingAllocatorOnTLS;
+#else
+extern "C" __attribute__((section(".CRT$XLY"), used)) const PIMAGE_TLS_CALLBACK
+    SC_MemoryCachingAllocatorTLSCallback = &SC_MemoryCachingAllocatorOnTLS;
+#endif
+#endif
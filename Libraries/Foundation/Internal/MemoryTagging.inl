@@ -0,0 +1,203 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+// Included by Foundation.cpp when SC_MEMORY_TAGGING == 1 (after Windows.h on Windows)
+#if !SC_PLATFORM_WINDOWS
+#include <sched.h> // sched_yield
+#endif
+
+namespace SC
+{
+struct MemoryTagging;
+}
+
+// All of its state is constant initialized, as containers can allocate before (or after) running static constructors
+struct SC::MemoryTagging
+{
+    // Protects all sites and links, as segments can be allocated by a thread and released by another one
+    struct SpinLock
+    {
+        int32_t locked;
+
+#if SC_PLATFORM_WINDOWS
+        void lock()
+        {
+            while (::InterlockedExchange(reinterpret_cast<volatile LONG*>(&locked), 1) != 0)
+            {
+                ::SwitchToThread();
+            }
+        }
+        void unlock() { (void)::InterlockedExchange(reinterpret_cast<volatile LONG*>(&locked), 0); }
+#else
+        void lock()
+        {
+            while (__atomic_exchange_n(&locked, 1, __ATOMIC_ACQUIRE) != 0)
+            {
+                ::sched_yield();
+            }
+        }
+        void unlock() { __atomic_store_n(&locked, 0, __ATOMIC_RELEASE); }
+#endif
+    };
+
+    static SpinLock                    lock;
+    static MemoryTagSite               untaggedSite; // Receives segments allocated outside of any SC_MEMORY_TAG
+    static MemoryTagSite*              firstSite;    // Registry of all sites that have been activated at least once
+    static thread_local MemoryTagSite* currentSite;
+
+    // Must be called with the lock held
+    static void registerSite(MemoryTagSite& site)
+    {
+        if (not site.registered)
+        {
+            site.registered = true;
+            site.nextSite   = firstSite;
+            firstSite       = &site;
+        }
+    }
+
+    static void addStatistics(MemoryTagStatistics& statistics, const MemoryTagSite& site)
+    {
+        statistics.bytesInUse += site.bytesInUse;
+        statistics.peakBytesInUse += site.peakBytesInUse;
+        statistics.numAllocations += site.numAllocations;
+        statistics.numReleases += site.numReleases;
+        statistics.numSmallVectorSpills += site.numSmallVectorSpills;
+        statistics.numSmallVectorInline += site.numSmallVectorInline;
+        for (const MemoryTagLink* link = site.firstLink; link != nullptr; link = link->next)
+        {
+            size_t capacityBytes = 0;
+            statistics.sizeBytes += link->usedBytes(*link, capacityBytes);
+            statistics.capacityBytes += capacityBytes;
+        }
+    }
+};
+
+SC::MemoryTagging::SpinLock    SC::MemoryTagging::lock         = {0};
+SC::MemoryTagSite              SC::MemoryTagging::untaggedSite = {"untagged", nullptr, 0};
+SC::MemoryTagSite*             SC::MemoryTagging::firstSite    = &SC::MemoryTagging::untaggedSite;
+thread_local SC::MemoryTagSite* SC::MemoryTagging::currentSite = nullptr;
+
+SC::MemoryTagScope::MemoryTagScope(MemoryTagSite& site) : previousSite(MemoryTagging::currentSite)
+{
+    if (not site.registered)
+    {
+        MemoryTagging::lock.lock();
+        MemoryTagging::registerSite(site);
+        MemoryTagging::lock.unlock();
+    }
+    MemoryTagging::currentSite = &site;
+}
+
+SC::MemoryTagScope::~MemoryTagScope() { MemoryTagging::currentSite = previousSite; }
+
+void SC::MemoryTagLink::track(MemoryTagSite* ownerSite, size_t segmentBytes, UsedBytesFunction usedBytesFunction,
+                              bool spilled)
+{
+    MemoryTagSite* activeSite = MemoryTagging::currentSite;
+    if (ownerSite != nullptr)
+        site = ownerSite;
+    else
+        site = activeSite != nullptr ? activeSite : &MemoryTagging::untaggedSite;
+    numBytes  = segmentBytes;
+    usedBytes = usedBytesFunction;
+    previous  = nullptr;
+
+    MemoryTagging::lock.lock();
+    next = site->firstLink;
+    if (next != nullptr)
+    {
+        next->previous = this;
+    }
+    site->firstLink = this;
+    site->bytesInUse += numBytes;
+    if (site->bytesInUse > site->peakBytesInUse)
+    {
+        site->peakBytesInUse = site->bytesInUse;
+    }
+    site->numAllocations++;
+    if (spilled)
+    {
+        site->numSmallVectorSpills++;
+    }
+    MemoryTagging::lock.unlock();
+}
+
+SC::MemoryTagSite* SC::MemoryTagLink::untrack(bool reallocating)
+{
+    MemoryTagSite* ownerSite = site;
+    if (ownerSite == nullptr)
+    {
+        return nullptr;
+    }
+    MemoryTagging::lock.lock();
+    if (previous != nullptr)
+        previous->next = next;
+    else
+        ownerSite->firstLink = next;
+    if (next != nullptr)
+    {
+        next->previous = previous;
+    }
+    ownerSite->bytesInUse -= numBytes;
+    if (not reallocating)
+    {
+        ownerSite->numReleases++;
+    }
+    MemoryTagging::lock.unlock();
+    site = nullptr;
+    return ownerSite;
+}
+
+void SC::MemoryTagLink::countSmallVectorInline()
+{
+    MemoryTagSite* site = MemoryTagging::currentSite;
+    MemoryTagging::lock.lock();
+    (site != nullptr ? site : &MemoryTagging::untaggedSite)->numSmallVectorInline++;
+    MemoryTagging::lock.unlock();
+}
+
+bool SC::Memory::getTagStatistics(Span<MemoryTagStatistics> statistics, size_t& numStatistics, bool groupByTag)
+{
+    numStatistics = 0;
+    MemoryTagging::lock.lock();
+    for (const MemoryTagSite* site = MemoryTagging::firstSite; site != nullptr; site = site->nextSite)
+    {
+        MemoryTagStatistics* found = nullptr;
+        if (groupByTag)
+        {
+            // Tags are usually string literals, so the same name can live at different addresses
+            const size_t numFilled = numStatistics < statistics.sizeInElements() ? numStatistics
+                                                                                  : statistics.sizeInElements();
+            for (size_t idx = 0; idx < numFilled; ++idx)
+            {
+                if (::strcmp(statistics.data()[idx].tag, site->tag) == 0)
+                {
+                    found = &statistics.data()[idx];
+                    break;
+                }
+            }
+        }
+        if (found == nullptr)
+        {
+            if (numStatistics < statistics.sizeInElements())
+            {
+                found  = &statistics.data()[numStatistics];
+                *found = MemoryTagStatistics();
+
+                found->tag = site->tag;
+                if (not groupByTag)
+                {
+                    found->file = site->file;
+                    found->line = site->line;
+                }
+            }
+            numStatistics++;
+        }
+        if (found != nullptr)
+        {
+            MemoryTagging::addStatistics(*found, *site);
+        }
+    }
+    MemoryTagging::lock.unlock();
+    return true;
+}
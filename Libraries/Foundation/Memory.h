@@ -2,14 +2,50 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 #include "../Foundation/PrimitiveTypes.h"
+#include "../Foundation/Span.h"
+
+#if !defined(SC_MEMORY_CACHING_ALLOCATOR)
+/// @brief Set to 1 (for example in `SCConfig.h`) to let SC::Memory use its own caching allocator instead of `malloc`
+#define SC_MEMORY_CACHING_ALLOCATOR 0
+#endif
+
+#if !defined(SC_MEMORY_TAGGING)
+/// @brief Set to 1 (for example in `SCConfig.h`) to attribute memory of containers to SC::MemoryTagSite (see
+/// SC_MEMORY_TAG)
+#define SC_MEMORY_TAGGING 0
+#endif
+
 namespace SC
 {
 struct Memory;
-}
+struct MemoryStatistics;
+struct MemoryTagStatistics;
+struct MemoryAllocator;
+struct ArenaAllocator;
+struct ScratchAllocator;
+struct PoolAllocator;
+} // namespace SC
 //! @addtogroup group_foundation_utility
 //! @{
 
 /// @brief Centralized functions to allocate, reallocate and deallocate memory
+///
+/// By default all functions forward to `malloc`, `realloc` and `free`.
+/// When `SC_MEMORY_CACHING_ALLOCATOR` is defined to 1, they use a caching allocator designed for allocation heavy
+/// multi-threaded code (for example many threads growing and freeing SC::Vector and SC::String):
+/// - Small allocations (up to 8 KB) are rounded to one of 32 size classes, and they're served from and released to
+///   a per-thread cache without taking any lock.
+/// - Per-thread caches exchange blocks with a central free list (one per size class) in batches, so that the
+///   (spin) lock of the central list is taken only once every many allocations, even when blocks are allocated by a
+///   thread and released by another one.
+/// - Blocks are carved from 64 KB spans obtained with `mmap` / `VirtualAlloc`, aligned so that the size class of any
+///   block can be found without a per-allocation header.
+/// - Large allocations get their own spans straight from the OS, and a few recently released ones are kept to be
+///   reused by later allocations of the same size.
+/// - Caches of exiting threads are flushed to the central lists.
+///
+/// Memory::getStatistics returns bytes in use (and their peak) and per size class allocation counts.
+/// @note Spans of small size classes are never given back to the OS.
 struct SC::Memory
 {
     /// @brief Allocates numBytes bytes of memory
@@ -26,5 +62,342 @@ struct SC::Memory
     /// @brief Free memory allocated by Memory::allocate and / or reallocated by Memory::reallocate
     /// @param allocatedMemory Memory to release / deallocate
     SC_COMPILER_EXPORT static void release(void* allocatedMemory);
+
+    /// @brief Obtains statistics of the caching allocator
+    /// @param statistics Receives the statistics
+    /// @return `false` if `SC_MEMORY_CACHING_ALLOCATOR` is not enabled
+    [[nodiscard]] SC_COMPILER_EXPORT static bool getStatistics(MemoryStatistics& statistics);
+
+    /// @brief Obtains statistics of heap memory used by containers, for each SC::MemoryTagSite or for each tag name
+    /// @param statistics Receives statistics of sites (or tags), until it's full
+    /// @param numStatistics Receives the number of sites (or tags), that can be larger than statistics size
+    /// @param groupByTag If `true` statistics of sites with the same tag name are summed together
+    /// @return `false` if `SC_MEMORY_TAGGING` is not enabled
+    [[nodiscard]] SC_COMPILER_EXPORT static bool getTagStatistics(Span<MemoryTagStatistics> statistics,
+                                                                  size_t& numStatistics, bool groupByTag = false);
+};
+
+/// @brief Statistics of the SC::Memory caching allocator (see Memory::getStatistics)
+///
+/// Values are summed from all threads without stopping them, so they're just a (very close) snapshot when other
+/// threads are allocating. The peak is updated when threads exchange blocks with central lists, so it can miss
+/// the memory cached by threads (a few KB each).
+struct SC::MemoryStatistics
+{
+    static constexpr size_t NumSizeClasses = 32;
+
+    struct SizeClass
+    {
+        size_t   blockSize      = 0; ///< Size of the blocks of this class
+        uint64_t numAllocations = 0; ///< Number of allocations served by this class
+        uint64_t numReleases    = 0; ///< Number of blocks of this class that have been released
+    };
+    SizeClass sizeClasses[NumSizeClasses];
+
+    uint64_t numLargeAllocations = 0; ///< Number of allocations larger than the largest size class
+    uint64_t numLargeReleases    = 0; ///< Number of large allocations that have been released
+
+    size_t bytesInUse      = 0; ///< Bytes of all blocks allocated and not released yet (including size class rounding)
+    size_t peakBytesInUse  = 0; ///< Highest value reached by bytesInUse
+    size_t bytesMapped     = 0; ///< Bytes obtained from the OS (including the ones cached or not used yet)
+    size_t numThreadCaches = 0; ///< Number of threads that have allocated memory and are still running
+};
+
+/// @brief Heap memory used by containers allocated under a SC::MemoryTagSite (see Memory::getTagStatistics)
+///
+/// Statistics count the heap segments that SC::Vector, SC::SmallVector, SC::String and SC::SmallString allocate with
+/// SC::Memory (but not the ones obtained from a SC::MemoryAllocator, that can be measured by the allocator itself).
+/// A segment belongs to the site that was active on the current thread when the container first allocated it, even
+/// when it's grown, released or moved to another container later on.
+struct SC::MemoryTagStatistics
+{
+    const char* tag  = nullptr; ///< Name of the tag (`"untagged"` for memory allocated outside of any SC_MEMORY_TAG)
+    const char* file = nullptr; ///< File declaring the site (`nullptr` when grouping by tag)
+    int         line = 0;       ///< Line declaring the site (`0` when grouping by tag)
+
+    size_t bytesInUse     = 0; ///< Bytes of heap segments not released yet (including their headers)
+    size_t peakBytesInUse = 0; ///< Highest value reached by bytesInUse (sum of site peaks when grouping by tag)
+    size_t capacityBytes  = 0; ///< Bytes that can be used by items in heap segments not released yet
+    size_t sizeBytes      = 0; ///< Bytes actually used by items in heap segments not released yet
+
+    uint64_t numAllocations       = 0; ///< Number of heap segments allocated or reallocated
+    uint64_t numReleases          = 0; ///< Number of heap segments released
+    uint64_t numSmallVectorSpills = 0; ///< Times a SC::SmallVector or SC::SmallString moved items to the heap
+    uint64_t numSmallVectorInline = 0; ///< SC::SmallVector or SC::SmallString destroyed using their inline buffer
+
+    /// @brief Bytes reserved by the growth policy of containers but not used by any item (capacity minus size)
+    [[nodiscard]] size_t getWastedBytes() const { return capacityBytes - sizeBytes; }
+};
+
+#if SC_MEMORY_TAGGING || DOXYGEN
+namespace SC
+{
+struct MemoryTagSite;
+struct MemoryTagScope;
+struct MemoryTagLink;
+} // namespace SC
+
+/// @brief Attributes heap memory allocated by containers in the rest of current scope (on the current thread) to a tag
+///
+/// Declares a SC::MemoryTagSite for the given tag at the current file and line, and makes it active with a
+/// SC::MemoryTagScope. Sites can be nested (the innermost one wins) and the same tag can be used by many sites, so
+/// that Memory::getTagStatistics can report memory both for each site or for each tag. @n
+/// When `SC_MEMORY_TAGGING` is not enabled it expands to nothing.
+/// @note It can be used at most once in the same block.
+#define SC_MEMORY_TAG(tagName)                                                                                         \
+    static SC::MemoryTagSite scMemoryTagSite(tagName, __FILE__, __LINE__);                                             \
+    SC::MemoryTagScope       scMemoryTagScope(scMemoryTagSite)
+
+/// @brief A place in code (declared by SC_MEMORY_TAG) collecting statistics of containers allocated under it
+///
+/// All fields, except for the ones describing the site, are protected by a global lock that is also taken
+/// by every allocation of a container heap segment, making it meant for diagnostic builds.
+struct SC::MemoryTagSite
+{
+    const char* tag;  ///< Name of the tag (for example a subsystem)
+    const char* file; ///< File declaring the site
+    int         line; ///< Line declaring the site
+
+    /// @brief Describes the site (it's constant initialized when static, so it doesn't need any lock)
+    constexpr MemoryTagSite(const char* tag, const char* file, int line) : tag(tag), file(file), line(line) {}
+
+  private:
+    friend struct Memory;
+    friend struct MemoryTagging;
+    friend struct MemoryTagScope;
+    friend struct MemoryTagLink;
+
+    MemoryTagSite* nextSite   = nullptr;
+    MemoryTagLink* firstLink  = nullptr;
+    bool           registered = false;
+
+    size_t   bytesInUse           = 0;
+    size_t   peakBytesInUse       = 0;
+    uint64_t numAllocations       = 0;
+    uint64_t numReleases          = 0;
+    uint64_t numSmallVectorSpills = 0;
+    uint64_t numSmallVectorInline = 0;
+};
+
+/// @brief Makes a SC::MemoryTagSite active on the current thread until destroyed (see SC_MEMORY_TAG)
+struct SC::MemoryTagScope
+{
+    SC_COMPILER_EXPORT explicit MemoryTagScope(MemoryTagSite& site);
+    SC_COMPILER_EXPORT ~MemoryTagScope();
+
+    MemoryTagScope(const MemoryTagScope&)            = delete;
+    MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+
+  private:
+    MemoryTagSite* previousSite;
+};
+
+/// @brief Links a heap segment of a container to the SC::MemoryTagSite that allocated it (used by SC::Vector)
+struct SC::MemoryTagLink
+{
+    /// @brief Returns bytes used by the items of the segment holding the link, and the ones it can hold
+    using UsedBytesFunction = size_t (*)(const MemoryTagLink& link, size_t& capacityBytes);
+
+    MemoryTagSite* site = nullptr; ///< Site owning the segment (`nullptr` if it's not tracked)
+
+    /// @brief Attributes a segment of numBytes to a site (or the site active on current thread if it's `nullptr`)
+    /// @param ownerSite Site of the segment being replaced by this one, or `nullptr` for the active site
+    /// @param numBytes Size of the allocated segment
+    /// @param usedBytes Function returning bytes used by the segment, when taking statistics
+    /// @param spilled `true` if the segment replaces the inline buffer of a SC::SmallVector or SC::SmallString
+    SC_COMPILER_EXPORT void track(MemoryTagSite* ownerSite, size_t numBytes, UsedBytesFunction usedBytes,
+                                  bool spilled);
+
+    /// @brief Removes the segment from its site, if tracked
+    /// @param reallocating `true` if the segment will be tracked again after being reallocated
+    /// @return The site that owned the segment (or `nullptr` if it was not tracked)
+    SC_COMPILER_EXPORT MemoryTagSite* untrack(bool reallocating);
+
+    /// @brief Counts a SC::SmallVector or SC::SmallString being destroyed while using its inline buffer
+    SC_COMPILER_EXPORT static void countSmallVectorInline();
+
+  private:
+    MemoryTagLink*    previous  = nullptr;
+    MemoryTagLink*    next      = nullptr;
+    size_t            numBytes  = 0;
+    UsedBytesFunction usedBytes = nullptr;
+
+    friend struct MemoryTagging;
+};
+#else
+#define SC_MEMORY_TAG(tagName)
+#endif
+
+/// @brief Interface of a stateful allocator that can be given to SC::Vector and SC::String (instead of SC::Memory)
+///
+/// Derived allocators pass to the constructor a single function implementing all operations, so that the interface
+/// costs just one pointer. All returned blocks must be aligned to MemoryAllocator::Alignment.
+/// @note The allocator must outlive all containers using it.
+struct SC::MemoryAllocator
+{
+    static constexpr size_t Alignment = 16; ///< Alignment of all blocks returned by allocators
+
+    /// @brief Allocates numBytes bytes of memory
+    /// @return Pointer to allocated memory or `nullptr` if allocation fails
+    [[nodiscard]] void* allocate(size_t numBytes) { return function(*this, Operation::Allocate, nullptr, 0, numBytes); }
+
+    /// @brief Changes size of a block obtained from this allocator, copying its contents
+    /// @param memory A block previously obtained from this allocator
+    /// @param oldNumBytes Size of the block passed to MemoryAllocator::allocate or MemoryAllocator::reallocate
+    /// @param newNumBytes New size of the block
+    /// @return Pointer to the resized block (that can be the same as memory) or `nullptr` if allocation fails
+    [[nodiscard]] void* reallocate(void* memory, size_t oldNumBytes, size_t newNumBytes)
+    {
+        return function(*this, Operation::Reallocate, memory, oldNumBytes, newNumBytes);
+    }
+
+    /// @brief Releases a block obtained from this allocator
+    /// @param memory A block previously obtained from this allocator
+    /// @param numBytes Size of the block passed to MemoryAllocator::allocate or MemoryAllocator::reallocate
+    void release(void* memory, size_t numBytes) { (void)function(*this, Operation::Release, memory, numBytes, 0); }
+
+  protected:
+    enum class Operation : uint8_t
+    {
+        Allocate,
+        Reallocate,
+        Release
+    };
+    using Function = void* (*)(MemoryAllocator&, Operation, void* memory, size_t oldNumBytes, size_t newNumBytes);
+
+    explicit MemoryAllocator(Function function) : function(function) {}
+
+    MemoryAllocator(const MemoryAllocator&)            = delete;
+    MemoryAllocator& operator=(const MemoryAllocator&) = delete;
+
+  private:
+    Function function;
+};
+
+/// @brief Linear (bump) allocator obtaining chunks of memory from SC::Memory and freeing all blocks at once.
+///
+/// Allocating is just incrementing an offset, and releasing single blocks does nothing.
+/// Reallocating the last allocated block grows it in place (as it happens with a SC::Vector being filled).
+/// ArenaAllocator::reset makes all memory available again in `O(1)`, keeping chunks for the following allocations,
+/// so that a whole graph of SC::Vector and SC::String used by a task (for example a request of a server) can be
+/// freed at once and its memory reused by the next task.
+/// @warning ArenaAllocator::reset doesn't run destructors: containers using the arena must be destroyed before it or
+/// they must be abandoned (never destroyed), for example when they're themselves created with ArenaAllocator::create.
+/// @note It's not thread safe.
+struct SC::ArenaAllocator : public MemoryAllocator
+{
+    /// @brief Creates the arena, without allocating any memory
+    /// @param chunkSize Minimum size of chunks requested to SC::Memory
+    explicit ArenaAllocator(size_t chunkSize = 64 * 1024);
+
+    /// @brief Releases all chunks to SC::Memory
+    ~ArenaAllocator();
+
+    /// @brief Makes all memory of the arena available again, invalidating all blocks allocated so far
+    void reset();
+
+    /// @brief Allocates upfront the first chunk, so that it can hold at least numBytes bytes.
+    /// It does nothing if the arena already owns a chunk.
+    /// @return `false` if allocation fails
+    [[nodiscard]] bool reserve(size_t numBytes);
+
+    /// @brief Changes the minimum size of chunks that will be requested to SC::Memory (existing chunks are kept)
+    void setChunkSize(size_t newChunkSize);
+
+    /// @brief Constructs an object in memory allocated from the arena (it will never be destroyed)
+    /// @return Pointer to the object or `nullptr` if allocation fails
+    template <typename T, typename... Args>
+    [[nodiscard]] T* create(Args&&... args)
+    {
+        static_assert(alignof(T) <= Alignment, "ArenaAllocator::create alignment");
+        void* memory = allocate(sizeof(T));
+        return memory == nullptr ? nullptr : new (memory, PlacementNew()) T(forward<Args>(args)...);
+    }
+
+    /// @brief Number of bytes allocated since creation or since last ArenaAllocator::reset
+    [[nodiscard]] size_t getBytesUsed() const { return bytesUsed; }
+
+  private:
+    struct Chunk;
+
+    Chunk* firstChunk   = nullptr;
+    Chunk* currentChunk = nullptr;
+    size_t chunkSize;
+    size_t offset        = 0; // Offset of first free byte in currentChunk
+    size_t lastAllocated = 0; // Offset of the last allocated block in currentChunk
+    size_t bytesUsed     = 0;
+
+    static void* allocatorFunction(MemoryAllocator&, Operation, void*, size_t, size_t);
+
+    void* allocateBlock(size_t numBytes);
+    bool  resizeLastBlock(void* memory, size_t newNumBytes);
+};
+
+/// @brief Stack (LIFO) allocator working on a given buffer, typically owned by a single thread as scratch memory.
+///
+/// Blocks released in reverse allocation order give their memory back immediately, and the last block can be grown
+/// in place. Blocks released out of order are reclaimed as soon as all blocks allocated after them are released.
+/// When the buffer is full, blocks are obtained from SC::Memory, so that allocations fail only if SC::Memory fails.
+/// A typical use is making temporary SC::Vector or SC::String live in a buffer on the stack of the current thread.
+/// @note It's not thread safe.
+struct SC::ScratchAllocator : public MemoryAllocator
+{
+    /// @brief Creates the allocator on the given buffer (that must outlive it)
+    explicit ScratchAllocator(Span<char> memory);
+
+    /// @brief Number of bytes of the buffer used by blocks not released yet (including their headers)
+    [[nodiscard]] size_t getBytesUsed() const { return top; }
+
+  private:
+    struct BlockHeader;
+    static constexpr size_t NoBlock = ~static_cast<size_t>(0);
+
+    char*  buffer;
+    size_t capacity;
+    size_t top       = 0;       // Offset of first free byte in buffer
+    size_t lastBlock = NoBlock; // Offset of the header of last allocated block
+
+    static void* allocatorFunction(MemoryAllocator&, Operation, void*, size_t, size_t);
+
+    void* allocateBlock(size_t numBytes);
+    void  releaseBlock(void* memory);
+    bool  owns(const void* memory) const;
+};
+
+/// @brief Allocator of fixed size blocks, obtained in chunks from SC::Memory and recycled through a free list.
+///
+/// Allocating and releasing a block are both `O(1)` and never touch SC::Memory once enough blocks are available.
+/// Allocations larger than the block size fail, and reallocating a block within the block size never moves it
+/// (so a SC::String or SC::Vector of bounded size allocates only once).
+/// @note It's not thread safe.
+struct SC::PoolAllocator : public MemoryAllocator
+{
+    /// @brief Creates the pool, without allocating any memory
+    /// @param blockSize Size of all blocks (rounded up to MemoryAllocator::Alignment)
+    /// @param blocksPerChunk Number of blocks requested to SC::Memory at once
+    explicit PoolAllocator(size_t blockSize, size_t blocksPerChunk = 64);
+
+    /// @brief Releases all chunks to SC::Memory
+    ~PoolAllocator();
+
+    /// @brief Size of the blocks of this pool
+    [[nodiscard]] size_t getBlockSize() const { return blockSize; }
+
+    /// @brief Number of blocks currently allocated
+    [[nodiscard]] size_t getNumBlocksInUse() const { return numBlocksInUse; }
+
+  private:
+    struct Chunk;
+    struct FreeBlock;
+
+    size_t     blockSize;
+    size_t     blocksPerChunk;
+    size_t     numBlocksInUse = 0;
+    Chunk*     chunks         = nullptr;
+    FreeBlock* freeBlocks     = nullptr;
+
+    static void* allocatorFunction(MemoryAllocator&, Operation, void*, size_t, size_t);
+
+    void* allocateBlock(size_t numBytes);
 };
 //! @}
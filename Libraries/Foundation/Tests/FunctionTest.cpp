@@ -24,6 +24,16 @@ struct SC::FunctionTest : public SC::TestCase
         int data = 0;
     };
 
+    struct Tracker
+    {
+        int& numDestroyed;
+        int  numCopies = 0;
+
+        Tracker(int& numDestroyed) : numDestroyed(numDestroyed) {}
+        Tracker(const Tracker& other) : numDestroyed(other.numDestroyed), numCopies(other.numCopies + 1) {}
+        ~Tracker() { numDestroyed++; }
+    };
+
     FunctionTest(SC::TestReport& report) : TestCase(report, "FunctionTest")
     {
         using namespace SC;
@@ -97,6 +107,82 @@ struct SC::FunctionTest : public SC::TestCase
             Function<void(int&)> constReference = [&](const int& val) { SC_TEST_EXPECT(val == 1); };
             constReference(val);
         }
+        if (test_section("inline storage"))
+        {
+            uint64_t values[4] = {1, 2, 3, 4};
+
+            FunctionN<uint64_t(int), 32> sum = [values](int idx) { return values[0] + values[1] + values[idx]; };
+            static_assert(sizeof(sum) == sizeof(void*) * 2 + 32, "FunctionN size");
+            FunctionN<uint64_t(int), 32> sumCopy = sum;
+            FunctionN<uint64_t(int), 32> sumMove = move(sumCopy);
+            SC_TEST_EXPECT(sum(3) == 7);
+            SC_TEST_EXPECT(sumMove(2) == 6);
+            sum = sumMove;
+            SC_TEST_EXPECT(sum(2) == 6);
+
+            // Lambdas that are not trivially copyable are copied, moved and destroyed through their operations
+            int numDestroyed = 0;
+            {
+                Tracker tracker(numDestroyed);
+
+                FunctionN<int(), 32> func = [tracker]() { return tracker.numCopies; };
+                numDestroyed              = 0;
+                FunctionN<int(), 32> funcCopy = func;
+                FunctionN<int(), 32> funcMove = move(func);
+                SC_TEST_EXPECT(funcCopy() == 3);
+                SC_TEST_EXPECT(not func.isValid());
+                SC_TEST_EXPECT(numDestroyed == 1); // moved from lambda
+            }
+            SC_TEST_EXPECT(numDestroyed == 4); // tracker, funcCopy, funcMove
+        }
+        if (test_section("heap"))
+        {
+            uint64_t values[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+            int      numDestroyed = 0;
+            {
+                Tracker tracker(numDestroyed);
+
+                FunctionN<uint64_t(), 16, true> func = [values, tracker]() { return values[7] + values[0]; };
+                numDestroyed                         = 0;
+                FunctionN<uint64_t(), 16, true> funcCopy = func;
+                FunctionN<uint64_t(), 16, true> funcMove = move(func);
+                SC_TEST_EXPECT(not func.isValid());
+                SC_TEST_EXPECT(numDestroyed == 0); // moving transfers ownership of the allocation
+                SC_TEST_EXPECT(funcCopy() == 9);
+                SC_TEST_EXPECT(funcMove() == 9);
+                funcCopy = funcMove;
+                SC_TEST_EXPECT(numDestroyed == 1);
+                funcMove = [] { return uint64_t(1); }; // fits the inline storage
+                SC_TEST_EXPECT(numDestroyed == 2);
+                SC_TEST_EXPECT(funcCopy() == 9);
+                SC_TEST_EXPECT(funcMove() == 1);
+            }
+            SC_TEST_EXPECT(numDestroyed == 4); // tracker, funcCopy
+        }
+        if (test_section("function ref"))
+        {
+            //! [functionRefSnippet]
+            struct Algorithm
+            {
+                static int sumOf(Span<const int> values, FunctionRef<int(int)> transform)
+                {
+                    int sum = 0;
+                    for (int value : values)
+                        sum += transform(value);
+                    return sum;
+                }
+            };
+            int offset = 2;
+            SC_TEST_EXPECT(Algorithm::sumOf({1, 2, 3}, [&](int value) { return value + offset; }) == 12);
+            SC_TEST_EXPECT(Algorithm::sumOf({1, 2, 3}, &TestClass::freeFunc) == 9);
+            //! [functionRefSnippet]
+
+            Function<int(int)>    func = &TestClass::freeFunc2;
+            FunctionRef<int(int)> ref  = func;
+            FunctionRef<int(int)> refCopy = ref;
+            SC_TEST_EXPECT(refCopy(1) == 0);
+            SC_TEST_EXPECT(Algorithm::sumOf({1, 2, 3}, ref) == 3);
+        }
     }
 };
 
@@ -0,0 +1,519 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../LibC.h"
+#include "../Memory.h"
+#include "../../Containers/SmallVector.h"
+#include "../../Containers/Vector.h"
+#include "../../Strings/SmallString.h"
+#include "../../Strings/String.h"
+#include "../../Strings/StringBuilder.h"
+#include "../../Testing/Testing.h"
+#include "../../Threading/Atomic.h"
+#include "../../Threading/Threading.h"
+
+namespace SC
+{
+struct MemoryTest;
+}
+
+struct SC::MemoryTest : public SC::TestCase
+{
+    inline void testAllocate();
+    inline void testReallocate();
+    inline void testStatistics();
+    inline void testThreads();
+    inline void testArenaAllocator();
+    inline void testScratchAllocator();
+    inline void testPoolAllocator();
+    inline void testTagging();
+
+    MemoryTest(SC::TestReport& report) : TestCase(report, "MemoryTest")
+    {
+        if (test_section("allocate"))
+        {
+            testAllocate();
+        }
+        if (test_section("reallocate"))
+        {
+            testReallocate();
+        }
+        if (test_section("statistics"))
+        {
+            testStatistics();
+        }
+        if (test_section("threads"))
+        {
+            testThreads();
+        }
+        if (test_section("arena"))
+        {
+            testArenaAllocator();
+        }
+        if (test_section("scratch"))
+        {
+            testScratchAllocator();
+        }
+        if (test_section("pool"))
+        {
+            testPoolAllocator();
+        }
+        if (test_section("tagging"))
+        {
+            testTagging();
+        }
+    }
+
+    static void fill(void* memory, size_t numBytes, uint8_t seed)
+    {
+        uint8_t* bytes = static_cast<uint8_t*>(memory);
+        for (size_t idx = 0; idx < numBytes; ++idx)
+        {
+            bytes[idx] = static_cast<uint8_t>(seed + idx * 7);
+        }
+    }
+
+    [[nodiscard]] static const MemoryTagStatistics* findTag(Span<const MemoryTagStatistics> statistics,
+                                                            StringView tag)
+    {
+        for (const MemoryTagStatistics& item : statistics)
+        {
+            if (StringView::fromNullTerminated(item.tag, StringEncoding::Ascii) == tag)
+                return &item;
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] static bool check(const void* memory, size_t numBytes, uint8_t seed)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(memory);
+        for (size_t idx = 0; idx < numBytes; ++idx)
+        {
+            if (bytes[idx] != static_cast<uint8_t>(seed + idx * 7))
+                return false;
+        }
+        return true;
+    }
+};
+
+void SC::MemoryTest::testAllocate()
+{
+    // Sizes around boundaries of small size classes and of large allocations
+    const size_t sizes[] = {0, 1, 15, 16, 17, 128, 129, 1000, 4096, 8191, 8192, 8193, 65536, 300 * 1024, 3000 * 1024};
+    void*        allocations[sizeof(sizes) / sizeof(sizes[0])];
+    for (size_t idx = 0; idx < sizeof(sizes) / sizeof(sizes[0]); ++idx)
+    {
+        allocations[idx] = Memory::allocate(sizes[idx]);
+        SC_TEST_EXPECT(allocations[idx] != nullptr);
+        SC_TEST_EXPECT((reinterpret_cast<size_t>(allocations[idx]) & 15) == 0);
+        fill(allocations[idx], sizes[idx], static_cast<uint8_t>(idx));
+    }
+    for (size_t idx = 0; idx < sizeof(sizes) / sizeof(sizes[0]); ++idx)
+    {
+        SC_TEST_EXPECT(check(allocations[idx], sizes[idx], static_cast<uint8_t>(idx)));
+        Memory::release(allocations[idx]);
+    }
+    Memory::release(nullptr);
+
+    // Released blocks are reused
+    void* blocks[1000];
+    for (void*& block : blocks)
+    {
+        block = Memory::allocate(48);
+        SC_TEST_EXPECT(block != nullptr);
+        fill(block, 48, 3);
+    }
+    for (void* block : blocks)
+    {
+        SC_TEST_EXPECT(check(block, 48, 3));
+        Memory::release(block);
+    }
+}
+
+void SC::MemoryTest::testReallocate()
+{
+    // Grows a block from a small size class up to a large allocation and back, checking that contents are preserved
+    size_t numBytes = 10;
+    void*  memory   = Memory::reallocate(nullptr, numBytes);
+    SC_TEST_EXPECT(memory != nullptr);
+    fill(memory, numBytes, 42);
+    while (numBytes < 1024 * 1024)
+    {
+        const size_t newSize = numBytes * 3 / 2;
+        memory               = Memory::reallocate(memory, newSize);
+        SC_TEST_EXPECT(memory != nullptr);
+        SC_TEST_EXPECT(check(memory, numBytes, 42));
+        numBytes = newSize;
+        fill(memory, numBytes, 42);
+    }
+    while (numBytes > 10)
+    {
+        numBytes = numBytes / 3;
+        memory   = Memory::reallocate(memory, numBytes);
+        SC_TEST_EXPECT(memory != nullptr);
+        SC_TEST_EXPECT(check(memory, numBytes, 42));
+    }
+    Memory::release(memory);
+}
+
+void SC::MemoryTest::testStatistics()
+{
+    //! [memoryStatisticsSnippet]
+    MemoryStatistics before;
+    if (not Memory::getStatistics(before))
+    {
+        // Statistics are available only when SC_MEMORY_CACHING_ALLOCATOR is defined to 1
+        SC_TEST_EXPECT(SC_MEMORY_CACHING_ALLOCATOR == 0);
+        return;
+    }
+    constexpr size_t NumBlocks = 100;
+    void*            blocks[NumBlocks];
+    for (void*& block : blocks)
+    {
+        block = Memory::allocate(40); // Rounded to the 48 bytes size class
+    }
+    void* large = Memory::allocate(100 * 1024);
+
+    MemoryStatistics during;
+    SC_TEST_EXPECT(Memory::getStatistics(during));
+    for (void* block : blocks)
+    {
+        Memory::release(block);
+    }
+    Memory::release(large);
+
+    MemoryStatistics after;
+    SC_TEST_EXPECT(Memory::getStatistics(after));
+    //! [memoryStatisticsSnippet]
+
+    // Other threads (if any) could allocate in the meantime, so only lower bounds can be checked
+    const MemoryStatistics::SizeClass& sizeClass = during.sizeClasses[2];
+    SC_TEST_EXPECT(sizeClass.blockSize == 48);
+    SC_TEST_EXPECT(sizeClass.numAllocations >= before.sizeClasses[2].numAllocations + NumBlocks);
+    SC_TEST_EXPECT(after.sizeClasses[2].numReleases >= during.sizeClasses[2].numReleases + NumBlocks);
+    SC_TEST_EXPECT(during.numLargeAllocations >= before.numLargeAllocations + 1);
+    SC_TEST_EXPECT(after.numLargeReleases >= during.numLargeReleases + 1);
+    SC_TEST_EXPECT(during.bytesInUse >= NumBlocks * 48 + 100 * 1024);
+    SC_TEST_EXPECT(during.peakBytesInUse >= during.bytesInUse);
+    SC_TEST_EXPECT(after.peakBytesInUse >= during.bytesInUse);
+    SC_TEST_EXPECT(during.bytesMapped >= during.bytesInUse);
+    SC_TEST_EXPECT(during.numThreadCaches >= 1);
+
+    // Size classes are sorted and the largest one is 8 KB
+    for (size_t idx = 1; idx < MemoryStatistics::NumSizeClasses; ++idx)
+    {
+        SC_TEST_EXPECT(after.sizeClasses[idx].blockSize > after.sizeClasses[idx - 1].blockSize);
+    }
+    SC_TEST_EXPECT(after.sizeClasses[MemoryStatistics::NumSizeClasses - 1].blockSize == 8192);
+}
+
+void SC::MemoryTest::testThreads()
+{
+    // Threads allocate blocks of random sizes, releasing half of them immediately and exchanging the other half with
+    // other threads through a shared array, so that blocks are often released by a thread different from the one that
+    // has allocated them. Blocks are filled with a pattern that is checked before releasing them.
+    static constexpr int NumThreads    = 4;
+    static constexpr int NumIterations = 20000;
+    static constexpr int NumSlots      = 64;
+
+    struct Shared
+    {
+        Atomic<void*>   slots[NumSlots];
+        Atomic<int32_t> numErrors = 0;
+    };
+    struct Worker
+    {
+        Shared* shared = nullptr;
+        int     index  = 0;
+        Thread  thread;
+    };
+    Shared shared;
+    for (Atomic<void*>& slot : shared.slots)
+    {
+        slot.store(nullptr);
+    }
+    Worker workers[NumThreads];
+    for (int idx = 0; idx < NumThreads; ++idx)
+    {
+        workers[idx].shared = &shared;
+        workers[idx].index  = idx;
+        SC_TEST_EXPECT(workers[idx].thread.start(
+            [&worker = workers[idx]](Thread&)
+            {
+                Shared&  shared = *worker.shared;
+                uint32_t random = static_cast<uint32_t>(worker.index) * 2654435761u + 1;
+                for (int iteration = 0; iteration < NumIterations; ++iteration)
+                {
+                    random ^= random << 13;
+                    random ^= random >> 17;
+                    random ^= random << 5;
+                    // Mostly small sizes, with some large ones
+                    const uint32_t numBytes = (random % 64) == 0 ? 8192 + random % 100000 : 8 + random % 2048;
+
+                    uint8_t* memory = static_cast<uint8_t*>(Memory::allocate(numBytes));
+                    if (memory == nullptr)
+                    {
+                        shared.numErrors.fetch_add(1);
+                        continue;
+                    }
+                    // Size of the block followed by a marker byte, to detect blocks overlapping other blocks
+                    ::memcpy(memory, &numBytes, sizeof(numBytes));
+                    fill(memory + sizeof(numBytes), numBytes - sizeof(numBytes), static_cast<uint8_t>(random));
+                    if ((random & 1) == 0)
+                    {
+                        Memory::release(memory);
+                        continue;
+                    }
+                    uint8_t* previous = static_cast<uint8_t*>(shared.slots[random % NumSlots].exchange(memory));
+                    if (previous != nullptr)
+                    {
+                        uint32_t previousBytes;
+                        ::memcpy(&previousBytes, previous, sizeof(previousBytes));
+                        const uint8_t seed = previous[sizeof(previousBytes)];
+                        if (not check(previous + sizeof(previousBytes), previousBytes - sizeof(previousBytes), seed))
+                        {
+                            shared.numErrors.fetch_add(1);
+                        }
+                        Memory::release(previous);
+                    }
+                }
+            }));
+    }
+    for (Worker& worker : workers)
+    {
+        SC_TEST_EXPECT(worker.thread.join());
+    }
+    for (Atomic<void*>& slot : shared.slots)
+    {
+        Memory::release(slot.exchange(nullptr));
+    }
+    SC_TEST_EXPECT(shared.numErrors.load() == 0);
+}
+
+void SC::MemoryTest::testArenaAllocator()
+{
+    //! [arenaAllocatorSnippet]
+    ArenaAllocator arena(1024);
+    for (int request = 0; request < 3; ++request)
+    {
+        // All containers of the request allocate from the arena, and they're freed at once by reset
+        Vector<int> numbers(arena);
+        String      text(arena);
+        for (int idx = 0; idx < 1000; ++idx)
+        {
+            SC_TEST_EXPECT(numbers.push_back(idx));
+        }
+        SC_TEST_EXPECT(StringBuilder(text).format("Request {} has {} numbers", request, numbers.size()));
+        SC_TEST_EXPECT(numbers.getAllocator() == &arena);
+        SC_TEST_EXPECT(text.view().startsWith("Request ") and text.view().endsWith(" has 1000 numbers"));
+        SC_TEST_EXPECT(numbers[999] == 999);
+        SC_TEST_EXPECT(arena.getBytesUsed() >= 1000 * sizeof(int));
+
+        // Moving transfers memory together with its allocator
+        Vector<int> moved = move(numbers);
+        SC_TEST_EXPECT(moved.getAllocator() == &arena and moved.size() == 1000);
+        // Copies allocate from SC::Memory
+        Vector<int> copy = moved;
+        SC_TEST_EXPECT(copy.getAllocator() == nullptr and copy.size() == 1000);
+        arena.reset();
+    }
+    //! [arenaAllocatorSnippet]
+    SC_TEST_EXPECT(arena.getBytesUsed() == 0);
+
+    // Growing the last allocated block happens in place
+    void* first = arena.allocate(10);
+    void* block = arena.allocate(100);
+    SC_TEST_EXPECT(first != nullptr and block != nullptr);
+    SC_TEST_EXPECT((reinterpret_cast<size_t>(block) & (MemoryAllocator::Alignment - 1)) == 0);
+    fill(block, 100, 5);
+    SC_TEST_EXPECT(arena.reallocate(block, 100, 500) == block);
+    SC_TEST_EXPECT(check(block, 100, 5));
+    // Growing a block that is not the last one moves it
+    void* moved = arena.reallocate(first, 10, 20);
+    SC_TEST_EXPECT(moved != nullptr and moved != first);
+    // Blocks larger than chunk size get their own chunk
+    void* large = arena.allocate(10000);
+    SC_TEST_EXPECT(large != nullptr);
+    fill(large, 10000, 7);
+    SC_TEST_EXPECT(check(block, 100, 5) and check(large, 10000, 7));
+
+    struct Point
+    {
+        int x, y;
+        Point(int x, int y) : x(x), y(y) {}
+    };
+    Point* point = arena.create<Point>(1, 2);
+    SC_TEST_EXPECT(point != nullptr and point->x == 1 and point->y == 2);
+}
+
+void SC::MemoryTest::testScratchAllocator()
+{
+    //! [scratchAllocatorSnippet]
+    char             buffer[1024];
+    ScratchAllocator scratch({buffer, sizeof(buffer)});
+    {
+        String path(scratch);
+        SC_TEST_EXPECT(StringBuilder(path).format("{}/{}", "directory", "file.txt"));
+        SC_TEST_EXPECT(path.view() == "directory/file.txt");
+        SC_TEST_EXPECT(scratch.getBytesUsed() > 0);
+    } // Memory is given back to the buffer
+    SC_TEST_EXPECT(scratch.getBytesUsed() == 0);
+    //! [scratchAllocatorSnippet]
+
+    // Blocks released out of order are reclaimed when all following blocks are released
+    void* block1 = scratch.allocate(100);
+    void* block2 = scratch.allocate(100);
+    void* block3 = scratch.allocate(100);
+    SC_TEST_EXPECT(block1 != nullptr and block2 != nullptr and block3 != nullptr);
+    SC_TEST_EXPECT((reinterpret_cast<size_t>(block2) & (MemoryAllocator::Alignment - 1)) == 0);
+    const size_t usedAfterTwo = scratch.getBytesUsed();
+    scratch.release(block2, 100);
+    SC_TEST_EXPECT(scratch.getBytesUsed() == usedAfterTwo);
+    scratch.release(block3, 100);
+    SC_TEST_EXPECT(scratch.getBytesUsed() < usedAfterTwo);
+    fill(block1, 100, 1);
+    // The last block grows in place, while it fits in the buffer
+    SC_TEST_EXPECT(scratch.reallocate(block1, 100, 500) == block1);
+    SC_TEST_EXPECT(check(block1, 100, 1));
+    // When the buffer is full, blocks are obtained from SC::Memory
+    void* grown = scratch.reallocate(block1, 500, 4000);
+    SC_TEST_EXPECT(grown != nullptr and grown != block1);
+    SC_TEST_EXPECT(check(grown, 100, 1));
+    SC_TEST_EXPECT(scratch.getBytesUsed() == 0);
+    void* outside = scratch.allocate(2000);
+    SC_TEST_EXPECT(outside != nullptr);
+    scratch.release(outside, 2000);
+    scratch.release(grown, 4000);
+
+    Vector<int> numbers(scratch);
+    for (int idx = 0; idx < 1000; ++idx)
+    {
+        SC_TEST_EXPECT(numbers.push_back(idx));
+    }
+    SC_TEST_EXPECT(numbers.size() == 1000 and numbers[500] == 500);
+}
+
+void SC::MemoryTest::testPoolAllocator()
+{
+    //! [poolAllocatorSnippet]
+    PoolAllocator pool(64, 4);
+    {
+        Vector<String> names;
+        for (int idx = 0; idx < 10; ++idx)
+        {
+            String name(pool);
+            SC_TEST_EXPECT(StringBuilder(name).format("Name {}", idx));
+            SC_TEST_EXPECT(names.push_back(move(name)));
+        }
+        SC_TEST_EXPECT(pool.getNumBlocksInUse() == 10);
+        SC_TEST_EXPECT(names[9].view() == "Name 9");
+    }
+    SC_TEST_EXPECT(pool.getNumBlocksInUse() == 0);
+    //! [poolAllocatorSnippet]
+
+    // Released blocks are reused, reallocating within block size doesn't move and larger allocations fail
+    void* block = pool.allocate(10);
+    SC_TEST_EXPECT(block != nullptr);
+    pool.release(block, 10);
+    void* reused = pool.allocate(20);
+    SC_TEST_EXPECT(reused == block);
+    SC_TEST_EXPECT(pool.reallocate(reused, 20, pool.getBlockSize()) == reused);
+    SC_TEST_EXPECT(pool.reallocate(reused, 20, pool.getBlockSize() + 1) == nullptr);
+    SC_TEST_EXPECT(pool.allocate(pool.getBlockSize() + 1) == nullptr);
+    pool.release(reused, 20);
+
+    {
+        Vector<int> numbers(pool);
+        SC_TEST_EXPECT(pool.getNumBlocksInUse() == 1); // The header remembering the allocator
+        SC_TEST_EXPECT(numbers.reserve(4));
+        SC_TEST_EXPECT(not numbers.reserve(1000));
+        SC_TEST_EXPECT(numbers.capacity() == 4);
+
+        // Shrinking an empty vector keeps its allocator
+        SC_TEST_EXPECT(numbers.push_back(1));
+        numbers.clear();
+        SC_TEST_EXPECT(numbers.shrink_to_fit());
+        SC_TEST_EXPECT(numbers.capacity() == 0 and numbers.getAllocator() == &pool);
+        SC_TEST_EXPECT(numbers.push_back(2) and pool.getNumBlocksInUse() == 1);
+
+        // A moved-from vector falls back to SC::Memory
+        Vector<int> moved = move(numbers);
+        SC_TEST_EXPECT(moved.getAllocator() == &pool and numbers.getAllocator() == nullptr);
+        SC_TEST_EXPECT(numbers.push_back(3) and numbers.getAllocator() == nullptr);
+        SC_TEST_EXPECT(pool.getNumBlocksInUse() == 1);
+    }
+    SC_TEST_EXPECT(pool.getNumBlocksInUse() == 0);
+}
+
+void SC::MemoryTest::testTagging()
+{
+    //! [memoryTaggingSnippet]
+    MemoryTagStatistics statistics[64];
+    size_t              numStatistics = 0;
+    {
+        SC_MEMORY_TAG("MemoryTest.parser"); // Attributes to the tag all containers allocated in this scope
+        Vector<int> tokens;
+        SC_TEST_EXPECT(tokens.reserve(100)); // Growth policy and reserve can leave unused capacity
+        SC_TEST_EXPECT(tokens.resize(10));
+        SmallVector<int, 4> small;
+        SC_TEST_EXPECT(small.resize(3)); // Fits in the inline buffer
+        SmallString<8> spilled = "a string longer than 8 bytes"; // Moves to the heap
+
+        if (not Memory::getTagStatistics({statistics, 64}, numStatistics))
+        {
+            // Statistics are available only when SC_MEMORY_TAGGING is defined to 1
+            SC_TEST_EXPECT(SC_MEMORY_TAGGING == 0);
+            return;
+        }
+    } // small is destroyed while using its inline buffer
+    //! [memoryTaggingSnippet]
+    const MemoryTagStatistics* parser = findTag({statistics, numStatistics}, "MemoryTest.parser");
+    SC_TEST_EXPECT(parser != nullptr);
+    if (parser == nullptr)
+        return;
+    SC_TEST_EXPECT(StringView::fromNullTerminated(parser->file, StringEncoding::Ascii).endsWith("MemoryTest.cpp"));
+    SC_TEST_EXPECT(parser->line > 0);
+    SC_TEST_EXPECT(parser->numAllocations == 2 and parser->numReleases == 0);
+    SC_TEST_EXPECT(parser->numSmallVectorSpills == 1);
+    SC_TEST_EXPECT(parser->capacityBytes >= 100 * sizeof(int) + 29);
+    SC_TEST_EXPECT(parser->sizeBytes == 10 * sizeof(int) + 29); // String size includes the null terminator
+    SC_TEST_EXPECT(parser->getWastedBytes() >= 90 * sizeof(int));
+    SC_TEST_EXPECT(parser->bytesInUse > parser->capacityBytes); // Includes segment headers
+    SC_TEST_EXPECT(parser->peakBytesInUse >= parser->bytesInUse);
+
+    // Segments released or grown out of their scope still belong to the site that allocated them
+    Vector<int> outlived;
+    {
+        SC_MEMORY_TAG("MemoryTest.lexer");
+        SC_TEST_EXPECT(outlived.resize(10));
+    }
+    {
+        SC_MEMORY_TAG("MemoryTest.shared");
+        SC_TEST_EXPECT(outlived.resize(1000));
+        String text = "some text";
+        {
+            SC_MEMORY_TAG("MemoryTest.shared"); // Same tag, different site
+            Vector<char> bytes;
+            SC_TEST_EXPECT(bytes.resize(50));
+            SC_TEST_EXPECT(Memory::getTagStatistics({statistics, 64}, numStatistics, true));
+        }
+    }
+    const MemoryTagStatistics* lexer  = findTag({statistics, numStatistics}, "MemoryTest.lexer");
+    const MemoryTagStatistics* shared = findTag({statistics, numStatistics}, "MemoryTest.shared");
+    parser                            = findTag({statistics, numStatistics}, "MemoryTest.parser");
+    SC_TEST_EXPECT(lexer != nullptr and shared != nullptr and parser != nullptr);
+    if (lexer == nullptr or shared == nullptr or parser == nullptr)
+        return;
+    SC_TEST_EXPECT(lexer->file == nullptr and lexer->line == 0); // Grouped by tag
+    SC_TEST_EXPECT(lexer->numAllocations == 2 and lexer->sizeBytes == 1000 * sizeof(int));
+    SC_TEST_EXPECT(shared->numAllocations == 2 and shared->sizeBytes == 10 + 50);
+    SC_TEST_EXPECT(parser->numReleases == 2 and parser->bytesInUse == 0 and parser->capacityBytes == 0);
+    SC_TEST_EXPECT(parser->numSmallVectorInline == 1);
+
+    // Memory allocated outside of any scope goes to the untagged site
+    SC_TEST_EXPECT(findTag({statistics, numStatistics}, "untagged") != nullptr);
+}
+
+namespace SC
+{
+void runMemoryTest(SC::TestReport& report) { MemoryTest test(report); }
+} // namespace SC
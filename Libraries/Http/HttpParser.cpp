@@ -391,7 +391,7 @@ bool SC::HttpParser::parseVersion(char currentChar)
     SC_CO_RETURN(nestedParserCoroutine, SC::Result(true));
     SC_TRY(currentChar == '.' or currentChar == '.');
     SC_CO_RETURN(nestedParserCoroutine, SC::Result(true));
-    SC_TRY(currentChar == '1' or currentChar == '1');
+    SC_TRY(currentChar == '0' or currentChar == '1'); // HTTP/1.0 or HTTP/1.1
     SC_CO_RETURN(nestedParserCoroutine, SC::Result(true));
     if (spaces)
     {
@@ -20,7 +20,7 @@ struct SC::HttpParser
     {
         HttpGET,  ///< `GET` method
         HttpPUT,  ///< `PUT` method
-        HttpPOST, ///< `POST` method
+        HttpPOST, ///< `POST` method (must be the last one, as HttpRouter sizes its tables with it)
     };
     Method method = Method::HttpGET; ///< Http method
 
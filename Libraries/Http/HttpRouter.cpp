@@ -0,0 +1,373 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "HttpRouter.h"
+#include "../Foundation/LibC.h" // memcmp
+
+struct SC::HttpRouter::Internal
+{
+    [[nodiscard]] static uint32_t pushNode(HttpRouter& router, size_t labelStart, size_t labelLength)
+    {
+        Node node;
+        node.labelStart  = static_cast<uint32_t>(labelStart);
+        node.labelLength = static_cast<uint32_t>(labelLength);
+        if (not router.nodes.push_back(node))
+        {
+            return InvalidIndex;
+        }
+        return static_cast<uint32_t>(router.nodes.size() - 1);
+    }
+
+    // Checks everything that depends only on the pattern, so that addRoute fails before modifying the trie
+    [[nodiscard]] static Result validatePattern(StringView pattern)
+    {
+        const char*  text          = pattern.bytesWithoutTerminator();
+        const size_t length        = pattern.sizeInBytes();
+        size_t       numParameters = 0;
+        for (size_t pos = 1; pos < length; ++pos)
+        {
+            if (text[pos] == ':')
+            {
+                SC_TRY_MSG(text[pos - 1] == '/', "HttpRouter::addRoute - Parameter must start a segment");
+                size_t nameEnd = pos + 1;
+                while (nameEnd < length and text[nameEnd] != '/')
+                {
+                    nameEnd++;
+                }
+                SC_TRY_MSG(nameEnd > pos + 1, "HttpRouter::addRoute - Empty parameter name");
+                SC_TRY_MSG(++numParameters <= MaxParameters, "HttpRouter::addRoute - Too many parameters");
+                pos = nameEnd - 1; // Name extends until the end of the segment
+            }
+            else if (text[pos] == '*')
+            {
+                SC_TRY_MSG(text[pos - 1] == '/' and pos + 1 == length,
+                           "HttpRouter::addRoute - Wildcard must be the last segment");
+            }
+        }
+        return Result(true);
+    }
+
+    [[nodiscard]] static Result insertRoute(HttpRouter& router, size_t methodIndex, size_t patternStart,
+                                            Handler&& handler)
+    {
+        const size_t patternEnd = router.labels.size();
+
+        uint32_t current = 0;
+        size_t   pos     = patternStart;
+        while (pos < patternEnd)
+        {
+            const char* text = router.labels.data();
+            if (text[pos] == ':')
+            {
+                size_t nameEnd = pos + 1;
+                while (nameEnd < patternEnd and text[nameEnd] != '/')
+                {
+                    nameEnd++;
+                }
+                const size_t nameLength = nameEnd - pos - 1;
+                uint32_t     parameter  = router.nodes[current].parameter;
+                if (parameter == InvalidIndex)
+                {
+                    parameter = pushNode(router, pos + 1, nameLength);
+                    SC_TRY_MSG(parameter != InvalidIndex, "HttpRouter::addRoute - Out of memory");
+                    router.nodes[current].parameter = parameter;
+                }
+                else
+                {
+                    const Node& existing = router.nodes[parameter];
+                    SC_TRY_MSG(existing.labelLength == nameLength and
+                                   ::memcmp(text + existing.labelStart, text + pos + 1, nameLength) == 0,
+                               "HttpRouter::addRoute - Conflicting parameter name");
+                }
+                current = parameter;
+                pos     = nameEnd;
+            }
+            else if (text[pos] == '*')
+            {
+                uint32_t wildcard = router.nodes[current].wildcard;
+                if (wildcard == InvalidIndex)
+                {
+                    wildcard = pushNode(router, pos, 0);
+                    SC_TRY_MSG(wildcard != InvalidIndex, "HttpRouter::addRoute - Out of memory");
+                    router.nodes[current].wildcard = wildcard;
+                }
+                current = wildcard;
+                pos     = patternEnd;
+            }
+            else
+            {
+                size_t runEnd = pos;
+                while (runEnd < patternEnd and text[runEnd] != ':' and text[runEnd] != '*')
+                {
+                    runEnd++;
+                }
+                SC_TRY(insertStatic(router, current, pos, runEnd));
+            }
+        }
+        SC_TRY_MSG(router.nodes[current].handlers[methodIndex] == InvalidIndex,
+                   "HttpRouter::addRoute - Route already exists");
+        SC_TRY_MSG(router.handlers.push_back(move(handler)), "HttpRouter::addRoute - Out of memory");
+        router.nodes[current].handlers[methodIndex] = static_cast<uint32_t>(router.handlers.size() - 1);
+        return Result(true);
+    }
+
+    [[nodiscard]] static Result insertStatic(HttpRouter& router, uint32_t& current, size_t& pos, size_t runEnd)
+    {
+        const char* text = router.labels.data();
+
+        // Static siblings are guaranteed to start with a different character
+        uint32_t childIndex = router.nodes[current].firstChild;
+        while (childIndex != InvalidIndex and text[router.nodes[childIndex].labelStart] != text[pos])
+        {
+            childIndex = router.nodes[childIndex].nextSibling;
+        }
+
+        if (childIndex == InvalidIndex)
+        {
+            const uint32_t newIndex = pushNode(router, pos, runEnd - pos);
+            SC_TRY_MSG(newIndex != InvalidIndex, "HttpRouter::addRoute - Out of memory");
+            router.nodes[newIndex].nextSibling = router.nodes[current].firstChild;
+            router.nodes[current].firstChild   = newIndex;
+
+            current = newIndex;
+            pos     = runEnd;
+            return Result(true);
+        }
+
+        const Node child  = router.nodes[childIndex];
+        size_t     common = 0;
+        while (common < child.labelLength and pos + common < runEnd and
+               text[child.labelStart + common] == text[pos + common])
+        {
+            common++;
+        }
+
+        if (common < child.labelLength)
+        {
+            // Split the edge: child keeps the common prefix, the new node inherits the remaining suffix
+            Node suffix        = child;
+            suffix.labelStart  = child.labelStart + static_cast<uint32_t>(common);
+            suffix.labelLength = child.labelLength - static_cast<uint32_t>(common);
+            suffix.nextSibling = InvalidIndex;
+            SC_TRY_MSG(router.nodes.push_back(suffix), "HttpRouter::addRoute - Out of memory");
+
+            Node& prefix       = router.nodes[childIndex];
+            prefix             = Node();
+            prefix.labelStart  = child.labelStart;
+            prefix.labelLength = static_cast<uint32_t>(common);
+            prefix.nextSibling = child.nextSibling;
+            prefix.firstChild  = static_cast<uint32_t>(router.nodes.size() - 1);
+        }
+        current = childIndex;
+        pos += common;
+        return Result(true);
+    }
+
+    [[nodiscard]] static bool matchNode(const HttpRouter& router, uint32_t nodeIndex, const char* path, size_t length,
+                                        size_t method, Match& match, uint32_t& handlerIndex, uint32_t& allowedMethods)
+    {
+        const Node& node = router.nodes[nodeIndex];
+        const char* text = router.labels.data();
+        if (length == 0)
+        {
+            if (node.handlers[method] != InvalidIndex)
+            {
+                handlerIndex = node.handlers[method];
+                return true;
+            }
+            for (size_t idx = 0; idx < NumMethods; ++idx)
+            {
+                allowedMethods |= node.handlers[idx] != InvalidIndex ? 1u << idx : 0;
+            }
+        }
+        else
+        {
+            // Static children have priority
+            for (uint32_t childIndex = node.firstChild; childIndex != InvalidIndex;)
+            {
+                const Node& child = router.nodes[childIndex];
+                if (text[child.labelStart] == path[0])
+                {
+                    if (child.labelLength <= length and ::memcmp(text + child.labelStart, path, child.labelLength) == 0)
+                    {
+                        if (matchNode(router, childIndex, path + child.labelLength, length - child.labelLength,
+                                      method, match, handlerIndex, allowedMethods))
+                        {
+                            return true;
+                        }
+                    }
+                    break; // No other sibling can start with the same character
+                }
+                childIndex = child.nextSibling;
+            }
+
+            // Then parameters
+            if (node.parameter != InvalidIndex and match.numParameters < MaxParameters)
+            {
+                size_t segmentLength = 0;
+                while (segmentLength < length and path[segmentLength] != '/')
+                {
+                    segmentLength++;
+                }
+                if (segmentLength > 0)
+                {
+                    const Node& parameterNode = router.nodes[node.parameter];
+                    Parameter&  parameter     = match.parameters[match.numParameters++];
+
+                    parameter.name  = StringView({text + parameterNode.labelStart, parameterNode.labelLength}, false,
+                                                 StringEncoding::Ascii);
+                    parameter.value = StringView({path, segmentLength}, false, StringEncoding::Ascii);
+                    if (matchNode(router, node.parameter, path + segmentLength, length - segmentLength, method, match,
+                                  handlerIndex, allowedMethods))
+                    {
+                        return true;
+                    }
+                    match.numParameters--;
+                }
+            }
+        }
+
+        // Wildcard matches anything left (including an empty remainder)
+        if (node.wildcard != InvalidIndex)
+        {
+            const Node& wildcardNode = router.nodes[node.wildcard];
+            if (wildcardNode.handlers[method] != InvalidIndex)
+            {
+                match.wildcard = StringView({path, length}, false, StringEncoding::Ascii);
+                handlerIndex   = wildcardNode.handlers[method];
+                return true;
+            }
+            for (size_t idx = 0; idx < NumMethods; ++idx)
+            {
+                allowedMethods |= wildcardNode.handlers[idx] != InvalidIndex ? 1u << idx : 0;
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] static const Handler* find(const HttpRouter& router, HttpParser::Method method, StringView url,
+                                             Match& match, uint32_t& allowedMethods)
+    {
+        match          = Match();
+        allowedMethods = 0;
+
+        const size_t methodIndex = static_cast<size_t>(method);
+        if (router.nodes.isEmpty() or methodIndex >= NumMethods)
+        {
+            return nullptr;
+        }
+        const char* path   = url.bytesWithoutTerminator();
+        size_t      length = url.sizeInBytes();
+        for (size_t idx = 0; idx < length; ++idx)
+        {
+            if (path[idx] == '?')
+            {
+                match.query = StringView({path + idx + 1, length - idx - 1}, false, StringEncoding::Ascii);
+                length      = idx;
+                break;
+            }
+        }
+        uint32_t handlerIndex = InvalidIndex;
+        if (matchNode(router, 0, path, length, methodIndex, match, handlerIndex, allowedMethods))
+        {
+            return &router.handlers[handlerIndex];
+        }
+        return nullptr;
+    }
+};
+
+bool SC::HttpRouter::Match::getParameter(StringView name, StringView& value) const
+{
+    for (size_t idx = 0; idx < numParameters; ++idx)
+    {
+        if (parameters[idx].name == name)
+        {
+            value = parameters[idx].value;
+            return true;
+        }
+    }
+    return false;
+}
+
+SC::Result SC::HttpRouter::addRoute(HttpParser::Method method, StringView pattern, Handler&& handler)
+{
+    const size_t methodIndex = static_cast<size_t>(method);
+    SC_TRY_MSG(methodIndex < NumMethods, "HttpRouter::addRoute - Invalid method");
+    SC_TRY_MSG(pattern.getEncoding() != StringEncoding::Utf16, "HttpRouter::addRoute - UTF16 pattern");
+    SC_TRY_MSG(pattern.startsWithAnyOf({'/'}), "HttpRouter::addRoute - Pattern must start with '/'");
+    SC_TRY(Internal::validatePattern(pattern));
+    if (nodes.isEmpty())
+    {
+        SC_TRY_MSG(Internal::pushNode(*this, 0, 0) == 0, "HttpRouter::addRoute - Out of memory");
+    }
+
+    // Pattern is copied once in labels and all nodes created for it just reference sub-ranges of it
+    const size_t patternStart = labels.size();
+    const size_t numNodes     = nodes.size();
+    SC_TRY_MSG(labels.append(pattern.toCharSpan()), "HttpRouter::addRoute - Out of memory");
+
+    const Result res = Internal::insertRoute(*this, methodIndex, patternStart, move(handler));
+    if (not res and nodes.size() == numNodes)
+    {
+        // A valid pattern can only conflict with existing routes before adding or splitting any node, so the trie is
+        // unchanged and its copy of the pattern can be dropped (nodes added before running out of memory keep it)
+        (void)labels.resize(patternStart);
+    }
+    return res;
+}
+
+const SC::HttpRouter::Handler* SC::HttpRouter::find(HttpParser::Method method, StringView url, Match& match,
+                                                    bool& methodNotAllowed) const
+{
+    uint32_t       allowedMethods = 0;
+    const Handler* handler        = Internal::find(*this, method, url, match, allowedMethods);
+    methodNotAllowed              = allowedMethods != 0;
+    return handler;
+}
+
+SC::Result SC::HttpRouter::dispatch(HttpServerBase::ClientChannel& client) const
+{
+    Match    match;
+    uint32_t allowedMethods = 0;
+
+    const Handler* handler =
+        Internal::find(*this, client.request.parser.method, client.request.url, match, allowedMethods);
+    if (handler != nullptr)
+    {
+        (*handler)(client, match);
+        return Result(true);
+    }
+    if (allowedMethods == 0)
+    {
+        SC_TRY(client.response.startResponse(404));
+        return client.response.end("");
+    }
+    // A 405 response must list the methods supported by the resource in the Allow header (RFC 9110 15.5.6)
+    static constexpr StringView methodNames[] = {"GET", "PUT", "POST"};
+    static_assert(sizeof(methodNames) / sizeof(methodNames[0]) == NumMethods, "Missing method names");
+
+    char   allow[sizeof("GET, PUT, POST")];
+    size_t length = 0;
+    for (size_t idx = 0; idx < NumMethods; ++idx)
+    {
+        if ((allowedMethods & (1u << idx)) != 0)
+        {
+            if (length > 0)
+            {
+                ::memcpy(allow + length, ", ", 2);
+                length += 2;
+            }
+            ::memcpy(allow + length, methodNames[idx].bytesWithoutTerminator(), methodNames[idx].sizeInBytes());
+            length += methodNames[idx].sizeInBytes();
+        }
+    }
+    SC_TRY(client.response.startResponse(405));
+    SC_TRY(client.response.addHeader("Allow", StringView({allow, length}, false, StringEncoding::Ascii)));
+    return client.response.end("");
+}
+
+void SC::HttpRouter::clear()
+{
+    nodes.clear();
+    labels.clear();
+    handlers.clear();
+}
@@ -0,0 +1,117 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "../Containers/Vector.h"
+#include "../Foundation/Function.h"
+#include "../Strings/StringView.h"
+#include "HttpServer.h"
+
+namespace SC
+{
+struct HttpRouter;
+} // namespace SC
+
+//! @addtogroup group_http
+//! @{
+
+/// @brief Dispatches requests to handlers registered for a method and a path pattern, using a radix trie.
+/// Patterns are made of static text, named parameter segments (`:name`) and an optional trailing wildcard (`*`):
+/// - `/users` matches only `/users`
+/// - `/users/:id/posts/:post` matches `/users/12/posts/3` extracting `id = 12` and `post = 3`
+/// - `/static/*` matches `/static/css/main.css` extracting `css/main.css` as wildcard
+///
+/// Static segments take priority over parameters that in turn take priority over wildcards.
+/// All patterns are merged in a single radix trie, so that lookup cost depends only on the url length and on the
+/// number of siblings sharing a common prefix, but not on the total number of registered routes.
+/// Parameters and wildcard are returned as StringView pointing inside the url (that is stored in
+/// HttpServerBase::Request::headerBuffer) so that matching a request doesn't allocate any memory.
+/// Query string (anything after `?`) is excluded from matching and returned separately.
+///
+/// Example:
+/// @snippet Libraries/Http/Tests/HttpRouterTest.cpp HttpRouterSnippet
+struct SC::HttpRouter
+{
+    /// @brief Maximum number of parameters that can be extracted from a single route
+    static constexpr size_t MaxParameters = 8;
+
+    /// @brief A named parameter extracted from the url
+    struct Parameter
+    {
+        StringView name;  ///< Name of the parameter as written in the pattern (without `:`)
+        StringView value; ///< Value of the parameter, pointing inside the matched url
+    };
+
+    /// @brief Outcome of matching an url against all registered routes
+    struct Match
+    {
+        Parameter parameters[MaxParameters]; ///< Parameters extracted from the url
+        size_t    numParameters = 0;         ///< Number of valid entries in parameters
+
+        StringView wildcard; ///< Portion of the url matched by a trailing `*`
+        StringView query;    ///< Query string following `?` (excluding the `?`)
+
+        /// @brief Finds a parameter by name
+        /// @param name Name of the parameter (without `:`)
+        /// @param value A StringView pointing inside the url with value of the parameter
+        /// @return `true` if the parameter has been found
+        [[nodiscard]] bool getParameter(StringView name, StringView& value) const;
+    };
+
+    using Handler = Function<void(HttpServerBase::ClientChannel&, const Match&)>;
+
+    /// @brief Registers a handler for a given method and path pattern
+    /// @param method The http method that must match
+    /// @param pattern Path pattern made of static text, `:name` parameter segments and an optional trailing `*`
+    /// @param handler Function that will be invoked when the route is matched by dispatch
+    /// @return Valid Result if the pattern is well formed and doesn't conflict with an existing route
+    [[nodiscard]] Result addRoute(HttpParser::Method method, StringView pattern, Handler&& handler);
+
+    /// @brief Matches a method and url against all registered routes
+    /// @param method The http method of the request
+    /// @param url The url of the request (it can include a query string)
+    /// @param match Receives parameters, wildcard and query string views into url
+    /// @param methodNotAllowed Set to `true` if the path matches a route registered only for other methods
+    /// @return Pointer to the matched handler or `nullptr` if no route matches
+    [[nodiscard]] const Handler* find(HttpParser::Method method, StringView url, Match& match,
+                                      bool& methodNotAllowed) const;
+
+    /// @brief Matches the request of given client and invokes the associated handler.
+    /// If no route matches, a `404` (or a `405` with an `Allow` header if the path matches with a different method)
+    /// response is sent.
+    /// @param client The client channel holding a request that has been parsed until HeadersEnd
+    /// @return Valid Result if a handler has been invoked or the error response has been written successfully
+    [[nodiscard]] Result dispatch(HttpServerBase::ClientChannel& client) const;
+
+    /// @brief Removes all registered routes
+    void clear();
+
+  private:
+    static constexpr uint32_t InvalidIndex = ~static_cast<uint32_t>(0);
+    // HttpParser::Method values are consecutive and HttpPOST is the last one
+    static constexpr size_t NumMethods = static_cast<size_t>(HttpParser::Method::HttpPOST) + 1;
+
+    struct Node
+    {
+        uint32_t labelStart  = 0; // Offset in labels (static text, or parameter name for parameter nodes)
+        uint32_t labelLength = 0; // Length in labels
+
+        uint32_t firstChild    = InvalidIndex; // First static child
+        uint32_t nextSibling   = InvalidIndex; // Next static sibling of this node
+        uint32_t parameter     = InvalidIndex; // Child matching a `:name` segment
+        uint32_t wildcard      = InvalidIndex; // Child matching a trailing `*`
+        uint32_t handlers[NumMethods];         // Index in handlers for every method or InvalidIndex
+
+        Node()
+        {
+            for (auto& it : handlers)
+                it = InvalidIndex;
+        }
+    };
+    Vector<Node>    nodes;
+    Vector<char>    labels;
+    Vector<Handler> handlers;
+
+    struct Internal;
+};
+
+//! @}
@@ -1,8 +1,6 @@
 // Copyright (c) Stefano Cristiano
 // SPDX-License-Identifier: MIT
 #include "HttpServer.h"
-#include "../Strings/SmallString.h"
-#include "../Strings/StringBuilder.h"
 
 // HttpServerBase::Request
 bool SC::HttpServerBase::Request::find(HttpParser::Result result, StringView& res) const
@@ -17,38 +15,323 @@ bool SC::HttpServerBase::Request::find(HttpParser::Result result, StringView& re
     return false;
 }
 
+bool SC::HttpServerBase::Request::getHeader(StringView headerName, StringView& value) const
+{
+    const char*  name       = headerName.bytesWithoutTerminator();
+    const size_t nameLength = headerName.sizeInBytes();
+    for (size_t idx = 0; idx + 1 < headerOffsets.size(); ++idx)
+    {
+        const Header& header = headerOffsets[idx];
+        if (header.result != HttpParser::Result::HeaderName or header.length != nameLength or
+            headerOffsets[idx + 1].result != HttpParser::Result::HeaderValue)
+        {
+            continue;
+        }
+        const char* text  = headerBuffer.data() + header.start;
+        bool        equal = true;
+        for (size_t pos = 0; equal and pos < nameLength; ++pos)
+        {
+            // Header names are ASCII and case-insensitive
+            equal = (text[pos] | 0x20) == (name[pos] | 0x20);
+        }
+        if (equal)
+        {
+            const Header& headerValue = headerOffsets[idx + 1];
+            value = StringView({headerBuffer.data() + headerValue.start, headerValue.length}, false,
+                               StringEncoding::Ascii);
+            return true;
+        }
+    }
+    return false;
+}
+
+namespace SC
+{
+// Vector grows to the exact requested size, while buffers of a request grow geometrically, as resizing a block that is
+// not the last one allocated from the arena leaves the old block unused until next reset
+template <typename T>
+static bool HttpServerReserve(Vector<T>& buffer, size_t numNewItems)
+{
+    const size_t newSize = buffer.size() + numNewItems;
+    if (newSize <= buffer.capacity())
+    {
+        return true;
+    }
+    const size_t newCapacity = buffer.capacity() < 16 ? 16 : buffer.capacity() * 2;
+    return buffer.reserve(newSize > newCapacity ? newSize : newCapacity);
+}
+
+static bool HttpServerAppend(Vector<char>& buffer, Span<const char> data)
+{
+    return HttpServerReserve(buffer, data.sizeInElements()) and buffer.append(data);
+}
+
+struct HttpServerStatusLine
+{
+    int        code;
+    StringView line;
+};
+// Status lines are stored pre-serialized to avoid formatting them on every response
+static constexpr HttpServerStatusLine HttpServerStatusLines[] = {
+    {101, "HTTP/1.1 101 Switching Protocols\r\n"},
+    {200, "HTTP/1.1 200 OK\r\n"},
+    {201, "HTTP/1.1 201 Created\r\n"},
+    {204, "HTTP/1.1 204 No Content\r\n"},
+    {301, "HTTP/1.1 301 Moved Permanently\r\n"},
+    {302, "HTTP/1.1 302 Found\r\n"},
+    {304, "HTTP/1.1 304 Not Modified\r\n"},
+    {400, "HTTP/1.1 400 Bad Request\r\n"},
+    {401, "HTTP/1.1 401 Unauthorized\r\n"},
+    {403, "HTTP/1.1 403 Forbidden\r\n"},
+    {404, "HTTP/1.1 404 Not Found\r\n"},
+    {405, "HTTP/1.1 405 Method Not Allowed\r\n"},
+    {500, "HTTP/1.1 500 Internal Server Error\r\n"},
+    {503, "HTTP/1.1 503 Service Unavailable\r\n"},
+};
+
+static Result HttpServerAppendStatusLine(Vector<char>& buffer, int code)
+{
+    for (const HttpServerStatusLine& it : HttpServerStatusLines)
+    {
+        if (it.code == code)
+        {
+            return Result(HttpServerAppend(buffer, it.line.toCharSpan()));
+        }
+    }
+    return Result::Error("HttpServer - Unsupported status code");
+}
+
+static Result HttpServerAppendHeader(Vector<char>& buffer, StringView headerName, StringView headerValue)
+{
+    SC_TRY(HttpServerAppend(buffer, headerName.toCharSpan()));
+    SC_TRY(HttpServerAppend(buffer, {": ", 2}));
+    SC_TRY(HttpServerAppend(buffer, headerValue.toCharSpan()));
+    return Result(HttpServerAppend(buffer, {"\r\n", 2}));
+}
+
+// Checks if a comma separated header value (like the one of Connection) contains token (compared case-insensitively)
+static bool HttpServerHasToken(StringView value, StringView token)
+{
+    const char*  text   = value.bytesWithoutTerminator();
+    const size_t length = value.sizeInBytes();
+    for (size_t begin = 0; begin < length;)
+    {
+        size_t end = begin;
+        while (end < length and text[end] != ',')
+            end++;
+        size_t first = begin, last = end;
+        while (first < last and (text[first] == ' ' or text[first] == '\t'))
+            first++;
+        while (last > first and (text[last - 1] == ' ' or text[last - 1] == '\t'))
+            last--;
+        bool equal = last - first == token.sizeInBytes();
+        for (size_t pos = 0; equal and pos < token.sizeInBytes(); ++pos)
+        {
+            equal = (text[first + pos] | 0x20) == (token.bytesWithoutTerminator()[pos] | 0x20);
+        }
+        if (equal)
+            return true;
+        begin = end + 1;
+    }
+    return false;
+}
+
+static Result HttpServerAppendDecimal(Vector<char>& buffer, uint64_t value)
+{
+    char   digits[20];
+    size_t numDigits = 0;
+    do
+    {
+        digits[sizeof(digits) - 1 - numDigits++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    return Result(HttpServerAppend(buffer, {digits + sizeof(digits) - numDigits, numDigits}));
+}
+} // namespace SC
+
+// HttpServerBase::HeaderBlock
+SC::Result SC::HttpServerBase::HeaderBlock::startResponse(int code)
+{
+    SC_TRY_MSG(buffer.isEmpty(), "HeaderBlock::startResponse - Status line must come first");
+    SC_TRY(HttpServerAppendStatusLine(buffer, code));
+    statusLine = true;
+    return Result(true);
+}
+
+SC::Result SC::HttpServerBase::HeaderBlock::addHeader(StringView headerName, StringView headerValue)
+{
+    return HttpServerAppendHeader(buffer, headerName, headerValue);
+}
+
+// HttpServerBase::DateHeader
+void SC::HttpServerBase::DateHeader::update(Time::HighResolutionCounter loopTime)
+{
+    if (length == 0 or loopTime.isLaterThanOrEqualTo(lastUpdate.offsetBy(Time::Milliseconds(1000))))
+    {
+        if (format(Time::Absolute::now()))
+        {
+            lastUpdate = loopTime;
+        }
+    }
+}
+
+bool SC::HttpServerBase::DateHeader::format(Time::Absolute now)
+{
+    Time::Absolute::ParseResult parsed;
+    if (not now.parseUTC(parsed))
+    {
+        return false;
+    }
+    constexpr char days[]   = "SunMonTueWedThuFriSat";
+    constexpr char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+
+    const auto twoDigits = [this](int value)
+    {
+        buffer[length++] = static_cast<char>('0' + value / 10);
+        buffer[length++] = static_cast<char>('0' + value % 10);
+    };
+    const auto copy = [this](const char* text, size_t textLength)
+    {
+        for (size_t idx = 0; idx < textLength; ++idx)
+            buffer[length++] = text[idx];
+    };
+    // Date: Sun, 06 Nov 1994 08:49:37 GMT\r\n
+    length = 0;
+    copy("Date: ", 6);
+    copy(days + (parsed.dayOfWeek % 7) * 3, 3);
+    copy(", ", 2);
+    twoDigits(parsed.dayOfMonth);
+    buffer[length++] = ' ';
+    copy(months + (parsed.month % 12) * 3, 3);
+    buffer[length++] = ' ';
+    twoDigits(parsed.year / 100);
+    twoDigits(parsed.year % 100);
+    buffer[length++] = ' ';
+    twoDigits(parsed.hour);
+    buffer[length++] = ':';
+    twoDigits(parsed.minutes);
+    buffer[length++] = ':';
+    twoDigits(parsed.seconds);
+    copy(" GMT\r\n", 6);
+    return true;
+}
+
+void SC::HttpServerBase::Request::reset()
+{
+    headersEndReceived = false;
+    parsedSuccessfully = true;
+    keepAlive          = true;
+
+    parser = HttpParser();
+    url    = StringView();
+    headerBuffer.clear();
+    headerOffsets.clear();
+}
+
 // HttpServerBase::Response
+void SC::HttpServerBase::Response::reset()
+{
+    outputBuffer.clear();
+    responseEnded      = false;
+    connectionUpgraded = false;
+    keepAlive          = true;
+}
+
+// HttpServerBase::ClientChannel
+SC::Result SC::HttpServerBase::ClientChannel::create(size_t arenaSize)
+{
+    arena.setChunkSize(arenaSize);
+    SC_TRY_MSG(arena.reserve(arenaSize), "ClientChannel::create - Out of memory");
+    reset();
+    return Result(true);
+}
+
+void SC::HttpServerBase::ClientChannel::reset()
+{
+    request.reset();
+    response.reset();
+    // Buffers keep their segment header in the arena, so they're dropped before rewinding it and then created again
+    request.headerBuffer  = Vector<char>();
+    request.headerOffsets = Vector<Header>();
+    response.outputBuffer = Vector<char>();
+    arena.reset();
+    request.headerBuffer  = Vector<char>(arena);
+    request.headerOffsets = Vector<Header>(arena);
+    response.outputBuffer = Vector<char>(arena);
+}
+
 SC::Result SC::HttpServerBase::Response::startResponse(int code)
 {
-    StringBuilder sb(outputBuffer, StringEncoding::Ascii, StringBuilder::Clear);
-    SC_TRY(sb.format("HTTP/1.1 "));
-    switch (code)
+    outputBuffer.clear();
+    SC_TRY(HttpServerAppendStatusLine(outputBuffer, code));
+    responseEnded = false;
+    return appendDateHeader();
+}
+
+SC::Result SC::HttpServerBase::Response::startResponse(const HeaderBlock& headerBlock)
+{
+    SC_TRY_MSG(headerBlock.hasStatusLine(), "Response::startResponse - HeaderBlock has no status line");
+    outputBuffer.clear();
+    SC_TRY(HttpServerAppend(outputBuffer, headerBlock.get()));
+    responseEnded = false;
+    return appendDateHeader();
+}
+
+SC::Result SC::HttpServerBase::Response::appendDateHeader()
+{
+    if (dateHeader != nullptr)
     {
-    case 200: SC_TRY(sb.append("{} OK\r\n", code)); break;
-    case 404: SC_TRY(sb.append("{} Not Found\r\n", code)); break;
-    case 405: SC_TRY(sb.append("{} Not Allowed\r\n", code)); break;
+        SC_TRY(HttpServerAppend(outputBuffer, dateHeader->get()));
     }
-    responseEnded = false;
     return Result(true);
 }
 
 SC::Result SC::HttpServerBase::Response::addHeader(StringView headerName, StringView headerValue)
 {
-    StringBuilder sb(outputBuffer, StringEncoding::Ascii);
-    SC_TRY(sb.append(headerName));
-    SC_TRY(sb.append(": "));
-    SC_TRY(sb.append(headerValue));
-    SC_TRY(sb.append("\r\n"));
-    return Result(true);
+    return HttpServerAppendHeader(outputBuffer, headerName, headerValue);
+}
+
+SC::Result SC::HttpServerBase::Response::addHeaders(const HeaderBlock& headerBlock)
+{
+    SC_TRY_MSG(not headerBlock.hasStatusLine(), "Response::addHeaders - HeaderBlock has a status line");
+    return Result(HttpServerAppend(outputBuffer, headerBlock.get()));
 }
 
 SC::Result SC::HttpServerBase::Response::end(StringView sv)
 {
-    StringBuilder sb(outputBuffer, StringEncoding::Ascii);
-    SC_TRY(sb.append("Content-Length: {}\r\n\r\n", sv.sizeInBytes()));
-    SC_TRY(sb.append(sv));
+    SC_TRY(HttpServerAppend(outputBuffer, {"Content-Length: ", 16}));
+    SC_TRY(HttpServerAppendDecimal(outputBuffer, sv.sizeInBytes()));
+    if (not keepAlive)
+    {
+        SC_TRY(HttpServerAppend(outputBuffer, {"\r\nConnection: close", 19}));
+    }
+    SC_TRY(HttpServerAppend(outputBuffer, {"\r\n\r\n", 4}));
+    SC_TRY(HttpServerAppend(outputBuffer, sv.toCharSpan()));
     responseEnded = true;
-    return Result(outputBuffer.pop_back()); // pop null terminator
+    return Result(true);
+}
+
+SC::Result SC::HttpServerBase::Response::endUpgrade()
+{
+    SC_TRY(HttpServerAppend(outputBuffer, {"\r\n", 2}));
+    responseEnded      = true;
+    connectionUpgraded = true;
+    return Result(true);
+}
+
+void SC::HttpServerBase::resetClient(ClientChannel& client)
+{
+    const size_t usedBytes = client.arena.getBytesUsed();
+    if (usedBytes > arenaStatistics.peakUsedBytes)
+    {
+        arenaStatistics.peakUsedBytes = usedBytes;
+    }
+    if (usedBytes > clientArenaSize)
+    {
+        arenaStatistics.numOverflows += 1;
+        arenaStatistics.overflowBytes += usedBytes - clientArenaSize;
+    }
+    client.reset();
 }
 
 // HttpServer
@@ -61,7 +344,7 @@ SC::Result SC::HttpServerBase::parse(Span<const char> readData, ClientChannel& c
         parsedSuccessfully = false;
         return Result::Error("Header size exceeded limit");
     }
-    SC_TRY(client.request.headerBuffer.append(readData));
+    SC_TRY(HttpServerAppend(client.request.headerBuffer, readData));
     size_t readBytes;
     while (client.request.parsedSuccessfully and not readData.empty())
     {
@@ -77,11 +360,23 @@ SC::Result SC::HttpServerBase::parse(Span<const char> readData, ClientChannel& c
             header.result = parser.result;
             header.start  = static_cast<uint32_t>(parser.tokenStart);
             header.length = static_cast<uint32_t>(parser.tokenLength);
+            parsedSuccessfully &= HttpServerReserve(client.request.headerOffsets, 1);
             parsedSuccessfully &= client.request.headerOffsets.push_back(header);
             if (parser.result == HttpParser::Result::HeadersEnd)
             {
                 client.request.headersEndReceived = true;
+                client.response.dateHeader        = &dateHeader;
                 SC_TRY(client.request.find(HttpParser::Result::Url, client.request.url));
+
+                // HTTP/1.1 connections are persistent by default, while HTTP/1.0 ones must ask for it explicitly
+                StringView version, connection;
+                SC_TRY(client.request.find(HttpParser::Result::Version, version));
+                const bool hasConnection = client.request.getHeader("Connection", connection);
+                if (version.sizeInBytes() > 0 and version.bytesWithoutTerminator()[version.sizeInBytes() - 1] == '0')
+                    client.request.keepAlive = hasConnection and HttpServerHasToken(connection, "keep-alive");
+                else
+                    client.request.keepAlive = not(hasConnection and HttpServerHasToken(connection, "close"));
+                client.response.keepAlive = client.request.keepAlive;
                 onClient(client);
                 break;
             }
@@ -91,20 +386,22 @@ SC::Result SC::HttpServerBase::parse(Span<const char> readData, ClientChannel& c
 }
 
 // HttpServer
-SC::Result SC::HttpServer::start(AsyncEventLoop& eventLoop, uint32_t maxConnections, StringView address, uint16_t port)
+SC::Result SC::HttpServer::start(AsyncEventLoop& loop, uint32_t maxConnections, StringView address, uint16_t port)
 {
-    SC_TRY(requestClients.resize(maxConnections));
-    SC_TRY(requests.resize(maxConnections));
+    eventLoop = &loop;
+    // Client slots are allocated in chunks when connections arrive, up to maxConnections
+    requestClients.setMaxSize(maxConnections);
+    requests.setMaxSize(maxConnections);
     SocketIPAddress nativeAddress;
     SC_TRY(nativeAddress.fromAddressPort(address, port));
-    SC_TRY(eventLoop.createAsyncTCPSocket(nativeAddress.getAddressFamily(), serverSocket));
+    SC_TRY(eventLoop->createAsyncTCPSocket(nativeAddress.getAddressFamily(), serverSocket));
     SocketServer server(serverSocket);
     SC_TRY(server.bind(nativeAddress));
     SC_TRY(server.listen(511));
 
     asyncAccept.setDebugName("HttpServer");
     asyncAccept.callback.bind<HttpServer, &HttpServer::onNewClient>(*this);
-    return asyncAccept.start(eventLoop, serverSocket);
+    return asyncAccept.start(*eventLoop, serverSocket);
 }
 
 SC::Result SC::HttpServer::stop() { return asyncAccept.stop(); }
@@ -117,28 +414,36 @@ void SC::HttpServer::onNewClient(AsyncSocketAccept::Result& result)
         // TODO: Invoke an error
         return;
     }
-    bool succeeded = true;
+    result.reactivateRequest(true);
+
+    // Chunks emptied by closed connections are released here, as clients are removed from their own callbacks
+    (void)requests.releaseEmptyChunks();
+    (void)requestClients.releaseEmptyChunks();
 
-    // TODO: do proper error handling
     auto key1 = requests.allocate();
-    succeeded &= key1.isValid();
     auto key2 = requestClients.allocate();
-    succeeded &= key2.isValid() and key1 == key2;
-    if (succeeded)
+    if (not key1.isValid() or not key2.isValid() or not requests.get(key1)->create(clientArenaSize))
     {
-        RequestClient& client = *requestClients.get(key2);
-        ClientChannel& req    = *requests.get(key1);
-        client.key            = key2;
-        client.socket         = move(acceptedClient);
-
-        auto& buffer = req.request.headerBuffer;
-        succeeded &= buffer.resizeWithoutInitializing(buffer.capacity());
-        client.asyncReceive.setDebugName(client.debugName.bytesIncludingTerminator());
-        client.asyncReceive.callback.bind<HttpServer, &HttpServer::onReceive>(*this);
-        succeeded &= client.asyncReceive.start(*asyncAccept.getEventLoop(), client.socket, buffer.toSpan());
-        SC_ASSERT_RELEASE(succeeded);
+        // Gives back the slots (so that failures don't reduce the number of connections that can be accepted) and
+        // drops the connection, as acceptedClient closes the socket when going out of scope
+        if (key1.isValid())
+        {
+            SC_ASSERT_RELEASE(requests.remove(key1));
+        }
+        if (key2.isValid())
+        {
+            SC_ASSERT_RELEASE(requestClients.remove(key2));
+        }
+        return;
     }
-    result.reactivateRequest(true);
+    RequestClient& client = *requestClients.get(key2);
+    client.key            = key2;
+    client.channelKey     = key1;
+    client.socket         = move(acceptedClient);
+
+    client.asyncReceive.setDebugName(client.debugName.bytesIncludingTerminator());
+    client.asyncReceive.callback.bind<HttpServer, &HttpServer::onReceive>(*this);
+    SC_ASSERT_RELEASE(client.asyncReceive.start(*eventLoop, client.socket, {client.receiveBuffer}));
 }
 
 void SC::HttpServer::onReceive(AsyncSocketReceive::Result& result)
@@ -147,16 +452,19 @@ void SC::HttpServer::onReceive(AsyncSocketReceive::Result& result)
     RequestClient& requestClient = SC_COMPILER_FIELD_OFFSET(RequestClient, asyncReceive, result.getAsync());
     SC_COMPILER_WARNING_POP
     SC_ASSERT_RELEASE(&requestClient.asyncReceive == &result.getAsync());
-    ClientChannel& client = *requests.get(requestClient.key.cast_to<ClientChannel>());
+    ClientChannel& client = *requests.get(requestClient.channelKey);
     Span<char>     readData;
-    if (not result.get(readData))
+    if (not result.get(readData) or readData.empty())
     {
-        // TODO: Invoke on error
+        // Error or remote side has closed the connection
+        closeClient(requestClient);
         return;
     }
+    dateHeader.update(eventLoop->getLoopTime());
     if (not HttpServerBase::parse(readData, client))
     {
         // TODO: Invoke on error
+        closeClient(requestClient);
         return;
     }
     if (client.response.mustBeFlushed())
@@ -165,10 +473,11 @@ void SC::HttpServer::onReceive(AsyncSocketReceive::Result& result)
 
         auto outspan = client.response.outputBuffer.toSpan();
         requestClient.asyncSend.callback.bind<HttpServer, &HttpServer::onAfterSend>(*this);
-        auto res = requestClient.asyncSend.start(*asyncAccept.getEventLoop(), requestClient.socket, outspan);
+        auto res = requestClient.asyncSend.start(*eventLoop, requestClient.socket, outspan);
         if (not res)
         {
             // TODO: Invoke on error
+            closeClient(requestClient);
             return;
         }
     }
@@ -180,13 +489,74 @@ void SC::HttpServer::onReceive(AsyncSocketReceive::Result& result)
 
 void SC::HttpServer::onAfterSend(AsyncSocketSend::Result& result)
 {
-    if (result.isValid())
+    SC_COMPILER_WARNING_PUSH_OFFSETOF
+    RequestClient& requestClient = SC_COMPILER_FIELD_OFFSET(RequestClient, asyncSend, result.getAsync());
+    SC_COMPILER_WARNING_POP
+    if (not result.isValid())
+    {
+        closeClient(requestClient);
+        return;
+    }
+    ClientChannel& client = *requests.get(requestClient.channelKey);
+    if (client.response.connectionUpgraded)
+    {
+        upgradeClient(requestClient, client);
+    }
+    else if (client.response.responseEnded and not client.response.keepAlive)
+    {
+        closeClient(requestClient); // HTTP/1.0 client or `Connection: close`
+    }
+    else if (client.response.responseEnded)
+    {
+        // Keep the connection alive, waiting for next request
+        resetClient(client);
+        auto res = requestClient.asyncReceive.start(*eventLoop, requestClient.socket,
+                                                    {requestClient.receiveBuffer});
+        if (not res)
+        {
+            closeClient(requestClient);
+        }
+    }
+    else
+    {
+        client.response.outputBuffer.clear();
+    }
+}
+
+void SC::HttpServer::upgradeClient(RequestClient& requestClient, ClientChannel& client)
+{
+    if (onUpgrade.isValid())
     {
-        SC_COMPILER_WARNING_PUSH_OFFSETOF
-        RequestClient& requestClient = SC_COMPILER_FIELD_OFFSET(RequestClient, asyncSend, result.getAsync());
-        SC_COMPILER_WARNING_POP
-        auto clientKey = requestClient.key.cast_to<ClientChannel>();
-        requests.get(clientKey)->response.outputBuffer.clear();
+        onUpgrade(client, requestClient.socket);
+    }
+    if (requestClient.socket.isValid())
+    {
+        closeClient(requestClient);
+        return;
     }
-    // TODO: Close socket and dispose resources
+    auto channelKey = requestClient.channelKey;
+    auto key        = requestClient.key;
+    SC_ASSERT_RELEASE(requests.remove(channelKey));
+    SC_ASSERT_RELEASE(requestClients.remove(key));
+}
+
+void SC::HttpServer::closeClient(RequestClient& requestClient)
+{
+    // Socket is closed asynchronously, after the event loop has stopped watching it
+    requestClient.asyncClose.callback.bind<HttpServer, &HttpServer::onAfterClose>(*this);
+    auto res = requestClient.asyncClose.start(*eventLoop, requestClient.socket);
+    SC_ASSERT_RELEASE(res);
+}
+
+void SC::HttpServer::onAfterClose(AsyncSocketClose::Result& result)
+{
+    SC_COMPILER_WARNING_PUSH_OFFSETOF
+    RequestClient& requestClient = SC_COMPILER_FIELD_OFFSET(RequestClient, asyncClose, result.getAsync());
+    SC_COMPILER_WARNING_POP
+    requestClient.socket.detach(); // Already closed by AsyncSocketClose
+
+    auto channelKey = requestClient.channelKey;
+    auto key        = requestClient.key;
+    SC_ASSERT_RELEASE(requests.remove(channelKey));
+    SC_ASSERT_RELEASE(requestClients.remove(key));
 }
@@ -1,12 +1,12 @@
 // Copyright (c) Stefano Cristiano
 // SPDX-License-Identifier: MIT
 #pragma once
-#include "../Containers/ArenaMap.h"
+#include "../Containers/ChunkedArenaMap.h"
 #include "../Foundation/Function.h"
 #include "HttpParser.h"
 
 #include "../Async/Async.h"
-#include "../Containers/SmallVector.h"
+#include "../Containers/Vector.h"
 #include "../Socket/SocketDescriptor.h"
 #include "../Strings/SmallString.h"
 
@@ -31,48 +31,157 @@ struct SC::HttpServerBase
         uint32_t length = 0;
     };
 
+    /// @brief Counters of requests that didn't fit in HttpServerBase::clientArenaSize bytes of their arena
+    struct ArenaStatistics
+    {
+        uint64_t numOverflows  = 0; ///< Number of requests that needed additional arena chunks from SC::Memory
+        uint64_t overflowBytes = 0; ///< Total number of bytes used by requests beyond clientArenaSize
+        size_t   peakUsedBytes = 0; ///< Highest number of arena bytes used by a single request
+    };
+
     /// @brief Http request
     struct Request
     {
         bool headersEndReceived = false; ///< All headers have been received
         bool parsedSuccessfully = true;  ///< Request headers have been parsed successfully
+        bool keepAlive          = true;  ///< Client wants the connection open after the response (not HTTP/1.0 or
+                                         ///< `Connection: close`, unless `Connection: keep-alive` is sent)
 
         HttpParser parser; ///< The parser used to parse headers
         StringView url;    ///< The url extracted from parsed headers
 
-        SmallVector<char, 255>  headerBuffer;  ///< Buffer containing all headers
-        SmallVector<Header, 16> headerOffsets; ///< Headers, defined as offsets in headerBuffer
+        Vector<char>   headerBuffer;  ///< Buffer containing all headers
+        Vector<Header> headerOffsets; ///< Headers, defined as offsets in headerBuffer
+
+        /// @brief Resets the request so that next request on the same connection can be parsed
+        void reset();
 
         /// @brief Finds a specific HttpParser::Result in the list of parsed header
         /// @param result The result to look for (Method, Url etc.)
         /// @param res A StringView, pointing at headerBuffer containing the found result
         /// @return `true` if the result has been found
         [[nodiscard]] bool find(HttpParser::Result result, StringView& res) const;
+
+        /// @brief Finds the value of an header by name (compared case-insensitively)
+        /// @param headerName Name of the header to look for
+        /// @param value A StringView, pointing at headerBuffer containing the header value
+        /// @return `true` if the header has been found
+        [[nodiscard]] bool getHeader(StringView headerName, StringView& value) const;
+    };
+
+    /// @brief Immutable block of pre-serialized status line and / or headers.
+    /// It's meant to be built once (for example at server startup) and copied as is into every Response, skipping
+    /// all per-request formatting of the status line and of common headers.
+    struct HeaderBlock
+    {
+        /// @brief Serializes the status line for the given code. Must be called before adding any header.
+        /// @param code Http status code (200, 404 etc.)
+        /// @return Valid Result if the code is supported and the block was empty
+        [[nodiscard]] Result startResponse(int code);
+
+        /// @brief Serializes an header line (`headerName: headerValue\r\n`)
+        [[nodiscard]] Result addHeader(StringView headerName, StringView headerValue);
+
+        /// @brief Returns `true` if the block starts with a status line
+        [[nodiscard]] bool hasStatusLine() const { return statusLine; }
+
+        /// @brief Obtains the serialized bytes of this block
+        [[nodiscard]] Span<const char> get() const { return buffer.toSpanConst(); }
+
+      private:
+        Vector<char> buffer;
+        bool         statusLine = false;
+    };
+
+    /// @brief Caches the `Date` header line, formatting it at most once per second.
+    /// The refresh is driven by the event loop clock, so that checking if the cache is stale doesn't need a syscall.
+    struct DateHeader
+    {
+        /// @brief Formats again the header line if at least one second has passed since last update
+        /// @param loopTime Current time of the event loop (see AsyncEventLoop::getLoopTime)
+        void update(Time::HighResolutionCounter loopTime);
+
+        /// @brief Formats the header line for the given absolute time
+        /// @param now The time to be formatted as IMF-fixdate (`Sun, 06 Nov 1994 08:49:37 GMT`)
+        /// @return `true` if the time could be formatted
+        [[nodiscard]] bool format(Time::Absolute now);
+
+        /// @brief Obtains the cached `Date: ...\r\n` header line (empty if never updated)
+        [[nodiscard]] Span<const char> get() const { return {buffer, length}; }
+
+      private:
+        char                        buffer[64];
+        size_t                      length = 0;
+        Time::HighResolutionCounter lastUpdate;
     };
 
+    /// @brief Http response
     struct Response
     {
-        SmallVector<char, 255> outputBuffer;
+        Vector<char> outputBuffer;
+
+        bool   responseEnded      = false;
+        bool   connectionUpgraded = false; ///< Response has been ended with Response::endUpgrade
+        bool   keepAlive          = true;  ///< If `false` Response::end adds `Connection: close` and HttpServer closes
+                                           ///< the connection once the response is sent (initialized from the request)
+        size_t highwaterMark      = 255;
 
-        bool   responseEnded = false;
-        size_t highwaterMark = 255;
+        const DateHeader* dateHeader = nullptr; ///< If set, its cached header line is added by startResponse
 
+        /// @brief Starts the response writing a precomputed status line (and the cached Date header if any)
         [[nodiscard]] Result startResponse(int code);
+
+        /// @brief Starts the response copying a HeaderBlock that includes the status line
+        [[nodiscard]] Result startResponse(const HeaderBlock& headerBlock);
+
+        /// @brief Appends a single header line
         [[nodiscard]] Result addHeader(StringView headerName, StringView headerValue);
+
+        /// @brief Appends a HeaderBlock containing only headers (no status line)
+        [[nodiscard]] Result addHeaders(const HeaderBlock& headerBlock);
+
+        /// @brief Writes the Content-Length header, followed by the body
         [[nodiscard]] Result end(StringView sv);
 
+        /// @brief Ends a `101 Switching Protocols` response (without Content-Length, as no body follows).
+        /// Once it has been sent the connection is handed over to HttpServer::onUpgrade.
+        [[nodiscard]] Result endUpgrade();
+
         [[nodiscard]] bool mustBeFlushed() const { return responseEnded or outputBuffer.size() > highwaterMark; }
+
+        /// @brief Resets the response so that it can be reused for next request on the same connection
+        void reset();
+
+      private:
+        [[nodiscard]] Result appendDateHeader();
     };
 
-    uint32_t maxHeaderSize = 8 * 1024;
+    uint32_t        maxHeaderSize   = 8 * 1024;
+    uint32_t        clientArenaSize = 4 * 1024; ///< Bytes of arena allocated for every accepted connection (and size of
+                                                ///< additional chunks for requests that don't fit in it)
+    DateHeader      dateHeader;                 ///< Date header shared by all responses
+    ArenaStatistics arenaStatistics;            ///< Arena usage of all requests
+
     struct ClientChannel
     {
-        Request  request;
-        Response response;
+        ArenaAllocator arena; ///< Backs all buffers of request and response (once created)
+        Request        request;
+        Response       response;
+
+        /// @brief Allocates the arena and makes buffers of request and response allocate from it
+        /// @param arenaSize Bytes allocated upfront, so that requests using less than that don't allocate.
+        /// Requests needing more memory get additional chunks of (at least) the same size.
+        [[nodiscard]] Result create(size_t arenaSize);
+
+        /// @brief Resets request, response and arena so that next request on the same connection can be handled
+        void reset();
     };
-    ArenaMap<ClientChannel>        requests;
+    ChunkedArenaMap<ClientChannel> requests;
     Function<void(ClientChannel&)> onClient;
 
+    /// @brief Updates arenaStatistics with the arena usage of the current request and resets the client
+    void resetClient(ClientChannel& client);
+
   protected:
     [[nodiscard]] Result parse(Span<const char> readData, ClientChannel& res);
 };
@@ -96,24 +205,38 @@ struct SC::HttpServer : public HttpServerBase
     /// @return Valid Result if server has been stopped successfully
     [[nodiscard]] Result stop();
 
+    /// @brief Invoked after a response ended with Response::endUpgrade has been sent.
+    /// The socket can be moved out of the server, that stops tracking the connection once the callback returns.
+    /// If the socket is not moved (or if onUpgrade is not set) the connection is closed.
+    Function<void(ClientChannel&, SocketDescriptor&)> onUpgrade;
+
   private:
     struct RequestClient
     {
-        ArenaMap<RequestClient>::Key key;
+        ChunkedArenaMap<RequestClient>::Key key;
+        ChunkedArenaMap<ClientChannel>::Key channelKey; // Slots of the two maps can have different generations
 
         SocketDescriptor   socket;
         SmallString<50>    debugName;
         AsyncSocketReceive asyncReceive;
         AsyncSocketSend    asyncSend;
+        AsyncSocketClose   asyncClose;
+
+        char receiveBuffer[1024];
     };
-    ArenaMap<RequestClient> requestClients;
-    SocketDescriptor        serverSocket;
+    ChunkedArenaMap<RequestClient> requestClients;
+    SocketDescriptor               serverSocket;
+    AsyncEventLoop*                eventLoop = nullptr;
 
     AsyncSocketAccept asyncAccept;
 
     void onNewClient(AsyncSocketAccept::Result& result);
     void onReceive(AsyncSocketReceive::Result& result);
     void onAfterSend(AsyncSocketSend::Result& result);
+    void onAfterClose(AsyncSocketClose::Result& result);
+
+    void closeClient(RequestClient& requestClient);
+    void upgradeClient(RequestClient& requestClient, ClientChannel& client);
 };
 
 //! @}
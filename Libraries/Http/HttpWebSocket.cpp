@@ -0,0 +1,611 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "HttpWebSocket.h"
+#include "../Foundation/LibC.h" // memcpy
+#include "../Hashing/Hashing.h"
+
+// HttpWebSocket
+SC::Result SC::HttpWebSocket::parseFrameHeader(Span<const char> data, FrameHeader& header, size_t& headerLength)
+{
+    headerLength = 0;
+    if (data.sizeInBytes() < 2)
+    {
+        return Result(true);
+    }
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.data());
+    SC_TRY_MSG((bytes[0] & 0x70) == 0, "WebSocket - Reserved bits must be zero");
+
+    const uint8_t opcode = bytes[0] & 0x0F;
+    SC_TRY_MSG(opcode <= 0x2 or (opcode >= 0x8 and opcode <= 0xA), "WebSocket - Unknown opcode");
+
+    const uint8_t length      = bytes[1] & 0x7F;
+    const size_t  lengthBytes = length == 126 ? 2 : (length == 127 ? 8 : 0);
+    const bool    masked      = (bytes[1] & 0x80) != 0;
+    const size_t  needed      = 2 + lengthBytes + (masked ? 4 : 0);
+    if (data.sizeInBytes() < needed)
+    {
+        return Result(true);
+    }
+
+    header.fin           = (bytes[0] & 0x80) != 0;
+    header.opcode        = static_cast<Opcode>(opcode);
+    header.masked        = masked;
+    header.payloadLength = lengthBytes == 0 ? length : 0;
+    for (size_t idx = 0; idx < lengthBytes; ++idx)
+    {
+        header.payloadLength = (header.payloadLength << 8) | bytes[2 + idx];
+    }
+    SC_TRY_MSG((header.payloadLength >> 63) == 0, "WebSocket - Invalid payload length");
+    if (header.isControl())
+    {
+        SC_TRY_MSG(header.fin, "WebSocket - Control frames cannot be fragmented");
+        SC_TRY_MSG(header.payloadLength <= MaxControlPayload, "WebSocket - Control frame payload too long");
+    }
+    if (masked)
+    {
+        ::memcpy(header.mask, bytes + 2 + lengthBytes, 4);
+    }
+    headerLength = needed;
+    return Result(true);
+}
+
+SC::size_t SC::HttpWebSocket::writeFrameHeader(const FrameHeader& header, char (&buffer)[MaxFrameHeaderSize])
+{
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(buffer);
+
+    bytes[0]      = static_cast<uint8_t>((header.fin ? 0x80 : 0) | static_cast<uint8_t>(header.opcode));
+    size_t length = 2;
+    if (header.payloadLength < 126)
+    {
+        bytes[1] = static_cast<uint8_t>(header.payloadLength);
+    }
+    else
+    {
+        const size_t lengthBytes = header.payloadLength <= 0xFFFF ? 2 : 8;
+        bytes[1]                 = lengthBytes == 2 ? 126 : 127;
+        for (size_t idx = 0; idx < lengthBytes; ++idx)
+        {
+            bytes[length++] = static_cast<uint8_t>(header.payloadLength >> (8 * (lengthBytes - 1 - idx)));
+        }
+    }
+    if (header.masked)
+    {
+        bytes[1] |= 0x80;
+        ::memcpy(bytes + length, header.mask, 4);
+        length += 4;
+    }
+    return length;
+}
+
+void SC::HttpWebSocket::applyMask(Span<char> data, const uint8_t (&mask)[4], uint64_t offset)
+{
+    // Mask rotated to start at offset, repeated to fill a 64 bit word
+    uint8_t rotated[8];
+    for (size_t idx = 0; idx < 8; ++idx)
+    {
+        rotated[idx] = mask[(offset + idx) & 3];
+    }
+    uint64_t wordMask;
+    ::memcpy(&wordMask, rotated, sizeof(wordMask));
+
+    char*        bytes = data.data();
+    const size_t size  = data.sizeInBytes();
+    size_t       idx   = 0;
+    // memcpy makes unaligned loads / stores well defined and it's compiled to plain moves (or vectorized)
+    for (; idx + sizeof(uint64_t) <= size; idx += sizeof(uint64_t))
+    {
+        uint64_t word;
+        ::memcpy(&word, bytes + idx, sizeof(word));
+        word ^= wordMask;
+        ::memcpy(bytes + idx, &word, sizeof(word));
+    }
+    for (; idx < size; ++idx)
+    {
+        bytes[idx] = static_cast<char>(bytes[idx] ^ rotated[idx & 3]);
+    }
+}
+
+SC::Result SC::HttpWebSocket::computeAcceptKey(StringView key, char (&acceptKey)[AcceptKeyLength])
+{
+    static constexpr char guid[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+    Hashing hashing;
+    SC_TRY_MSG(hashing.setType(Hashing::TypeSHA1), "WebSocket - SHA1 not available");
+    SC_TRY_MSG(hashing.add(key.toBytesSpan()), "WebSocket - SHA1 failed");
+    SC_TRY_MSG(hashing.add({reinterpret_cast<const uint8_t*>(guid), sizeof(guid) - 1}), "WebSocket - SHA1 failed");
+    Hashing::Result sha1;
+    SC_TRY_MSG(hashing.getHash(sha1), "WebSocket - SHA1 failed");
+
+    // Base64 of the 20 bytes digest (6 full triplets plus a last one with two bytes, padded with a single '=')
+    static constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t                length     = 0;
+    for (size_t idx = 0; idx < Hashing::Result::SHA1_DIGEST_LENGTH; idx += 3)
+    {
+        const size_t   remaining = Hashing::Result::SHA1_DIGEST_LENGTH - idx;
+        const uint32_t triplet   = (uint32_t(sha1.hash[idx]) << 16) | (uint32_t(sha1.hash[idx + 1]) << 8) |
+                                 (remaining > 2 ? sha1.hash[idx + 2] : 0);
+
+        acceptKey[length++] = alphabet[(triplet >> 18) & 0x3F];
+        acceptKey[length++] = alphabet[(triplet >> 12) & 0x3F];
+        acceptKey[length++] = alphabet[(triplet >> 6) & 0x3F];
+        acceptKey[length++] = remaining > 2 ? alphabet[triplet & 0x3F] : '=';
+    }
+    return Result(true);
+}
+
+namespace SC
+{
+// Case insensitive search of an ASCII token in a comma separated header value (like `Connection: keep-alive, Upgrade`)
+static bool HttpWebSocketContainsToken(StringView headerValue, StringView token)
+{
+    const char*  text       = headerValue.bytesWithoutTerminator();
+    const size_t textLength = headerValue.sizeInBytes();
+    const size_t length     = token.sizeInBytes();
+    size_t       start      = 0;
+    while (start < textLength)
+    {
+        while (start < textLength and (text[start] == ' ' or text[start] == ','))
+        {
+            start++;
+        }
+        size_t end = start;
+        while (end < textLength and text[end] != ',' and text[end] != ' ')
+        {
+            end++;
+        }
+        if (end - start == length)
+        {
+            bool equal = true;
+            for (size_t idx = 0; equal and idx < length; ++idx)
+            {
+                equal = (text[start + idx] | 0x20) == (token.bytesWithoutTerminator()[idx] | 0x20);
+            }
+            if (equal)
+            {
+                return true;
+            }
+        }
+        start = end;
+    }
+    return false;
+}
+} // namespace SC
+
+bool SC::HttpWebSocket::isUpgradeRequest(const HttpServerBase::Request& request)
+{
+    StringView upgrade, connection;
+    return request.parser.method == HttpParser::Method::HttpGET and request.getHeader("Upgrade", upgrade) and
+           HttpWebSocketContainsToken(upgrade, "websocket") and request.getHeader("Connection", connection) and
+           HttpWebSocketContainsToken(connection, "upgrade");
+}
+
+SC::Result SC::HttpWebSocket::acceptUpgrade(HttpServerBase::ClientChannel& client)
+{
+    SC_TRY_MSG(isUpgradeRequest(client.request), "WebSocket - Not an upgrade request");
+    StringView version, key;
+    SC_TRY_MSG(client.request.getHeader("Sec-WebSocket-Version", version) and version == "13",
+               "WebSocket - Unsupported version");
+    SC_TRY_MSG(client.request.getHeader("Sec-WebSocket-Key", key) and not key.isEmpty(), "WebSocket - Missing key");
+
+    char acceptKey[AcceptKeyLength];
+    SC_TRY(computeAcceptKey(key, acceptKey));
+
+    HttpServerBase::Response& response = client.response;
+    SC_TRY(response.startResponse(101));
+    SC_TRY(response.addHeader("Upgrade", "websocket"));
+    SC_TRY(response.addHeader("Connection", "Upgrade"));
+    SC_TRY(response.addHeader("Sec-WebSocket-Accept", StringView({acceptKey, AcceptKeyLength}, false,
+                                                                 StringEncoding::Ascii)));
+    return response.endUpgrade();
+}
+
+// HttpWebSocketServer
+struct SC::HttpWebSocketServer::Frame
+{
+    uint32_t refCount;
+    uint32_t size;
+
+    char* data() { return reinterpret_cast<char*>(this + 1); }
+
+    static Frame* create(Opcode opcode, Span<const char> payload)
+    {
+        HttpWebSocket::FrameHeader header;
+        header.opcode        = opcode;
+        header.payloadLength = payload.sizeInBytes();
+
+        char         headerBytes[HttpWebSocket::MaxFrameHeaderSize];
+        const size_t headerLength = HttpWebSocket::writeFrameHeader(header, headerBytes);
+
+        Frame* frame = static_cast<Frame*>(Memory::allocate(sizeof(Frame) + headerLength + payload.sizeInBytes()));
+        if (frame != nullptr)
+        {
+            frame->refCount = 1;
+            frame->size     = static_cast<uint32_t>(headerLength + payload.sizeInBytes());
+            ::memcpy(frame->data(), headerBytes, headerLength);
+            if (not payload.empty())
+            {
+                ::memcpy(frame->data() + headerLength, payload.data(), payload.sizeInBytes());
+            }
+        }
+        return frame;
+    }
+
+    void release()
+    {
+        if (--refCount == 0)
+        {
+            Memory::release(this);
+        }
+    }
+};
+
+struct SC::HttpWebSocketServer::Internal
+{
+    [[nodiscard]] static Result queueFrame(HttpWebSocketServer& server, Connection& connection, Frame& frame)
+    {
+        if (connection.closing or connection.closeQueued)
+        {
+            return Result(true); // Dropped, as the connection is going away
+        }
+        if (connection.queueSize == MaxQueuedFrames)
+        {
+            server.statistics.numSlowConsumers++;
+            closeConnection(server, connection);
+            return Result(true);
+        }
+        frame.refCount++;
+        connection.queue[(connection.queueStart + connection.queueSize) % MaxQueuedFrames] = &frame;
+        connection.queueSize++;
+        server.statistics.numFramesQueued++;
+        if (not connection.sending)
+        {
+            sendNext(server, connection);
+        }
+        return Result(true);
+    }
+
+    [[nodiscard]] static Result queueControlFrame(HttpWebSocketServer& server, Connection& connection, Opcode opcode,
+                                                  Span<const char> payload)
+    {
+        Frame* frame = Frame::create(opcode, payload);
+        SC_TRY_MSG(frame != nullptr, "WebSocket - Out of memory");
+        const Result res = queueFrame(server, connection, *frame);
+        frame->release();
+        return res;
+    }
+
+    static void sendNext(HttpWebSocketServer& server, Connection& connection)
+    {
+        Frame&           frame     = *connection.queue[connection.queueStart];
+        AsyncSocketSend& asyncSend = connection.asyncSend[connection.sendIndex];
+        connection.sendIndex       = 1 - connection.sendIndex;
+        if (asyncSend.start(*server.eventLoop, connection.sendSocket, {frame.data(), frame.size}))
+        {
+            connection.sending = true;
+        }
+        else
+        {
+            closeConnection(server, connection);
+        }
+    }
+
+    static void releaseQueue(Connection& connection)
+    {
+        while (connection.queueSize > 0)
+        {
+            connection.queue[connection.queueStart]->release();
+            connection.queueStart = (connection.queueStart + 1) % MaxQueuedFrames;
+            connection.queueSize--;
+        }
+    }
+
+    static void onAfterSend(HttpWebSocketServer& server, Connection& connection, AsyncSocketSend::Result& result)
+    {
+        connection.sending = false;
+        if (connection.closing)
+        {
+            closeWhenIdle(server, connection);
+            return;
+        }
+        if (not result.isValid())
+        {
+            closeConnection(server, connection);
+            return;
+        }
+        connection.queue[connection.queueStart]->release();
+        connection.queueStart = (connection.queueStart + 1) % MaxQueuedFrames;
+        connection.queueSize--;
+        if (connection.queueSize > 0)
+        {
+            sendNext(server, connection);
+        }
+        else if (connection.closeQueued)
+        {
+            closeConnection(server, connection); // Close frame has been sent
+        }
+    }
+
+    static void onReceive(HttpWebSocketServer& server, Connection& connection, AsyncSocketReceive::Result& result)
+    {
+        connection.receiving = false;
+        Span<char> data;
+        if (connection.closing or not result.get(data) or data.empty())
+        {
+            // Connection is being closed, an error occurred or the remote side has closed the connection
+            closeConnection(server, connection);
+            return;
+        }
+        if (not processReceived(server, connection, data))
+        {
+            (void)close(server, connection, 1002); // Protocol error
+        }
+        if (not connection.closing and not connection.closeQueued)
+        {
+            connection.receiving = true;
+            result.reactivateRequest(true);
+        }
+        else if (connection.closing)
+        {
+            closeWhenIdle(server, connection);
+        }
+    }
+
+    // Parses all frames contained in data, delivering payloads in place
+    [[nodiscard]] static Result processReceived(HttpWebSocketServer& server, Connection& connection, Span<char> data)
+    {
+        HttpWebSocket::FrameHeader& frame = connection.frame;
+        while (not connection.closing and not connection.closeQueued)
+        {
+            if (not connection.inPayload)
+            {
+                if (data.empty())
+                {
+                    break;
+                }
+                // Header bytes are accumulated only if the header is split between two receives
+                const size_t space  = sizeof(connection.headerBytes) - connection.headerSize;
+                const size_t copied = space < data.sizeInBytes() ? space : data.sizeInBytes();
+                ::memcpy(connection.headerBytes + connection.headerSize, data.data(), copied);
+
+                size_t headerLength;
+                SC_TRY(HttpWebSocket::parseFrameHeader({connection.headerBytes, connection.headerSize + copied}, frame,
+                                                       headerLength));
+                if (headerLength == 0)
+                {
+                    connection.headerSize += copied;
+                    break;
+                }
+                SC_TRY(data.sliceStart(headerLength - connection.headerSize, data));
+                connection.headerSize = 0;
+
+                SC_TRY_MSG(frame.masked, "WebSocket - Client frames must be masked");
+                if (frame.opcode == Opcode::Continuation)
+                {
+                    SC_TRY_MSG(connection.inMessage, "WebSocket - Unexpected continuation frame");
+                }
+                else if (not frame.isControl())
+                {
+                    SC_TRY_MSG(not connection.inMessage, "WebSocket - Expected continuation frame");
+                    connection.messageOpcode = frame.opcode;
+                }
+                connection.inPayload     = true;
+                connection.payloadOffset = 0;
+            }
+
+            const uint64_t remaining = frame.payloadLength - connection.payloadOffset;
+            const size_t   available = remaining < data.sizeInBytes() ? static_cast<size_t>(remaining) //
+                                                                      : data.sizeInBytes();
+            if (available == 0 and remaining > 0)
+            {
+                break;
+            }
+            Span<char> payload;
+            SC_TRY(data.sliceStartLength(0, available, payload));
+            SC_TRY(data.sliceStart(available, data));
+            HttpWebSocket::applyMask(payload, frame.mask, connection.payloadOffset);
+
+            const uint64_t payloadOffset = connection.payloadOffset;
+            connection.payloadOffset += available;
+
+            const bool frameEnded = connection.payloadOffset == frame.payloadLength;
+            if (frameEnded)
+            {
+                connection.inPayload = false;
+            }
+            if (frame.isControl())
+            {
+                // Control frames are small (at most 125 bytes) but they could still be split between receives
+                ::memcpy(connection.controlPayload + payloadOffset, payload.data(), available);
+                if (frameEnded)
+                {
+                    SC_TRY(processControlFrame(server, connection));
+                }
+            }
+            else
+            {
+                connection.inMessage = not(frame.fin and frameEnded);
+                Message message;
+                message.opcode = connection.messageOpcode;
+                message.data   = payload;
+                message.last   = frame.fin and frameEnded;
+                if ((available > 0 or message.last) and server.onMessage.isValid())
+                {
+                    server.onMessage(connection.key, message);
+                }
+            }
+        }
+        return Result(true);
+    }
+
+    [[nodiscard]] static Result processControlFrame(HttpWebSocketServer& server, Connection& connection)
+    {
+        const size_t length = static_cast<size_t>(connection.frame.payloadLength);
+        switch (connection.frame.opcode)
+        {
+        case Opcode::Ping:
+            return queueControlFrame(server, connection, Opcode::Pong, {connection.controlPayload, length});
+        case Opcode::Close: {
+            // Echo the status code (if any) and close the connection after the Close frame has been sent
+            SC_TRY(queueControlFrame(server, connection, Opcode::Close,
+                                     {connection.controlPayload, length >= 2 ? size_t(2) : size_t(0)}));
+            connection.closeQueued = true;
+            return Result(true);
+        }
+        default: return Result(true); // Unsolicited Pong
+        }
+    }
+
+    [[nodiscard]] static Result close(HttpWebSocketServer& server, Connection& connection, uint16_t statusCode)
+    {
+        if (connection.closing or connection.closeQueued)
+        {
+            return Result(true);
+        }
+        const char payload[2] = {static_cast<char>(statusCode >> 8), static_cast<char>(statusCode & 0xFF)};
+        SC_TRY(queueControlFrame(server, connection, Opcode::Close, {payload, sizeof(payload)}));
+        connection.closeQueued = not connection.closing;
+        return Result(true);
+    }
+
+    // Shuts down the socket, so that pending receive and send complete (with an error) and the socket can be closed
+    static void closeConnection(HttpWebSocketServer& server, Connection& connection)
+    {
+        if (connection.closing)
+        {
+            return;
+        }
+        connection.closing = true;
+        releaseQueue(connection);
+        (void)SocketClient(connection.socket).shutdown();
+        closeWhenIdle(server, connection);
+    }
+
+    static void closeWhenIdle(HttpWebSocketServer& server, Connection& connection)
+    {
+        if (connection.receiving or connection.sending or connection.closeStarted)
+        {
+            return;
+        }
+        connection.closeStarted = true;
+        if (not connection.asyncClose.start(*server.eventLoop, connection.socket))
+        {
+            onAfterClose(server, connection);
+        }
+    }
+
+    static void onAfterClose(HttpWebSocketServer& server, Connection& connection)
+    {
+        connection.socket.detach(); // Already closed by AsyncSocketClose
+        if (connection.sendSocket.isValid())
+        {
+            (void)connection.sendSocket.close();
+        }
+        const Key key = connection.key;
+        SC_ASSERT_RELEASE(server.connections.remove(key));
+        server.numConnections--;
+        if (server.onClose.isValid())
+        {
+            server.onClose(key);
+        }
+    }
+};
+
+SC::HttpWebSocketServer::~HttpWebSocketServer()
+{
+    for (Connection& connection : connections)
+    {
+        Internal::releaseQueue(connection);
+    }
+}
+
+SC::Result SC::HttpWebSocketServer::start(AsyncEventLoop& loop, uint32_t maxConnections)
+{
+    SC_TRY_MSG(numConnections == 0, "HttpWebSocketServer::start - Already started");
+    eventLoop = &loop;
+    return Result(connections.resize(maxConnections));
+}
+
+SC::Result SC::HttpWebSocketServer::stop()
+{
+    for (Connection& connection : connections)
+    {
+        Internal::closeConnection(*this, connection);
+    }
+    return Result(true);
+}
+
+SC::Result SC::HttpWebSocketServer::addConnection(SocketDescriptor& socket, Key& key)
+{
+    SC_TRY_MSG(eventLoop != nullptr, "HttpWebSocketServer::addConnection - Not started");
+    key = connections.allocate();
+    SC_TRY_MSG(key.isValid(), "HttpWebSocketServer::addConnection - Too many connections");
+    Connection& connection = *connections.get(key);
+    connection.key         = key;
+    connection.socket      = move(socket);
+    numConnections++;
+
+    // Some event loop backends (epoll) can't watch the same descriptor with multiple requests, so sends use a
+    // duplicated descriptor to wait for the socket to become writable while a receive is pending on the original one.
+    if (not connection.socket.duplicate(connection.sendSocket) or
+        not eventLoop->associateExternallyCreatedTCPSocket(connection.sendSocket))
+    {
+        Internal::closeConnection(*this, connection);
+        return Result::Error("HttpWebSocketServer::addConnection - Cannot duplicate socket");
+    }
+    HttpWebSocketServer* self    = this;
+    Connection*          pointer = &connection;
+
+    connection.asyncReceive.callback = [self, pointer](AsyncSocketReceive::Result& result)
+    { Internal::onReceive(*self, *pointer, result); };
+    for (AsyncSocketSend& asyncSend : connection.asyncSend)
+    {
+        asyncSend.callback = [self, pointer](AsyncSocketSend::Result& result)
+        { Internal::onAfterSend(*self, *pointer, result); };
+    }
+    connection.asyncClose.callback = [self, pointer](AsyncSocketClose::Result&)
+    { Internal::onAfterClose(*self, *pointer); };
+
+    if (not connection.asyncReceive.start(*eventLoop, connection.socket, {connection.receiveBuffer}))
+    {
+        Internal::closeConnection(*this, connection);
+        return Result::Error("HttpWebSocketServer::addConnection - Cannot start receiving");
+    }
+    connection.receiving = true;
+    return Result(true);
+}
+
+SC::Result SC::HttpWebSocketServer::send(Key key, Opcode opcode, Span<const char> data)
+{
+    Connection* connection = connections.get(key);
+    SC_TRY_MSG(connection != nullptr, "HttpWebSocketServer::send - Invalid key");
+    SC_TRY_MSG(opcode == Opcode::Text or opcode == Opcode::Binary, "HttpWebSocketServer::send - Invalid opcode");
+    Frame* frame = Frame::create(opcode, data);
+    SC_TRY_MSG(frame != nullptr, "HttpWebSocketServer::send - Out of memory");
+    const Result res = Internal::queueFrame(*this, *connection, *frame);
+    frame->release();
+    return res;
+}
+
+SC::Result SC::HttpWebSocketServer::broadcast(Opcode opcode, Span<const char> data)
+{
+    SC_TRY_MSG(opcode == Opcode::Text or opcode == Opcode::Binary, "HttpWebSocketServer::broadcast - Invalid opcode");
+    Frame* frame = Frame::create(opcode, data);
+    SC_TRY_MSG(frame != nullptr, "HttpWebSocketServer::broadcast - Out of memory");
+    Result res = Result(true);
+    for (Connection& connection : connections)
+    {
+        if (not Internal::queueFrame(*this, connection, *frame))
+        {
+            res = Result::Error("HttpWebSocketServer::broadcast - Failed queuing frame");
+        }
+    }
+    frame->release();
+    return res;
+}
+
+SC::Result SC::HttpWebSocketServer::close(Key key, uint16_t statusCode)
+{
+    Connection* connection = connections.get(key);
+    SC_TRY_MSG(connection != nullptr, "HttpWebSocketServer::close - Invalid key");
+    return Internal::close(*this, *connection, statusCode);
+}
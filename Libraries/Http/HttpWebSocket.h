@@ -0,0 +1,198 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "HttpServer.h"
+
+namespace SC
+{
+struct HttpWebSocket;
+struct HttpWebSocketServer;
+} // namespace SC
+
+//! @addtogroup group_http
+//! @{
+
+/// @brief RFC 6455 WebSocket handshake and framing primitives
+struct SC::HttpWebSocket
+{
+    /// @brief Frame opcode
+    enum class Opcode : uint8_t
+    {
+        Continuation = 0x0, ///< Continuation of a fragmented message
+        Text         = 0x1, ///< First frame of an UTF8 text message
+        Binary       = 0x2, ///< First frame of a binary message
+        Close        = 0x8, ///< Close control frame
+        Ping         = 0x9, ///< Ping control frame
+        Pong         = 0xA, ///< Pong control frame
+    };
+
+    /// @brief Maximum size of a serialized frame header (2 bytes, 8 bytes extended length and 4 bytes of mask)
+    static constexpr size_t MaxFrameHeaderSize = 14;
+
+    /// @brief Maximum payload length of a control frame
+    static constexpr size_t MaxControlPayload = 125;
+
+    /// @brief Length of the Sec-WebSocket-Accept header value (base64 of a SHA1)
+    static constexpr size_t AcceptKeyLength = 28;
+
+    /// @brief Parsed (or to be serialized) frame header
+    struct FrameHeader
+    {
+        bool     fin           = true;         ///< Last frame of a message
+        Opcode   opcode        = Opcode::Text; ///< Opcode of the frame
+        bool     masked        = false;        ///< Payload is masked (mandatory for frames sent by clients)
+        uint8_t  mask[4]       = {0};          ///< Masking key
+        uint64_t payloadLength = 0;            ///< Length of the payload following the header
+
+        /// @brief Returns `true` for Close, Ping and Pong frames
+        [[nodiscard]] bool isControl() const { return (static_cast<uint8_t>(opcode) & 0x8) != 0; }
+    };
+
+    /// @brief Parses a frame header from the beginning of data
+    /// @param data Received bytes, starting at a frame boundary
+    /// @param header The parsed frame header
+    /// @param headerLength Number of bytes of the header or zero if more data is needed to parse it
+    /// @return Invalid Result if the header violates the protocol (reserved bits, unknown opcode etc.)
+    [[nodiscard]] static Result parseFrameHeader(Span<const char> data, FrameHeader& header, size_t& headerLength);
+
+    /// @brief Serializes a frame header
+    /// @param header The header to be serialized (mask is written only if FrameHeader::masked is `true`)
+    /// @param buffer Destination buffer
+    /// @return Number of bytes written to buffer
+    [[nodiscard]] static size_t writeFrameHeader(const FrameHeader& header, char (&buffer)[MaxFrameHeaderSize]);
+
+    /// @brief Masks (or unmasks) data in place, processing it a machine word at a time
+    /// @param data The payload (or a chunk of it) to be masked
+    /// @param mask The masking key
+    /// @param offset Offset of data from the beginning of the payload (to continue masking a payload split in chunks)
+    static void applyMask(Span<char> data, const uint8_t (&mask)[4], uint64_t offset);
+
+    /// @brief Computes the Sec-WebSocket-Accept value for a given Sec-WebSocket-Key
+    [[nodiscard]] static Result computeAcceptKey(StringView key, char (&acceptKey)[AcceptKeyLength]);
+
+    /// @brief Returns `true` if the request asks to upgrade the connection to a WebSocket
+    [[nodiscard]] static bool isUpgradeRequest(const HttpServerBase::Request& request);
+
+    /// @brief Validates the handshake request and writes the `101 Switching Protocols` response.
+    /// After the response has been sent, the socket is passed to HttpServer::onUpgrade (see HttpWebSocketServer).
+    /// @param client A client whose request has been parsed until HeadersEnd
+    /// @return Invalid Result if the request is not a valid RFC 6455 handshake
+    [[nodiscard]] static Result acceptUpgrade(HttpServerBase::ClientChannel& client);
+};
+
+/// @brief Serves WebSocket connections upgraded by an HttpServer, on a single AsyncEventLoop.
+/// Received messages are handed out in chunks that point inside the receive buffer of the connection, unmasked in
+/// place, so that payloads are never copied. A message larger than the receive buffer (or split across TCP segments)
+/// is delivered in multiple chunks, the last of which has Message::last set.
+///
+/// Frames sent with HttpWebSocketServer::broadcast are serialized once and queued (by reference) on every connection,
+/// so that fanning out a message to thousands of subscribers costs one allocation and one send per subscriber.
+/// A connection whose send queue is full (a slow consumer) is closed and counted in Statistics::numSlowConsumers.
+///
+/// Example:
+/// @snippet Libraries/Http/Tests/HttpWebSocketTest.cpp HttpWebSocketSnippet
+struct SC::HttpWebSocketServer
+{
+    using Opcode = HttpWebSocket::Opcode;
+
+  private:
+    struct Connection;
+    struct Frame;
+
+  public:
+    using Key = ArenaMapKey<Connection>;
+
+    /// @brief Maximum number of frames that can be queued on a single connection before it's considered too slow
+    static constexpr size_t MaxQueuedFrames = 64;
+
+    /// @brief A chunk of a received message
+    struct Message
+    {
+        Opcode     opcode = Opcode::Text; ///< Text or Binary (opcode of the first frame of the message)
+        Span<char> data;                  ///< Payload chunk, valid only for the duration of onMessage
+        bool       last = true;           ///< `true` if this is the last chunk of the message
+    };
+
+    /// @brief Counters updated by the server
+    struct Statistics
+    {
+        uint64_t numFramesQueued  = 0; ///< Frames queued for sending (counted once per connection)
+        uint64_t numSlowConsumers = 0; ///< Connections closed because their send queue was full
+    };
+
+    HttpWebSocketServer() {}
+    ~HttpWebSocketServer();
+    HttpWebSocketServer(const HttpWebSocketServer&)            = delete;
+    HttpWebSocketServer& operator=(const HttpWebSocketServer&) = delete;
+
+    /// @brief Prepares the server to accept connections on the given event loop
+    /// @param loop The event loop used by all connections (must be the same of the HttpServer upgrading them)
+    /// @param maxConnections Maximum number of concurrent connections
+    [[nodiscard]] Result start(AsyncEventLoop& loop, uint32_t maxConnections);
+
+    /// @brief Closes all connections
+    [[nodiscard]] Result stop();
+
+    /// @brief Takes ownership of an upgraded socket (typically from HttpServer::onUpgrade) and starts receiving
+    /// @param socket The socket, that will be moved into the server
+    /// @param key Receives the key identifying the new connection
+    [[nodiscard]] Result addConnection(SocketDescriptor& socket, Key& key);
+
+    /// @brief Queues a message (in a single frame) for sending to a connection
+    [[nodiscard]] Result send(Key key, Opcode opcode, Span<const char> data);
+
+    /// @brief Queues a message (serialized once in a single frame) for sending to all connections
+    [[nodiscard]] Result broadcast(Opcode opcode, Span<const char> data);
+
+    /// @brief Starts the closing handshake, sending a Close frame with the given status code
+    [[nodiscard]] Result close(Key key, uint16_t statusCode = 1000);
+
+    /// @brief Returns the number of open connections
+    [[nodiscard]] uint32_t getNumConnections() const { return numConnections; }
+
+    Function<void(Key, Message&)> onMessage; ///< Invoked for every chunk of every received Text or Binary message
+    Function<void(Key)>           onClose;   ///< Invoked after the socket of a connection has been closed
+
+    Statistics statistics;
+
+  private:
+    struct Connection
+    {
+        Key key;
+
+        SocketDescriptor   socket;
+        SocketDescriptor   sendSocket; // Duplicated descriptor used by sends (see HttpWebSocketServer::addConnection)
+        AsyncSocketReceive asyncReceive;
+        AsyncSocketSend    asyncSend[2]; // A send can't be started again from its own callback, so they alternate
+        AsyncSocketClose   asyncClose;
+
+        bool   receiving     = false;        // asyncReceive is waiting for data
+        bool   sending       = false;        // One of asyncSend is sending queue[queueStart]
+        bool   closeQueued   = false;        // A Close frame has been queued, socket is closed after sending it
+        bool   closing       = false;        // Socket has been shut down, waiting for pending requests to complete
+        bool   closeStarted  = false;        // asyncClose has been started
+        int    sendIndex     = 0;            // Index in asyncSend of the next send
+        bool   inMessage     = false;        // Receiving a fragmented message
+        bool   inPayload     = false;        // Receiving the payload of current frame
+        Opcode messageOpcode = Opcode::Text; // Opcode of the (eventually fragmented) message being received
+
+        HttpWebSocket::FrameHeader frame;              // Header of the frame being received
+        uint64_t                   payloadOffset = 0; // Payload bytes received for current frame
+        size_t                     headerSize    = 0; // Bytes of a partially received frame header
+        char headerBytes[HttpWebSocket::MaxFrameHeaderSize];
+        char controlPayload[HttpWebSocket::MaxControlPayload];
+
+        Frame* queue[MaxQueuedFrames];
+        size_t queueStart = 0;
+        size_t queueSize  = 0;
+
+        char receiveBuffer[4096];
+    };
+    ArenaMap<Connection> connections;
+    AsyncEventLoop*      eventLoop      = nullptr;
+    uint32_t             numConnections = 0;
+
+    struct Internal;
+};
+
+//! @}
@@ -0,0 +1,164 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../HttpRouter.h"
+#include "../../Testing/Testing.h"
+
+namespace SC
+{
+struct HttpRouterTest;
+}
+
+struct SC::HttpRouterTest : public SC::TestCase
+{
+    HttpRouterTest(SC::TestReport& report) : TestCase(report, "HttpRouterTest")
+    {
+        using Method = HttpParser::Method;
+        if (test_section("static"))
+        {
+            HttpRouter router;
+            int        which = 0;
+            SC_TEST_EXPECT(router.addRoute(Method::HttpGET, "/", [&](auto&, const auto&) { which = 1; }));
+            SC_TEST_EXPECT(router.addRoute(Method::HttpGET, "/users", [&](auto&, const auto&) { which = 2; }));
+            SC_TEST_EXPECT(router.addRoute(Method::HttpGET, "/user", [&](auto&, const auto&) { which = 3; }));
+            SC_TEST_EXPECT(router.addRoute(Method::HttpGET, "/uploads", [&](auto&, const auto&) { which = 4; }));
+            SC_TEST_EXPECT(router.addRoute(Method::HttpPOST, "/users", [&](auto&, const auto&) { which = 5; }));
+            SC_TEST_EXPECT(not router.addRoute(Method::HttpGET, "/users", [&](auto&, const auto&) {}));
+            SC_TEST_EXPECT(not router.addRoute(Method::HttpGET, "users", [&](auto&, const auto&) {}));
+
+            HttpRouter::Match         match;
+            bool                      notAllowed = false;
+            HttpServer::ClientChannel channel;
+
+            const HttpRouter::Handler* handler;
+            const StringView           urls[]   = {"/", "/users", "/user", "/uploads"};
+            const int                  values[] = {1, 2, 3, 4};
+            for (size_t idx = 0; idx < 4; ++idx)
+            {
+                handler = router.find(Method::HttpGET, urls[idx], match, notAllowed);
+                SC_TEST_EXPECT(handler != nullptr);
+                if (handler)
+                {
+                    (*handler)(channel, match);
+                }
+                SC_TEST_EXPECT(which == values[idx]);
+            }
+            handler = router.find(Method::HttpPOST, "/users?x=1", match, notAllowed);
+            SC_TEST_EXPECT(handler != nullptr and match.query == "x=1");
+            SC_TEST_EXPECT(router.find(Method::HttpGET, "/use", match, notAllowed) == nullptr and not notAllowed);
+            SC_TEST_EXPECT(router.find(Method::HttpGET, "/usersx", match, notAllowed) == nullptr);
+            SC_TEST_EXPECT(router.find(Method::HttpPUT, "/users", match, notAllowed) == nullptr and notAllowed);
+        }
+        if (test_section("parameters"))
+        {
+            //! [HttpRouterSnippet]
+            HttpRouter router;
+            StringView ids[2]; // user id and post id
+            SC_TEST_EXPECT(router.addRoute(Method::HttpGET, "/users/:id/posts/:post",
+                                           [&](HttpServer::ClientChannel&, const HttpRouter::Match& match)
+                                           {
+                                               SC_TEST_EXPECT(match.getParameter("id", ids[0]));
+                                               SC_TEST_EXPECT(match.getParameter("post", ids[1]));
+                                           }));
+            //! [HttpRouterSnippet]
+            SC_TEST_EXPECT(router.addRoute(Method::HttpGET, "/users/me/posts/:post", [&](auto&, const auto&) {}));
+            SC_TEST_EXPECT(router.addRoute(Method::HttpGET, "/users/:id", [&](auto&, const auto&) {}));
+            SC_TEST_EXPECT(not router.addRoute(Method::HttpGET, "/users/:name/likes", [&](auto&, const auto&) {}));
+            SC_TEST_EXPECT(not router.addRoute(Method::HttpGET, "/users/:", [&](auto&, const auto&) {}));
+
+            HttpRouter::Match match;
+            bool              notAllowed = false;
+
+            HttpServer::ClientChannel  channel;
+            const HttpRouter::Handler* handler = router.find(Method::HttpGET, "/users/12/posts/3", match, notAllowed);
+            SC_TEST_EXPECT(handler != nullptr and match.numParameters == 2);
+            if (handler)
+            {
+                (*handler)(channel, match);
+            }
+            SC_TEST_EXPECT(ids[0] == "12" and ids[1] == "3");
+
+            // Static segments win over parameters
+            SC_TEST_EXPECT(router.find(Method::HttpGET, "/users/me/posts/7", match, notAllowed) != nullptr);
+            SC_TEST_EXPECT(match.numParameters == 1 and match.parameters[0].value == "7");
+
+            // Backtracks from the static "me" branch to the parameter one
+            SC_TEST_EXPECT(router.find(Method::HttpGET, "/users/me", match, notAllowed) != nullptr);
+            SC_TEST_EXPECT(match.numParameters == 1 and match.parameters[0].value == "me");
+
+            SC_TEST_EXPECT(router.find(Method::HttpGET, "/users/", match, notAllowed) == nullptr);
+            SC_TEST_EXPECT(router.find(Method::HttpGET, "/users/12/posts", match, notAllowed) == nullptr);
+        }
+        if (test_section("wildcard"))
+        {
+            HttpRouter router;
+            SC_TEST_EXPECT(router.addRoute(Method::HttpGET, "/static/*", [&](auto&, const auto&) {}));
+            SC_TEST_EXPECT(router.addRoute(Method::HttpGET, "/static/index.html", [&](auto&, const auto&) {}));
+            SC_TEST_EXPECT(not router.addRoute(Method::HttpGET, "/files/*/x", [&](auto&, const auto&) {}));
+
+            HttpRouter::Match match;
+            bool              notAllowed = false;
+            SC_TEST_EXPECT(router.find(Method::HttpGET, "/static/css/main.css", match, notAllowed) != nullptr);
+            SC_TEST_EXPECT(match.wildcard == "css/main.css");
+            SC_TEST_EXPECT(router.find(Method::HttpGET, "/static/index.html", match, notAllowed) != nullptr);
+            SC_TEST_EXPECT(match.wildcard.isEmpty());
+            SC_TEST_EXPECT(router.find(Method::HttpGET, "/static/", match, notAllowed) != nullptr);
+            SC_TEST_EXPECT(router.find(Method::HttpPOST, "/static/a", match, notAllowed) == nullptr and notAllowed);
+        }
+        if (test_section("invalid patterns"))
+        {
+            // Patterns failing validation must not leave nodes behind, that would conflict with later routes
+            HttpRouter router;
+            SC_TEST_EXPECT(not router.addRoute(Method::HttpGET, "/p/:a/:b/:c/:d/:e/:f/:g/:h/:i",
+                                               [&](auto&, const auto&) {}));
+            SC_TEST_EXPECT(router.addRoute(Method::HttpGET, "/p/:x", [&](auto&, const auto&) {}));
+            SC_TEST_EXPECT(not router.addRoute(Method::HttpGET, "/w/:name/*/x", [&](auto&, const auto&) {}));
+            SC_TEST_EXPECT(not router.addRoute(Method::HttpGET, "/w/:name/a:b", [&](auto&, const auto&) {}));
+            SC_TEST_EXPECT(router.addRoute(Method::HttpGET, "/w/:id", [&](auto&, const auto&) {}));
+            SC_TEST_EXPECT(not router.addRoute(Method::HttpGET, "/w/:other", [&](auto&, const auto&) {}));
+            SC_TEST_EXPECT(router.addRoute(Method::HttpPUT, "/w/:id", [&](auto&, const auto&) {}));
+
+            HttpRouter::Match match;
+            bool              notAllowed = false;
+            SC_TEST_EXPECT(router.find(Method::HttpGET, "/p/1", match, notAllowed) != nullptr);
+            SC_TEST_EXPECT(match.numParameters == 1 and match.parameters[0].name == "x");
+            SC_TEST_EXPECT(router.find(Method::HttpPUT, "/w/2", match, notAllowed) != nullptr);
+            SC_TEST_EXPECT(match.numParameters == 1 and match.parameters[0].name == "id");
+            SC_TEST_EXPECT(router.find(Method::HttpGET, "/w/2/x", match, notAllowed) == nullptr and not notAllowed);
+        }
+        if (test_section("dispatch"))
+        {
+            HttpRouter router;
+            SC_TEST_EXPECT(router.addRoute(Method::HttpGET, "/index.html",
+                                           [&](HttpServer::ClientChannel& client, const HttpRouter::Match&)
+                                           {
+                                               SC_TEST_EXPECT(client.response.startResponse(200));
+                                               SC_TEST_EXPECT(client.response.end("OK"));
+                                           }));
+            HttpServer::ClientChannel channel;
+            channel.request.url = "/index.html";
+            SC_TEST_EXPECT(router.dispatch(channel));
+            SC_TEST_EXPECT(StringView(channel.response.outputBuffer.toSpanConst(), false, StringEncoding::Ascii)
+                               .startsWith("HTTP/1.1 200 OK"));
+            channel.request.url = "/missing";
+            SC_TEST_EXPECT(router.dispatch(channel));
+            SC_TEST_EXPECT(StringView(channel.response.outputBuffer.toSpanConst(), false, StringEncoding::Ascii)
+                               .startsWith("HTTP/1.1 404 Not Found"));
+            channel.request.url           = "/index.html";
+            channel.request.parser.method = Method::HttpPOST;
+            SC_TEST_EXPECT(router.dispatch(channel));
+            StringView response(channel.response.outputBuffer.toSpanConst(), false, StringEncoding::Ascii);
+            SC_TEST_EXPECT(response.startsWith("HTTP/1.1 405 Method Not Allowed\r\n"));
+            SC_TEST_EXPECT(response.containsString("\r\nAllow: GET\r\n"));
+
+            SC_TEST_EXPECT(router.addRoute(Method::HttpPUT, "/index.html", [&](auto&, const auto&) {}));
+            SC_TEST_EXPECT(router.dispatch(channel));
+            response = StringView(channel.response.outputBuffer.toSpanConst(), false, StringEncoding::Ascii);
+            SC_TEST_EXPECT(response.containsString("\r\nAllow: GET, PUT\r\n"));
+        }
+    }
+};
+
+namespace SC
+{
+void runHttpRouterTest(SC::TestReport& report) { HttpRouterTest test(report); }
+} // namespace SC
@@ -1,6 +1,7 @@
 // Copyright (c) Stefano Cristiano
 // SPDX-License-Identifier: MIT
 #include "../HttpServer.h"
+#include "../../Foundation/LibC.h" // memset
 #include "../../Strings/StringBuilder.h"
 #include "../../Testing/Testing.h"
 #include "../HttpClient.h"
@@ -11,6 +12,142 @@ struct HttpServerTest;
 
 struct SC::HttpServerTest : public SC::TestCase
 {
+    // Sends multiple requests on the same connection, checking that the server keeps it alive
+    struct KeepAliveClient
+    {
+        HttpServer*     server    = nullptr;
+        AsyncEventLoop* eventLoop = nullptr;
+
+        SocketDescriptor   socket;
+        AsyncSocketConnect asyncConnect;
+        AsyncSocketSend    asyncSend;
+        AsyncSocketReceive asyncReceive;
+
+        char receiveBuffer[256];
+        int  numResponses = 0;
+        int  numErrors    = 0;
+
+        static constexpr int wantedResponses = 3;
+
+        // Invoked after receiving all responses (if not set the socket is closed and the server is stopped)
+        Function<void(KeepAliveClient&)> onFinished;
+
+        void check(bool value) { numErrors += value ? 0 : 1; }
+
+        void start(HttpServer& httpServer, AsyncEventLoop& loop, SocketIPAddress address)
+        {
+            server    = &httpServer;
+            eventLoop = &loop;
+            check(eventLoop->createAsyncTCPSocket(address.getAddressFamily(), socket));
+            asyncConnect.callback.bind<KeepAliveClient, &KeepAliveClient::onConnected>(*this);
+            check(asyncConnect.start(*eventLoop, socket, address));
+        }
+
+        void onConnected(AsyncSocketConnect::Result& result)
+        {
+            check(result.isValid());
+            sendRequest();
+        }
+
+        void sendRequest()
+        {
+            asyncSend.callback.bind<KeepAliveClient, &KeepAliveClient::onSent>(*this);
+            check(asyncSend.start(*eventLoop, socket, StringView("GET / HTTP/1.1\r\n\r\n").toCharSpan()));
+        }
+
+        void onSent(AsyncSocketSend::Result& result)
+        {
+            check(result.isValid());
+            asyncReceive.callback.bind<KeepAliveClient, &KeepAliveClient::onReceived>(*this);
+            check(asyncReceive.start(*eventLoop, socket, {receiveBuffer, sizeof(receiveBuffer)}));
+        }
+
+        void onReceived(AsyncSocketReceive::Result& result)
+        {
+            Span<char> data;
+            check(result.get(data));
+            const StringView response(data, false, StringEncoding::Ascii);
+            check(response.startsWith("HTTP/1.1 200 OK\r\n") and response.endsWith("\r\n\r\nOK"));
+            numResponses++;
+            if (numResponses < wantedResponses)
+            {
+                sendRequest();
+            }
+            else if (onFinished.isValid())
+            {
+                onFinished(*this);
+            }
+            else
+            {
+                check(SocketClient(socket).close());
+                check(server->stop());
+            }
+        }
+    };
+
+    // Sends a single request, waiting for the server to close the connection
+    struct ClosingClient
+    {
+        AsyncEventLoop* eventLoop = nullptr;
+
+        StringView request;
+
+        SocketDescriptor   socket;
+        AsyncSocketConnect asyncConnect;
+        AsyncSocketSend    asyncSend;
+        AsyncSocketReceive asyncReceive;
+
+        char receiveBuffer[256];
+        int  numResponses = 0;
+        int  numErrors    = 0;
+        bool closed       = false; // Server has closed the connection after the response
+
+        void check(bool value) { numErrors += value ? 0 : 1; }
+
+        void start(AsyncEventLoop& loop, SocketIPAddress address, StringView requestToSend)
+        {
+            eventLoop = &loop;
+            request   = requestToSend;
+            check(eventLoop->createAsyncTCPSocket(address.getAddressFamily(), socket));
+            asyncConnect.callback.bind<ClosingClient, &ClosingClient::onConnected>(*this);
+            check(asyncConnect.start(*eventLoop, socket, address));
+        }
+
+        void onConnected(AsyncSocketConnect::Result& result)
+        {
+            check(result.isValid());
+            asyncSend.callback.bind<ClosingClient, &ClosingClient::onSent>(*this);
+            check(asyncSend.start(*eventLoop, socket, request.toCharSpan()));
+        }
+
+        void onSent(AsyncSocketSend::Result& result)
+        {
+            if (not result.isValid())
+            {
+                closed = true; // Connection dropped by the server before reading the request
+                check(SocketClient(socket).close());
+                return;
+            }
+            asyncReceive.callback.bind<ClosingClient, &ClosingClient::onReceived>(*this);
+            check(asyncReceive.start(*eventLoop, socket, {receiveBuffer, sizeof(receiveBuffer)}));
+        }
+
+        void onReceived(AsyncSocketReceive::Result& result)
+        {
+            Span<char> data;
+            if (not result.get(data) or data.empty())
+            {
+                closed = true; // Connection closed or reset by the server
+                check(SocketClient(socket).close());
+                return;
+            }
+            const StringView response(data, false, StringEncoding::Ascii);
+            check(response.startsWith("HTTP/1.1 200 OK\r\n") and response.endsWith("Connection: close\r\n\r\nOK"));
+            numResponses++;
+            result.reactivateRequest(true); // Wait for the server to close the connection
+        }
+    };
+
     static constexpr int wantedNumTries = 3;
 
     int numTries = 0;
@@ -45,10 +182,8 @@ struct SC::HttpServerTest : public SC::TestCase
                     SC_TEST_EXPECT(server.stop());
                 }
                 SC_TEST_EXPECT(res.startResponse(200));
-                SC_TEST_EXPECT(res.addHeader("Connection", "Closed"));
                 SC_TEST_EXPECT(res.addHeader("Content-Type", "text/html"));
                 SC_TEST_EXPECT(res.addHeader("Server", "SC"));
-                SC_TEST_EXPECT(res.addHeader("Date", "Mon, 27 Aug 2023 16:37:00 GMT"));
                 SC_TEST_EXPECT(res.addHeader("Last-Modified", "Wed, 27 Aug 2023 16:37:00 GMT"));
                 String        str;
                 StringBuilder sb(str);
@@ -69,13 +204,221 @@ struct SC::HttpServerTest : public SC::TestCase
                 SC_TEST_EXPECT(sb.format("HttpClient [{}]", i));
                 SC_TEST_EXPECT(client[i].setCustomDebugName(buffer.view()));
                 client[i].callback = [this](HttpClient& result)
-                { SC_TEST_EXPECT(result.getResponse().containsString("This is a title")); };
+                {
+                    SC_TEST_EXPECT(result.getResponse().containsString("This is a title"));
+                    SC_TEST_EXPECT(result.getResponse().containsString("\r\nDate: "));
+                };
                 SC_TEST_EXPECT(client[i].get(eventLoop, "http://localhost:6152/index.html"));
             }
             SC_TEST_EXPECT(eventLoop.run());
             SC_TEST_EXPECT(numTries == wantedNumTries);
             SC_TEST_EXPECT(eventLoop.close());
         }
+        if (test_section("keep alive"))
+        {
+            AsyncEventLoop eventLoop;
+            SC_TEST_EXPECT(eventLoop.create());
+            HttpServer server;
+            SC_TEST_EXPECT(server.start(eventLoop, 2, "127.0.0.1", 6153));
+            int numRequests = 0;
+            server.onClient = [this, &numRequests](HttpServer::ClientChannel& client)
+            {
+                numRequests++;
+                SC_TEST_EXPECT(client.response.startResponse(200));
+                SC_TEST_EXPECT(client.response.end("OK"));
+            };
+            SocketIPAddress address;
+            SC_TEST_EXPECT(address.fromAddressPort("127.0.0.1", 6153));
+            KeepAliveClient keepAlive;
+            keepAlive.start(server, eventLoop, address);
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(keepAlive.numErrors == 0);
+            SC_TEST_EXPECT(numRequests == KeepAliveClient::wantedResponses);
+            SC_TEST_EXPECT(keepAlive.numResponses == KeepAliveClient::wantedResponses);
+            SC_TEST_EXPECT(server.arenaStatistics.numOverflows == 0);
+            SC_TEST_EXPECT(server.arenaStatistics.peakUsedBytes > 0);
+            SC_TEST_EXPECT(eventLoop.close());
+        }
+        if (test_section("connection close"))
+        {
+            AsyncEventLoop eventLoop;
+            SC_TEST_EXPECT(eventLoop.create());
+            HttpServer server;
+            SC_TEST_EXPECT(server.start(eventLoop, 4, "127.0.0.1", 6155));
+            int numRequests = 0;
+            server.onClient = [this, &numRequests](HttpServer::ClientChannel& client)
+            {
+                SC_TEST_EXPECT(not client.request.keepAlive);
+                SC_TEST_EXPECT(client.response.startResponse(200));
+                SC_TEST_EXPECT(client.response.end("OK"));
+                numRequests++;
+            };
+            SocketIPAddress address;
+            SC_TEST_EXPECT(address.fromAddressPort("127.0.0.1", 6155));
+            // HTTP/1.1 client asking to close the connection and HTTP/1.0 client not asking to keep it alive
+            ClosingClient clients[2];
+            clients[0].start(eventLoop, address, "GET / HTTP/1.1\r\nConnection: close\r\n\r\n");
+            clients[1].start(eventLoop, address, "GET / HTTP/1.0\r\nHost: x\r\n\r\n");
+            bool stopped = false;
+            while (not stopped)
+            {
+                SC_TEST_EXPECT(eventLoop.runOnce());
+                if (clients[0].closed and clients[1].closed)
+                {
+                    SC_TEST_EXPECT(server.stop());
+                    stopped = true;
+                }
+            }
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(numRequests == 2);
+            for (ClosingClient& client : clients)
+            {
+                SC_TEST_EXPECT(client.numErrors == 0 and client.numResponses == 1 and client.closed);
+            }
+            SC_TEST_EXPECT(eventLoop.close());
+        }
+        if (test_section("connection slots"))
+        {
+            AsyncEventLoop eventLoop;
+            SC_TEST_EXPECT(eventLoop.create());
+            HttpServer server;
+            SC_TEST_EXPECT(server.start(eventLoop, 1, "127.0.0.1", 6156));
+            server.onClient = [this](HttpServer::ClientChannel& client)
+            {
+                SC_TEST_EXPECT(client.response.startResponse(200));
+                SC_TEST_EXPECT(client.response.end("OK"));
+            };
+            SocketIPAddress address;
+            SC_TEST_EXPECT(address.fromAddressPort("127.0.0.1", 6156));
+            // Connections accepted while no ClientChannel is available are dropped without leaking slots
+            auto taken = server.requests.allocate();
+            SC_TEST_EXPECT(taken.isValid());
+            ClosingClient refused[2];
+            for (ClosingClient& client : refused)
+            {
+                client.start(eventLoop, address, "GET / HTTP/1.1\r\n\r\n");
+            }
+            while (not refused[0].closed or not refused[1].closed)
+            {
+                SC_TEST_EXPECT(eventLoop.runOnce());
+            }
+            for (ClosingClient& client : refused)
+            {
+                SC_TEST_EXPECT(client.numResponses == 0);
+            }
+            SC_TEST_EXPECT(server.requests.remove(taken));
+            KeepAliveClient keepAlive;
+            keepAlive.start(server, eventLoop, address);
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(keepAlive.numErrors == 0);
+            SC_TEST_EXPECT(keepAlive.numResponses == KeepAliveClient::wantedResponses);
+            SC_TEST_EXPECT(eventLoop.close());
+        }
+        if (test_section("many connections"))
+        {
+            // Connections span multiple chunks of the server maps, that are emptied while closing all of them
+            constexpr int numClients = 150;
+            struct Context
+            {
+                HttpServer      server;
+                KeepAliveClient clients[numClients];
+                int             numFinished = 0;
+            };
+            AsyncEventLoop eventLoop;
+            SC_TEST_EXPECT(eventLoop.create());
+            Context context;
+            SC_TEST_EXPECT(context.server.start(eventLoop, numClients, "127.0.0.1", 6154));
+            context.server.onClient = [this](HttpServer::ClientChannel& client)
+            {
+                SC_TEST_EXPECT(client.response.startResponse(200));
+                SC_TEST_EXPECT(client.response.end("OK"));
+            };
+            SocketIPAddress address;
+            SC_TEST_EXPECT(address.fromAddressPort("127.0.0.1", 6154));
+            for (KeepAliveClient& client : context.clients)
+            {
+                client.onFinished = [&context](KeepAliveClient&)
+                {
+                    // All connections are kept open until the last client has received all of its responses
+                    if (++context.numFinished == numClients)
+                    {
+                        for (KeepAliveClient& it : context.clients)
+                        {
+                            it.check(SocketClient(it.socket).close());
+                        }
+                        (void)context.server.stop();
+                    }
+                };
+                client.start(context.server, eventLoop, address);
+            }
+            SC_TEST_EXPECT(eventLoop.run());
+            for (KeepAliveClient& client : context.clients)
+            {
+                SC_TEST_EXPECT(client.numErrors == 0 and client.numResponses == KeepAliveClient::wantedResponses);
+            }
+            SC_TEST_EXPECT(context.numFinished == numClients);
+            SC_TEST_EXPECT(eventLoop.close());
+        }
+        if (test_section("arena"))
+        {
+            HttpServer server;
+            server.clientArenaSize = 1024;
+            HttpServer::ClientChannel client;
+            SC_TEST_EXPECT(client.create(server.clientArenaSize));
+            SC_TEST_EXPECT(client.request.headerBuffer.getAllocator() == &client.arena);
+            SC_TEST_EXPECT(client.response.outputBuffer.getAllocator() == &client.arena);
+
+            SC_TEST_EXPECT(client.request.headerBuffer.append(StringView("GET / HTTP/1.1\r\n").toCharSpan()));
+            SC_TEST_EXPECT(client.request.headerBuffer.append(StringView("Host: x\r\n\r\n").toCharSpan()));
+            SC_TEST_EXPECT(client.response.startResponse(200));
+            SC_TEST_EXPECT(client.response.end("OK"));
+            SC_TEST_EXPECT(StringView(client.response.outputBuffer.toSpanConst(), false, StringEncoding::Ascii)
+                               .endsWith("Content-Length: 2\r\n\r\nOK"));
+            server.resetClient(client);
+            SC_TEST_EXPECT(server.arenaStatistics.numOverflows == 0 and server.arenaStatistics.peakUsedBytes > 0);
+
+            // Reset rewinds the arena, keeping buffers allocated from it
+            SC_TEST_EXPECT(client.arena.getBytesUsed() < 64 and client.response.outputBuffer.isEmpty());
+            SC_TEST_EXPECT(client.response.outputBuffer.getAllocator() == &client.arena);
+
+            // Requests using more than clientArenaSize bytes are counted
+            char body[2048];
+            ::memset(body, 'x', sizeof(body));
+            SC_TEST_EXPECT(client.response.startResponse(200));
+            SC_TEST_EXPECT(client.response.end(StringView({body, sizeof(body)}, false, StringEncoding::Ascii)));
+            server.resetClient(client);
+            SC_TEST_EXPECT(server.arenaStatistics.numOverflows == 1 and server.arenaStatistics.overflowBytes > 0);
+            SC_TEST_EXPECT(server.arenaStatistics.peakUsedBytes > sizeof(body));
+        }
+        if (test_section("header block"))
+        {
+            HttpServer::HeaderBlock commonHeaders;
+            SC_TEST_EXPECT(commonHeaders.startResponse(200));
+            SC_TEST_EXPECT(commonHeaders.addHeader("Server", "SC"));
+            SC_TEST_EXPECT(not commonHeaders.startResponse(200));
+
+            HttpServer::HeaderBlock htmlHeaders;
+            SC_TEST_EXPECT(htmlHeaders.addHeader("Content-Type", "text/html"));
+
+            HttpServer::DateHeader dateHeader;
+            SC_TEST_EXPECT(dateHeader.format(Time::Absolute(784111777000)));
+
+            HttpServer::Response response;
+            response.dateHeader = &dateHeader;
+            SC_TEST_EXPECT(not response.startResponse(htmlHeaders));
+            SC_TEST_EXPECT(not response.addHeaders(commonHeaders));
+            SC_TEST_EXPECT(response.startResponse(commonHeaders));
+            SC_TEST_EXPECT(response.addHeaders(htmlHeaders));
+            SC_TEST_EXPECT(response.end("Hello"));
+            const StringView output(response.outputBuffer.toSpanConst(), false, StringEncoding::Ascii);
+            SC_TEST_EXPECT(output == "HTTP/1.1 200 OK\r\n"
+                                     "Server: SC\r\n"
+                                     "Date: Sun, 06 Nov 1994 08:49:37 GMT\r\n"
+                                     "Content-Type: text/html\r\n"
+                                     "Content-Length: 5\r\n\r\n"
+                                     "Hello");
+            SC_TEST_EXPECT(not response.startResponse(999));
+        }
     }
 };
 
@@ -0,0 +1,247 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../HttpWebSocket.h"
+#include "../../Containers/Vector.h"
+#include "../../Testing/Testing.h"
+#include "../../Threading/Threading.h"
+
+namespace SC
+{
+struct HttpWebSocketTest;
+}
+
+struct SC::HttpWebSocketTest : public SC::TestCase
+{
+    using Opcode = HttpWebSocket::Opcode;
+
+    Vector<char> message;
+
+    // Blocking WebSocket client, running on its own thread
+    struct Client
+    {
+        SocketDescriptor socket;
+
+        char   buffer[1024];
+        size_t bufferSize = 0;
+        int    numErrors  = 0;
+
+        void check(bool value) { numErrors += value ? 0 : 1; }
+
+        [[nodiscard]] bool handshake(uint16_t port)
+        {
+            SC_TRY(socket.create(SocketFlags::AddressFamilyIPV4));
+            SC_TRY(SocketClient(socket).connect("127.0.0.1", port));
+            SC_TRY(SocketClient(socket).write(StringView("GET /chat HTTP/1.1\r\n"
+                                                         "Host: 127.0.0.1\r\n"
+                                                         "Upgrade: websocket\r\n"
+                                                         "Connection: keep-alive, Upgrade\r\n"
+                                                         "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                                                         "Sec-WebSocket-Version: 13\r\n\r\n")
+                                                  .toCharSpan()));
+            // Server doesn't send frames before receiving one, so the response is all that can be received
+            while (not StringView({buffer, bufferSize}, false, StringEncoding::Ascii).endsWith("\r\n\r\n"))
+            {
+                SC_TRY(receive());
+            }
+            const StringView response({buffer, bufferSize}, false, StringEncoding::Ascii);
+            bufferSize = 0;
+            return response.startsWith("HTTP/1.1 101 Switching Protocols\r\n") and
+                   response.containsString("\r\nSec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=\r\n");
+        }
+
+        [[nodiscard]] bool receive()
+        {
+            Span<char> readData;
+            SC_TRY(SocketClient(socket).read({buffer + bufferSize, sizeof(buffer) - bufferSize}, readData));
+            bufferSize += readData.sizeInBytes();
+            return not readData.empty();
+        }
+
+        [[nodiscard]] bool sendFrame(Opcode opcode, StringView payload, bool fin = true)
+        {
+            HttpWebSocket::FrameHeader header;
+            header.opcode        = opcode;
+            header.fin           = fin;
+            header.masked        = true;
+            header.payloadLength = payload.sizeInBytes();
+            header.mask[0]       = 0x37;
+            header.mask[1]       = 0xfa;
+            header.mask[2]       = 0x21;
+            header.mask[3]       = 0x3d;
+
+            char   frame[HttpWebSocket::MaxFrameHeaderSize + 128];
+            size_t length = HttpWebSocket::writeFrameHeader(header, *reinterpret_cast<char(*)[14]>(frame));
+            ::memcpy(frame + length, payload.bytesWithoutTerminator(), payload.sizeInBytes());
+            HttpWebSocket::applyMask({frame + length, payload.sizeInBytes()}, header.mask, 0);
+            return SocketClient(socket).write({frame, length + payload.sizeInBytes()});
+        }
+
+        [[nodiscard]] bool receiveFrame(Opcode opcode, StringView payload)
+        {
+            HttpWebSocket::FrameHeader header;
+            size_t                     headerLength = 0;
+            while (true)
+            {
+                SC_TRY(HttpWebSocket::parseFrameHeader({buffer, bufferSize}, header, headerLength));
+                if (headerLength > 0 and bufferSize >= headerLength + header.payloadLength)
+                    break;
+                SC_TRY(receive());
+            }
+            const size_t frameLength = headerLength + static_cast<size_t>(header.payloadLength);
+            const bool   matches     = not header.masked and header.fin and header.opcode == opcode and
+                                 StringView({buffer + headerLength, static_cast<size_t>(header.payloadLength)}, false,
+                                            StringEncoding::Ascii) == payload;
+            ::memmove(buffer, buffer + frameLength, bufferSize - frameLength);
+            bufferSize -= frameLength;
+            return matches;
+        }
+
+        void run(uint16_t port)
+        {
+            check(handshake(port));
+            // A message fragmented in two frames with a ping in between
+            check(sendFrame(Opcode::Text, "Hello ", false));
+            check(sendFrame(Opcode::Ping, "ping"));
+            check(sendFrame(Opcode::Continuation, "WebSocket"));
+            check(receiveFrame(Opcode::Pong, "ping"));
+            check(receiveFrame(Opcode::Text, "Hello WebSocket"));
+            // Ask for a broadcast, received by all connections (just this one)
+            check(sendFrame(Opcode::Binary, "broadcast"));
+            check(receiveFrame(Opcode::Binary, "to everyone"));
+            // Closing handshake (status code 1000 is echoed back)
+            const StringView statusCode({"\x03\xe8", 2}, false, StringEncoding::Ascii);
+            check(sendFrame(Opcode::Close, statusCode));
+            check(receiveFrame(Opcode::Close, statusCode));
+            check(not receive()); // Server has closed the connection
+        }
+    };
+
+    HttpWebSocketTest(SC::TestReport& report) : TestCase(report, "HttpWebSocketTest")
+    {
+        if (test_section("frame header"))
+        {
+            const uint64_t lengths[] = {0, 5, 125, 126, 300, 65535, 65536, 70000};
+            for (const uint64_t length : lengths)
+            {
+                HttpWebSocket::FrameHeader header;
+                header.opcode        = Opcode::Binary;
+                header.fin           = length % 2 == 0;
+                header.masked        = length > 200;
+                header.mask[2]       = 0xab;
+                header.payloadLength = length;
+
+                char         buffer[HttpWebSocket::MaxFrameHeaderSize];
+                const size_t written = HttpWebSocket::writeFrameHeader(header, buffer);
+                const size_t lengthBytes = length < 126 ? 0 : length <= 65535 ? 2 : 8;
+                SC_TEST_EXPECT(written == 2 + lengthBytes + (header.masked ? 4 : 0));
+
+                HttpWebSocket::FrameHeader parsed;
+                size_t                     headerLength;
+                SC_TEST_EXPECT(HttpWebSocket::parseFrameHeader({buffer, written - 1}, parsed, headerLength));
+                SC_TEST_EXPECT(headerLength == 0); // Incomplete
+                SC_TEST_EXPECT(HttpWebSocket::parseFrameHeader({buffer, written}, parsed, headerLength));
+                SC_TEST_EXPECT(headerLength == written and parsed.payloadLength == length);
+                SC_TEST_EXPECT(parsed.opcode == Opcode::Binary and parsed.fin == header.fin);
+                SC_TEST_EXPECT(parsed.masked == header.masked and parsed.mask[2] == (header.masked ? 0xab : 0));
+            }
+            HttpWebSocket::FrameHeader parsed;
+            size_t                     headerLength;
+            SC_TEST_EXPECT(not HttpWebSocket::parseFrameHeader({"\xc1\x00", 2}, parsed, headerLength)); // Reserved
+            SC_TEST_EXPECT(not HttpWebSocket::parseFrameHeader({"\x83\x00", 2}, parsed, headerLength)); // Opcode
+            SC_TEST_EXPECT(not HttpWebSocket::parseFrameHeader({"\x09\x00", 2}, parsed, headerLength)); // Fragmented
+            SC_TEST_EXPECT(not HttpWebSocket::parseFrameHeader({"\x89\x7e\x00\x7e", 4}, parsed, headerLength));
+        }
+        if (test_section("masking"))
+        {
+            const uint8_t mask[4] = {0x12, 0x34, 0x56, 0x78};
+
+            char original[67];
+            for (size_t idx = 0; idx < sizeof(original); ++idx)
+            {
+                original[idx] = static_cast<char>(idx * 7);
+            }
+            // Masking in chunks (starting at any offset) must give the same result of byte by byte masking
+            const size_t splits[] = {0, 1, 3, 8, 13, 66, 67};
+            for (const size_t split : splits)
+            {
+                char masked[sizeof(original)];
+                ::memcpy(masked, original, sizeof(original));
+                HttpWebSocket::applyMask({masked, split}, mask, 0);
+                HttpWebSocket::applyMask({masked + split, sizeof(masked) - split}, mask, split);
+                bool matches = true;
+                for (size_t idx = 0; idx < sizeof(original); ++idx)
+                {
+                    matches &= masked[idx] == static_cast<char>(original[idx] ^ mask[idx % 4]);
+                }
+                SC_TEST_EXPECT(matches);
+                HttpWebSocket::applyMask({masked, sizeof(masked)}, mask, 0);
+                SC_TEST_EXPECT(::memcmp(masked, original, sizeof(original)) == 0);
+            }
+        }
+        if (test_section("accept key"))
+        {
+            // Example from RFC 6455
+            char acceptKey[HttpWebSocket::AcceptKeyLength];
+            SC_TEST_EXPECT(HttpWebSocket::computeAcceptKey("dGhlIHNhbXBsZSBub25jZQ==", acceptKey));
+            SC_TEST_EXPECT(StringView({acceptKey, sizeof(acceptKey)}, false, StringEncoding::Ascii) ==
+                           "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=");
+        }
+        if (test_section("server"))
+        {
+            constexpr uint16_t port = 6155;
+            //! [HttpWebSocketSnippet]
+            AsyncEventLoop eventLoop;
+            SC_TEST_EXPECT(eventLoop.create());
+            HttpServer          httpServer;
+            HttpWebSocketServer webSocketServer;
+            SC_TEST_EXPECT(httpServer.start(eventLoop, 16, "127.0.0.1", port));
+            SC_TEST_EXPECT(webSocketServer.start(eventLoop, 16));
+
+            // Upgrade requests are accepted by the http server...
+            httpServer.onClient = [this](HttpServer::ClientChannel& client)
+            {
+                SC_TEST_EXPECT(HttpWebSocket::isUpgradeRequest(client.request));
+                SC_TEST_EXPECT(HttpWebSocket::acceptUpgrade(client));
+            };
+            // ...that hands over the socket to the WebSocket server
+            httpServer.onUpgrade = [this, &webSocketServer](HttpServer::ClientChannel&, SocketDescriptor& socket)
+            {
+                HttpWebSocketServer::Key key;
+                SC_TEST_EXPECT(webSocketServer.addConnection(socket, key));
+            };
+
+            webSocketServer.onMessage = [this, &webSocketServer](HttpWebSocketServer::Key      key,
+                                                                 HttpWebSocketServer::Message& chunk)
+            {
+                if (chunk.opcode == Opcode::Binary)
+                {
+                    SC_TEST_EXPECT(webSocketServer.broadcast(Opcode::Binary, StringView("to everyone").toCharSpan()));
+                    return;
+                }
+                SC_TEST_EXPECT(message.append(chunk.data)); // Accumulates chunks of fragmented messages
+                if (chunk.last)
+                {
+                    SC_TEST_EXPECT(webSocketServer.send(key, Opcode::Text, message.toSpanConst()));
+                }
+            };
+            //! [HttpWebSocketSnippet]
+            webSocketServer.onClose = [this, &httpServer](HttpWebSocketServer::Key)
+            { SC_TEST_EXPECT(httpServer.stop()); };
+
+            Client client;
+            Thread thread;
+            SC_TEST_EXPECT(thread.start([&client](Thread&) { client.run(port); }));
+            SC_TEST_EXPECT(eventLoop.run());
+            SC_TEST_EXPECT(thread.join());
+            SC_TEST_EXPECT(client.numErrors == 0);
+            SC_TEST_EXPECT(webSocketServer.getNumConnections() == 0);
+            SC_TEST_EXPECT(webSocketServer.statistics.numSlowConsumers == 0);
+            SC_TEST_EXPECT(eventLoop.close());
+        }
+    }
+};
+
+namespace SC
+{
+void runHttpWebSocketTest(SC::TestReport& report) { HttpWebSocketTest test(report); }
+} // namespace SC
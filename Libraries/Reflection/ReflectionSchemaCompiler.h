@@ -1,7 +1,7 @@
 // Copyright (c) Stefano Cristiano
 // SPDX-License-Identifier: MIT
 #pragma once
-#include "../Algorithms/AlgorithmBubbleSort.h"
+#include "../Algorithms/AlgorithmInsertionSort.h"
 #include "Reflection.h"
 
 namespace SC
@@ -68,8 +68,8 @@ struct SchemaCompiler
                 types.values[baseLinkID].typeInfo.structInfo.isPacked)
             {
                 // This is a little help for Binary Serialization, as packed structs end up serialized as is
-                Algorithms::bubbleSort(types.values + baseLinkID + 1, types.values + baseLinkID + 1 + numberOfChildren,
-                                       OrderByMemberOffset());
+                Algorithms::insertionSort(types.values + baseLinkID + 1,
+                                          types.values + baseLinkID + 1 + numberOfChildren, OrderByMemberOffset());
             }
             types.size += numberOfTypes;
             return true;
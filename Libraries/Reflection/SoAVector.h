@@ -0,0 +1,422 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "../Foundation/Assert.h"
+#include "../Foundation/LibC.h" // memcpy
+#include "../Foundation/Memory.h"
+#include "../Foundation/Span.h"
+#include "Reflection.h"
+
+namespace SC
+{
+template <typename T>
+struct SoAVector;
+namespace Reflection
+{
+template <typename T>
+struct SoAVectorFieldsCounter;
+template <typename T>
+struct SoAVectorLayout;
+template <typename T, typename MemberType>
+struct SoAVectorFieldFinder;
+} // namespace Reflection
+} // namespace SC
+
+//! @addtogroup group_reflection
+//! @{
+
+/// @brief Counts members of T visiting `Reflect<T>` (used by SC::SoAVector)
+template <typename T>
+struct SC::Reflection::SoAVectorFieldsCounter
+{
+    size_t numFields = 0;
+
+    constexpr SoAVectorFieldsCounter() { (void)Reflect<T>::visit(*this); }
+
+    template <typename R, int N>
+    constexpr bool operator()(int memberTag, R T::*member, const char (&name)[N], size_t offset)
+    {
+        SC_COMPILER_UNUSED(memberTag);
+        SC_COMPILER_UNUSED(member);
+        SC_COMPILER_UNUSED(name);
+        SC_COMPILER_UNUSED(offset);
+        static_assert(TypeTraits::IsTriviallyCopyable<R>::value, "SoAVector members must be trivially copyable");
+        numFields++;
+        return true;
+    }
+};
+
+/// @brief Offset and size of all members of T visiting `Reflect<T>` (used by SC::SoAVector)
+template <typename T>
+struct SC::Reflection::SoAVectorLayout
+{
+    static constexpr size_t NumFields = SoAVectorFieldsCounter<T>().numFields;
+    static_assert(NumFields > 0, "SoAVector needs a type with at least one reflected member");
+
+    struct FieldInfo
+    {
+        size_t offsetInBytes = 0; ///< Offset of the member in T
+        size_t sizeInBytes   = 0; ///< Size of the member
+    };
+    FieldInfo fields[NumFields];
+    size_t    numFields = 0;
+
+    constexpr SoAVectorLayout() : fields() { (void)Reflect<T>::visit(*this); }
+
+    template <typename R, int N>
+    constexpr bool operator()(int memberTag, R T::*member, const char (&name)[N], size_t offset)
+    {
+        SC_COMPILER_UNUSED(memberTag);
+        SC_COMPILER_UNUSED(member);
+        SC_COMPILER_UNUSED(name);
+        fields[numFields].offsetInBytes = offset;
+        fields[numFields].sizeInBytes   = sizeof(R);
+        numFields++;
+        return true;
+    }
+};
+
+/// @brief Finds position of a member in the list of members visited by `Reflect<T>` (used by SC::SoAVector)
+template <typename T, typename MemberType>
+struct SC::Reflection::SoAVectorFieldFinder
+{
+    MemberType T::*member;
+
+    size_t index = 0;
+    size_t found = SoAVectorLayout<T>::NumFields;
+
+    constexpr SoAVectorFieldFinder(MemberType T::*member) : member(member) { (void)Reflect<T>::visit(*this); }
+
+    template <int N>
+    constexpr bool operator()(int memberTag, MemberType T::*other, const char (&name)[N], size_t offset)
+    {
+        SC_COMPILER_UNUSED(memberTag);
+        SC_COMPILER_UNUSED(name);
+        SC_COMPILER_UNUSED(offset);
+        if (other == member)
+        {
+            found = index;
+            return false; // stop visiting
+        }
+        index++;
+        return true;
+    }
+
+    template <typename R, int N>
+    constexpr bool operator()(int memberTag, R T::*other, const char (&name)[N], size_t offset)
+    {
+        SC_COMPILER_UNUSED(memberTag);
+        SC_COMPILER_UNUSED(other);
+        SC_COMPILER_UNUSED(name);
+        SC_COMPILER_UNUSED(offset);
+        index++;
+        return true;
+    }
+};
+
+/// @brief A vector storing each reflected member of T in its own contiguous array (structure of arrays).
+///
+/// Loops reading just a few members of many items only touch memory of those members, instead of loading entire items
+/// as it happens with SC::Vector (array of structures). @n
+/// Members are found at compile time visiting `Reflect<T>` (see SC_REFLECT_STRUCT_VISIT), and they must be trivially
+/// copyable. All member arrays live in a single memory block, each one aligned to MemoryAllocator::Alignment (16
+/// bytes) so that it can be processed with SIMD instructions. @n
+/// SoAVector::getField returns a Span of all values of a member, while SoAVector::operator[] returns a SoAVector::Row
+/// proxy to access members of a single item or to gather / scatter the entire item.
+/// Passing a member pointer searches it among members visited by `Reflect<T>` on every call, so loops should obtain the
+/// Span once with SoAVector::getField, or resolve the member once with SoAVector::findField and pass the returned
+/// SoAVector::Field to SoAVector::getField and Row::get.
+/// @note Growing the vector moves all member arrays, invalidating previously obtained Span and Row.
+/// @tparam T A type described by Reflection (with `Reflect<T>::visit`)
+template <typename T>
+struct SC::SoAVector
+{
+    /// @brief Number of members of T, that is the number of arrays of this SoAVector
+    static constexpr size_t NumFields = Reflection::SoAVectorLayout<T>::NumFields;
+
+    /// @brief A member of T with type R, resolved by SoAVector::findField (accessing it doesn't search `Reflect<T>`)
+    template <typename R>
+    struct Field
+    {
+        size_t index = NumFields; ///< Position of the member in the list of members described by `Reflect<T>`
+    };
+
+    /// @brief Proxy to access members of a single item of the SoAVector
+    template <typename VectorType>
+    struct RowProxy
+    {
+        VectorType* vector = nullptr;
+        size_t      index  = 0;
+
+        /// @brief Access the given member of this item
+        template <typename R>
+        [[nodiscard]] auto& get(R T::*member) const
+        {
+            return vector->getField(member)[index];
+        }
+
+        /// @brief Access the given member (resolved with SoAVector::findField) of this item
+        template <typename R>
+        [[nodiscard]] auto& get(Field<R> field) const
+        {
+            return vector->getField(field)[index];
+        }
+
+        /// @brief Gathers all members of this item into a T
+        [[nodiscard]] T load() const
+        {
+            T value;
+            vector->loadItem(index, value);
+            return value;
+        }
+
+        /// @brief Scatters all members of value to this item
+        void store(const T& value) const { vector->storeItem(index, value); }
+    };
+    using Row      = RowProxy<SoAVector>;
+    using ConstRow = RowProxy<const SoAVector>;
+
+    SoAVector() {}
+    ~SoAVector()
+    {
+        if (block)
+            Memory::release(block);
+    }
+
+    SoAVector(const SoAVector& other) { *this = other; }
+    SoAVector(SoAVector&& other) { *this = move(other); }
+
+    SoAVector& operator=(const SoAVector& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            SC_ASSERT_RELEASE(reserve(other.numItems));
+            copyItems(other, other.numItems);
+            numItems = other.numItems;
+        }
+        return *this;
+    }
+
+    SoAVector& operator=(SoAVector&& other)
+    {
+        if (this != &other)
+        {
+            if (block)
+                Memory::release(block);
+            block    = other.block;
+            numItems = other.numItems;
+            capacity = other.capacity;
+            for (size_t idx = 0; idx < NumFields; ++idx)
+            {
+                fields[idx] = other.fields[idx];
+            }
+            other.block    = nullptr;
+            other.numItems = 0;
+            other.capacity = 0;
+        }
+        return *this;
+    }
+
+    /// @brief Returns number of items
+    [[nodiscard]] size_t size() const { return numItems; }
+
+    /// @brief Returns number of items that can be stored without allocating memory
+    [[nodiscard]] size_t getCapacity() const { return capacity; }
+
+    /// @brief Check if the SoAVector is empty
+    [[nodiscard]] bool isEmpty() const { return numItems == 0; }
+
+    /// @brief Removes all items (without releasing memory)
+    void clear() { numItems = 0; }
+
+    /// @brief Reserves memory for newCapacity items
+    /// @return `false` if memory allocation fails
+    [[nodiscard]] bool reserve(size_t newCapacity)
+    {
+        if (newCapacity <= capacity)
+            return true;
+        SoAVector newVector;
+        newVector.block = Memory::allocate(getBlockSize(newCapacity));
+        if (newVector.block == nullptr)
+            return false;
+        newVector.capacity = newCapacity;
+        newVector.computeFields();
+        newVector.copyItems(*this, numItems);
+        newVector.numItems = numItems;
+        *this              = move(newVector);
+        return true;
+    }
+
+    /// @brief Resizes to newSize items, copying value to all new items
+    /// @return `false` if memory allocation fails
+    [[nodiscard]] bool resize(size_t newSize, const T& value = T())
+    {
+        if (not reserve(newSize))
+            return false;
+        for (size_t idx = numItems; idx < newSize; ++idx)
+        {
+            storeItem(idx, value);
+        }
+        numItems = newSize;
+        return true;
+    }
+
+    /// @brief Appends a new item, scattering its members to their arrays
+    /// @return `false` if memory allocation fails
+    [[nodiscard]] bool push_back(const T& value)
+    {
+        if (numItems == capacity and not reserve(capacity < 8 ? 8 : capacity * 2))
+            return false;
+        storeItem(numItems++, value);
+        return true;
+    }
+
+    /// @brief Removes last item
+    /// @return `false` if the SoAVector is empty
+    [[nodiscard]] bool pop_back()
+    {
+        if (numItems == 0)
+            return false;
+        numItems--;
+        return true;
+    }
+
+    /// @brief Returns a Row proxy to access members of the item at index
+    [[nodiscard]] Row operator[](size_t index)
+    {
+        SC_ASSERT_DEBUG(index < numItems);
+        return {this, index};
+    }
+
+    /// @brief Returns a ConstRow proxy to read members of the item at index
+    [[nodiscard]] ConstRow operator[](size_t index) const
+    {
+        SC_ASSERT_DEBUG(index < numItems);
+        return {this, index};
+    }
+
+    /// @brief Returns a Span with the values of the given member for all items
+    /// @param member Pointer to a member of T that is described by its `Reflect<T>`
+    template <typename R>
+    [[nodiscard]] Span<R> getField(R T::*member)
+    {
+        return {static_cast<R*>(fields[getFieldIndex(member)]), numItems};
+    }
+
+    /// @brief Returns a Span with the values of the given member for all items
+    /// @param member Pointer to a member of T that is described by its `Reflect<T>`
+    template <typename R>
+    [[nodiscard]] Span<const R> getField(R T::*member) const
+    {
+        return {static_cast<const R*>(fields[getFieldIndex(member)]), numItems};
+    }
+
+    /// @brief Returns a Span with the values of the given member (resolved with SoAVector::findField) for all items
+    template <typename R>
+    [[nodiscard]] Span<R> getField(Field<R> field)
+    {
+        SC_ASSERT_DEBUG(field.index < NumFields);
+        return {static_cast<R*>(fields[field.index]), numItems};
+    }
+
+    /// @brief Returns a Span with the values of the given member (resolved with SoAVector::findField) for all items
+    template <typename R>
+    [[nodiscard]] Span<const R> getField(Field<R> field) const
+    {
+        SC_ASSERT_DEBUG(field.index < NumFields);
+        return {static_cast<const R*>(fields[field.index]), numItems};
+    }
+
+    /// @brief Resolves the given member once, so that accessing it with the returned Field doesn't search `Reflect<T>`
+    /// @param member Pointer to a member of T that is described by its `Reflect<T>`
+    template <typename R>
+    [[nodiscard]] static Field<R> findField(R T::*member)
+    {
+        Field<R> field;
+        field.index = getFieldIndex(member);
+        return field;
+    }
+
+    /// @brief Returns position of the given member in the list of members described by `Reflect<T>`
+    template <typename R>
+    [[nodiscard]] static size_t getFieldIndex(R T::*member)
+    {
+        const Reflection::SoAVectorFieldFinder<T, R> finder(member);
+        SC_ASSERT_RELEASE(finder.found < NumFields); // Member must be described by Reflect<T>
+        return finder.found;
+    }
+
+  private:
+    using Layout    = Reflection::SoAVectorLayout<T>;
+    using FieldInfo = typename Layout::FieldInfo;
+
+    static constexpr Layout layout = Layout();
+
+    void*  block    = nullptr;
+    size_t numItems = 0;
+    size_t capacity = 0;
+    void*  fields[NumFields];
+
+    static constexpr size_t alignSize(size_t numBytes)
+    {
+        return (numBytes + MemoryAllocator::Alignment - 1) & ~(MemoryAllocator::Alignment - 1);
+    }
+
+    static size_t getBlockSize(size_t numItems)
+    {
+        size_t blockSize = 0;
+        for (size_t idx = 0; idx < NumFields; ++idx)
+        {
+            blockSize += alignSize(numItems * layout.fields[idx].sizeInBytes);
+        }
+        return blockSize;
+    }
+
+    void computeFields()
+    {
+        char* field = static_cast<char*>(block);
+        for (size_t idx = 0; idx < NumFields; ++idx)
+        {
+            fields[idx] = field;
+            field += alignSize(capacity * layout.fields[idx].sizeInBytes);
+        }
+    }
+
+    void copyItems(const SoAVector& other, size_t numItemsToCopy)
+    {
+        for (size_t idx = 0; idx < NumFields; ++idx)
+        {
+            if (numItemsToCopy > 0)
+            {
+                ::memcpy(fields[idx], other.fields[idx], numItemsToCopy * layout.fields[idx].sizeInBytes);
+            }
+        }
+    }
+
+    void storeItem(size_t index, const T& value)
+    {
+        const char* source = reinterpret_cast<const char*>(&value);
+        for (size_t idx = 0; idx < NumFields; ++idx)
+        {
+            const FieldInfo& field = layout.fields[idx];
+            ::memcpy(static_cast<char*>(fields[idx]) + index * field.sizeInBytes, source + field.offsetInBytes,
+                     field.sizeInBytes);
+        }
+    }
+
+    void loadItem(size_t index, T& value) const
+    {
+        char* destination = reinterpret_cast<char*>(&value);
+        for (size_t idx = 0; idx < NumFields; ++idx)
+        {
+            const FieldInfo& field = layout.fields[idx];
+            ::memcpy(destination + field.offsetInBytes,
+                     static_cast<const char*>(fields[idx]) + index * field.sizeInBytes, field.sizeInBytes);
+        }
+    }
+};
+
+template <typename T>
+constexpr SC::Reflection::SoAVectorLayout<T> SC::SoAVector<T>::layout;
+//! @}
@@ -0,0 +1,144 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../SoAVector.h"
+#include "../../Testing/Testing.h"
+
+namespace TestNamespace
+{
+struct Particle;
+} // namespace TestNamespace
+
+//! [soaVectorSnippet1]
+struct TestNamespace::Particle
+{
+    float        position[3] = {0, 0, 0};
+    float        velocity[3] = {0, 0, 0};
+    SC::uint8_t  flags       = 0;
+    double       mass        = 1;
+    SC::uint32_t id          = 0;
+};
+
+SC_REFLECT_STRUCT_VISIT(TestNamespace::Particle)
+SC_REFLECT_STRUCT_FIELD(0, position)
+SC_REFLECT_STRUCT_FIELD(1, velocity)
+SC_REFLECT_STRUCT_FIELD(2, flags)
+SC_REFLECT_STRUCT_FIELD(3, mass)
+SC_REFLECT_STRUCT_FIELD(4, id)
+SC_REFLECT_STRUCT_LEAVE()
+//! [soaVectorSnippet1]
+
+namespace SC
+{
+struct SoAVectorTest;
+}
+
+struct SC::SoAVectorTest : public SC::TestCase
+{
+    SoAVectorTest(SC::TestReport& report) : TestCase(report, "SoAVectorTest")
+    {
+        using namespace SC;
+        using TestNamespace::Particle;
+        if (test_section("push_back"))
+        {
+            SoAVector<Particle> particles;
+            static_assert(SoAVector<Particle>::NumFields == 5, "Particle has 5 reflected members");
+            SC_TEST_EXPECT(particles.isEmpty());
+            for (uint32_t idx = 0; idx < 100; ++idx)
+            {
+                Particle particle;
+                particle.id          = idx;
+                particle.flags       = static_cast<uint8_t>(idx % 3);
+                particle.position[1] = static_cast<float>(idx);
+                particle.mass        = idx * 2.0;
+                SC_TEST_EXPECT(particles.push_back(particle));
+            }
+            SC_TEST_EXPECT(particles.size() == 100);
+            SC_TEST_EXPECT(particles.getCapacity() >= 100);
+            SC_TEST_EXPECT(SoAVector<Particle>::getFieldIndex(&Particle::mass) == 3);
+
+            Span<uint32_t> ids    = particles.getField(&Particle::id);
+            Span<double>   masses = particles.getField(&Particle::mass);
+            Span<uint8_t>  flags  = particles.getField(&Particle::flags);
+            SC_TEST_EXPECT(ids.sizeInElements() == 100);
+            bool correct = true;
+            for (size_t idx = 0; idx < ids.sizeInElements(); ++idx)
+            {
+                correct = correct and ids[idx] == idx and masses[idx] == idx * 2.0 and flags[idx] == idx % 3;
+            }
+            SC_TEST_EXPECT(correct);
+            // All member arrays are aligned for SIMD instructions
+            SC_TEST_EXPECT(reinterpret_cast<size_t>(flags.data()) % MemoryAllocator::Alignment == 0);
+            SC_TEST_EXPECT(reinterpret_cast<size_t>(masses.data()) % MemoryAllocator::Alignment == 0);
+            SC_TEST_EXPECT(reinterpret_cast<size_t>(ids.data()) % MemoryAllocator::Alignment == 0);
+
+            SC_TEST_EXPECT(particles.pop_back());
+            SC_TEST_EXPECT(particles.size() == 99);
+            particles.clear();
+            SC_TEST_EXPECT(particles.isEmpty() and not particles.pop_back());
+        }
+        if (test_section("row"))
+        {
+            //! [soaVectorSnippet2]
+            SoAVector<Particle> particles;
+            SC_TEST_EXPECT(particles.resize(10));
+            // Integrate positions touching only position and velocity arrays
+            Span<float[3]> positions  = particles.getField(&Particle::position);
+            Span<float[3]> velocities = particles.getField(&Particle::velocity);
+            for (size_t idx = 0; idx < particles.size(); ++idx)
+            {
+                velocities[idx][0] = 1.0f;
+                positions[idx][0] += velocities[idx][0] * 0.5f;
+            }
+            // Access members of a single particle or gather all of them
+            particles[3].get(&Particle::id) = 3;
+            Particle particle = particles[3].load();
+            SC_TEST_EXPECT(particle.id == 3 and particle.position[0] == 0.5f and particle.mass == 1);
+            particle.mass = 10;
+            particles[4].store(particle);
+            //! [soaVectorSnippet2]
+            SC_TEST_EXPECT(particles[4].get(&Particle::id) == 3);
+            SC_TEST_EXPECT(particles[4].get(&Particle::mass) == 10);
+            const SoAVector<Particle>& constParticles = particles;
+            SC_TEST_EXPECT(constParticles[4].load().velocity[0] == 1.0f);
+            SC_TEST_EXPECT(constParticles.getField(&Particle::mass)[3] == 1);
+
+            // Resolve members once when accessing them item by item in a loop
+            const auto idField   = SoAVector<Particle>::findField(&Particle::id);
+            const auto massField = SoAVector<Particle>::findField(&Particle::mass);
+            SC_TEST_EXPECT(massField.index == 3);
+            bool correct = true;
+            for (size_t idx = 0; idx < particles.size(); ++idx)
+            {
+                particles[idx].get(idField) = static_cast<uint32_t>(idx);
+                correct = correct and constParticles[idx].get(massField) == (idx == 4 ? 10 : 1);
+            }
+            SC_TEST_EXPECT(correct);
+            SC_TEST_EXPECT(constParticles.getField(idField)[7] == 7);
+        }
+        if (test_section("copy"))
+        {
+            SoAVector<Particle> particles;
+            Particle            particle;
+            for (uint32_t idx = 0; idx < 10; ++idx)
+            {
+                particle.id = idx;
+                SC_TEST_EXPECT(particles.push_back(particle));
+            }
+            SoAVector<Particle> particlesCopy = particles;
+            SoAVector<Particle> particlesMove = move(particles);
+            SC_TEST_EXPECT(particles.isEmpty());
+            SC_TEST_EXPECT(particlesCopy.size() == 10 and particlesMove.size() == 10);
+            SC_TEST_EXPECT(particlesCopy[9].get(&Particle::id) == 9);
+            SC_TEST_EXPECT(particlesMove[9].get(&Particle::id) == 9);
+            SC_TEST_EXPECT(particlesCopy.getField(&Particle::id).data() !=
+                           particlesMove.getField(&Particle::id).data());
+            SC_TEST_EXPECT(particlesCopy.reserve(1000));
+            SC_TEST_EXPECT(particlesCopy[9].get(&Particle::id) == 9);
+        }
+    }
+};
+
+namespace SC
+{
+void runSoAVectorTest(SC::TestReport& report) { SoAVectorTest test(report); }
+} // namespace SC
@@ -33,6 +33,22 @@ SC::Result SC::SocketClient::connect(SocketIPAddress ipAddress)
 
 SC::Result SC::SocketClient::close() { return socket.close(); }
 
+SC::Result SC::SocketClient::shutdown()
+{
+    SocketDescriptor::Handle nativeSocket;
+    SC_TRY(socket.get(nativeSocket, Result::Error("Invalid socket")));
+#if SC_PLATFORM_WINDOWS
+    const int how = SD_BOTH;
+#else
+    const int how = SHUT_RDWR;
+#endif
+    if (::shutdown(nativeSocket, how) == SOCKET_ERROR)
+    {
+        return Result::Error("shutdown error");
+    }
+    return Result(true);
+}
+
 SC::Result SC::SocketClient::write(Span<const char> data)
 {
     SocketDescriptor::Handle nativeSocket;
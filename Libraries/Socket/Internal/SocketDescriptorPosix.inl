@@ -38,6 +38,21 @@ SC::Result SC::SocketDescriptor::setBlocking(bool blocking)
     return fd.setBlocking(blocking);
 }
 
+SC::Result SC::SocketDescriptor::duplicate(SocketDescriptor&            newDescriptor,
+                                           SocketFlags::InheritableType inheritable) const
+{
+    SC_TRY_MSG(isValid(), "SocketDescriptor::duplicate - Invalid socket");
+    SC_TRUST_RESULT(newDescriptor.close());
+    const int command = inheritable == SocketFlags::NonInheritable ? F_DUPFD_CLOEXEC : F_DUPFD;
+    int       newHandle;
+    do
+    {
+        newHandle = ::fcntl(handle, command, 0);
+    } while (newHandle == -1 and errno == EINTR);
+    SC_TRY_MSG(newHandle != -1, "SocketDescriptor::duplicate - fcntl failed");
+    return newDescriptor.assign(newHandle);
+}
+
 SC::Result SC::SocketDescriptor::isInheritable(bool& hasValue) const
 {
     FileDescriptor fd;
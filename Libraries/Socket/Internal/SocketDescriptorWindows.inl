@@ -36,6 +36,29 @@ SC::Result SC::SocketDescriptor::setBlocking(bool blocking)
     return Result(true);
 }
 
+SC::Result SC::SocketDescriptor::duplicate(SocketDescriptor&            newDescriptor,
+                                           SocketFlags::InheritableType inheritable) const
+{
+    SC_TRY_MSG(isValid(), "SocketDescriptor::duplicate - Invalid socket");
+    SC_TRUST_RESULT(newDescriptor.close());
+    WSAPROTOCOL_INFOW info;
+    if (::WSADuplicateSocketW(handle, ::GetCurrentProcessId(), &info) == SOCKET_ERROR)
+    {
+        return Result::Error("WSADuplicateSocketW failed");
+    }
+    DWORD flags = WSA_FLAG_OVERLAPPED;
+    if (inheritable == SocketFlags::NonInheritable)
+    {
+        flags |= WSA_FLAG_NO_HANDLE_INHERIT;
+    }
+    const SOCKET newHandle = ::WSASocketW(FROM_PROTOCOL_INFO, FROM_PROTOCOL_INFO, FROM_PROTOCOL_INFO, &info, 0, flags);
+    if (newHandle == INVALID_SOCKET)
+    {
+        return Result::Error("WSASocketW failed");
+    }
+    return newDescriptor.assign(newHandle);
+}
+
 SC::Result SC::SocketDescriptor::isInheritable(bool& hasValue) const
 {
     DWORD flags;
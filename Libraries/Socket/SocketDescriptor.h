@@ -180,6 +180,15 @@ struct SC::SocketDescriptor : public UniqueHandle<detail::SocketDescriptorDefini
     /// @return Valid Result if it has been possible changing the blocking status of this socket
     [[nodiscard]] Result setBlocking(bool value);
 
+    /// @brief Creates a new descriptor referring to the same socket (closing one of them leaves the other valid).
+    /// It can be used to wait for reads and writes of the same socket with APIs allowing a single watcher per
+    /// descriptor (like epoll).
+    /// @param[out] newDescriptor The descriptor that will refer to this socket (if Result is valid)
+    /// @param inheritable If the new descriptor should be inheritable by child processes
+    /// @return Valid Result if this socket has been successfully duplicated
+    [[nodiscard]] Result duplicate(SocketDescriptor&            newDescriptor,
+                                   SocketFlags::InheritableType inheritable = SocketFlags::NonInheritable) const;
+
     /// @brief Get address family (IPV4 / IPV6) of this socket
     /// @param[out] addressFamily The address family of this socket (if Result is valid)
     /// @return Valid Result the address family for this socket has been queried successfully
@@ -241,6 +250,11 @@ struct SC::SocketClient
     /// @return The Result of SocketDescriptor::close
     [[nodiscard]] Result close();
 
+    /// @brief Shuts down both directions of the connection, without closing the socket.
+    /// Pending (or subsequent) reads return zero bytes and writes fail, both locally and on the remote side.
+    /// @return Valid Result if the socket has been shut down successfully
+    [[nodiscard]] Result shutdown();
+
     /// @brief Connect to a given address and port combination
     /// @param address Address as string
     /// @param port Port to start listening to
@@ -98,6 +98,24 @@ void SC::SocketDescriptorTest::socketDescriptor()
     SC_TEST_EXPECT(isInheritable);
     SC_TEST_EXPECT(socket.close());
     //! [socketDescriptorSnippet]
+
+    SocketDescriptor duplicated;
+    SC_TEST_EXPECT(not socket.duplicate(duplicated));
+    SC_TEST_EXPECT(socket.create(SocketFlags::AddressFamilyIPV4, SocketFlags::SocketStream, SocketFlags::ProtocolTcp,
+                                 SocketFlags::NonBlocking, SocketFlags::Inheritable));
+    SC_TEST_EXPECT(socket.duplicate(duplicated));
+    SC_TEST_EXPECT(duplicated.isValid());
+    isInheritable = true;
+    SC_TEST_EXPECT(duplicated.isInheritable(isInheritable));
+    SC_TEST_EXPECT(not isInheritable);
+    SC_TEST_EXPECT(duplicated.close());
+    SC_TEST_EXPECT(socket.isValid());
+    SC_TEST_EXPECT(socket.duplicate(duplicated, SocketFlags::Inheritable));
+    isInheritable = false;
+    SC_TEST_EXPECT(duplicated.isInheritable(isInheritable));
+    SC_TEST_EXPECT(isInheritable);
+    SC_TEST_EXPECT(socket.close());
+    SC_TEST_EXPECT(duplicated.close());
 }
 
 void SC::SocketDescriptorTest::socketClientServer(SocketFlags::SocketType   socketType,
@@ -97,6 +97,16 @@ struct SC::SmallString : public String
         return *this;
     }
 
+#if SC_MEMORY_TAGGING
+    ~SmallString()
+    {
+        if (String::data.items == buffer.items)
+        {
+            MemoryTagLink::countSmallVectorInline();
+        }
+    }
+#endif
+
   private:
     void init()
     {
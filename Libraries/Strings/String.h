@@ -32,6 +32,14 @@ struct SC::String
     /// @param encoding The encoding of the String
     String(StringEncoding encoding = StringEncoding::Utf8) : encoding(encoding) {}
 
+    /// @brief Builds an empty String allocating its memory from the given allocator, instead of SC::Memory
+    /// (see SC::Vector::Vector(MemoryAllocator&) for the header segment allocated immediately)
+    /// @param allocator The allocator (for example SC::ArenaAllocator), that must outlive the String
+    /// @param encoding The encoding of the String
+    explicit String(MemoryAllocator& allocator, StringEncoding encoding = StringEncoding::Utf8)
+        : encoding(encoding), data(allocator)
+    {}
+
     /// @brief Builds String from a StringView
     /// @param sv StringView to be assigned to this String
     /// @warning This function will assert if StringView::assign fails
@@ -78,6 +86,10 @@ struct SC::String
     /// @return a null-terminated StringView from current String
     [[nodiscard]] StringView view() const;
 
+    /// @brief Computes a 64 bit hash of the String (see StringView::hash), allowing String keys in SC::HashMap
+    /// @return Hash of the String, equal to the hash of any StringView comparing equal to it
+    [[nodiscard]] uint64_t hash() const { return view().hash(); }
+
     /// @brief Check if current String is same as other String
     /// @param other String to be checked
     /// @return `true` if the two strings are equal
@@ -103,6 +115,11 @@ struct SC::String
     /// @return `true` if the String is smaller than StringView (using StringView::compare)
     [[nodiscard]] bool operator<(const StringView other) const { return view() < other; }
 
+    /// @brief Check if current String is smaller to another String (using StringView::compare)
+    /// @param other String to be checked
+    /// @return `true` if the String is smaller than other String (using StringView::compare)
+    [[nodiscard]] bool operator<(const String& other) const { return view() < other.view(); }
+
     /// @brief Check if current String is equal to the ascii string literal
     /// @tparam N Length of string literal, including null terminator
     /// @param other The string literal
@@ -122,6 +139,16 @@ struct SC::String
         return view() != other;
     }
 
+    /// @brief Check if current String is smaller than the ascii string literal
+    /// @tparam N Length of string literal, including null terminator
+    /// @param other The string literal
+    /// @return `true` if the String is smaller than other (using StringView::compare)
+    template <size_t N>
+    [[nodiscard]] bool operator<(const char (&other)[N]) const
+    {
+        return view() < other;
+    }
+
     /// @brief Assigns an ascii string literal to current String
     /// @tparam N Length of string literal, including null terminator
     /// @param text  The string literal
@@ -160,6 +187,20 @@ struct SC::String
 #pragma warning(pop)
 #endif
 };
+
+/// @brief Hashes String keys of SC::HashMap and SC::HashSet, allowing lookups with StringView and string literals
+template <>
+struct SC::Hash<SC::String>
+{
+    [[nodiscard]] uint64_t operator()(const String& text) const { return text.view().hash(); }
+    [[nodiscard]] uint64_t operator()(StringView text) const { return text.hash(); }
+
+    template <size_t N>
+    [[nodiscard]] uint64_t operator()(const char (&text)[N]) const
+    {
+        return StringView(text).hash();
+    }
+};
 //! @}
 
 //-----------------------------------------------------------------------------------------------------------------------
@@ -1,6 +1,7 @@
 // Copyright (c) Stefano Cristiano
 // SPDX-License-Identifier: MIT
 #include "../Strings/StringView.h"
+#include "../Containers/Hash.h"
 
 #include <errno.h>  // errno
 #include <stdint.h> // INT32_MIN/MAX
@@ -246,6 +247,45 @@ bool SC::StringView::splitBefore(const StringView stringToMatch, StringView& str
         });
 }
 
+uint64_t SC::StringView::hash() const
+{
+    HashBytes hashBytes;
+    if (getEncoding() != StringEncoding::Utf16)
+    {
+        hashBytes.add(text, textSizeInBytes);
+        return hashBytes.finish();
+    }
+    // Hash UTF16 code points as UTF8 sequences, to match hashes of equal ASCII / UTF8 StringView
+    StringIteratorUTF16 it = getIterator<StringIteratorUTF16>();
+    StringCodePoint     codePoint;
+    while (it.advanceRead(codePoint))
+    {
+        if (codePoint < 0x80)
+        {
+            hashBytes.addByte(static_cast<uint8_t>(codePoint));
+        }
+        else if (codePoint < 0x800)
+        {
+            hashBytes.addByte(static_cast<uint8_t>(0xC0 | (codePoint >> 6)));
+            hashBytes.addByte(static_cast<uint8_t>(0x80 | (codePoint & 0x3F)));
+        }
+        else if (codePoint < 0x10000)
+        {
+            hashBytes.addByte(static_cast<uint8_t>(0xE0 | (codePoint >> 12)));
+            hashBytes.addByte(static_cast<uint8_t>(0x80 | ((codePoint >> 6) & 0x3F)));
+            hashBytes.addByte(static_cast<uint8_t>(0x80 | (codePoint & 0x3F)));
+        }
+        else
+        {
+            hashBytes.addByte(static_cast<uint8_t>(0xF0 | (codePoint >> 18)));
+            hashBytes.addByte(static_cast<uint8_t>(0x80 | ((codePoint >> 12) & 0x3F)));
+            hashBytes.addByte(static_cast<uint8_t>(0x80 | ((codePoint >> 6) & 0x3F)));
+            hashBytes.addByte(static_cast<uint8_t>(0x80 | (codePoint & 0x3F)));
+        }
+    }
+    return hashBytes.finish();
+}
+
 bool SC::StringView::containsCodePoint(StringCodePoint c) const
 {
     return withIterator([c](auto it) { return it.advanceUntilMatches(c); });
@@ -8,7 +8,8 @@ namespace SC
 struct SC_COMPILER_EXPORT StringView;
 struct SC_COMPILER_EXPORT StringViewTokenizer;
 struct SC_COMPILER_EXPORT StringAlgorithms;
-
+template <typename T>
+struct Hash;
 } // namespace SC
 
 //! @defgroup group_strings Strings
@@ -215,6 +216,12 @@ struct SC::StringView
     /// @endcode
     [[nodiscard]] constexpr bool fullyOverlaps(StringView other, size_t& commonOverlappingPoints) const;
 
+    /// @brief Computes a 64 bit hash of the StringView, used by SC::HashMap and SC::HashSet (see SC::Hash).
+    /// StringView-s comparing equal with StringView::operator== have the same hash, even if they have different
+    /// encodings, because UTF16 code points are hashed as their UTF8 sequence.
+    /// @return Hash of the code points of the StringView
+    [[nodiscard]] uint64_t hash() const;
+
     /// @brief Check if StringView is empty
     /// @return `true` if string is empty
     [[nodiscard]] constexpr bool isEmpty() const { return text == nullptr or textSizeInBytes == 0; }
@@ -564,6 +571,13 @@ struct SC::StringView
     constexpr bool equalsIterator(StringView other, size_t& points) const;
 };
 
+/// @brief Hashes StringView keys of SC::HashMap and SC::HashSet (see StringView::hash)
+template <>
+struct SC::Hash<SC::StringView>
+{
+    [[nodiscard]] uint64_t operator()(StringView text) const { return text.hash(); }
+};
+
 /// @brief Splits a StringView in tokens according to separators
 struct SC::StringViewTokenizer
 {
@@ -6,12 +6,41 @@
 #if _MSC_VER
 extern "C"
 {
+    char    _InterlockedExchangeAdd8(char volatile* Addend, char Value);
+    short   _InterlockedExchangeAdd16(short volatile* Addend, short Value);
     long    _InterlockedExchangeAdd(long volatile* Addend, long Value);
     char    _InterlockedExchange8(char volatile* Target, char Value);
+    short   _InterlockedExchange16(short volatile* Target, short Value);
+    long    _InterlockedExchange(long volatile* Target, long Value);
+    char    _InterlockedCompareExchange8(char volatile* Destination, char Exchange, char Comparand);
+    short   _InterlockedCompareExchange16(short volatile* Destination, short Exchange, short Comparand);
+    long    _InterlockedCompareExchange(long volatile* Destination, long Exchange, long Comparand);
+    __int64 _InterlockedCompareExchange64(__int64 volatile* Destination, __int64 Exchange, __int64 Comparand);
+    char    _InterlockedAnd8(char volatile* Value, char Mask);
+    short   _InterlockedAnd16(short volatile* Value, short Mask);
+    long    _InterlockedAnd(long volatile* Value, long Mask);
+    char    _InterlockedOr8(char volatile* Value, char Mask);
+    short   _InterlockedOr16(short volatile* Value, short Mask);
+    long    _InterlockedOr(long volatile* Value, long Mask);
+    char    _InterlockedXor8(char volatile* Value, char Mask);
+    short   _InterlockedXor16(short volatile* Value, short Mask);
+    long    _InterlockedXor(long volatile* Value, long Mask);
+#if !defined(_M_IX86)
+    __int64 _InterlockedExchangeAdd64(__int64 volatile* Addend, __int64 Value);
+    __int64 _InterlockedExchange64(__int64 volatile* Target, __int64 Value);
+    __int64 _InterlockedAnd64(__int64 volatile* Value, __int64 Mask);
+    __int64 _InterlockedOr64(__int64 volatile* Value, __int64 Mask);
+    __int64 _InterlockedXor64(__int64 volatile* Value, __int64 Mask);
+#endif
     void    __dmb(unsigned int _Type);
     void    __iso_volatile_store8(volatile __int8*, __int8);
+    void    __iso_volatile_store16(volatile __int16*, __int16);
+    void    __iso_volatile_store32(volatile __int32*, __int32);
+    void    __iso_volatile_store64(volatile __int64*, __int64);
     __int8  __iso_volatile_load8(const volatile __int8*);
+    __int16 __iso_volatile_load16(const volatile __int16*);
     __int32 __iso_volatile_load32(const volatile __int32*);
+    __int64 __iso_volatile_load64(const volatile __int64*);
     void    _ReadWriteBarrier(void);
 
 #ifdef __clang__
@@ -83,107 +112,343 @@ typedef enum memory_order
 } memory_order;
 
 #endif
-/// @brief Atomic variables (only for `int` and `bool` for now).
-/// @n
-/// Example:
-/// @code{.cpp}
-/// Atomic<bool> test = true;
-///
-/// SC_TEST_EXPECT(test.load());
-/// test.exchange(false);
-/// SC_TEST_EXPECT(not test.load());
-/// @endcode
-template <typename T>
-struct Atomic;
+
+/// @brief Issues a memory fence with the given order
+inline void atomic_thread_fence(memory_order order)
+{
+#if _MSC_VER
+    if (order == memory_order_seq_cst)
+    {
+        long barrier = 0;
+        (void)_InterlockedExchange(&barrier, 0); // Interlocked functions are full barriers
+    }
+    else if (order != memory_order_relaxed)
+    {
+        SC_COMPILER_MSVC_COMPILER_MEMORY_BARRIER();
+    }
+#else
+    __atomic_thread_fence(order);
+#endif
+}
+
+namespace detail
+{
+#if _MSC_VER
+// Maps atomic operations on types of a given size to the Interlocked / iso_volatile intrinsics
+template <int Size>
+struct AtomicIntrinsics;
 
 template <>
-struct Atomic<int32_t>
+struct AtomicIntrinsics<1>
 {
-    Atomic(int32_t value) : value(value) {}
+    using Type = char;
+    static Type load(const volatile Type* v) { return __iso_volatile_load8(v); }
+    static void store(volatile Type* v, Type d) { __iso_volatile_store8(v, d); }
+    static Type exchange(volatile Type* v, Type d) { return _InterlockedExchange8(v, d); }
+    static Type compareExchange(volatile Type* v, Type d, Type e) { return _InterlockedCompareExchange8(v, d, e); }
+    static Type fetchAdd(volatile Type* v, Type d) { return _InterlockedExchangeAdd8(v, d); }
+    static Type fetchAnd(volatile Type* v, Type d) { return _InterlockedAnd8(v, d); }
+    static Type fetchOr(volatile Type* v, Type d) { return _InterlockedOr8(v, d); }
+    static Type fetchXor(volatile Type* v, Type d) { return _InterlockedXor8(v, d); }
+};
+
+template <>
+struct AtomicIntrinsics<2>
+{
+    using Type = short;
+    static Type load(const volatile Type* v) { return __iso_volatile_load16(v); }
+    static void store(volatile Type* v, Type d) { __iso_volatile_store16(v, d); }
+    static Type exchange(volatile Type* v, Type d) { return _InterlockedExchange16(v, d); }
+    static Type compareExchange(volatile Type* v, Type d, Type e) { return _InterlockedCompareExchange16(v, d, e); }
+    static Type fetchAdd(volatile Type* v, Type d) { return _InterlockedExchangeAdd16(v, d); }
+    static Type fetchAnd(volatile Type* v, Type d) { return _InterlockedAnd16(v, d); }
+    static Type fetchOr(volatile Type* v, Type d) { return _InterlockedOr16(v, d); }
+    static Type fetchXor(volatile Type* v, Type d) { return _InterlockedXor16(v, d); }
+};
 
-    int32_t fetch_add(int32_t val)
+template <>
+struct AtomicIntrinsics<4>
+{
+    using Type = long;
+    static Type load(const volatile Type* v) { return __iso_volatile_load32(reinterpret_cast<const volatile int*>(v)); }
+    static void store(volatile Type* v, Type d) { __iso_volatile_store32(reinterpret_cast<volatile int*>(v), d); }
+    static Type exchange(volatile Type* v, Type d) { return _InterlockedExchange(v, d); }
+    static Type compareExchange(volatile Type* v, Type d, Type e) { return _InterlockedCompareExchange(v, d, e); }
+    static Type fetchAdd(volatile Type* v, Type d) { return _InterlockedExchangeAdd(v, d); }
+    static Type fetchAnd(volatile Type* v, Type d) { return _InterlockedAnd(v, d); }
+    static Type fetchOr(volatile Type* v, Type d) { return _InterlockedOr(v, d); }
+    static Type fetchXor(volatile Type* v, Type d) { return _InterlockedXor(v, d); }
+};
+
+template <>
+struct AtomicIntrinsics<8>
+{
+    using Type = __int64;
+    static Type load(const volatile Type* v) { return __iso_volatile_load64(v); }
+    static void store(volatile Type* v, Type d) { __iso_volatile_store64(v, d); }
+    static Type compareExchange(volatile Type* v, Type d, Type e) { return _InterlockedCompareExchange64(v, d, e); }
+#if defined(_M_IX86)
+    // 64 bit read-modify-write intrinsics are not available on x86, so they're emulated with compare exchange
+    template <typename Operation>
+    static Type update(volatile Type* v, Operation operation)
+    {
+        Type expected = load(v);
+        for (;;)
+        {
+            const Type previous = compareExchange(v, operation(expected), expected);
+            if (previous == expected)
+                return previous;
+            expected = previous;
+        }
+    }
+    static Type exchange(volatile Type* v, Type d) { return update(v, [d](Type) { return d; }); }
+    static Type fetchAdd(volatile Type* v, Type d) { return update(v, [d](Type e) { return e + d; }); }
+    static Type fetchAnd(volatile Type* v, Type d) { return update(v, [d](Type e) { return e & d; }); }
+    static Type fetchOr(volatile Type* v, Type d) { return update(v, [d](Type e) { return e | d; }); }
+    static Type fetchXor(volatile Type* v, Type d) { return update(v, [d](Type e) { return e ^ d; }); }
+#else
+    static Type exchange(volatile Type* v, Type d) { return _InterlockedExchange64(v, d); }
+    static Type fetchAdd(volatile Type* v, Type d) { return _InterlockedExchangeAdd64(v, d); }
+    static Type fetchAnd(volatile Type* v, Type d) { return _InterlockedAnd64(v, d); }
+    static Type fetchOr(volatile Type* v, Type d) { return _InterlockedOr64(v, d); }
+    static Type fetchXor(volatile Type* v, Type d) { return _InterlockedXor64(v, d); }
+#endif
+};
+#endif
+
+/// Common operations of all Atomic types
+template <typename T>
+struct AtomicBase
+{
+    constexpr AtomicBase(T value) : value(value) {}
+
+    /// @brief Atomically reads the value
+    [[nodiscard]] T load(memory_order order = memory_order_seq_cst) const
     {
 #if _MSC_VER
-        int32_t res;
-        res = _InterlockedExchangeAdd(reinterpret_cast<volatile long*>(&value), val);
+        const T res = fromBits(Intrinsics::load(bits()));
+        SC_COMPILER_MSVC_ATOMIC_LOAD_VERIFY_MEMORY_ORDER(order);
         return res;
 #else
-        return __atomic_fetch_add(&value, val, __ATOMIC_SEQ_CST);
+        return __atomic_load_n(&value, order);
 #endif
     }
 
-    int32_t load() const
+    /// @brief Atomically replaces the value
+    void store(T desired, memory_order order = memory_order_seq_cst)
     {
-        int32_t res;
 #if _MSC_VER
-        res = __iso_volatile_load32(reinterpret_cast<volatile const int*>(&value));
-        SC_COMPILER_MSVC_COMPILER_MEMORY_BARRIER();
+        if (order == memory_order_seq_cst)
+        {
+            (void)Intrinsics::exchange(bits(), toBits(desired));
+        }
+        else
+        {
+            if (order != memory_order_relaxed)
+            {
+                SC_COMPILER_MSVC_COMPILER_MEMORY_BARRIER();
+            }
+            Intrinsics::store(bits(), toBits(desired));
+        }
 #else
-        __atomic_load(&value, &res, __ATOMIC_SEQ_CST);
+        __atomic_store_n(&value, desired, order);
 #endif
-        return res;
     }
 
-    int32_t load(memory_order mem) const
+    /// @brief Atomically replaces the value, returning the previous one
+    T exchange(T desired, memory_order order = memory_order_seq_cst)
     {
-        int32_t res;
 #if _MSC_VER
-        res = __iso_volatile_load32(reinterpret_cast<volatile const int*>(&value));
-        SC_COMPILER_MSVC_ATOMIC_LOAD_VERIFY_MEMORY_ORDER(mem);
+        (void)order;
+        return fromBits(Intrinsics::exchange(bits(), toBits(desired)));
 #else
-        __atomic_load(&value, &res, mem);
+        return __atomic_exchange_n(&value, desired, order);
 #endif
-        return res;
     }
 
-  private:
-    volatile int32_t value;
+    /// @brief Replaces the value with desired if it's equal to expected, otherwise loads it into expected
+    /// @return `true` if the value has been replaced
+    bool compare_exchange_strong(T& expected, T desired, memory_order success, memory_order failure)
+    {
+#if _MSC_VER
+        (void)success;
+        (void)failure;
+        const auto previous = Intrinsics::compareExchange(bits(), toBits(desired), toBits(expected));
+        if (previous == toBits(expected))
+        {
+            return true;
+        }
+        expected = fromBits(previous);
+        return false;
+#else
+        return __atomic_compare_exchange_n(&value, &expected, desired, false, success, failure);
+#endif
+    }
+
+    /// @brief Replaces the value with desired if it's equal to expected, otherwise loads it into expected.
+    /// It can fail spuriously (even if the value is equal to expected), and it's meant to be used in a loop.
+    /// @return `true` if the value has been replaced
+    bool compare_exchange_weak(T& expected, T desired, memory_order success, memory_order failure)
+    {
+#if _MSC_VER
+        return compare_exchange_strong(expected, desired, success, failure);
+#else
+        return __atomic_compare_exchange_n(&value, &expected, desired, true, success, failure);
+#endif
+    }
+
+    /// @brief Same as compare_exchange_strong, deriving the order of the failure case from order
+    bool compare_exchange_strong(T& expected, T desired, memory_order order = memory_order_seq_cst)
+    {
+        return compare_exchange_strong(expected, desired, order, failureOrder(order));
+    }
+
+    /// @brief Same as compare_exchange_weak, deriving the order of the failure case from order
+    bool compare_exchange_weak(T& expected, T desired, memory_order order = memory_order_seq_cst)
+    {
+        return compare_exchange_weak(expected, desired, order, failureOrder(order));
+    }
+
+  protected:
+    // Failure of a compare exchange is a load, that can't have release semantics
+    static constexpr memory_order failureOrder(memory_order order)
+    {
+        return order == memory_order_acq_rel   ? memory_order_acquire
+               : order == memory_order_release ? memory_order_relaxed
+                                               : order;
+    }
+#if _MSC_VER
+    using Intrinsics = AtomicIntrinsics<sizeof(T)>;
+    using Bits       = typename Intrinsics::Type;
+
+    union Converter
+    {
+        T    value;
+        Bits bits;
+    };
+    static Bits toBits(T value)
+    {
+        Converter converter;
+        converter.bits  = 0;
+        converter.value = value;
+        return converter.bits;
+    }
+    static T fromBits(Bits bits)
+    {
+        Converter converter;
+        converter.bits = bits;
+        return converter.value;
+    }
+    volatile Bits*       bits() { return reinterpret_cast<volatile Bits*>(&value); }
+    const volatile Bits* bits() const { return reinterpret_cast<const volatile Bits*>(&value); }
+#endif
+    alignas(sizeof(T)) T value;
 };
+} // namespace detail
 
-template <>
-struct Atomic<bool>
+/// @brief Atomic variables of integer (of any width), `bool` or pointer types.
+/// Every operation accepts an optional SC::memory_order (sequential consistency by default), with the same
+/// semantics of `std::atomic`.
+/// @n
+/// Example:
+/// @code{.cpp}
+/// Atomic<bool> test = true;
+///
+/// SC_TEST_EXPECT(test.load());
+/// test.exchange(false);
+/// SC_TEST_EXPECT(not test.load());
+///
+/// Atomic<uint64_t> counter = 0;
+/// uint64_t expected = 0;
+/// SC_TEST_EXPECT(counter.compare_exchange_strong(expected, 10, memory_order_acq_rel));
+/// SC_TEST_EXPECT(counter.fetch_add(1, memory_order_relaxed) == 10);
+/// @endcode
+template <typename T>
+struct Atomic : public detail::AtomicBase<T>
 {
-    Atomic(bool value) : value(value) {}
+    using Base = detail::AtomicBase<T>;
 
-    bool exchange(bool desired)
+    constexpr Atomic(T value = T()) : Base(value) {}
+
+    /// @brief Atomically adds val, returning the previous value
+    T fetch_add(T val, memory_order order = memory_order_seq_cst)
     {
 #if _MSC_VER
-        return static_cast<bool>(_InterlockedExchange8(reinterpret_cast<volatile char*>(&value), desired));
+        (void)order;
+        return this->fromBits(Base::Intrinsics::fetchAdd(this->bits(), this->toBits(val)));
 #else
-        bool res;
-        __atomic_exchange(&value, &desired, &res, __ATOMIC_SEQ_CST);
-        return res;
+        return __atomic_fetch_add(&this->value, val, order);
 #endif
     }
 
-    bool load() const
+    /// @brief Atomically subtracts val, returning the previous value
+    T fetch_sub(T val, memory_order order = memory_order_seq_cst)
+    {
+        return fetch_add(static_cast<T>(T(0) - val), order);
+    }
+
+    /// @brief Atomically applies bitwise and with val, returning the previous value
+    T fetch_and(T val, memory_order order = memory_order_seq_cst)
     {
 #if _MSC_VER
-        char res = __iso_volatile_load8(reinterpret_cast<volatile const char*>(&value));
-        SC_COMPILER_MSVC_COMPILER_MEMORY_BARRIER();
-        return reinterpret_cast<bool&>(res);
+        (void)order;
+        return this->fromBits(Base::Intrinsics::fetchAnd(this->bits(), this->toBits(val)));
 #else
-        bool res;
-        __atomic_load(&value, &res, __ATOMIC_SEQ_CST);
-        return res;
+        return __atomic_fetch_and(&this->value, val, order);
 #endif
     }
 
-    bool load(memory_order mem) const
+    /// @brief Atomically applies bitwise or with val, returning the previous value
+    T fetch_or(T val, memory_order order = memory_order_seq_cst)
     {
 #if _MSC_VER
-        char res = __iso_volatile_load8(reinterpret_cast<volatile const char*>(&value));
-        SC_COMPILER_MSVC_ATOMIC_LOAD_VERIFY_MEMORY_ORDER(mem);
-        return reinterpret_cast<bool&>(res);
+        (void)order;
+        return this->fromBits(Base::Intrinsics::fetchOr(this->bits(), this->toBits(val)));
 #else
-        bool res;
-        __atomic_load(&value, &res, mem);
-        return res;
+        return __atomic_fetch_or(&this->value, val, order);
+#endif
+    }
+
+    /// @brief Atomically applies bitwise xor with val, returning the previous value
+    T fetch_xor(T val, memory_order order = memory_order_seq_cst)
+    {
+#if _MSC_VER
+        (void)order;
+        return this->fromBits(Base::Intrinsics::fetchXor(this->bits(), this->toBits(val)));
+#else
+        return __atomic_fetch_xor(&this->value, val, order);
+#endif
+    }
+};
+
+template <>
+struct Atomic<bool> : public detail::AtomicBase<bool>
+{
+    constexpr Atomic(bool value = false) : detail::AtomicBase<bool>(value) {}
+};
+
+template <typename T>
+struct Atomic<T*> : public detail::AtomicBase<T*>
+{
+    using Base = detail::AtomicBase<T*>;
+
+    constexpr Atomic(T* value = nullptr) : Base(value) {}
+
+    /// @brief Atomically advances the pointer by delta elements, returning the previous value
+    T* fetch_add(ssize_t delta, memory_order order = memory_order_seq_cst)
+    {
+        const ssize_t bytes = delta * static_cast<ssize_t>(sizeof(T));
+#if _MSC_VER
+        (void)order;
+        using Bits = typename Base::Bits;
+        return this->fromBits(Base::Intrinsics::fetchAdd(this->bits(), static_cast<Bits>(bytes)));
+#else
+        return __atomic_fetch_add(&this->value, bytes, order);
 #endif
     }
 
-  private:
-    volatile bool value;
+    /// @brief Atomically moves back the pointer by delta elements, returning the previous value
+    T* fetch_sub(ssize_t delta, memory_order order = memory_order_seq_cst) { return fetch_add(-delta, order); }
 };
 
 } // namespace SC
@@ -0,0 +1,660 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "../Containers/Hash.h"
+#include "../Foundation/Assert.h"
+#include "../Foundation/Memory.h"
+#include "../Foundation/Span.h"
+#include "EpochReclamation.h"
+
+namespace SC
+{
+template <typename Key, typename Value, typename HashFunction>
+struct ConcurrentHashMap;
+} // namespace SC
+
+//! @addtogroup group_threading
+//! @{
+
+/// @brief A hash map shared by many threads, with lock-free reads and striped writes.
+///
+/// It's meant for read-mostly data (for example caches) read by all workers of an SC::ThreadPool:
+/// - Readers look up values with ConcurrentHashMap::get inside a read section of an SC::EpochDomain, without taking
+///   any lock and without writing to any shared cache line, so they scale with the number of threads.
+/// - Writers take one of ConcurrentHashMap::NumStripes mutexes (chosen by key hash), so that only writers of keys in
+///   the same stripe wait for each other. Free slots are claimed with a compare exchange.
+///
+/// Every key-value pair lives in its own node, that is never modified after being published:
+/// ConcurrentHashMap::insertOverwrite replaces the node and ConcurrentHashMap::remove leaves a tombstone (reused by
+/// later insertions), retiring the old node to the SC::EpochDomain. Readers can keep using a value until they leave
+/// their read section, even if a writer has replaced or removed it in the meantime.
+///
+/// The map can be initialized in two ways:
+/// - ConcurrentHashMap::init with caller provided slots and nodes has a fixed capacity and never allocates.
+/// - ConcurrentHashMap::init with an initial capacity allocates nodes and slots with SC::Memory, and it grows when
+///   3/4 of the slots are used. Growth is incremental: a table with twice the slots is published, and every following
+///   write moves a batch of slots from the old table, so that no writer has to move all of them at once.
+///   Readers look up both tables until all slots have been moved.
+///
+/// @note Writers must be registered with the same SC::EpochDomain passed to the constructor.
+/// @tparam Key Type of the key (must support `==` comparison and must be hashable by HashFunction)
+/// @tparam Value Value type associated with Key
+/// @tparam HashFunction Functor hashing Key and all types comparable to it (defaults to SC::Hash)
+///
+/// Example:
+/// @snippet Libraries/Threading/Tests/ConcurrentHashMapTest.cpp concurrentHashMapSnippet
+template <typename Key, typename Value, typename HashFunction = SC::Hash<Key>>
+struct SC::ConcurrentHashMap
+{
+    static constexpr size_t NumStripes      = 32; ///< Number of mutexes serializing writers of the same keys
+    static constexpr size_t MinimumCapacity = 16; ///< Minimum number of slots of a growable map
+    static constexpr size_t MigrationBatch  = 64; ///< Slots moved to the new table by every write during growth
+
+    /// @brief Holds a key-value pair (supplied by the caller to initialize a fixed capacity map)
+    struct Node : public EpochRetired
+    {
+        Node() {}
+        ~Node() {}
+
+        Node(const Node&)            = delete;
+        Node& operator=(const Node&) = delete;
+
+      private:
+        friend struct ConcurrentHashMap;
+        uint64_t     hash = 0;
+        Atomic<bool> used = false; // A node of caller provided storage is holding a key-value pair
+        union
+        {
+            Key key;
+        };
+        union
+        {
+            Value value;
+        };
+    };
+
+    /// @brief A slot of the hash table (supplied by the caller to initialize a fixed capacity map)
+    struct Slot
+    {
+      private:
+        friend struct ConcurrentHashMap;
+        Atomic<size_t> bits = 0; // Empty, Tombstone or a Node pointer, optionally tagged with MovedBit
+    };
+
+    /// @brief Creates an empty map, whose values are reclaimed by domain
+    explicit ConcurrentHashMap(EpochDomain& domain) : domain(domain) {}
+
+    /// @brief Destroys all key-value pairs (there must be no reader or writer)
+    /// @note Caller provided nodes must outlive the SC::EpochDomain, that will still reclaim retired ones
+    ~ConcurrentHashMap() { destroy(); }
+
+    ConcurrentHashMap(const ConcurrentHashMap&)            = delete;
+    ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+
+    /// @brief Initializes a map with a fixed capacity, that never allocates memory
+    /// @param slotsStorage Caller owned slots, whose number must be a power of two
+    /// @param nodesStorage Caller owned nodes, limiting the number of key-value pairs (including the ones replaced or
+    /// removed but not yet reclaimed by the SC::EpochDomain)
+    [[nodiscard]] Result init(Span<Slot> slotsStorage, Span<Node> nodesStorage)
+    {
+        const size_t numSlots = slotsStorage.sizeInElements();
+        SC_TRY_MSG(current.load(memory_order_relaxed) == nullptr, "ConcurrentHashMap::init - Already initialized");
+        SC_TRY_MSG(numSlots > 0 and (numSlots & (numSlots - 1)) == 0,
+                   "ConcurrentHashMap::init - Number of slots must be a power of two");
+        SC_TRY_MSG(nodesStorage.sizeInElements() > 0, "ConcurrentHashMap::init - Nodes must not be empty");
+        nodes    = nodesStorage.data();
+        numNodes = nodesStorage.sizeInElements();
+        for (size_t idx = 0; idx < numNodes; ++idx)
+        {
+            nodes[idx].used.store(false, memory_order_relaxed);
+        }
+        for (size_t idx = 0; idx < numSlots; ++idx)
+        {
+            slotsStorage.data()[idx].bits.store(Empty, memory_order_relaxed);
+        }
+        fixedTable.slots = slotsStorage.data();
+        fixedTable.mask  = numSlots - 1;
+        current.store(&fixedTable, memory_order_release);
+        return Result(true);
+    }
+
+    /// @brief Initializes a map allocating nodes and slots, that grows as needed
+    /// @param initialCapacity Number of key-value pairs that can be inserted before growing
+    [[nodiscard]] Result init(size_t initialCapacity = 0)
+    {
+        SC_TRY_MSG(current.load(memory_order_relaxed) == nullptr, "ConcurrentHashMap::init - Already initialized");
+        size_t capacity = MinimumCapacity;
+        while (capacity - capacity / 4 < initialCapacity)
+        {
+            capacity *= 2;
+        }
+        Table* table = allocateTable(capacity);
+        SC_TRY_MSG(table != nullptr, "ConcurrentHashMap::init - Cannot allocate table");
+        current.store(table, memory_order_release);
+        return Result(true);
+    }
+
+    /// @brief Returns value associated to key (or `nullptr` if it doesn't exist) without taking any lock.
+    /// It must be called inside a read section of the SC::EpochDomain (see SC::EpochGuard), and the returned value can
+    /// be used until leaving it, even if the key is concurrently overwritten or removed.
+    template <typename ComparableToKey>
+    [[nodiscard]] const Value* get(const ComparableToKey& key) const
+    {
+        const Node* node = findNode(key, hashFunction(key));
+        return node ? &node->value : nullptr;
+    }
+
+    /// @brief Checks if the map contains key (it must be called inside a read section of the SC::EpochDomain)
+    template <typename ComparableToKey>
+    [[nodiscard]] bool contains(const ComparableToKey& key) const
+    {
+        return findNode(key, hashFunction(key)) != nullptr;
+    }
+
+    /// @brief Inserts a key-value pair if key doesn't exist already
+    /// @param writer Registration of the calling thread with the SC::EpochDomain
+    /// @return `false` if key already exists or if the map is full (or memory allocation fails)
+    template <typename K, typename V>
+    [[nodiscard]] bool insertIfNotExists(EpochThread& writer, K&& key, V&& value)
+    {
+        return insert(writer, Operation::InsertIfNotExists, forward<K>(key), forward<V>(value));
+    }
+
+    /// @brief Inserts a key-value pair, replacing the value of key if it already exists
+    /// @param writer Registration of the calling thread with the SC::EpochDomain
+    /// @return `false` if the map is full (or memory allocation fails)
+    template <typename K, typename V>
+    [[nodiscard]] bool insertOverwrite(EpochThread& writer, K&& key, V&& value)
+    {
+        return insert(writer, Operation::InsertOverwrite, forward<K>(key), forward<V>(value));
+    }
+
+    /// @brief Removes key from the map
+    /// @param writer Registration of the calling thread with the SC::EpochDomain
+    /// @return `true` if the key has been found and removed
+    template <typename ComparableToKey>
+    [[nodiscard]] bool remove(EpochThread& writer, const ComparableToKey& key)
+    {
+        return write(writer, Operation::Remove, key, hashFunction(key), nullptr);
+    }
+
+    /// @brief Returns number of key-value pairs (it can be outdated as soon as it's returned, if writers are active)
+    [[nodiscard]] size_t size() const { return numItems.load(memory_order_relaxed); }
+
+    /// @brief Returns number of slots of the current table
+    [[nodiscard]] size_t capacity() const
+    {
+        const Table* table = current.load(memory_order_acquire);
+        return table ? table->mask + 1 : 0;
+    }
+
+  private:
+    static constexpr size_t Empty     = 0;
+    static constexpr size_t Tombstone = 1; // Slot of a removed node, that can be reused by insertions
+    static constexpr size_t MovedBit  = 2; // Slot content has been moved to the next table
+
+    enum class Operation
+    {
+        InsertIfNotExists,
+        InsertOverwrite,
+        Remove,
+    };
+
+    enum class WriteResult
+    {
+        Done,
+        NotDone,
+        Retry, // The table has been replaced by a new one
+        Full,
+    };
+
+    struct Table : public EpochRetired
+    {
+        Slot*  slots = nullptr;
+        size_t mask  = 0;
+
+        Atomic<size_t> numUsed     = 0;       // Slots that are not Empty (holding a node or a Tombstone)
+        Atomic<size_t> migrateNext = 0;       // First slot not yet claimed by a migration batch
+        Atomic<size_t> numMigrated = 0;       // Slots whose migration to the next table is complete
+        Atomic<Table*> next        = nullptr; // Table where slots are being moved
+        Atomic<Table*> previous    = nullptr; // Table whose slots are being moved here
+    };
+
+    [[nodiscard]] static Node* nodeOf(size_t bits) { return reinterpret_cast<Node*>(bits & ~(Tombstone | MovedBit)); }
+    [[nodiscard]] static size_t stripeOf(uint64_t hash) { return static_cast<size_t>(hash >> 32) % NumStripes; }
+
+    template <typename ComparableToKey>
+    [[nodiscard]] static bool matches(const Node& node, const ComparableToKey& key, uint64_t hash)
+    {
+        return node.hash == hash and node.key == key;
+    }
+
+    // Looks up key in table, following it to the next table if it has been moved there
+    template <typename ComparableToKey>
+    [[nodiscard]] static const Node* findInTable(const Table* table, const ComparableToKey& key, uint64_t hash)
+    {
+        while (table != nullptr)
+        {
+            const Table* next = nullptr;
+            for (size_t probe = 0, idx = hash & table->mask; probe <= table->mask; ++probe)
+            {
+                const size_t bits = table->slots[idx].bits.load(memory_order_acquire);
+                if ((bits & ~MovedBit) == Empty)
+                {
+                    return nullptr; // Probing stops at the first slot that was Empty
+                }
+                const Node* node = nodeOf(bits);
+                if (node != nullptr and matches(*node, key, hash))
+                {
+                    if ((bits & MovedBit) == 0)
+                    {
+                        return node;
+                    }
+                    next = table->next.load(memory_order_acquire);
+                    break;
+                }
+                idx = (idx + 1) & table->mask;
+            }
+            table = next;
+        }
+        return nullptr;
+    }
+
+    template <typename ComparableToKey>
+    [[nodiscard]] const Node* findNode(const ComparableToKey& key, uint64_t hash) const
+    {
+        const Table* table = current.load(memory_order_acquire);
+        if (table == nullptr)
+        {
+            return nullptr;
+        }
+        // Previous table must be loaded before probing the current one, or a key moved after being missed in the
+        // current table could be missed in the previous one too, if the migration completes in the meantime
+        const Table* previous = table->previous.load(memory_order_acquire);
+        const Node*  node     = findInTable(table, key, hash);
+        if (node == nullptr and previous != nullptr)
+        {
+            // Keys not moved yet are still in the previous table (or they're followed back here if moved meanwhile)
+            node = findInTable(previous, key, hash);
+        }
+        return node;
+    }
+
+    template <typename K, typename V>
+    [[nodiscard]] bool insert(EpochThread& writer, Operation operation, K&& key, V&& value)
+    {
+        Node* node = allocateNode();
+        if (node == nullptr)
+        {
+            return false;
+        }
+        new (&node->key, PlacementNew()) Key(forward<K>(key));
+        new (&node->value, PlacementNew()) Value(forward<V>(value));
+        node->hash = hashFunction(node->key);
+        if (not write(writer, operation, node->key, node->hash, node))
+        {
+            node->reclaim(*node); // Never published, so it can be released immediately
+            return false;
+        }
+        return true;
+    }
+
+    template <typename ComparableToKey>
+    [[nodiscard]] bool write(EpochThread& writer, Operation operation, const ComparableToKey& key, uint64_t hash,
+                             Node* node)
+    {
+        EpochGuard guard(domain, writer);
+        if (current.load(memory_order_acquire) == nullptr)
+        {
+            return false;
+        }
+        while (true)
+        {
+            migrateBatch(writer); // Must be done without holding a stripe, as it locks the stripes of moved nodes
+            Table*      table  = current.load(memory_order_acquire);
+            bool        grow   = false;
+            Mutex&      stripe = stripes[stripeOf(hash)];
+            WriteResult result;
+            stripe.lock();
+            do
+            {
+                table  = current.load(memory_order_acquire);
+                result = writeLocked(writer, operation, *table, key, hash, node, grow);
+            } while (result == WriteResult::Retry);
+            stripe.unlock();
+
+            if (grow or result == WriteResult::Full)
+            {
+                // Growing must be done without holding a stripe, as it may need to complete a migration
+                if (not growTable(writer, *table) and result == WriteResult::Full)
+                {
+                    return false; // Fixed capacity or allocation failure
+                }
+            }
+            if (result != WriteResult::Full)
+            {
+                return result == WriteResult::Done;
+            }
+        }
+    }
+
+    // Called holding the stripe of hash, so that no other thread writes or moves nodes with the same key
+    template <typename ComparableToKey>
+    [[nodiscard]] WriteResult writeLocked(EpochThread& writer, Operation operation, Table& table,
+                                          const ComparableToKey& key, uint64_t hash, Node* node, bool& grow)
+    {
+        // Moves key from previous table, so that it's never found in both tables
+        Table* previous = table.previous.load(memory_order_acquire);
+        if (previous != nullptr)
+        {
+            for (size_t probe = 0, idx = hash & previous->mask; probe <= previous->mask; ++probe)
+            {
+                Slot&        slot = previous->slots[idx];
+                const size_t bits = slot.bits.load(memory_order_acquire);
+                if ((bits & ~MovedBit) == Empty)
+                {
+                    break;
+                }
+                Node* found = nodeOf(bits);
+                if (found != nullptr and (bits & MovedBit) == 0 and matches(*found, key, hash))
+                {
+                    SC_ASSERT_RELEASE(placeNode(table, *found));
+                    slot.bits.store(bits | MovedBit, memory_order_release);
+                    break;
+                }
+                idx = (idx + 1) & previous->mask;
+            }
+        }
+
+        // Looks for key, remembering the first slot where it could be inserted
+        size_t freeIndex = table.mask + 1;
+        size_t freeBits  = Empty;
+        for (size_t probe = 0, idx = hash & table.mask; probe <= table.mask; ++probe)
+        {
+            Slot&  slot = table.slots[idx];
+            size_t bits = slot.bits.load(memory_order_acquire);
+            if (bits & MovedBit)
+            {
+                return WriteResult::Retry; // Table is being moved to a new one
+            }
+            Node* found = nodeOf(bits);
+            if (found == nullptr)
+            {
+                if (freeIndex > table.mask)
+                {
+                    freeIndex = idx;
+                    freeBits  = bits;
+                }
+                if (bits == Empty)
+                {
+                    break;
+                }
+            }
+            else if (matches(*found, key, hash))
+            {
+                if (operation == Operation::InsertIfNotExists)
+                {
+                    return WriteResult::NotDone;
+                }
+                const size_t replacement = operation == Operation::Remove ? Tombstone : reinterpret_cast<size_t>(node);
+                if (not slot.bits.compare_exchange_strong(bits, replacement, memory_order_acq_rel))
+                {
+                    return WriteResult::Retry; // Slot has been marked as moved
+                }
+                if (operation == Operation::Remove)
+                {
+                    numItems.fetch_sub(1, memory_order_relaxed);
+                }
+                domain.retire(writer, *found);
+                return WriteResult::Done;
+            }
+            idx = (idx + 1) & table.mask;
+        }
+        if (operation == Operation::Remove)
+        {
+            return WriteResult::NotDone;
+        }
+        if (freeIndex > table.mask)
+        {
+            return WriteResult::Full;
+        }
+        // Slot can be concurrently claimed by a writer of another stripe or marked as moved
+        if (not table.slots[freeIndex].bits.compare_exchange_strong(freeBits, reinterpret_cast<size_t>(node),
+                                                                    memory_order_acq_rel))
+        {
+            return WriteResult::Retry;
+        }
+        numItems.fetch_add(1, memory_order_relaxed);
+        if (freeBits == Empty)
+        {
+            const size_t numUsed = table.numUsed.fetch_add(1, memory_order_relaxed) + 1;
+            grow                 = numUsed > table.mask + 1 - (table.mask + 1) / 4;
+        }
+        return WriteResult::Done;
+    }
+
+    // Inserts a node (whose key is not in table) in the first Empty or Tombstone slot
+    [[nodiscard]] static bool placeNode(Table& table, Node& node)
+    {
+        for (size_t probe = 0, idx = node.hash & table.mask; probe <= table.mask; ++probe)
+        {
+            Slot&  slot = table.slots[idx];
+            size_t bits = slot.bits.load(memory_order_acquire);
+            while (nodeOf(bits) == nullptr and (bits & MovedBit) == 0)
+            {
+                if (slot.bits.compare_exchange_weak(bits, reinterpret_cast<size_t>(&node), memory_order_acq_rel))
+                {
+                    if (bits == Empty)
+                    {
+                        table.numUsed.fetch_add(1, memory_order_relaxed);
+                    }
+                    return true;
+                }
+            }
+            idx = (idx + 1) & table.mask;
+        }
+        return false;
+    }
+
+    // Moves a batch of slots from the previous table to the current one
+    void migrateBatch(EpochThread& writer)
+    {
+        Table* table    = current.load(memory_order_acquire);
+        Table* previous = table ? table->previous.load(memory_order_acquire) : nullptr;
+        if (previous == nullptr)
+        {
+            return;
+        }
+        const size_t numSlots = previous->mask + 1;
+        const size_t first    = previous->migrateNext.fetch_add(MigrationBatch, memory_order_relaxed);
+        if (first >= numSlots)
+        {
+            return; // All slots have been claimed by other writers
+        }
+        const size_t last = min(first + MigrationBatch, numSlots);
+        for (size_t idx = first; idx < last; ++idx)
+        {
+            migrateSlot(*table, previous->slots[idx]);
+        }
+        if (previous->numMigrated.fetch_add(last - first, memory_order_acq_rel) + (last - first) == numSlots)
+        {
+            // Readers still looking at the previous table are protected by the domain until they leave
+            table->previous.store(nullptr, memory_order_release);
+            domain.retire(writer, *previous);
+        }
+    }
+
+    void migrateSlot(Table& table, Slot& slot)
+    {
+        size_t bits = slot.bits.load(memory_order_acquire);
+        while ((bits & MovedBit) == 0)
+        {
+            Node* node = nodeOf(bits);
+            if (node == nullptr)
+            {
+                // Marking Empty and Tombstone slots prevents writers still using this table from claiming them
+                (void)slot.bits.compare_exchange_weak(bits, bits | MovedBit, memory_order_acq_rel);
+                continue;
+            }
+            // Node can't be reused for another key while this thread is inside a read section
+            Mutex& stripe = stripes[stripeOf(node->hash)];
+            stripe.lock();
+            bits = slot.bits.load(memory_order_acquire);
+            if (nodeOf(bits) == node and (bits & MovedBit) == 0)
+            {
+                SC_ASSERT_RELEASE(placeNode(table, *node));
+                slot.bits.store(bits | MovedBit, memory_order_release);
+            }
+            stripe.unlock();
+            bits = slot.bits.load(memory_order_acquire);
+        }
+    }
+
+    // Publishes a table with twice the slots of the given one (if no other thread has already done it)
+    [[nodiscard]] bool growTable(EpochThread& writer, Table& table)
+    {
+        if (&table == &fixedTable)
+        {
+            return false;
+        }
+        bool grown = true;
+        resizeMutex.lock();
+        if (current.load(memory_order_acquire) == &table)
+        {
+            // Previous growth must be complete, as readers only look into current and previous tables
+            while (table.previous.load(memory_order_acquire) != nullptr)
+            {
+                migrateBatch(writer);
+                if (table.previous.load(memory_order_acquire) != nullptr)
+                {
+                    Thread::Sleep(0); // Waiting for other writers to complete the batches they've claimed
+                }
+            }
+            Table* next = allocateTable((table.mask + 1) * 2);
+            if (next != nullptr)
+            {
+                next->previous.store(&table, memory_order_relaxed);
+                table.next.store(next, memory_order_release);
+                current.store(next, memory_order_release);
+            }
+            grown = next != nullptr;
+        }
+        resizeMutex.unlock();
+        return grown;
+    }
+
+    [[nodiscard]] Node* allocateNode()
+    {
+        if (nodes != nullptr)
+        {
+            // Nodes reclaimed by the domain are marked as unused, and they're found again by a rotating cursor
+            for (size_t attempt = 0; attempt < numNodes; ++attempt)
+            {
+                Node& node     = nodes[nodesCursor.fetch_add(1, memory_order_relaxed) % numNodes];
+                bool  expected = false;
+                if (not node.used.load(memory_order_relaxed) and
+                    node.used.compare_exchange_strong(expected, true, memory_order_acquire))
+                {
+                    node.reclaim = &ConcurrentHashMap::releaseNode;
+                    return &node;
+                }
+            }
+            return nullptr;
+        }
+        void* memory = Memory::allocate(sizeof(Node));
+        if (memory == nullptr)
+        {
+            return nullptr;
+        }
+        Node* node    = new (memory, PlacementNew()) Node();
+        node->reclaim = &ConcurrentHashMap::freeNode;
+        return node;
+    }
+
+    // Reclaims a node of caller provided storage
+    static void releaseNode(EpochRetired& retired)
+    {
+        Node& node = static_cast<Node&>(retired);
+        node.key.~Key();
+        node.value.~Value();
+        node.used.store(false, memory_order_release);
+    }
+
+    // Reclaims a node allocated with SC::Memory
+    static void freeNode(EpochRetired& retired)
+    {
+        Node& node = static_cast<Node&>(retired);
+        node.key.~Key();
+        node.value.~Value();
+        node.~Node();
+        Memory::release(&node);
+    }
+
+    [[nodiscard]] static Table* allocateTable(size_t numSlots)
+    {
+        void* memory = Memory::allocate(sizeof(Table) + numSlots * sizeof(Slot));
+        if (memory == nullptr)
+        {
+            return nullptr;
+        }
+        Table* table   = new (memory, PlacementNew()) Table();
+        table->slots   = reinterpret_cast<Slot*>(table + 1);
+        table->mask    = numSlots - 1;
+        table->reclaim = &ConcurrentHashMap::freeTable;
+        for (size_t idx = 0; idx < numSlots; ++idx)
+        {
+            new (&table->slots[idx], PlacementNew()) Slot();
+        }
+        return table;
+    }
+
+    static void freeTable(EpochRetired& retired)
+    {
+        Table& table = static_cast<Table&>(retired);
+        table.~Table();
+        Memory::release(&table);
+    }
+
+    void destroy()
+    {
+        Table* table = current.exchange(nullptr);
+        if (table == nullptr)
+        {
+            return;
+        }
+        Table* tables[2] = {table->previous.load(memory_order_relaxed), table};
+        for (Table* it : tables)
+        {
+            for (size_t idx = 0; it != nullptr and idx <= it->mask; ++idx)
+            {
+                const size_t bits = it->slots[idx].bits.load(memory_order_relaxed);
+                Node*        node = nodeOf(bits);
+                if (node != nullptr and (bits & MovedBit) == 0)
+                {
+                    node->reclaim(*node);
+                }
+            }
+            if (it != nullptr and it != &fixedTable)
+            {
+                freeTable(*it);
+            }
+        }
+        numItems.store(0, memory_order_relaxed);
+    }
+
+    EpochDomain& domain;
+    HashFunction hashFunction;
+
+    Atomic<Table*> current  = nullptr;
+    Atomic<size_t> numItems = 0;
+
+    Table  fixedTable;                 // Table using caller provided slots
+    Node*  nodes    = nullptr;         // Caller provided nodes
+    size_t numNodes = 0;
+    Atomic<size_t> nodesCursor = 0;    // Next caller provided node to check for allocation
+
+    Mutex stripes[NumStripes];
+    Mutex resizeMutex;
+};
+
+//! @}
@@ -0,0 +1,494 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "CpuTopology.h"
+#include "../Foundation/Memory.h"
+
+#if SC_PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>  // open
+#include <unistd.h> // read, close, sysconf
+#if SC_PLATFORM_APPLE
+#include <sys/sysctl.h> // sysctlbyname
+#endif
+#endif
+
+struct SC::CpuTopology::Internal
+{
+#if SC_PLATFORM_LINUX
+    // Null terminated path built from pieces, as in "/sys/devices/system/cpu/cpu" + 3 + "/topology/core_id"
+    struct SysPath
+    {
+        char   buffer[128];
+        size_t length = 0;
+
+        SysPath& append(const char* text)
+        {
+            for (; *text != 0 and length + 1 < sizeof(buffer); ++text)
+            {
+                buffer[length++] = *text;
+            }
+            buffer[length] = 0;
+            return *this;
+        }
+
+        SysPath& append(uint32_t number)
+        {
+            char   digits[10];
+            size_t numDigits = 0;
+            do
+            {
+                digits[numDigits++] = static_cast<char>('0' + number % 10);
+                number /= 10;
+            } while (number != 0);
+            while (numDigits > 0 and length + 1 < sizeof(buffer))
+            {
+                buffer[length++] = digits[--numDigits];
+            }
+            buffer[length] = 0;
+            return *this;
+        }
+    };
+
+    // Reads a (small) text file of sysfs as a null terminated string
+    [[nodiscard]] static bool readFile(const SysPath& path, char (&text)[1024])
+    {
+        const int fileDescriptor = ::open(path.buffer, O_RDONLY | O_CLOEXEC);
+        if (fileDescriptor < 0)
+        {
+            return false;
+        }
+        size_t  length = 0;
+        ssize_t numRead;
+        do
+        {
+            numRead = ::read(fileDescriptor, text + length, sizeof(text) - 1 - length);
+            if (numRead > 0)
+            {
+                length += static_cast<size_t>(numRead);
+            }
+        } while (numRead > 0 and length < sizeof(text) - 1);
+        ::close(fileDescriptor);
+        text[length] = 0;
+        return numRead >= 0;
+    }
+
+    [[nodiscard]] static bool parseNumber(const char*& it, uint32_t& value)
+    {
+        if (*it < '0' or *it > '9')
+        {
+            return false;
+        }
+        value = 0;
+        for (; *it >= '0' and *it <= '9'; ++it)
+        {
+            value = value * 10 + static_cast<uint32_t>(*it - '0');
+        }
+        return true;
+    }
+
+    [[nodiscard]] static bool readNumber(const SysPath& path, uint32_t& value)
+    {
+        char text[1024];
+        if (not readFile(path, text))
+        {
+            return false;
+        }
+        const char* it = text;
+        return parseNumber(it, value);
+    }
+
+    // Parses lists of ranges like "0-3,8-11,16" (as found in cpulist files)
+    [[nodiscard]] static bool readList(const SysPath& path, CpuSet& list)
+    {
+        char text[1024];
+        if (not readFile(path, text))
+        {
+            return false;
+        }
+        list.clear();
+        const char* it = text;
+        uint32_t    first, last;
+        while (parseNumber(it, first))
+        {
+            last = first;
+            if (*it == '-')
+            {
+                ++it;
+                if (not parseNumber(it, last))
+                {
+                    return false;
+                }
+            }
+            for (uint32_t value = first; value <= last; ++value)
+            {
+                if (not list.add(value))
+                {
+                    return false;
+                }
+            }
+            if (*it != ',')
+            {
+                break;
+            }
+            ++it;
+        }
+        return true;
+    }
+
+    // Parses sizes like "48K" or "32M" (as found in cache size files)
+    [[nodiscard]] static bool readSize(const SysPath& path, size_t& size)
+    {
+        char text[1024];
+        if (not readFile(path, text))
+        {
+            return false;
+        }
+        const char* it = text;
+        uint32_t    value;
+        if (not parseNumber(it, value))
+        {
+            return false;
+        }
+        size = value;
+        switch (*it)
+        {
+        case 'K': size *= 1024; break;
+        case 'M': size *= 1024 * 1024; break;
+        case 'G': size *= 1024 * 1024 * 1024; break;
+        default: break;
+        }
+        return true;
+    }
+
+    [[nodiscard]] static bool stringEquals(const char* text, const char* expected)
+    {
+        for (; *expected != 0; ++text, ++expected)
+        {
+            if (*text != *expected)
+                return false;
+        }
+        return *text == 0 or *text == '\n';
+    }
+
+    static void detectCaches(CpuTopology& topology, uint32_t cpu)
+    {
+        for (uint32_t index = 0; index < 8; ++index)
+        {
+            SysPath cachePath;
+            cachePath.append("/sys/devices/system/cpu/cpu").append(cpu).append("/cache/index").append(index);
+
+            uint32_t level;
+            size_t   size;
+            char     type[1024];
+            if (not readNumber(SysPath(cachePath).append("/level"), level) or
+                not readSize(SysPath(cachePath).append("/size"), size) or
+                not readFile(SysPath(cachePath).append("/type"), type))
+            {
+                break; // No more caches
+            }
+            if (level == 1 and stringEquals(type, "Data"))
+            {
+                topology.l1DataCacheSize = size;
+                uint32_t lineSize;
+                if (readNumber(SysPath(cachePath).append("/coherency_line_size"), lineSize))
+                {
+                    topology.cacheLineSize = lineSize;
+                }
+            }
+            else if (level == 2 and not stringEquals(type, "Instruction"))
+            {
+                topology.l2CacheSize = size;
+            }
+            else if (level == 3 and not stringEquals(type, "Instruction"))
+            {
+                topology.l3CacheSize = size;
+            }
+        }
+    }
+
+    [[nodiscard]] static Result detect(CpuTopology& topology)
+    {
+        CpuSet online;
+        if (not readList(SysPath().append("/sys/devices/system/cpu/online"), online))
+        {
+            return Result::Error("CpuTopology::detect - Cannot read /sys/devices/system/cpu/online");
+        }
+
+        // Node of each processor (all processors are on node 0 on kernels without NUMA support)
+        uint32_t cpuNodes[MaxCpus];
+        for (uint32_t& node : cpuNodes)
+        {
+            node = 0;
+        }
+        CpuSet nodes;
+        if (readList(SysPath().append("/sys/devices/system/node/online"), nodes))
+        {
+            for (uint32_t node = 0; node < CpuSet::MaxCpus; ++node)
+            {
+                CpuSet nodeCpus;
+                if (nodes.contains(node) and
+                    readList(SysPath().append("/sys/devices/system/node/node").append(node).append("/cpulist"),
+                             nodeCpus))
+                {
+                    for (uint32_t cpu = 0; cpu < MaxCpus; ++cpu)
+                    {
+                        if (nodeCpus.contains(cpu))
+                            cpuNodes[cpu] = node;
+                    }
+                }
+            }
+        }
+
+        bool cachesDetected = false;
+        for (uint32_t cpu = 0; cpu < MaxCpus; ++cpu)
+        {
+            if (not online.contains(cpu))
+            {
+                continue;
+            }
+            // The first SMT sibling identifies the core (core_id is unique only inside the same package)
+            SysPath topologyPath;
+            topologyPath.append("/sys/devices/system/cpu/cpu").append(cpu).append("/topology/");
+
+            CpuSet siblings;
+            if (not readList(SysPath(topologyPath).append("core_cpus_list"), siblings) and
+                not readList(SysPath(topologyPath).append("thread_siblings_list"), siblings))
+            {
+                (void)siblings.add(cpu); // Every processor is a core of its own
+            }
+            uint32_t coreId = cpu;
+            for (uint32_t sibling = 0; sibling < cpu; ++sibling)
+            {
+                if (siblings.contains(sibling))
+                {
+                    coreId = sibling;
+                    break;
+                }
+            }
+            SC_TRY(topology.addCpu(cpu, coreId, cpuNodes[cpu]));
+            if (not cachesDetected)
+            {
+                detectCaches(topology, cpu);
+                cachesDetected = true;
+            }
+        }
+        return Result(true);
+    }
+#elif SC_PLATFORM_WINDOWS
+    [[nodiscard]] static Result detect(CpuTopology& topology)
+    {
+        using Information = SYSTEM_LOGICAL_PROCESSOR_INFORMATION;
+
+        DWORD length = 0;
+        ::GetLogicalProcessorInformation(nullptr, &length);
+        Information* informations = static_cast<Information*>(Memory::allocate(length));
+        SC_TRY_MSG(informations != nullptr, "CpuTopology::detect - Cannot allocate memory");
+        if (::GetLogicalProcessorInformation(informations, &length) == FALSE)
+        {
+            Memory::release(informations);
+            return Result::Error("CpuTopology::detect - GetLogicalProcessorInformation failed");
+        }
+        const DWORD numInformations = length / sizeof(Information);
+
+        // Only processors of the first group (up to 64) are described by masks
+        static constexpr uint32_t MaskBits = sizeof(ULONG_PTR) * 8;
+
+        uint32_t cpuCores[MaskBits];
+        uint32_t cpuNodes[MaskBits];
+        for (uint32_t cpu = 0; cpu < MaskBits; ++cpu)
+        {
+            cpuCores[cpu] = MaxCpus;
+            cpuNodes[cpu] = 0;
+        }
+        for (DWORD idx = 0; idx < numInformations; ++idx)
+        {
+            const Information& information = informations[idx];
+            switch (information.Relationship)
+            {
+            case RelationProcessorCore:
+            case RelationNumaNode:
+                for (uint32_t cpu = 0; cpu < MaskBits; ++cpu)
+                {
+                    if (information.ProcessorMask & (ULONG_PTR(1) << cpu))
+                    {
+                        if (information.Relationship == RelationProcessorCore)
+                            cpuCores[cpu] = idx;
+                        else
+                            cpuNodes[cpu] = information.NumaNode.NodeNumber;
+                    }
+                }
+                break;
+            case RelationCache: {
+                const CACHE_DESCRIPTOR& cache = information.Cache;
+                if (cache.Level == 1 and cache.Type == CacheData)
+                {
+                    topology.l1DataCacheSize = cache.Size;
+                    topology.cacheLineSize   = cache.LineSize;
+                }
+                else if (cache.Level == 2 and cache.Type != CacheInstruction)
+                {
+                    topology.l2CacheSize = cache.Size;
+                }
+                else if (cache.Level == 3 and cache.Type != CacheInstruction)
+                {
+                    topology.l3CacheSize = cache.Size;
+                }
+                break;
+            }
+            default: break;
+            }
+        }
+        Memory::release(informations);
+        for (uint32_t cpu = 0; cpu < MaskBits; ++cpu)
+        {
+            if (cpuCores[cpu] != MaxCpus)
+            {
+                SC_TRY(topology.addCpu(cpu, cpuCores[cpu], cpuNodes[cpu]));
+            }
+        }
+        return Result(true);
+    }
+#elif SC_PLATFORM_APPLE
+    [[nodiscard]] static bool readSysctl(const char* name, uint64_t& value)
+    {
+        // Some values are 32 bits and some are 64 bits (but they're all little endian)
+        value         = 0;
+        size_t length = sizeof(value);
+        return ::sysctlbyname(name, &value, &length, nullptr, 0) == 0;
+    }
+
+    [[nodiscard]] static Result detect(CpuTopology& topology)
+    {
+        uint64_t numLogical = 0, numPhysical = 0, value = 0;
+        SC_TRY_MSG(readSysctl("hw.logicalcpu", numLogical) and readSysctl("hw.physicalcpu", numPhysical) and
+                       numPhysical > 0,
+                   "CpuTopology::detect - sysctlbyname failed");
+        if (readSysctl("hw.l1dcachesize", value))
+            topology.l1DataCacheSize = static_cast<size_t>(value);
+        if (readSysctl("hw.l2cachesize", value))
+            topology.l2CacheSize = static_cast<size_t>(value);
+        if (readSysctl("hw.l3cachesize", value))
+            topology.l3CacheSize = static_cast<size_t>(value);
+        if (readSysctl("hw.cachelinesize", value))
+            topology.cacheLineSize = static_cast<uint32_t>(value);
+
+        // Assumes SMT siblings to be numbered consecutively, on a single node
+        const uint64_t threadsPerCore = numLogical >= numPhysical ? numLogical / numPhysical : 1;
+        for (uint64_t cpu = 0; cpu < numLogical and cpu < MaxCpus; ++cpu)
+        {
+            SC_TRY(topology.addCpu(static_cast<uint32_t>(cpu), static_cast<uint32_t>(cpu / threadsPerCore), 0));
+        }
+        return Result(true);
+    }
+#else
+    [[nodiscard]] static Result detect(CpuTopology& topology)
+    {
+        const long numProcessors = ::sysconf(_SC_NPROCESSORS_ONLN);
+        for (long cpu = 0; cpu < numProcessors and cpu < long(MaxCpus); ++cpu)
+        {
+            SC_TRY(topology.addCpu(static_cast<uint32_t>(cpu), static_cast<uint32_t>(cpu), 0));
+        }
+        if (topology.getNumCpus() == 0)
+        {
+            SC_TRY(topology.addCpu(0, 0, 0));
+        }
+        return Result(true);
+    }
+#endif
+};
+
+SC::Result SC::CpuTopology::detect()
+{
+    clear();
+    Result res = Internal::detect(*this);
+    if (not res)
+    {
+        clear();
+    }
+    return res;
+}
+
+void SC::CpuTopology::clear()
+{
+    cpus.clear();
+    numCores        = 0;
+    numNodes        = 0;
+    l1DataCacheSize = 0;
+    l2CacheSize     = 0;
+    l3CacheSize     = 0;
+    cacheLineSize   = 0;
+}
+
+SC::Result SC::CpuTopology::addCpu(uint32_t cpu, uint32_t coreId, uint32_t nodeId)
+{
+    SC_TRY_MSG(cpu < MaxCpus, "CpuTopology::addCpu - Invalid cpu index");
+    SC_TRY_MSG(not cpus.contains(cpu), "CpuTopology::addCpu - Cpu has already been added");
+
+    uint32_t node = 0;
+    while (node < numNodes and nodeIds[node] != nodeId)
+    {
+        node++;
+    }
+    uint32_t core = 0;
+    while (core < numCores and coreIds[core] != coreId)
+    {
+        core++;
+    }
+    if (core < numCores)
+    {
+        SC_TRY_MSG(coreNodes[core] == node, "CpuTopology::addCpu - Core has processors on different nodes");
+    }
+    else
+    {
+        SC_TRY_MSG(node < MaxNodes, "CpuTopology::addCpu - Too many nodes");
+        if (node == numNodes)
+        {
+            nodeIds[numNodes++] = nodeId;
+        }
+        coreIds[numCores]   = coreId;
+        coreNodes[numCores] = static_cast<uint16_t>(node);
+        numCores++;
+    }
+    cpuCores[cpu] = static_cast<uint16_t>(core);
+    (void)cpus.add(cpu);
+    return Result(true);
+}
+
+bool SC::CpuTopology::getCpu(uint32_t cpu, uint32_t& core, uint32_t& node) const
+{
+    if (not cpus.contains(cpu))
+    {
+        return false;
+    }
+    core = cpuCores[cpu];
+    node = coreNodes[core];
+    return true;
+}
+
+SC::CpuSet SC::CpuTopology::getCoreCpus(uint32_t core) const
+{
+    CpuSet coreCpus;
+    for (uint32_t cpu = 0; cpu < MaxCpus; ++cpu)
+    {
+        if (cpus.contains(cpu) and cpuCores[cpu] == core)
+        {
+            (void)coreCpus.add(cpu);
+        }
+    }
+    return coreCpus;
+}
+
+SC::CpuSet SC::CpuTopology::getNodeCpus(uint32_t node) const
+{
+    CpuSet nodeCpus;
+    for (uint32_t cpu = 0; cpu < MaxCpus; ++cpu)
+    {
+        if (cpus.contains(cpu) and coreNodes[cpuCores[cpu]] == node)
+        {
+            (void)nodeCpus.add(cpu);
+        }
+    }
+    return nodeCpus;
+}
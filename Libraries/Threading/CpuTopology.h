@@ -0,0 +1,89 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "Threading.h"
+
+namespace SC
+{
+struct CpuTopology;
+} // namespace SC
+
+//! @addtogroup group_threading
+//! @{
+
+/// @brief Logical processors of the machine, grouped in physical cores (SMT siblings) and NUMA nodes.
+///
+/// CpuTopology::detect reads the topology of online processors from the OS:
+/// - On Linux it parses `/sys/devices/system/cpu` (SMT siblings, caches) and `/sys/devices/system/node` (NUMA nodes)
+/// - On Windows it uses `GetLogicalProcessorInformation` (limited to the first processor group)
+/// - On macOS it uses `sysctl` (assuming a single node)
+///
+/// Cores and nodes are numbered with consecutive indices (starting from zero), that can be different from the ids
+/// used by the OS. Processors keep the index used by the OS, to be used with SC::CpuSet and SC::Thread::setAffinity.
+/// A topology can also be built manually with CpuTopology::addCpu (for example to test placement policies).
+///
+/// SC::ThreadPool can use it to create one worker for each physical core, with per-node queues.
+///
+/// Example:
+/// @snippet Libraries/Threading/Tests/CpuTopologyTest.cpp cpuTopologySnippet
+struct SC::CpuTopology
+{
+    static constexpr uint32_t MaxCpus  = CpuSet::MaxCpus; ///< Maximum number of logical processors
+    static constexpr uint32_t MaxNodes = 64;              ///< Maximum number of NUMA nodes
+
+    size_t   l1DataCacheSize = 0; ///< Size (in bytes) of the L1 data cache of a core (0 if unknown)
+    size_t   l2CacheSize     = 0; ///< Size (in bytes) of the L2 cache (0 if unknown)
+    size_t   l3CacheSize     = 0; ///< Size (in bytes) of the L3 cache (0 if unknown)
+    uint32_t cacheLineSize   = 0; ///< Size (in bytes) of a cache line (0 if unknown)
+
+    /// @brief Replaces current topology with the one of online processors of this machine
+    [[nodiscard]] Result detect();
+
+    /// @brief Adds a logical processor to the topology
+    /// @param cpu Index of the processor (as used by the OS and SC::CpuSet)
+    /// @param coreId Any identifier of the physical core, shared by all SMT siblings of the processor
+    /// @param nodeId Any identifier of the NUMA node of the core
+    [[nodiscard]] Result addCpu(uint32_t cpu, uint32_t coreId, uint32_t nodeId);
+
+    /// @brief Removes all processors, cores, nodes and cache sizes
+    void clear();
+
+    /// @brief Returns the number of logical processors
+    [[nodiscard]] uint32_t getNumCpus() const { return cpus.count(); }
+
+    /// @brief Returns the number of physical cores
+    [[nodiscard]] uint32_t getNumCores() const { return numCores; }
+
+    /// @brief Returns the number of NUMA nodes
+    [[nodiscard]] uint32_t getNumNodes() const { return numNodes; }
+
+    /// @brief Returns all logical processors
+    [[nodiscard]] const CpuSet& getCpus() const { return cpus; }
+
+    /// @brief Obtains core and node indices of a logical processor
+    /// @return `false` if the processor is not part of the topology
+    [[nodiscard]] bool getCpu(uint32_t cpu, uint32_t& core, uint32_t& node) const;
+
+    /// @brief Returns the node index of a core (0 if core is not valid)
+    [[nodiscard]] uint32_t getCoreNode(uint32_t core) const { return core < numCores ? coreNodes[core] : 0; }
+
+    /// @brief Returns all logical processors (SMT siblings) of a physical core
+    [[nodiscard]] CpuSet getCoreCpus(uint32_t core) const;
+
+    /// @brief Returns all logical processors of a NUMA node
+    [[nodiscard]] CpuSet getNodeCpus(uint32_t node) const;
+
+  private:
+    struct Internal;
+
+    CpuSet   cpus;
+    uint32_t numCores = 0;
+    uint32_t numNodes = 0;
+
+    uint16_t cpuCores[MaxCpus];  // Core index of each processor in cpus
+    uint16_t coreNodes[MaxCpus]; // Node index of each core
+    uint32_t coreIds[MaxCpus];   // Identifier passed to addCpu for each core
+    uint32_t nodeIds[MaxNodes];  // Identifier passed to addCpu for each node
+};
+
+//! @}
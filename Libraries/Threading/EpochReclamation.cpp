@@ -0,0 +1,215 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "EpochReclamation.h"
+#include "../Foundation/Assert.h"
+
+struct SC::EpochDomain::Internal
+{
+    // Pushes a chain of objects (linked through next) to a list that the collector takes with an exchange.
+    // It's ABA free, as objects are never popped one by one.
+    static void pushChain(Atomic<EpochRetired*>& list, EpochRetired& first, EpochRetired& last)
+    {
+        EpochRetired* head = list.load(memory_order_relaxed);
+        do
+        {
+            last.next = head;
+        } while (not list.compare_exchange_weak(head, &first, memory_order_release, memory_order_relaxed));
+    }
+
+    // Moves all objects of list in front of the pending list of the collector
+    static void takeAll(EpochDomain& domain, Atomic<EpochRetired*>& list)
+    {
+        EpochRetired* head = list.exchange(nullptr, memory_order_acquire);
+        if (head != nullptr)
+        {
+            EpochRetired* last = head;
+            while (last->next != nullptr)
+            {
+                last = last->next;
+            }
+            last->next     = domain.pending;
+            domain.pending = head;
+        }
+    }
+
+    // Reclaims pending objects retired at least two epochs before the given one (or all of them)
+    static void reclaimPending(EpochDomain& domain, uint64_t epoch, bool all)
+    {
+        EpochRetired** link = &domain.pending;
+        size_t numReclaimed = 0;
+        while (*link != nullptr)
+        {
+            EpochRetired* object = *link;
+            if (all or object->epoch + 2 <= epoch)
+            {
+                *link        = object->next; // Unlinked before reclaim, that can free the object
+                object->next = nullptr;
+                object->reclaim(*object);
+                numReclaimed++;
+            }
+            else
+            {
+                link = &object->next;
+            }
+        }
+        domain.numRetired.fetch_sub(numReclaimed, memory_order_relaxed);
+    }
+};
+
+SC::Result SC::EpochDomain::setThreadPool(ThreadPool& pool, size_t threshold)
+{
+    mutex.lock();
+    const bool hasThreads = threads != nullptr;
+    mutex.unlock();
+    SC_TRY_MSG(not hasThreads, "EpochDomain::setThreadPool - Threads have already been registered");
+    SC_TRY_MSG(threshold > 0, "EpochDomain::setThreadPool - Threshold must be greater than zero");
+    threadPool       = &pool;
+    collectThreshold = threshold;
+    return Result(true);
+}
+
+SC::Result SC::EpochDomain::registerThread(EpochThread& thread)
+{
+    SC_TRY_MSG(thread.domain == nullptr, "EpochDomain::registerThread - Thread is already registered");
+    mutex.lock();
+    thread.domain  = this;
+    thread.nesting = 0;
+    thread.state.store(0, memory_order_relaxed);
+    thread.prev = nullptr;
+    thread.next = threads;
+    if (threads != nullptr)
+    {
+        threads->prev = &thread;
+    }
+    threads = &thread;
+    mutex.unlock();
+    return Result(true);
+}
+
+SC::Result SC::EpochDomain::unregisterThread(EpochThread& thread)
+{
+    SC_TRY_MSG(thread.domain == this, "EpochDomain::unregisterThread - Thread is not registered with this domain");
+    SC_TRY_MSG(thread.nesting == 0, "EpochDomain::unregisterThread - Thread is inside a read section");
+    mutex.lock();
+    if (thread.prev != nullptr)
+    {
+        thread.prev->next = thread.next;
+    }
+    else
+    {
+        threads = thread.next;
+    }
+    if (thread.next != nullptr)
+    {
+        thread.next->prev = thread.prev;
+    }
+    // The collector takes retired lists only with mutex locked, so this one can't be taken anymore after unlocking
+    EpochRetired* first = thread.retired.exchange(nullptr, memory_order_acquire);
+    mutex.unlock();
+    if (first != nullptr)
+    {
+        EpochRetired* last = first;
+        while (last->next != nullptr)
+        {
+            last = last->next;
+        }
+        Internal::pushChain(orphans, *first, *last);
+    }
+    thread.domain = nullptr;
+    thread.next   = nullptr;
+    thread.prev   = nullptr;
+    return Result(true);
+}
+
+void SC::EpochDomain::retire(EpochThread& thread, EpochRetired& object)
+{
+    SC_ASSERT_DEBUG(thread.domain == this and object.reclaim != nullptr);
+    // Reading the epoch after the object has been unlinked from shared data (by the caller) is what makes it safe
+    object.epoch = globalEpoch.load();
+    Internal::pushChain(thread.retired, object, object);
+    const size_t retired = numRetired.fetch_add(1, memory_order_relaxed) + 1;
+    if (threadPool != nullptr and retired >= collectThreshold and not collectQueued.exchange(true))
+    {
+        if (not threadPool->queueTask(collectTask))
+        {
+            // Task is still finishing its previous run (or pool is being destroyed), a later retire will try again
+            collectQueued.store(false);
+        }
+    }
+}
+
+void SC::EpochDomain::runCollectTask()
+{
+    collectQueued.store(false);
+    (void)collect();
+}
+
+bool SC::EpochDomain::collect()
+{
+    if (collecting.exchange(true, memory_order_acquire))
+    {
+        return false;
+    }
+    // Pairs with the fence in EpochDomain::enter: either a reader state is visible here or the reader will see all
+    // shared data modifications (including unlinking of objects retired so far) done before this point.
+    atomic_thread_fence(memory_order_seq_cst);
+    uint64_t epoch = globalEpoch.load(memory_order_relaxed);
+
+    bool canAdvance = true;
+    mutex.lock();
+    for (EpochThread* thread = threads; thread != nullptr; thread = thread->next)
+    {
+        const uint64_t state = thread->state.load(memory_order_acquire);
+        if ((state & 1) != 0 and (state >> 1) != epoch)
+        {
+            canAdvance = false; // Thread is reading since a previous epoch
+        }
+        Internal::takeAll(*this, thread->retired);
+    }
+    mutex.unlock();
+    Internal::takeAll(*this, orphans);
+
+    if (canAdvance)
+    {
+        epoch++;
+        globalEpoch.store(epoch);
+    }
+    Internal::reclaimPending(*this, epoch, false);
+    collecting.store(false, memory_order_release);
+    return true;
+}
+
+void SC::EpochDomain::synchronize()
+{
+    // Objects retired so far have an epoch not greater than current one, and they're reclaimed two epochs later
+    const uint64_t target = globalEpoch.load() + 2;
+    for (;;)
+    {
+        if (collect() and globalEpoch.load() >= target)
+        {
+            // Any object retired with an epoch lower than target has been taken and reclaimed by the last collect
+            return;
+        }
+        Thread::Sleep(0);
+    }
+}
+
+SC::Result SC::EpochDomain::destroy()
+{
+    mutex.lock();
+    const bool hasThreads = threads != nullptr;
+    mutex.unlock();
+    SC_TRY_MSG(not hasThreads, "EpochDomain::destroy - Some threads are still registered");
+    if (threadPool != nullptr and threadPool->getNumWorkerThreads() > 0)
+    {
+        SC_TRY(threadPool->waitForTask(collectTask));
+    }
+    while (collecting.exchange(true, memory_order_acquire))
+    {
+        Thread::Sleep(0); // Some thread is still inside collect
+    }
+    Internal::takeAll(*this, orphans);
+    Internal::reclaimPending(*this, 0, true);
+    collecting.store(false, memory_order_release);
+    return Result(true);
+}
@@ -0,0 +1,325 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "../Foundation/Memory.h"
+#include "ThreadPool.h"
+#include "Threading.h"
+
+namespace SC
+{
+struct EpochDomain;
+struct EpochThread;
+struct EpochRetired;
+struct EpochGuard;
+template <typename T>
+struct RcuPointer;
+} // namespace SC
+
+//! @addtogroup group_threading
+//! @{
+
+/// @brief An object removed from a shared data structure, waiting for SC::EpochDomain to reclaim it.
+///
+/// Embed it in (or inherit it from) the object to be retired with EpochDomain::retire, and set
+/// EpochRetired::reclaim to a function freeing the object, that will be called when no reader can access it anymore.
+struct SC::EpochRetired
+{
+    using ReclaimFunction = void (*)(EpochRetired& retired);
+
+    ReclaimFunction reclaim = nullptr; ///< Frees the object (called by the thread running EpochDomain::collect)
+
+  private:
+    friend struct EpochDomain;
+    EpochRetired* next  = nullptr;
+    uint64_t      epoch = 0; // Global epoch when the object has been retired
+};
+
+/// @brief Registration of a thread with an SC::EpochDomain (to be used only by the thread that owns it).
+///
+/// @warning It must stay registered (and at a stable address) while the thread enters read sections or retires
+/// objects, and it must be unregistered with EpochDomain::unregisterThread before being destroyed.
+struct SC::EpochThread
+{
+    EpochThread() = default;
+
+    EpochThread(const EpochThread&)            = delete;
+    EpochThread(EpochThread&&)                 = delete;
+    EpochThread& operator=(const EpochThread&) = delete;
+    EpochThread& operator=(EpochThread&&)      = delete;
+
+    /// @brief Returns `true` if the thread is registered with an SC::EpochDomain
+    [[nodiscard]] bool isRegistered() const { return domain != nullptr; }
+
+    /// @brief Returns `true` if the thread is inside a read section
+    [[nodiscard]] bool isReading() const { return nesting > 0; }
+
+  private:
+    friend struct EpochDomain;
+    static constexpr size_t CacheLineSize = 64;
+
+    EpochDomain* domain  = nullptr; // Domain where this thread is registered
+    EpochThread* next    = nullptr; // Registered threads list (protected by EpochDomain::mutex)
+    EpochThread* prev    = nullptr;
+    uint32_t     nesting = 0;       // Nested read sections (accessed only by the owner)
+
+    Atomic<uint64_t>      state   = 0;       // (epoch << 1) | 1 inside a read section, 0 outside of it
+    Atomic<EpochRetired*> retired = nullptr; // Objects retired by this thread, not yet taken by the collector
+
+    // Avoids false sharing with the state of other threads
+    char padding[CacheLineSize];
+};
+
+/// @brief Epoch based reclamation of memory shared by lock-free readers.
+///
+/// Readers access shared objects inside read sections (EpochDomain::enter / EpochDomain::leave or SC::EpochGuard)
+/// that don't take any lock, don't write to any shared cache line and cost just a store and a fence.
+/// Writers remove objects from shared data structures and pass them to EpochDomain::retire, instead of freeing them.
+///
+/// A global epoch is advanced by EpochDomain::collect only when all threads inside a read section have observed the
+/// current one. Objects retired during epoch `E` are reclaimed once the global epoch reaches `E + 2`, as no reader
+/// that could have obtained a reference to them can still be inside a read section.
+///
+/// Every thread registers an SC::EpochThread (owned by the caller, as the domain doesn't allocate any memory) and
+/// retired objects are linked in per-thread lists, until the collector takes them.
+/// EpochDomain::collect can be called periodically by any thread, or automatically by a task of an SC::ThreadPool
+/// (see EpochDomain::setThreadPool) when enough objects have been retired.
+///
+/// SC::RcuPointer is a versioned pointer built on top of it.
+///
+/// @warning A thread must not wait for reclamation (EpochDomain::synchronize) or block for long time inside a read
+/// section, as it would prevent the epoch from advancing and retired objects from being reclaimed.
+///
+/// Example:
+/// @snippet Libraries/Threading/Tests/EpochReclamationTest.cpp epochDomainSnippet
+struct SC::EpochDomain
+{
+    EpochDomain() { collectTask.function = [this]() { runCollectTask(); }; }
+    ~EpochDomain() { (void)destroy(); }
+
+    EpochDomain(const EpochDomain&)            = delete;
+    EpochDomain(EpochDomain&&)                 = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+    EpochDomain& operator=(EpochDomain&&)      = delete;
+
+    /// @brief Collects retired objects in a task of threadPool, when at least threshold of them are waiting
+    /// @note It must be called before registering any thread, and threadPool must outlive the domain
+    [[nodiscard]] Result setThreadPool(ThreadPool& threadPool, size_t threshold = 64);
+
+    /// @brief Registers the calling thread, that can then enter read sections and retire objects
+    [[nodiscard]] Result registerThread(EpochThread& thread);
+
+    /// @brief Unregisters a thread (outside of read sections), handing over its retired objects to the domain
+    [[nodiscard]] Result unregisterThread(EpochThread& thread);
+
+    /// @brief Enters a read section (they can be nested), protecting all objects read until EpochDomain::leave
+    void enter(EpochThread& thread)
+    {
+        if (thread.nesting++ == 0)
+        {
+            const uint64_t epoch = globalEpoch.load(memory_order_relaxed);
+            thread.state.store((epoch << 1) | 1, memory_order_relaxed);
+            // Orders publishing the state before loads of shared pointers (pairs with the fence in collect)
+            atomic_thread_fence(memory_order_seq_cst);
+        }
+    }
+
+    /// @brief Leaves a read section, after which objects read inside it must not be accessed anymore
+    void leave(EpochThread& thread)
+    {
+        if (--thread.nesting == 0)
+        {
+            thread.state.store(0, memory_order_release);
+        }
+    }
+
+    /// @brief Schedules reclamation of an object already removed from shared data structures.
+    /// Readers that have obtained a reference to it can keep using it until they leave their read section.
+    void retire(EpochThread& thread, EpochRetired& object);
+
+    /// @brief Tries to advance the global epoch and reclaims objects that can't be accessed anymore
+    /// @return `false` if another thread (or the SC::ThreadPool task) is already collecting
+    bool collect();
+
+    /// @brief Waits until all objects retired so far have been reclaimed
+    /// @warning It must not be called inside a read section
+    void synchronize();
+
+    /// @brief Reclaims all objects (there must be no registered thread) and waits for the collector task to finish
+    [[nodiscard]] Result destroy();
+
+    /// @brief Returns current global epoch
+    [[nodiscard]] uint64_t getEpoch() const { return globalEpoch.load(memory_order_relaxed); }
+
+    /// @brief Returns the number of objects retired but not reclaimed yet
+    [[nodiscard]] size_t getNumRetired() const { return numRetired.load(memory_order_relaxed); }
+
+  private:
+    struct Internal;
+    void runCollectTask();
+
+    Atomic<uint64_t> globalEpoch = 1;
+    Atomic<size_t>   numRetired  = 0;
+    Atomic<bool>     collecting  = false; // A thread is running collect
+
+    Mutex        mutex;             // Protects registered threads list
+    EpochThread* threads = nullptr; // Registered threads
+
+    Atomic<EpochRetired*> orphans = nullptr; // Objects retired by threads that have been unregistered
+    EpochRetired*         pending = nullptr; // Objects taken by the collector (accessed only inside collect)
+
+    ThreadPool*      threadPool       = nullptr;
+    size_t           collectThreshold = 0;
+    ThreadPool::Task collectTask;
+    Atomic<bool>     collectQueued = false;
+};
+
+/// @brief Enters a read section of an SC::EpochDomain in constructor and leaves it in destructor
+struct SC::EpochGuard
+{
+    EpochGuard(EpochDomain& domain, EpochThread& thread) : domain(domain), thread(thread) { domain.enter(thread); }
+    ~EpochGuard() { domain.leave(thread); }
+
+    EpochGuard(const EpochGuard&)            = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+
+  private:
+    EpochDomain& domain;
+    EpochThread& thread;
+};
+
+/// @brief A versioned pointer to an immutable value, read without locks and replaced by copy-on-write (RCU).
+///
+/// Readers obtain the current value with RcuPointer::load inside a read section of the SC::EpochDomain, and they can
+/// use it until they leave the section, even if a writer has replaced it in the meantime.
+/// Writers (serialized by a mutex) publish a new version with RcuPointer::store or RcuPointer::update, retiring the
+/// previous one, that will be freed by the domain collector once no reader can access it anymore.
+/// Every published value gets a version number (starting from 1), that readers can use to detect changes.
+///
+/// It's useful for read-mostly shared data, like configurations or routing tables, where readers should never block.
+///
+/// @note Versions are allocated with SC::Memory. T must be copy constructible to be used with RcuPointer::update.
+///
+/// Example:
+/// @snippet Libraries/Threading/Tests/EpochReclamationTest.cpp rcuPointerSnippet
+template <typename T>
+struct SC::RcuPointer
+{
+    explicit RcuPointer(EpochDomain& domain) : domain(domain) {}
+
+    /// @brief Frees current value (there must be no reader, as it's not retired)
+    ~RcuPointer() { reset(); }
+
+    RcuPointer(const RcuPointer&)            = delete;
+    RcuPointer& operator=(const RcuPointer&) = delete;
+
+    /// @brief Returns current value (or `nullptr`), that can be used until the calling thread leaves its read section
+    [[nodiscard]] const T* load() const
+    {
+        const Version* version = current.load(memory_order_acquire);
+        return version ? &version->value : nullptr;
+    }
+
+    /// @brief Returns current value (or `nullptr`) and its version number (0 if there is no value)
+    [[nodiscard]] const T* load(uint64_t& versionNumber) const
+    {
+        const Version* version = current.load(memory_order_acquire);
+        versionNumber          = version ? version->number : 0;
+        return version ? &version->value : nullptr;
+    }
+
+    /// @brief Returns version number of current value (0 if no value has been published yet)
+    [[nodiscard]] uint64_t getVersion() const
+    {
+        const Version* version = current.load(memory_order_acquire);
+        return version ? version->number : 0;
+    }
+
+    /// @brief Publishes a new value, retiring the current one
+    /// @param writer Registration of the calling thread with the SC::EpochDomain
+    /// @param value The value to publish
+    template <typename U>
+    [[nodiscard]] Result store(EpochThread& writer, U&& value)
+    {
+        Version* version = allocate(forward<U>(value));
+        SC_TRY_MSG(version != nullptr, "RcuPointer::store - Cannot allocate version");
+        writerMutex.lock();
+        publish(writer, *version);
+        writerMutex.unlock();
+        return Result(true);
+    }
+
+    /// @brief Publishes a modified copy of current value (or of a default constructed one), retiring the current one
+    /// @param writer Registration of the calling thread with the SC::EpochDomain
+    /// @param modify Function receiving a `T&` to the copy to be modified
+    template <typename Modify>
+    [[nodiscard]] Result update(EpochThread& writer, Modify&& modify)
+    {
+        writerMutex.lock();
+        // Only writers retire versions and they're serialized, so the current one can be safely copied
+        const Version* previous = current.load(memory_order_relaxed);
+        Version*       version  = previous ? allocate(previous->value) : allocate();
+        if (version == nullptr)
+        {
+            writerMutex.unlock();
+            return Result::Error("RcuPointer::update - Cannot allocate version");
+        }
+        modify(version->value);
+        publish(writer, *version);
+        writerMutex.unlock();
+        return Result(true);
+    }
+
+    /// @brief Frees current value immediately (there must be no reader)
+    void reset()
+    {
+        Version* version = current.exchange(nullptr);
+        if (version != nullptr)
+        {
+            Version::release(*version);
+        }
+    }
+
+  private:
+    struct Version : public EpochRetired
+    {
+        template <typename... Args>
+        Version(Args&&... args) : value(forward<Args>(args)...)
+        {}
+
+        T        value;
+        uint64_t number = 0;
+
+        static void release(EpochRetired& retired)
+        {
+            Version& version = static_cast<Version&>(retired);
+            version.~Version();
+            Memory::release(&version);
+        }
+    };
+
+    template <typename... Args>
+    [[nodiscard]] static Version* allocate(Args&&... args)
+    {
+        void* memory = Memory::allocate(sizeof(Version));
+        return memory ? new (memory, PlacementNew()) Version(forward<Args>(args)...) : nullptr;
+    }
+
+    // Called with writerMutex locked
+    void publish(EpochThread& writer, Version& version)
+    {
+        version.number   = ++lastNumber;
+        version.reclaim  = &Version::release;
+        Version* retired = current.exchange(&version);
+        if (retired != nullptr)
+        {
+            domain.retire(writer, *retired);
+        }
+    }
+
+    EpochDomain&     domain;
+    Atomic<Version*> current    = nullptr;
+    Mutex            writerMutex;
+    uint64_t         lastNumber = 0;
+};
+
+//! @}
@@ -5,6 +5,166 @@
 #include <errno.h> // errno
 #include <pthread.h>
 #include <unistd.h> // usleep
+#if SC_PLATFORM_LINUX
+#include <linux/futex.h>  // FUTEX_WAIT_PRIVATE
+#include <sched.h>        // cpu_set_t
+#include <sys/resource.h> // setpriority
+#include <sys/syscall.h>  // SYS_futex, SYS_gettid
+
+namespace SC
+{
+struct FutexLinux
+{
+    static constexpr int AllThreads = 0x7fffffff;
+
+    static void wait(Atomic<uint32_t>& word, uint32_t expected)
+    {
+        // Returns immediately if word has already changed (EAGAIN), or on signals (EINTR)
+        ::syscall(SYS_futex, &word, FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+    }
+
+    static void wake(Atomic<uint32_t>& word, int numThreads)
+    {
+        ::syscall(SYS_futex, &word, FUTEX_WAKE_PRIVATE, numThreads, nullptr, nullptr, 0);
+    }
+
+    static void pause()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        asm volatile("yield");
+#endif
+    }
+};
+
+// Mutex futex word states and adaptive spinning estimate
+struct MutexLinux
+{
+    static constexpr uint32_t Unlocked  = 0;
+    static constexpr uint32_t Locked    = 1; // Locked, no thread sleeping on it
+    static constexpr uint32_t Contended = 2; // Locked, some thread could be sleeping on it
+
+    // Spinning adapts to how long it took to acquire this mutex recently (similar to PTHREAD_MUTEX_ADAPTIVE_NP), so
+    // that mutexes held for short sections spin enough to avoid sleeping and long held ones give up spinning early
+    static constexpr uint32_t MaxSpinCount = 100;
+
+    Atomic<uint32_t> state;
+    Atomic<uint32_t> spinEstimate; // Moving average of spins needed to acquire the lock (updated only by owners)
+};
+
+// Sequence is incremented on every signal, so that a waiter doesn't sleep if it has missed one
+struct ConditionVariableLinux
+{
+    Atomic<uint32_t> sequence;
+    Atomic<uint32_t> numWaiters;
+};
+} // namespace SC
+
+SC::Mutex::Mutex()
+{
+    MutexLinux& m = mutex.reinterpret_as<MutexLinux>();
+    m.state.store(MutexLinux::Unlocked, memory_order_relaxed);
+    m.spinEstimate.store(0, memory_order_relaxed);
+}
+SC::Mutex::~Mutex() {} // Nothing to do
+
+void SC::Mutex::lock()
+{
+    MutexLinux& m        = mutex.reinterpret_as<MutexLinux>();
+    uint32_t    expected = MutexLinux::Unlocked;
+    if (m.state.compare_exchange_strong(expected, MutexLinux::Locked, memory_order_acquire))
+    {
+        return; // Fast path
+    }
+    // Spins a bit more than recently needed, so that the estimate can grow again if the owners get slower
+    const uint32_t estimate = m.spinEstimate.load(memory_order_relaxed);
+    const uint32_t wanted   = estimate * 2 + 10;
+    const uint32_t maxSpins = wanted < MutexLinux::MaxSpinCount ? wanted : MutexLinux::MaxSpinCount;
+
+    // Spinning makes sense only if no other thread is already sleeping, waiting for the owner to unlock
+    bool     acquired = false;
+    uint32_t spin     = 0;
+    for (; spin < maxSpins and expected != MutexLinux::Contended; ++spin)
+    {
+        if (expected == MutexLinux::Unlocked)
+        {
+            if (m.state.compare_exchange_weak(expected, MutexLinux::Locked, memory_order_acquire))
+            {
+                acquired = true;
+                break;
+            }
+            continue;
+        }
+        FutexLinux::pause();
+        expected = m.state.load(memory_order_relaxed);
+    }
+    if (not acquired)
+    {
+        // Marks the mutex as contended, so that the owner will wake up one sleeping thread when unlocking
+        while (m.state.exchange(MutexLinux::Contended, memory_order_acquire) != MutexLinux::Unlocked)
+        {
+            FutexLinux::wait(m.state, MutexLinux::Contended);
+        }
+    }
+    // Only the owner updates the estimate, moving it by 1/8 of the difference with the spins needed this time
+    const int32_t delta = (static_cast<int32_t>(spin) - static_cast<int32_t>(estimate)) / 8;
+    m.spinEstimate.store(static_cast<uint32_t>(static_cast<int32_t>(estimate) + delta), memory_order_relaxed);
+}
+
+void SC::Mutex::unlock()
+{
+    MutexLinux& m = mutex.reinterpret_as<MutexLinux>();
+    if (m.state.exchange(MutexLinux::Unlocked, memory_order_release) == MutexLinux::Contended)
+    {
+        FutexLinux::wake(m.state, 1);
+    }
+}
+
+SC::ConditionVariable::ConditionVariable()
+{
+    ConditionVariableLinux& cv = condition.reinterpret_as<ConditionVariableLinux>();
+    cv.sequence.store(0, memory_order_relaxed);
+    cv.numWaiters.store(0, memory_order_relaxed);
+}
+SC::ConditionVariable::~ConditionVariable() {} // Nothing to do
+
+void SC::ConditionVariable::wait(Mutex& mutex)
+{
+    ConditionVariableLinux& cv = condition.reinterpret_as<ConditionVariableLinux>();
+    // Announces the waiter before reading sequence, so that a signal() either sees it or changes sequence
+    cv.numWaiters.fetch_add(1);
+    const uint32_t sequence = cv.sequence.load();
+    mutex.unlock();
+    FutexLinux::wait(cv.sequence, sequence);
+    cv.numWaiters.fetch_sub(1, memory_order_relaxed);
+    mutex.lock();
+}
+
+void SC::ConditionVariable::signal()
+{
+    ConditionVariableLinux& cv = condition.reinterpret_as<ConditionVariableLinux>();
+    cv.sequence.fetch_add(1);
+    if (cv.numWaiters.load() != 0)
+    {
+        FutexLinux::wake(cv.sequence, 1);
+    }
+}
+
+void SC::ConditionVariable::broadcast()
+{
+    ConditionVariableLinux& cv = condition.reinterpret_as<ConditionVariableLinux>();
+    cv.sequence.fetch_add(1);
+    if (cv.numWaiters.load() != 0)
+    {
+        FutexLinux::wake(cv.sequence, FutexLinux::AllThreads);
+    }
+}
+
+void SC::Futex::wait(uint32_t expected) { FutexLinux::wait(value, expected); }
+void SC::Futex::wakeOne() { FutexLinux::wake(value, 1); }
+void SC::Futex::wakeAll() { FutexLinux::wake(value, FutexLinux::AllThreads); }
+#else
 SC::Mutex::Mutex() { pthread_mutex_init(&mutex.reinterpret_as<pthread_mutex_t>(), 0); }
 SC::Mutex::~Mutex() { pthread_mutex_destroy(&mutex.reinterpret_as<pthread_mutex_t>()); }
 void SC::Mutex::lock() { pthread_mutex_lock(&mutex.reinterpret_as<pthread_mutex_t>()); }
@@ -18,6 +178,7 @@ void SC::ConditionVariable::wait(Mutex& mutex)
 }
 void SC::ConditionVariable::signal() { pthread_cond_signal(&condition.reinterpret_as<pthread_cond_t>()); }
 void SC::ConditionVariable::broadcast() { pthread_cond_broadcast(&condition.reinterpret_as<pthread_cond_t>()); }
+#endif
 
 struct SC::Thread::Internal
 {
@@ -70,8 +231,98 @@ struct SC::Thread::Internal
         }
         return Result(true);
     }
+
+    static NativeHandle currentThread() { return pthread_self(); }
+
+    [[nodiscard]] static Result setAffinity(NativeHandle threadNative, const CpuSet& cpus)
+    {
+#if SC_PLATFORM_LINUX
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        for (uint32_t cpu = 0; cpu < CpuSet::MaxCpus and cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (cpus.contains(cpu))
+            {
+                CPU_SET(cpu, &cpuSet);
+            }
+        }
+        if (pthread_setaffinity_np(threadNative, sizeof(cpuSet), &cpuSet) != 0)
+        {
+            return Result::Error("Thread::setAffinity - pthread_setaffinity_np failed");
+        }
+        return Result(true);
+#else
+        (void)threadNative;
+        (void)cpus;
+        return Result::Error("Thread::setAffinity - Not supported on this platform");
+#endif
+    }
 };
 
+SC::Result SC::Thread::GetCurrentThreadAffinity(CpuSet& cpus)
+{
+    cpus.clear();
+#if SC_PLATFORM_LINUX
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) != 0)
+    {
+        return Result::Error("Thread::GetCurrentThreadAffinity - pthread_getaffinity_np failed");
+    }
+    for (uint32_t cpu = 0; cpu < CpuSet::MaxCpus and cpu < CPU_SETSIZE; ++cpu)
+    {
+        if (CPU_ISSET(cpu, &cpuSet))
+        {
+            (void)cpus.add(cpu);
+        }
+    }
+    return Result(true);
+#else
+    return Result::Error("Thread::GetCurrentThreadAffinity - Not supported on this platform");
+#endif
+}
+
+SC::Result SC::Thread::SetCurrentThreadPriority(Priority priority)
+{
+#if SC_PLATFORM_LINUX
+    // Priority of SCHED_OTHER threads is their nice value, that Linux tracks per thread (and not per process)
+    int niceValue = 0;
+    switch (priority)
+    {
+    case Priority::Lowest: niceValue = 19; break;
+    case Priority::Low: niceValue = 10; break;
+    case Priority::Normal: niceValue = 0; break;
+    case Priority::High: niceValue = -10; break;
+    case Priority::Highest: niceValue = -20; break;
+    }
+    const id_t threadID = static_cast<id_t>(::syscall(SYS_gettid));
+    if (::setpriority(PRIO_PROCESS, threadID, niceValue) != 0)
+    {
+        return Result::Error("Thread::SetCurrentThreadPriority - setpriority failed (missing privileges?)");
+    }
+    return Result(true);
+#elif SC_PLATFORM_EMSCRIPTEN
+    (void)priority;
+    return Result::Error("Thread::SetCurrentThreadPriority - Not supported on this platform");
+#else
+    int         policy;
+    sched_param param;
+    if (pthread_getschedparam(pthread_self(), &policy, &param) != 0)
+    {
+        return Result::Error("Thread::SetCurrentThreadPriority - pthread_getschedparam failed");
+    }
+    // Spreads the five priorities over the range allowed by the current scheduling policy
+    const int minimum    = sched_get_priority_min(policy);
+    const int maximum    = sched_get_priority_max(policy);
+    param.sched_priority = minimum + (maximum - minimum) * static_cast<int>(priority) / 4;
+    if (pthread_setschedparam(pthread_self(), policy, &param) != 0)
+    {
+        return Result::Error("Thread::SetCurrentThreadPriority - pthread_setschedparam failed");
+    }
+    return Result(true);
+#endif
+}
+
 void SC::Thread::Sleep(uint32_t milliseconds)
 {
     int rc;
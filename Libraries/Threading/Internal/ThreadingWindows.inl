@@ -65,8 +65,71 @@ struct SC::Thread::Internal
         CloseHandle(threadNative.reinterpret_as<HANDLE>());
         return Result(true);
     }
+
+    static NativeHandle currentThread() { return ::GetCurrentThread(); }
+
+    // Only processors of the processor group of the thread (0 to 63) can be represented in an affinity mask
+    [[nodiscard]] static Result setAffinity(NativeHandle threadNative, const CpuSet& cpus)
+    {
+        DWORD_PTR mask = 0;
+        for (uint32_t cpu = 0; cpu < sizeof(DWORD_PTR) * 8; ++cpu)
+        {
+            if (cpus.contains(cpu))
+            {
+                mask |= DWORD_PTR(1) << cpu;
+            }
+        }
+        if (mask == 0 or ::SetThreadAffinityMask(threadNative, mask) == 0)
+        {
+            return Result::Error("Thread::setAffinity - SetThreadAffinityMask failed");
+        }
+        return Result(true);
+    }
 };
 
+SC::Result SC::Thread::GetCurrentThreadAffinity(CpuSet& cpus)
+{
+    cpus.clear();
+    DWORD_PTR processMask, systemMask;
+    if (::GetProcessAffinityMask(::GetCurrentProcess(), &processMask, &systemMask) == 0)
+    {
+        return Result::Error("Thread::GetCurrentThreadAffinity - GetProcessAffinityMask failed");
+    }
+    // There is no GetThreadAffinityMask, but SetThreadAffinityMask returns the previous mask (that is restored)
+    const DWORD_PTR threadMask = ::SetThreadAffinityMask(::GetCurrentThread(), processMask);
+    if (threadMask == 0)
+    {
+        return Result::Error("Thread::GetCurrentThreadAffinity - SetThreadAffinityMask failed");
+    }
+    ::SetThreadAffinityMask(::GetCurrentThread(), threadMask);
+    for (uint32_t cpu = 0; cpu < sizeof(DWORD_PTR) * 8; ++cpu)
+    {
+        if (threadMask & (DWORD_PTR(1) << cpu))
+        {
+            (void)cpus.add(cpu);
+        }
+    }
+    return Result(true);
+}
+
+SC::Result SC::Thread::SetCurrentThreadPriority(Priority priority)
+{
+    int value = THREAD_PRIORITY_NORMAL;
+    switch (priority)
+    {
+    case Priority::Lowest: value = THREAD_PRIORITY_LOWEST; break;
+    case Priority::Low: value = THREAD_PRIORITY_BELOW_NORMAL; break;
+    case Priority::Normal: value = THREAD_PRIORITY_NORMAL; break;
+    case Priority::High: value = THREAD_PRIORITY_ABOVE_NORMAL; break;
+    case Priority::Highest: value = THREAD_PRIORITY_HIGHEST; break;
+    }
+    if (::SetThreadPriority(::GetCurrentThread(), value) == 0)
+    {
+        return Result::Error("Thread::SetCurrentThreadPriority - SetThreadPriority failed");
+    }
+    return Result(true);
+}
+
 void SC::Thread::Sleep(uint32_t milliseconds) { ::Sleep(milliseconds); }
 
 SC::uint64_t SC::Thread::CurrentThreadID() { return ::GetCurrentThreadId(); }
@@ -0,0 +1,656 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "JobSystem.h"
+#include "../Foundation/Memory.h"
+
+// How fibers switch their execution context
+#if SC_PLATFORM_WINDOWS
+#define SC_JOB_SYSTEM_FIBERS_WINDOWS  1 // Windows Fibers API
+#define SC_JOB_SYSTEM_FIBERS_ASSEMBLY 0
+#define SC_JOB_SYSTEM_FIBERS_UCONTEXT 0
+#elif SC_PLATFORM_EMSCRIPTEN
+#define SC_JOB_SYSTEM_FIBERS_WINDOWS  0 // Not supported
+#define SC_JOB_SYSTEM_FIBERS_ASSEMBLY 0
+#define SC_JOB_SYSTEM_FIBERS_UCONTEXT 0
+#elif defined(__x86_64__) || defined(__aarch64__)
+#define SC_JOB_SYSTEM_FIBERS_WINDOWS  0
+#define SC_JOB_SYSTEM_FIBERS_ASSEMBLY 1 // Saving and restoring callee saved registers
+#define SC_JOB_SYSTEM_FIBERS_UCONTEXT 0
+#else
+#define SC_JOB_SYSTEM_FIBERS_WINDOWS  0
+#define SC_JOB_SYSTEM_FIBERS_ASSEMBLY 0
+#define SC_JOB_SYSTEM_FIBERS_UCONTEXT 1 // Posix getcontext / makecontext / swapcontext
+#endif
+
+#if SC_PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <sys/mman.h> // mmap
+#include <unistd.h>   // sysconf
+#if SC_JOB_SYSTEM_FIBERS_UCONTEXT
+#include <ucontext.h>
+#endif
+#endif
+
+#if SC_JOB_SYSTEM_FIBERS_ASSEMBLY
+// Saves callee saved registers on the current stack, stores the stack pointer in fromStackPointer and restores the
+// registers saved on toStackPointer (or the initial frame prepared by JobSystem::Internal::prepareFiber).
+extern "C" void sc_job_system_switch(void** fromStackPointer, void* toStackPointer);
+
+#if SC_PLATFORM_APPLE
+#define SC_JOB_SYSTEM_SYMBOL      "_sc_job_system_switch"
+#define SC_JOB_SYSTEM_SYMBOL_TYPE ""
+#define SC_JOB_SYSTEM_SYMBOL_SIZE ""
+#else
+#define SC_JOB_SYSTEM_SYMBOL      "sc_job_system_switch"
+#define SC_JOB_SYSTEM_SYMBOL_TYPE ".type sc_job_system_switch, %function\n"
+#define SC_JOB_SYSTEM_SYMBOL_SIZE ".size sc_job_system_switch, .-sc_job_system_switch\n"
+#endif
+
+#if defined(__x86_64__)
+asm(".text\n"
+    ".globl " SC_JOB_SYSTEM_SYMBOL "\n" SC_JOB_SYSTEM_SYMBOL_TYPE ".p2align 4\n" SC_JOB_SYSTEM_SYMBOL ":\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    movq  %rsp, (%rdi)\n"
+    "    movq  %rsi, %rsp\n"
+    "    popq  %r15\n"
+    "    popq  %r14\n"
+    "    popq  %r13\n"
+    "    popq  %r12\n"
+    "    popq  %rbx\n"
+    "    popq  %rbp\n"
+    "    ret\n" SC_JOB_SYSTEM_SYMBOL_SIZE);
+#else
+asm(".text\n"
+    ".globl " SC_JOB_SYSTEM_SYMBOL "\n" SC_JOB_SYSTEM_SYMBOL_TYPE ".p2align 2\n" SC_JOB_SYSTEM_SYMBOL ":\n"
+    "    sub  sp, sp, #160\n"
+    "    stp  x19, x20, [sp, #0]\n"
+    "    stp  x21, x22, [sp, #16]\n"
+    "    stp  x23, x24, [sp, #32]\n"
+    "    stp  x25, x26, [sp, #48]\n"
+    "    stp  x27, x28, [sp, #64]\n"
+    "    stp  x29, x30, [sp, #80]\n"
+    "    stp  d8,  d9,  [sp, #96]\n"
+    "    stp  d10, d11, [sp, #112]\n"
+    "    stp  d12, d13, [sp, #128]\n"
+    "    stp  d14, d15, [sp, #144]\n"
+    "    mov  x2, sp\n"
+    "    str  x2, [x0]\n"
+    "    mov  sp, x1\n"
+    "    ldp  x19, x20, [sp, #0]\n"
+    "    ldp  x21, x22, [sp, #16]\n"
+    "    ldp  x23, x24, [sp, #32]\n"
+    "    ldp  x25, x26, [sp, #48]\n"
+    "    ldp  x27, x28, [sp, #64]\n"
+    "    ldp  x29, x30, [sp, #80]\n"
+    "    ldp  d8,  d9,  [sp, #96]\n"
+    "    ldp  d10, d11, [sp, #112]\n"
+    "    ldp  d12, d13, [sp, #128]\n"
+    "    ldp  d14, d15, [sp, #144]\n"
+    "    add  sp, sp, #160\n"
+    "    ret\n" SC_JOB_SYSTEM_SYMBOL_SIZE);
+#endif
+#undef SC_JOB_SYSTEM_SYMBOL
+#undef SC_JOB_SYSTEM_SYMBOL_TYPE
+#undef SC_JOB_SYSTEM_SYMBOL_SIZE
+#endif
+
+struct SC::JobSystem::Fiber
+{
+    // Execution context of a fiber or of a worker thread
+    struct Context
+    {
+#if SC_JOB_SYSTEM_FIBERS_WINDOWS
+        void* fiber = nullptr;
+#elif SC_JOB_SYSTEM_FIBERS_ASSEMBLY
+        void* stackPointer = nullptr;
+#elif SC_JOB_SYSTEM_FIBERS_UCONTEXT
+        ucontext_t context;
+#endif
+    };
+
+    enum class State
+    {
+        Free,     // Not running any job (in freeFibers)
+        Running,  // Running a job on some worker
+        Waiting,  // Suspended in JobCounter::wait (in waitingFibers of a counter)
+        Finished, // Job is finished, waiting for the worker to switch back and release it
+    };
+    Context context;
+
+    JobSystem*  jobSystem      = nullptr;
+    Job*        job            = nullptr;
+    JobCounter* waitingCounter = nullptr; // Counter to unlock after switching back to the worker (State::Waiting)
+    Fiber*      next           = nullptr;
+    State       state          = State::Free;
+};
+
+struct SC::JobSystem::Worker
+{
+    Fiber::Context context;
+
+    JobSystem* jobSystem    = nullptr;
+    Fiber*     currentFiber = nullptr; // Fiber being executed by this worker
+    CpuSet     cpus;                   // Processors where the worker pins itself (if not empty)
+    Thread     thread;
+};
+
+struct SC::JobSystem::Internal
+{
+    static thread_local Worker* currentWorker;
+
+    // Not inlined to avoid caching the thread local address in a fiber, that can be resumed on a different thread
+#if SC_COMPILER_MSVC
+    __declspec(noinline)
+#else
+    __attribute__((noinline))
+#endif
+    static Worker* getCurrentWorker()
+    {
+        return currentWorker;
+    }
+
+    static uint32_t getNumberOfProcessors()
+    {
+#if SC_PLATFORM_WINDOWS
+        SYSTEM_INFO systemInfo;
+        ::GetSystemInfo(&systemInfo);
+        return static_cast<uint32_t>(systemInfo.dwNumberOfProcessors);
+#else
+        const long numProcessors = ::sysconf(_SC_NPROCESSORS_ONLN);
+        return numProcessors > 0 ? static_cast<uint32_t>(numProcessors) : 1;
+#endif
+    }
+
+    static size_t getPageSize()
+    {
+#if SC_PLATFORM_WINDOWS
+        SYSTEM_INFO systemInfo;
+        ::GetSystemInfo(&systemInfo);
+        return systemInfo.dwPageSize;
+#else
+        return static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+    }
+
+    //---------------------------------------------------------------------------------------------------
+    // Context switching
+    //---------------------------------------------------------------------------------------------------
+    static void switchContext(Fiber::Context& from, Fiber::Context& to)
+    {
+#if SC_JOB_SYSTEM_FIBERS_WINDOWS
+        SC_COMPILER_UNUSED(from);
+        ::SwitchToFiber(to.fiber);
+#elif SC_JOB_SYSTEM_FIBERS_ASSEMBLY
+        sc_job_system_switch(&from.stackPointer, to.stackPointer);
+#elif SC_JOB_SYSTEM_FIBERS_UCONTEXT
+        ::swapcontext(&from.context, &to.context);
+#else
+        SC_COMPILER_UNUSED(from);
+        SC_COMPILER_UNUSED(to);
+#endif
+    }
+
+    // Entry point of all fibers, running one job after the other (it never returns)
+    static void fiberMain()
+    {
+        for (;;)
+        {
+            Fiber& fiber = *getCurrentWorker()->currentFiber;
+
+            Job&        job     = *fiber.job;
+            JobCounter* counter = job.counter;
+            job.function();
+            job.counter = nullptr;
+            counter->decrement(); // Job can be reused or released by its owner after this line
+
+            fiber.state = Fiber::State::Finished;
+            switchContext(fiber.context, getCurrentWorker()->context);
+        }
+    }
+
+#if SC_JOB_SYSTEM_FIBERS_WINDOWS
+    static void WINAPI fiberProc(void*) { fiberMain(); }
+#endif
+
+    [[nodiscard]] static Result prepareFiber(Fiber& fiber, char* stackBottom, size_t stackSize)
+    {
+#if SC_JOB_SYSTEM_FIBERS_WINDOWS
+        SC_COMPILER_UNUSED(stackBottom);
+        fiber.context.fiber = ::CreateFiberEx(stackSize, stackSize, FIBER_FLAG_FLOAT_SWITCH, &fiberProc, nullptr);
+        SC_TRY_MSG(fiber.context.fiber != nullptr, "JobSystem::create - CreateFiberEx failed");
+#elif SC_JOB_SYSTEM_FIBERS_ASSEMBLY
+        // Initial frame restored by the first switch, "returning" into fiberMain at the top of the stack
+        void** stackPointer = reinterpret_cast<void**>(stackBottom + stackSize);
+#if defined(__x86_64__)
+        *--stackPointer = nullptr;                              // Return address of fiberMain (keeps ABI alignment)
+        *--stackPointer = reinterpret_cast<void*>(&fiberMain); // Return address of sc_job_system_switch
+        for (int idx = 0; idx < 6; ++idx)
+        {
+            *--stackPointer = nullptr; // rbp, rbx, r12, r13, r14, r15
+        }
+#else
+        stackPointer -= 20; // x19-x30 and d8-d15
+        for (int idx = 0; idx < 20; ++idx)
+        {
+            stackPointer[idx] = nullptr;
+        }
+        stackPointer[11] = reinterpret_cast<void*>(&fiberMain); // x30 (link register)
+#endif
+        fiber.context.stackPointer = stackPointer;
+#elif SC_JOB_SYSTEM_FIBERS_UCONTEXT
+        SC_TRY_MSG(::getcontext(&fiber.context.context) == 0, "JobSystem::create - getcontext failed");
+        fiber.context.context.uc_stack.ss_sp   = stackBottom;
+        fiber.context.context.uc_stack.ss_size = stackSize;
+        fiber.context.context.uc_link          = nullptr;
+        ::makecontext(&fiber.context.context, &fiberMain, 0);
+#else
+        SC_COMPILER_UNUSED(fiber);
+        SC_COMPILER_UNUSED(stackBottom);
+        SC_COMPILER_UNUSED(stackSize);
+        return Result::Error("JobSystem::create - Fibers are not supported on this platform");
+#endif
+        return Result(true);
+    }
+
+    //---------------------------------------------------------------------------------------------------
+    // Stacks
+    //---------------------------------------------------------------------------------------------------
+    [[nodiscard]] static Result allocateStacks(JobSystem& jobSystem, size_t guardSize, size_t stackSize)
+    {
+#if SC_JOB_SYSTEM_FIBERS_WINDOWS
+        // Windows fibers allocate their own stacks (with guard pages)
+        SC_COMPILER_UNUSED(jobSystem);
+        SC_COMPILER_UNUSED(guardSize);
+        SC_COMPILER_UNUSED(stackSize);
+#else
+        // A single mapping holds all stacks, each one preceded by a guard page catching its overflow
+        const size_t size = (guardSize + stackSize) * jobSystem.numFibers;
+        void* memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        SC_TRY_MSG(memory != MAP_FAILED, "JobSystem::create - Cannot allocate fiber stacks");
+        jobSystem.stacksMemory     = memory;
+        jobSystem.stacksMemorySize = size;
+        for (uint32_t idx = 0; idx < jobSystem.numFibers; ++idx)
+        {
+            char* guard = static_cast<char*>(memory) + idx * (guardSize + stackSize);
+            SC_TRY_MSG(::mprotect(guard, guardSize, PROT_NONE) == 0, "JobSystem::create - Cannot protect stacks");
+        }
+#endif
+        return Result(true);
+    }
+
+    static void releaseFibers(JobSystem& jobSystem)
+    {
+#if SC_JOB_SYSTEM_FIBERS_WINDOWS
+        for (uint32_t idx = 0; idx < jobSystem.numFibers; ++idx)
+        {
+            if (jobSystem.fibers[idx].context.fiber != nullptr)
+            {
+                ::DeleteFiber(jobSystem.fibers[idx].context.fiber);
+            }
+        }
+#else
+        if (jobSystem.stacksMemory != nullptr)
+        {
+            ::munmap(jobSystem.stacksMemory, jobSystem.stacksMemorySize);
+        }
+#endif
+        jobSystem.stacksMemory     = nullptr;
+        jobSystem.stacksMemorySize = 0;
+        Memory::release(jobSystem.fibers);
+        jobSystem.fibers     = nullptr;
+        jobSystem.numFibers  = 0;
+        jobSystem.freeFibers = nullptr;
+    }
+
+    //---------------------------------------------------------------------------------------------------
+    // Scheduling
+    //---------------------------------------------------------------------------------------------------
+    // Must be called with jobSystem.mutex locked
+    static void pushReady(JobSystem& jobSystem, Fiber& fiber)
+    {
+        fiber.next = nullptr;
+        if (jobSystem.readyTail)
+        {
+            jobSystem.readyTail->next = &fiber;
+        }
+        else
+        {
+            jobSystem.readyHead = &fiber;
+        }
+        jobSystem.readyTail = &fiber;
+    }
+
+    // Resumes fibers suspended on a counter that has reached zero (called by JobCounter::decrement)
+    static void resumeFibers(Fiber* fiber)
+    {
+        while (fiber != nullptr)
+        {
+            Fiber*     next      = fiber->next;
+            JobSystem& jobSystem = *fiber->jobSystem;
+            jobSystem.mutex.lock();
+            pushReady(jobSystem, *fiber);
+            if (jobSystem.numSleepingWorkers > 0)
+            {
+                jobSystem.workAvailable.signal();
+            }
+            jobSystem.mutex.unlock();
+            fiber = next;
+        }
+    }
+
+    // Must be called with jobSystem.mutex locked. Returns the next fiber to switch to (if any).
+    static Fiber* findWork(JobSystem& jobSystem)
+    {
+        // Fibers that can be resumed have precedence, as they could be holding resources (like their stack)
+        Fiber* fiber = jobSystem.readyHead;
+        if (fiber != nullptr)
+        {
+            jobSystem.readyHead = fiber->next;
+            if (jobSystem.readyHead == nullptr)
+            {
+                jobSystem.readyTail = nullptr;
+            }
+            return fiber;
+        }
+        Job* job = jobSystem.jobsHead;
+        fiber    = jobSystem.freeFibers;
+        if (job == nullptr or fiber == nullptr)
+        {
+            return nullptr;
+        }
+        jobSystem.jobsHead = job->next;
+        if (jobSystem.jobsHead == nullptr)
+        {
+            jobSystem.jobsTail = nullptr;
+        }
+        job->next            = nullptr;
+        jobSystem.freeFibers = fiber->next;
+        jobSystem.numActiveFibers++;
+        fiber->job = job;
+        return fiber;
+    }
+
+    static void workerMain(Worker& worker)
+    {
+        JobSystem& jobSystem = *worker.jobSystem;
+        currentWorker        = &worker;
+        if (not worker.cpus.isEmpty())
+        {
+            (void)Thread::SetCurrentThreadAffinity(worker.cpus); // Best effort (it can fail in restricted cpusets)
+        }
+#if SC_JOB_SYSTEM_FIBERS_WINDOWS
+        worker.context.fiber = ::ConvertThreadToFiberEx(nullptr, FIBER_FLAG_FLOAT_SWITCH);
+#endif
+        jobSystem.mutex.lock();
+        for (;;)
+        {
+            Fiber* fiber = findWork(jobSystem);
+            if (fiber == nullptr)
+            {
+                if (jobSystem.stopRequested and jobSystem.jobsHead == nullptr and jobSystem.numActiveFibers == 0)
+                {
+                    break;
+                }
+                jobSystem.numSleepingWorkers++;
+                jobSystem.workAvailable.wait(jobSystem.mutex);
+                jobSystem.numSleepingWorkers--;
+                continue;
+            }
+            jobSystem.mutex.unlock();
+
+            fiber->state        = Fiber::State::Running;
+            worker.currentFiber = fiber;
+            switchContext(worker.context, fiber->context);
+            worker.currentFiber = nullptr;
+
+            if (fiber->state == Fiber::State::Waiting)
+            {
+                // The fiber has been fully suspended, so it can now be resumed by JobCounter::decrement
+                fiber->waitingCounter->mutex.unlock();
+                jobSystem.mutex.lock();
+            }
+            else
+            {
+                jobSystem.mutex.lock();
+                fiber->job   = nullptr;
+                fiber->state = Fiber::State::Free;
+                fiber->next  = jobSystem.freeFibers;
+
+                jobSystem.freeFibers = fiber;
+                jobSystem.numActiveFibers--;
+                if (jobSystem.stopRequested or jobSystem.jobsHead != nullptr)
+                {
+                    jobSystem.workAvailable.broadcast(); // Workers sleeping for lack of free fibers (or stopping)
+                }
+            }
+        }
+        jobSystem.mutex.unlock();
+#if SC_JOB_SYSTEM_FIBERS_WINDOWS
+        ::ConvertFiberToThread();
+#endif
+        currentWorker = nullptr;
+    }
+
+    // Suspends the fiber running on the calling worker, that must be a job waiting on counter (locked)
+    static void suspendCurrentFiber(Worker& worker, JobCounter& counter)
+    {
+        Fiber& fiber         = *worker.currentFiber;
+        fiber.state          = Fiber::State::Waiting;
+        fiber.waitingCounter = &counter;
+        fiber.next           = counter.waitingFibers;
+
+        counter.waitingFibers = &fiber;
+        switchContext(fiber.context, worker.context);
+        // Resumed by resumeFibers (possibly on a different worker thread)
+        fiber.waitingCounter = nullptr;
+    }
+};
+
+thread_local SC::JobSystem::Worker* SC::JobSystem::Internal::currentWorker = nullptr;
+
+SC::Result SC::JobSystem::create(const Options& options)
+{
+    SC_TRY_MSG(numWorkers == 0, "JobSystem::create - Already created");
+    SC_TRY_MSG(options.numFibers > 0, "JobSystem::create - Need at least one fiber");
+#if !SC_JOB_SYSTEM_FIBERS_WINDOWS && !SC_JOB_SYSTEM_FIBERS_ASSEMBLY && !SC_JOB_SYSTEM_FIBERS_UCONTEXT
+    return Result::Error("JobSystem::create - Fibers are not supported on this platform");
+#else
+    const uint32_t numProcessors = Internal::getNumberOfProcessors();
+    const size_t   pageSize      = Internal::getPageSize();
+    const size_t   stackSize     = (options.fiberStackSize + pageSize - 1) / pageSize * pageSize;
+    SC_TRY_MSG(stackSize > 0, "JobSystem::create - Invalid stack size");
+
+    const uint32_t wantedWorkers = options.numWorkers > 0 ? options.numWorkers : numProcessors;
+
+    fibers = static_cast<Fiber*>(Memory::allocate(sizeof(Fiber) * options.numFibers));
+    SC_TRY_MSG(fibers != nullptr, "JobSystem::create - Cannot allocate fibers");
+    for (uint32_t idx = 0; idx < options.numFibers; ++idx)
+    {
+        Fiber* fiber     = new (&fibers[idx], PlacementNew()) Fiber();
+        fiber->jobSystem = this;
+    }
+    numFibers = options.numFibers;
+    if (not Internal::allocateStacks(*this, pageSize, stackSize))
+    {
+        Internal::releaseFibers(*this);
+        return Result::Error("JobSystem::create - Cannot allocate fiber stacks");
+    }
+    for (uint32_t idx = 0; idx < numFibers; ++idx)
+    {
+        char* stackBottom = static_cast<char*>(stacksMemory) + idx * (pageSize + stackSize) + pageSize;
+        if (not Internal::prepareFiber(fibers[idx], stacksMemory ? stackBottom : nullptr, stackSize))
+        {
+            Internal::releaseFibers(*this);
+            return Result::Error("JobSystem::create - Cannot create fibers");
+        }
+        fibers[idx].next = freeFibers;
+        freeFibers       = &fibers[idx];
+    }
+
+    workers = static_cast<Worker*>(Memory::allocate(sizeof(Worker) * wantedWorkers));
+    if (workers == nullptr)
+    {
+        Internal::releaseFibers(*this);
+        return Result::Error("JobSystem::create - Cannot allocate workers");
+    }
+    numWorkers = wantedWorkers;
+    for (uint32_t idx = 0; idx < numWorkers; ++idx)
+    {
+        Worker* worker    = new (&workers[idx], PlacementNew()) Worker();
+        worker->jobSystem = this;
+        if (options.pinWorkers)
+        {
+            (void)worker->cpus.add(idx % numProcessors);
+        }
+    }
+
+    // JobSystem::destroy joins all started threads
+    for (uint32_t idx = 0; idx < numWorkers; ++idx)
+    {
+        Worker* worker = &workers[idx];
+        if (not worker->thread.start([worker](Thread&) { Internal::workerMain(*worker); }))
+        {
+            (void)destroy();
+            return Result::Error("JobSystem::create - Cannot create worker thread");
+        }
+    }
+    return Result(true);
+#endif
+}
+
+SC::Result SC::JobSystem::destroy()
+{
+    mutex.lock();
+    if (numWorkers == 0)
+    {
+        mutex.unlock();
+        return Result(true); // Already destroyed
+    }
+    stopRequested = true;
+    workAvailable.broadcast();
+    mutex.unlock();
+
+    // Workers exit their loop once all queued jobs and suspended fibers have completed
+    for (uint32_t idx = 0; idx < numWorkers; ++idx)
+    {
+        if (workers[idx].thread.wasStarted())
+        {
+            (void)workers[idx].thread.join();
+        }
+        workers[idx].~Worker();
+    }
+    stopRequested = false;
+
+    Internal::releaseFibers(*this);
+    Memory::release(workers);
+    workers    = nullptr;
+    numWorkers = 0;
+    return Result(true);
+}
+
+SC::Result SC::JobSystem::run(Span<Job> jobs, JobCounter& counter)
+{
+    SC_TRY_MSG(numWorkers > 0, "JobSystem::run - Not created");
+    if (jobs.empty())
+    {
+        return Result(true);
+    }
+    for (const Job& job : jobs)
+    {
+        SC_TRY_MSG(job.counter == nullptr, "JobSystem::run - Job is already queued");
+    }
+    counter.increment(static_cast<uint32_t>(jobs.sizeInElements()));
+    for (Job& job : jobs)
+    {
+        job.counter = &counter;
+        job.next    = nullptr;
+    }
+    for (size_t idx = 0; idx + 1 < jobs.sizeInElements(); ++idx)
+    {
+        jobs[idx].next = &jobs[idx + 1];
+    }
+
+    mutex.lock();
+    if (jobsTail)
+    {
+        jobsTail->next = &jobs[0];
+    }
+    else
+    {
+        jobsHead = &jobs[0];
+    }
+    jobsTail = &jobs[jobs.sizeInElements() - 1];
+    if (numSleepingWorkers > 0)
+    {
+        if (jobs.sizeInElements() == 1)
+        {
+            workAvailable.signal();
+        }
+        else
+        {
+            workAvailable.broadcast();
+        }
+    }
+    mutex.unlock();
+    return Result(true);
+}
+
+//-------------------------------------------------------------------------------------------------------
+// JobCounter
+//-------------------------------------------------------------------------------------------------------
+
+void SC::JobCounter::increment(uint32_t count) { value.value.fetch_add(count); }
+
+void SC::JobCounter::decrement()
+{
+    // Reaching zero happens under the mutex, so that waiters (that always take it) can't return while still in use
+    mutex.lock();
+    JobSystem::Fiber* fibers = nullptr;
+    if (value.value.fetch_sub(1) == 1)
+    {
+        fibers        = waitingFibers;
+        waitingFibers = nullptr;
+        if (numThreadWaiters.load() != 0)
+        {
+            value.wakeAll();
+        }
+    }
+    mutex.unlock();
+    JobSystem::Internal::resumeFibers(fibers);
+}
+
+void SC::JobCounter::wait()
+{
+    JobSystem::Worker* worker = JobSystem::Internal::getCurrentWorker();
+    if (worker == nullptr or worker->currentFiber == nullptr)
+    {
+        // Not a job, so the thread blocks
+        numThreadWaiters.fetch_add(1);
+        for (uint32_t current = value.value.load(); current != 0; current = value.value.load())
+        {
+            value.wait(current);
+        }
+        numThreadWaiters.fetch_sub(1);
+        mutex.lock(); // Waits for JobCounter::decrement to stop using this counter
+        mutex.unlock();
+        return;
+    }
+    mutex.lock();
+    if (value.value.load() == 0)
+    {
+        mutex.unlock();
+        return;
+    }
+    JobSystem::Internal::suspendCurrentFiber(*worker, *this); // Worker unlocks the mutex after the switch
+}
+
+#undef SC_JOB_SYSTEM_FIBERS_WINDOWS
+#undef SC_JOB_SYSTEM_FIBERS_ASSEMBLY
+#undef SC_JOB_SYSTEM_FIBERS_UCONTEXT
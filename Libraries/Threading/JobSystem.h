@@ -0,0 +1,153 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "../Foundation/Span.h"
+#include "Threading.h"
+
+namespace SC
+{
+struct Job;
+struct JobCounter;
+struct JobSystem;
+} // namespace SC
+
+//! @addtogroup group_threading
+//! @{
+
+/// @brief A function to execute on a fiber of SC::JobSystem.
+///
+/// Fill Job::function with any function to execute. It can wait for other jobs (or asynchronous operations) with
+/// JobCounter::wait, suspending its fiber without blocking the worker thread.
+struct SC::Job
+{
+    Function<void()> function; ///< Function that will be executed by the job
+
+  private:
+    friend struct JobSystem;
+    JobCounter* counter = nullptr;
+    Job*        next    = nullptr;
+};
+
+/// @brief Executes jobs on stackful fibers, so that jobs waiting for other work don't block their worker thread.
+///
+/// One worker thread is created for each processor (optionally pinned to it) and a fixed number of fibers, with their
+/// own preallocated stacks (guarded by a non accessible page to catch overflows), is created in JobSystem::create.
+/// A worker picks a free fiber and runs a queued job on it, switching stacks in user mode (with a few instructions on
+/// x86_64 and ARM64, `ucontext` on other Posix architectures and the Fibers API on Windows).
+/// When a job waits on a SC::JobCounter that has not reached zero, its fiber is suspended and the worker continues
+/// with other jobs. The fiber will be resumed (on any worker) when the counter reaches zero.
+///
+/// SC::AsyncEventLoopJobs allows jobs to suspend their fiber until an SC::AsyncRequest completes.
+///
+/// @note The number of fibers limits how many jobs can be started (and suspended) at the same time. A job waiting on
+/// other jobs that can't start, because all fibers are suspended, will wait forever.
+///
+/// @warning The caller is responsible of keeping Job address stable until the counter passed to JobSystem::run
+/// reaches zero. Jobs must be able to complete, as JobSystem::destroy waits for all of them.
+///
+/// Example:
+/// @snippet Libraries/Threading/Tests/JobSystemTest.cpp jobSystemSnippet
+struct SC::JobSystem
+{
+    /// @brief Parameters for JobSystem::create
+    struct Options
+    {
+        uint32_t numWorkers     = 0;         ///< Number of worker threads (0 means one for each processor)
+        uint32_t numFibers      = 128;       ///< Number of fibers (jobs that can be started or suspended at once)
+        size_t   fiberStackSize = 64 * 1024; ///< Stack size of each fiber (rounded to page size)
+        bool     pinWorkers     = true;      ///< Pins each worker thread to a different processor (where supported)
+    };
+
+    JobSystem() = default;
+    ~JobSystem() { (void)destroy(); }
+
+    JobSystem(const JobSystem&)            = delete;
+    JobSystem(JobSystem&&)                 = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    JobSystem& operator=(JobSystem&&)      = delete;
+
+    /// @brief Creates worker threads and fibers with default JobSystem::Options
+    [[nodiscard]] Result create() { return create(Options()); }
+
+    /// @brief Creates worker threads, fibers and their stacks
+    [[nodiscard]] Result create(const Options& options);
+
+    /// @brief Waits for all jobs to complete and destroys worker threads and fibers
+    [[nodiscard]] Result destroy();
+
+    /// @brief Queues jobs, adding their number to counter (that is decremented as each one of them completes)
+    /// @param jobs Jobs to execute (that must not be already queued)
+    /// @param counter Counter that can be waited with JobCounter::wait for all jobs to complete
+    [[nodiscard]] Result run(Span<Job> jobs, JobCounter& counter);
+
+    /// @brief Returns the number of worker threads
+    [[nodiscard]] uint32_t getNumWorkers() const { return numWorkers; }
+
+  private:
+    friend struct JobCounter;
+    struct Fiber;
+    struct Worker;
+    struct Internal;
+
+    Worker*  workers    = nullptr;
+    uint32_t numWorkers = 0;
+
+    Fiber*   fibers           = nullptr;
+    uint32_t numFibers        = 0;
+    void*    stacksMemory     = nullptr; // All fiber stacks (with their guard pages)
+    size_t   stacksMemorySize = 0;
+
+    Mutex             mutex;         // Protects all fields below
+    ConditionVariable workAvailable; // Signals sleeping workers that a job has been queued or a fiber is ready
+
+    Job*   jobsHead   = nullptr; // FIFO of queued jobs
+    Job*   jobsTail   = nullptr;
+    Fiber* readyHead  = nullptr; // FIFO of fibers ready to be resumed
+    Fiber* readyTail  = nullptr;
+    Fiber* freeFibers = nullptr; // Fibers not running any job
+
+    uint32_t numActiveFibers    = 0; // Fibers running (or suspended in) a job
+    uint32_t numSleepingWorkers = 0;
+    bool     stopRequested      = false;
+};
+
+/// @brief Counts pending jobs (or other operations), letting jobs and threads wait until it reaches zero.
+///
+/// JobSystem::run increments the counter by the number of jobs, and every job decrements it on completion.
+/// It can be also incremented manually, for example before starting an asynchronous operation that will call
+/// JobCounter::decrement from its completion callback.
+///
+/// @warning A counter must not be destroyed before JobCounter::wait returns
+struct SC::JobCounter
+{
+    JobCounter() = default;
+
+    JobCounter(const JobCounter&)            = delete;
+    JobCounter(JobCounter&&)                 = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+    JobCounter& operator=(JobCounter&&)      = delete;
+
+    /// @brief Adds count to the counter
+    void increment(uint32_t count = 1);
+
+    /// @brief Subtracts one from the counter, resuming jobs and threads waiting for it if it reaches zero
+    void decrement();
+
+    /// @brief Waits for the counter to reach zero.
+    /// When called from a job, it suspends its fiber (so that the worker thread can run other jobs).
+    /// When called from any other thread, it blocks the thread.
+    void wait();
+
+    /// @brief Returns the current value of the counter
+    [[nodiscard]] uint32_t getValue() const { return value.value.load(); }
+
+  private:
+    friend struct JobSystem;
+    Futex            value;
+    Atomic<uint32_t> numThreadWaiters = 0;
+
+    Mutex             mutex;                   // Protects waitingFibers and serializes reaching zero with waiters
+    JobSystem::Fiber* waitingFibers = nullptr; // Fibers suspended on this counter
+};
+
+//! @}
@@ -0,0 +1,243 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "../Foundation/Result.h"
+#include "../Foundation/Span.h"
+#include "Atomic.h"
+
+namespace SC
+{
+template <typename T>
+struct SPSCQueue;
+template <typename T>
+struct MPMCQueue;
+} // namespace SC
+
+//! @addtogroup group_threading
+//! @{
+
+/// @brief Bounded lock-free queue for a single producer thread and a single consumer thread.
+///
+/// Elements are stored in a caller provided ring buffer (whose size must be a power of two), so that the queue never
+/// allocates memory. Producer and consumer indices live on separate cache lines, and each side keeps a cached copy of
+/// the index of the other side, so that they touch each other cache line only when the queue looks full (or empty).
+///
+/// Example:
+/// @snippet Libraries/Threading/Tests/LockFreeQueueTest.cpp spscQueueSnippet
+template <typename T>
+struct SC::SPSCQueue
+{
+    SPSCQueue() = default;
+    SPSCQueue(const SPSCQueue&)            = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    /// @brief Uses storage as ring buffer (it must not be called while producer or consumer are using the queue)
+    /// @param storage Caller owned elements, whose number must be a power of two
+    [[nodiscard]] Result init(Span<T> storage)
+    {
+        const size_t size = storage.sizeInElements();
+        SC_TRY_MSG(size > 0 and (size & (size - 1)) == 0, "SPSCQueue::init - Size must be a power of two");
+        items = storage.data();
+        mask  = size - 1;
+        tail.store(0);
+        head.store(0);
+        cachedHead = 0;
+        cachedTail = 0;
+        return Result(true);
+    }
+
+    /// @brief Maximum number of elements that can be queued
+    [[nodiscard]] size_t capacity() const { return items ? mask + 1 : 0; }
+
+    /// @brief Moves value at the end of the queue (producer thread only)
+    /// @return `false` if the queue is full
+    [[nodiscard]] bool tryPush(T&& value) { return push(move(value)); }
+
+    /// @brief Copies value at the end of the queue (producer thread only)
+    /// @return `false` if the queue is full
+    [[nodiscard]] bool tryPush(const T& value) { return push(value); }
+
+    /// @brief Moves the element at the front of the queue into value (consumer thread only)
+    /// @return `false` if the queue is empty
+    [[nodiscard]] bool tryPop(T& value)
+    {
+        const size_t position = head.load(memory_order_relaxed);
+        if (position == cachedTail)
+        {
+            cachedTail = tail.load(memory_order_acquire);
+            if (position == cachedTail)
+            {
+                return false;
+            }
+        }
+        value = move(items[position & mask]);
+        head.store(position + 1, memory_order_release);
+        return true;
+    }
+
+  private:
+    static constexpr size_t CacheLineSize = 64;
+
+    template <typename U>
+    bool push(U&& value)
+    {
+        const size_t position = tail.load(memory_order_relaxed);
+        if (position - cachedHead > mask)
+        {
+            cachedHead = head.load(memory_order_acquire);
+            if (position - cachedHead > mask)
+            {
+                return false;
+            }
+        }
+        items[position & mask] = forward<U>(value);
+        tail.store(position + 1, memory_order_release);
+        return true;
+    }
+
+    char   padding0[CacheLineSize];
+    T*     items = nullptr; // Read-only after init
+    size_t mask  = 0;
+
+    char           padding1[CacheLineSize];
+    Atomic<size_t> tail       = 0; // Written by the producer
+    size_t         cachedHead = 0; // Last head seen by the producer
+
+    char           padding2[CacheLineSize];
+    Atomic<size_t> head       = 0; // Written by the consumer
+    size_t         cachedTail = 0; // Last tail seen by the consumer
+
+    char padding3[CacheLineSize];
+};
+
+/// @brief Bounded lock-free queue for multiple producer and multiple consumer threads.
+///
+/// Implements the queue described by Dmitry Vyukov, where every cell of a caller provided ring buffer holds a
+/// sequence number telling if it's ready to be written or read at a given position.
+/// Producers (and consumers) claim a position with a single compare exchange on their own cache line, and
+/// no thread ever waits for another one to finish (a full queue just makes MPMCQueue::tryPush return `false`).
+///
+/// Example:
+/// @snippet Libraries/Threading/Tests/LockFreeQueueTest.cpp mpmcQueueSnippet
+template <typename T>
+struct SC::MPMCQueue
+{
+    /// @brief An element of the ring buffer, supplied by the caller to MPMCQueue::init
+    struct Cell
+    {
+        Atomic<size_t> sequence = 0;
+        T              value;
+    };
+
+    MPMCQueue() = default;
+    MPMCQueue(const MPMCQueue&)            = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    /// @brief Uses storage as ring buffer (it must not be called while other threads are using the queue)
+    /// @param storage Caller owned cells, whose number must be a power of two (and at least 2)
+    [[nodiscard]] Result init(Span<Cell> storage)
+    {
+        const size_t size = storage.sizeInElements();
+        SC_TRY_MSG(size >= 2 and (size & (size - 1)) == 0, "MPMCQueue::init - Size must be a power of two");
+        cells = storage.data();
+        mask  = size - 1;
+        for (size_t idx = 0; idx < size; ++idx)
+        {
+            cells[idx].sequence.store(idx, memory_order_relaxed);
+        }
+        enqueuePosition.store(0);
+        dequeuePosition.store(0);
+        return Result(true);
+    }
+
+    /// @brief Maximum number of elements that can be queued
+    [[nodiscard]] size_t capacity() const { return cells ? mask + 1 : 0; }
+
+    /// @brief Moves value at the end of the queue
+    /// @return `false` if the queue is full
+    [[nodiscard]] bool tryPush(T&& value) { return push(move(value)); }
+
+    /// @brief Copies value at the end of the queue
+    /// @return `false` if the queue is full
+    [[nodiscard]] bool tryPush(const T& value) { return push(value); }
+
+    /// @brief Moves the element at the front of the queue into value
+    /// @return `false` if the queue is empty
+    [[nodiscard]] bool tryPop(T& value)
+    {
+        Cell*  cell;
+        size_t position = dequeuePosition.load(memory_order_relaxed);
+        for (;;)
+        {
+            cell                   = &cells[position & mask];
+            const size_t  sequence = cell->sequence.load(memory_order_acquire);
+            const ssize_t distance = static_cast<ssize_t>(sequence) - static_cast<ssize_t>(position + 1);
+            if (distance == 0)
+            {
+                if (dequeuePosition.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (distance < 0)
+            {
+                return false; // Cell has not been written yet
+            }
+            else
+            {
+                position = dequeuePosition.load(memory_order_relaxed);
+            }
+        }
+        value = move(cell->value);
+        cell->sequence.store(position + mask + 1, memory_order_release);
+        return true;
+    }
+
+  private:
+    static constexpr size_t CacheLineSize = 64;
+
+    template <typename U>
+    bool push(U&& value)
+    {
+        Cell*  cell;
+        size_t position = enqueuePosition.load(memory_order_relaxed);
+        for (;;)
+        {
+            cell                   = &cells[position & mask];
+            const size_t  sequence = cell->sequence.load(memory_order_acquire);
+            const ssize_t distance = static_cast<ssize_t>(sequence) - static_cast<ssize_t>(position);
+            if (distance == 0)
+            {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (distance < 0)
+            {
+                return false; // Cell has not been read yet
+            }
+            else
+            {
+                position = enqueuePosition.load(memory_order_relaxed);
+            }
+        }
+        cell->value = forward<U>(value);
+        cell->sequence.store(position + 1, memory_order_release);
+        return true;
+    }
+
+    char   padding0[CacheLineSize];
+    Cell*  cells = nullptr; // Read-only after init
+    size_t mask  = 0;
+
+    char           padding1[CacheLineSize];
+    Atomic<size_t> enqueuePosition = 0;
+
+    char           padding2[CacheLineSize];
+    Atomic<size_t> dequeuePosition = 0;
+
+    char padding3[CacheLineSize];
+};
+
+//! @}
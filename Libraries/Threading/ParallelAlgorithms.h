@@ -0,0 +1,360 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "../Algorithms/AlgorithmMergeSort.h"
+#include "../Foundation/Span.h"
+#include "Atomic.h"
+#include "ThreadPool.h"
+
+namespace SC
+{
+template <typename T>
+struct Vector;
+
+namespace Algorithms
+{
+//! @addtogroup group_threading
+//! @{
+
+/// @brief Splits `[0, count)` in chunks of at least `grainSize` elements and invokes `function(begin, end)` on each of
+/// them, from the worker threads of `threadPool` and from the calling thread.
+///
+/// Chunks are claimed dynamically (with an atomic counter) so that a slow chunk doesn't hold back other tasks.
+/// The caller supplies the task storage, so that no memory is allocated.
+/// Tasks must not be in use and they're completed when this function returns.
+/// @param threadPool Thread pool running the chunks (together with the calling thread)
+/// @param tasks At most `tasks.sizeInElements()` tasks will be queued to the pool
+/// @param count Number of elements of the range
+/// @param grainSize Minimum number of elements processed by a single invocation of function
+/// @param function Invoked as `function(size_t begin, size_t end)` concurrently on disjoint sub-ranges
+/// @return Invalid result if one of the tasks could not be queued (all chunks are processed anyway)
+/// @warning Don't call it from a task running in the same `threadPool`, as it blocks waiting for the queued tasks
+template <typename Func>
+[[nodiscard]] Result parallelFor(ThreadPool& threadPool, Span<ThreadPoolTask> tasks, size_t count, size_t grainSize,
+                                 Func&& function);
+
+/// @brief Reduces `[0, count)` splitting it in up to `partials.sizeInElements()` contiguous blocks.
+/// Every block is reduced to `partials[block] = map(begin, end)` in parallel, and then all partials are combined, in
+/// order, with `result = reduce(result, partials[block])`.
+/// Combining blocks in order gives deterministic results (also for floating point) for a given size of `partials`,
+/// requiring `reduce` to be just associative.
+/// @param threadPool Thread pool running the blocks (together with the calling thread)
+/// @param tasks Caller owned task storage (see SC::Algorithms::parallelFor)
+/// @param partials Caller owned storage for one partial result per block
+/// @param count Number of elements of the range
+/// @param grainSize Minimum number of elements of a single block
+/// @param result Initial value (for example the identity of `reduce`) that receives the reduced value
+/// @param map Invoked as `T map(size_t begin, size_t end)`
+/// @param reduce Invoked as `T reduce(const T& a, const T& b)`
+template <typename T, typename Map, typename Reduce>
+[[nodiscard]] Result parallelReduce(ThreadPool& threadPool, Span<ThreadPoolTask> tasks, Span<T> partials, size_t count,
+                                    size_t grainSize, T& result, Map&& map, Reduce&& reduce);
+
+/// @brief Computes the inclusive scan (prefix sum) `output[i] = op(output[i - 1], input[i])` in parallel.
+/// Input is split in up to `partials.sizeInElements()` blocks, that are reduced in parallel, combined serially and
+/// then scanned again in parallel starting from the combined value of previous blocks (about `2 * N` applications
+/// of `op`). `op` must be associative. Input and output can be the same span.
+/// @param threadPool Thread pool running the blocks (together with the calling thread)
+/// @param tasks Caller owned task storage (see SC::Algorithms::parallelFor)
+/// @param partials Caller owned storage for one partial result per block
+/// @param input Elements to scan
+/// @param output Receives the scanned elements (must have the same size of input)
+/// @param grainSize Minimum number of elements of a single block
+/// @param op Invoked as `T op(const T& a, const T& b)`
+template <typename T, typename BinaryOp>
+[[nodiscard]] Result parallelScan(ThreadPool& threadPool, Span<ThreadPoolTask> tasks, Span<T> partials,
+                                  Span<const T> input, Span<T> output, size_t grainSize, BinaryOp&& op);
+
+/// @brief Sorts a span in parallel (stable merge sort).
+/// Data is split in one block per task (plus one for the calling thread), blocks are sorted concurrently and then
+/// merged pairwise, splitting every merge between multiple tasks (with a binary search on the merge path) so that
+/// also the last merge rounds use all threads.
+/// @param threadPool Thread pool running the sort (together with the calling thread)
+/// @param tasks Caller owned task storage (see SC::Algorithms::parallelFor)
+/// @param data Elements to be sorted
+/// @param scratch Caller owned temporary storage, with at least as many elements as `data`
+/// @param predicate A predicate that takes `(a, b)` and returns `bool` (example SC::Algorithms::smallerThan)
+/// @param grainSize Minimum number of elements of a block sorted by a single thread
+template <typename T, typename BinaryPredicate = smallerThan<T>>
+[[nodiscard]] Result parallelSort(ThreadPool& threadPool, Span<ThreadPoolTask> tasks, Span<T> data, Span<T> scratch,
+                                  BinaryPredicate predicate = BinaryPredicate(), size_t grainSize = 4096);
+
+/// @brief Sorts a Vector in parallel (stable merge sort), resizing `scratch` to the size of `data` if needed.
+/// @see SC::Algorithms::parallelSort
+template <typename T, typename BinaryPredicate = smallerThan<T>>
+[[nodiscard]] Result parallelSort(ThreadPool& threadPool, Span<ThreadPoolTask> tasks, Vector<T>& data,
+                                  Vector<T>& scratch, BinaryPredicate predicate = BinaryPredicate(),
+                                  size_t grainSize = 4096);
+
+//! @}
+
+namespace detail
+{
+template <typename Func>
+struct ParallelForContext
+{
+    static constexpr size_t ChunksPerTask = 8; // Allows balancing load when chunks have different costs
+
+    Func&   function;
+    size_t  count;
+    size_t  chunkSize;
+    int32_t numChunks;
+
+    Atomic<int32_t> nextChunk{0};
+
+    ParallelForContext(Func& function, size_t count, size_t grainSize, size_t numThreads)
+        : function(function), count(count)
+    {
+        const size_t maxChunks = numThreads * ChunksPerTask;
+        chunkSize              = max(grainSize, (count + maxChunks - 1) / maxChunks);
+        numChunks              = static_cast<int32_t>((count + chunkSize - 1) / chunkSize);
+    }
+
+    void run()
+    {
+        for (int32_t chunk = nextChunk.fetch_add(1); chunk < numChunks; chunk = nextChunk.fetch_add(1))
+        {
+            const size_t begin = static_cast<size_t>(chunk) * chunkSize;
+            function(begin, min(begin + chunkSize, count));
+        }
+    }
+};
+
+// Begin of the block-th of numBlocks blocks of similar size of a range of count elements
+inline size_t blockBegin(size_t count, size_t numBlocks, size_t block)
+{
+    return static_cast<size_t>(static_cast<uint64_t>(count) * block / numBlocks);
+}
+
+inline size_t numBlocksFor(size_t count, size_t grainSize, size_t maxBlocks)
+{
+    grainSize = grainSize > 0 ? grainSize : 1;
+    return min((count + grainSize - 1) / grainSize, maxBlocks);
+}
+
+// Returns how many elements of a are among the first `diagonal` elements of the stable merge of a and b
+template <typename T, typename BinaryPredicate>
+size_t mergePath(const T* a, size_t countA, const T* b, size_t countB, size_t diagonal, BinaryPredicate& predicate)
+{
+    size_t low  = diagonal > countB ? diagonal - countB : 0;
+    size_t high = min(diagonal, countA);
+    while (low < high)
+    {
+        const size_t mid = low + (high - low) / 2;
+        if (predicate(b[diagonal - mid - 1], a[mid]))
+            high = mid;
+        else
+            low = mid + 1;
+    }
+    return low;
+}
+
+} // namespace detail
+} // namespace Algorithms
+} // namespace SC
+
+template <typename Func>
+SC::Result SC::Algorithms::parallelFor(ThreadPool& threadPool, Span<ThreadPoolTask> tasks, size_t count,
+                                       size_t grainSize, Func&& function)
+{
+    if (count == 0)
+    {
+        return Result(true);
+    }
+    using FunctionType = typename TypeTraits::RemoveReference<Func>::type;
+    const size_t maxTasks = min(tasks.sizeInElements(), static_cast<size_t>(1024));
+
+    detail::ParallelForContext<FunctionType> context(function, count, grainSize > 0 ? grainSize : 1, maxTasks + 1);
+
+    // The calling thread processes chunks too, so a single chunk doesn't need any task
+    const size_t numTasks  = min(maxTasks, static_cast<size_t>(context.numChunks - 1));
+    size_t       numQueued = 0;
+    Result       result(true);
+    for (; numQueued < numTasks; ++numQueued)
+    {
+        tasks[numQueued].function = [&context]() { context.run(); };
+        result                    = threadPool.queueTask(tasks[numQueued]);
+        if (not result)
+        {
+            break;
+        }
+    }
+    context.run();
+    for (size_t idx = 0; idx < numQueued; ++idx)
+    {
+        const Result waitResult = threadPool.waitForTask(tasks[idx]);
+        if (result and not waitResult)
+        {
+            result = waitResult;
+        }
+    }
+    return result;
+}
+
+template <typename T, typename Map, typename Reduce>
+SC::Result SC::Algorithms::parallelReduce(ThreadPool& threadPool, Span<ThreadPoolTask> tasks, Span<T> partials,
+                                          size_t count, size_t grainSize, T& result, Map&& map, Reduce&& reduce)
+{
+    SC_TRY_MSG(not partials.empty(), "parallelReduce - partials cannot be empty");
+    const size_t numBlocks = detail::numBlocksFor(count, grainSize, partials.sizeInElements());
+
+    auto reduceBlocks = [&](size_t begin, size_t end)
+    {
+        for (size_t block = begin; block < end; ++block)
+        {
+            partials[block] = map(detail::blockBegin(count, numBlocks, block),
+                                  detail::blockBegin(count, numBlocks, block + 1));
+        }
+    };
+    SC_TRY(parallelFor(threadPool, tasks, numBlocks, 1, reduceBlocks));
+    for (size_t block = 0; block < numBlocks; ++block)
+    {
+        result = reduce(result, partials[block]);
+    }
+    return Result(true);
+}
+
+template <typename T, typename BinaryOp>
+SC::Result SC::Algorithms::parallelScan(ThreadPool& threadPool, Span<ThreadPoolTask> tasks, Span<T> partials,
+                                        Span<const T> input, Span<T> output, size_t grainSize, BinaryOp&& op)
+{
+    SC_TRY_MSG(not partials.empty(), "parallelScan - partials cannot be empty");
+    SC_TRY_MSG(input.sizeInElements() == output.sizeInElements(), "parallelScan - input and output size differ");
+    const size_t count     = input.sizeInElements();
+    const size_t numBlocks = detail::numBlocksFor(count, grainSize, partials.sizeInElements());
+    if (numBlocks == 0)
+    {
+        return Result(true);
+    }
+
+    // 1. Reduce every block (the last one is not needed by the following blocks)
+    auto reduceBlocks = [&](size_t begin, size_t end)
+    {
+        for (size_t block = begin; block < end; ++block)
+        {
+            const size_t blockEnd = detail::blockBegin(count, numBlocks, block + 1);
+            size_t       idx      = detail::blockBegin(count, numBlocks, block);
+
+            T value = input[idx];
+            for (++idx; idx < blockEnd; ++idx)
+            {
+                value = op(value, input[idx]);
+            }
+            partials[block] = move(value);
+        }
+    };
+    SC_TRY(parallelFor(threadPool, tasks, numBlocks - 1, 1, reduceBlocks));
+
+    // 2. Turn partials in the combined value of all blocks preceding each block (partials[0] is not used)
+    for (size_t block = numBlocks - 1; block > 0; --block)
+    {
+        partials[block] = partials[block - 1];
+    }
+    for (size_t block = 2; block < numBlocks; ++block)
+    {
+        partials[block] = op(partials[block - 1], partials[block]);
+    }
+
+    // 3. Scan every block starting from the value of the preceding blocks
+    auto scanBlocks = [&](size_t begin, size_t end)
+    {
+        for (size_t block = begin; block < end; ++block)
+        {
+            const size_t blockEnd = detail::blockBegin(count, numBlocks, block + 1);
+            size_t       idx      = detail::blockBegin(count, numBlocks, block);
+
+            T value = block == 0 ? input[idx] : op(partials[block], input[idx]);
+            for (output[idx] = value, ++idx; idx < blockEnd; ++idx)
+            {
+                value       = op(value, input[idx]);
+                output[idx] = value;
+            }
+        }
+    };
+    return parallelFor(threadPool, tasks, numBlocks, 1, scanBlocks);
+}
+
+template <typename T, typename BinaryPredicate>
+SC::Result SC::Algorithms::parallelSort(ThreadPool& threadPool, Span<ThreadPoolTask> tasks, Span<T> data,
+                                        Span<T> scratch, BinaryPredicate predicate, size_t grainSize)
+{
+    SC_TRY_MSG(scratch.sizeInElements() >= data.sizeInElements(), "parallelSort - scratch is too small");
+    const size_t count     = data.sizeInElements();
+    const size_t numTasks  = tasks.sizeInElements() + 1; // Includes the calling thread
+    const size_t numBlocks = detail::numBlocksFor(count, grainSize, numTasks);
+
+    // 1. Sort every block
+    auto sortBlocks = [&](size_t begin, size_t end)
+    {
+        for (size_t block = begin; block < end; ++block)
+        {
+            const size_t blockBegin = detail::blockBegin(count, numBlocks, block);
+            const size_t blockEnd   = detail::blockBegin(count, numBlocks, block + 1);
+            mergeSort(data.data() + blockBegin, data.data() + blockEnd, scratch.data() + blockBegin, predicate);
+        }
+    };
+    SC_TRY(parallelFor(threadPool, tasks, numBlocks, 1, sortBlocks));
+
+    // 2. Merge pairs of runs (made of `width` blocks) alternating between data and scratch
+    T* source      = data.data();
+    T* destination = scratch.data();
+    for (size_t width = 1; width < numBlocks; width *= 2)
+    {
+        const size_t numPairs     = (numBlocks + 2 * width - 1) / (2 * width);
+        const size_t numSegments  = max(numTasks / numPairs, static_cast<size_t>(1)); // Segments of every merge
+        auto         mergeBlocks = [&](size_t begin, size_t end)
+        {
+            for (size_t idx = begin; idx < end; ++idx)
+            {
+                const size_t pair    = idx / numSegments;
+                const size_t segment = idx % numSegments;
+                const size_t first   = detail::blockBegin(count, numBlocks, pair * 2 * width);
+                const size_t middle  = detail::blockBegin(count, numBlocks, min(pair * 2 * width + width, numBlocks));
+                const size_t last    = detail::blockBegin(count, numBlocks, min((pair + 1) * 2 * width, numBlocks));
+
+                const size_t countA = middle - first;
+                const size_t countB = last - middle;
+
+                // Segment of the merged output produced by this task and the corresponding inputs
+                const size_t diagonalBegin = detail::blockBegin(last - first, numSegments, segment);
+                const size_t diagonalEnd   = detail::blockBegin(last - first, numSegments, segment + 1);
+
+                T* a = source + first;
+                T* b = source + middle;
+
+                const size_t beginA = detail::mergePath(a, countA, b, countB, diagonalBegin, predicate);
+                const size_t endA   = detail::mergePath(a, countA, b, countB, diagonalEnd, predicate);
+                const size_t beginB = diagonalBegin - beginA;
+                const size_t endB   = diagonalEnd - endA;
+                merge(a + beginA, a + endA, b + beginB, b + endB, destination + first + diagonalBegin, predicate);
+            }
+        };
+        SC_TRY(parallelFor(threadPool, tasks, numPairs * numSegments, 1, mergeBlocks));
+        swap(source, destination);
+    }
+
+    // 3. Move back the result if it's in scratch
+    if (source != data.data())
+    {
+        auto moveBack = [&](size_t begin, size_t end)
+        {
+            for (size_t idx = begin; idx < end; ++idx)
+            {
+                data[idx] = move(scratch[idx]);
+            }
+        };
+        SC_TRY(parallelFor(threadPool, tasks, count, grainSize, moveBack));
+    }
+    return Result(true);
+}
+
+template <typename T, typename BinaryPredicate>
+SC::Result SC::Algorithms::parallelSort(ThreadPool& threadPool, Span<ThreadPoolTask> tasks, Vector<T>& data,
+                                        Vector<T>& scratch, BinaryPredicate predicate, size_t grainSize)
+{
+    if (scratch.size() < data.size())
+    {
+        SC_TRY_MSG(scratch.resize(data.size()), "parallelSort - cannot resize scratch");
+    }
+    return parallelSort(threadPool, tasks, data.toSpan(), scratch.toSpan(), predicate, grainSize);
+}
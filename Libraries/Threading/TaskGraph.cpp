@@ -0,0 +1,198 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "TaskGraph.h"
+
+struct SC::TaskGraph::Internal
+{
+    static void prepare(Node& node)
+    {
+        Node* self         = &node;
+        node.task.function = [self]()
+        {
+            if (self->function.isValid())
+            {
+                self->function();
+            }
+            finishWork(*self);
+        };
+    }
+
+    static void queueNode(Node& node)
+    {
+        if (not node.graph->threadPool->queueTask(node.task))
+        {
+            node.task.function(); // Don't leave the graph hanging if the thread pool can't accept it
+        }
+    }
+
+    // Called when the function of node returns or when one of its children is finished
+    static void finishWork(Node& node)
+    {
+        if (node.pendingWork.fetch_add(-1) != 1)
+        {
+            return; // Some children are still running
+        }
+        TaskGraph& graph = *node.graph;
+        for (Edge* edge = node.successors; edge != nullptr; edge = edge->next)
+        {
+            if (edge->successor->pendingPredecessors.fetch_add(-1) == 1)
+            {
+                queueNode(*edge->successor); // This was the last predecessor
+            }
+        }
+        if (node.parent)
+        {
+            finishWork(*node.parent);
+        }
+        if (graph.numPendingNodes.fetch_add(-1) == 1)
+        {
+            if (graph.onComplete.isValid())
+            {
+                graph.onComplete();
+            }
+            graph.completed.signal();
+        }
+    }
+
+    // Returns the number of nodes that can be executed in topological order (all of them if there are no cycles)
+    static int32_t countSortableNodes(TaskGraph& graph)
+    {
+        // Kahn's algorithm, using Node::parent (always nullptr for nodes of the graph) to link the stack of ready nodes
+        Node* ready = nullptr;
+        for (Node* node = graph.firstNode; node != nullptr; node = node->next)
+        {
+            node->pendingPredecessors.store(node->numPredecessors);
+            if (node->numPredecessors == 0)
+            {
+                node->parent = ready;
+                ready        = node;
+            }
+        }
+        int32_t numSorted = 0;
+        while (ready != nullptr)
+        {
+            Node* node   = ready;
+            ready        = node->parent;
+            node->parent = nullptr;
+            numSorted++;
+            for (Edge* edge = node->successors; edge != nullptr; edge = edge->next)
+            {
+                if (edge->successor->pendingPredecessors.fetch_add(-1) == 1)
+                {
+                    edge->successor->parent = ready;
+                    ready                   = edge->successor;
+                }
+            }
+        }
+        return numSorted;
+    }
+
+    [[nodiscard]] static Result waitNodes(ThreadPool& threadPool, Node* firstNode)
+    {
+        // Makes sure that the thread pool is not using tasks anymore, so that they can be reused or released
+        for (Node* node = firstNode; node != nullptr; node = node->next)
+        {
+            SC_TRY(threadPool.waitForTask(node->task));
+            SC_TRY(waitNodes(threadPool, node->firstChild));
+        }
+        return Result(true);
+    }
+};
+
+SC::Result SC::TaskGraph::addNode(Node& node)
+{
+    SC_TRY_MSG(not running, "TaskGraph::addNode - Graph is running");
+    SC_TRY_MSG(node.graph == nullptr, "TaskGraph::addNode - Node already belongs to a graph");
+    node.graph           = this;
+    node.next            = nullptr;
+    node.parent          = nullptr;
+    node.firstChild      = nullptr;
+    node.successors      = nullptr;
+    node.numPredecessors = 0;
+    Internal::prepare(node);
+    if (lastNode)
+    {
+        lastNode->next = &node;
+    }
+    else
+    {
+        firstNode = &node;
+    }
+    lastNode = &node;
+    return Result(true);
+}
+
+SC::Result SC::TaskGraph::addDependency(Node& predecessor, Node& successor, Edge& edge)
+{
+    SC_TRY_MSG(not running, "TaskGraph::addDependency - Graph is running");
+    SC_TRY_MSG(predecessor.graph == this and successor.graph == this and predecessor.parent == nullptr and
+                   successor.parent == nullptr,
+               "TaskGraph::addDependency - Nodes must be added to this graph");
+    SC_TRY_MSG(&predecessor != &successor, "TaskGraph::addDependency - Node cannot depend on itself");
+    edge.successor         = &successor;
+    edge.next              = predecessor.successors;
+    predecessor.successors = &edge;
+    successor.numPredecessors++;
+    return Result(true);
+}
+
+SC::Result SC::TaskGraph::start(ThreadPool& pool)
+{
+    SC_TRY_MSG(not running, "TaskGraph::start - Graph is already running");
+    SC_TRY_MSG(firstNode != nullptr, "TaskGraph::start - Graph has no nodes");
+    int32_t numNodes = 0;
+    for (Node* node = firstNode; node != nullptr; node = node->next)
+    {
+        numNodes++;
+    }
+    SC_TRY_MSG(Internal::countSortableNodes(*this) == numNodes, "TaskGraph::start - Dependencies contain a cycle");
+
+    for (Node* node = firstNode; node != nullptr; node = node->next)
+    {
+        node->pendingPredecessors.store(node->numPredecessors);
+        node->pendingWork.store(1);
+        node->firstChild = nullptr;
+    }
+    numPendingNodes.store(numNodes);
+    threadPool = &pool;
+    running    = true;
+    for (Node* node = firstNode; node != nullptr; node = node->next)
+    {
+        if (node->numPredecessors == 0)
+        {
+            Internal::queueNode(*node);
+        }
+    }
+    return Result(true);
+}
+
+SC::Result SC::TaskGraph::spawn(Node& parent, Node& child)
+{
+    SC_TRY_MSG(running and parent.graph == this, "TaskGraph::spawn - Parent is not running in this graph");
+    SC_TRY_MSG(child.graph == nullptr or (child.graph == this and child.parent != nullptr),
+               "TaskGraph::spawn - Child cannot be a node added to a graph");
+    child.graph           = this;
+    child.parent          = &parent;
+    child.firstChild      = nullptr;
+    child.successors      = nullptr;
+    child.numPredecessors = 0;
+    child.pendingWork.store(1);
+    Internal::prepare(child);
+
+    // Only the (running) parent links its children, so this doesn't need any synchronization
+    child.next        = parent.firstChild;
+    parent.firstChild = &child;
+
+    parent.pendingWork.fetch_add(1);
+    numPendingNodes.fetch_add(1);
+    Internal::queueNode(child);
+    return Result(true);
+}
+
+SC::Result SC::TaskGraph::wait()
+{
+    SC_TRY_MSG(running, "TaskGraph::wait - Graph is not running");
+    completed.wait();
+    running = false;
+    return Internal::waitNodes(*threadPool, firstNode);
+}
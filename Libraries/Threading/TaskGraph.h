@@ -0,0 +1,115 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#pragma once
+#include "Atomic.h"
+#include "ThreadPool.h"
+
+namespace SC
+{
+struct TaskGraph;
+struct TaskGraphNode;
+struct TaskGraphEdge;
+} // namespace SC
+
+//! @addtogroup group_threading
+//! @{
+
+/// @brief A node of a SC::TaskGraph, executing TaskGraphNode::function once all of its predecessors are finished.
+/// A node is considered finished when its function has returned and all children spawned by it (with
+/// TaskGraph::spawn) are finished too.
+struct SC::TaskGraphNode
+{
+    Function<void()> function; ///< Executed when all predecessors are finished (can be empty for join nodes)
+
+  private:
+    friend struct TaskGraph;
+    ThreadPoolTask task;
+
+    TaskGraph*     graph      = nullptr;
+    TaskGraphNode* next       = nullptr; // Next node of the graph (or next child of parent for spawned nodes)
+    TaskGraphNode* parent     = nullptr; // Node that has spawned this one (if any)
+    TaskGraphNode* firstChild = nullptr; // Nodes spawned by this one during current run
+    TaskGraphEdge* successors = nullptr; // Nodes depending on this one
+
+    int32_t         numPredecessors     = 0; // Number of dependencies declared with TaskGraph::addDependency
+    Atomic<int32_t> pendingPredecessors = 0; // Predecessors not finished yet (during a run)
+    Atomic<int32_t> pendingWork         = 0; // 1 for function + number of children not finished yet (during a run)
+};
+
+/// @brief A dependency between two SC::TaskGraphNode, supplied by the caller to TaskGraph::addDependency
+struct SC::TaskGraphEdge
+{
+  private:
+    friend struct TaskGraph;
+    TaskGraphNode* successor = nullptr;
+    TaskGraphEdge* next      = nullptr;
+};
+
+/// @brief Executes a directed acyclic graph of tasks on a SC::ThreadPool.
+///
+/// Every node keeps an atomic counter of its unfinished predecessors, decremented by each predecessor when it
+/// finishes. The node that brings the counter to zero queues it to the thread pool, so that no thread ever waits for
+/// a dependency and independent branches of the graph run concurrently.
+/// A running node can also spawn additional children nodes (TaskGraph::spawn), whose number doesn't need to be known
+/// upfront. Successors of a node run only after all its children are finished, so children act as fork / join.
+///
+/// When the last node finishes, TaskGraph::onComplete is invoked (from the worker thread that has finished it).
+/// It can be used to notify an SC::AsyncEventLoop through SC::AsyncLoopWakeUp::wakeUp, without blocking the loop
+/// thread in TaskGraph::wait. TaskGraph::wait must always be called before running the graph again or before
+/// releasing it (it returns immediately if the graph is already complete).
+///
+/// As SC::ThreadPool, this class doesn't allocate any memory and expects the caller to supply all nodes and edges,
+/// that must be kept at a stable address until the graph is complete.
+///
+/// Example:
+/// @snippet Libraries/Threading/Tests/TaskGraphTest.cpp taskGraphSnippet
+struct SC::TaskGraph
+{
+    using Node = TaskGraphNode;
+    using Edge = TaskGraphEdge;
+
+    TaskGraph() = default;
+    TaskGraph(const TaskGraph&)            = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    Function<void()> onComplete; ///< Invoked by the thread finishing the last node, before TaskGraph::wait returns
+
+    /// @brief Adds a node to the graph (that must not be running)
+    [[nodiscard]] Result addNode(Node& node);
+
+    /// @brief Declares that `successor` can only run after `predecessor` is finished
+    /// @param predecessor A node already added to this graph
+    /// @param successor A node already added to this graph
+    /// @param edge Caller supplied storage for the dependency (not used by other dependencies)
+    [[nodiscard]] Result addDependency(Node& predecessor, Node& successor, Edge& edge);
+
+    /// @brief Starts running the graph, queuing all nodes without predecessors to the thread pool
+    /// @param threadPool Thread pool that will execute nodes of the graph
+    /// @return Invalid Result if the graph is empty, already running or if its dependencies contain a cycle
+    [[nodiscard]] Result start(ThreadPool& threadPool);
+
+    /// @brief Runs a child node, delaying completion of parent until the child will be finished too.
+    /// It must be called from the function of `parent` (a child can spawn its own children, passing itself as parent).
+    /// @param parent The node currently running
+    /// @param child A node not added to any graph (it can be reused as a child in later runs)
+    [[nodiscard]] Result spawn(Node& parent, Node& child);
+
+    /// @brief Blocks until all nodes of the graph (and all spawned children) are finished
+    [[nodiscard]] Result wait();
+
+    /// @brief Returns `true` if the graph has been started and TaskGraph::wait has not been called yet
+    [[nodiscard]] bool isRunning() const { return running; }
+
+  private:
+    ThreadPool* threadPool = nullptr;
+    Node*       firstNode  = nullptr;
+    Node*       lastNode   = nullptr;
+    bool        running    = false;
+
+    Atomic<int32_t> numPendingNodes = 0; // Nodes (including children) not finished yet
+    EventObject     completed;
+
+    struct Internal;
+};
+
+//! @}
@@ -10,6 +10,27 @@ struct AtomicTest;
 
 struct SC::AtomicTest : public SC::TestCase
 {
+    template <typename T>
+    void testIntegers()
+    {
+        Atomic<T> test;
+        SC_TEST_EXPECT(test.load() == 0);
+        test.store(T(0x70), memory_order_relaxed);
+        SC_TEST_EXPECT(test.exchange(T(0x0f)) == T(0x70));
+        SC_TEST_EXPECT(test.fetch_add(T(1), memory_order_relaxed) == T(0x0f));
+        SC_TEST_EXPECT(test.fetch_sub(T(2), memory_order_release) == T(0x10));
+        SC_TEST_EXPECT(test.fetch_and(T(0x0c), memory_order_acquire) == T(0x0e));
+        SC_TEST_EXPECT(test.fetch_or(T(0x41)) == T(0x0c));
+        SC_TEST_EXPECT(test.fetch_xor(T(0x05), memory_order_acq_rel) == T(0x4d));
+        SC_TEST_EXPECT(test.load(memory_order_acquire) == T(0x48));
+
+        T expected = T(0x12);
+        SC_TEST_EXPECT(not test.compare_exchange_strong(expected, T(0x20)));
+        SC_TEST_EXPECT(expected == T(0x48));
+        SC_TEST_EXPECT(test.compare_exchange_strong(expected, T(0x20), memory_order_acq_rel));
+        SC_TEST_EXPECT(test.load() == T(0x20));
+    }
+
     AtomicTest(SC::TestReport& report) : TestCase(report, "AtomicTest")
     {
         using namespace SC;
@@ -30,6 +51,56 @@ struct SC::AtomicTest : public SC::TestCase
             SC_TEST_EXPECT(test.fetch_add(1) == 10);
             SC_TEST_EXPECT(test.load() == 11);
         }
+        if (test_section("atomic<integers>"))
+        {
+            testIntegers<int8_t>();
+            testIntegers<uint8_t>();
+            testIntegers<int16_t>();
+            testIntegers<uint16_t>();
+            testIntegers<int32_t>();
+            testIntegers<uint32_t>();
+            testIntegers<int64_t>();
+            testIntegers<uint64_t>();
+            testIntegers<size_t>();
+
+            Atomic<uint64_t> wide = 0xffffffffull;
+            SC_TEST_EXPECT(wide.fetch_add(1, memory_order_relaxed) == 0xffffffffull);
+            SC_TEST_EXPECT(wide.load(memory_order_acquire) == 0x100000000ull);
+        }
+        if (test_section("atomic<pointer>"))
+        {
+            int64_t values[4] = {0};
+
+            Atomic<int64_t*> pointer = values;
+            SC_TEST_EXPECT(pointer.fetch_add(2) == values);
+            SC_TEST_EXPECT(pointer.load() == values + 2);
+            SC_TEST_EXPECT(pointer.fetch_sub(1, memory_order_acq_rel) == values + 2);
+            SC_TEST_EXPECT(pointer.exchange(nullptr) == values + 1);
+
+            int64_t* expected = values;
+            SC_TEST_EXPECT(not pointer.compare_exchange_strong(expected, values + 3));
+            SC_TEST_EXPECT(expected == nullptr);
+            SC_TEST_EXPECT(pointer.compare_exchange_strong(expected, values + 3));
+            SC_TEST_EXPECT(pointer.load(memory_order_relaxed) == values + 3);
+        }
+        if (test_section("compare_exchange"))
+        {
+            Atomic<bool> flag;
+            bool         expected = true;
+            SC_TEST_EXPECT(not flag.compare_exchange_strong(expected, false));
+            SC_TEST_EXPECT(not expected);
+            SC_TEST_EXPECT(flag.compare_exchange_strong(expected, true, memory_order_acquire, memory_order_relaxed));
+            flag.store(false, memory_order_release);
+            SC_TEST_EXPECT(not flag.load());
+
+            // Weak version can fail spuriously, so it's used in a loop
+            Atomic<int32_t> value    = 5;
+            int32_t         previous = value.load(memory_order_relaxed);
+            while (not value.compare_exchange_weak(previous, previous * 3, memory_order_acq_rel))
+            {
+            }
+            SC_TEST_EXPECT(value.load() == 15);
+        }
     }
 };
 
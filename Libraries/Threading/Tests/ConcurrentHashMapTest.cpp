@@ -0,0 +1,490 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../ConcurrentHashMap.h"
+#include "../../Strings/String.h"
+#include "../../Testing/Testing.h"
+
+namespace SC
+{
+struct ConcurrentHashMapTest;
+}
+
+struct SC::ConcurrentHashMapTest : public SC::TestCase
+{
+    // A value that can be checked for consistency and that counts its live instances
+    struct Entry
+    {
+        int32_t key   = 0;
+        int32_t check = 0; // Always 3 * key
+
+        static Atomic<int32_t>& numInstances()
+        {
+            static Atomic<int32_t> instances;
+            return instances;
+        }
+        Entry(int32_t key = 0) : key(key), check(key * 3) { numInstances().fetch_add(1); }
+        Entry(const Entry& other) : key(other.key), check(other.check) { numInstances().fetch_add(1); }
+        ~Entry() { numInstances().fetch_sub(1); }
+
+        bool isValid(int32_t expectedKey) const { return key == expectedKey and check == 3 * key; }
+    };
+
+    inline void testFixed();
+    inline void testGrowable();
+    inline void testConcurrent();
+    inline void testGrowingReaders();
+    inline void concurrentHashMapSnippet();
+
+    ConcurrentHashMapTest(SC::TestReport& report) : TestCase(report, "ConcurrentHashMapTest")
+    {
+        if (test_section("fixed"))
+        {
+            testFixed();
+        }
+        if (test_section("growable"))
+        {
+            testGrowable();
+        }
+        if (test_section("concurrent"))
+        {
+            testConcurrent();
+        }
+        if (test_section("growing readers"))
+        {
+            testGrowingReaders();
+        }
+        if (test_section("snippet"))
+        {
+            concurrentHashMapSnippet();
+        }
+    }
+};
+
+void SC::ConcurrentHashMapTest::testFixed()
+{
+    using Map = ConcurrentHashMap<int32_t, Entry>;
+    EpochDomain domain;
+    EpochThread thread;
+    SC_TEST_EXPECT(domain.registerThread(thread));
+    {
+        Map::Slot slots[16];
+        Map::Node nodes[8];
+        Map       map(domain);
+
+        Map::Slot wrongSlots[12];
+        SC_TEST_EXPECT(not map.init(wrongSlots, nodes));
+        SC_TEST_EXPECT(map.init(slots, nodes));
+        SC_TEST_EXPECT(not map.init(slots, nodes));
+        SC_TEST_EXPECT(map.capacity() == 16);
+
+        for (int32_t key = 0; key < 8; ++key)
+        {
+            SC_TEST_EXPECT(map.insertIfNotExists(thread, key, Entry(key)));
+        }
+        SC_TEST_EXPECT(map.size() == 8);
+        SC_TEST_EXPECT(not map.insertIfNotExists(thread, 3, Entry(3))); // Already exists
+        SC_TEST_EXPECT(not map.insertIfNotExists(thread, 8, Entry(8))); // All nodes are used
+        {
+            EpochGuard guard(domain, thread);
+            for (int32_t key = 0; key < 8; ++key)
+            {
+                const Entry* entry = map.get(key);
+                SC_TEST_EXPECT(entry != nullptr and entry->isValid(key));
+            }
+            SC_TEST_EXPECT(map.get(8) == nullptr);
+            SC_TEST_EXPECT(not map.contains(-1));
+        }
+
+        // Removed nodes become available again once reclaimed by the domain
+        SC_TEST_EXPECT(map.remove(thread, 2));
+        SC_TEST_EXPECT(not map.remove(thread, 2));
+        SC_TEST_EXPECT(map.size() == 7);
+        SC_TEST_EXPECT(not map.insertOverwrite(thread, 5, Entry(5)));
+        domain.synchronize();
+        SC_TEST_EXPECT(map.insertOverwrite(thread, 5, Entry(5)));
+        domain.synchronize();
+        SC_TEST_EXPECT(map.insertIfNotExists(thread, 2, Entry(2))); // Reuses the tombstone
+        SC_TEST_EXPECT(map.size() == 8);
+        {
+            EpochGuard guard(domain, thread);
+            SC_TEST_EXPECT(map.get(2) and map.get(2)->isValid(2));
+            SC_TEST_EXPECT(map.get(5) and map.get(5)->isValid(5));
+        }
+    }
+    domain.synchronize();
+    SC_TEST_EXPECT(Entry::numInstances().load() == 0);
+
+    // Insertion fails when all slots are used
+    {
+        Map::Slot slots[4];
+        Map::Node nodes[8];
+        Map       map(domain);
+        SC_TEST_EXPECT(map.init(slots, nodes));
+        for (int32_t key = 0; key < 4; ++key)
+        {
+            SC_TEST_EXPECT(map.insertIfNotExists(thread, key, Entry(key)));
+        }
+        SC_TEST_EXPECT(not map.insertIfNotExists(thread, 4, Entry(4)));
+        SC_TEST_EXPECT(map.insertOverwrite(thread, 1, Entry(1)));
+        domain.synchronize(); // Caller provided nodes must not be destroyed before the domain reclaims them
+    }
+    SC_TEST_EXPECT(domain.unregisterThread(thread));
+    SC_TEST_EXPECT(domain.destroy());
+    SC_TEST_EXPECT(Entry::numInstances().load() == 0);
+}
+
+void SC::ConcurrentHashMapTest::testGrowable()
+{
+    static constexpr int32_t NumKeys = 10000;
+
+    EpochDomain domain;
+    EpochThread thread;
+    SC_TEST_EXPECT(domain.registerThread(thread));
+    {
+        ConcurrentHashMap<int32_t, Entry> map(domain);
+        SC_TEST_EXPECT(map.capacity() == 0);
+        SC_TEST_EXPECT(not map.insertIfNotExists(thread, 1, Entry(1))); // Not initialized
+        SC_TEST_EXPECT(map.init());
+        SC_TEST_EXPECT(map.capacity() == 16);
+
+        bool inserted = true;
+        for (int32_t key = 0; key < NumKeys; ++key)
+        {
+            inserted = inserted and map.insertIfNotExists(thread, key, Entry(key));
+        }
+        SC_TEST_EXPECT(inserted);
+        SC_TEST_EXPECT(map.size() == NumKeys);
+        SC_TEST_EXPECT(map.capacity() >= NumKeys);
+
+        bool removed = true;
+        for (int32_t key = 0; key < NumKeys; key += 2)
+        {
+            removed = removed and map.remove(thread, key);
+        }
+        SC_TEST_EXPECT(removed);
+        SC_TEST_EXPECT(map.size() == NumKeys / 2);
+        bool overwritten = true;
+        for (int32_t key = 1; key < NumKeys; key += 4)
+        {
+            overwritten = overwritten and map.insertOverwrite(thread, key, Entry(key));
+        }
+        SC_TEST_EXPECT(overwritten);
+        {
+            EpochGuard guard(domain, thread);
+            bool       found = true;
+            for (int32_t key = 0; key < NumKeys; ++key)
+            {
+                const Entry* entry = map.get(key);
+                found = found and (key % 2 == 0 ? entry == nullptr : entry != nullptr and entry->isValid(key));
+            }
+            SC_TEST_EXPECT(found);
+        }
+
+        // Keys can be looked up with any type comparable to them
+        ConcurrentHashMap<String, int32_t> strings(domain);
+        SC_TEST_EXPECT(strings.init(4));
+        SC_TEST_EXPECT(strings.insertIfNotExists(thread, String("one"), 1));
+        SC_TEST_EXPECT(strings.insertIfNotExists(thread, String("two"), 2));
+        {
+            EpochGuard guard(domain, thread);
+            SC_TEST_EXPECT(strings.get(StringView("two")) and *strings.get(StringView("two")) == 2);
+            SC_TEST_EXPECT(not strings.contains(StringView("three")));
+        }
+        SC_TEST_EXPECT(strings.remove(thread, StringView("one")));
+    }
+    SC_TEST_EXPECT(domain.unregisterThread(thread));
+    SC_TEST_EXPECT(domain.destroy());
+    SC_TEST_EXPECT(Entry::numInstances().load() == 0);
+}
+
+void SC::ConcurrentHashMapTest::testConcurrent()
+{
+    static constexpr int     NumReaders = 4;
+    static constexpr int     NumWriters = 3;
+    static constexpr int32_t NumKeys    = 6000; // Keys are partitioned between writers
+
+    using Map = ConcurrentHashMap<int32_t, Entry>;
+    EpochDomain domain;
+    {
+        Map map(domain);
+        SC_TEST_EXPECT(map.init()); // Starting small, so that the map grows many times while being read
+
+        Atomic<bool> stop = false;
+        struct Reader
+        {
+            EpochDomain*  domain = nullptr;
+            Map*          map    = nullptr;
+            Atomic<bool>* stop   = nullptr;
+
+            int32_t  numErrors = 0;
+            uint64_t numFound  = 0;
+            Thread   thread;
+        } readers[NumReaders];
+        struct Writer
+        {
+            EpochDomain* domain = nullptr;
+            Map*         map    = nullptr;
+            int32_t      index  = 0;
+
+            int32_t numErrors   = 0;
+            int32_t numInserted = 0; // Inserted by this writer into shared keys
+            bool    present[NumKeys / NumWriters];
+            Thread  thread;
+        } writers[NumWriters];
+
+        for (Reader& reader : readers)
+        {
+            reader.domain = &domain;
+            reader.map    = &map;
+            reader.stop   = &stop;
+            SC_TEST_EXPECT(reader.thread.start(
+                [&reader](Thread&)
+                {
+                    EpochThread epochThread;
+                    if (not reader.domain->registerThread(epochThread))
+                    {
+                        reader.numErrors++;
+                        return;
+                    }
+                    for (int32_t key = 0; not reader.stop->load(memory_order_relaxed); key = (key + 7) % NumKeys)
+                    {
+                        EpochGuard   guard(*reader.domain, epochThread);
+                        const Entry* entry = reader.map->get(key);
+                        if (entry != nullptr)
+                        {
+                            // Values are never seen half constructed (or freed)
+                            reader.numErrors += entry->isValid(key) ? 0 : 1;
+                            reader.numFound++;
+                        }
+                    }
+                    (void)reader.domain->unregisterThread(epochThread);
+                }));
+        }
+        for (int32_t idx = 0; idx < NumWriters; ++idx)
+        {
+            Writer& writer = writers[idx];
+            writer.domain  = &domain;
+            writer.map     = &map;
+            writer.index   = idx;
+            SC_TEST_EXPECT(writer.thread.start(
+                [&writer](Thread&)
+                {
+                    EpochThread epochThread;
+                    if (not writer.domain->registerThread(epochThread))
+                    {
+                        writer.numErrors++;
+                        return;
+                    }
+                    // Keys owned by this writer (key % NumWriters == index) are inserted, overwritten and removed
+                    for (int32_t round = 0; round < 3; ++round)
+                    {
+                        for (int32_t idx = 0; idx < NumKeys / NumWriters; ++idx)
+                        {
+                            const int32_t key = idx * NumWriters + writer.index;
+                            if (round == 0)
+                            {
+                                writer.numErrors += writer.map->insertIfNotExists(epochThread, key, Entry(key)) ? 0 : 1;
+                                writer.present[idx] = true;
+                            }
+                            else if ((idx + round) % 3 == 0)
+                            {
+                                writer.numErrors += writer.map->remove(epochThread, key) == writer.present[idx] ? 0 : 1;
+                                writer.present[idx] = false;
+                            }
+                            else
+                            {
+                                writer.numErrors += writer.map->insertOverwrite(epochThread, key, Entry(key)) ? 0 : 1;
+                                writer.present[idx] = true;
+                            }
+                        }
+                    }
+                    // All writers race to insert the same keys, and only one must succeed for every key
+                    for (int32_t key = NumKeys; key < NumKeys + 1000; ++key)
+                    {
+                        writer.numInserted += writer.map->insertIfNotExists(epochThread, key, Entry(key)) ? 1 : 0;
+                    }
+                    (void)writer.domain->unregisterThread(epochThread);
+                }));
+        }
+        int32_t numErrors   = 0;
+        int32_t numInserted = 0;
+        for (Writer& writer : writers)
+        {
+            SC_TEST_EXPECT(writer.thread.join());
+            numErrors += writer.numErrors;
+            numInserted += writer.numInserted;
+        }
+        stop.store(true);
+        for (Reader& reader : readers)
+        {
+            SC_TEST_EXPECT(reader.thread.join());
+            numErrors += reader.numErrors;
+        }
+        SC_TEST_EXPECT(numErrors == 0);
+        SC_TEST_EXPECT(numInserted == 1000);
+
+        // Final content must match what every writer expects
+        EpochThread thread;
+        SC_TEST_EXPECT(domain.registerThread(thread));
+        {
+            EpochGuard guard(domain, thread);
+            size_t     numPresent = 1000;
+            bool       matching   = true;
+            for (const Writer& writer : writers)
+            {
+                for (int32_t idx = 0; idx < NumKeys / NumWriters; ++idx)
+                {
+                    const int32_t key   = idx * NumWriters + writer.index;
+                    const Entry*  entry = map.get(key);
+                    matching = matching and (writer.present[idx] ? entry and entry->isValid(key) : entry == nullptr);
+                    numPresent += writer.present[idx] ? 1 : 0;
+                }
+            }
+            SC_TEST_EXPECT(matching);
+            SC_TEST_EXPECT(map.size() == numPresent);
+        }
+        SC_TEST_EXPECT(domain.unregisterThread(thread));
+    }
+    SC_TEST_EXPECT(domain.destroy());
+    SC_TEST_EXPECT(Entry::numInstances().load() == 0);
+}
+
+void SC::ConcurrentHashMapTest::testGrowingReaders()
+{
+    static constexpr int     NumReaders = 4;
+    static constexpr int32_t NumStable  = 64;    // Inserted before readers start and never removed
+    static constexpr int32_t NumGrowing = 20000; // Inserted while readers run, forcing many growths
+    static constexpr int32_t NumRepeats = 4;
+
+    using Map = ConcurrentHashMap<int32_t, Entry>;
+    EpochDomain domain;
+    EpochThread thread;
+    SC_TEST_EXPECT(domain.registerThread(thread));
+    for (int32_t repeat = 0; repeat < NumRepeats; ++repeat)
+    {
+        Map map(domain);
+        SC_TEST_EXPECT(map.init());
+        bool inserted = true;
+        for (int32_t key = 0; key < NumStable; ++key)
+        {
+            inserted = inserted and map.insertIfNotExists(thread, key, Entry(key));
+        }
+        SC_TEST_EXPECT(inserted);
+
+        Atomic<bool> stop = false;
+        struct Reader
+        {
+            EpochDomain*  domain = nullptr;
+            Map*          map    = nullptr;
+            Atomic<bool>* stop   = nullptr;
+
+            int32_t numErrors = 0;
+            Thread  thread;
+        } readers[NumReaders];
+
+        for (Reader& reader : readers)
+        {
+            reader.domain = &domain;
+            reader.map    = &map;
+            reader.stop   = &stop;
+            SC_TEST_EXPECT(reader.thread.start(
+                [&reader](Thread&)
+                {
+                    EpochThread epochThread;
+                    if (not reader.domain->registerThread(epochThread))
+                    {
+                        reader.numErrors++;
+                        return;
+                    }
+                    while (not reader.stop->load(memory_order_relaxed))
+                    {
+                        for (int32_t key = 0; key < NumStable; ++key)
+                        {
+                            // Keys that are never removed must be found even while being moved to a new table
+                            EpochGuard   guard(*reader.domain, epochThread);
+                            const Entry* entry = reader.map->get(key);
+                            reader.numErrors += entry != nullptr and entry->isValid(key) ? 0 : 1;
+                        }
+                    }
+                    (void)reader.domain->unregisterThread(epochThread);
+                }));
+        }
+        for (int32_t key = NumStable; key < NumStable + NumGrowing; ++key)
+        {
+            inserted = inserted and map.insertIfNotExists(thread, key, Entry(key));
+        }
+        stop.store(true);
+        int32_t numErrors = 0;
+        for (Reader& reader : readers)
+        {
+            SC_TEST_EXPECT(reader.thread.join());
+            numErrors += reader.numErrors;
+        }
+        SC_TEST_EXPECT(inserted);
+        SC_TEST_EXPECT(numErrors == 0);
+        SC_TEST_EXPECT(map.capacity() >= NumStable + NumGrowing);
+    }
+    domain.synchronize();
+    SC_TEST_EXPECT(domain.unregisterThread(thread));
+    SC_TEST_EXPECT(domain.destroy());
+    SC_TEST_EXPECT(Entry::numInstances().load() == 0);
+}
+
+void SC::ConcurrentHashMapTest::concurrentHashMapSnippet()
+{
+    //! [concurrentHashMapSnippet]
+    // A cache of symbols read by all workers of a thread pool and written rarely
+    EpochDomain                         domain;
+    ConcurrentHashMap<String, uint64_t> symbols(domain);
+    SC_TEST_EXPECT(symbols.init(1024)); // Grows as needed (or pass caller provided slots and nodes)
+
+    ThreadPool threadPool;
+    SC_TEST_EXPECT(threadPool.create(4));
+
+    struct Lookup
+    {
+        EpochDomain*                         domain  = nullptr;
+        ConcurrentHashMap<String, uint64_t>* symbols = nullptr;
+        StringView                           name;
+        uint64_t                             address = 0;
+        ThreadPool::Task                     task;
+    } lookups[4];
+    const StringView names[] = {"main", "printf", "main", "malloc"};
+
+    for (int idx = 0; idx < 4; ++idx)
+    {
+        Lookup& lookup       = lookups[idx];
+        lookup.domain        = &domain;
+        lookup.symbols       = &symbols;
+        lookup.name          = names[idx];
+        lookup.task.function = [&lookup]()
+        {
+            EpochThread thread;
+            if (not lookup.domain->registerThread(thread))
+                return;
+            {
+                // Readers don't take any lock
+                EpochGuard      guard(*lookup.domain, thread);
+                const uint64_t* address = lookup.symbols->get(lookup.name);
+                lookup.address          = address ? *address : 0;
+            }
+            if (lookup.address == 0)
+            {
+                // Writers take a lock shared with just a few other keys (1 in ConcurrentHashMap::NumStripes)
+                lookup.address = lookup.name.sizeInBytes() * 0x1000; // "Resolving" the symbol
+                (void)lookup.symbols->insertIfNotExists(thread, String(lookup.name), lookup.address);
+            }
+            (void)lookup.domain->unregisterThread(thread);
+        };
+        SC_TEST_EXPECT(threadPool.queueTask(lookup.task));
+    }
+    SC_TEST_EXPECT(threadPool.waitForAllTasks());
+    SC_TEST_EXPECT(symbols.size() == 3);
+    SC_TEST_EXPECT(lookups[0].address == lookups[2].address);
+    //! [concurrentHashMapSnippet]
+}
+
+namespace SC
+{
+void runConcurrentHashMapTest(SC::TestReport& report) { ConcurrentHashMapTest test(report); }
+} // namespace SC
@@ -0,0 +1,100 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../CpuTopology.h"
+#include "../../Testing/Testing.h"
+
+namespace SC
+{
+struct CpuTopologyTest;
+}
+
+struct SC::CpuTopologyTest : public SC::TestCase
+{
+    inline void testDetect();
+    inline void testManual();
+
+    CpuTopologyTest(SC::TestReport& report) : TestCase(report, "CpuTopologyTest")
+    {
+        if (test_section("detect"))
+        {
+            testDetect();
+        }
+        if (test_section("manual"))
+        {
+            testManual();
+        }
+    }
+};
+
+void SC::CpuTopologyTest::testDetect()
+{
+    //! [cpuTopologySnippet]
+    CpuTopology topology;
+    SC_TEST_EXPECT(topology.detect());
+    SC_TEST_EXPECT(topology.getNumCpus() > 0);
+    SC_TEST_EXPECT(topology.getNumCores() > 0 and topology.getNumCores() <= topology.getNumCpus());
+    SC_TEST_EXPECT(topology.getNumNodes() > 0 and topology.getNumNodes() <= topology.getNumCores());
+
+    // Every processor belongs to exactly one core, and every core to exactly one node
+    uint32_t numCpusInCores = 0;
+    for (uint32_t core = 0; core < topology.getNumCores(); ++core)
+    {
+        const CpuSet coreCpus = topology.getCoreCpus(core);
+        SC_TEST_EXPECT(not coreCpus.isEmpty());
+        numCpusInCores += coreCpus.count();
+    }
+    SC_TEST_EXPECT(numCpusInCores == topology.getNumCpus());
+
+    uint32_t numCpusInNodes = 0;
+    for (uint32_t node = 0; node < topology.getNumNodes(); ++node)
+    {
+        numCpusInNodes += topology.getNodeCpus(node).count();
+    }
+    SC_TEST_EXPECT(numCpusInNodes == topology.getNumCpus());
+    //! [cpuTopologySnippet]
+
+#if SC_PLATFORM_LINUX
+    // Caches are always described in /sys (unless running in some very restricted container)
+    SC_TEST_EXPECT(topology.l1DataCacheSize == 0 or topology.cacheLineSize > 0);
+#endif
+}
+
+void SC::CpuTopologyTest::testManual()
+{
+    // Two nodes with two cores each, with two SMT siblings numbered like Linux does (0-3 first, then siblings 4-7)
+    CpuTopology topology;
+    for (uint32_t cpu = 0; cpu < 8; ++cpu)
+    {
+        const uint32_t coreId = 100 + cpu % 4;
+        const uint32_t nodeId = (cpu % 4) < 2 ? 7 : 3;
+        SC_TEST_EXPECT(topology.addCpu(cpu, coreId, nodeId));
+    }
+    SC_TEST_EXPECT(topology.getNumCpus() == 8);
+    SC_TEST_EXPECT(topology.getNumCores() == 4);
+    SC_TEST_EXPECT(topology.getNumNodes() == 2);
+
+    uint32_t core = 0, node = 0;
+    SC_TEST_EXPECT(topology.getCpu(5, core, node));
+    SC_TEST_EXPECT(core == 1 and node == 0);
+    SC_TEST_EXPECT(topology.getCpu(6, core, node));
+    SC_TEST_EXPECT(core == 2 and node == 1);
+    SC_TEST_EXPECT(not topology.getCpu(8, core, node));
+
+    const CpuSet siblings = topology.getCoreCpus(2);
+    SC_TEST_EXPECT(siblings.count() == 2 and siblings.contains(2) and siblings.contains(6));
+    const CpuSet nodeCpus = topology.getNodeCpus(1);
+    SC_TEST_EXPECT(nodeCpus.count() == 4 and nodeCpus.contains(3) and nodeCpus.contains(7));
+    SC_TEST_EXPECT(topology.getCoreNode(3) == 1);
+
+    SC_TEST_EXPECT(not topology.addCpu(3, 100, 7));                  // Already added
+    SC_TEST_EXPECT(not topology.addCpu(8, 100, 3));                  // Core on a different node
+    SC_TEST_EXPECT(not topology.addCpu(CpuTopology::MaxCpus, 0, 0)); // Invalid processor
+
+    topology.clear();
+    SC_TEST_EXPECT(topology.getNumCpus() == 0 and topology.getNumCores() == 0 and topology.getNumNodes() == 0);
+}
+
+namespace SC
+{
+void runCpuTopologyTest(SC::TestReport& report) { CpuTopologyTest test(report); }
+} // namespace SC
@@ -0,0 +1,402 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../EpochReclamation.h"
+#include "../../Testing/Testing.h"
+
+namespace SC
+{
+struct EpochReclamationTest;
+}
+
+struct SC::EpochReclamationTest : public SC::TestCase
+{
+    inline void testEpochDomain();
+    inline void testRcuPointer();
+    inline void testStress();
+
+    EpochReclamationTest(SC::TestReport& report) : TestCase(report, "EpochReclamationTest")
+    {
+        if (test_section("EpochDomain"))
+        {
+            testEpochDomain();
+        }
+        if (test_section("RcuPointer"))
+        {
+            testRcuPointer();
+        }
+        if (test_section("stress"))
+        {
+            testStress();
+        }
+    }
+};
+
+void SC::EpochReclamationTest::testEpochDomain()
+{
+    //! [epochDomainSnippet]
+    struct Node : public EpochRetired
+    {
+        int  value     = 0;
+        bool reclaimed = false; // Instead of freeing the node, for the purpose of this test
+
+        static void release(EpochRetired& retired) { static_cast<Node&>(retired).reclaimed = true; }
+    };
+    Node first, second;
+    first.value    = 1;
+    first.reclaim  = &Node::release;
+    second.value   = 2;
+    second.reclaim = &Node::release;
+
+    EpochDomain   domain;
+    Atomic<Node*> shared = &first; // Some shared data, read without locks
+
+    // A reader thread obtains the shared node inside a read section, and keeps using it until leaving the section
+    struct Reader
+    {
+        EpochDomain*   domain = nullptr;
+        Atomic<Node*>* shared = nullptr;
+        EventObject    entered, writerDone;
+        int            value = 0;
+    } reader;
+    reader.domain = &domain;
+    reader.shared = &shared;
+
+    Thread readerThread;
+    SC_TEST_EXPECT(readerThread.start(
+        [&reader](Thread&)
+        {
+            EpochThread epochThread;
+            if (reader.domain->registerThread(epochThread))
+            {
+                {
+                    EpochGuard guard(*reader.domain, epochThread);
+                    Node*      node = reader.shared->load(memory_order_acquire);
+                    reader.entered.signal();
+                    reader.writerDone.wait();   // Meanwhile, node is replaced and retired by the writer
+                    reader.value = node->value; // ...but it can't be reclaimed until the reader leaves the section
+                }
+                (void)reader.domain->unregisterThread(epochThread);
+            }
+        }));
+    reader.entered.wait();
+
+    // The writer (this thread) replaces the shared node and retires the old one
+    EpochThread writerThread;
+    SC_TEST_EXPECT(domain.registerThread(writerThread));
+    Node* old = shared.exchange(&second);
+    domain.retire(writerThread, *old);
+    for (int idx = 0; idx < 10; ++idx)
+    {
+        SC_TEST_EXPECT(domain.collect());
+    }
+    SC_TEST_EXPECT(not first.reclaimed); // Reader is still inside its read section
+    SC_TEST_EXPECT(domain.getNumRetired() == 1);
+    reader.writerDone.signal();
+    SC_TEST_EXPECT(readerThread.join());
+    SC_TEST_EXPECT(reader.value == 1);
+
+    domain.synchronize(); // Waits until all objects retired so far have been reclaimed
+    SC_TEST_EXPECT(first.reclaimed and not second.reclaimed);
+    SC_TEST_EXPECT(domain.getNumRetired() == 0);
+    SC_TEST_EXPECT(domain.unregisterThread(writerThread));
+    //! [epochDomainSnippet]
+
+    // Read sections can be nested
+    SC_TEST_EXPECT(domain.registerThread(writerThread));
+    SC_TEST_EXPECT(not domain.registerThread(writerThread));
+    domain.enter(writerThread);
+    domain.enter(writerThread);
+    domain.leave(writerThread);
+    SC_TEST_EXPECT(writerThread.isReading());
+    SC_TEST_EXPECT(not domain.unregisterThread(writerThread)); // Inside a read section
+    const uint64_t epoch = domain.getEpoch();
+    for (int idx = 0; idx < 4; ++idx)
+    {
+        SC_TEST_EXPECT(domain.collect());
+    }
+    SC_TEST_EXPECT(domain.getEpoch() == epoch + 1); // Blocked by this thread reading since previous epoch
+    domain.leave(writerThread);
+    SC_TEST_EXPECT(not writerThread.isReading());
+
+    // Objects retired by an unregistered thread are handed over to the domain, that reclaims them on destroy
+    second.reclaim = &Node::release;
+    domain.retire(writerThread, second);
+    SC_TEST_EXPECT(not domain.destroy()); // A thread is still registered
+    SC_TEST_EXPECT(domain.unregisterThread(writerThread));
+    SC_TEST_EXPECT(not writerThread.isRegistered());
+    SC_TEST_EXPECT(domain.destroy());
+    SC_TEST_EXPECT(second.reclaimed);
+}
+
+void SC::EpochReclamationTest::testRcuPointer()
+{
+    static constexpr int NumReaders = 4;
+    static constexpr int NumUpdates = 2000;
+
+    //! [rcuPointerSnippet]
+    // Read-mostly data, that must always be seen in a consistent state by readers
+    struct Config
+    {
+        int port    = 80;
+        int retries = 160; // Always 2 * port
+
+        static Atomic<int32_t>& numInstances()
+        {
+            static Atomic<int32_t> instances;
+            return instances;
+        }
+        Config() { numInstances().fetch_add(1); }
+        Config(const Config& other) : port(other.port), retries(other.retries) { numInstances().fetch_add(1); }
+        ~Config() { numInstances().fetch_sub(1); }
+    };
+    ThreadPool threadPool;
+    SC_TEST_EXPECT(threadPool.create(1));
+
+    EpochDomain domain;
+    SC_TEST_EXPECT(domain.setThreadPool(threadPool, 16)); // Retired versions are freed by a task of the pool
+    {
+        RcuPointer<Config> config(domain);
+        SC_TEST_EXPECT(config.load() == nullptr and config.getVersion() == 0);
+
+        EpochThread writer;
+        SC_TEST_EXPECT(domain.registerThread(writer));
+        SC_TEST_EXPECT(config.store(writer, Config()));
+
+        struct Reader
+        {
+            EpochDomain*        domain = nullptr;
+            RcuPointer<Config>* config = nullptr;
+            Atomic<bool>*       stop   = nullptr;
+
+            int32_t  numErrors = 0;
+            uint64_t numReads  = 0;
+            Thread   thread;
+        };
+        Atomic<bool> stop = false;
+        Reader       readers[NumReaders];
+        for (Reader& reader : readers)
+        {
+            reader.domain = &domain;
+            reader.config = &config;
+            reader.stop   = &stop;
+            SC_TEST_EXPECT(reader.thread.start(
+                [&reader](Thread&)
+                {
+                    EpochThread readerThread;
+                    if (not reader.domain->registerThread(readerThread))
+                    {
+                        reader.numErrors++;
+                        return;
+                    }
+                    uint64_t lastVersion = 0;
+                    while (not reader.stop->load(memory_order_relaxed))
+                    {
+                        EpochGuard    guard(*reader.domain, readerThread);
+                        uint64_t      version;
+                        const Config* current = reader.config->load(version);
+                        // Versions never go back, and values are never seen half updated (or freed)
+                        if (current->retries != 2 * current->port or version < lastVersion)
+                        {
+                            reader.numErrors++;
+                        }
+                        lastVersion = version;
+                        reader.numReads++;
+                    }
+                    (void)reader.domain->unregisterThread(readerThread);
+                }));
+        }
+        // Writers publish modified copies, without ever blocking readers
+        for (int idx = 0; idx < NumUpdates; ++idx)
+        {
+            SC_TEST_EXPECT(config.update(writer,
+                                         [](Config& copy)
+                                         {
+                                             copy.port += 1;
+                                             copy.retries = 2 * copy.port;
+                                         }));
+            if (idx % 256 == 0)
+            {
+                Thread::Sleep(1); // Lets readers run on machines with a few processors
+            }
+        }
+        stop.store(true);
+        for (Reader& reader : readers)
+        {
+            SC_TEST_EXPECT(reader.thread.join());
+            SC_TEST_EXPECT(reader.numErrors == 0);
+        }
+        SC_TEST_EXPECT(config.getVersion() == NumUpdates + 1);
+        SC_TEST_EXPECT(config.load()->port == 80 + NumUpdates);
+
+        domain.synchronize(); // All retired versions are freed
+        SC_TEST_EXPECT(Config::numInstances().load() == 1);
+        SC_TEST_EXPECT(domain.unregisterThread(writer));
+    } // RcuPointer destructor frees current version
+    SC_TEST_EXPECT(Config::numInstances().load() == 0);
+    SC_TEST_EXPECT(domain.destroy());
+    SC_TEST_EXPECT(threadPool.destroy());
+    //! [rcuPointerSnippet]
+}
+
+void SC::EpochReclamationTest::testStress()
+{
+    // Readers check that objects they obtain inside read sections are never reclaimed before they leave the section.
+    // Objects are not freed (but just flagged) on reclaim, so that a premature reclamation can be detected.
+    static constexpr int      NumReaders      = 4;
+    static constexpr int      NumWriters      = 2;
+    static constexpr int      NumSlots        = 8;
+    static constexpr int      NumReplacements = 5000; // For every writer
+    static constexpr uint32_t Alive           = 0xA11CE;
+    static constexpr uint32_t Reclaimed       = 0xDEAD;
+
+    struct Object : public EpochRetired
+    {
+        Atomic<uint32_t> state = 0;
+
+        static void release(EpochRetired& retired)
+        {
+            static_cast<Object&>(retired).state.store(Reclaimed, memory_order_relaxed);
+        }
+    };
+    struct Shared
+    {
+        EpochDomain      domain;
+        Atomic<Object*>  slots[NumSlots];
+        Object*          objects     = nullptr;
+        Atomic<uint32_t> nextObject  = 0;
+        Atomic<bool>     stop        = false;
+        Atomic<int32_t>  numErrors   = 0;
+        Atomic<uint64_t> numReads    = 0;
+        Atomic<int32_t>  numFinished = 0;
+    };
+    struct Participant
+    {
+        Shared* shared = nullptr;
+        int     index  = 0;
+        Thread  thread;
+    };
+
+    static constexpr uint32_t NumObjects = NumSlots + NumWriters * NumReplacements;
+
+    Shared shared;
+    shared.objects = static_cast<Object*>(Memory::allocate(sizeof(Object) * NumObjects));
+    SC_TEST_EXPECT(shared.objects != nullptr);
+    if (shared.objects == nullptr)
+        return;
+    for (uint32_t idx = 0; idx < NumObjects; ++idx)
+    {
+        Object* object  = new (&shared.objects[idx], PlacementNew()) Object();
+        object->reclaim = &Object::release;
+    }
+    for (Atomic<Object*>& slot : shared.slots)
+    {
+        Object* object = &shared.objects[shared.nextObject.fetch_add(1)];
+        object->state.store(Alive);
+        slot.store(object);
+    }
+
+    ThreadPool threadPool;
+    SC_TEST_EXPECT(threadPool.create(2, ThreadPool::Scheduling::WorkStealing));
+    SC_TEST_EXPECT(shared.domain.setThreadPool(threadPool, 32));
+
+    Participant readers[NumReaders];
+    Participant writers[NumWriters];
+    for (int idx = 0; idx < NumReaders; ++idx)
+    {
+        readers[idx].shared = &shared;
+        readers[idx].index  = idx;
+        SC_TEST_EXPECT(readers[idx].thread.start(
+            [&participant = readers[idx]](Thread&)
+            {
+                Shared&     shared = *participant.shared;
+                EpochThread epochThread;
+                if (not shared.domain.registerThread(epochThread))
+                {
+                    shared.numErrors.fetch_add(1);
+                    return;
+                }
+                uint32_t random = static_cast<uint32_t>(participant.index) * 2654435761u + 1;
+                uint64_t reads  = 0;
+                while (not shared.stop.load(memory_order_relaxed))
+                {
+                    shared.domain.enter(epochThread);
+                    random ^= random << 13;
+                    random ^= random >> 17;
+                    random ^= random << 5;
+                    Object* object = shared.slots[random % NumSlots].load(memory_order_acquire);
+                    for (int check = 0; check < 4; ++check)
+                    {
+                        if (object->state.load(memory_order_relaxed) != Alive)
+                        {
+                            shared.numErrors.fetch_add(1);
+                        }
+                    }
+                    shared.domain.leave(epochThread);
+                    reads++;
+                }
+                shared.numReads.fetch_add(reads);
+                (void)shared.domain.unregisterThread(epochThread);
+            }));
+    }
+    for (int idx = 0; idx < NumWriters; ++idx)
+    {
+        writers[idx].shared = &shared;
+        writers[idx].index  = idx;
+        SC_TEST_EXPECT(writers[idx].thread.start(
+            [&participant = writers[idx]](Thread&)
+            {
+                Shared&     shared = *participant.shared;
+                EpochThread epochThread;
+                if (not shared.domain.registerThread(epochThread))
+                {
+                    shared.numErrors.fetch_add(1);
+                    return;
+                }
+                for (int idx = 0; idx < NumReplacements; ++idx)
+                {
+                    Object* object = &shared.objects[shared.nextObject.fetch_add(1)];
+                    object->state.store(Alive, memory_order_relaxed);
+                    Object* old = shared.slots[(idx + participant.index) % NumSlots].exchange(object);
+                    shared.domain.retire(epochThread, *old);
+                    if (idx % 512 == 0)
+                    {
+                        Thread::Sleep(0);
+                    }
+                }
+                (void)shared.domain.unregisterThread(epochThread);
+                shared.numFinished.fetch_add(1);
+            }));
+    }
+    for (Participant& writer : writers)
+    {
+        SC_TEST_EXPECT(writer.thread.join());
+    }
+    shared.stop.store(true);
+    for (Participant& reader : readers)
+    {
+        SC_TEST_EXPECT(reader.thread.join());
+    }
+    SC_TEST_EXPECT(shared.numErrors.load() == 0);
+    SC_TEST_EXPECT(shared.numFinished.load() == NumWriters);
+
+    shared.domain.synchronize();
+    SC_TEST_EXPECT(shared.domain.getNumRetired() == 0);
+    uint32_t numReclaimed = 0;
+    for (uint32_t idx = 0; idx < NumObjects; ++idx)
+    {
+        numReclaimed += shared.objects[idx].state.load() == Reclaimed ? 1 : 0;
+    }
+    SC_TEST_EXPECT(numReclaimed == NumWriters * NumReplacements); // Only objects still in slots are alive
+    SC_TEST_EXPECT(shared.domain.destroy());
+    SC_TEST_EXPECT(threadPool.destroy());
+    for (uint32_t idx = 0; idx < NumObjects; ++idx)
+    {
+        shared.objects[idx].~Object();
+    }
+    Memory::release(shared.objects);
+}
+
+namespace SC
+{
+void runEpochReclamationTest(SC::TestReport& report) { EpochReclamationTest test(report); }
+} // namespace SC
@@ -0,0 +1,224 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../JobSystem.h"
+#include "../../Testing/Testing.h"
+
+namespace SC
+{
+struct JobSystemTest;
+}
+
+struct SC::JobSystemTest : public SC::TestCase
+{
+    inline void testJobs();
+    inline void testWait();
+    inline void testStack();
+    inline void testErrors();
+
+    JobSystemTest(SC::TestReport& report) : TestCase(report, "JobSystemTest")
+    {
+        if (test_section("jobs"))
+        {
+            testJobs();
+        }
+        if (test_section("wait"))
+        {
+            testWait();
+        }
+        if (test_section("stack"))
+        {
+            testStack();
+        }
+        if (test_section("errors"))
+        {
+            testErrors();
+        }
+    }
+};
+
+void SC::JobSystemTest::testJobs()
+{
+    //! [jobSystemSnippet]
+    JobSystem::Options options;
+    options.numWorkers = 4;
+    options.numFibers  = 32;
+
+    JobSystem jobSystem;
+    SC_TEST_EXPECT(jobSystem.create(options));
+    SC_TEST_EXPECT(jobSystem.getNumWorkers() == 4);
+
+    // Jobs must outlive their execution, as the job system doesn't allocate any memory for them
+    static constexpr int NumJobs = 1000;
+
+    Job             jobs[NumJobs];
+    Atomic<int32_t> sum = 0;
+    for (int idx = 0; idx < NumJobs; ++idx)
+    {
+        jobs[idx].function = [&sum, idx]() { sum.fetch_add(idx); };
+    }
+    JobCounter counter;
+    SC_TEST_EXPECT(jobSystem.run(jobs, counter));
+    counter.wait(); // Blocks this thread (that is not a job) until all jobs are done
+    SC_TEST_EXPECT(sum.load() == NumJobs * (NumJobs - 1) / 2);
+    SC_TEST_EXPECT(counter.getValue() == 0);
+    //! [jobSystemSnippet]
+
+    // Jobs can be queued again after their counter has reached zero
+    for (int run = 0; run < 10; ++run)
+    {
+        SC_TEST_EXPECT(jobSystem.run(jobs, counter));
+        counter.wait();
+    }
+    SC_TEST_EXPECT(sum.load() == 11 * NumJobs * (NumJobs - 1) / 2);
+    SC_TEST_EXPECT(jobSystem.destroy());
+    SC_TEST_EXPECT(jobSystem.destroy()); // Destroying twice is fine
+}
+
+void SC::JobSystemTest::testWait()
+{
+    // Every parent job queues children and waits for them, suspending its fiber and letting workers run children
+    static constexpr int NumParents  = 16;
+    static constexpr int NumChildren = 8;
+
+    struct Parent
+    {
+        JobSystem*      jobSystem = nullptr;
+        Atomic<int32_t> numErrors = 0;
+
+        Job        children[NumChildren];
+        JobCounter childrenCounter;
+        int32_t    results[NumChildren];
+        int32_t    sum = 0;
+    };
+    JobSystem::Options options;
+    options.numWorkers = 2; // Much less workers than jobs waiting at the same time
+    options.numFibers  = NumParents + 4;
+
+    JobSystem jobSystem;
+    SC_TEST_EXPECT(jobSystem.create(options));
+
+    Parent parents[NumParents];
+    Job    parentJobs[NumParents];
+    for (int idx = 0; idx < NumParents; ++idx)
+    {
+        Parent& parent   = parents[idx];
+        parent.jobSystem = &jobSystem;
+        for (int child = 0; child < NumChildren; ++child)
+        {
+            int32_t* result                 = &parent.results[child];
+            parent.children[child].function = [result, child]() { *result = child + 1; };
+        }
+        parentJobs[idx].function = [&parent]()
+        {
+            if (not parent.jobSystem->run(parent.children, parent.childrenCounter))
+            {
+                parent.numErrors.fetch_add(1);
+            }
+            parent.childrenCounter.wait(); // Suspends the fiber, without blocking the worker thread
+            for (int32_t result : parent.results)
+            {
+                parent.sum += result;
+            }
+        };
+    }
+    for (int run = 0; run < 20; ++run)
+    {
+        JobCounter counter;
+        SC_TEST_EXPECT(jobSystem.run(parentJobs, counter));
+        counter.wait();
+        for (Parent& parent : parents)
+        {
+            SC_TEST_EXPECT(parent.sum == NumChildren * (NumChildren + 1) / 2);
+            SC_TEST_EXPECT(parent.numErrors.load() == 0);
+            parent.sum = 0;
+        }
+    }
+
+    // A job can wait on a counter incremented and decremented manually (for example by another thread)
+    JobCounter event;
+    event.increment();
+    Job waiter;
+    int value       = 0;
+    waiter.function = [&event, &value]()
+    {
+        event.wait();
+        value = 42;
+    };
+    JobCounter waiterCounter;
+    SC_TEST_EXPECT(jobSystem.run(waiter, waiterCounter));
+    Thread signaling;
+    SC_TEST_EXPECT(signaling.start(
+        [&event](Thread&)
+        {
+            Thread::Sleep(10);
+            event.decrement();
+        }));
+    waiterCounter.wait();
+    SC_TEST_EXPECT(signaling.join());
+    SC_TEST_EXPECT(value == 42);
+    SC_TEST_EXPECT(jobSystem.destroy());
+}
+
+void SC::JobSystemTest::testStack()
+{
+    JobSystem::Options options;
+    options.numWorkers     = 1;
+    options.numFibers      = 2;
+    options.fiberStackSize = 128 * 1024;
+
+    JobSystem jobSystem;
+    SC_TEST_EXPECT(jobSystem.create(options));
+
+    // Uses a good part of the fiber stack
+    struct Recursion
+    {
+        static int sum(int depth)
+        {
+            volatile char buffer[1024];
+            buffer[0] = static_cast<char>(depth);
+            return depth == 0 ? buffer[0] : buffer[0] + sum(depth - 1);
+        }
+    };
+    int result = 0;
+    Job job;
+    job.function = [&result]() { result = Recursion::sum(64); };
+    JobCounter counter;
+    SC_TEST_EXPECT(jobSystem.run(job, counter));
+    counter.wait();
+    SC_TEST_EXPECT(result == 64 * 65 / 2);
+    SC_TEST_EXPECT(jobSystem.destroy());
+}
+
+void SC::JobSystemTest::testErrors()
+{
+    JobSystem  jobSystem;
+    Job        job;
+    JobCounter counter;
+    job.function = []() {};
+    SC_TEST_EXPECT(not jobSystem.run(job, counter)); // Not created
+
+    JobSystem::Options options;
+    options.numWorkers = 1;
+    options.numFibers  = 0;
+    SC_TEST_EXPECT(not jobSystem.create(options));
+    options.numFibers = 1;
+    SC_TEST_EXPECT(jobSystem.create(options));
+    SC_TEST_EXPECT(not jobSystem.create(options)); // Already created
+
+    Job jobs[2];
+    jobs[0].function = []() {};
+    jobs[1].function = []() {};
+    Job sameJobTwice[1];
+    sameJobTwice[0].function = []() { Thread::Sleep(10); };
+    SC_TEST_EXPECT(jobSystem.run(sameJobTwice, counter));
+    SC_TEST_EXPECT(not jobSystem.run(sameJobTwice, counter)); // Already queued
+    counter.wait();
+    SC_TEST_EXPECT(jobSystem.run(jobs, counter)); // A single fiber runs jobs one after the other
+    counter.wait();
+    SC_TEST_EXPECT(jobSystem.destroy());
+}
+
+namespace SC
+{
+void runJobSystemTest(SC::TestReport& report) { JobSystemTest test(report); }
+} // namespace SC
@@ -0,0 +1,184 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../LockFreeQueue.h"
+#include "../../Testing/Testing.h"
+#include "../Threading.h"
+
+namespace SC
+{
+struct LockFreeQueueTest;
+}
+
+struct SC::LockFreeQueueTest : public SC::TestCase
+{
+    inline void testSPSCQueue();
+    inline void testMPMCQueue();
+
+    LockFreeQueueTest(SC::TestReport& report) : TestCase(report, "LockFreeQueueTest")
+    {
+        if (test_section("SPSCQueue"))
+        {
+            testSPSCQueue();
+        }
+        if (test_section("MPMCQueue"))
+        {
+            testMPMCQueue();
+        }
+    }
+};
+
+void SC::LockFreeQueueTest::testSPSCQueue()
+{
+    //! [spscQueueSnippet]
+    uint32_t            storage[64]; // Caller owned ring buffer (power of two)
+    SPSCQueue<uint32_t> queue;
+    SC_TEST_EXPECT(queue.init(storage));
+    SC_TEST_EXPECT(queue.capacity() == 64);
+
+    static constexpr uint32_t NumValues = 200000;
+
+    // Producer thread pushes a sequence of numbers, retrying when the queue is full
+    Thread producer;
+    SC_TEST_EXPECT(producer.start(
+        [&queue](Thread&)
+        {
+            for (uint32_t idx = 0; idx < NumValues; ++idx)
+            {
+                while (not queue.tryPush(idx))
+                {
+                    Thread::Sleep(0);
+                }
+            }
+        }));
+    // Consumer (this thread) receives them in the same order
+    bool inOrder = true;
+    for (uint32_t idx = 0; idx < NumValues; ++idx)
+    {
+        uint32_t value;
+        while (not queue.tryPop(value))
+        {
+            Thread::Sleep(0);
+        }
+        inOrder = inOrder and value == idx;
+    }
+    SC_TEST_EXPECT(producer.join());
+    SC_TEST_EXPECT(inOrder);
+    //! [spscQueueSnippet]
+
+    uint32_t value;
+    SC_TEST_EXPECT(not queue.tryPop(value)); // Empty
+    for (uint32_t idx = 0; idx < 64; ++idx)
+    {
+        SC_TEST_EXPECT(queue.tryPush(idx));
+    }
+    SC_TEST_EXPECT(not queue.tryPush(64u)); // Full
+    SC_TEST_EXPECT(queue.tryPop(value) and value == 0);
+    SC_TEST_EXPECT(queue.tryPush(64u));
+
+    uint32_t wrongSize[3];
+    SC_TEST_EXPECT(not queue.init(wrongSize));
+}
+
+void SC::LockFreeQueueTest::testMPMCQueue()
+{
+    static constexpr uint32_t NumThreads = 4;       // Producers and consumers
+    static constexpr uint32_t NumValues  = 50000;   // Pushed by every producer
+    static constexpr uint32_t Tag        = 1 << 24; // Values are tagged with producer index
+
+    struct Context
+    {
+        MPMCQueue<uint32_t> queue;
+        Atomic<uint32_t>    numPopped = 0;
+        Atomic<uint64_t>    sum       = 0;
+        Atomic<int32_t>     numErrors = 0;
+    };
+    struct Producer
+    {
+        Context* context = nullptr;
+        uint32_t index   = 0;
+        Thread   thread;
+    };
+    struct Consumer
+    {
+        Context* context = nullptr;
+        uint32_t lastValue[NumThreads];
+        Thread   thread;
+    };
+
+    //! [mpmcQueueSnippet]
+    MPMCQueue<uint32_t>::Cell cells[128]; // Caller owned ring buffer (power of two)
+
+    Context context;
+    SC_TEST_EXPECT(context.queue.init(cells));
+    //! [mpmcQueueSnippet]
+
+    Producer producers[NumThreads];
+    Consumer consumers[NumThreads];
+    for (uint32_t idx = 0; idx < NumThreads; ++idx)
+    {
+        Consumer& consumer = consumers[idx];
+        consumer.context   = &context;
+        for (uint32_t& last : consumer.lastValue)
+        {
+            last = 0;
+        }
+        SC_TEST_EXPECT(consumer.thread.start(
+            [&consumer](Thread&)
+            {
+                Context& ctx = *consumer.context;
+                while (ctx.numPopped.load(memory_order_relaxed) < NumThreads * NumValues)
+                {
+                    uint32_t value;
+                    if (not ctx.queue.tryPop(value))
+                    {
+                        Thread::Sleep(0);
+                        continue;
+                    }
+                    ctx.numPopped.fetch_add(1);
+                    ctx.sum.fetch_add(value % Tag, memory_order_relaxed);
+                    // Values of a given producer must be popped in the same order they've been pushed
+                    uint32_t& last = consumer.lastValue[value / Tag];
+                    if (value % Tag <= last)
+                    {
+                        ctx.numErrors.fetch_add(1);
+                    }
+                    last = value % Tag;
+                }
+            }));
+    }
+    for (uint32_t idx = 0; idx < NumThreads; ++idx)
+    {
+        Producer& producer = producers[idx];
+        producer.context   = &context;
+        producer.index     = idx;
+        SC_TEST_EXPECT(producer.thread.start(
+            [&producer](Thread&)
+            {
+                for (uint32_t value = 1; value <= NumValues; ++value)
+                {
+                    while (not producer.context->queue.tryPush(producer.index * Tag + value))
+                    {
+                        Thread::Sleep(0);
+                    }
+                }
+            }));
+    }
+    for (uint32_t idx = 0; idx < NumThreads; ++idx)
+    {
+        SC_TEST_EXPECT(producers[idx].thread.join());
+        SC_TEST_EXPECT(consumers[idx].thread.join());
+    }
+    SC_TEST_EXPECT(context.numErrors.load() == 0);
+    SC_TEST_EXPECT(context.numPopped.load() == NumThreads * NumValues);
+    SC_TEST_EXPECT(context.sum.load() == uint64_t(NumThreads) * NumValues * (NumValues + 1) / 2);
+
+    uint32_t value;
+    SC_TEST_EXPECT(not context.queue.tryPop(value));
+    MPMCQueue<uint32_t>::Cell oneCell[1];
+    SC_TEST_EXPECT(not context.queue.init(oneCell));
+}
+
+namespace SC
+{
+void runLockFreeQueueTest(SC::TestReport& report) { LockFreeQueueTest test(report); }
+} // namespace SC
@@ -0,0 +1,213 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../ParallelAlgorithms.h"
+#include "../../Containers/Vector.h"
+#include "../../Testing/Testing.h"
+
+namespace SC
+{
+struct ParallelAlgorithmsTest;
+}
+
+struct SC::ParallelAlgorithmsTest : public SC::TestCase
+{
+    inline void testParallelFor(ThreadPool::Scheduling scheduling);
+    inline void testParallelReduce();
+    inline void testParallelScan();
+    inline void testParallelSort();
+
+    ParallelAlgorithmsTest(SC::TestReport& report) : TestCase(report, "ParallelAlgorithmsTest")
+    {
+        if (test_section("parallelFor"))
+        {
+            testParallelFor(ThreadPool::Scheduling::SharedQueue);
+            testParallelFor(ThreadPool::Scheduling::WorkStealing);
+        }
+        if (test_section("parallelReduce"))
+        {
+            testParallelReduce();
+        }
+        if (test_section("parallelScan"))
+        {
+            testParallelScan();
+        }
+        if (test_section("parallelSort"))
+        {
+            testParallelSort();
+        }
+    }
+};
+
+void SC::ParallelAlgorithmsTest::testParallelFor(ThreadPool::Scheduling scheduling)
+{
+    //! [parallelForSnippet]
+    // Tasks are declared before the pool, so that they outlive it
+    ThreadPool::Task tasks[8];
+    ThreadPool       threadPool;
+    SC_TEST_EXPECT(threadPool.create(4, scheduling));
+
+    uint32_t values[10000];
+    auto     square = [&values](size_t begin, size_t end)
+    {
+        for (size_t idx = begin; idx < end; ++idx)
+        {
+            values[idx] = static_cast<uint32_t>(idx * idx);
+        }
+    };
+    SC_TEST_EXPECT(Algorithms::parallelFor(threadPool, tasks, 10000, 64, square));
+    //! [parallelForSnippet]
+    bool allGood = true;
+    for (size_t idx = 0; idx < 10000; ++idx)
+    {
+        allGood = allGood and values[idx] == static_cast<uint32_t>(idx * idx);
+    }
+    SC_TEST_EXPECT(allGood);
+
+    // A grain larger than the range or no tasks at all run everything on the calling thread
+    Atomic<int32_t> numCalls = 0;
+    auto            count    = [&numCalls](size_t, size_t) { numCalls.fetch_add(1); };
+    SC_TEST_EXPECT(Algorithms::parallelFor(threadPool, tasks, 100, 1000, count));
+    SC_TEST_EXPECT(Algorithms::parallelFor(threadPool, {}, 80, 10, count));
+    SC_TEST_EXPECT(numCalls.load() == 9);
+    SC_TEST_EXPECT(Algorithms::parallelFor(threadPool, tasks, 0, 10, count));
+    SC_TEST_EXPECT(numCalls.load() == 9);
+    SC_TEST_EXPECT(threadPool.destroy());
+}
+
+void SC::ParallelAlgorithmsTest::testParallelReduce()
+{
+    ThreadPool::Task tasks[4];
+    ThreadPool       threadPool;
+    SC_TEST_EXPECT(threadPool.create(4));
+
+    uint64_t partials[16];
+    uint64_t sum    = 0;
+    auto     map    = [](size_t begin, size_t end)
+    {
+        uint64_t value = 0;
+        for (size_t idx = begin; idx < end; ++idx)
+            value += idx;
+        return value;
+    };
+    auto reduce = [](uint64_t a, uint64_t b) { return a + b; };
+    SC_TEST_EXPECT(Algorithms::parallelReduce(threadPool, tasks, Span<uint64_t>(partials), 100000, 100, sum, map,
+                                              reduce));
+    SC_TEST_EXPECT(sum == 99999ull * 100000ull / 2);
+
+    // Partials are combined in order, so that a non commutative reduce works too
+    char text[26];
+    for (size_t idx = 0; idx < sizeof(text); ++idx)
+    {
+        text[idx] = static_cast<char>('a' + idx);
+    }
+    uint64_t packed    = 0;
+    auto     mapDigits = [&text](size_t begin, size_t end)
+    {
+        uint64_t value = 0;
+        for (size_t idx = begin; idx < end; ++idx)
+            value = value * 100 + static_cast<uint64_t>(text[idx] - 'a');
+        return value;
+    };
+    uint64_t digitsPartials[3]; // 3 blocks of 3 elements
+    auto     concatenate = [](uint64_t a, uint64_t b) { return a * 1000000 + b; };
+    SC_TEST_EXPECT(Algorithms::parallelReduce(threadPool, tasks, Span<uint64_t>(digitsPartials), 9, 3, packed,
+                                              mapDigits, concatenate));
+    SC_TEST_EXPECT(packed == 102030405060708ull);
+    SC_TEST_EXPECT(threadPool.destroy());
+}
+
+void SC::ParallelAlgorithmsTest::testParallelScan()
+{
+    ThreadPool::Task tasks[4];
+    ThreadPool       threadPool;
+    SC_TEST_EXPECT(threadPool.create(4, ThreadPool::Scheduling::WorkStealing));
+
+    const size_t sizes[] = {0, 1, 2, 7, 100, 4999};
+    for (const size_t size : sizes)
+    {
+        int64_t values[4999];
+        for (size_t idx = 0; idx < size; ++idx)
+        {
+            values[idx] = static_cast<int64_t>(idx % 7) - 3;
+        }
+        int64_t partials[6];
+        auto    add = [](int64_t a, int64_t b) { return a + b; };
+        // In place scan
+        SC_TEST_EXPECT(Algorithms::parallelScan(threadPool, tasks, Span<int64_t>(partials),
+                                                Span<const int64_t>(values, size), Span<int64_t>(values, size), 5,
+                                                add));
+        bool    allGood = true;
+        int64_t sum     = 0;
+        for (size_t idx = 0; idx < size; ++idx)
+        {
+            sum += static_cast<int64_t>(idx % 7) - 3;
+            allGood = allGood and values[idx] == sum;
+        }
+        SC_TEST_EXPECT(allGood);
+    }
+    int64_t input[3], output[2], partials[2];
+    SC_TEST_EXPECT(not Algorithms::parallelScan(threadPool, tasks, Span<int64_t>(partials), Span<const int64_t>(input),
+                                                Span<int64_t>(output), 1, [](int64_t a, int64_t b) { return a + b; }));
+    SC_TEST_EXPECT(threadPool.destroy());
+}
+
+void SC::ParallelAlgorithmsTest::testParallelSort()
+{
+    struct Record
+    {
+        uint32_t key   = 0;
+        uint32_t order = 0; // Original position, to verify stability
+
+        bool operator<(const Record& other) const { return key < other.key; }
+    };
+
+    ThreadPool::Task tasks[7];
+    ThreadPool       threadPool;
+    SC_TEST_EXPECT(threadPool.create(4, ThreadPool::Scheduling::WorkStealing));
+
+    const size_t sizes[]  = {0, 1, 31, 1000, 50000, 123457};
+    const size_t grains[] = {1, 64, 4096};
+    for (const size_t size : sizes)
+    {
+        for (const size_t grain : grains)
+        {
+            //! [parallelSortSnippet]
+            Vector<Record> records, scratch;
+            SC_TEST_EXPECT(records.resize(size));
+            uint32_t random = 1234567;
+            for (size_t idx = 0; idx < size; ++idx)
+            {
+                random ^= random << 13;
+                random ^= random >> 17;
+                random ^= random << 5;
+                records[idx].key   = random % 1000; // Many duplicates
+                records[idx].order = static_cast<uint32_t>(idx);
+            }
+            SC_TEST_EXPECT(Algorithms::parallelSort(threadPool, tasks, records, scratch,
+                                                    Algorithms::smallerThan<Record>(), grain));
+            //! [parallelSortSnippet]
+            bool sorted = true;
+            for (size_t idx = 1; idx < size; ++idx)
+            {
+                const Record& a = records[idx - 1];
+                const Record& b = records[idx];
+                sorted = sorted and (a.key < b.key or (a.key == b.key and a.order < b.order));
+            }
+            SC_TEST_EXPECT(sorted);
+        }
+    }
+
+    // Span version with a custom predicate
+    int values[] = {5, 3, 9, 1, 7, 2, 8};
+    int scratch[7];
+    SC_TEST_EXPECT(Algorithms::parallelSort(threadPool, tasks, Span<int>(values), Span<int>(scratch),
+                                            [](int a, int b) { return a > b; }, 1));
+    SC_TEST_EXPECT(values[0] == 9 and values[3] == 5 and values[6] == 1);
+    SC_TEST_EXPECT(not Algorithms::parallelSort(threadPool, tasks, Span<int>(values), Span<int>(scratch, 3)));
+    SC_TEST_EXPECT(threadPool.destroy());
+}
+
+namespace SC
+{
+void runParallelAlgorithmsTest(SC::TestReport& report) { ParallelAlgorithmsTest test(report); }
+} // namespace SC
@@ -0,0 +1,211 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../TaskGraph.h"
+#include "../../Async/Async.h"
+#include "../../Testing/Testing.h"
+
+namespace SC
+{
+struct TaskGraphTest;
+}
+
+struct SC::TaskGraphTest : public SC::TestCase
+{
+    inline void testDependencies(ThreadPool::Scheduling scheduling);
+    inline void testSpawn(ThreadPool::Scheduling scheduling);
+    inline void testErrors();
+    inline void testEventLoop();
+
+    TaskGraphTest(SC::TestReport& report) : TestCase(report, "TaskGraphTest")
+    {
+        if (test_section("dependencies"))
+        {
+            testDependencies(ThreadPool::Scheduling::SharedQueue);
+            testDependencies(ThreadPool::Scheduling::WorkStealing);
+        }
+        if (test_section("spawn"))
+        {
+            testSpawn(ThreadPool::Scheduling::SharedQueue);
+            testSpawn(ThreadPool::Scheduling::WorkStealing);
+        }
+        if (test_section("errors"))
+        {
+            testErrors();
+        }
+        if (test_section("event loop"))
+        {
+            testEventLoop();
+        }
+    }
+};
+
+void SC::TaskGraphTest::testDependencies(ThreadPool::Scheduling scheduling)
+{
+    //! [taskGraphSnippet]
+    // A diamond (compile -> [link, package] -> deploy), nodes and edges are declared before the pool to outlive it
+    TaskGraph::Node nodes[4];
+    TaskGraph::Edge edges[4];
+
+    int32_t         order[4] = {0};
+    Atomic<int32_t> sequence = 0;
+    for (int idx = 0; idx < 4; ++idx)
+    {
+        int32_t*         slot    = &order[idx];
+        Atomic<int32_t>* counter = &sequence;
+        nodes[idx].function      = [slot, counter]() { *slot = counter->fetch_add(1); };
+    }
+    ThreadPool threadPool;
+    SC_TEST_EXPECT(threadPool.create(4, scheduling));
+
+    TaskGraph graph;
+    for (TaskGraph::Node& node : nodes)
+    {
+        SC_TEST_EXPECT(graph.addNode(node));
+    }
+    SC_TEST_EXPECT(graph.addDependency(nodes[0], nodes[1], edges[0]));
+    SC_TEST_EXPECT(graph.addDependency(nodes[0], nodes[2], edges[1]));
+    SC_TEST_EXPECT(graph.addDependency(nodes[1], nodes[3], edges[2]));
+    SC_TEST_EXPECT(graph.addDependency(nodes[2], nodes[3], edges[3]));
+    for (int run = 0; run < 100; ++run) // A graph can be run many times
+    {
+        sequence.store(0);
+        SC_TEST_EXPECT(graph.start(threadPool));
+        SC_TEST_EXPECT(graph.wait());
+        SC_TEST_EXPECT(order[0] == 0 and order[3] == 3);
+    }
+    //! [taskGraphSnippet]
+    SC_TEST_EXPECT(not graph.isRunning());
+    SC_TEST_EXPECT(threadPool.destroy());
+}
+
+void SC::TaskGraphTest::testSpawn(ThreadPool::Scheduling scheduling)
+{
+    static constexpr int NumChildren      = 8;
+    static constexpr int NumGrandChildren = 4;
+
+    struct Child
+    {
+        TaskGraph::Node node;
+        TaskGraph::Node children[NumGrandChildren];
+    };
+    struct Context
+    {
+        TaskGraph       graph;
+        TaskGraph::Node root;
+        TaskGraph::Node last;
+        TaskGraph::Edge edge;
+        Child           children[NumChildren];
+
+        Atomic<int32_t> numExecuted    = 0;
+        Atomic<int32_t> numErrors      = 0;
+        int32_t         executedAtLast = 0;
+    } context;
+
+    // Root spawns children that spawn grandchildren, and `last` (successor of root) must run after all of them
+    context.root.function = [&context]()
+    {
+        for (Child& child : context.children)
+        {
+            Child*   self       = &child;
+            Context* ctx        = &context;
+            child.node.function = [self, ctx]()
+            {
+                for (TaskGraph::Node& grandChild : self->children)
+                {
+                    Atomic<int32_t>* numExecuted = &ctx->numExecuted;
+                    grandChild.function          = [numExecuted]() { numExecuted->fetch_add(1); };
+                    if (not ctx->graph.spawn(self->node, grandChild))
+                        ctx->numErrors.fetch_add(1);
+                }
+                ctx->numExecuted.fetch_add(1);
+            };
+            if (not context.graph.spawn(context.root, child.node))
+                context.numErrors.fetch_add(1);
+        }
+    };
+    context.last.function = [&context]() { context.executedAtLast = context.numExecuted.load(); };
+
+    ThreadPool threadPool;
+    SC_TEST_EXPECT(threadPool.create(4, scheduling));
+    SC_TEST_EXPECT(context.graph.addNode(context.root));
+    SC_TEST_EXPECT(context.graph.addNode(context.last));
+    SC_TEST_EXPECT(context.graph.addDependency(context.root, context.last, context.edge));
+    for (int run = 0; run < 20; ++run)
+    {
+        SC_TEST_EXPECT(context.graph.start(threadPool));
+        SC_TEST_EXPECT(context.graph.wait());
+        SC_TEST_EXPECT(context.executedAtLast == (run + 1) * NumChildren * (NumGrandChildren + 1));
+    }
+    SC_TEST_EXPECT(context.numErrors.load() == 0);
+    SC_TEST_EXPECT(threadPool.destroy());
+}
+
+void SC::TaskGraphTest::testErrors()
+{
+    TaskGraph::Node nodes[3];
+    TaskGraph::Edge edges[3];
+    ThreadPool      threadPool;
+    SC_TEST_EXPECT(threadPool.create(2));
+
+    TaskGraph graph;
+    TaskGraph other;
+    SC_TEST_EXPECT(not graph.start(threadPool)); // Empty
+    SC_TEST_EXPECT(not graph.wait());            // Not running
+    for (TaskGraph::Node& node : nodes)
+    {
+        SC_TEST_EXPECT(graph.addNode(node));
+    }
+    SC_TEST_EXPECT(not other.addNode(nodes[0]));                          // Already in a graph
+    SC_TEST_EXPECT(not graph.addDependency(nodes[0], nodes[0], edges[0])); // Self dependency
+    SC_TEST_EXPECT(not graph.spawn(nodes[0], nodes[1]));                   // Not running
+
+    // Cycle
+    SC_TEST_EXPECT(graph.addDependency(nodes[0], nodes[1], edges[0]));
+    SC_TEST_EXPECT(graph.addDependency(nodes[1], nodes[2], edges[1]));
+    SC_TEST_EXPECT(graph.addDependency(nodes[2], nodes[1], edges[2]));
+    SC_TEST_EXPECT(not graph.start(threadPool));
+    SC_TEST_EXPECT(not graph.isRunning());
+    SC_TEST_EXPECT(threadPool.destroy());
+}
+
+void SC::TaskGraphTest::testEventLoop()
+{
+    //! [taskGraphEventLoopSnippet]
+    TaskGraph::Node nodes[2];
+    TaskGraph::Edge edge;
+    ThreadPool      threadPool;
+    SC_TEST_EXPECT(threadPool.create(2, ThreadPool::Scheduling::WorkStealing));
+
+    AsyncEventLoop eventLoop;
+    SC_TEST_EXPECT(eventLoop.create());
+
+    // The thread finishing the last node wakes up the event loop, that will collect the graph without blocking
+    TaskGraph       graph;
+    AsyncLoopWakeUp wakeUp;
+    wakeUp.callback = [this, &graph](AsyncLoopWakeUp::Result& result)
+    {
+        SC_TEST_EXPECT(graph.wait());
+        SC_TEST_EXPECT(result.getAsync().stop());
+    };
+    SC_TEST_EXPECT(wakeUp.start(eventLoop));
+    graph.onComplete = [&wakeUp]() { (void)wakeUp.wakeUp(); };
+
+    int values[2] = {0, 0};
+    nodes[0].function = [&values]() { values[0] = 1; };
+    nodes[1].function = [&values]() { values[1] = values[0] + 1; };
+    SC_TEST_EXPECT(graph.addNode(nodes[0]));
+    SC_TEST_EXPECT(graph.addNode(nodes[1]));
+    SC_TEST_EXPECT(graph.addDependency(nodes[0], nodes[1], edge));
+    SC_TEST_EXPECT(graph.start(threadPool));
+    SC_TEST_EXPECT(eventLoop.run());
+    //! [taskGraphEventLoopSnippet]
+    SC_TEST_EXPECT(not graph.isRunning());
+    SC_TEST_EXPECT(values[1] == 2);
+    SC_TEST_EXPECT(eventLoop.close());
+    SC_TEST_EXPECT(threadPool.destroy());
+}
+
+namespace SC
+{
+void runTaskGraphTest(SC::TestReport& report) { TaskGraphTest test(report); }
+} // namespace SC
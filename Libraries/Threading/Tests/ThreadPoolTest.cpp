@@ -1,7 +1,11 @@
 // Copyright (c) Stefano Cristiano
 // SPDX-License-Identifier: MIT
 #include "../ThreadPool.h"
+#include "../../Containers/SmallVector.h"
+#include "../../Strings/StringFormat.h"
 #include "../../Testing/Testing.h"
+#include "../Atomic.h"
+#include "../CpuTopology.h"
 
 namespace SC
 {
@@ -12,6 +16,10 @@ struct SC::ThreadPoolTest : public SC::TestCase
 {
     inline void testThreadPool();
     inline void testThreadPoolErrors();
+    inline void testWorkStealing();
+    inline void testWorkStealingDestroy();
+    inline void testTopology();
+    inline void testStatistics(ThreadPool::Scheduling scheduling);
 
     ThreadPoolTest(SC::TestReport& report) : TestCase(report, "ThreadPoolTest")
     {
@@ -24,6 +32,27 @@ struct SC::ThreadPoolTest : public SC::TestCase
         {
             testThreadPoolErrors();
         }
+
+        if (test_section("WorkStealing"))
+        {
+            testWorkStealing();
+        }
+
+        if (test_section("WorkStealing destroy"))
+        {
+            testWorkStealingDestroy();
+        }
+
+        if (test_section("Topology"))
+        {
+            testTopology();
+        }
+
+        if (test_section("Statistics"))
+        {
+            testStatistics(ThreadPool::Scheduling::SharedQueue);
+            testStatistics(ThreadPool::Scheduling::WorkStealing);
+        }
     }
 };
 
@@ -106,6 +135,250 @@ void SC::ThreadPoolTest::testThreadPoolErrors()
     SC_TEST_EXPECT(not threadPool.queueTask(tasks[1]));
 }
 
+void SC::ThreadPoolTest::testWorkStealing()
+{
+    static const size_t numParents  = 16;
+    static const size_t numChildren = 32;
+
+    struct Parent
+    {
+        ThreadPool*          threadPool = nullptr;
+        ThreadPool::Task     task;
+        ThreadPool::Task     children[numChildren];
+        Atomic<int32_t>*     numExecuted = nullptr;
+        Atomic<int32_t>      numErrors   = 0;
+    };
+    Parent          parents[numParents];
+    Atomic<int32_t> numExecuted = 0;
+
+    ThreadPool threadPool;
+    SC_TEST_EXPECT(threadPool.create(4, ThreadPool::Scheduling::WorkStealing));
+    for (Parent& parent : parents)
+    {
+        parent.threadPool  = &threadPool;
+        parent.numExecuted = &numExecuted;
+        for (ThreadPool::Task& child : parent.children)
+        {
+            Atomic<int32_t>* counter = &numExecuted;
+            child.function           = [counter]() { counter->fetch_add(1); };
+        }
+        // Tasks queued from a worker thread go to its own deque, where other workers steal them
+        Parent* pointer      = &parent;
+        parent.task.function = [pointer]()
+        {
+            for (ThreadPool::Task& child : pointer->children)
+            {
+                if (not pointer->threadPool->queueTask(child))
+                {
+                    pointer->numErrors.fetch_add(1);
+                }
+            }
+            pointer->numExecuted->fetch_add(1);
+        };
+        SC_TEST_EXPECT(threadPool.queueTask(parent.task));
+    }
+    SC_TEST_EXPECT(threadPool.waitForTask(parents[0].task));
+    SC_TEST_EXPECT(threadPool.waitForAllTasks());
+    SC_TEST_EXPECT(numExecuted.load() == numParents * (numChildren + 1));
+    bool noErrors = true;
+    for (Parent& parent : parents)
+    {
+        noErrors = noErrors and parent.numErrors.load() == 0;
+    }
+    SC_TEST_EXPECT(noErrors);
+
+    // Completed tasks can be queued again
+    SC_TEST_EXPECT(threadPool.queueTask(parents[0].children[0]));
+    SC_TEST_EXPECT(threadPool.waitForTask(parents[0].children[0]));
+    SC_TEST_EXPECT(numExecuted.load() == numParents * (numChildren + 1) + 1);
+    SC_TEST_EXPECT(threadPool.destroy());
+}
+
+void SC::ThreadPoolTest::testTopology()
+{
+    //! [threadPoolTopologySnippet]
+    // One worker for each physical core of this machine, pinned to its SMT siblings, with one queue for each node
+    CpuTopology topology;
+    SC_TEST_EXPECT(topology.detect());
+
+    ThreadPool threadPool;
+    SC_TEST_EXPECT(threadPool.create(topology));
+    SC_TEST_EXPECT(threadPool.getNumWorkerThreads() == topology.getNumCores());
+    SC_TEST_EXPECT(threadPool.getNumNodes() == topology.getNumNodes());
+    //! [threadPoolTopologySnippet]
+
+    static const size_t numTasks = 256;
+
+    ThreadPool::Task tasks[numTasks];
+    Atomic<int32_t>  numExecuted = 0;
+    for (ThreadPool::Task& task : tasks)
+    {
+        task.function = [&numExecuted]() { numExecuted.fetch_add(1); };
+        SC_TEST_EXPECT(threadPool.queueTask(task));
+    }
+    SC_TEST_EXPECT(threadPool.waitForAllTasks());
+    SC_TEST_EXPECT(numExecuted.load() == numTasks);
+    SC_TEST_EXPECT(threadPool.destroy());
+    SC_TEST_EXPECT(threadPool.getNumNodes() == 0);
+
+    // A topology with two nodes of two cores each (pinning to processors that may not exist fails silently)
+    CpuTopology twoNodes;
+    for (uint32_t cpu = 0; cpu < 4; ++cpu)
+    {
+        SC_TEST_EXPECT(twoNodes.addCpu(cpu, cpu, cpu / 2));
+    }
+    SC_TEST_EXPECT(threadPool.create(twoNodes));
+    SC_TEST_EXPECT(threadPool.getNumWorkerThreads() == 4);
+    SC_TEST_EXPECT(threadPool.getNumNodes() == 2);
+
+    // Tasks queued on a node are stolen by workers of the other node when it's busy
+    numExecuted.store(0);
+    for (size_t idx = 0; idx < numTasks; ++idx)
+    {
+        SC_TEST_EXPECT(threadPool.queueTaskOnNode(tasks[idx], idx % 8 == 0 ? 1 : 0));
+    }
+    SC_TEST_EXPECT(threadPool.waitForAllTasks());
+    SC_TEST_EXPECT(numExecuted.load() == numTasks);
+    SC_TEST_EXPECT(not threadPool.queueTaskOnNode(tasks[0], 2)); // Invalid node
+    SC_TEST_EXPECT(threadPool.destroy());
+
+    CpuTopology empty;
+    SC_TEST_EXPECT(not threadPool.create(empty));
+}
+
+void SC::ThreadPoolTest::testWorkStealingDestroy()
+{
+    static const size_t numTasks = 8;
+
+    // Define tasks before threadpool to avoid threadpool destructor accessing invalid tasks
+    ThreadPool::Task tasks[numTasks];
+
+    ThreadPool threadPool;
+    SC_TEST_EXPECT(threadPool.create(1, ThreadPool::Scheduling::WorkStealing));
+    for (size_t idx = 0; idx < numTasks; idx++)
+    {
+        tasks[idx].function = []() { Thread::Sleep(20); };
+        SC_TEST_EXPECT(threadPool.queueTask(tasks[idx]));
+    }
+    // Expect error if trying to queue a task again
+    SC_TEST_EXPECT(not threadPool.queueTask(tasks[numTasks - 1]));
+
+    // Tasks that have not been executed are released, so they can be queued on another threadpool
+    SC_TEST_EXPECT(threadPool.destroy());
+    ThreadPool threadPool2;
+    SC_TEST_EXPECT(threadPool2.create(2, ThreadPool::Scheduling::WorkStealing));
+    for (size_t idx = 0; idx < numTasks; idx++)
+    {
+        SC_TEST_EXPECT(threadPool2.queueTask(tasks[idx]));
+    }
+    SC_TEST_EXPECT(threadPool2.waitForAllTasks());
+    SC_TEST_EXPECT(threadPool2.destroy());
+}
+
+void SC::ThreadPoolTest::testStatistics(ThreadPool::Scheduling scheduling)
+{
+    static const size_t numTasks   = 20;
+    static const size_t numWorkers = 2;
+
+    ThreadPool::Task tasks[numTasks];
+    ThreadPool       threadPool;
+#if SC_THREAD_POOL_STATISTICS
+    //! [threadPoolStatisticsSnippet]
+    SC_TEST_EXPECT(threadPool.create(numWorkers, scheduling));
+
+    // Optionally record an event for each task, to be written as Chrome Trace Event JSON
+    ThreadPoolTraceEvent events[numTasks];
+    SC_TEST_EXPECT(threadPool.setTraceEvents(events));
+    for (ThreadPool::Task& task : tasks)
+    {
+        task.function = []() { Thread::Sleep(2); };
+        SC_TEST_EXPECT(threadPool.queueTask(task));
+    }
+    SC_TEST_EXPECT(threadPool.waitForAllTasks());
+
+    // Snapshot of histograms of queue wait and execution time, together with busy / idle time of each worker
+    ThreadPoolWorkerStatistics statistics[numWorkers];
+    SC_TEST_EXPECT(threadPool.getStatistics(statistics));
+
+    SmallVector<char, 1024> json;
+    StringFormatOutput      output(StringEncoding::Ascii, json);
+    SC_TEST_EXPECT(threadPool.writeChromeTrace(output)); // Can be loaded in chrome://tracing or ui.perfetto.dev
+    //! [threadPoolStatisticsSnippet]
+
+    uint64_t numExecuted = 0;
+    uint64_t numWaited   = 0;
+    for (const ThreadPoolWorkerStatistics& worker : statistics)
+    {
+        numExecuted += worker.execution.count;
+        numWaited += worker.queueWait.count;
+        SC_TEST_EXPECT(worker.getUtilization() >= 0.0 and worker.getUtilization() <= 1.0);
+        if (worker.execution.count > 0)
+        {
+            // Tasks sleep at least 2 milliseconds
+            SC_TEST_EXPECT(worker.execution.getPercentileNanoseconds(50) >= 1000000);
+            SC_TEST_EXPECT(worker.execution.getAverageNanoseconds() >= 2000000);
+            SC_TEST_EXPECT(worker.busyNanoseconds >= worker.execution.count * 2000000);
+        }
+    }
+    SC_TEST_EXPECT(numExecuted == numTasks);
+    SC_TEST_EXPECT(numWaited == numTasks);
+
+    // With two workers, the last tasks have waited in queue for (at least) the execution of many others
+    uint64_t maxQueueWait = 0;
+    for (const ThreadPoolWorkerStatistics& worker : statistics)
+    {
+        maxQueueWait = worker.queueWait.maxNanoseconds > maxQueueWait ? worker.queueWait.maxNanoseconds : maxQueueWait;
+    }
+    SC_TEST_EXPECT(maxQueueWait >= (numTasks / numWorkers - 1) * 2000000);
+
+    SC_TEST_EXPECT(threadPool.getTraceEvents().sizeInElements() == numTasks);
+    for (const ThreadPoolTraceEvent& event : threadPool.getTraceEvents())
+    {
+        SC_TEST_EXPECT(event.workerIndex < numWorkers);
+        SC_TEST_EXPECT(event.queuedNanoseconds <= event.startNanoseconds);
+        SC_TEST_EXPECT(event.startNanoseconds + 2000000 <= event.endNanoseconds);
+    }
+    const StringView trace({json.data(), json.size() - 1}, false, StringEncoding::Ascii);
+    SC_TEST_EXPECT(trace.startsWith("{\"traceEvents\":["));
+    SC_TEST_EXPECT(trace.containsString("\"name\":\"ThreadPool Worker 1\""));
+    SC_TEST_EXPECT(trace.containsString("\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":"));
+    SC_TEST_EXPECT(trace.endsWith("]}\n"));
+
+    // Statistics and trace events can be cleared
+    SC_TEST_EXPECT(threadPool.resetStatistics());
+    SC_TEST_EXPECT(threadPool.getStatistics(statistics));
+    SC_TEST_EXPECT(statistics[0].execution.count == 0 and statistics[1].queueWait.count == 0);
+    SC_TEST_EXPECT(threadPool.getTraceEvents().empty());
+
+    // Trace events buffer can't be changed while tasks are running
+    EventObject taskStarted, taskCanEnd;
+    tasks[0].function = [&]()
+    {
+        taskStarted.signal();
+        taskCanEnd.wait();
+    };
+    SC_TEST_EXPECT(threadPool.queueTask(tasks[0]));
+    taskStarted.wait();
+    SC_TEST_EXPECT(not threadPool.setTraceEvents({}));
+    taskCanEnd.signal();
+    SC_TEST_EXPECT(threadPool.waitForAllTasks());
+    SC_TEST_EXPECT(threadPool.setTraceEvents({}));
+
+    ThreadPoolWorkerStatistics tooFew[numWorkers - 1];
+    SC_TEST_EXPECT(not threadPool.getStatistics(tooFew));
+    SC_TEST_EXPECT(threadPool.destroy());
+    SC_TEST_EXPECT(not threadPool.getStatistics(statistics));
+#else
+    // Statistics are not compiled in
+    SC_TEST_EXPECT(threadPool.create(numWorkers, scheduling));
+    ThreadPoolWorkerStatistics statistics[numWorkers];
+    SC_TEST_EXPECT(not threadPool.getStatistics(statistics));
+    SC_TEST_EXPECT(threadPool.getTraceEvents().empty());
+    SC_TEST_EXPECT(threadPool.destroy());
+    SC_COMPILER_UNUSED(tasks);
+#endif
+}
+
 namespace SC
 {
 void runThreadPoolTest(SC::TestReport& report) { ThreadPoolTest test(report); }
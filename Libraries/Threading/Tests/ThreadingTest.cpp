@@ -13,6 +13,10 @@ struct SC::ThreadingTest : public SC::TestCase
     inline void testThread();
     inline void testEventObject();
     inline void testMutex();
+    inline void testConditionVariable();
+    inline void testSemaphore();
+    inline void testReadWriteLock();
+    inline void testAffinity();
 
     ThreadingTest(SC::TestReport& report) : TestCase(report, "ThreadingTest")
     {
@@ -28,6 +32,22 @@ struct SC::ThreadingTest : public SC::TestCase
         {
             testMutex();
         }
+        if (test_section("ConditionVariable"))
+        {
+            testConditionVariable();
+        }
+        if (test_section("Semaphore"))
+        {
+            testSemaphore();
+        }
+        if (test_section("ReadWriteLock"))
+        {
+            testReadWriteLock();
+        }
+        if (test_section("Affinity"))
+        {
+            testAffinity();
+        }
     }
 };
 
@@ -77,6 +97,35 @@ void SC::ThreadingTest::testEventObject()
     // Signal
     // After waiting
     //! [eventObjectSnippet]
+
+    // Ping pong between two threads, each one waiting for the other to signal
+    static constexpr int NumRounds = 10000;
+
+    EventObject ping;
+    EventObject pong;
+    Thread      ponger;
+    SC_TEST_EXPECT(ponger.start(
+        [&ping, &pong](Thread&)
+        {
+            for (int idx = 0; idx < NumRounds; ++idx)
+            {
+                ping.wait();
+                pong.signal();
+            }
+        }));
+    for (int idx = 0; idx < NumRounds; ++idx)
+    {
+        ping.signal();
+        pong.wait();
+    }
+    SC_TEST_EXPECT(ponger.join());
+
+    // A signal before wait is not lost, and a manual reset event stays signaled
+    EventObject manualReset;
+    manualReset.autoReset = false;
+    manualReset.signal();
+    manualReset.wait();
+    manualReset.wait();
 }
 
 void SC::ThreadingTest::testMutex()
@@ -107,6 +156,263 @@ void SC::ThreadingTest::testMutex()
     SC_TEST_EXPECT(thread2.join());
     SC_TEST_EXPECT(globalVariable == 2);
     //! [mutexSnippet]
+
+#if SC_PLATFORM_LINUX
+    SC_TEST_EXPECT(sizeof(Mutex) == 2 * sizeof(uint32_t)); // Futex word and spin estimate
+#endif
+
+    // Many threads incrementing a shared counter under contention
+    static constexpr int NumThreads    = 4;
+    static constexpr int NumIncrements = 50000;
+
+    int    counter = 0;
+    Thread threads[NumThreads];
+    for (Thread& thread : threads)
+    {
+        SC_TEST_EXPECT(thread.start(
+            [&mutex, &counter](Thread&)
+            {
+                for (int idx = 0; idx < NumIncrements; ++idx)
+                {
+                    mutex.lock();
+                    counter++;
+                    mutex.unlock();
+                }
+            }));
+    }
+    for (Thread& thread : threads)
+    {
+        SC_TEST_EXPECT(thread.join());
+    }
+    SC_TEST_EXPECT(counter == NumThreads * NumIncrements);
+}
+
+void SC::ThreadingTest::testConditionVariable()
+{
+    // Producer passes values one by one to consumer through a single slot
+    static constexpr int NumValues = 10000;
+    struct Slot
+    {
+        Mutex             mutex;
+        ConditionVariable changed;
+
+        int  value = 0;
+        bool full  = false;
+    } slot;
+
+    Thread consumer;
+    int    sum = 0;
+    SC_TEST_EXPECT(consumer.start(
+        [&slot, &sum](Thread&)
+        {
+            for (int idx = 0; idx < NumValues; ++idx)
+            {
+                slot.mutex.lock();
+                while (not slot.full)
+                {
+                    slot.changed.wait(slot.mutex);
+                }
+                sum += slot.value;
+                slot.full = false;
+                slot.mutex.unlock();
+                slot.changed.broadcast();
+            }
+        }));
+    for (int idx = 1; idx <= NumValues; ++idx)
+    {
+        slot.mutex.lock();
+        while (slot.full)
+        {
+            slot.changed.wait(slot.mutex);
+        }
+        slot.value = idx;
+        slot.full  = true;
+        slot.mutex.unlock();
+        slot.changed.signal();
+    }
+    SC_TEST_EXPECT(consumer.join());
+    SC_TEST_EXPECT(sum == NumValues * (NumValues + 1) / 2);
+}
+
+void SC::ThreadingTest::testSemaphore()
+{
+    //! [semaphoreSnippet]
+    Semaphore semaphore(1);
+    SC_TEST_EXPECT(semaphore.tryAcquire());     // Takes the only unit
+    SC_TEST_EXPECT(not semaphore.tryAcquire()); // None is left
+
+    // Workers block until units are released
+    static constexpr int NumThreads = 4;
+
+    Atomic<int32_t> numAcquired = 0;
+    Thread          threads[NumThreads];
+    for (Thread& thread : threads)
+    {
+        SC_TEST_EXPECT(thread.start(
+            [&semaphore, &numAcquired](Thread&)
+            {
+                semaphore.acquire();
+                numAcquired.fetch_add(1);
+            }));
+    }
+    semaphore.release(NumThreads);
+    for (Thread& thread : threads)
+    {
+        SC_TEST_EXPECT(thread.join());
+    }
+    SC_TEST_EXPECT(numAcquired.load() == NumThreads);
+    //! [semaphoreSnippet]
+
+    // Units are exchanged one by one between two threads
+    static constexpr int NumRounds = 10000;
+
+    Semaphore produced;
+    Semaphore consumed;
+    Thread    consumer;
+    SC_TEST_EXPECT(consumer.start(
+        [&produced, &consumed](Thread&)
+        {
+            for (int idx = 0; idx < NumRounds; ++idx)
+            {
+                produced.acquire();
+                consumed.release();
+            }
+        }));
+    for (int idx = 0; idx < NumRounds; ++idx)
+    {
+        produced.release();
+        consumed.acquire();
+    }
+    SC_TEST_EXPECT(consumer.join());
+    SC_TEST_EXPECT(not produced.tryAcquire() and not consumed.tryAcquire());
+}
+
+void SC::ThreadingTest::testReadWriteLock()
+{
+    //! [readWriteLockSnippet]
+    // Writers keep the two values equal, so readers must never observe them being different
+    static constexpr int NumReaders = 3;
+    static constexpr int NumWriters = 2;
+    static constexpr int NumRounds  = 20000;
+
+    struct Shared
+    {
+        ReadWriteLock   lock;
+        int             values[2] = {0, 0};
+        Atomic<int32_t> numErrors = 0;
+    } shared;
+
+    Thread readers[NumReaders];
+    Thread writers[NumWriters];
+    for (Thread& thread : readers)
+    {
+        SC_TEST_EXPECT(thread.start(
+            [&shared](Thread&)
+            {
+                for (int idx = 0; idx < NumRounds; ++idx)
+                {
+                    shared.lock.lockRead();
+                    if (shared.values[0] != shared.values[1])
+                    {
+                        shared.numErrors.fetch_add(1);
+                    }
+                    shared.lock.unlockRead();
+                }
+            }));
+    }
+    for (Thread& thread : writers)
+    {
+        SC_TEST_EXPECT(thread.start(
+            [&shared](Thread&)
+            {
+                for (int idx = 0; idx < NumRounds; ++idx)
+                {
+                    shared.lock.lockWrite();
+                    shared.values[0]++;
+                    shared.values[1]++;
+                    shared.lock.unlockWrite();
+                }
+            }));
+    }
+    for (Thread& thread : readers)
+    {
+        SC_TEST_EXPECT(thread.join());
+    }
+    for (Thread& thread : writers)
+    {
+        SC_TEST_EXPECT(thread.join());
+    }
+    SC_TEST_EXPECT(shared.numErrors.load() == 0);
+    SC_TEST_EXPECT(shared.values[0] == NumWriters * NumRounds);
+    //! [readWriteLockSnippet]
+}
+
+void SC::ThreadingTest::testAffinity()
+{
+    CpuSet cpus;
+    SC_TEST_EXPECT(cpus.isEmpty());
+    SC_TEST_EXPECT(cpus.add(3) and cpus.add(64) and cpus.add(CpuSet::MaxCpus - 1));
+    SC_TEST_EXPECT(not cpus.add(CpuSet::MaxCpus));
+    SC_TEST_EXPECT(cpus.count() == 3 and cpus.contains(64) and not cpus.contains(4));
+    cpus.remove(64);
+    SC_TEST_EXPECT(cpus.count() == 2 and not cpus.contains(64));
+    cpus.clear();
+    SC_TEST_EXPECT(cpus.isEmpty());
+
+    Thread notStarted;
+    SC_TEST_EXPECT(not notStarted.setAffinity(cpus));
+    SC_TEST_EXPECT(not Thread::SetCurrentThreadAffinity(cpus)); // Empty set
+
+#if SC_PLATFORM_LINUX || SC_PLATFORM_WINDOWS
+    //! [threadAffinitySnippet]
+    // Pin a thread to the first of the processors where this thread is allowed to run, lowering its priority
+    CpuSet allowed;
+    SC_TEST_EXPECT(Thread::GetCurrentThreadAffinity(allowed));
+    uint32_t firstCpu = 0;
+    while (not allowed.contains(firstCpu))
+    {
+        firstCpu++;
+    }
+    CpuSet pinned;
+    SC_TEST_EXPECT(pinned.add(firstCpu));
+
+    struct Context
+    {
+        CpuSet pinned;
+        CpuSet affinity;
+        bool   pinnedOk   = false;
+        bool   priorityOk = false;
+    } context;
+    context.pinned = pinned;
+
+    Thread thread;
+    SC_TEST_EXPECT(thread.start(
+        [&context](Thread& thread)
+        {
+            thread.setThreadName(SC_NATIVE_STR("Pinned thread"));
+            context.pinnedOk = Thread::SetCurrentThreadAffinity(context.pinned) and
+                               Thread::GetCurrentThreadAffinity(context.affinity);
+            // Lowering priority doesn't need any privilege (but raising it again could)
+            context.priorityOk = Thread::SetCurrentThreadPriority(Thread::Priority::Low);
+        }));
+    SC_TEST_EXPECT(thread.join());
+    SC_TEST_EXPECT(context.pinnedOk and context.priorityOk);
+    SC_TEST_EXPECT(context.affinity.count() == 1 and context.affinity.contains(firstCpu));
+    //! [threadAffinitySnippet]
+
+    // Affinity of a started thread can be changed from another thread
+    EventObject started, proceed;
+    SC_TEST_EXPECT(thread.start(
+        [&started, &proceed](Thread&)
+        {
+            started.signal();
+            proceed.wait();
+        }));
+    started.wait();
+    SC_TEST_EXPECT(thread.setAffinity(allowed));
+    proceed.signal();
+    SC_TEST_EXPECT(thread.join());
+#endif
 }
 
 namespace SC
@@ -2,12 +2,123 @@
 // SPDX-License-Identifier: MIT
 #include "ThreadPool.h"
 #include "../Foundation/Deferred.h"
+#include "../Foundation/Memory.h"
+#include "CpuTopology.h"
 
 #if SC_PLATFORM_WINDOWS
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
 #else
 #include <pthread.h>
+#if SC_PLATFORM_LINUX
+#include <sched.h> // sched_getcpu
+#endif
+#endif
+#include "Atomic.h" // memory_order
+
+#if SC_THREAD_POOL_STATISTICS
+#include "../Strings/StringFormat.h"
+#include "../Time/Time.h"
+
+//-------------------------------------------------------------------------------------------------------
+// Statistics
+//-------------------------------------------------------------------------------------------------------
+struct SC::ThreadPool::Statistics
+{
+    // Same as ThreadPoolHistogram, but readable by ThreadPool::getStatistics while a worker is updating it
+    struct Histogram
+    {
+        Atomic<uint64_t> buckets[ThreadPoolHistogram::NumBuckets];
+        Atomic<uint64_t> count;
+        Atomic<uint64_t> totalNanoseconds;
+        Atomic<uint64_t> maxNanoseconds;
+
+        // Called only by the worker owning the statistics
+        void record(uint64_t nanoseconds)
+        {
+            buckets[ThreadPoolHistogram::getBucketIndex(nanoseconds)].fetch_add(1, memory_order_relaxed);
+            count.fetch_add(1, memory_order_relaxed);
+            totalNanoseconds.fetch_add(nanoseconds, memory_order_relaxed);
+            if (nanoseconds > maxNanoseconds.load(memory_order_relaxed))
+            {
+                maxNanoseconds.store(nanoseconds, memory_order_relaxed);
+            }
+        }
+
+        void copyTo(ThreadPoolHistogram& histogram) const
+        {
+            for (int idx = 0; idx < ThreadPoolHistogram::NumBuckets; ++idx)
+            {
+                histogram.buckets[idx] = buckets[idx].load(memory_order_relaxed);
+            }
+            histogram.count            = count.load(memory_order_relaxed);
+            histogram.totalNanoseconds = totalNanoseconds.load(memory_order_relaxed);
+            histogram.maxNanoseconds   = maxNanoseconds.load(memory_order_relaxed);
+        }
+
+        void reset()
+        {
+            for (Atomic<uint64_t>& bucket : buckets)
+            {
+                bucket.store(0, memory_order_relaxed);
+            }
+            count.store(0, memory_order_relaxed);
+            totalNanoseconds.store(0, memory_order_relaxed);
+            maxNanoseconds.store(0, memory_order_relaxed);
+        }
+    };
+
+    Histogram        queueWait;
+    Histogram        execution;
+    Atomic<uint64_t> busyNanoseconds;
+
+    static int64_t now() { return Time::HighResolutionCounter().snap().toNanoseconds(); }
+
+    static void recordTask(ThreadPool& threadPool, size_t workerIndex, int64_t queued, int64_t started, int64_t ended)
+    {
+        Statistics&    statistics    = threadPool.statistics[workerIndex];
+        const uint64_t executionTime = ended > started ? static_cast<uint64_t>(ended - started) : 0;
+        statistics.queueWait.record(started > queued ? static_cast<uint64_t>(started - queued) : 0);
+        statistics.execution.record(executionTime);
+        statistics.busyNanoseconds.fetch_add(executionTime, memory_order_relaxed);
+        if (threadPool.traceEventsCapacity > 0)
+        {
+            const size_t index = threadPool.numTraceEvents.fetch_add(1, memory_order_relaxed);
+            if (index < threadPool.traceEventsCapacity)
+            {
+                const int64_t         origin = threadPool.statisticsStartNanoseconds.load(memory_order_relaxed);
+                ThreadPoolTraceEvent& event  = threadPool.traceEvents[index];
+                event.workerIndex            = static_cast<uint32_t>(workerIndex);
+                event.queuedNanoseconds      = queued - origin;
+                event.startNanoseconds       = started - origin;
+                event.endNanoseconds         = ended - origin;
+            }
+        }
+    }
+
+    [[nodiscard]] static Result create(ThreadPool& threadPool, size_t numWorkers)
+    {
+        threadPool.statistics = static_cast<Statistics*>(Memory::allocate(sizeof(Statistics) * numWorkers));
+        SC_TRY_MSG(threadPool.statistics != nullptr, "ThreadPool::create - Cannot allocate statistics");
+        for (size_t idx = 0; idx < numWorkers; ++idx)
+        {
+            new (&threadPool.statistics[idx], PlacementNew()) Statistics();
+        }
+        threadPool.numStartedWorkers.store(0);
+        threadPool.statisticsStartNanoseconds.store(now());
+        return Result(true);
+    }
+
+    // Called after all workers have exited
+    static void release(ThreadPool& threadPool)
+    {
+        Memory::release(threadPool.statistics);
+        threadPool.statistics          = nullptr;
+        threadPool.traceEvents         = nullptr;
+        threadPool.traceEventsCapacity = 0;
+        threadPool.numTraceEvents.store(0);
+    }
+};
 #endif
 
 struct SC::ThreadPool::WorkerThread
@@ -19,6 +130,9 @@ struct SC::ThreadPool::WorkerThread
 #endif
     {
         ThreadPool& threadPool = *reinterpret_cast<ThreadPool*>(arg);
+#if SC_THREAD_POOL_STATISTICS
+        const size_t workerIndex = threadPool.numStartedWorkers.fetch_add(1);
+#endif
         for (;;)
         {
             // 1. Loop forever, trying to grab new tasks
@@ -31,7 +145,14 @@ struct SC::ThreadPool::WorkerThread
             // 2. Execute the task
             if (task != nullptr)
             {
+#if SC_THREAD_POOL_STATISTICS
+                const int64_t queued  = task->queuedNanoseconds;
+                const int64_t started = Statistics::now();
                 task->function();
+                Statistics::recordTask(threadPool, workerIndex, queued, started, Statistics::now());
+#else
+                task->function();
+#endif
             }
 
             // 3. Signal completion of the task
@@ -47,13 +168,13 @@ struct SC::ThreadPool::WorkerThread
         auto deferUnlock = MakeDeferred([&threadPool] { threadPool.poolMutex.unlock(); });
 
         // 1. Check for new task (or for the stop message)
-        while (not threadPool.stopRequested and threadPool.taskHead == nullptr)
+        while (not threadPool.stopRequested.load(memory_order_relaxed) and threadPool.taskHead == nullptr)
         {
             threadPool.taskAvailable.wait(threadPool.poolMutex);
         }
 
         // 2. If a stop has been requested let execute stop the infinite loop
-        if (threadPool.stopRequested)
+        if (threadPool.stopRequested.load(memory_order_relaxed))
         {
             // Flag the task as completed to unblock waitForTask and return false to signal stopping the infinite loop
             threadPool.numWorkerThreads--;
@@ -68,7 +189,8 @@ struct SC::ThreadPool::WorkerThread
         // 4. Update the head of the FIFO
         if (task)
         {
-            if (task->next == nullptr)
+            Task* next = task->next.load(memory_order_relaxed);
+            if (next == nullptr)
             {
                 // This was the last task available, now the FIFO is empty
                 threadPool.taskHead = nullptr;
@@ -76,7 +198,7 @@ struct SC::ThreadPool::WorkerThread
             }
             else
             {
-                threadPool.taskHead = task->next;
+                threadPool.taskHead = next;
             }
         }
         return true;
@@ -88,11 +210,12 @@ struct SC::ThreadPool::WorkerThread
         threadPool.poolMutex.lock();
         if (task)
         {
-            task->threadPool = nullptr; // free the task
-            task->next       = nullptr;
+            task->threadPool.store(nullptr, memory_order_relaxed); // free the task
+            task->next.store(nullptr, memory_order_relaxed);
         }
         threadPool.numRunningTasks--;
-        if (not threadPool.stopRequested) // stopRequested handling happens in waitForAvailableTask
+        // stopRequested handling happens in waitForAvailableTask
+        if (not threadPool.stopRequested.load(memory_order_relaxed))
         {
             threadPool.taskCompleted.signal();
         }
@@ -100,18 +223,580 @@ struct SC::ThreadPool::WorkerThread
     }
 };
 
-SC::Result SC::ThreadPool::create(size_t workerThreads)
+//-------------------------------------------------------------------------------------------------------
+// Scheduling::WorkStealing
+//-------------------------------------------------------------------------------------------------------
+struct SC::ThreadPool::Worker
+{
+    static constexpr int64_t Capacity      = 256; // Maximum number of tasks in the deque (must be a power of two)
+    static constexpr size_t  CacheLineSize = 64;
+
+    ThreadPool* threadPool = nullptr;
+    uint32_t    random     = 0; // State of the xorshift generator used to pick victims of stealing
+    size_t      node       = 0; // Index of the NUMA node of this worker
+    CpuSet      cpus;           // Processors where the worker pins itself (if not empty)
+
+    // Chase-Lev deque, as described in "Correct and Efficient Work-Stealing for Weak Memory Models" (Lê et al.).
+    // The owner pushes and pops at bottom, other workers steal at top. Indices only grow (modulo Capacity).
+    char            padding0[CacheLineSize];
+    Atomic<int64_t> top = 0;
+    char            padding1[CacheLineSize];
+    Atomic<int64_t> bottom = 0;
+    char            padding2[CacheLineSize];
+    Atomic<Task*>   tasks[Capacity];
+};
+
+// Injection queue of a NUMA node
+struct SC::ThreadPool::Node
+{
+    static constexpr size_t CacheLineSize = 64;
+
+    Task            injectionStub;                     // Stub node of the injection queue (never executed)
+    Task*           injectionHead     = &injectionStub; // Injection queue consumer side (owned by injectionConsumer)
+    Atomic<Task*>   injectionTail     = &injectionStub; // Injection queue producers side
+    Atomic<bool>    injectionConsumer = false; // A worker is moving tasks from the injection queue to its deque
+    Atomic<int64_t> numInjectedTasks  = 0;     // Tasks in the injection queue
+    char            padding[CacheLineSize];    // Avoids false sharing with the queue of the next node
+};
+
+struct SC::ThreadPool::WorkStealing
+{
+    static constexpr int SpinCount = 64; // Failed searches for a task before parking the worker
+
+    // Worker executing current thread (if any)
+    static thread_local Worker* currentWorker;
+
+    static void pause()
+    {
+#if SC_PLATFORM_WINDOWS
+        ::YieldProcessor();
+#elif defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        asm volatile("yield");
+#endif
+    }
+
+    //---------------------------------------------------------------------------------------------------
+    // Chase-Lev deque
+    //---------------------------------------------------------------------------------------------------
+    // Called only by the owner of the deque
+    [[nodiscard]] static bool push(Worker& worker, Task& task)
+    {
+        const int64_t bottom = worker.bottom.load(memory_order_relaxed);
+        const int64_t top    = worker.top.load(memory_order_acquire);
+        if (bottom - top >= Worker::Capacity)
+        {
+            return false; // Deque is full
+        }
+        worker.tasks[bottom & (Worker::Capacity - 1)].store(&task, memory_order_relaxed);
+        worker.bottom.store(bottom + 1, memory_order_release);
+        return true;
+    }
+
+    // Called only by the owner of the deque
+    [[nodiscard]] static Task* pop(Worker& worker)
+    {
+        const int64_t bottom = worker.bottom.load(memory_order_relaxed) - 1;
+        worker.bottom.store(bottom, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        int64_t top = worker.top.load(memory_order_relaxed);
+        if (top > bottom)
+        {
+            worker.bottom.store(bottom + 1, memory_order_relaxed); // Deque was empty
+            return nullptr;
+        }
+        Task* task = worker.tasks[bottom & (Worker::Capacity - 1)].load(memory_order_relaxed);
+        if (top == bottom)
+        {
+            // Last task in the deque, race against thieves trying to steal it
+            if (not worker.top.compare_exchange_strong(top, top + 1))
+            {
+                task = nullptr;
+            }
+            worker.bottom.store(bottom + 1, memory_order_relaxed);
+        }
+        return task;
+    }
+
+    // Called by any thread
+    [[nodiscard]] static Task* steal(Worker& worker)
+    {
+        int64_t top = worker.top.load(memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        const int64_t bottom = worker.bottom.load(memory_order_acquire);
+        if (top >= bottom)
+        {
+            return nullptr;
+        }
+        Task* task = worker.tasks[top & (Worker::Capacity - 1)].load(memory_order_relaxed);
+        if (not worker.top.compare_exchange_strong(top, top + 1))
+        {
+            return nullptr; // Lost the race with the owner or with another thief
+        }
+        return task;
+    }
+
+    [[nodiscard]] static bool isEmpty(Worker& worker)
+    {
+        return worker.top.load(memory_order_acquire) >= worker.bottom.load(memory_order_acquire);
+    }
+
+    //---------------------------------------------------------------------------------------------------
+    // Injection queue
+    //---------------------------------------------------------------------------------------------------
+    // Intrusive MPSC queue (by Dmitry Vyukov) linking tasks through Task::next. Pushing is wait-free.
+    // Popping is allowed to a single worker at a time (injectionConsumer), that moves a batch of tasks to its deque
+    // where other workers can steal them. Other workers don't wait for it, they just look for tasks elsewhere.
+    // Every NUMA node has its own injection queue.
+    static void inject(Node& node, Task& task)
+    {
+        node.numInjectedTasks.fetch_add(1);
+        task.next.store(nullptr, memory_order_relaxed);
+        Task* previous = node.injectionTail.exchange(&task);
+        previous->next.store(&task, memory_order_release);
+    }
+
+    // Called only by the worker holding injectionConsumer
+    [[nodiscard]] static Task* popInjected(Node& node)
+    {
+        Task* head = node.injectionHead;
+        Task* next = head->next.load(memory_order_acquire);
+        if (head == &node.injectionStub)
+        {
+            if (next == nullptr)
+            {
+                return nullptr;
+            }
+            node.injectionHead = next;
+            head               = next;
+            next               = next->next.load(memory_order_acquire);
+        }
+        if (next == nullptr)
+        {
+            if (head != node.injectionTail.load(memory_order_acquire))
+            {
+                return nullptr; // A producer is in the middle of a push, task will be available in a moment
+            }
+            // Head is the last task, push back the stub to be able to detach it
+            node.injectionStub.next.store(nullptr, memory_order_relaxed);
+            Task* previous = node.injectionTail.exchange(&node.injectionStub);
+            previous->next.store(&node.injectionStub, memory_order_release);
+            next = head->next.load(memory_order_acquire);
+            if (next == nullptr)
+            {
+                return nullptr;
+            }
+        }
+        node.injectionHead = next;
+        return head;
+    }
+
+    // Moves a batch of tasks injected in node to the (empty) deque of the worker, returning the oldest one to execute
+    [[nodiscard]] static Task* takeInjected(Worker& worker, Node& node)
+    {
+        if (node.numInjectedTasks.load(memory_order_relaxed) == 0 or
+            node.injectionConsumer.exchange(true, memory_order_acquire))
+        {
+            return nullptr; // Nothing to take or some other worker is already taking tasks
+        }
+        Task*   task     = popInjected(node);
+        int64_t numTaken = 0;
+        if (task != nullptr)
+        {
+            numTaken = 1;
+            // Room of the deque is computed once, as only the owner can push to it
+            const int64_t room  = Worker::Capacity - (worker.bottom.load() - worker.top.load());
+            const int64_t batch = room < Worker::Capacity / 2 ? room : Worker::Capacity / 2;
+            for (int64_t idx = 0; idx < batch; ++idx)
+            {
+                Task* next = popInjected(node);
+                if (next == nullptr or not push(worker, *next))
+                {
+                    break;
+                }
+                numTaken++;
+            }
+            node.numInjectedTasks.fetch_sub(numTaken);
+        }
+        node.injectionConsumer.store(false, memory_order_release);
+        if (numTaken > 1)
+        {
+            wakeUpWorker(*worker.threadPool); // Let some other worker steal the tasks just moved to the deque
+        }
+        return task;
+    }
+
+    // Node where a task queued from outside the pool is injected
+    [[nodiscard]] static size_t getCurrentNode(ThreadPool& threadPool)
+    {
+        if (threadPool.numNodes == 1)
+        {
+            return 0;
+        }
+#if SC_PLATFORM_LINUX
+        const int cpu = ::sched_getcpu();
+#elif SC_PLATFORM_WINDOWS
+        const int cpu = static_cast<int>(::GetCurrentProcessorNumber());
+#else
+        const int cpu = -1;
+#endif
+        if (cpu >= 0 and cpu < static_cast<int>(CpuSet::MaxCpus) and threadPool.cpuNodes[cpu] < threadPool.numNodes)
+        {
+            return threadPool.cpuNodes[cpu];
+        }
+        return static_cast<size_t>(threadPool.nextNode.fetch_add(1)) % threadPool.numNodes;
+    }
+
+    //---------------------------------------------------------------------------------------------------
+    // Worker threads
+    //---------------------------------------------------------------------------------------------------
+    [[nodiscard]] static Task* findTask(Worker& worker)
+    {
+        // 1. Newest task queued by tasks executed on this worker
+        Task* task = pop(worker);
+        if (task != nullptr)
+            return task;
+
+        // 2. Tasks queued from outside the thread pool on the node of this worker
+        ThreadPool& threadPool = *worker.threadPool;
+        task                   = takeInjected(worker, threadPool.nodes[worker.node]);
+        if (task != nullptr)
+            return task;
+
+        // 3. Oldest task of some other worker of the same node
+        task = stealTask(worker, true);
+        if (task != nullptr)
+            return task;
+
+        // 4. Tasks queued on other nodes and finally oldest task of workers of other nodes
+        for (size_t idx = 1; idx < threadPool.numNodes; ++idx)
+        {
+            task = takeInjected(worker, threadPool.nodes[(worker.node + idx) % threadPool.numNodes]);
+            if (task != nullptr)
+                return task;
+        }
+        return threadPool.numNodes > 1 ? stealTask(worker, false) : nullptr;
+    }
+
+    // Steals the oldest task of some worker on the same (or on a different) node, starting from a random one
+    [[nodiscard]] static Task* stealTask(Worker& worker, bool sameNode)
+    {
+        ThreadPool& threadPool = *worker.threadPool;
+        worker.random ^= worker.random << 13;
+        worker.random ^= worker.random >> 17;
+        worker.random ^= worker.random << 5;
+        const size_t first = worker.random % threadPool.numWorkers;
+        for (size_t idx = 0; idx < threadPool.numWorkers; ++idx)
+        {
+            Worker& victim = threadPool.workers[(first + idx) % threadPool.numWorkers];
+            if (&victim != &worker and (victim.node == worker.node) == sameNode)
+            {
+                Task* task = steal(victim);
+                if (task != nullptr)
+                    return task;
+            }
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] static bool hasQueuedTasks(ThreadPool& threadPool)
+    {
+        for (size_t idx = 0; idx < threadPool.numNodes; ++idx)
+        {
+            if (threadPool.nodes[idx].numInjectedTasks.load() != 0)
+                return true;
+        }
+        for (size_t idx = 0; idx < threadPool.numWorkers; ++idx)
+        {
+            if (not isEmpty(threadPool.workers[idx]))
+                return true;
+        }
+        return false;
+    }
+
+#if SC_PLATFORM_WINDOWS
+    static DWORD WINAPI execute(void* arg)
+#else
+    static void* execute(void* arg)
+#endif
+    {
+        Worker&     worker     = *reinterpret_cast<Worker*>(arg);
+        ThreadPool& threadPool = *worker.threadPool;
+        currentWorker          = &worker;
+        if (not worker.cpus.isEmpty())
+        {
+            (void)Thread::SetCurrentThreadAffinity(worker.cpus); // Best effort (it can fail in restricted cpusets)
+        }
+
+        bool spinning          = false; // Counted in numSpinningWorkers
+        int  numFailedSearches = 0;
+        while (not threadPool.stopRequested.load())
+        {
+            Task* task = findTask(worker);
+            if (task == nullptr)
+            {
+                if (not spinning)
+                {
+                    spinning = true;
+                    threadPool.numSpinningWorkers.fetch_add(1);
+                }
+                if (++numFailedSearches < SpinCount)
+                {
+                    pause();
+                }
+                else
+                {
+                    numFailedSearches = 0;
+                    spinning          = false;
+                    threadPool.numSpinningWorkers.fetch_sub(1);
+                    park(threadPool);
+                }
+                continue;
+            }
+            numFailedSearches = 0;
+            if (spinning)
+            {
+                // The last spinning worker finding a task wakes up another one, as there could be more tasks
+                spinning = false;
+                if (threadPool.numSpinningWorkers.fetch_sub(1) == 1)
+                {
+                    wakeUpWorker(threadPool);
+                }
+            }
+
+#if SC_THREAD_POOL_STATISTICS
+            const int64_t queued  = task->queuedNanoseconds;
+            const int64_t started = Statistics::now();
+            task->function();
+            Statistics::recordTask(threadPool, static_cast<size_t>(&worker - threadPool.workers), queued, started,
+                                   Statistics::now());
+#else
+            task->function();
+#endif
+
+            task->next.store(nullptr, memory_order_relaxed);
+            task->threadPool.store(nullptr); // free the task
+            threadPool.numPendingTasks.fetch_sub(1);
+            if (threadPool.numWaiters.load() > 0)
+            {
+                threadPool.poolMutex.lock();
+                threadPool.taskCompleted.broadcast();
+                threadPool.poolMutex.unlock();
+            }
+        }
+        if (spinning)
+        {
+            threadPool.numSpinningWorkers.fetch_sub(1);
+        }
+        currentWorker = nullptr;
+
+        threadPool.poolMutex.lock();
+        threadPool.numWorkerThreads--;
+        threadPool.taskCompleted.broadcast();
+        threadPool.poolMutex.unlock();
+        return 0;
+    }
+
+    //---------------------------------------------------------------------------------------------------
+    // Parking
+    //---------------------------------------------------------------------------------------------------
+    static void park(ThreadPool& threadPool)
+    {
+        const uint32_t epoch = threadPool.wakeUpEpoch.value.load();
+        threadPool.numSleepingWorkers.fetch_add(1);
+        // Check again after announcing to be sleeping, as producers look for sleeping workers after queuing tasks
+        if (not threadPool.stopRequested.load() and not hasQueuedTasks(threadPool))
+        {
+            // Returns immediately if wakeUpEpoch has already changed (spurious wake ups just restart the search)
+            threadPool.wakeUpEpoch.wait(epoch);
+        }
+        threadPool.numSleepingWorkers.fetch_sub(1);
+    }
+
+    static void wakeUpWorker(ThreadPool& threadPool)
+    {
+        // Orders publishing the task before checking for spinning or sleeping workers
+        atomic_thread_fence(memory_order_seq_cst);
+        if (threadPool.numSpinningWorkers.load() != 0 or threadPool.numSleepingWorkers.load() == 0)
+        {
+            return; // Fast path (no syscall or lock), a spinning worker will find the task
+        }
+        threadPool.wakeUpEpoch.value.fetch_add(1);
+        threadPool.wakeUpEpoch.wakeOne();
+    }
+
+    //---------------------------------------------------------------------------------------------------
+    // ThreadPool methods
+    //---------------------------------------------------------------------------------------------------
+    static void queueTask(ThreadPool& threadPool, Task& task)
+    {
+        threadPool.numPendingTasks.fetch_add(1);
+        Worker* worker = currentWorker;
+        if (worker == nullptr or worker->threadPool != &threadPool)
+        {
+            inject(threadPool.nodes[getCurrentNode(threadPool)], task);
+        }
+        else if (not push(*worker, task))
+        {
+            inject(threadPool.nodes[worker->node], task);
+        }
+        wakeUpWorker(threadPool);
+    }
+
+    static void queueTaskOnNode(ThreadPool& threadPool, Task& task, size_t node)
+    {
+        threadPool.numPendingTasks.fetch_add(1);
+        inject(threadPool.nodes[node], task);
+        wakeUpWorker(threadPool);
+    }
+
+    [[nodiscard]] static Result allocate(ThreadPool& threadPool, size_t numWorkers, const CpuTopology* topology)
+    {
+        const size_t numNodes = topology ? topology->getNumNodes() : 1;
+
+        threadPool.workers = static_cast<Worker*>(Memory::allocate(sizeof(Worker) * numWorkers));
+        threadPool.nodes   = static_cast<Node*>(Memory::allocate(sizeof(Node) * numNodes));
+        if (numNodes > 1)
+        {
+            threadPool.cpuNodes = static_cast<uint16_t*>(Memory::allocate(sizeof(uint16_t) * CpuSet::MaxCpus));
+        }
+        if (threadPool.workers == nullptr or threadPool.nodes == nullptr or
+            (numNodes > 1 and threadPool.cpuNodes == nullptr))
+        {
+            Memory::release(threadPool.workers);
+            Memory::release(threadPool.nodes);
+            Memory::release(threadPool.cpuNodes);
+            threadPool.workers  = nullptr;
+            threadPool.nodes    = nullptr;
+            threadPool.cpuNodes = nullptr;
+            return Result::Error("ThreadPool::create - Cannot allocate workers");
+        }
+        for (size_t idx = 0; idx < numNodes; idx++)
+        {
+            new (&threadPool.nodes[idx], PlacementNew()) Node();
+        }
+        threadPool.numNodes = numNodes;
+        for (size_t idx = 0; idx < numWorkers; idx++)
+        {
+            Worker* worker     = new (&threadPool.workers[idx], PlacementNew()) Worker();
+            worker->threadPool = &threadPool;
+            worker->random     = static_cast<uint32_t>(idx * 2654435761u + 1);
+            if (topology)
+            {
+                worker->node = topology->getCoreNode(static_cast<uint32_t>(idx));
+                worker->cpus = topology->getCoreCpus(static_cast<uint32_t>(idx));
+            }
+        }
+        if (threadPool.cpuNodes)
+        {
+            for (uint32_t cpu = 0; cpu < CpuSet::MaxCpus; ++cpu)
+            {
+                uint32_t core, node;
+                threadPool.cpuNodes[cpu] = static_cast<uint16_t>(topology->getCpu(cpu, core, node) ? node : 0xffff);
+            }
+        }
+        return Result(true);
+    }
+
+    // Must be called with poolMutex locked
+    static void stopWorkers(ThreadPool& threadPool)
+    {
+        threadPool.stopRequested.store(true);
+        threadPool.wakeUpEpoch.value.fetch_add(1);
+        threadPool.wakeUpEpoch.wakeAll();
+    }
+
+    // Frees tasks that have not been executed (after all workers have exited)
+    static void releaseQueuedTasks(ThreadPool& threadPool)
+    {
+        for (size_t idx = 0; idx < threadPool.numWorkers; ++idx)
+        {
+            Worker& worker = threadPool.workers[idx];
+            const int64_t bottom = worker.bottom.load(memory_order_relaxed);
+            for (int64_t pos = worker.top.load(memory_order_relaxed); pos < bottom; ++pos)
+            {
+                worker.tasks[pos & (Worker::Capacity - 1)].load(memory_order_relaxed)->threadPool.store(nullptr);
+            }
+            worker.~Worker();
+        }
+        for (size_t idx = 0; idx < threadPool.numNodes; ++idx)
+        {
+            Node& node = threadPool.nodes[idx];
+            for (Task* task = node.injectionHead; task != nullptr;)
+            {
+                Task* next = task->next.load(memory_order_relaxed);
+                if (task != &node.injectionStub)
+                {
+                    task->threadPool.store(nullptr);
+                }
+                task->next.store(nullptr, memory_order_relaxed);
+                task = next;
+            }
+            node.~Node();
+        }
+        Memory::release(threadPool.workers);
+        Memory::release(threadPool.nodes);
+        Memory::release(threadPool.cpuNodes);
+        threadPool.workers    = nullptr;
+        threadPool.nodes      = nullptr;
+        threadPool.cpuNodes   = nullptr;
+        threadPool.numWorkers = 0;
+        threadPool.numNodes   = 0;
+        threadPool.numPendingTasks.store(0);
+    }
+};
+
+thread_local SC::ThreadPool::Worker* SC::ThreadPool::WorkStealing::currentWorker = nullptr;
+
+SC::Result SC::ThreadPool::create(size_t workerThreads, Scheduling wantedScheduling)
 {
     SC_TRY_MSG(numWorkerThreads == 0, "Cannot create already inited threadpool");
     SC_TRY_MSG(workerThreads > 0, "Cannot create threadpool with 0 worker threads");
 
+    scheduling = wantedScheduling;
+    if (scheduling == Scheduling::WorkStealing)
+    {
+        SC_TRY(WorkStealing::allocate(*this, workerThreads, nullptr));
+    }
+    else
+    {
+        numNodes = 1;
+    }
+    return startWorkerThreads(workerThreads);
+}
+
+SC::Result SC::ThreadPool::create(const CpuTopology& topology)
+{
+    SC_TRY_MSG(numWorkerThreads == 0, "Cannot create already inited threadpool");
+    SC_TRY_MSG(topology.getNumCores() > 0, "Cannot create threadpool with an empty CpuTopology");
+
+    scheduling = Scheduling::WorkStealing;
+    SC_TRY(WorkStealing::allocate(*this, topology.getNumCores(), &topology));
+    return startWorkerThreads(topology.getNumCores());
+}
+
+SC::Result SC::ThreadPool::startWorkerThreads(size_t workerThreads)
+{
+    numWorkers = workerThreads;
+#if SC_THREAD_POOL_STATISTICS
+    SC_TRY(Statistics::create(*this, workerThreads));
+#endif
+
     // Creating threads and detaching them, as they will take care themselves of monitoring the incoming tasks.
     for (size_t idx = 0; idx < workerThreads; idx++)
     {
+        void* argument = this;
+        auto  function = &WorkerThread::execute;
+        if (scheduling == Scheduling::WorkStealing)
+        {
+            argument = &workers[idx];
+            function = &WorkStealing::execute;
+        }
         // Not using SC::Thread to avoid needing to store Function memory
 #if SC_PLATFORM_WINDOWS
         DWORD  threadID;
-        HANDLE thread = ::CreateThread(0, 512 * 1024, &WorkerThread::execute, this, CREATE_SUSPENDED, &threadID);
+        HANDLE thread = ::CreateThread(0, 512 * 1024, function, argument, CREATE_SUSPENDED, &threadID);
         if (thread == nullptr)
         {
             return Result::Error("ThreadPool::create - CreateThread failed");
@@ -120,7 +805,7 @@ SC::Result SC::ThreadPool::create(size_t workerThreads)
         ::CloseHandle(thread);
 #else
         pthread_t thread;
-        const int res = ::pthread_create(&thread, nullptr, &WorkerThread::execute, this);
+        const int res = ::pthread_create(&thread, nullptr, function, argument);
         if (res != 0)
         {
             return Result::Error("ThreadPool::create - pthread_create failed");
@@ -134,6 +819,32 @@ SC::Result SC::ThreadPool::create(size_t workerThreads)
 
 SC::Result SC::ThreadPool::destroy()
 {
+    if (scheduling == Scheduling::WorkStealing)
+    {
+        poolMutex.lock();
+        auto deferUnlock = MakeDeferred([this] { poolMutex.unlock(); });
+        if (numWorkerThreads == 0)
+        {
+            return Result(true); // this was already destroyed
+        }
+        // 1. Request all threads to stop (they will finish the task they're executing)
+        WorkStealing::stopWorkers(*this);
+
+        // 2. Wait for all threads to stop
+        while (numWorkerThreads != 0)
+        {
+            taskCompleted.wait(poolMutex);
+        }
+
+        // 3. Free tasks that have not been executed yet and reset the stop flag
+        WorkStealing::releaseQueuedTasks(*this);
+#if SC_THREAD_POOL_STATISTICS
+        Statistics::release(*this);
+#endif
+        stopRequested.store(false);
+        scheduling = Scheduling::SharedQueue;
+        return Result(true);
+    }
     {
         poolMutex.lock();
         auto deferUnlock = MakeDeferred([this] { poolMutex.unlock(); });
@@ -144,15 +855,15 @@ SC::Result SC::ThreadPool::destroy()
         // 1. Free tasks that have not been executed yet
         while (taskHead)
         {
-            Task* task           = taskHead->next;
-            taskHead->next       = nullptr;
-            taskHead->threadPool = nullptr;
-            taskHead             = task;
+            Task* task = taskHead->next.load(memory_order_relaxed);
+            taskHead->next.store(nullptr, memory_order_relaxed);
+            taskHead->threadPool.store(nullptr, memory_order_relaxed);
+            taskHead = task;
         }
         taskTail = nullptr;
 
         // 2. Request all threads to stop
-        stopRequested = true;
+        stopRequested.store(true);
         taskAvailable.broadcast();
     }
 
@@ -160,7 +871,12 @@ SC::Result SC::ThreadPool::destroy()
     Result res = waitForAllTasks();
 
     // 4. Reset the stop flag
-    stopRequested = false;
+    stopRequested.store(false);
+    numWorkers = 0;
+    numNodes   = 0;
+#if SC_THREAD_POOL_STATISTICS
+    Statistics::release(*this);
+#endif
     return res;
 }
 
@@ -173,10 +889,22 @@ SC::Result SC::ThreadPool::waitForAllTasks()
     {
         return Result(true);
     }
+    if (scheduling == Scheduling::WorkStealing)
+    {
+        // Workers take the mutex to signal completions only when there are waiters
+        numWaiters.fetch_add(1);
+        while (numPendingTasks.load() != 0)
+        {
+            taskCompleted.wait(poolMutex);
+        }
+        numWaiters.fetch_sub(1);
+        return Result(true);
+    }
     for (;;)
     {
-        const bool runningWithPendingTasks    = not stopRequested and (taskHead != nullptr or numRunningTasks != 0);
-        const bool stoppingWithRunningThreads = stopRequested and numWorkerThreads != 0;
+        const bool stopping                   = stopRequested.load(memory_order_relaxed);
+        const bool runningWithPendingTasks    = not stopping and (taskHead != nullptr or numRunningTasks != 0);
+        const bool stoppingWithRunningThreads = stopping and numWorkerThreads != 0;
         if (runningWithPendingTasks or stoppingWithRunningThreads)
         {
             taskCompleted.wait(poolMutex);
@@ -197,9 +925,20 @@ SC::Result SC::ThreadPool::waitForTask(Task& task)
     poolMutex.lock();
     auto deferUnlock = MakeDeferred([this] { poolMutex.unlock(); });
 
+    if (scheduling == Scheduling::WorkStealing)
+    {
+        numWaiters.fetch_add(1);
+        while (task.threadPool.load() == this)
+        {
+            taskCompleted.wait(poolMutex);
+        }
+        numWaiters.fetch_sub(1);
+        return Result(true);
+    }
+
     for (;;)
     {
-        if (task.threadPool == nullptr)
+        if (task.threadPool.load(memory_order_relaxed) == nullptr)
         {
             break; // The task being waited has been flagged as completed
         }
@@ -219,14 +958,32 @@ SC::Result SC::ThreadPool::queueTask(Task& task)
 {
     SC_TRY_MSG(numWorkerThreads > 0, "Cannot queue tasks on an uninitialized threadpool");
 
+    if (scheduling == Scheduling::WorkStealing)
+    {
+        // Lock-free: the task is owned by the pool from here, until a worker frees it after its execution
+        ThreadPool* previous = task.threadPool.load();
+        SC_TRY_MSG(previous != this, "Trying to queue a task that has already been queued");
+        SC_TRY_MSG(previous == nullptr, "Trying to queue a task that is already in use by another threadpool");
+        task.threadPool.store(this, memory_order_relaxed); // Published to workers by inject or push
+#if SC_THREAD_POOL_STATISTICS
+        task.queuedNanoseconds = Statistics::now();
+#endif
+        WorkStealing::queueTask(*this, task);
+        return Result(true);
+    }
+
     // Function is entirely protected by the mutex
     poolMutex.lock();
     auto deferUnlock = MakeDeferred([this] { poolMutex.unlock(); });
 
-    SC_TRY_MSG(task.threadPool != this, "Trying to queue a task that has already been queued");
-    SC_TRY_MSG(task.threadPool == nullptr, "Trying to queue a task that is already in use by another threadpool");
+    ThreadPool* previous = task.threadPool.load(memory_order_relaxed);
+    SC_TRY_MSG(previous != this, "Trying to queue a task that has already been queued");
+    SC_TRY_MSG(previous == nullptr, "Trying to queue a task that is already in use by another threadpool");
 
-    task.threadPool = this;
+    task.threadPool.store(this, memory_order_relaxed);
+#if SC_THREAD_POOL_STATISTICS
+    task.queuedNanoseconds = Statistics::now();
+#endif
     if (taskHead == nullptr)
     {
         // FIFO was empty, replace head and tail with the task
@@ -236,9 +993,181 @@ SC::Result SC::ThreadPool::queueTask(Task& task)
     else
     {
         // FIFO was not empty, append task to the tail
-        taskTail->next = &task;
+        taskTail->next.store(&task, memory_order_relaxed);
         taskTail       = &task;
     }
     taskAvailable.broadcast();
     return Result(true);
 }
+
+SC::Result SC::ThreadPool::queueTaskOnNode(Task& task, size_t node)
+{
+    SC_TRY_MSG(numWorkerThreads > 0, "Cannot queue tasks on an uninitialized threadpool");
+    SC_TRY_MSG(node < numNodes, "ThreadPool::queueTaskOnNode - Invalid node");
+    if (scheduling != Scheduling::WorkStealing)
+    {
+        return queueTask(task); // There is a single queue
+    }
+    ThreadPool* previous = task.threadPool.load();
+    SC_TRY_MSG(previous != this, "Trying to queue a task that has already been queued");
+    SC_TRY_MSG(previous == nullptr, "Trying to queue a task that is already in use by another threadpool");
+    task.threadPool.store(this, memory_order_relaxed);
+#if SC_THREAD_POOL_STATISTICS
+    task.queuedNanoseconds = Statistics::now();
+#endif
+    WorkStealing::queueTaskOnNode(*this, task, node);
+    return Result(true);
+}
+
+//-------------------------------------------------------------------------------------------------------
+// Statistics
+//-------------------------------------------------------------------------------------------------------
+int SC::ThreadPoolHistogram::getBucketIndex(uint64_t nanoseconds)
+{
+    int index = 0;
+    while (nanoseconds > 1 and index < NumBuckets - 1)
+    {
+        nanoseconds >>= 1;
+        index++;
+    }
+    return index;
+}
+
+SC::uint64_t SC::ThreadPoolHistogram::getPercentileNanoseconds(double percentile) const
+{
+    const double wanted = static_cast<double>(count) * percentile / 100.0;
+    uint64_t     sum    = 0;
+    for (int idx = 0; idx < NumBuckets - 1; ++idx)
+    {
+        sum += buckets[idx];
+        if (sum > 0 and static_cast<double>(sum) >= wanted)
+        {
+            const uint64_t upperBound = uint64_t(1) << (idx + 1);
+            return upperBound < maxNanoseconds ? upperBound : maxNanoseconds;
+        }
+    }
+    return maxNanoseconds;
+}
+
+SC::Result SC::ThreadPool::getStatistics(Span<ThreadPoolWorkerStatistics> workerStatistics) const
+{
+#if SC_THREAD_POOL_STATISTICS
+    SC_TRY_MSG(numWorkers > 0, "ThreadPool::getStatistics - Thread pool has not been created");
+    SC_TRY_MSG(workerStatistics.sizeInElements() >= numWorkers,
+               "ThreadPool::getStatistics - Needs one element for each worker thread");
+    const int64_t  elapsed = Statistics::now() - statisticsStartNanoseconds.load(memory_order_relaxed);
+    const uint64_t total   = elapsed > 0 ? static_cast<uint64_t>(elapsed) : 0;
+    for (size_t idx = 0; idx < numWorkers; ++idx)
+    {
+        const Statistics&           source      = statistics[idx];
+        ThreadPoolWorkerStatistics& destination = workerStatistics[idx];
+        source.queueWait.copyTo(destination.queueWait);
+        source.execution.copyTo(destination.execution);
+        // Tasks running right now are not counted as busy time until they're completed
+        destination.busyNanoseconds = source.busyNanoseconds.load(memory_order_relaxed);
+        destination.idleNanoseconds = total > destination.busyNanoseconds ? total - destination.busyNanoseconds : 0;
+    }
+    return Result(true);
+#else
+    SC_COMPILER_UNUSED(workerStatistics);
+    return Result::Error("ThreadPool::getStatistics - Requires SC_THREAD_POOL_STATISTICS == 1");
+#endif
+}
+
+SC::Result SC::ThreadPool::resetStatistics()
+{
+#if SC_THREAD_POOL_STATISTICS
+    SC_TRY_MSG(numWorkers > 0, "ThreadPool::resetStatistics - Thread pool has not been created");
+    for (size_t idx = 0; idx < numWorkers; ++idx)
+    {
+        statistics[idx].queueWait.reset();
+        statistics[idx].execution.reset();
+        statistics[idx].busyNanoseconds.store(0, memory_order_relaxed);
+    }
+    numTraceEvents.store(0);
+    statisticsStartNanoseconds.store(Statistics::now());
+    return Result(true);
+#else
+    return Result::Error("ThreadPool::resetStatistics - Requires SC_THREAD_POOL_STATISTICS == 1");
+#endif
+}
+
+SC::Result SC::ThreadPool::setTraceEvents(Span<ThreadPoolTraceEvent> events)
+{
+#if SC_THREAD_POOL_STATISTICS
+    // Workers read the buffer while recording tasks, so it can be changed only when none of them is running
+    poolMutex.lock();
+    auto deferUnlock = MakeDeferred([this] { poolMutex.unlock(); });
+    if (numWorkerThreads != 0)
+    {
+        const bool idle = scheduling == Scheduling::WorkStealing ? numPendingTasks.load() == 0
+                                                                 : taskHead == nullptr and numRunningTasks == 0;
+        SC_TRY_MSG(idle, "ThreadPool::setTraceEvents - Tasks are queued or running");
+    }
+    traceEvents         = events.data();
+    traceEventsCapacity = events.sizeInElements();
+    numTraceEvents.store(0);
+    return Result(true);
+#else
+    SC_COMPILER_UNUSED(events);
+    return Result::Error("ThreadPool::setTraceEvents - Requires SC_THREAD_POOL_STATISTICS == 1");
+#endif
+}
+
+SC::Span<const SC::ThreadPoolTraceEvent> SC::ThreadPool::getTraceEvents() const
+{
+#if SC_THREAD_POOL_STATISTICS
+    const size_t numEvents = numTraceEvents.load();
+    return {traceEvents, numEvents < traceEventsCapacity ? numEvents : traceEventsCapacity};
+#else
+    return {};
+#endif
+}
+
+SC::Result SC::ThreadPool::writeChromeTrace(StringFormatOutput& output) const
+{
+#if SC_THREAD_POOL_STATISTICS
+    // Complete events ("ph":"X") with timestamps and durations in microseconds, one thread for each worker
+    const StringView integer;
+    const StringView decimal(".3");
+    output.onFormatBegin();
+    bool res = output.append("{\"traceEvents\":["_a8);
+    for (uint32_t idx = 0; res and idx < static_cast<uint32_t>(numWorkers); ++idx)
+    {
+        res = output.append(idx == 0 ? "\n"_a8 : ",\n"_a8) and
+              output.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"_a8) and
+              StringFormatterFor<uint32_t>::format(output, integer, idx) and
+              output.append(",\"args\":{\"name\":\"ThreadPool Worker "_a8) and
+              StringFormatterFor<uint32_t>::format(output, integer, idx) and output.append("\"}}"_a8);
+    }
+    for (const ThreadPoolTraceEvent& event : getTraceEvents())
+    {
+        if (not res)
+        {
+            break;
+        }
+        const double startMicroseconds = static_cast<double>(event.startNanoseconds) / 1000.0;
+        const double duration          = static_cast<double>(event.endNanoseconds - event.startNanoseconds) / 1000.0;
+        const double queueWait = static_cast<double>(event.startNanoseconds - event.queuedNanoseconds) / 1000.0;
+
+        res = output.append(",\n{\"name\":\"Task\",\"cat\":\"ThreadPool\",\"ph\":\"X\",\"pid\":1,\"tid\":"_a8) and
+              StringFormatterFor<uint32_t>::format(output, integer, event.workerIndex) and
+              output.append(",\"ts\":"_a8) and
+              StringFormatterFor<double>::format(output, decimal, startMicroseconds) and
+              output.append(",\"dur\":"_a8) and StringFormatterFor<double>::format(output, decimal, duration) and
+              output.append(",\"args\":{\"queueWaitUs\":"_a8) and
+              StringFormatterFor<double>::format(output, decimal, queueWait) and output.append("}}"_a8);
+    }
+    res = res and output.append("\n]}\n"_a8);
+    if (not res)
+    {
+        output.onFormatFailed();
+        return Result::Error("ThreadPool::writeChromeTrace - Cannot write to output");
+    }
+    SC_TRY_MSG(output.onFormatSucceeded(), "ThreadPool::writeChromeTrace - Cannot write to output");
+    return Result(true);
+#else
+    SC_COMPILER_UNUSED(output);
+    return Result::Error("ThreadPool::writeChromeTrace - Requires SC_THREAD_POOL_STATISTICS == 1");
+#endif
+}
@@ -1,12 +1,23 @@
 // Copyright (c) Stefano Cristiano
 // SPDX-License-Identifier: MIT
 #pragma once
+#include "../Foundation/Span.h"
 #include "Threading.h"
 
+#if !defined(SC_THREAD_POOL_STATISTICS)
+/// @brief Set to 1 (for example in `SCConfig.h`) to let SC::ThreadPool record queue wait and run time of all tasks
+#define SC_THREAD_POOL_STATISTICS 0
+#endif
+
 namespace SC
 {
 struct ThreadPool;
 struct ThreadPoolTask;
+struct CpuTopology;
+struct ThreadPoolHistogram;
+struct ThreadPoolWorkerStatistics;
+struct ThreadPoolTraceEvent;
+struct StringFormatOutput;
 } // namespace SC
 
 //! @addtogroup group_threading
@@ -21,46 +32,170 @@ struct SC::ThreadPoolTask
     Function<void()> function; ///< Function that will be executed during the task
   private:
     friend struct ThreadPool;
-    ThreadPool*     threadPool = nullptr;
-    ThreadPoolTask* next       = nullptr;
+    Atomic<ThreadPool*>     threadPool = nullptr; // Pool where the task is queued or running (nullptr when free)
+    Atomic<ThreadPoolTask*> next       = nullptr;
+#if SC_THREAD_POOL_STATISTICS
+    int64_t queuedNanoseconds = 0; // When ThreadPool::queueTask has been called
+#endif
+};
+
+/// @brief Distribution of durations in power of two buckets of nanoseconds
+struct SC::ThreadPoolHistogram
+{
+    static constexpr int NumBuckets = 32; ///< Number of buckets (the last one holds all durations longer than ~2s)
+
+    uint64_t buckets[NumBuckets] = {0}; ///< Bucket `i` counts durations in [2^i, 2^(i+1)) nanoseconds
+    uint64_t count               = 0;   ///< Number of durations recorded
+    uint64_t totalNanoseconds    = 0;   ///< Sum of all durations recorded
+    uint64_t maxNanoseconds      = 0;   ///< Longest duration recorded
+
+    /// @brief Returns index of the bucket counting a duration
+    [[nodiscard]] static int getBucketIndex(uint64_t nanoseconds);
+
+    /// @brief Returns average duration (or 0 if nothing has been recorded)
+    [[nodiscard]] uint64_t getAverageNanoseconds() const { return count > 0 ? totalNanoseconds / count : 0; }
+
+    /// @brief Returns the upper bound of the bucket containing the given percentile (between 0 and 100)
+    [[nodiscard]] uint64_t getPercentileNanoseconds(double percentile) const;
+};
+
+/// @brief Snapshot of tasks executed by a ThreadPool worker thread, obtained with ThreadPool::getStatistics
+struct SC::ThreadPoolWorkerStatistics
+{
+    ThreadPoolHistogram queueWait; ///< Time between ThreadPool::queueTask and a worker starting the task
+    ThreadPoolHistogram execution; ///< Time spent executing task functions
+
+    uint64_t busyNanoseconds = 0; ///< Time spent executing tasks since creation (or ThreadPool::resetStatistics)
+    uint64_t idleNanoseconds = 0; ///< Time spent waiting for tasks since creation (or ThreadPool::resetStatistics)
+
+    /// @brief Returns the fraction of time (between 0 and 1) spent executing tasks
+    [[nodiscard]] double getUtilization() const
+    {
+        const uint64_t total = busyNanoseconds + idleNanoseconds;
+        return total > 0 ? static_cast<double>(busyNanoseconds) / static_cast<double>(total) : 0.0;
+    }
+};
+
+/// @brief Execution of a task, recorded in the buffer passed to ThreadPool::setTraceEvents
+struct SC::ThreadPoolTraceEvent
+{
+    uint32_t workerIndex       = 0; ///< Index of the worker thread that has executed the task
+    int64_t  queuedNanoseconds = 0; ///< When the task has been queued (relative to ThreadPool::resetStatistics)
+    int64_t  startNanoseconds  = 0; ///< When the task has been started (relative to ThreadPool::resetStatistics)
+    int64_t  endNanoseconds    = 0; ///< When the task has been completed (relative to ThreadPool::resetStatistics)
 };
 
 /// @brief Simple thread pool that executes tasks in a fixed number of worker threads.
 ///
 /// This class is not copyable / moveable due to it containing Mutex and Condition variable.
-/// Additionally, this class does not allocate any memory by itself, and expects the caller to supply
+/// Additionally, this class does not allocate any memory for tasks, and expects the caller to supply
 /// SC::ThreadPool::Task objects.
 ///
+/// Tasks can be distributed to worker threads with one of the ThreadPool::Scheduling modes:
+/// - ThreadPool::Scheduling::SharedQueue (default) uses a single FIFO protected by a mutex.
+///   It's simple and fair, but all workers contend on the same lock, limiting throughput of many short tasks.
+/// - ThreadPool::Scheduling::WorkStealing gives each worker a fixed size Chase-Lev deque.
+///   Tasks queued from outside the pool go through a lock-free injection queue, while tasks queued by a running task
+///   are pushed to the deque of its worker (and run in LIFO order). Idle workers steal the oldest tasks of other
+///   workers, spin for a while and finally park on a futex (where available), so that queuing a task doesn't need
+///   any lock or syscall unless some worker is sleeping. Deques are allocated once in ThreadPool::create.
+///
+/// ThreadPool::create can also take a SC::CpuTopology, to use Scheduling::WorkStealing with one worker for each
+/// physical core, pinned to its SMT siblings (where supported, see SC::Thread::setAffinity).
+/// Every NUMA node gets its own injection queue, and idle workers look for tasks on their own node before stealing
+/// from other nodes, so that tasks tend to run close to the memory touched by who queued them.
+/// Tasks queued from outside the pool go to the node of the processor running the calling thread (where it can be
+/// known, or to the next node otherwise), unless ThreadPool::queueTaskOnNode explicitly picks one.
+///
 /// @warning The caller is responsible of keeping Task address stable until the it will be completed.
 /// If it's not already completed the task must still be valid during ThreadPool::destroy or ThreadPool destructor.
 ///
 /// Example:
 /// @snippet Libraries/Threading/Tests/ThreadPoolTest.cpp threadPoolSnippet
 ///
+/// When `SC_THREAD_POOL_STATISTICS` is defined to 1, every task is timestamped when queued, started and completed.
+/// Each worker keeps histograms of queue wait and execution time of its tasks, together with its busy / idle time,
+/// that can be obtained with ThreadPool::getStatistics. Executions can also be recorded to a caller supplied buffer
+/// (see ThreadPool::setTraceEvents) and written as Chrome Trace Event JSON (to be loaded in `chrome://tracing` or
+/// [Perfetto](https://ui.perfetto.dev)) with ThreadPool::writeChromeTrace.
+/// With the default `SC_THREAD_POOL_STATISTICS == 0` none of this code or data exists, and such methods return errors.
+///
+/// @snippet Libraries/Threading/Tests/ThreadPoolTest.cpp threadPoolStatisticsSnippet
+///
 struct SC::ThreadPool
 {
     using Task = ThreadPoolTask;
 
+    /// @brief How queued tasks are distributed to worker threads
+    enum class Scheduling
+    {
+        SharedQueue,  ///< A single FIFO queue protected by a mutex
+        WorkStealing, ///< Per-worker deques, lock-free injection queue and stealing between idle workers
+    };
+
     ThreadPool() = default;
     ~ThreadPool() { (void)destroy(); }
 
     /// @brief Create a thread pool with the requested number of worker threads
-    [[nodiscard]] Result create(size_t workerThreads);
+    /// @param workerThreads Number of worker threads
+    /// @param scheduling How tasks are distributed to worker threads (see ThreadPool::Scheduling)
+    [[nodiscard]] Result create(size_t workerThreads, Scheduling scheduling = Scheduling::SharedQueue);
+
+    /// @brief Create a Scheduling::WorkStealing thread pool with one worker thread for each physical core
+    /// @param topology Cores and nodes where workers are placed (for example obtained with CpuTopology::detect)
+    /// @note Pinning workers to their core is best effort (it can be denied by the OS or not be supported)
+    [[nodiscard]] Result create(const CpuTopology& topology);
 
     /// @brief Destroy the thread pool created previously with ThreadPool::create
     /// @warning Tasks that are queued will NOT be executed (but you can use ThreadPool::waitForAllTasks for that)
     [[nodiscard]] Result destroy();
 
-    /// @brief Queue a task (that should not be already in use)
+    /// @brief Queue a task (that should not be already in use).
+    /// With Scheduling::WorkStealing, tasks queued from a task running in this pool go to the deque of its worker.
     [[nodiscard]] Result queueTask(Task& task);
 
+    /// @brief Queue a task (that should not be already in use) on the injection queue of a given NUMA node
+    /// @param task Task to be executed (preferably by a worker of the given node)
+    /// @param node Index of the node (smaller than ThreadPool::getNumNodes)
+    [[nodiscard]] Result queueTaskOnNode(Task& task, size_t node);
+
     /// @brief Blocks execution until all queued and pending tasks will be fully completed
     [[nodiscard]] Result waitForAllTasks();
 
     /// @brief Blocks execution until all queued and pending tasks will be fully completed
     [[nodiscard]] Result waitForTask(Task& task);
 
+    /// @brief Returns the number of worker threads (0 if the pool has not been created)
+    [[nodiscard]] size_t getNumWorkerThreads() const { return numWorkers; }
+
+    /// @brief Returns the number of NUMA nodes with a dedicated queue (1 unless created with a SC::CpuTopology)
+    [[nodiscard]] size_t getNumNodes() const { return numNodes; }
+
+    /// @brief Copies statistics of each worker thread (requires `SC_THREAD_POOL_STATISTICS == 1`)
+    /// @param workerStatistics One element for each worker thread (see ThreadPool::getNumWorkerThreads)
+    [[nodiscard]] Result getStatistics(Span<ThreadPoolWorkerStatistics> workerStatistics) const;
+
+    /// @brief Clears statistics and trace events, restarting the measurement of busy / idle time from now
+    [[nodiscard]] Result resetStatistics();
+
+    /// @brief Records (until full) an event for every executed task (requires `SC_THREAD_POOL_STATISTICS == 1`)
+    /// @param events Caller owned buffer, that must be valid until the pool is destroyed (or another call)
+    /// @note It fails if tasks are queued or running, so it must be called before create or when the pool is idle
+    /// (for example after ThreadPool::waitForAllTasks) and not while other threads are queuing tasks.
+    /// Buffers set before create are released by destroy.
+    [[nodiscard]] Result setTraceEvents(Span<ThreadPoolTraceEvent> events);
+
+    /// @brief Returns events recorded so far in the buffer passed to ThreadPool::setTraceEvents
+    /// @note Events are complete only after ThreadPool::waitForAllTasks (or ThreadPool::waitForTask) has returned
+    [[nodiscard]] Span<const ThreadPoolTraceEvent> getTraceEvents() const;
+
+    /// @brief Writes recorded trace events as Chrome Trace Event JSON (one thread for each worker)
+    /// @note It must be called when no task is running (for example after ThreadPool::waitForAllTasks)
+    [[nodiscard]] Result writeChromeTrace(StringFormatOutput& output) const;
+
   private:
+    [[nodiscard]] Result startWorkerThreads(size_t workerThreads);
+
     Task* taskHead = nullptr; // Head of the FIFO linked list containing all threads
     Task* taskTail = nullptr; // Tail of the FIFO linked list containing all threads
 
@@ -71,9 +206,40 @@ struct SC::ThreadPool
     ConditionVariable taskAvailable; // Signals to worker threads that there is a new queued task available
     ConditionVariable taskCompleted; // Signals to threadpool that there is a new task that was completed
 
-    bool stopRequested = false; // Signals background threads to end their infinite task processing loop
+    Atomic<bool> stopRequested = false; // Signals background threads to end their infinite task processing loop
+
+    // Scheduling::WorkStealing state
+    struct Worker;
+    struct Node;
+    Scheduling scheduling = Scheduling::SharedQueue;
+    Worker*    workers    = nullptr; // Per-worker deques (numWorkers elements)
+    size_t     numWorkers = 0;       // Number of worker threads created (and of elements in workers)
+    Node*      nodes      = nullptr; // Per-node injection queues (numNodes elements)
+    size_t     numNodes   = 0;       // Number of NUMA nodes (and of elements in nodes)
+    uint16_t*  cpuNodes   = nullptr; // Node of every processor (CpuSet::MaxCpus elements, if numNodes > 1)
+
+    Atomic<int64_t> nextNode        = 0; // Round robin node for tasks queued from unknown processors
+    Atomic<int64_t> numPendingTasks = 0; // Queued or running tasks
+
+    Atomic<int32_t> numSpinningWorkers = 0; // Workers looking for tasks before parking
+    Atomic<int32_t> numSleepingWorkers = 0; // Workers parked (or about to park) waiting for wakeUpEpoch to change
+    Futex           wakeUpEpoch;            // Incremented to wake up parked workers
+    Atomic<int32_t> numWaiters         = 0; // Threads waiting on taskCompleted
 
     struct WorkerThread;
+    struct WorkStealing;
+
+#if SC_THREAD_POOL_STATISTICS
+    struct Statistics;
+    Statistics* statistics = nullptr; // One element for each worker thread
+
+    Atomic<int64_t>  statisticsStartNanoseconds = 0; // Origin of trace events and of busy / idle time
+    Atomic<uint32_t> numStartedWorkers          = 0; // Assigns statistics to Scheduling::SharedQueue workers
+
+    ThreadPoolTraceEvent* traceEvents         = nullptr;
+    size_t                traceEventsCapacity = 0;
+    Atomic<size_t>        numTraceEvents      = 0; // Can be larger than capacity (events that have been dropped)
+#endif
 };
 
 //! @}
@@ -46,24 +46,230 @@ SC::Result SC::Thread::detach()
 
 bool SC::Thread::wasStarted() const { return thread.hasValue(); }
 
-void SC::EventObject::wait()
+SC::Result SC::Thread::setAffinity(const CpuSet& cpus)
 {
-    mutex.lock();
-    while (not isSignaled)
+    OpaqueThread* threadNative;
+    SC_TRY_MSG(thread.get(threadNative), "Thread::setAffinity - Thread has not been started");
+    SC_TRY_MSG(not cpus.isEmpty(), "Thread::setAffinity - Empty CpuSet");
+    return Internal::setAffinity(threadNative->reinterpret_as<Internal::NativeHandle>(), cpus);
+}
+
+SC::Result SC::Thread::SetCurrentThreadAffinity(const CpuSet& cpus)
+{
+    SC_TRY_MSG(not cpus.isEmpty(), "Thread::SetCurrentThreadAffinity - Empty CpuSet");
+    return Internal::setAffinity(Internal::currentThread(), cpus);
+}
+
+SC::uint32_t SC::CpuSet::count() const
+{
+    uint32_t numCpus = 0;
+    for (uint64_t word : words)
     {
-        cond.wait(mutex);
+        for (; word != 0; word &= word - 1) // Clears lowest set bit
+        {
+            numCpus++;
+        }
     }
-    if (autoReset)
+    return numCpus;
+}
+
+#if !SC_PLATFORM_LINUX
+// Checking value with the mutex locked ensures that a wake up (locking the mutex after changing value) is not lost
+void SC::Futex::wait(uint32_t expected)
+{
+    mutex.lock();
+    if (value.load() == expected)
     {
-        isSignaled = false;
+        condition.wait(mutex);
     }
     mutex.unlock();
 }
 
-void SC::EventObject::signal()
+void SC::Futex::wakeOne()
+{
+    mutex.lock();
+    mutex.unlock();
+    condition.signal();
+}
+
+void SC::Futex::wakeAll()
 {
     mutex.lock();
-    isSignaled = true;
     mutex.unlock();
-    cond.signal();
+    condition.broadcast();
+}
+#endif
+
+struct SC::EventObject::Internal
+{
+    static constexpr uint32_t NotSignaled = 0;
+    static constexpr uint32_t Signaled    = 1;
+    static constexpr uint32_t Waiting     = 2; // Not signaled, some thread could be sleeping on it
+};
+
+void SC::EventObject::wait()
+{
+    bool hasSlept = false;
+    for (;;)
+    {
+        uint32_t current = state.value.load(memory_order_acquire);
+        if (current == Internal::Signaled)
+        {
+            if (not autoReset)
+            {
+                return;
+            }
+            // A thread that has slept can't know if other ones are still sleeping, so it leaves Waiting behind
+            const uint32_t reset = hasSlept ? Internal::Waiting : Internal::NotSignaled;
+            if (state.value.compare_exchange_weak(current, reset, memory_order_acquire))
+            {
+                return;
+            }
+            continue;
+        }
+        if (current == Internal::NotSignaled and
+            not state.value.compare_exchange_weak(current, Internal::Waiting, memory_order_relaxed))
+        {
+            continue;
+        }
+        state.wait(Internal::Waiting);
+        hasSlept = true;
+    }
+}
+
+void SC::EventObject::signal()
+{
+    if (state.value.exchange(Internal::Signaled, memory_order_acq_rel) == Internal::Waiting)
+    {
+        if (autoReset)
+        {
+            state.wakeOne();
+        }
+        else
+        {
+            state.wakeAll();
+        }
+    }
+}
+
+bool SC::Semaphore::tryAcquire()
+{
+    uint32_t current = count.value.load(memory_order_relaxed);
+    while (current > 0)
+    {
+        if (count.value.compare_exchange_weak(current, current - 1, memory_order_acquire, memory_order_relaxed))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SC::Semaphore::acquire()
+{
+    while (not tryAcquire())
+    {
+        // Announces the waiter before blocking, so that a release() either sees it or changes count
+        numWaiters.fetch_add(1);
+        count.wait(0);
+        numWaiters.fetch_sub(1, memory_order_relaxed);
+    }
+}
+
+void SC::Semaphore::release(uint32_t units)
+{
+    count.value.fetch_add(units);
+    if (numWaiters.load() != 0)
+    {
+        if (units == 1)
+        {
+            count.wakeOne();
+        }
+        else
+        {
+            count.wakeAll();
+        }
+    }
+}
+
+struct SC::ReadWriteLock::Internal
+{
+    static constexpr uint32_t Writer        = 1u << 31; // A writer holds the lock
+    static constexpr uint32_t Waiting       = 1u << 30; // Some thread could be sleeping on the lock
+    static constexpr uint32_t WriterPending = 1u << 29; // A writer is waiting (blocks new readers)
+    static constexpr uint32_t ReadersMask   = WriterPending - 1;
+
+    // Clears Waiting and wakes up all sleepers, that will compete again for the lock
+    static void wakeUpWaiters(Futex& state)
+    {
+        if (state.value.fetch_and(~Waiting) & Waiting)
+        {
+            state.wakeAll();
+        }
+    }
+};
+
+void SC::ReadWriteLock::lockRead()
+{
+    uint32_t current = state.value.load(memory_order_relaxed);
+    for (;;)
+    {
+        if ((current & (Internal::Writer | Internal::WriterPending)) == 0)
+        {
+            if (state.value.compare_exchange_weak(current, current + 1, memory_order_acquire, memory_order_relaxed))
+            {
+                return;
+            }
+            continue;
+        }
+        const uint32_t waiting = current | Internal::Waiting;
+        if (current != waiting and not state.value.compare_exchange_weak(current, waiting, memory_order_relaxed))
+        {
+            continue;
+        }
+        state.wait(waiting);
+        current = state.value.load(memory_order_relaxed);
+    }
+}
+
+void SC::ReadWriteLock::unlockRead()
+{
+    const uint32_t current = state.value.fetch_sub(1, memory_order_release) - 1;
+    if ((current & Internal::ReadersMask) == 0 and (current & Internal::Waiting) != 0)
+    {
+        Internal::wakeUpWaiters(state); // Last reader lets a pending writer in
+    }
+}
+
+void SC::ReadWriteLock::lockWrite()
+{
+    uint32_t current = state.value.load(memory_order_relaxed);
+    for (;;)
+    {
+        if ((current & (Internal::Writer | Internal::ReadersMask)) == 0)
+        {
+            const uint32_t locked = (current | Internal::Writer) & ~Internal::WriterPending;
+            if (state.value.compare_exchange_weak(current, locked, memory_order_acquire, memory_order_relaxed))
+            {
+                return;
+            }
+            continue;
+        }
+        const uint32_t waiting = current | Internal::Waiting | Internal::WriterPending;
+        if (current != waiting and not state.value.compare_exchange_weak(current, waiting, memory_order_relaxed))
+        {
+            continue;
+        }
+        state.wait(waiting);
+        current = state.value.load(memory_order_relaxed);
+    }
+}
+
+void SC::ReadWriteLock::unlockWrite()
+{
+    const uint32_t previous = state.value.fetch_and(~Internal::Writer, memory_order_release);
+    if (previous & Internal::Waiting)
+    {
+        Internal::wakeUpWaiters(state);
+    }
 }
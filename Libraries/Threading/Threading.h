@@ -4,14 +4,19 @@
 #include "../Foundation/AlignedStorage.h"
 #include "../Foundation/Function.h"
 #include "../Foundation/Result.h"
+#include "Atomic.h"
 #include "Internal/Optional.h" // UniqueOptional
 
 namespace SC
 {
 struct Thread;
+struct CpuSet;
 struct ConditionVariable;
 struct Mutex;
+struct Futex;
 struct EventObject;
+struct Semaphore;
+struct ReadWriteLock;
 } // namespace SC
 
 //! @defgroup group_threading Threading
@@ -20,7 +25,12 @@ struct EventObject;
 //! @addtogroup group_threading
 //! @{
 
-/// @brief A native OS mutex to synchronize access to shared resources.
+/// @brief A mutex to synchronize access to shared resources.
+///
+/// On Linux it's a futex word (plus a spin estimate), that doesn't make any syscall when it's not contended.
+/// A thread finding it locked spins for a short while (only if no other thread is already sleeping on it), as the owner
+/// is likely to release it soon, before going to sleep. How long it spins adapts to how many spins were needed to
+/// acquire the same mutex recently. On other platforms it wraps the native OS mutex.
 ///
 /// Example:
 /// @snippet Libraries/Threading/Tests/ThreadingTest.cpp mutexSnippet
@@ -49,6 +59,9 @@ struct SC::Mutex
 #elif SC_PLATFORM_EMSCRIPTEN
     static constexpr int OpaqueMutexSize      = sizeof(void*) * 6 + sizeof(long);
     static constexpr int OpaqueMutexAlignment = alignof(long);
+#elif SC_PLATFORM_LINUX
+    static constexpr int OpaqueMutexSize      = sizeof(uint32_t) * 2; // Futex word and spin estimate
+    static constexpr int OpaqueMutexAlignment = alignof(uint32_t);
 #else
     static constexpr int OpaqueMutexSize      = sizeof(void*) * 6;
     static constexpr int OpaqueMutexAlignment = alignof(long);
@@ -58,7 +71,9 @@ struct SC::Mutex
     OpaqueMutex mutex;
 };
 
-/// @brief A native OS condition variable.
+/// @brief A condition variable (futex based on Linux, native OS condition variable elsewhere).
+///
+/// On Linux ConditionVariable::signal and ConditionVariable::broadcast don't make any syscall if no thread is waiting.
 struct SC::ConditionVariable
 {
     ConditionVariable();
@@ -84,6 +99,9 @@ struct SC::ConditionVariable
 #elif SC_PLATFORM_EMSCRIPTEN
     static constexpr int OpaqueCVSize         = sizeof(void*) * 12;
     static constexpr int OpaqueCVAlignment    = alignof(long);
+#elif SC_PLATFORM_LINUX
+    static constexpr int OpaqueCVSize         = sizeof(uint32_t) * 2; // Futex sequence and number of waiters
+    static constexpr int OpaqueCVAlignment    = alignof(uint32_t);
 #else
     static constexpr int OpaqueCVSize         = sizeof(void*) * 6;
     static constexpr int OpaqueCVAlignment    = alignof(long);
@@ -94,6 +112,88 @@ struct SC::ConditionVariable
     OpaqueConditionVariable condition;
 };
 
+/// @brief A 32 bit atomic value that threads can block on until it changes.
+///
+/// It's the building block of SC::EventObject, SC::Semaphore and SC::ReadWriteLock, that change Futex::value with
+/// atomic operations and call Futex::wait / Futex::wakeOne / Futex::wakeAll only when a thread needs to block.
+/// It's a `futex` on Linux (4 bytes) and it's emulated with a SC::Mutex and a SC::ConditionVariable elsewhere.
+struct SC::Futex
+{
+    Atomic<uint32_t> value;
+
+    Futex(uint32_t value = 0) : value(value) {}
+
+    Futex(const Futex&)            = delete;
+    Futex(Futex&&)                 = delete;
+    Futex& operator=(const Futex&) = delete;
+    Futex& operator=(Futex&&)      = delete;
+
+    /// @brief Blocks the calling thread if Futex::value is equal to expected, until woken up.
+    /// @note It can return spuriously, so it must be called in a loop checking Futex::value
+    void wait(uint32_t expected);
+
+    /// @brief Wakes up one of the threads blocked in Futex::wait (to be called after modifying Futex::value)
+    void wakeOne();
+
+    /// @brief Wakes up all threads blocked in Futex::wait (to be called after modifying Futex::value)
+    void wakeAll();
+
+  private:
+#if !SC_PLATFORM_LINUX
+    Mutex             mutex;
+    ConditionVariable condition;
+#endif
+};
+
+/// @brief A set of logical processors, used to pin threads to them with SC::Thread::setAffinity.
+///
+/// Processors are identified by the index used by the OS (see SC::CpuTopology to find SMT siblings and NUMA nodes).
+struct SC::CpuSet
+{
+    static constexpr uint32_t MaxCpus = 1024; ///< Maximum number of logical processors that can be added to the set
+
+    /// @brief Adds a processor to the set
+    /// @return `false` if cpu is not smaller than CpuSet::MaxCpus
+    [[nodiscard]] bool add(uint32_t cpu)
+    {
+        if (cpu >= MaxCpus)
+            return false;
+        words[cpu / BitsPerWord] |= uint64_t(1) << (cpu % BitsPerWord);
+        return true;
+    }
+
+    /// @brief Removes a processor from the set
+    void remove(uint32_t cpu)
+    {
+        if (cpu < MaxCpus)
+            words[cpu / BitsPerWord] &= ~(uint64_t(1) << (cpu % BitsPerWord));
+    }
+
+    /// @brief Returns `true` if the set contains the given processor
+    [[nodiscard]] bool contains(uint32_t cpu) const
+    {
+        return cpu < MaxCpus and (words[cpu / BitsPerWord] & (uint64_t(1) << (cpu % BitsPerWord))) != 0;
+    }
+
+    /// @brief Returns the number of processors in the set
+    [[nodiscard]] uint32_t count() const;
+
+    /// @brief Returns `true` if the set doesn't contain any processor
+    [[nodiscard]] bool isEmpty() const { return count() == 0; }
+
+    /// @brief Removes all processors from the set
+    void clear()
+    {
+        for (uint64_t& word : words)
+            word = 0;
+    }
+
+  private:
+    static constexpr uint32_t BitsPerWord = 64;
+
+    uint64_t words[MaxCpus / BitsPerWord] = {0};
+};
+
 /// @brief A native OS thread.
 ///
 /// Example:
@@ -114,6 +214,10 @@ struct SC::ConditionVariable
 /// @endcode
 ///
 /// @warning Thread destructor will assert if SC::Thread::detach() or SC::Thread::join() has not been called.
+///
+/// Threads can be pinned to a set of processors with Thread::setAffinity (or Thread::SetCurrentThreadAffinity) and
+/// their scheduling priority can be changed with Thread::SetCurrentThreadPriority:
+/// @snippet Libraries/Threading/Tests/ThreadingTest.cpp threadAffinitySnippet
 struct SC::Thread
 {
     Thread() = default;
@@ -158,6 +262,31 @@ struct SC::Thread
     /// @param milliseconds Sleep for given number of milliseconds
     static void Sleep(uint32_t milliseconds);
 
+    /// @brief Scheduling priority of a thread, relative to other threads of the process
+    enum class Priority
+    {
+        Lowest,
+        Low,
+        Normal,
+        High,
+        Highest,
+    };
+
+    /// @brief Restricts this (started) thread to run only on the given processors
+    /// @note On Windows only processors of the first processor group (0 to 63) can be used.
+    /// It's not supported on macOS (that exposes only affinity hints).
+    [[nodiscard]] Result setAffinity(const CpuSet& cpus);
+
+    /// @brief Restricts the calling thread to run only on the given processors (see Thread::setAffinity)
+    [[nodiscard]] static Result SetCurrentThreadAffinity(const CpuSet& cpus);
+
+    /// @brief Obtains the set of processors where the calling thread is allowed to run
+    [[nodiscard]] static Result GetCurrentThreadAffinity(CpuSet& cpus);
+
+    /// @brief Changes scheduling priority of the calling thread
+    /// @note Raising priority over Priority::Normal (or restoring it, on Linux) can require additional privileges
+    [[nodiscard]] static Result SetCurrentThreadPriority(Priority priority);
+
   private:
     void setThreadNameInternal(const native_char_t* name);
     struct Internal;
@@ -167,6 +296,9 @@ struct SC::Thread
 };
 
 /// @brief An automatically reset event object to synchronize two threads.
+///
+/// It's built on a SC::Futex, so that EventObject::signal doesn't make any syscall (or take any lock) unless a thread
+/// is blocked in EventObject::wait, and EventObject::wait doesn't block if the event is already signaled.
 /// @n
 /// Example:
 /// @snippet Libraries/Threading/Tests/ThreadingTest.cpp eventObjectSnippet
@@ -181,10 +313,60 @@ struct SC::EventObject
     void signal();
 
   private:
-    bool  isSignaled = false;
-    Mutex mutex;
+    struct Internal;
+    Futex state; // Internal::NotSignaled, Internal::Signaled or Internal::Waiting
+};
+
+/// @brief A counting semaphore.
+///
+/// Semaphore::acquire and Semaphore::release don't make any syscall unless a thread needs to block (or be woken up).
+///
+/// Example:
+/// @snippet Libraries/Threading/Tests/ThreadingTest.cpp semaphoreSnippet
+struct SC::Semaphore
+{
+    /// @brief Creates the semaphore with initialCount available units
+    Semaphore(uint32_t initialCount = 0) : count(initialCount) {}
+
+    /// @brief Takes one unit, blocking until one is available
+    void acquire();
+
+    /// @brief Takes one unit, only if it's available
+    /// @return `true` if a unit has been taken
+    [[nodiscard]] bool tryAcquire();
+
+    /// @brief Adds units, waking up threads blocked in Semaphore::acquire
+    void release(uint32_t units = 1);
+
+  private:
+    Futex            count;
+    Atomic<uint32_t> numWaiters = 0;
+};
+
+/// @brief A lock allowing multiple concurrent readers or a single writer.
+///
+/// Locking and unlocking don't make any syscall when there is no contention.
+/// Writers are preferred: once a writer is waiting, new readers wait for it to acquire and release the lock.
+///
+/// Example:
+/// @snippet Libraries/Threading/Tests/ThreadingTest.cpp readWriteLockSnippet
+struct SC::ReadWriteLock
+{
+    /// @brief Acquires shared (read) access, blocking while a writer holds (or waits for) the lock
+    void lockRead();
+
+    /// @brief Releases shared (read) access
+    void unlockRead();
+
+    /// @brief Acquires exclusive (write) access, blocking while readers or another writer hold the lock
+    void lockWrite();
 
-    ConditionVariable cond;
+    /// @brief Releases exclusive (write) access
+    void unlockWrite();
+
+  private:
+    struct Internal;
+    Futex state; // Number of readers and Internal flags
 };
 
 //! @}
@@ -161,6 +161,17 @@ SC::Time::Relative SC::Time::HighResolutionCounter::getRelative() const
 #endif
 }
 
+SC::int64_t SC::Time::HighResolutionCounter::toNanoseconds() const
+{
+    constexpr int64_t secondsToNanoseconds = 1000000000;
+#if SC_PLATFORM_WINDOWS
+    // Split in whole seconds and remainder to avoid overflowing when multiplying ticks by 1e9
+    return (part1 / part2) * secondsToNanoseconds + ((part1 % part2) * secondsToNanoseconds) / part2;
+#else
+    return part1 * secondsToNanoseconds + part2;
+#endif
+}
+
 [[nodiscard]] SC::Time::HighResolutionCounter SC::Time::HighResolutionCounter::subtractExact(
     HighResolutionCounter other) const
 {
@@ -164,6 +164,10 @@ struct SC::Time::HighResolutionCounter
 
     Relative getRelative() const;
 
+    /// @brief Converts this counter (or an interval obtained with HighResolutionCounter::subtractExact) to nanoseconds
+    /// @return Number of nanoseconds represented by this counter
+    [[nodiscard]] int64_t toNanoseconds() const;
+
     int64_t part1;
     int64_t part2;
 
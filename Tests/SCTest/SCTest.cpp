@@ -4,17 +4,27 @@
 namespace SC
 {
 struct TestReport;
+// Algorithms
+void runAlgorithmSimdTest(TestReport& report);
+void runAlgorithmSortTest(TestReport& report);
+
 // Build
 void runBuildTest(TestReport& report);
 
 // Foundation
 void runBaseTest(TestReport& report);
+void runMemoryTest(TestReport& report);
 void runArenaMapTest(TestReport& report);
+void runChunkedArenaMapTest(TestReport& report);
 void runArrayTest(TestReport& report);
 void runIntrusiveDoubleLinkedListTest(TestReport& report);
 void runSmallVectorTest(TestReport& report);
 void runVectorMapTest(TestReport& report);
 void runVectorSetTest(TestReport& report);
+void runSortedVectorMapTest(TestReport& report);
+void runSortedVectorSetTest(TestReport& report);
+void runHashMapTest(TestReport& report);
+void runHashSetTest(TestReport& report);
 void runVectorTest(TestReport& report);
 void runFunctionTest(TestReport& report);
 void runUniqueHandleTest(TestReport& report);
@@ -42,6 +52,8 @@ void runHashingTest(TestReport& report);
 void runHttpClientTest(TestReport& report);
 void runHttpParserTest(TestReport& report);
 void runHttpServerTest(TestReport& report);
+void runHttpRouterTest(TestReport& report);
+void runHttpWebSocketTest(TestReport& report);
 void runHttpURLParserTest(TestReport& report);
 
 // Plugin
@@ -52,6 +64,7 @@ void runProcessTest(TestReport& report);
 
 // Reflection
 void runReflectionTest(TestReport& report);
+void runSoAVectorTest(TestReport& report);
 
 // Serialization
 void runSerializationBinaryTest(TestReport& report);
@@ -76,8 +89,15 @@ void runTimeTest(TestReport& report);
 
 // Threading
 void runAtomicTest(TestReport& report);
+void runCpuTopologyTest(TestReport& report);
+void runConcurrentHashMapTest(TestReport& report);
+void runEpochReclamationTest(TestReport& report);
+void runJobSystemTest(TestReport& report);
+void runLockFreeQueueTest(TestReport& report);
 void runThreadingTest(TestReport& report);
 void runThreadPoolTest(TestReport& report);
+void runParallelAlgorithmsTest(TestReport& report);
+void runTaskGraphTest(TestReport& report);
 
 // Async
 void runAsyncTest(SC::TestReport& report);
@@ -125,10 +145,16 @@ int main(int argc, const char* argv[])
 
     globalConsole = &console;
 
+    // Algorithms tests
+    runAlgorithmSimdTest(report);
+    runAlgorithmSortTest(report);
+
     // Foundation tests
     runArenaMapTest(report);
+    runChunkedArenaMapTest(report);
     runArrayTest(report);
     runBaseTest(report);
+    runMemoryTest(report);
     runFunctionTest(report);
     runIntrusiveDoubleLinkedListTest(report);
     runUniqueHandleTest(report);
@@ -138,6 +164,10 @@ int main(int argc, const char* argv[])
     runVectorTest(report);
     runVectorMapTest(report);
     runVectorSetTest(report);
+    runSortedVectorMapTest(report);
+    runSortedVectorSetTest(report);
+    runHashMapTest(report);
+    runHashSetTest(report);
 
     // File tests
     runFileDescriptorTest(report);
@@ -160,6 +190,8 @@ int main(int argc, const char* argv[])
     runHttpParserTest(report);
     runHttpClientTest(report);
     runHttpServerTest(report);
+    runHttpRouterTest(report);
+    runHttpWebSocketTest(report);
     runHttpURLParserTest(report);
 
     // Plugin tests
@@ -170,6 +202,7 @@ int main(int argc, const char* argv[])
 
     // Reflection tests
     runReflectionTest(report);
+    runSoAVectorTest(report);
 
     // Serialization tests
     runSerializationBinaryTest(report);
@@ -194,8 +227,15 @@ int main(int argc, const char* argv[])
 
     // Threading tests
     runAtomicTest(report);
+    runCpuTopologyTest(report);
+    runConcurrentHashMapTest(report);
+    runEpochReclamationTest(report);
+    runJobSystemTest(report);
+    runLockFreeQueueTest(report);
     runThreadingTest(report);
     runThreadPoolTest(report);
+    runParallelAlgorithmsTest(report);
+    runTaskGraphTest(report);
 
     // Async tests
     runAsyncTest(report);
@@ -0,0 +1,14 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+
+// Same configuration of SCTest, with optional library features enabled to test them
+#include "../SCTest/SCConfig.h"
+
+// Records queue wait and execution time of ThreadPool tasks (see SC::ThreadPool)
+#define SC_THREAD_POOL_STATISTICS 1
+
+// Uses the caching allocator of SC::Memory (see SC::Memory and SC::MemoryStatistics)
+#define SC_MEMORY_CACHING_ALLOCATOR 1
+
+// Attributes memory of containers to SC_MEMORY_TAG sites (see SC::Memory::getTagStatistics)
+#define SC_MEMORY_TAGGING 1
@@ -0,0 +1,355 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../Libraries/Algorithms/AlgorithmMergeSort.h"
+#include "../Libraries/Algorithms/AlgorithmQuickSort.h"
+#include "../Libraries/Algorithms/AlgorithmRadixSort.h"
+#include "../Libraries/Algorithms/AlgorithmSimd.h"
+#include "../Libraries/Containers/Vector.h"
+#include "../Libraries/Foundation/LibC.h" // memchr, memcmp, memcpy
+#include "../Libraries/Strings/Console.h"
+#include "../Libraries/Time/Time.h"
+#include "Tools.h"
+
+namespace SC
+{
+namespace Tools
+{
+// Measures average picoseconds per item of SC::Algorithms.
+// - simd: finds, counts, gets minimum / maximum, compares and removes items with a mask, once for every SIMD level
+//   supported by the CPU (see Algorithms::Simd). Items are searched to the end of the array (worst case).
+//   memchr and memcmp of the C library are measured too as a reference.
+// - sort: sorts uint32_t items with heapSort, quickSort, mergeSort and radixSort, once for every distribution of
+//   input values (random, sorted, reversed and few unique). Copying input items before every sort is measured too.
+//
+// Usage:
+//  SC-algorithmsbench simd [-n numItems]
+//  SC-algorithmsbench sort [-n numItems]
+struct AlgorithmsBenchOptions
+{
+    uint32_t numItems = 65536;
+
+    [[nodiscard]] Result parse(Span<const StringView> arguments)
+    {
+        for (size_t idx = 0; idx < arguments.sizeInElements(); ++idx)
+        {
+            const StringView arg = arguments[idx];
+            SC_TRY_MSG(idx + 1 < arguments.sizeInElements(), "SC-algorithmsbench - Missing option value");
+            int32_t value = 0;
+            SC_TRY_MSG(arguments[idx + 1].parseInt32(value) and value > 0, "SC-algorithmsbench - Invalid option value");
+            idx++;
+            if (arg == "-n")
+                numItems = static_cast<uint32_t>(value);
+            else
+                return Result::Error("SC-algorithmsbench - Unknown option (supported -n)");
+        }
+        return Result(true);
+    }
+};
+
+// Prints text padded with spaces to width (string formatting doesn't support alignment)
+static void printColumn(Console& console, StringView text, size_t width, bool alignRight)
+{
+    const StringView spaces    = "                              ";
+    const size_t     numSpaces = text.sizeInBytes() < width ? width - text.sizeInBytes() : 0;
+    if (alignRight)
+        console.print(spaces.sliceStartLength(0, numSpaces));
+    console.print(text);
+    if (not alignRight)
+        console.print(spaces.sliceStartLength(0, numSpaces));
+}
+
+struct AlgorithmsBenchSimd
+{
+    static constexpr uint64_t ItemsPerMeasure = 64 * 1024 * 1024; // Items processed by every measure (at least once)
+
+    enum class Operation
+    {
+        FindUInt8,
+        FindUInt32,
+        FindFloat,
+        CountUInt8,
+        CountUInt32,
+        MinMaxInt32,
+        MinMaxFloat,
+        MismatchUInt8,
+        RemoveMaskedUInt32,
+        MemchrUInt8,
+        MemcmpUInt8,
+    };
+
+    static constexpr const char* OperationNames[] = {
+        "find uint8_t",          "find uint32_t",  "find float",     "count uint8_t",
+        "count uint32_t",        "minmax int32_t", "minmax float",   "findMismatch uint8_t",
+        "removeMasked uint32_t", "memchr (libc)",  "memcmp (libc)",
+    };
+
+    Vector<uint8_t>  bytes;
+    Vector<uint8_t>  bytesCopy;
+    Vector<uint32_t> integers;
+    Vector<uint32_t> integersWork;
+    Vector<float>    floats;
+    Vector<uint8_t>  removeMask;
+
+    [[nodiscard]] Result init(uint32_t numItems)
+    {
+        SC_TRY(bytes.resizeWithoutInitializing(numItems));
+        SC_TRY(integers.resizeWithoutInitializing(numItems));
+        SC_TRY(integersWork.resizeWithoutInitializing(numItems));
+        SC_TRY(floats.resizeWithoutInitializing(numItems));
+        SC_TRY(removeMask.resizeWithoutInitializing(numItems));
+        for (uint32_t idx = 0; idx < numItems; ++idx)
+        {
+            // Searched value (255) is found only in the last item
+            bytes[idx]      = idx + 1 == numItems ? 255 : static_cast<uint8_t>(idx % 251);
+            integers[idx]   = idx + 1 == numItems ? 0xffffffff : idx * 2654435761u % 0xfffffff0u;
+            floats[idx]     = idx + 1 == numItems ? -1.0f : static_cast<float>(idx % 1000);
+            removeMask[idx] = (idx / 64) % 4 == 3 ? 1 : static_cast<uint8_t>(idx % 5 == 0); // runs of removed items
+        }
+        SC_TRY(bytesCopy.append(bytes.toSpanConst()));
+        return Result(true);
+    }
+
+    // Returns a value depending on results, so that operations can't be optimized away
+    [[nodiscard]] size_t execute(Operation operation)
+    {
+        using namespace Algorithms;
+        const size_t numItems = bytes.size();
+        switch (operation)
+        {
+        case Operation::FindUInt8: return findValue(bytes.toSpanConst(), static_cast<uint8_t>(255));
+        case Operation::FindUInt32: return findValue(integers.toSpanConst(), 0xffffffffu);
+        case Operation::FindFloat: return findValue(floats.toSpanConst(), -1.0f);
+        case Operation::CountUInt8: return countValue(bytes.toSpanConst(), static_cast<uint8_t>(7));
+        case Operation::CountUInt32: return countValue(integers.toSpanConst(), 0xffffffffu);
+        case Operation::MinMaxInt32: {
+            int32_t minValue, maxValue;
+            const Span<const int32_t> values = {reinterpret_cast<const int32_t*>(integers.data()), numItems};
+            (void)findMinMax(values, minValue, maxValue);
+            return static_cast<size_t>(maxValue - minValue);
+        }
+        case Operation::MinMaxFloat: {
+            float minValue, maxValue;
+            (void)findMinMax(floats.toSpanConst(), minValue, maxValue);
+            return static_cast<size_t>(maxValue - minValue);
+        }
+        case Operation::MismatchUInt8: return findMismatch(bytes.toSpanConst(), bytesCopy.toSpanConst());
+        case Operation::RemoveMaskedUInt32: {
+            ::memcpy(integersWork.data(), integers.data(), numItems * sizeof(uint32_t));
+            return removeMasked(integersWork.toSpan(), removeMask.toSpanConst());
+        }
+        case Operation::MemchrUInt8: {
+            const void* found = ::memchr(bytes.data(), 255, numItems);
+            return static_cast<size_t>(static_cast<const uint8_t*>(found) - bytes.data());
+        }
+        case Operation::MemcmpUInt8: return ::memcmp(bytes.data(), bytesCopy.data(), numItems) == 0 ? numItems : 0;
+        }
+        Assert::unreachable();
+    }
+
+    // Executes operation until ItemsPerMeasure items are processed, returning average picoseconds per item
+    [[nodiscard]] int64_t measure(Operation operation, size_t& checksum)
+    {
+        using Counter = Time::HighResolutionCounter;
+
+        const uint64_t numItems  = bytes.size();
+        const uint64_t numRounds = ItemsPerMeasure / numItems + 1;
+        const Counter  start     = Counter().snap();
+        for (uint64_t round = 0; round < numRounds; ++round)
+        {
+            checksum += execute(operation);
+        }
+        const Counter end = Counter().snap();
+        return end.subtractExact(start).toNanoseconds() * 1000 / static_cast<int64_t>(numRounds * numItems);
+    }
+
+    [[nodiscard]] static Result run(Console& console, const AlgorithmsBenchOptions& options)
+    {
+        using namespace Algorithms;
+        AlgorithmsBenchSimd bench;
+        SC_TRY(bench.init(options.numItems));
+
+        const SimdLevel allLevels[] = {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::NEON};
+        SimdLevel       levels[4];
+        size_t          numLevels = 0;
+        for (SimdLevel level : allLevels)
+        {
+            if (Simd::setLevel(level) == level)
+                levels[numLevels++] = level;
+        }
+
+        console.print("Average picoseconds per item ({} items)\n", options.numItems);
+        printColumn(console, "", 22, false);
+        for (size_t idx = 0; idx < numLevels; ++idx)
+        {
+            const char* levelName = Simd::getLevelName(levels[idx]);
+            printColumn(console, StringView::fromNullTerminated(levelName, StringEncoding::Ascii), 9, true);
+        }
+        console.print("\n");
+        for (size_t operation = 0; operation < TypeTraits::SizeOfArray(OperationNames); ++operation)
+        {
+            const char* name = OperationNames[operation];
+            printColumn(console, StringView::fromNullTerminated(name, StringEncoding::Ascii), 22, false);
+            // Results must be the same at all levels
+            size_t expected = 0;
+            for (size_t idx = 0; idx < numLevels; ++idx)
+            {
+                (void)Simd::setLevel(levels[idx]);
+                size_t checksum = 0;
+                console.print("{:9}", bench.measure(static_cast<Operation>(operation), checksum));
+                SC_TRY_MSG(idx == 0 or checksum == expected, "SC-algorithmsbench - Results differ between levels");
+                expected = checksum;
+                if (static_cast<Operation>(operation) >= Operation::MemchrUInt8)
+                    break; // C library functions don't depend on the level
+            }
+            console.print("\n");
+        }
+        (void)Simd::setLevel(Simd::getSupportedLevel());
+        return Result(true);
+    }
+};
+
+constexpr const char* AlgorithmsBenchSimd::OperationNames[];
+
+struct AlgorithmsBenchSort
+{
+    static constexpr uint64_t ItemsPerMeasure = 4 * 1024 * 1024; // Items sorted by every measure (at least once)
+
+    enum class Algorithm
+    {
+        HeapSort,
+        QuickSort,
+        MergeSort,
+        RadixSort,
+    };
+
+    enum class Distribution
+    {
+        Random,
+        Sorted,
+        Reversed,
+        FewUnique,
+    };
+
+    static constexpr const char* AlgorithmNames[]    = {"heapSort", "quickSort", "mergeSort", "radixSort"};
+    static constexpr const char* DistributionNames[] = {"random", "sorted", "reversed", "few unique"};
+
+    Vector<uint32_t> input;
+    Vector<uint32_t> items;
+    Vector<uint32_t> scratch;
+
+    [[nodiscard]] Result init(uint32_t numItems)
+    {
+        SC_TRY(input.resizeWithoutInitializing(numItems));
+        SC_TRY(items.resizeWithoutInitializing(numItems));
+        SC_TRY(scratch.resizeWithoutInitializing(numItems));
+        return Result(true);
+    }
+
+    void fill(Distribution distribution)
+    {
+        const uint32_t numItems = static_cast<uint32_t>(input.size());
+        uint32_t       random   = 1;
+        for (uint32_t idx = 0; idx < numItems; ++idx)
+        {
+            random ^= random << 13; // xorshift32
+            random ^= random >> 17;
+            random ^= random << 5;
+            switch (distribution)
+            {
+            case Distribution::Random: input[idx] = random; break;
+            case Distribution::Sorted: input[idx] = idx; break;
+            case Distribution::Reversed: input[idx] = numItems - idx; break;
+            case Distribution::FewUnique: input[idx] = random % 16; break;
+            }
+        }
+    }
+
+    // Returns a value depending on results, so that sorts can't be optimized away
+    [[nodiscard]] size_t execute(Algorithm algorithm)
+    {
+        using namespace Algorithms;
+        const size_t numItems = input.size();
+        ::memcpy(items.data(), input.data(), numItems * sizeof(uint32_t));
+        switch (algorithm)
+        {
+        case Algorithm::HeapSort: heapSort(items.begin(), items.end()); break;
+        case Algorithm::QuickSort: quickSort(items.begin(), items.end()); break;
+        case Algorithm::MergeSort: mergeSort(items.begin(), items.end(), scratch.begin()); break;
+        case Algorithm::RadixSort: radixSort(items.begin(), items.end(), scratch.begin()); break;
+        }
+        return items[0] + items[numItems / 2] + items[numItems - 1];
+    }
+
+    // Sorts until ItemsPerMeasure items are processed, returning average picoseconds per item
+    [[nodiscard]] int64_t measure(Algorithm algorithm, size_t& checksum)
+    {
+        using Counter = Time::HighResolutionCounter;
+
+        const uint64_t numItems  = input.size();
+        const uint64_t numRounds = ItemsPerMeasure / numItems + 1;
+        const Counter  start     = Counter().snap();
+        for (uint64_t round = 0; round < numRounds; ++round)
+        {
+            checksum += execute(algorithm);
+        }
+        const Counter end = Counter().snap();
+        return end.subtractExact(start).toNanoseconds() * 1000 / static_cast<int64_t>(numRounds * numItems);
+    }
+
+    [[nodiscard]] static Result run(Console& console, const AlgorithmsBenchOptions& options)
+    {
+        AlgorithmsBenchSort bench;
+        SC_TRY(bench.init(options.numItems));
+
+        console.print("Average picoseconds per item ({} items)\n", options.numItems);
+        printColumn(console, "", 12, false);
+        for (const char* name : DistributionNames)
+        {
+            printColumn(console, StringView::fromNullTerminated(name, StringEncoding::Ascii), 12, true);
+        }
+        console.print("\n");
+        for (size_t algorithm = 0; algorithm < TypeTraits::SizeOfArray(AlgorithmNames); ++algorithm)
+        {
+            const char* name = AlgorithmNames[algorithm];
+            printColumn(console, StringView::fromNullTerminated(name, StringEncoding::Ascii), 12, false);
+            for (size_t distribution = 0; distribution < TypeTraits::SizeOfArray(DistributionNames); ++distribution)
+            {
+                bench.fill(static_cast<Distribution>(distribution));
+                // Results must be the same for all algorithms
+                const size_t expected = bench.execute(Algorithm::HeapSort);
+                SC_TRY_MSG(bench.execute(static_cast<Algorithm>(algorithm)) == expected,
+                           "SC-algorithmsbench - Results differ between algorithms");
+                size_t checksum = 0;
+                console.print("{:12}", bench.measure(static_cast<Algorithm>(algorithm), checksum));
+            }
+            console.print("\n");
+        }
+        return Result(true);
+    }
+};
+
+constexpr const char* AlgorithmsBenchSort::AlgorithmNames[];
+constexpr const char* AlgorithmsBenchSort::DistributionNames[];
+
+[[nodiscard]] Result runAlgorithmsBenchTool(Tool::Arguments& arguments)
+{
+    AlgorithmsBenchOptions options;
+    SC_TRY(options.parse(arguments.arguments));
+    if (arguments.action == "simd")
+    {
+        return AlgorithmsBenchSimd::run(arguments.console, options);
+    }
+    else if (arguments.action == "sort")
+    {
+        return AlgorithmsBenchSort::run(arguments.console, options);
+    }
+    return Result::Error("SC-algorithmsbench unknown action (supported \"simd\" and \"sort\")");
+}
+
+#if !defined(SC_LIBRARY_PATH) && !defined(SC_TOOLS_IMPORT)
+StringView Tool::getToolName() { return "SC-algorithmsbench"; }
+StringView Tool::getDefaultAction() { return "simd"; }
+Result     Tool::runTool(Tool::Arguments& arguments) { return runAlgorithmsBenchTool(arguments); }
+#endif
+} // namespace Tools
+} // namespace SC
@@ -88,11 +88,14 @@ void addSaneCppLibraries(Project& project, const Parameters& parameters)
     }
 }
 
-static constexpr StringView TEST_PROJECT_NAME = "SCTest";
+static constexpr StringView TEST_PROJECT_NAME          = "SCTest";
+static constexpr StringView TEST_FEATURES_PROJECT_NAME = "SCTestFeatures";
 
-Result buildTestProject(const Parameters& parameters, Project& project)
+// configDirectory is the path of the SCConfig.h used to build libraries and tests
+Result buildTestProject(const Parameters& parameters, Project& project, StringView projectName,
+                        StringView configDirectory)
 {
-    project = {TargetType::Executable, TEST_PROJECT_NAME};
+    project = {TargetType::Executable, projectName};
 
     // All relative paths are evaluated from this project root directory.
     project.setRootDirectory(parameters.directories.libraryDirectory.view());
@@ -108,13 +111,13 @@ Result buildTestProject(const Parameters& parameters, Project& project)
 
     // Includes
     project.compile.addIncludes({
-        ".",            // Libraries path (for PluginTest)
-        "Tests/SCTest", // SCConfig.h path (enabled by SC_COMPILER_ENABLE_CONFIG == 1)
+        ".",             // Libraries path (for PluginTest)
+        configDirectory, // SCConfig.h path (enabled by SC_COMPILER_ENABLE_CONFIG == 1)
     });
 
     addSaneCppLibraries(project, parameters);
     project.addDirectory("Tests/SCTest", "*.cpp"); // add all .cpp from SCTest directory
-    project.addDirectory("Tests/SCTest", "*.h");   // add all .h from SCTest directory
+    project.addDirectory(configDirectory, "*.h");  // add SCConfig.h
     project.addDirectory("Tools", "SC-*.cpp");     // add all tools
     project.addDirectory("Tools", "*.h");          // add tools headers
     project.addDirectory("Tools", "*Test.cpp");    // add tools tests
@@ -192,9 +195,11 @@ Result buildExampleProject(const Parameters& parameters, Project& project)
 Result configure(Definition& definition, const Parameters& parameters)
 {
     Workspace workspace = {"SCTest"};
-    SC_TRY(workspace.projects.resize(2));
-    SC_TRY(buildTestProject(parameters, workspace.projects[0]));
+    SC_TRY(workspace.projects.resize(3));
+    SC_TRY(buildTestProject(parameters, workspace.projects[0], TEST_PROJECT_NAME, "Tests/SCTest"));
     SC_TRY(buildExampleProject(parameters, workspace.projects[1]));
+    // Same tests, with optional features (SC_MEMORY_CACHING_ALLOCATOR, SC_MEMORY_TAGGING...) enabled
+    SC_TRY(buildTestProject(parameters, workspace.projects[2], TEST_FEATURES_PROJECT_NAME, "Tests/SCTestFeatures"));
     definition.workspaces.push_back(move(workspace));
     return Result(true);
 }
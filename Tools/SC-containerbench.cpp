@@ -0,0 +1,266 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../Libraries/Containers/HashMap.h"
+#include "../Libraries/Containers/SortedVectorMap.h"
+#include "../Libraries/Containers/SortedVectorSet.h"
+#include "../Libraries/Containers/Vector.h"
+#include "../Libraries/Containers/VectorMap.h"
+#include "../Libraries/Strings/Console.h"
+#include "../Libraries/Strings/String.h"
+#include "../Libraries/Strings/StringBuilder.h"
+#include "../Libraries/Time/Time.h"
+#include "Tools.h"
+
+namespace SC
+{
+namespace Tools
+{
+// Measures average nanoseconds per operation of map containers against the number of items they hold.
+// - map: inserts, finds and removes all keys of HashMap and VectorMap, with uint32_t and String keys.
+//   VectorMap operations are linear in the number of items, so it's measured only up to -v items.
+// - lookup: finds all uint32_t keys in a SortedVectorSet (SIMD search), in a SortedVectorMap (binary search) and in a
+//   HashMap, built once with all keys.
+//
+// Usage:
+//  SC-containerbench map [-n maxItems] [-v maxVectorMapItems]
+//  SC-containerbench lookup [-n maxItems]
+struct ContainerBenchOptions
+{
+    uint32_t maxItems          = 65536;
+    uint32_t maxVectorMapItems = 4096;
+
+    [[nodiscard]] Result parse(Span<const StringView> arguments)
+    {
+        for (size_t idx = 0; idx < arguments.sizeInElements(); ++idx)
+        {
+            const StringView arg = arguments[idx];
+            SC_TRY_MSG(idx + 1 < arguments.sizeInElements(), "SC-containerbench - Missing option value");
+            int32_t value = 0;
+            SC_TRY_MSG(arguments[idx + 1].parseInt32(value) and value > 0, "SC-containerbench - Invalid option value");
+            idx++;
+            if (arg == "-n")
+                maxItems = static_cast<uint32_t>(value);
+            else if (arg == "-v")
+                maxVectorMapItems = static_cast<uint32_t>(value);
+            else
+                return Result::Error("SC-containerbench - Unknown option (supported -n -v)");
+        }
+        return Result(true);
+    }
+};
+
+struct ContainerBenchMap
+{
+    static constexpr uint32_t OperationsPerSize = 1000000; // Operations repeated at every size (at least one round)
+
+    struct Timings
+    {
+        int64_t insert = 0;
+        int64_t find   = 0;
+        int64_t remove = 0;
+    };
+
+    // Inserts, finds and removes all keys, numRounds times, returning average nanoseconds per operation
+    template <typename Map, typename Key>
+    [[nodiscard]] static Result measure(Span<const Key> keys, uint32_t numRounds, Timings& timings)
+    {
+        using Counter = Time::HighResolutionCounter;
+
+        int64_t insert = 0, find = 0, remove = 0;
+        for (uint32_t round = 0; round < numRounds; ++round)
+        {
+            Map map;
+
+            Counter start = Counter().snap();
+            for (size_t idx = 0; idx < keys.sizeInElements(); ++idx)
+            {
+                SC_TRY_MSG(map.insertIfNotExists({keys[idx], static_cast<uint32_t>(idx)}),
+                           "SC-containerbench - Insert failed");
+            }
+            Counter end = Counter().snap();
+            insert += end.subtractExact(start).toNanoseconds();
+
+            start          = end;
+            size_t numHits = 0;
+            for (size_t idx = 0; idx < keys.sizeInElements(); ++idx)
+            {
+                const uint32_t* value = map.get(keys[idx]);
+                numHits += (value != nullptr and *value == idx) ? 1 : 0;
+            }
+            end = Counter().snap();
+            find += end.subtractExact(start).toNanoseconds();
+            SC_TRY_MSG(numHits == keys.sizeInElements(), "SC-containerbench - Find failed");
+
+            start = end;
+            for (size_t idx = 0; idx < keys.sizeInElements(); ++idx)
+            {
+                SC_TRY_MSG(map.remove(keys[idx]), "SC-containerbench - Remove failed");
+            }
+            end = Counter().snap();
+            remove += end.subtractExact(start).toNanoseconds();
+            SC_TRY_MSG(map.isEmpty(), "SC-containerbench - Map is not empty after removing all keys");
+        }
+        const int64_t numOperations = static_cast<int64_t>(numRounds) * static_cast<int64_t>(keys.sizeInElements());
+        timings.insert              = insert / numOperations;
+        timings.find                = find / numOperations;
+        timings.remove              = remove / numOperations;
+        return Result(true);
+    }
+
+    template <typename Key>
+    [[nodiscard]] static Result run(Console& console, const ContainerBenchOptions& options, Span<const Key> allKeys)
+    {
+        console.print("    items        insert    find  remove          insert    find  remove\n");
+        for (uint32_t numItems = 16; numItems <= options.maxItems; numItems *= 4)
+        {
+            const Span<const Key> keys      = {allKeys.data(), numItems};
+            const uint32_t        numRounds = numItems < OperationsPerSize ? OperationsPerSize / numItems : 1;
+
+            Timings hashMap;
+            SC_TRY((measure<HashMap<Key, uint32_t>, Key>(keys, numRounds, hashMap)));
+            console.print("  {:7}     {:7} {:7} {:7}", numItems, hashMap.insert, hashMap.find, hashMap.remove);
+            if (numItems <= options.maxVectorMapItems)
+            {
+                // VectorMap is much slower, so it's measured on a fraction of the rounds
+                Timings vectorMap;
+                SC_TRY((measure<VectorMap<Key, uint32_t>, Key>(keys, numRounds / 16 + 1, vectorMap)));
+                console.print("         {:7} {:7} {:7}", vectorMap.insert, vectorMap.find, vectorMap.remove);
+            }
+            console.print("\n");
+        }
+        return Result(true);
+    }
+};
+
+struct ContainerBenchLookup
+{
+    static constexpr uint32_t LookupsPerSize = 4000000; // Lookups repeated at every size (at least one round)
+
+    // Finds all keys (half of them missing) numRounds times, returning average nanoseconds per lookup
+    template <typename Container>
+    [[nodiscard]] static Result measure(const Container& container, Span<const uint32_t> keys, uint32_t numRounds,
+                                        int64_t& nanoseconds)
+    {
+        using Counter = Time::HighResolutionCounter;
+
+        size_t        numHits = 0;
+        const Counter start   = Counter().snap();
+        for (uint32_t round = 0; round < numRounds; ++round)
+        {
+            for (size_t idx = 0; idx < keys.sizeInElements(); ++idx)
+            {
+                numHits += container.contains(keys[idx]) ? 1 : 0;
+            }
+        }
+        const Counter end = Counter().snap();
+        SC_TRY_MSG(numHits * 2 == keys.sizeInElements() * numRounds, "SC-containerbench - Lookup failed");
+        const int64_t numLookups = static_cast<int64_t>(numRounds) * static_cast<int64_t>(keys.sizeInElements());
+        nanoseconds              = end.subtractExact(start).toNanoseconds() / numLookups;
+        return Result(true);
+    }
+
+    [[nodiscard]] static Result run(Console& console, const ContainerBenchOptions& options,
+                                    Span<const uint32_t> allKeys)
+    {
+        console.print("Average nanoseconds per lookup (half of the keys are missing)\n");
+        console.print("    items  SortedVectorSet SortedVectorMap         HashMap\n");
+        for (uint32_t numItems = 16; numItems <= options.maxItems; numItems *= 4)
+        {
+            // Containers hold the keys at even indices, and all keys are looked up
+            SortedVectorSet<uint32_t>           set;
+            SortedVectorMap<uint32_t, uint32_t> sortedMap;
+            HashMap<uint32_t, uint32_t>         hashMap;
+            for (uint32_t idx = 0; idx < numItems; idx += 2)
+            {
+                SC_TRY(set.items.push_back(allKeys[idx]));
+                SC_TRY(sortedMap.items.push_back({allKeys[idx], idx}));
+                SC_TRY(hashMap.insertIfNotExists({allKeys[idx], idx}));
+            }
+            SC_TRY(set.sortItems());
+            SC_TRY(sortedMap.sortItems());
+
+            const Span<const uint32_t> keys      = {allKeys.data(), numItems};
+            const uint32_t             numRounds = numItems < LookupsPerSize ? LookupsPerSize / numItems : 1;
+
+            int64_t setTime = 0, sortedMapTime = 0, hashMapTime = 0;
+            SC_TRY(measure(set, keys, numRounds, setTime));
+            SC_TRY(measure(sortedMap, keys, numRounds, sortedMapTime));
+            SC_TRY(measure(hashMap, keys, numRounds, hashMapTime));
+            console.print("  {:7}          {:7}         {:7}         {:7}\n", numItems, setTime, sortedMapTime,
+                          hashMapTime);
+        }
+        return Result(true);
+    }
+};
+
+[[nodiscard]] uint32_t getContainerBenchMaxItems(const ContainerBenchOptions& options)
+{
+    uint32_t maxItems = 16;
+    while (maxItems * 4 <= options.maxItems)
+    {
+        maxItems *= 4;
+    }
+    return maxItems;
+}
+
+[[nodiscard]] Result getContainerBenchKeys(uint32_t maxItems, Vector<uint32_t>& integerKeys)
+{
+    SC_TRY(integerKeys.reserve(maxItems));
+    for (uint32_t idx = 0; idx < maxItems; ++idx)
+    {
+        SC_TRY(integerKeys.push_back(idx * 2654435761u)); // Distinct keys, because the multiplier is odd
+    }
+    return Result(true);
+}
+
+[[nodiscard]] Result runContainerBenchLookup(Console& console, const ContainerBenchOptions& options)
+{
+    Vector<uint32_t> integerKeys;
+    SC_TRY(getContainerBenchKeys(getContainerBenchMaxItems(options), integerKeys));
+    return ContainerBenchLookup::run(console, options, integerKeys.toSpanConst());
+}
+
+[[nodiscard]] Result runContainerBenchMap(Console& console, const ContainerBenchOptions& options)
+{
+    const uint32_t maxItems = getContainerBenchMaxItems(options);
+    Vector<uint32_t> integerKeys;
+    Vector<String>   stringKeys;
+    SC_TRY(getContainerBenchKeys(maxItems, integerKeys));
+    SC_TRY(stringKeys.reserve(maxItems));
+    for (uint32_t key : integerKeys)
+    {
+        String stringKey;
+        SC_TRY(StringBuilder(stringKey).format("key_{}", key));
+        SC_TRY(stringKeys.push_back(move(stringKey)));
+    }
+
+    console.print("Average nanoseconds per operation (HashMap on the left, VectorMap on the right)\n");
+    console.print("uint32_t keys:\n");
+    SC_TRY(ContainerBenchMap::run<uint32_t>(console, options, integerKeys.toSpanConst()));
+    console.print("String keys:\n");
+    SC_TRY(ContainerBenchMap::run<String>(console, options, stringKeys.toSpanConst()));
+    return Result(true);
+}
+
+[[nodiscard]] Result runContainerBenchTool(Tool::Arguments& arguments)
+{
+    ContainerBenchOptions options;
+    SC_TRY(options.parse(arguments.arguments));
+    if (arguments.action == "map")
+    {
+        return runContainerBenchMap(arguments.console, options);
+    }
+    else if (arguments.action == "lookup")
+    {
+        return runContainerBenchLookup(arguments.console, options);
+    }
+    return Result::Error("SC-containerbench unknown action (supported \"map\", \"lookup\")");
+}
+
+#if !defined(SC_LIBRARY_PATH) && !defined(SC_TOOLS_IMPORT)
+StringView Tool::getToolName() { return "SC-containerbench"; }
+StringView Tool::getDefaultAction() { return "map"; }
+Result     Tool::runTool(Tool::Arguments& arguments) { return runContainerBenchTool(arguments); }
+#endif
+} // namespace Tools
+} // namespace SC
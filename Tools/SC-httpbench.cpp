@@ -0,0 +1,598 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../Libraries/Async/Async.h"
+#include "../Libraries/Containers/ArenaMap.h"
+#include "../Libraries/Http/HttpParser.h"
+#include "../Libraries/Http/HttpServer.h"
+#include "../Libraries/Http/HttpURLParser.h"
+#include "../Libraries/Socket/SocketDescriptor.h"
+#include "../Libraries/Strings/Console.h"
+#include "../Libraries/Threading/Threading.h"
+#include "Tools.h"
+
+namespace SC
+{
+namespace Tools
+{
+// Load generator for http servers, opening keep-alive connections on one or more AsyncEventLoop (one per thread).
+// Every connection sends a request, waits for the full response and sends the next one.
+// - Closed-loop (default): next request is sent as soon as the previous response has been received
+// - Fixed-rate (-R): requests follow a fixed schedule. Latency is measured from the instant the request was supposed
+//   to be sent, so that a slow server delaying the schedule doesn't hide queuing time (coordinated omission).
+//
+// Usage:
+//  SC-httpbench self [-c connections] [-t threads] [-d seconds] [-R requestsPerSecond] [-p port]
+//  SC-httpbench run http://127.0.0.1:8080/ [-c connections] [-t threads] [-d seconds] [-R requestsPerSecond]
+//  SC-httpbench server [-p port] [-d seconds]
+struct HttpBenchOptions
+{
+    uint32_t numConnections  = 32;
+    uint32_t numThreads      = 1;
+    uint32_t durationSeconds = 5;
+    uint32_t requestsPerSec  = 0; // 0 means closed-loop
+    uint16_t port            = 8090;
+
+    StringView       url;
+    SmallString<256> ipAddress;
+    uint16_t         remotePort = 0;
+    SmallString<512> request;
+
+    [[nodiscard]] Result parse(Span<const StringView> arguments, bool needsUrl)
+    {
+        for (size_t idx = 0; idx < arguments.sizeInElements(); ++idx)
+        {
+            const StringView arg = arguments[idx];
+            if (arg.startsWith("-"))
+            {
+                SC_TRY_MSG(idx + 1 < arguments.sizeInElements(), "SC-httpbench - Missing option value");
+                int32_t value = 0;
+                SC_TRY_MSG(arguments[idx + 1].parseInt32(value) and value >= 0, "SC-httpbench - Invalid option value");
+                idx++;
+                if (arg == "-c")
+                    numConnections = static_cast<uint32_t>(value);
+                else if (arg == "-t")
+                    numThreads = static_cast<uint32_t>(value);
+                else if (arg == "-d")
+                    durationSeconds = static_cast<uint32_t>(value);
+                else if (arg == "-R")
+                    requestsPerSec = static_cast<uint32_t>(value);
+                else if (arg == "-p")
+                    port = static_cast<uint16_t>(value);
+                else
+                    return Result::Error("SC-httpbench - Unknown option (supported -c -t -d -R -p)");
+            }
+            else
+            {
+                url = arg;
+            }
+        }
+        SC_TRY_MSG(numThreads > 0 and numConnections >= numThreads, "SC-httpbench - Need at least 1 connection/thread");
+        SC_TRY_MSG(not needsUrl or not url.isEmpty(), "SC-httpbench - Missing url");
+        return Result(true);
+    }
+
+    [[nodiscard]] Result prepareRequest()
+    {
+        HttpURLParser parser;
+        SC_TRY(parser.parse(url));
+        SC_TRY_MSG(parser.protocol == "http", "SC-httpbench - Only http protocol is supported");
+        SC_TRY(SocketDNS::resolveDNS(parser.hostname, ipAddress));
+        remotePort = parser.port;
+        return Result(StringBuilder(request, StringBuilder::Clear)
+                          .format("GET {} HTTP/1.1\r\n"
+                                  "Host: {}\r\n"
+                                  "User-Agent: SC-httpbench\r\n"
+                                  "Connection: keep-alive\r\n\r\n",
+                                  parser.path.isEmpty() ? StringView("/") : parser.path, parser.host));
+    }
+};
+
+// Log-linear histogram of nanoseconds values (32 sub-buckets for every power of two, ~3% relative precision)
+struct HttpBenchHistogram
+{
+    static constexpr uint32_t SubBucketsBits = 5;
+    static constexpr uint32_t SubBuckets     = 1 << SubBucketsBits;
+    static constexpr uint32_t NumBuckets     = (64 - SubBucketsBits) * SubBuckets;
+
+    uint64_t counts[NumBuckets] = {0};
+    uint64_t totalCount         = 0;
+    uint64_t maxValue           = 0;
+    double   sumValues          = 0;
+
+    static uint32_t indexOf(uint64_t value)
+    {
+        if (value < 2 * SubBuckets)
+        {
+            return static_cast<uint32_t>(value);
+        }
+        uint32_t shift = 0;
+        while ((value >> shift) >= 2 * SubBuckets)
+        {
+            shift++;
+        }
+        return (shift + 1) * SubBuckets + static_cast<uint32_t>((value >> shift) - SubBuckets);
+    }
+
+    static uint64_t valueOf(uint32_t index)
+    {
+        if (index < 2 * SubBuckets)
+        {
+            return index;
+        }
+        const uint32_t shift = index / SubBuckets - 1;
+        // Middle of the bucket
+        return ((SubBuckets + static_cast<uint64_t>(index % SubBuckets)) << shift) + ((uint64_t(1) << shift) >> 1);
+    }
+
+    void record(int64_t nanoseconds)
+    {
+        const uint64_t value = nanoseconds < 0 ? 0 : static_cast<uint64_t>(nanoseconds);
+        counts[indexOf(value)]++;
+        totalCount++;
+        maxValue = max(maxValue, value);
+        sumValues += static_cast<double>(value);
+    }
+
+    void add(const HttpBenchHistogram& other)
+    {
+        for (uint32_t idx = 0; idx < NumBuckets; ++idx)
+        {
+            counts[idx] += other.counts[idx];
+        }
+        totalCount += other.totalCount;
+        maxValue = max(maxValue, other.maxValue);
+        sumValues += other.sumValues;
+    }
+
+    uint64_t percentile(double percentage) const
+    {
+        const double wanted = static_cast<double>(totalCount) * percentage / 100.0;
+
+        uint64_t cumulative = 0;
+        for (uint32_t idx = 0; idx < NumBuckets; ++idx)
+        {
+            cumulative += counts[idx];
+            if (counts[idx] > 0 and static_cast<double>(cumulative) >= wanted)
+            {
+                return min(valueOf(idx), maxValue);
+            }
+        }
+        return maxValue;
+    }
+
+    double mean() const { return totalCount > 0 ? sumValues / static_cast<double>(totalCount) : 0; }
+};
+
+struct HttpBenchStats
+{
+    HttpBenchHistogram responseTime; // From the intended send time (corrected for coordinated omission)
+    HttpBenchHistogram serviceTime;  // From the actual send time
+
+    uint64_t numCompleted  = 0;
+    uint64_t numErrors     = 0;
+    uint64_t numNon2xx     = 0;
+    uint64_t receivedBytes = 0;
+
+    void add(const HttpBenchStats& other)
+    {
+        responseTime.add(other.responseTime);
+        serviceTime.add(other.serviceTime);
+        numCompleted += other.numCompleted;
+        numErrors += other.numErrors;
+        numNon2xx += other.numNon2xx;
+        receivedBytes += other.receivedBytes;
+    }
+};
+
+struct HttpBenchLoop;
+
+struct HttpBenchConnection
+{
+    HttpBenchLoop* benchLoop = nullptr;
+
+    SocketDescriptor   socket;
+    AsyncSocketConnect asyncConnect;
+    AsyncSocketSend    asyncSend;
+    AsyncSocketReceive asyncReceive;
+    AsyncSocketClose   asyncClose;
+    AsyncLoopTimeout   asyncTimeout;
+    HttpParser         parser;
+
+    int64_t intendedStart = 0; // When request should have been sent (fixed-rate only)
+    int64_t actualStart   = 0; // When request has actually been sent
+    int64_t nextIntended  = 0; // Next slot in the fixed-rate schedule
+
+    char receiveBuffer[4096];
+
+    [[nodiscard]] Result start(HttpBenchLoop& loop, int64_t firstIntended);
+
+  private:
+    void scheduleNext();
+    void sendRequest(int64_t intended);
+    void fail();
+    void close();
+
+    void onConnected(AsyncSocketConnect::Result& result);
+    void onTimeout(AsyncLoopTimeout::Result& result);
+    void onSent(AsyncSocketSend::Result& result);
+    void onReceived(AsyncSocketReceive::Result& result);
+    void onClosed(AsyncSocketClose::Result& result);
+};
+
+struct HttpBenchLoop
+{
+    const HttpBenchOptions* options = nullptr;
+
+    AsyncEventLoop eventLoop;
+    Thread         thread;
+    HttpBenchStats stats;
+    Result         result = Result(true);
+
+    int64_t endTime    = 0; // Stop sending new requests after this instant
+    int64_t intervalNs = 0; // Time between two requests on the same connection (fixed-rate only)
+
+    ArenaMap<HttpBenchConnection> connections;
+
+    static int64_t now() { return Time::HighResolutionCounter().snap().toNanoseconds(); }
+
+    [[nodiscard]] Result create(const HttpBenchOptions& benchOptions, uint32_t numConnections)
+    {
+        options = &benchOptions;
+        SC_TRY(eventLoop.create());
+        SC_TRY(connections.resize(numConnections));
+        for (uint32_t idx = 0; idx < numConnections; ++idx)
+        {
+            SC_TRY(connections.allocate().isValid());
+        }
+        return Result(true);
+    }
+
+    void run(int64_t startTime)
+    {
+        constexpr int64_t secondsToNanoseconds = 1000000000;
+
+        endTime = startTime + static_cast<int64_t>(options->durationSeconds) * secondsToNanoseconds;
+        if (options->requestsPerSec > 0)
+        {
+            intervalNs = static_cast<int64_t>(options->numConnections) * secondsToNanoseconds /
+                         static_cast<int64_t>(options->requestsPerSec);
+        }
+        // Stagger connections uniformly over the first interval so that the aggregated rate is constant
+        const int64_t stagger = intervalNs / static_cast<int64_t>(connections.size());
+
+        int64_t idx = 0;
+        for (HttpBenchConnection& connection : connections)
+        {
+            result = connection.start(*this, startTime + stagger * idx++);
+            if (not result)
+                return;
+        }
+        result = eventLoop.run();
+        if (result)
+        {
+            result = eventLoop.close();
+        }
+    }
+};
+
+Result HttpBenchConnection::start(HttpBenchLoop& loop, int64_t firstIntended)
+{
+    benchLoop    = &loop;
+    nextIntended = firstIntended;
+    SocketIPAddress address;
+    SC_TRY(address.fromAddressPort(loop.options->ipAddress.view(), loop.options->remotePort));
+    SC_TRY(loop.eventLoop.createAsyncTCPSocket(address.getAddressFamily(), socket));
+    asyncConnect.setDebugName("SC-httpbench");
+    asyncConnect.callback.bind<HttpBenchConnection, &HttpBenchConnection::onConnected>(*this);
+    return asyncConnect.start(loop.eventLoop, socket, address);
+}
+
+void HttpBenchConnection::onConnected(AsyncSocketConnect::Result& result)
+{
+    if (not result.isValid())
+    {
+        fail();
+        return;
+    }
+    scheduleNext();
+}
+
+void HttpBenchConnection::scheduleNext()
+{
+    const int64_t now = HttpBenchLoop::now();
+    if (now >= benchLoop->endTime)
+    {
+        close();
+        return;
+    }
+    if (benchLoop->intervalNs == 0)
+    {
+        sendRequest(now); // closed-loop
+        return;
+    }
+    const int64_t intended = nextIntended;
+    nextIntended += benchLoop->intervalNs;
+
+    constexpr int64_t millisecondsToNanoseconds = 1000000;
+    if (intended - now >= millisecondsToNanoseconds)
+    {
+        // Timers have milliseconds resolution so wake up a little earlier than intended rather than later
+        intendedStart = intended;
+        asyncTimeout.callback.bind<HttpBenchConnection, &HttpBenchConnection::onTimeout>(*this);
+        const Time::Milliseconds wait((intended - now) / millisecondsToNanoseconds);
+        if (not asyncTimeout.start(benchLoop->eventLoop, wait))
+        {
+            fail();
+        }
+    }
+    else
+    {
+        sendRequest(intended);
+    }
+}
+
+void HttpBenchConnection::onTimeout(AsyncLoopTimeout::Result&) { sendRequest(intendedStart); }
+
+void HttpBenchConnection::sendRequest(int64_t intended)
+{
+    intendedStart = intended;
+    actualStart   = HttpBenchLoop::now();
+    parser        = HttpParser();
+    parser.type   = HttpParser::Type::Response;
+    asyncSend.callback.bind<HttpBenchConnection, &HttpBenchConnection::onSent>(*this);
+    if (not asyncSend.start(benchLoop->eventLoop, socket, benchLoop->options->request.view().toCharSpan()))
+    {
+        fail();
+    }
+}
+
+void HttpBenchConnection::onSent(AsyncSocketSend::Result& result)
+{
+    asyncReceive.callback.bind<HttpBenchConnection, &HttpBenchConnection::onReceived>(*this);
+    if (not result.isValid() or not asyncReceive.start(benchLoop->eventLoop, socket, {receiveBuffer}))
+    {
+        fail();
+    }
+}
+
+void HttpBenchConnection::onReceived(AsyncSocketReceive::Result& result)
+{
+    Span<char> readData;
+    if (not result.get(readData) or readData.empty())
+    {
+        fail(); // Error or connection closed by server
+        return;
+    }
+    benchLoop->stats.receivedBytes += readData.sizeInBytes();
+
+    Span<const char> data     = readData;
+    bool             complete = false;
+    while (not data.empty() and not complete)
+    {
+        size_t           readBytes = 0;
+        Span<const char> parsedData;
+        if (not parser.parse(data, readBytes, parsedData) or not data.sliceStart(readBytes, data))
+        {
+            fail();
+            return;
+        }
+        if (parser.state == HttpParser::State::Result)
+        {
+            complete = (parser.result == HttpParser::Result::Body) or
+                       (parser.result == HttpParser::Result::HeadersEnd and parser.contentLength == 0);
+        }
+        else if (readBytes == 0)
+        {
+            break; // Needs more data
+        }
+    }
+    if (not complete)
+    {
+        result.reactivateRequest(true);
+        return;
+    }
+    const int64_t  completion = HttpBenchLoop::now();
+    HttpBenchStats& stats     = benchLoop->stats;
+    stats.numCompleted++;
+    if (parser.statusCode < 200 or parser.statusCode > 299)
+    {
+        stats.numNon2xx++;
+    }
+    stats.serviceTime.record(completion - actualStart);
+    // A request sent late (because of a slow previous response) accounts also for the time spent waiting
+    stats.responseTime.record(completion - min(intendedStart, actualStart));
+    scheduleNext();
+}
+
+void HttpBenchConnection::fail()
+{
+    benchLoop->stats.numErrors++;
+    close();
+}
+
+void HttpBenchConnection::close()
+{
+    asyncClose.callback.bind<HttpBenchConnection, &HttpBenchConnection::onClosed>(*this);
+    if (not asyncClose.start(benchLoop->eventLoop, socket))
+    {
+        benchLoop->result = Result::Error("SC-httpbench - Cannot close socket");
+    }
+}
+
+void HttpBenchConnection::onClosed(AsyncSocketClose::Result&)
+{
+    socket.detach(); // Already closed by AsyncSocketClose
+}
+
+// Minimal server answering to every request, running on its own thread
+struct HttpBenchServer
+{
+    AsyncEventLoop  eventLoop;
+    AsyncLoopWakeUp wakeUp;
+    HttpServer      server;
+    Thread          thread;
+    Result          result = Result(true);
+
+    [[nodiscard]] Result start(uint16_t port, uint32_t maxConnections)
+    {
+        SC_TRY(eventLoop.create());
+        SC_TRY(server.start(eventLoop, maxConnections, "127.0.0.1", port));
+        server.onClient = [](HttpServer::ClientChannel& client)
+        {
+            auto& response = client.response;
+            if (response.startResponse(200) and response.addHeader("Content-Type", "text/plain"))
+            {
+                (void)response.end("Hello World");
+            }
+        };
+        return Result(true);
+    }
+
+    // Allows stopping the server from another thread with wakeUp.wakeUp()
+    [[nodiscard]] Result startWakeUp()
+    {
+        wakeUp.callback = [this](AsyncLoopWakeUp::Result& res)
+        {
+            result = server.stop();
+            if (result)
+            {
+                result = res.getAsync().stop();
+            }
+        };
+        return wakeUp.start(eventLoop);
+    }
+
+    [[nodiscard]] Result run()
+    {
+        SC_TRY(eventLoop.run());
+        SC_TRY(result);
+        return eventLoop.close();
+    }
+};
+
+static Result runHttpBenchLoops(Console& console, const HttpBenchOptions& options)
+{
+    ArenaMap<HttpBenchLoop> loops;
+    SC_TRY(loops.resize(options.numThreads));
+    for (uint32_t idx = 0; idx < options.numThreads; ++idx)
+    {
+        // Distribute connections as evenly as possible between threads
+        const uint32_t numConnections =
+            options.numConnections / options.numThreads + (idx < options.numConnections % options.numThreads ? 1 : 0);
+        HttpBenchLoop& loop = *loops.get(loops.allocate());
+        SC_TRY(loop.create(options, numConnections));
+    }
+
+    if (options.requestsPerSec > 0)
+    {
+        console.print("Running {}s test @ {} ({} connections, {} threads, fixed-rate {} req/s)\n",
+                      options.durationSeconds, options.url, options.numConnections, options.numThreads,
+                      options.requestsPerSec);
+    }
+    else
+    {
+        console.print("Running {}s test @ {} ({} connections, {} threads, closed-loop)\n", options.durationSeconds,
+                      options.url, options.numConnections, options.numThreads);
+    }
+
+    const int64_t startTime = HttpBenchLoop::now();
+    for (HttpBenchLoop& loop : loops)
+    {
+        SC_TRY(loop.thread.start([&loop, startTime](Thread&) { loop.run(startTime); }));
+    }
+    HttpBenchStats stats;
+    for (HttpBenchLoop& loop : loops)
+    {
+        SC_TRY(loop.thread.join());
+        SC_TRY(loop.result);
+        stats.add(loop.stats);
+    }
+    const double elapsed = static_cast<double>(HttpBenchLoop::now() - startTime) / 1e9;
+
+    console.print("  Requests: {} ({:.1} req/s), Transfer: {:.2} MB/s, Errors: {}, Non-2xx: {}\n",
+                  stats.numCompleted, static_cast<double>(stats.numCompleted) / elapsed,
+                  static_cast<double>(stats.receivedBytes) / elapsed / (1024 * 1024), stats.numErrors,
+                  stats.numNon2xx);
+
+    const double percentiles[] = {50, 75, 90, 99, 99.9, 99.99};
+    console.print("  Latency (ms)  p50       p75       p90       p99       p99.9     p99.99    max       mean\n");
+
+    const auto printHistogram = [&console, &percentiles](StringView name, const HttpBenchHistogram& histogram)
+    {
+        console.print("  {}", name);
+        for (double percentage : percentiles)
+        {
+            console.print("{:9.3} ", static_cast<double>(histogram.percentile(percentage)) / 1e6);
+        }
+        console.print("{:9.3} {:9.3}\n", static_cast<double>(histogram.maxValue) / 1e6, histogram.mean() / 1e6);
+    };
+    if (options.requestsPerSec > 0)
+    {
+        printHistogram("corrected   ", stats.responseTime);
+        printHistogram("uncorrected ", stats.serviceTime);
+    }
+    else
+    {
+        printHistogram("measured    ", stats.serviceTime);
+    }
+    return Result(true);
+}
+
+[[nodiscard]] Result runHttpBenchTool(Tool::Arguments& arguments)
+{
+    SC_TRY(SocketNetworking::initNetworking());
+    HttpBenchOptions options;
+    if (arguments.action == "run")
+    {
+        SC_TRY(options.parse(arguments.arguments, true));
+        SC_TRY(options.prepareRequest());
+        return runHttpBenchLoops(arguments.console, options);
+    }
+    else if (arguments.action == "self")
+    {
+        SC_TRY(options.parse(arguments.arguments, false));
+        SmallString<64> url;
+        SC_TRY(StringBuilder(url).format("http://127.0.0.1:{}/", options.port));
+        options.url = url.view();
+        SC_TRY(options.prepareRequest());
+
+        HttpBenchServer benchServer;
+        SC_TRY(benchServer.start(options.port, options.numConnections + 16));
+        SC_TRY(benchServer.startWakeUp());
+        Result serverResult = Result(true);
+        SC_TRY(benchServer.thread.start([&benchServer, &serverResult](Thread&) { serverResult = benchServer.run(); }));
+        const Result benchResult = runHttpBenchLoops(arguments.console, options);
+        SC_TRY(benchServer.wakeUp.wakeUp());
+        SC_TRY(benchServer.thread.join());
+        SC_TRY(benchResult);
+        const HttpServer::ArenaStatistics& arena = benchServer.server.arenaStatistics;
+        arguments.console.print("  Server arena: peak {} bytes per request, {} overflows ({} bytes)\n",
+                                arena.peakUsedBytes, arena.numOverflows, arena.overflowBytes);
+        return serverResult;
+    }
+    else if (arguments.action == "server")
+    {
+        options.durationSeconds = 0; // Runs forever unless specified
+        SC_TRY(options.parse(arguments.arguments, false));
+        HttpBenchServer benchServer;
+        SC_TRY(benchServer.start(options.port, 1024));
+        AsyncLoopTimeout timeout;
+        if (options.durationSeconds > 0)
+        {
+            timeout.callback = [&benchServer](AsyncLoopTimeout::Result&)
+            { benchServer.result = benchServer.server.stop(); };
+            SC_TRY(timeout.start(benchServer.eventLoop, Time::Seconds(options.durationSeconds)));
+        }
+        arguments.console.print("Listening on http://127.0.0.1:{}/\n", options.port);
+        return benchServer.run();
+    }
+    return Result::Error("SC-httpbench unknown action (supported \"self\", \"run\" or \"server\")");
+}
+
+#if !defined(SC_LIBRARY_PATH) && !defined(SC_TOOLS_IMPORT)
+StringView Tool::getToolName() { return "SC-httpbench"; }
+StringView Tool::getDefaultAction() { return "self"; }
+Result     Tool::runTool(Tool::Arguments& arguments) { return runHttpBenchTool(arguments); }
+#endif
+} // namespace Tools
+} // namespace SC
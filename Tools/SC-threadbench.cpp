@@ -0,0 +1,779 @@
+// Copyright (c) Stefano Cristiano
+// SPDX-License-Identifier: MIT
+#include "../Libraries/Containers/HashMap.h"
+#include "../Libraries/Containers/Vector.h"
+#include "../Libraries/Process/Process.h"
+#include "../Libraries/Strings/Console.h"
+#include "../Libraries/Threading/ConcurrentHashMap.h"
+#include "../Libraries/Threading/EpochReclamation.h"
+#include "../Libraries/Threading/LockFreeQueue.h"
+#include "../Libraries/Threading/ThreadPool.h"
+#include "../Libraries/Time/Time.h"
+#include "Tools.h"
+
+namespace SC
+{
+namespace Tools
+{
+// Measures throughput (tasks/sec) of ThreadPool scheduling modes against the number of worker threads.
+// - external: all tasks are queued from the main thread (exercising the shared queue or the injection queue)
+// - spawn: a few root tasks queue all other tasks from worker threads (exercising per-worker deques and stealing)
+//
+// Measures throughput (items/sec) of bounded queues against the number of producer / consumer pairs.
+// - mutex: a ring buffer protected by a Mutex
+// - mpmc: MPMCQueue
+// - spsc: SPSCQueue (only with a single pair)
+//
+// Measures read throughput (reads/sec) of a shared table, against the number of reader threads, while a writer
+// thread modifies it about every millisecond.
+// - mutex: table protected by a Mutex
+// - rwlock: table protected by a ReadWriteLock
+// - rcu: table published through an RcuPointer (lock-free reads inside EpochDomain read sections)
+//
+// Measures lookup throughput (lookups/sec) of a shared hash map, against the number of reader threads, while a writer
+// thread overwrites a key about every millisecond.
+// - mutex: HashMap protected by a Mutex
+// - rwlock: HashMap protected by a ReadWriteLock
+// - concurrent: ConcurrentHashMap (lock-free lookups inside EpochDomain read sections)
+//
+// Usage:
+//  SC-threadbench pool [-t maxThreads] [-n tasks] [-w workPerTask]
+//  SC-threadbench queue [-t maxThreads] [-n items]
+//  SC-threadbench rcu [-t maxThreads] [-n readsPerThread]
+//  SC-threadbench map [-t maxThreads] [-n lookupsPerThread]
+struct ThreadBenchOptions
+{
+    uint32_t maxThreads  = 0; // 0 means number of processors
+    uint32_t numTasks    = 200000;
+    uint32_t workPerTask = 100; // Iterations of a small computation executed by every task
+
+    [[nodiscard]] Result parse(Span<const StringView> arguments)
+    {
+        for (size_t idx = 0; idx < arguments.sizeInElements(); ++idx)
+        {
+            const StringView arg = arguments[idx];
+            SC_TRY_MSG(idx + 1 < arguments.sizeInElements(), "SC-threadbench - Missing option value");
+            int32_t value = 0;
+            SC_TRY_MSG(arguments[idx + 1].parseInt32(value) and value >= 0, "SC-threadbench - Invalid option value");
+            idx++;
+            if (arg == "-t")
+                maxThreads = static_cast<uint32_t>(value);
+            else if (arg == "-n")
+                numTasks = static_cast<uint32_t>(value);
+            else if (arg == "-w")
+                workPerTask = static_cast<uint32_t>(value);
+            else
+                return Result::Error("SC-threadbench - Unknown option (supported -t -n -w)");
+        }
+        if (maxThreads == 0)
+        {
+            maxThreads = static_cast<uint32_t>(Process::getNumberOfProcessors());
+        }
+        SC_TRY_MSG(maxThreads > 0 and numTasks > 0, "SC-threadbench - Need at least 1 thread and 1 task");
+        return Result(true);
+    }
+};
+
+struct ThreadBenchPool
+{
+    static constexpr uint32_t BatchSize = 4096; // Tasks queued externally before waiting for them
+
+    const ThreadBenchOptions& options;
+
+    ThreadPool               threadPool;
+    Vector<ThreadPool::Task> tasks;
+    Vector<ThreadPool::Task> roots;
+    Vector<uint32_t>         results;
+
+    ThreadBenchPool(const ThreadBenchOptions& options) : options(options) {}
+
+    [[nodiscard]] Result prepare()
+    {
+        SC_TRY(tasks.resize(options.numTasks));
+        SC_TRY(results.resize(options.numTasks));
+        for (uint32_t idx = 0; idx < options.numTasks; ++idx)
+        {
+            results[idx]          = idx;
+            ThreadBenchPool* self = this;
+            uint32_t*        slot = &results[idx];
+            tasks[idx].function   = [self, slot]() { *slot = self->work(*slot); };
+        }
+        return Result(true);
+    }
+
+    uint32_t work(uint32_t seed) const
+    {
+        uint32_t value = seed + 1;
+        for (uint32_t idx = 0; idx < options.workPerTask; ++idx)
+        {
+            value ^= value << 13;
+            value ^= value >> 17;
+            value ^= value << 5;
+        }
+        return value;
+    }
+
+    [[nodiscard]] Result runExternal()
+    {
+        for (uint32_t start = 0; start < options.numTasks; start += BatchSize)
+        {
+            const uint32_t end = start + BatchSize < options.numTasks ? start + BatchSize : options.numTasks;
+            for (uint32_t idx = start; idx < end; ++idx)
+            {
+                SC_TRY(threadPool.queueTask(tasks[idx]));
+            }
+            SC_TRY(threadPool.waitForAllTasks());
+        }
+        return Result(true);
+    }
+
+    [[nodiscard]] Result runSpawn(uint32_t numThreads)
+    {
+        const uint32_t numRoots = numThreads * 4;
+        SC_TRY(roots.resize(numRoots));
+        for (uint32_t root = 0; root < numRoots; ++root)
+        {
+            ThreadBenchPool*  self = this;
+            ThreadPool::Task* task = &roots[root];
+            task->function         = [self, task]()
+            {
+                // Every root queues one every numRoots tasks
+                const size_t numRoots = self->roots.size();
+                for (size_t idx = static_cast<size_t>(task - self->roots.data()); idx < self->options.numTasks;
+                     idx += numRoots)
+                {
+                    (void)self->threadPool.queueTask(self->tasks[idx]);
+                }
+            };
+            SC_TRY(threadPool.queueTask(roots[root]));
+        }
+        return threadPool.waitForAllTasks();
+    }
+
+    [[nodiscard]] Result measure(Console& console, ThreadPool::Scheduling scheduling, uint32_t numThreads, bool spawn)
+    {
+        SC_TRY(threadPool.create(numThreads, scheduling));
+        const Time::HighResolutionCounter start = Time::HighResolutionCounter().snap();
+        SC_TRY(spawn ? runSpawn(numThreads) : runExternal());
+        const int64_t elapsed = Time::HighResolutionCounter().snap().subtractExact(start).toNanoseconds();
+        SC_TRY(threadPool.destroy());
+
+        const double tasksPerSecond = static_cast<double>(options.numTasks) * 1e9 / static_cast<double>(elapsed);
+        console.print(" {:12.0}", tasksPerSecond);
+        return Result(true);
+    }
+};
+
+[[nodiscard]] Result runThreadBenchPool(Console& console, const ThreadBenchOptions& options)
+{
+    ThreadBenchPool bench(options);
+    SC_TRY(bench.prepare());
+
+    console.print("ThreadPool throughput (tasks/s), {} tasks of {} work iterations\n", options.numTasks,
+                  options.workPerTask);
+    console.print("  threads  shared-external  steal-external    shared-spawn     steal-spawn\n");
+    for (uint32_t numThreads = 1; numThreads <= options.maxThreads;)
+    {
+        console.print("  {:7}    ", numThreads);
+        SC_TRY(bench.measure(console, ThreadPool::Scheduling::SharedQueue, numThreads, false));
+        console.print("    ");
+        SC_TRY(bench.measure(console, ThreadPool::Scheduling::WorkStealing, numThreads, false));
+        console.print("    ");
+        SC_TRY(bench.measure(console, ThreadPool::Scheduling::SharedQueue, numThreads, true));
+        console.print("    ");
+        SC_TRY(bench.measure(console, ThreadPool::Scheduling::WorkStealing, numThreads, true));
+        console.print("\n");
+        if (numThreads == options.maxThreads)
+            break;
+        numThreads = numThreads * 2 < options.maxThreads ? numThreads * 2 : options.maxThreads;
+    }
+    return Result(true);
+}
+
+// Ring buffer protected by a mutex, used as baseline for the lock-free queues
+struct ThreadBenchMutexQueue
+{
+    Mutex     mutex;
+    uint32_t* items = nullptr;
+    size_t    mask  = 0;
+    size_t    head  = 0;
+    size_t    tail  = 0;
+
+    [[nodiscard]] Result init(Span<uint32_t> storage)
+    {
+        items = storage.data();
+        mask  = storage.sizeInElements() - 1;
+        return Result(true);
+    }
+
+    [[nodiscard]] bool tryPush(uint32_t value)
+    {
+        mutex.lock();
+        const bool pushed = tail - head <= mask;
+        if (pushed)
+        {
+            items[tail++ & mask] = value;
+        }
+        mutex.unlock();
+        return pushed;
+    }
+
+    [[nodiscard]] bool tryPop(uint32_t& value)
+    {
+        mutex.lock();
+        const bool popped = head != tail;
+        if (popped)
+        {
+            value = items[head++ & mask];
+        }
+        mutex.unlock();
+        return popped;
+    }
+};
+
+struct ThreadBenchQueue
+{
+    static constexpr uint32_t MaxPairs  = 32;
+    static constexpr uint32_t QueueSize = 1024;
+    static constexpr int      SpinCount = 64; // Failed attempts before yielding the CPU
+
+    const ThreadBenchOptions& options;
+
+    ThreadBenchQueue(const ThreadBenchOptions& options) : options(options) {}
+
+    template <typename Queue>
+    struct Shared
+    {
+        Queue*           queue            = nullptr;
+        uint32_t         itemsPerProducer = 0;
+        uint32_t         numItems         = 0;
+        Atomic<uint32_t> numPopped        = 0;
+        Atomic<uint64_t> sum              = 0;
+    };
+
+    static void backoff(int& numFailures)
+    {
+        if (++numFailures == SpinCount)
+        {
+            numFailures = 0;
+            Thread::Sleep(0);
+        }
+    }
+
+    template <typename Queue>
+    [[nodiscard]] Result measure(Console& console, Queue& queue, uint32_t numPairs)
+    {
+        Shared<Queue> shared;
+        shared.queue            = &queue;
+        shared.itemsPerProducer = options.numTasks / numPairs;
+        shared.numItems         = shared.itemsPerProducer * numPairs;
+
+        Thread producers[MaxPairs];
+        Thread consumers[MaxPairs];
+
+        const Time::HighResolutionCounter start = Time::HighResolutionCounter().snap();
+        for (uint32_t idx = 0; idx < numPairs; ++idx)
+        {
+            SC_TRY(consumers[idx].start(
+                [&shared](Thread&)
+                {
+                    int numFailures = 0;
+                    while (shared.numPopped.load(memory_order_relaxed) < shared.numItems)
+                    {
+                        uint32_t value;
+                        if (shared.queue->tryPop(value))
+                        {
+                            shared.numPopped.fetch_add(1, memory_order_relaxed);
+                            shared.sum.fetch_add(value, memory_order_relaxed);
+                        }
+                        else
+                        {
+                            backoff(numFailures);
+                        }
+                    }
+                }));
+            SC_TRY(producers[idx].start(
+                [&shared](Thread&)
+                {
+                    int numFailures = 0;
+                    for (uint32_t value = 1; value <= shared.itemsPerProducer; ++value)
+                    {
+                        while (not shared.queue->tryPush(value))
+                        {
+                            backoff(numFailures);
+                        }
+                    }
+                }));
+        }
+        for (uint32_t idx = 0; idx < numPairs; ++idx)
+        {
+            SC_TRY(producers[idx].join());
+            SC_TRY(consumers[idx].join());
+        }
+        const int64_t elapsed = Time::HighResolutionCounter().snap().subtractExact(start).toNanoseconds();
+
+        const uint64_t expectedSum = uint64_t(numPairs) * shared.itemsPerProducer * (shared.itemsPerProducer + 1) / 2;
+        SC_TRY_MSG(shared.sum.load() == expectedSum, "SC-threadbench - Queue has lost some items");
+
+        const double itemsPerSecond = static_cast<double>(shared.numItems) * 1e9 / static_cast<double>(elapsed);
+        console.print(" {:12.0}", itemsPerSecond);
+        return Result(true);
+    }
+};
+
+[[nodiscard]] Result runThreadBenchQueue(Console& console, const ThreadBenchOptions& options)
+{
+    ThreadBenchQueue bench(options);
+
+    const uint32_t maxPairs = options.maxThreads < 2 ? 1 : options.maxThreads / 2;
+    SC_TRY_MSG(maxPairs <= ThreadBenchQueue::MaxPairs, "SC-threadbench - Too many threads for queue benchmark");
+
+    uint32_t                  ring[ThreadBenchQueue::QueueSize];
+    MPMCQueue<uint32_t>::Cell cells[ThreadBenchQueue::QueueSize];
+
+    const uint32_t queueSize = ThreadBenchQueue::QueueSize;
+    console.print("Queue throughput (items/s), {} items through a queue of {} elements\n", options.numTasks, queueSize);
+    console.print("    pairs           mutex            mpmc            spsc\n");
+    for (uint32_t numPairs = 1; numPairs <= maxPairs;)
+    {
+        console.print("  {:7}    ", numPairs);
+        ThreadBenchMutexQueue mutexQueue;
+        SC_TRY(mutexQueue.init(ring));
+        SC_TRY(bench.measure(console, mutexQueue, numPairs));
+        console.print("    ");
+        MPMCQueue<uint32_t> mpmcQueue;
+        SC_TRY(mpmcQueue.init(cells));
+        SC_TRY(bench.measure(console, mpmcQueue, numPairs));
+        if (numPairs == 1)
+        {
+            console.print("    ");
+            SPSCQueue<uint32_t> spscQueue;
+            SC_TRY(spscQueue.init(ring));
+            SC_TRY(bench.measure(console, spscQueue, numPairs));
+        }
+        console.print("\n");
+        if (numPairs == maxPairs)
+            break;
+        numPairs = numPairs * 2 < maxPairs ? numPairs * 2 : maxPairs;
+    }
+    return Result(true);
+}
+
+// Read-mostly data shared between readers and the writer, that must always be seen in a consistent state
+struct ThreadBenchTable
+{
+    static constexpr int NumValues = 16;
+
+    uint32_t values[NumValues] = {0};
+
+    void fill(uint32_t value)
+    {
+        for (uint32_t& element : values)
+            element = value;
+    }
+
+    [[nodiscard]] bool isConsistent() const
+    {
+        for (uint32_t element : values)
+        {
+            if (element != values[0])
+                return false;
+        }
+        return true;
+    }
+};
+
+// Every table policy receives the EpochThread of the calling thread, even if only the RCU one uses it, and the index
+// of the read (used by map policies to pick the key to look up)
+struct ThreadBenchMutexTable
+{
+    Mutex            mutex;
+    ThreadBenchTable table;
+
+    [[nodiscard]] Result registerThread(EpochThread&) { return Result(true); }
+    [[nodiscard]] Result unregisterThread(EpochThread&) { return Result(true); }
+
+    [[nodiscard]] bool read(EpochThread&, uint32_t)
+    {
+        mutex.lock();
+        const bool consistent = table.isConsistent();
+        mutex.unlock();
+        return consistent;
+    }
+
+    [[nodiscard]] Result write(EpochThread&, uint32_t value)
+    {
+        mutex.lock();
+        table.fill(value);
+        mutex.unlock();
+        return Result(true);
+    }
+};
+
+struct ThreadBenchReadWriteLockTable
+{
+    ReadWriteLock    lock;
+    ThreadBenchTable table;
+
+    [[nodiscard]] Result registerThread(EpochThread&) { return Result(true); }
+    [[nodiscard]] Result unregisterThread(EpochThread&) { return Result(true); }
+
+    [[nodiscard]] bool read(EpochThread&, uint32_t)
+    {
+        lock.lockRead();
+        const bool consistent = table.isConsistent();
+        lock.unlockRead();
+        return consistent;
+    }
+
+    [[nodiscard]] Result write(EpochThread&, uint32_t value)
+    {
+        lock.lockWrite();
+        table.fill(value);
+        lock.unlockWrite();
+        return Result(true);
+    }
+};
+
+struct ThreadBenchRcuTable
+{
+    ThreadPool                   threadPool; // Collects retired versions
+    EpochDomain                  domain;
+    RcuPointer<ThreadBenchTable> table{domain};
+
+    ~ThreadBenchRcuTable()
+    {
+        table.reset();
+        (void)domain.destroy();
+        (void)threadPool.destroy();
+    }
+
+    [[nodiscard]] Result init()
+    {
+        SC_TRY(threadPool.create(1));
+        SC_TRY(domain.setThreadPool(threadPool));
+        EpochThread thread;
+        SC_TRY(domain.registerThread(thread));
+        const Result stored = table.store(thread, ThreadBenchTable());
+        SC_TRY(domain.unregisterThread(thread));
+        return stored;
+    }
+
+    [[nodiscard]] Result registerThread(EpochThread& thread) { return domain.registerThread(thread); }
+    [[nodiscard]] Result unregisterThread(EpochThread& thread) { return domain.unregisterThread(thread); }
+
+    [[nodiscard]] bool read(EpochThread& thread, uint32_t)
+    {
+        EpochGuard guard(domain, thread);
+        return table.load()->isConsistent();
+    }
+
+    [[nodiscard]] Result write(EpochThread& thread, uint32_t value)
+    {
+        return table.update(thread, [value](ThreadBenchTable& copy) { copy.fill(value); });
+    }
+};
+
+// Keys of the shared map, whose values must always be 3 times the key
+struct ThreadBenchMapKeys
+{
+    static constexpr uint32_t NumKeys = 4096;
+
+    static constexpr uint32_t keyOf(uint32_t index) { return (index * 7919) % NumKeys; }
+};
+
+constexpr uint32_t ThreadBenchMapKeys::NumKeys;
+
+struct ThreadBenchMutexMap
+{
+    Mutex                       mutex;
+    HashMap<uint32_t, uint32_t> map;
+
+    [[nodiscard]] Result init()
+    {
+        for (uint32_t key = 0; key < ThreadBenchMapKeys::NumKeys; ++key)
+        {
+            SC_TRY(map.insertIfNotExists({key, key * 3}));
+        }
+        return Result(true);
+    }
+
+    [[nodiscard]] Result registerThread(EpochThread&) { return Result(true); }
+    [[nodiscard]] Result unregisterThread(EpochThread&) { return Result(true); }
+
+    [[nodiscard]] bool read(EpochThread&, uint32_t index)
+    {
+        const uint32_t key = ThreadBenchMapKeys::keyOf(index);
+        mutex.lock();
+        const uint32_t* value      = map.get(key);
+        const bool      consistent = value != nullptr and *value == key * 3;
+        mutex.unlock();
+        return consistent;
+    }
+
+    [[nodiscard]] Result write(EpochThread&, uint32_t index)
+    {
+        const uint32_t key = ThreadBenchMapKeys::keyOf(index);
+        mutex.lock();
+        const bool written = map.insertOverwrite({key, key * 3}) != nullptr;
+        mutex.unlock();
+        return Result(written);
+    }
+};
+
+struct ThreadBenchReadWriteLockMap
+{
+    ReadWriteLock               lock;
+    HashMap<uint32_t, uint32_t> map;
+
+    [[nodiscard]] Result init()
+    {
+        for (uint32_t key = 0; key < ThreadBenchMapKeys::NumKeys; ++key)
+        {
+            SC_TRY(map.insertIfNotExists({key, key * 3}));
+        }
+        return Result(true);
+    }
+
+    [[nodiscard]] Result registerThread(EpochThread&) { return Result(true); }
+    [[nodiscard]] Result unregisterThread(EpochThread&) { return Result(true); }
+
+    [[nodiscard]] bool read(EpochThread&, uint32_t index)
+    {
+        const uint32_t key = ThreadBenchMapKeys::keyOf(index);
+        lock.lockRead();
+        const uint32_t* value      = map.get(key);
+        const bool      consistent = value != nullptr and *value == key * 3;
+        lock.unlockRead();
+        return consistent;
+    }
+
+    [[nodiscard]] Result write(EpochThread&, uint32_t index)
+    {
+        const uint32_t key = ThreadBenchMapKeys::keyOf(index);
+        lock.lockWrite();
+        const bool written = map.insertOverwrite({key, key * 3}) != nullptr;
+        lock.unlockWrite();
+        return Result(written);
+    }
+};
+
+struct ThreadBenchConcurrentMap
+{
+    ThreadPool                            threadPool; // Collects retired values
+    EpochDomain                           domain;
+    ConcurrentHashMap<uint32_t, uint32_t> map{domain};
+
+    ~ThreadBenchConcurrentMap()
+    {
+        (void)domain.destroy();
+        (void)threadPool.destroy();
+    }
+
+    [[nodiscard]] Result init()
+    {
+        SC_TRY(threadPool.create(1));
+        SC_TRY(domain.setThreadPool(threadPool));
+        SC_TRY(map.init(ThreadBenchMapKeys::NumKeys));
+        EpochThread thread;
+        SC_TRY(domain.registerThread(thread));
+        bool inserted = true;
+        for (uint32_t key = 0; key < ThreadBenchMapKeys::NumKeys; ++key)
+        {
+            inserted = inserted and map.insertIfNotExists(thread, key, key * 3);
+        }
+        SC_TRY(domain.unregisterThread(thread));
+        return Result(inserted);
+    }
+
+    [[nodiscard]] Result registerThread(EpochThread& thread) { return domain.registerThread(thread); }
+    [[nodiscard]] Result unregisterThread(EpochThread& thread) { return domain.unregisterThread(thread); }
+
+    [[nodiscard]] bool read(EpochThread& thread, uint32_t index)
+    {
+        const uint32_t  key = ThreadBenchMapKeys::keyOf(index);
+        EpochGuard      guard(domain, thread);
+        const uint32_t* value = map.get(key);
+        return value != nullptr and *value == key * 3;
+    }
+
+    [[nodiscard]] Result write(EpochThread& thread, uint32_t index)
+    {
+        const uint32_t key = ThreadBenchMapKeys::keyOf(index);
+        return Result(map.insertOverwrite(thread, key, key * 3));
+    }
+};
+
+struct ThreadBenchReaders
+{
+    static constexpr uint32_t MaxReaders = 64;
+
+    const ThreadBenchOptions& options;
+
+    ThreadBenchReaders(const ThreadBenchOptions& options) : options(options) {}
+
+    template <typename Table>
+    struct Shared
+    {
+        Table*           table        = nullptr;
+        uint32_t         numReads     = 0; // For every reader
+        Atomic<uint32_t> numRunning   = 0; // Readers still running
+        Atomic<uint32_t> numErrors    = 0;
+        uint32_t         numWrites    = 0;
+        Result           writerResult = Result(true);
+    };
+
+    template <typename Table>
+    [[nodiscard]] Result measure(Console& console, Table& table, uint32_t numReaders)
+    {
+        Shared<Table> shared;
+        shared.table    = &table;
+        shared.numReads = options.numTasks;
+        shared.numRunning.store(numReaders);
+
+        Thread readers[MaxReaders];
+        Thread writer;
+
+        const Time::HighResolutionCounter start = Time::HighResolutionCounter().snap();
+        for (uint32_t idx = 0; idx < numReaders; ++idx)
+        {
+            SC_TRY(readers[idx].start(
+                [&shared](Thread&)
+                {
+                    EpochThread thread;
+                    if (not shared.table->registerThread(thread))
+                    {
+                        shared.numErrors.fetch_add(1);
+                    }
+                    else
+                    {
+                        uint32_t numErrors = 0;
+                        for (uint32_t read = 0; read < shared.numReads; ++read)
+                        {
+                            numErrors += shared.table->read(thread, read) ? 0 : 1;
+                        }
+                        shared.numErrors.fetch_add(numErrors);
+                        (void)shared.table->unregisterThread(thread);
+                    }
+                    shared.numRunning.fetch_sub(1);
+                }));
+        }
+        SC_TRY(writer.start(
+            [&shared](Thread&)
+            {
+                EpochThread thread;
+                shared.writerResult = shared.table->registerThread(thread);
+                while (shared.writerResult and shared.numRunning.load(memory_order_relaxed) > 0)
+                {
+                    shared.writerResult = shared.table->write(thread, ++shared.numWrites);
+                    Thread::Sleep(1);
+                }
+                (void)shared.table->unregisterThread(thread);
+            }));
+        for (uint32_t idx = 0; idx < numReaders; ++idx)
+        {
+            SC_TRY(readers[idx].join());
+        }
+        const int64_t elapsed = Time::HighResolutionCounter().snap().subtractExact(start).toNanoseconds();
+        SC_TRY(writer.join());
+        SC_TRY(shared.writerResult);
+        SC_TRY_MSG(shared.numErrors.load() == 0, "SC-threadbench - Readers have seen an inconsistent table");
+
+        const double readsPerSecond =
+            static_cast<double>(shared.numReads) * numReaders * 1e9 / static_cast<double>(elapsed);
+        console.print(" {:12.0}", readsPerSecond);
+        return Result(true);
+    }
+};
+
+[[nodiscard]] Result runThreadBenchRcu(Console& console, const ThreadBenchOptions& options)
+{
+    ThreadBenchReaders bench(options);
+    SC_TRY_MSG(options.maxThreads <= ThreadBenchReaders::MaxReaders,
+               "SC-threadbench - Too many threads for rcu benchmark");
+
+    console.print("Read throughput (reads/s), {} reads for every reader thread, with a writer every ~1ms\n",
+                  options.numTasks);
+    console.print("  readers           mutex          rwlock             rcu\n");
+    for (uint32_t numReaders = 1; numReaders <= options.maxThreads;)
+    {
+        console.print("  {:7}    ", numReaders);
+        ThreadBenchMutexTable mutexTable;
+        SC_TRY(bench.measure(console, mutexTable, numReaders));
+        console.print("    ");
+        ThreadBenchReadWriteLockTable readWriteLockTable;
+        SC_TRY(bench.measure(console, readWriteLockTable, numReaders));
+        console.print("    ");
+        ThreadBenchRcuTable rcuTable;
+        SC_TRY(rcuTable.init());
+        SC_TRY(bench.measure(console, rcuTable, numReaders));
+        console.print("\n");
+        if (numReaders == options.maxThreads)
+            break;
+        numReaders = numReaders * 2 < options.maxThreads ? numReaders * 2 : options.maxThreads;
+    }
+    return Result(true);
+}
+
+[[nodiscard]] Result runThreadBenchMap(Console& console, const ThreadBenchOptions& options)
+{
+    ThreadBenchReaders bench(options);
+    SC_TRY_MSG(options.maxThreads <= ThreadBenchReaders::MaxReaders,
+               "SC-threadbench - Too many threads for map benchmark");
+
+    console.print("Lookup throughput (lookups/s) of {} keys, {} lookups for every reader thread, with a writer "
+                  "every ~1ms\n",
+                  ThreadBenchMapKeys::NumKeys, options.numTasks);
+    console.print("  readers           mutex          rwlock      concurrent\n");
+    for (uint32_t numReaders = 1; numReaders <= options.maxThreads;)
+    {
+        console.print("  {:7}    ", numReaders);
+        ThreadBenchMutexMap mutexMap;
+        SC_TRY(mutexMap.init());
+        SC_TRY(bench.measure(console, mutexMap, numReaders));
+        console.print("    ");
+        ThreadBenchReadWriteLockMap readWriteLockMap;
+        SC_TRY(readWriteLockMap.init());
+        SC_TRY(bench.measure(console, readWriteLockMap, numReaders));
+        console.print("    ");
+        ThreadBenchConcurrentMap concurrentMap;
+        SC_TRY(concurrentMap.init());
+        SC_TRY(bench.measure(console, concurrentMap, numReaders));
+        console.print("\n");
+        if (numReaders == options.maxThreads)
+            break;
+        numReaders = numReaders * 2 < options.maxThreads ? numReaders * 2 : options.maxThreads;
+    }
+    return Result(true);
+}
+
+[[nodiscard]] Result runThreadBenchTool(Tool::Arguments& arguments)
+{
+    ThreadBenchOptions options;
+    SC_TRY(options.parse(arguments.arguments));
+    if (arguments.action == "pool")
+    {
+        return runThreadBenchPool(arguments.console, options);
+    }
+    else if (arguments.action == "queue")
+    {
+        return runThreadBenchQueue(arguments.console, options);
+    }
+    else if (arguments.action == "rcu")
+    {
+        return runThreadBenchRcu(arguments.console, options);
+    }
+    else if (arguments.action == "map")
+    {
+        return runThreadBenchMap(arguments.console, options);
+    }
+    return Result::Error("SC-threadbench unknown action (supported \"pool\", \"queue\", \"rcu\" and \"map\")");
+}
+
+#if !defined(SC_LIBRARY_PATH) && !defined(SC_TOOLS_IMPORT)
+StringView Tool::getToolName() { return "SC-threadbench"; }
+StringView Tool::getDefaultAction() { return "pool"; }
+Result     Tool::runTool(Tool::Arguments& arguments) { return runThreadBenchTool(arguments); }
+#endif
+} // namespace Tools
+} // namespace SC
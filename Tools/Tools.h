@@ -40,6 +40,10 @@ struct Package;
 // Tools
 [[nodiscard]] Result runFormatTool(Tool::Arguments& arguments);
 [[nodiscard]] Result runBuildTool(Tool::Arguments& arguments);
+[[nodiscard]] Result runHttpBenchTool(Tool::Arguments& arguments);
+[[nodiscard]] Result runThreadBenchTool(Tool::Arguments& arguments);
+[[nodiscard]] Result runContainerBenchTool(Tool::Arguments& arguments);
+[[nodiscard]] Result runAlgorithmsBenchTool(Tool::Arguments& arguments);
 [[nodiscard]] Result runPackageTool(Tool::Arguments& arguments, Tools::Package* package = nullptr);
 [[nodiscard]] Result findSystemClangFormat(Console& console, StringView wantedMajorVersion, String& foundPath);
 } // namespace Tools